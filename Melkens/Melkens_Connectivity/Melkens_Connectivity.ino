@@ -7,8 +7,13 @@
 
 #include "src/Settings.h"
 #include "src/ImuCommunication/ImuCommunication.h"
+#include "src/Melkens_Lib/Types/MessageCodec.h"
 #include "src/MqttNode/MqttNode.h"
 #include "src/WebHandler/WebHandler.h"
+#include "src/Telemetry/TelemetryStream.h"
+#include "src/RouteUpload/RouteUpload.h"
+#include "src/FirmwareUpload/FirmwareUpload.h"
+#include "src/TimeBase/TimeBase.h"
 
 #ifdef BLE_SERIAL
    #include "src/BleSerial/BleSerial.h"
@@ -28,6 +33,11 @@
 #define FIXED_POINT_SCALE (1 << FIXED_POINT_BITS)
 
 #define DELAY_TIME 500  /* 200ms delay */ 
+#define NETWORK_TASK_CORE 0     // same core as Wi-Fi stack and AsyncTCP (build_opt.h), IMU link runs on the other one
+#define NETWORK_TASK_PRIORITY 1
+#define NETWORK_TASK_STACK 8192
+#define NETWORK_PERIOD 10       // [ms]
+#define LINK_STATS_PERIOD 10000 // [ms] also latency histograms published over mqtt
 #define WIFI_CONNECTION_TIMEOUT 10 // [s] If it does not connect after this time, it switches to AP mode.
 #define SOFT_AP_TIMEOUT 120 // [s] If after this time no one connects to the server, it resets.
 
@@ -70,6 +80,12 @@ static unsigned long StartTime, CurrentTime, LastIMUConnectedTime, brokerMsgStat
   BleSerial bleSerial;
 #endif
 
+static uint32_t NetworkMaxJitter; // [us] deviation of network task period
+
+static void Network_Task(void *parameter);
+static void Network_Perform(void);
+static void ImuLink_Perform(const Imu2EspFrame_t *frame, bool frameReceived);
+
 void onAPStationConnected(WiFiEvent_t event, WiFiEventInfo_t info) {
   Serial.println("Client connected:");
   softApTimeout.enabled = false;
@@ -86,13 +102,14 @@ void setup(void){
   pinMode(LED_PIN_YELLOW, OUTPUT);
 
   Serial.begin(115200);
-  ImuCommunication_Init();
+  ImuCommunication_Init(ImuLink_Perform);
   
   Serial.println("Firmware verion: "FIRMWARE_V);
 
   if(Wifi_Connect())
   {
      MqttNode_Connect(broker, port);
+     TimeBase_StartSntp();
 
      Serial.println("");
      Serial.print("Connected to ");
@@ -131,15 +148,83 @@ void setup(void){
     brokerMsgStatusTime = millis();
 
     LastIMUConnectedTime = millis();
+
+    xTaskCreatePinnedToCore(Network_Task, "network", NETWORK_TASK_STACK, NULL, NETWORK_TASK_PRIORITY, NULL, NETWORK_TASK_CORE);
 }
 
 void loop(void)
+{
+  // All work is done in IMU link and network tasks
+  vTaskDelete(NULL);
+}
+
+// IMU link task, a firmware update owns the link until the new image is up
+static void ImuLink_Perform(const Imu2EspFrame_t *frame, bool frameReceived)
+{
+  if (!FirmwareUpload_IsActive())
+  {
+    RouteUpload_Perform(frame, frameReceived);
+  }
+  FirmwareUpload_Perform(frame, frameReceived);
+}
+
+#ifdef LINK_STATS
+static void Network_PrintLinkStats(void)
+{
+  ImuLinkStats stats;
+  ProtocolHello_t peer;
+
+  if (ImuCommunication_GetPeer(&peer))
+  {
+    Serial.printf("IMU protocol: version %u, layout %04X (ESP %04X), common features %04X\n",
+                  peer.version, peer.layoutHash, dPROTOCOL_LAYOUT_HASH, ProtocolHello_CommonFeatures(&peer));
+  }
+  ImuCommunication_GetStats(&stats, true);
+  Serial.printf("IMU link: %u baud, %u rate changes, frames %u, crc errors %u, overflows %u, frame gap %u..%u ms, control delay %u us, command ack %u us, stops %u, stop reaction %u us, network jitter %u us\n",
+                stats.baud, stats.rateChanges, stats.frames, stats.crcErrors, stats.overflows,
+                (stats.frames > 1) ? stats.minFrameGap : 0, stats.maxFrameGap, stats.maxControlDelay, stats.maxCommandAck,
+                stats.stops, stats.maxStopReaction, NetworkMaxJitter);
+  NetworkMaxJitter = 0;
+
+  TelemetryStats telemetry;
+  TelemetryStream_GetStats(&telemetry, true);
+  Serial.printf("Web telemetry: %u subscribers, frames %u, sent %u, dropped %u\n",
+                telemetry.subscribers, telemetry.frames, telemetry.sent, telemetry.dropped);
+
+  WebServedStats served;
+  WebHandler_GetServedStats(&served, true);
+  Serial.printf("Web pages: %u requests, %u not modified, %u bytes, heap free %u, lowest %u\n",
+                served.requests, served.notModified, served.bytes, ESP.getFreeHeap(), ESP.getMinFreeHeap());
+}
+#endif
+
+static void Network_Task(void *parameter)
+{
+  TickType_t lastWake = xTaskGetTickCount();
+  uint32_t lastTime = micros();
+  uint32_t now, period;
+
+  for (;;)
+  {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(NETWORK_PERIOD));
+
+    now = micros();
+    period = now - lastTime;
+    lastTime = now;
+    NetworkMaxJitter = max(NetworkMaxJitter, (uint32_t)abs((int32_t)(period - NETWORK_PERIOD * 1000)));
+
+    Network_Perform();
+  }
+}
+
+static void Network_Perform(void)
 {
   static unsigned long timeBaseCurrent;
   static unsigned long timeBase10ms;
-  static unsigned long timeBase100ms;
   static unsigned long timeBase500ms;
   static unsigned long timeBase1s;
+  static unsigned long timeBase10s;
+  static uint32_t imuFrameCount;
 
     // LastIMUConnectedTime = millis();
 
@@ -163,8 +248,11 @@ void loop(void)
     {
       timeBase10ms = timeBaseCurrent;
 
-      if(ImuCommunication_Rx(&Imu2EspFrame))
+      Imu2EspFrame_t Imu2EspFrame;
+      uint32_t frameCount = ImuCommunication_GetStatus(&Imu2EspFrame);
+      if(frameCount != imuFrameCount)
       {
+        imuFrameCount = frameCount;
 #ifdef BLE_SERIAL
         bleSerial.println("IMU Data received");
 #endif
@@ -183,16 +271,14 @@ void loop(void)
 */      
       }
 
-    } // end of 10ms
-
-    //------- 100ms --------//
-    if ((unsigned long)(timeBaseCurrent - timeBase100ms) >= (100U))
-    {
-      timeBase100ms = timeBaseCurrent;
+      if (WiFi.getMode() == WIFI_STA)
+      {
+        MqttNode_Poll();
+      }
 
-      ImuCommunication_Tx(&Esp2ImuFrame);
+      WebHandler_SendTelemetry();
 
-    } // end of 100ms
+    } // end of 10ms
 
     //------- 500ms -----//
     if ((unsigned long)(timeBaseCurrent - timeBase500ms) >= (500U))
@@ -253,6 +339,18 @@ void loop(void)
 
     } // end of 1s
 
+    if ((unsigned long)(timeBaseCurrent - timeBase10s) >= (LINK_STATS_PERIOD))
+    {
+      timeBase10s = timeBaseCurrent;
+      if (WiFi.getMode() == WIFI_STA)
+      {
+        MqttNode_PublishLatency();
+      }
+#ifdef LINK_STATS
+      Network_PrintLinkStats();
+#endif
+    }
+
     // if (WiFi.getMode() == WIFI_STA && !MqttNode_IsConnected())
     // {
     //   Serial.println("Disconnected from broker, reconnecting...");
@@ -279,7 +377,7 @@ void loop(void)
 #ifdef BLE_SERIAL    
     bleSerial.perform();
 #endif
-  } // end of loop ///////////////////////////////////////////////////////////////
+  } // end of Network_Perform ///////////////////////////////////////////////////////////////
 
   float CalculateDegreeFromPi(int32_t Degree)
   {
@@ -0,0 +1,339 @@
+#include "FirmwareUpload.h"
+#include "src/ImuCommunication/ImuCommunication.h"
+#include "src/Melkens_Lib/CRC16/CRC16.h"
+#include "src/Melkens_Lib/FwUpdate/FwUpdate.h"
+#include "src/Melkens_Lib/LinkSpeed/LinkSpeed.h"
+#include "src/Melkens_Lib/Types/MessageCodec.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define FIRMWARE_UPLOAD_WINDOW   4     // blocks in flight, loaders buffer 2 KB
+#define FIRMWARE_REQUEST_PERIOD  20    // [ms] FW_UPDATE frame repeat
+#define FIRMWARE_REQUEST_QUIET   200   // [ms] without IMU frame the loader runs
+#define FIRMWARE_REQUEST_TIMEOUT 1000  // [ms] IMU keeps sending frames: request refused
+#define FIRMWARE_BOOT_TIMEOUT    15000 // [ms] for the new application to answer
+#define FIRMWARE_CRC_CHUNK       512   // [bytes] on link task stack
+
+const char* imuFirmwareFile = "/fw_imu.new";
+const char* pmbFirmwareFile = "/fw_pmb.new";
+// Last image the application came up with, sent again when a new one does not
+static const char* KeptFiles[] = { NULL, "/fw_imu.bin", "/fw_pmb.bin" };
+
+typedef struct {
+    volatile FirmwareUploadStep step;
+    volatile uint8_t target;        // dFW_TARGET_...
+    uint8_t rate;                   // dLINK_RATE_... of the loaders
+    bool isRollback;                // sending the kept image
+    File file;
+    FwImageHeader header;
+    FwSender sender;
+    volatile uint16_t blockCount;
+    volatile uint16_t ackedBlocks;
+    volatile uint8_t loaderState;
+    uint32_t stepTime;              // [ms]
+    uint32_t frameTime;             // [ms] last IMU frame
+    uint32_t requestTime;           // [ms] last FW_UPDATE frame
+} FirmwareUpload_t;
+
+static FirmwareUpload_t Upload;     // link task
+static uint8_t Packet[dFW_PACKET_MAX];
+static uint8_t PendingTarget;       // passed from FirmwareUpload_Start to link task
+static portMUX_TYPE PendingLock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char* FirmwareUpload_NewFile(uint8_t target)
+{
+    return (target == dFW_TARGET_PMB) ? pmbFirmwareFile : imuFirmwareFile;
+}
+
+// Rate the link runs at now, the loaders start at it
+static uint8_t FirmwareUpload_LinkRate(void)
+{
+    ImuLinkStats stats;
+
+    ImuCommunication_GetStats(&stats, false);
+    for (uint8_t rate = dLINK_RATE_NUM_OF; rate-- > 0;)
+    {
+        if (LinkSpeed_RateToBaud(rate) == stats.baud)
+        {
+            return rate;
+        }
+    }
+    return dLINK_RATE_115200;
+}
+
+static bool FirmwareUpload_Read(uint32_t offset, uint8_t *data, uint16_t length)
+{
+    return Upload.file.seek(offset) && Upload.file.read(data, length) == length;
+}
+
+static void FirmwareUpload_Send(void)
+{
+    uint16_t length;
+
+    while ((length = FwSender_Poll(&Upload.sender, Packet, millis())) > 0)
+    {
+        ImuCommunication_Write(Packet, length);
+    }
+    Upload.ackedBlocks = Upload.sender.AckedBlocks;
+    Upload.loaderState = Upload.sender.LoaderState;
+}
+
+// ImuRawHandler, loader answers
+static void FirmwareUpload_RawReceived(const uint8_t *data, size_t length)
+{
+    FwSender_Receive(&Upload.sender, data, length, millis());
+    FirmwareUpload_Send();
+}
+
+static void FirmwareUpload_Finish(FirmwareUploadStep step)
+{
+    Upload.file.close();
+    Upload.step = step;
+    Serial.printf("Firmware upload %s, %u/%u blocks\n",
+                  (step == FirmwareUpload_Done) ? "done" : (step == FirmwareUpload_RolledBack) ? "rolled back" : "failed",
+                  Upload.ackedBlocks, Upload.blockCount);
+}
+
+// Opens the image, CRC is read from the file in chunks (images are larger than free heap)
+static bool FirmwareUpload_Open(const char *path)
+{
+    uint8_t chunk[FIRMWARE_CRC_CHUNK];
+    uint16_t crc = dCRC16_INIT;
+    size_t size, length;
+
+    Upload.file.close();
+    Upload.file = LittleFS.open(path, "r");
+    size = Upload.file ? Upload.file.size() : 0;
+    if (size == 0)
+    {
+        return false;
+    }
+    while ((length = Upload.file.read(chunk, sizeof(chunk))) > 0)
+    {
+        crc = CRC16_Update(crc, chunk, (uint16_t)length);
+    }
+
+    // same image gives the same version, a broken transfer is resumed
+    FwImage_MakeHeader(&Upload.header, Upload.target, ((uint32_t)crc << 16) | (size & 0xFFFF), size, crc);
+    Upload.blockCount = (size + dFW_BLOCK_SIZE - 1) / dFW_BLOCK_SIZE;
+    Upload.ackedBlocks = 0;
+    Upload.loaderState = dFW_STATE_IDLE;
+    return true;
+}
+
+static void FirmwareUpload_Begin(bool isRollback)
+{
+    const char *path = isRollback ? KeptFiles[Upload.target] : FirmwareUpload_NewFile(Upload.target);
+
+    Upload.isRollback = isRollback;
+    if (!FirmwareUpload_Open(path))
+    {
+        Serial.printf("Firmware upload: cannot read %s\n", path);
+        FirmwareUpload_Finish(FirmwareUpload_Failed);
+        return;
+    }
+    // the kept image goes at base rate, the link may be why the new one failed
+    Upload.rate = isRollback ? dLINK_RATE_115200 : FirmwareUpload_LinkRate();
+    Upload.step = FirmwareUpload_Request;
+    Upload.stepTime = millis();
+    Upload.frameTime = Upload.stepTime;
+    Upload.requestTime = Upload.stepTime - FIRMWARE_REQUEST_PERIOD;
+}
+
+static void FirmwareUpload_Fail(void)
+{
+    if (!Upload.isRollback && LittleFS.exists(KeptFiles[Upload.target]))
+    {
+        Serial.println("Firmware upload: sending kept image");
+        FirmwareUpload_Begin(true);
+        return;
+    }
+    FirmwareUpload_Finish(FirmwareUpload_Failed);
+}
+
+static void FirmwareUpload_Booted(void)
+{
+    Upload.file.close();
+    if (Upload.isRollback)
+    {
+        FirmwareUpload_Finish(FirmwareUpload_RolledBack);
+        return;
+    }
+    LittleFS.remove(KeptFiles[Upload.target]);
+    LittleFS.rename(FirmwareUpload_NewFile(Upload.target), KeptFiles[Upload.target]);
+    FirmwareUpload_Finish(FirmwareUpload_Done);
+}
+
+static void FirmwareUpload_AskLoader(bool frameReceived)
+{
+    uint32_t now = millis();
+    ProtocolHello_t peer;
+    Esp2ImuFrame_t frame = {};
+
+    if (ImuCommunication_IsStopped())
+    {
+        // not while stopped, application refuses while a route is driven anyway
+        Upload.stepTime = now;
+        Upload.frameTime = now;
+        return;
+    }
+    if (frameReceived)
+    {
+        Upload.frameTime = now;
+        if (ImuCommunication_GetPeer(&peer) && !(ProtocolHello_CommonFeatures(&peer) & dPROTOCOL_FEATURE_FW_UPDATE))
+        {
+            Serial.println("Firmware upload: IMU application has no loader request");
+            FirmwareUpload_Finish(FirmwareUpload_Failed);
+            return;
+        }
+    }
+
+    if ((now - Upload.frameTime) >= FIRMWARE_REQUEST_QUIET)
+    {
+        // IMU is in its loader (asked now or left there by a failed image)
+        ImuCommunication_SetRaw(FirmwareUpload_RawReceived, Upload.rate);
+        FwSender_Start(&Upload.sender, &Upload.header, FirmwareUpload_Read, FIRMWARE_UPLOAD_WINDOW, now);
+        Upload.step = FirmwareUpload_Transfer;
+        Upload.stepTime = now;
+        FirmwareUpload_Send();
+        return;
+    }
+    if ((now - Upload.stepTime) >= FIRMWARE_REQUEST_TIMEOUT)
+    {
+        // PMB link slower than this one or a route is driven
+        if (Upload.rate == dLINK_RATE_115200)
+        {
+            Serial.println("Firmware upload: IMU refused the loader request");
+            FirmwareUpload_Finish(FirmwareUpload_Failed);
+            return;
+        }
+        Upload.rate = dLINK_RATE_115200;
+        Upload.stepTime = now;
+    }
+    if ((now - Upload.requestTime) >= FIRMWARE_REQUEST_PERIOD)
+    {
+        Upload.requestTime = now;
+        frame.frameType = dESP2IMU_FRAME_FW_UPDATE;
+        frame.fwTarget = Upload.target;
+        frame.fwRate = Upload.rate;
+        ImuCommunication_Tx(&frame);
+    }
+}
+
+bool FirmwareUpload_Start(uint8_t target)
+{
+    File file;
+
+    if ((target != dFW_TARGET_IMU && target != dFW_TARGET_PMB) || FirmwareUpload_IsActive())
+    {
+        return false;
+    }
+    if (!(dPROTOCOL_FEATURES & dPROTOCOL_FEATURE_FW_UPDATE))
+    {
+        // no loader to reset into on IMU or PMB, image stays in LittleFS
+        Serial.println("Firmware upload: loaders not available");
+        return false;
+    }
+    file = LittleFS.open(FirmwareUpload_NewFile(target), "r");
+    if (!file || file.size() == 0)
+    {
+        Serial.println("Firmware upload: no image");
+        return false;
+    }
+    file.close();
+
+    portENTER_CRITICAL(&PendingLock);
+    PendingTarget = target;
+    portEXIT_CRITICAL(&PendingLock);
+    return true;
+}
+
+void FirmwareUpload_Perform(const Imu2EspFrame_t *frame, bool frameReceived)
+{
+    uint8_t target;
+
+    portENTER_CRITICAL(&PendingLock);
+    target = PendingTarget;
+    PendingTarget = dFW_TARGET_NONE;
+    portEXIT_CRITICAL(&PendingLock);
+    if (target != dFW_TARGET_NONE && !FirmwareUpload_IsActive())
+    {
+        Upload.target = target;
+        FirmwareUpload_Begin(false);
+        return;
+    }
+
+    switch (Upload.step)
+    {
+    case FirmwareUpload_Request:
+        FirmwareUpload_AskLoader(frameReceived);
+        break;
+
+    case FirmwareUpload_Transfer:
+        // timeouts of the sender, packets go out from FirmwareUpload_RawReceived
+        FirmwareUpload_Send();
+        if (Upload.sender.Step == FwSender_Done || Upload.sender.Step == FwSender_Failed)
+        {
+            // loader starts the application, it comes up at base rate with frames
+            ImuCommunication_SetRaw(NULL, dLINK_RATE_115200);
+            Upload.stepTime = millis();
+            if (Upload.sender.Step == FwSender_Done)
+            {
+                Upload.step = FirmwareUpload_Boot;
+            }
+            else
+            {
+                Serial.printf("Firmware upload: loader state %u\n", Upload.loaderState);
+                FirmwareUpload_Fail();
+            }
+        }
+        break;
+
+    case FirmwareUpload_Boot:
+        // PMB image is up once the IMU application talks to it again
+        if (frameReceived && (Upload.target == dFW_TARGET_IMU || frame->pmbConnection))
+        {
+            FirmwareUpload_Booted();
+        }
+        else if ((millis() - Upload.stepTime) >= FIRMWARE_BOOT_TIMEOUT)
+        {
+            FirmwareUpload_Fail();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+bool FirmwareUpload_IsActive(void)
+{
+    FirmwareUploadStep step = Upload.step;
+
+    return step == FirmwareUpload_Request || step == FirmwareUpload_Transfer || step == FirmwareUpload_Boot;
+}
+
+FirmwareUploadStep FirmwareUpload_GetStep(void)
+{
+    return Upload.step;
+}
+
+uint8_t FirmwareUpload_GetTarget(void)
+{
+    return Upload.target;
+}
+
+uint16_t FirmwareUpload_GetBlockCount(void)
+{
+    return Upload.blockCount;
+}
+
+uint16_t FirmwareUpload_GetAckedBlocks(void)
+{
+    return Upload.ackedBlocks;
+}
+
+uint8_t FirmwareUpload_GetLoaderState(void)
+{
+    return Upload.loaderState;
+}
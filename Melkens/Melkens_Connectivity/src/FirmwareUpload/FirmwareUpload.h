@@ -0,0 +1,47 @@
+#ifndef FIRMWARE_UPLOAD_H
+#define FIRMWARE_UPLOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "src/Melkens_Lib/Types/MessageTypes.h"
+
+// Sends an IMU or PMB firmware image from LittleFS to the loader of the MCU
+// (Melkens_Lib/FwUpdate). The IMU application is asked to start its loader
+// with dESP2IMU_FRAME_FW_UPDATE (for the PMB it passes the request on and
+// its loader bridges the stream), then the link runs raw at the same rate
+// until the image is committed. The image is taken once the new application
+// answers; otherwise the image kept from the last good update is sent again.
+// Off while dPROTOCOL_FEATURE_FW_UPDATE is not offered: the IMU and PMB
+// loaders are not in the tree yet.
+// FirmwareUpload_Perform runs in IMU link task, the other functions can be
+// called from any task.
+
+typedef enum FirmwareUploadStep_t {
+    FirmwareUpload_Idle = 0,
+    FirmwareUpload_Request,     // application asked to start the loader
+    FirmwareUpload_Transfer,    // loader receives the image
+    FirmwareUpload_Boot,        // waiting for the new application
+    FirmwareUpload_Done,
+    FirmwareUpload_RolledBack,  // new image did not come up, kept image sent again
+    FirmwareUpload_Failed,
+} FirmwareUploadStep;
+
+extern const char* imuFirmwareFile;
+extern const char* pmbFirmwareFile;
+
+// Hands imuFirmwareFile or pmbFirmwareFile (dFW_TARGET_...) over to link
+// task, false when the file is missing or empty, an update runs or the
+// update is off
+bool FirmwareUpload_Start(uint8_t target);
+// ImuLinkHandler, frameReceived when frame was just received
+void FirmwareUpload_Perform(const Imu2EspFrame_t *frame, bool frameReceived);
+// Link is taken by the update, frames of other uploads wait
+bool FirmwareUpload_IsActive(void);
+FirmwareUploadStep FirmwareUpload_GetStep(void);
+uint8_t FirmwareUpload_GetTarget(void);
+uint16_t FirmwareUpload_GetBlockCount(void);
+uint16_t FirmwareUpload_GetAckedBlocks(void);
+// dFW_STATE_... last reported by the loader
+uint8_t FirmwareUpload_GetLoaderState(void);
+
+#endif // FIRMWARE_UPLOAD_H
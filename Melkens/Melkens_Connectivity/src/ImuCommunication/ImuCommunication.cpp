@@ -1,51 +1,543 @@
 #include "ImuCommunication.h"
+#include "Snapshot.h"
+#include "LatencyTrace.h"
 #include "src/Melkens_Lib/CRC16/CRC16.h"
+#include "src/Melkens_Lib/Types/MessageCodec.h"
+#include "src/Melkens_Lib/TimeSync/TimeSync.h"
+#include "src/Melkens_Lib/LinkSpeed/LinkSpeed.h"
+#include "src/TimeBase/TimeBase.h"
 #include <Arduino.h>
-#include <HardwareSerial.h>
+#include <driver/uart.h>
 
 
-#define IMU_SERIAL Serial1
+#define IMU_UART UART_NUM_1
 
 #define IMU_TX GPIO_NUM_17
 #define IMU_RX GPIO_NUM_18
-#define IMU_BAUD    115200
+#define IMU_MAX_RATE dLINK_RATE_2000000  // highest baud rate negotiated with IMU
 
-#define IMU_SERIAL_TIMEOUT 5000 // Timeout for IMU serial communication
+#define IMU_UART_RX_BUFFER  1024
+#define IMU_UART_TX_BUFFER  512  // frames are queued, transmission is not awaited
+#define IMU_UART_QUEUE_SIZE 16
+#define IMU_UART_RX_TIMEOUT 2    // [symbols] line idle time raising UART_DATA event at the end of a frame
 
-Imu2EspFrame_t Imu2EspFrame;
-Esp2ImuFrame_t Esp2ImuFrame;
+#define IMU_WRITE_QUEUE_SIZE 4
+#define IMU_WRITE_MAX       32   // raw bytes per ImuCommunication_Write from other tasks
 
-void ImuCommunication_Init(void)
+#define IMU_LINK_STACK      4096
+
+typedef struct {
+    Esp2ImuFrame_t frame;
+    uint32_t changeTime; // [us]
+    bool stop;           // emergency stop, sent as dESP2IMU_FRAME_STOP with frame.commandSequence
+} ImuControl_t;
+
+typedef struct {
+    uint8_t length;
+    uint8_t data[IMU_WRITE_MAX];
+} ImuWrite_t;
+
+static Snapshot<Imu2EspFrame_t> StatusSnapshot;
+static Snapshot<ImuControl_t> ControlSnapshot;
+static Snapshot<ImuLinkStats> StatsSnapshot;
+static Snapshot<ProtocolHello_t> PeerSnapshot;
+static std::atomic<bool> StatsReset;
+static std::atomic<bool> Stopped;       // ControlSnapshot holds a stop
+static std::atomic<bool> StopRequested; // stop goes out without IMU_CONTROL_MIN_INTERVAL
+static SemaphoreHandle_t ControlEvent;  // given by SetControl and SetStop on change
+
+// Link task only
+static QueueHandle_t UartQueue;
+static QueueHandle_t WriteQueue;        // raw bytes of other tasks, written by link task
+static QueueSetHandle_t LinkEvents;     // UART events, ControlEvent and WriteQueue
+static ImuControl_t SentControl;
+static bool SentControlAcked = true;
+static bool SentControlTraced = true;
+static uint32_t SentControlTxTime;  // [us] first UART write of SentControl command
+static bool SentStopMeasured = true;
+static ImuLinkHandler Handler;
+static Imu2EspFrame_t Imu2EspFrame;
+static uint8_t RxBuffer[2 * sizeof(Imu2EspFrame_t)];
+static size_t RxLength;
+static bool RxSynchronised = true;
+static uint32_t LastFrameTime;
+static uint32_t LastPerformTime;
+static ImuLinkStats Stats;
+static TimeSync Sync;               // ESP is time master of the link, echoes IMU stamps
+static bool PeerKnown;              // IMU answered protocol hello since link came up
+static uint16_t PeerFeatures;       // dPROTOCOL_FEATURE_... common with IMU
+static LinkSpeed Speed;             // ESP is master of the link baud rate
+static bool SpeedSwitching;         // SWITCH sent, next frame follows after IMU_CONTROL_MIN_INTERVAL
+static ImuRawHandler RawHandler;    // link is raw, no frames
+static TaskHandle_t LinkTask;       // the only task writing to IMU_UART
+
+static void ImuCommunication_ResetStats(void)
+{
+    memset(&Stats, 0, sizeof(Stats));
+    Stats.minFrameGap = UINT32_MAX;
+    Stats.baud = LinkSpeed_GetBaud(&Speed);
+}
+
+static void ImuCommunication_FrameReceived(void)
+{
+    uint32_t now = millis();
+    uint32_t gap = now - LastFrameTime;
+
+    if (Stats.frames++ > 0)
+    {
+        Stats.minFrameGap = min(Stats.minFrameGap, gap);
+        Stats.maxFrameGap = max(Stats.maxFrameGap, gap);
+    }
+    LastFrameTime = now;
+    TimeSync_Receive(&Sync, &Imu2EspFrame.sync, micros(), false);
+    LinkSpeed_Receive(&Speed, &Imu2EspFrame.link, now);
+
+    if (!SentControlAcked && Imu2EspFrame.commandSequence == SentControl.frame.commandSequence)
+    {
+        SentControlAcked = true;
+        Stats.maxCommandAck = max(Stats.maxCommandAck, (uint32_t)(micros() - SentControl.changeTime));
+    }
+    if (SentControl.stop && !SentStopMeasured && Imu2EspFrame.stopTime == SentControl.changeTime &&
+        Imu2EspFrame.stopReaction != dSTOP_REACTION_UNKNOWN)
+    {
+        // measured by PMB in shared time, request here to stop commands queued for all inverters
+        SentStopMeasured = true;
+        Stats.stops++;
+        Stats.maxStopReaction = max(Stats.maxStopReaction, (uint32_t)Imu2EspFrame.stopReaction);
+        if (Imu2EspFrame.stopReaction > IMU_STOP_REACTION_BUDGET)
+        {
+            Serial.printf("Emergency stop took %u us\n", Imu2EspFrame.stopReaction);
+        }
+    }
+    if (!SentControlTraced && Imu2EspFrame.trace.traceId == SentControl.frame.commandSequence)
+    {
+        SentControlTraced = true;
+        if (PeerFeatures & dPROTOCOL_FEATURE_TRACE)
+        {
+            LatencyTrace_Add(&Imu2EspFrame.trace, SentControl.changeTime, SentControlTxTime, micros());
+        }
+    }
+
+    StatusSnapshot.write(Imu2EspFrame);
+    Handler(&Imu2EspFrame, true);
+    LastPerformTime = now;
+}
+
+// IMU answer to protocol hello at the start of RxBuffer
+static bool ImuCommunication_HelloReceived(void)
+{
+    ProtocolHello_t hello;
+
+    ProtocolHello_Unpack(&hello, RxBuffer);
+    if (!ProtocolHello_Check(&hello))
+    {
+        return false;
+    }
+
+    PeerKnown = true;
+    PeerFeatures = ProtocolHello_CommonFeatures(&hello);
+    PeerSnapshot.write(hello);
+    if (hello.layoutHash != dPROTOCOL_LAYOUT_HASH)
+    {
+        Serial.printf("IMU protocol mismatch: IMU version %u layout %04X, ESP version %u layout %04X\n",
+                      hello.version, hello.layoutHash, PROTOCOL_VERSION, dPROTOCOL_LAYOUT_HASH);
+    }
+    return true;
+}
+
+// Reads everything UART driver has buffered, frames are found by CRC so the
+// link resynchronises after lost or corrupted bytes. Protocol hello is found
+// by magic and CRC whatever the frame layout of the IMU firmware is.
+static void ImuCommunication_Rx(void)
 {
-    IMU_SERIAL.begin(IMU_BAUD, SERIAL_8N1, IMU_RX, IMU_TX);
-    //IMU_SERIAL.setTimeout(dTIMEOUT_UART_ERROR); //todo: check if needed
-    IMU_SERIAL.setRxBufferSize(sizeof(Imu2EspFrame_t));
-    //IMU_SERIAL.setWriteTimeout(IMU_SERIAL_TIMEOUT);
+    const size_t crcOffset = offsetof(Imu2EspFrame_t, crc);
+    int length;
+
+    do
+    {
+        length = uart_read_bytes(IMU_UART, &RxBuffer[RxLength], sizeof(RxBuffer) - RxLength, 0);
+        if (length > 0)
+        {
+            RxLength += length;
+        }
+
+        while (RxLength >= sizeof(ProtocolHello_t))
+        {
+            if (ImuCommunication_HelloReceived())
+            {
+                RxLength -= sizeof(ProtocolHello_t);
+                memmove(RxBuffer, &RxBuffer[sizeof(ProtocolHello_t)], RxLength);
+                RxSynchronised = true;
+                continue;
+            }
+            if (RxLength < sizeof(Imu2EspFrame_t))
+            {
+                break;
+            }
+
+            if (Imu2EspFrameView_GetCrc(RxBuffer) == CRC16(RxBuffer, crcOffset))
+            {
+                Imu2EspFrame_Unpack(&Imu2EspFrame, RxBuffer);
+                RxLength -= sizeof(Imu2EspFrame_t);
+                memmove(RxBuffer, &RxBuffer[sizeof(Imu2EspFrame_t)], RxLength);
+                RxSynchronised = true;
+                ImuCommunication_FrameReceived();
+            }
+            else
+            {
+                // garbage right after a baud rate change is expected
+                if (RxSynchronised && LinkSpeed_Error(&Speed, millis()))
+                {
+                    Stats.crcErrors++;
+                    Serial.println("Invalid IMU frame received");
+                }
+                RxSynchronised = false;
+                RxLength--;
+                memmove(RxBuffer, &RxBuffer[1], RxLength);
+            }
+        }
+    } while (length > 0);
+}
+
+// Raw link, everything buffered goes to RawHandler
+static void ImuCommunication_RawRx(void)
+{
+    int length;
+
+    do
+    {
+        length = uart_read_bytes(IMU_UART, RxBuffer, sizeof(RxBuffer), 0);
+        if (length > 0)
+        {
+            RawHandler(RxBuffer, length);
+        }
+    } while (length > 0 && RawHandler != NULL);
+}
+
+// Applies a baud rate change once the frame being sent is out, bytes of the
+// old rate still buffered are dropped
+static void ImuCommunication_PerformSpeed(void)
+{
+    if (!LinkSpeed_Perform(&Speed, millis()))
+    {
+        return;
+    }
+    uart_wait_tx_done(IMU_UART, pdMS_TO_TICKS(IMU_CONTROL_MIN_INTERVAL));
+    uart_set_baudrate(IMU_UART, LinkSpeed_GetBaud(&Speed));
+    uart_flush_input(IMU_UART);
+    RxLength = 0;
+    RxSynchronised = true;
+    Stats.baud = LinkSpeed_GetBaud(&Speed);
+    Stats.rateChanges++;
+    Serial.printf("IMU link: %u baud\n", LinkSpeed_GetBaud(&Speed));
+}
+
+static void ImuCommunication_SendControl(void)
+{
+    ImuControl_t control;
+    Esp2ImuFrame_t frame = {};
+
+    ControlSnapshot.read(control);
+    if (control.stop && (PeerFeatures & dPROTOCOL_FEATURE_STOP))
+    {
+        frame.frameType = dESP2IMU_FRAME_STOP;
+        frame.stopSequence = control.frame.commandSequence;
+        frame.stopTime = control.changeTime;
+        ImuCommunication_Tx(&frame);
+    }
+    else
+    {
+        // IMU without stop frames gets the stop as control frame with everything off
+        ImuCommunication_Tx(&control.frame);
+    }
+
+    if (control.frame.commandSequence != SentControl.frame.commandSequence)
+    {
+        SentControlAcked = false;
+        SentControlTraced = false;
+        SentStopMeasured = !control.stop;
+        SentControlTxTime = micros();
+        Stats.maxControlDelay = max(Stats.maxControlDelay, SentControlTxTime - control.changeTime);
+    }
+    SentControl = control;
+}
+
+// Repeated until IMU answers, again after link loss (IMU may run other firmware)
+static void ImuCommunication_SendHello(void)
+{
+    Esp2ImuFrame_t frame = {};
+
+    frame.frameType = dESP2IMU_FRAME_HELLO;
+    ProtocolHello_Make(&frame.hello);
+    ImuCommunication_Tx(&frame);
 }
 
-bool ImuCommunication_Rx(Imu2EspFrame_t *frame)
+static void ImuCommunication_Task(void *parameter)
 {
-    if (IMU_SERIAL.available() >= sizeof(Imu2EspFrame_t))
+    QueueSetMemberHandle_t member;
+    uart_event_t event;
+    ImuWrite_t write;
+    uint32_t now, wait;
+    uint32_t lastControlTime = millis();
+    uint32_t lastHelloTime = lastControlTime - IMU_HELLO_PERIOD;
+    bool controlPending = false;
+    bool stopPending = false;
+
+    for (;;)
     {
-        IMU_SERIAL.readBytes((uint8_t*)frame, sizeof(Imu2EspFrame_t));
+        // control change waits only for IMU_CONTROL_MIN_INTERVAL since last control frame
+        wait = IMU_LINK_PERIOD;
+        if (controlPending)
+        {
+            wait = IMU_CONTROL_MIN_INTERVAL - min((uint32_t)IMU_CONTROL_MIN_INTERVAL, millis() - lastControlTime);
+        }
+
+        member = xQueueSelectFromSet(LinkEvents, pdMS_TO_TICKS(wait));
+        if (member == ControlEvent)
+        {
+            xSemaphoreTake(ControlEvent, 0);
+            controlPending = true;
+            stopPending = StopRequested.exchange(false);
+        }
+        else if (member == WriteQueue && xQueueReceive(WriteQueue, &write, 0) == pdTRUE)
+        {
+            // between whole frames, dropped while the loader owns the line
+            if (RawHandler == NULL)
+            {
+                uart_write_bytes(IMU_UART, write.data, write.length);
+            }
+        }
+        else if (member == UartQueue && xQueueReceive(UartQueue, &event, 0) == pdTRUE)
+        {
+            switch (event.type)
+            {
+            case UART_DATA:
+                if (RawHandler != NULL)
+                {
+                    ImuCommunication_RawRx();
+                }
+                else
+                {
+                    ImuCommunication_Rx();
+                }
+                break;
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                uart_flush_input(IMU_UART);
+                RxLength = 0;
+                Stats.overflows++;
+                break;
+            default:
+                break;
+            }
+        }
 
-        if ((frame->crc) == CRC16((uint8_t *)frame, sizeof(Imu2EspFrame_t) - sizeof(frame->crc)))
+        now = millis();
+        if ((now - LastPerformTime) >= IMU_LINK_PERIOD)
+        {
+            LastPerformTime = now;
+            Handler(&Imu2EspFrame, false);
+        }
+        if (RawHandler != NULL)
         {
-            return true; // Valid frame received
+            // loader owns the line, control and hello wait for the frames to come back
+            controlPending = false;
+            stopPending = false;
+            lastControlTime = now;
+            lastHelloTime = now - IMU_HELLO_PERIOD;
         }
         else
         {
-            frame->crcEsp2ImuErrorCount++; // Increment error count for CRC mismatch
-            Serial.println("Invalid IMU frame received");
-            return false; // Invalid frame
+            if (stopPending || (controlPending && (now - lastControlTime) >= IMU_CONTROL_MIN_INTERVAL) ||
+                (now - lastControlTime) >= IMU_CONTROL_PERIOD)
+            {
+                lastControlTime = now;
+                controlPending = false;
+                stopPending = false;
+                ImuCommunication_SendControl();
+                controlPending = SpeedSwitching;
+            }
+            ImuCommunication_PerformSpeed();
+            if (PeerKnown && (now - LastFrameTime) >= IMU_LINK_TIMEOUT)
+            {
+                PeerKnown = false;
+                PeerFeatures = 0;
+            }
+            if (!PeerKnown && (now - lastHelloTime) >= IMU_HELLO_PERIOD)
+            {
+                lastHelloTime = now;
+                ImuCommunication_SendHello();
+            }
         }
+
+        if (StatsReset.exchange(false))
+        {
+            ImuCommunication_ResetStats();
+        }
+        StatsSnapshot.write(Stats);
+        LatencyTrace_Perform();
+    }
+}
+
+void ImuCommunication_Init(ImuLinkHandler handler)
+{
+    uart_config_t config = {};
+
+    CRC16_Init();
+    TimeSync_Init(&Sync);
+    LinkSpeed_Init(&Speed, true, IMU_MAX_RATE, millis());
+    config.baud_rate = LinkSpeed_GetBaud(&Speed);
+    config.data_bits = UART_DATA_8_BITS;
+    config.parity = UART_PARITY_DISABLE;
+    config.stop_bits = UART_STOP_BITS_1;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_DEFAULT;
+
+    uart_driver_install(IMU_UART, IMU_UART_RX_BUFFER, IMU_UART_TX_BUFFER, IMU_UART_QUEUE_SIZE, &UartQueue, 0);
+    uart_param_config(IMU_UART, &config);
+    uart_set_pin(IMU_UART, IMU_TX, IMU_RX, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    uart_set_rx_timeout(IMU_UART, IMU_UART_RX_TIMEOUT);
+
+    ControlEvent = xSemaphoreCreateBinary();
+    WriteQueue = xQueueCreate(IMU_WRITE_QUEUE_SIZE, sizeof(ImuWrite_t));
+    LinkEvents = xQueueCreateSet(IMU_UART_QUEUE_SIZE + 1 + IMU_WRITE_QUEUE_SIZE);
+    xQueueAddToSet(UartQueue, LinkEvents);
+    xQueueAddToSet(ControlEvent, LinkEvents);
+    xQueueAddToSet(WriteQueue, LinkEvents);
+
+    ImuCommunication_ResetStats();
+    Handler = handler;
+    xTaskCreatePinnedToCore(ImuCommunication_Task, "imuLink", IMU_LINK_STACK, NULL, IMU_LINK_PRIORITY, &LinkTask, IMU_LINK_CORE);
+}
+
+uint32_t ImuCommunication_GetStatus(Imu2EspFrame_t *frame)
+{
+    return StatusSnapshot.read(*frame);
+}
+
+void ImuCommunication_GetControl(Esp2ImuFrame_t *frame)
+{
+    ImuControl_t control;
+
+    ControlSnapshot.read(control);
+    *frame = control.frame;
+}
+
+void ImuCommunication_SetControl(const Esp2ImuFrame_t *frame)
+{
+    ImuControl_t control;
+    Esp2ImuFrame_t next = *frame;
+
+    ControlSnapshot.read(control);
+    if (control.stop)
+    {
+        return; // only ImuCommunication_SetStop releases
     }
-    return false; // Not enough data available
+    next.frameType = dESP2IMU_FRAME_CONTROL;
+    next.commandSequence = control.frame.commandSequence;
+    next.crc = control.frame.crc;
+    if (memcmp(&next, &control.frame, sizeof(Esp2ImuFrame_t)) == 0)
+    {
+        return; // unchanged, keep-alive frames carry it
+    }
+
+    next.commandSequence++;
+    control.frame = next;
+    control.changeTime = micros();
+    ControlSnapshot.write(control);
+    xSemaphoreGive(ControlEvent);
+}
+
+void ImuCommunication_SetStop(bool stop)
+{
+    ImuControl_t control;
+
+    ControlSnapshot.read(control);
+    if (control.stop == stop)
+    {
+        return;
+    }
+
+    // released with everything off, next control change starts from there
+    control.frame.frameType = dESP2IMU_FRAME_CONTROL;
+    control.frame.moveX = 0;
+    control.frame.moveY = 0;
+    control.frame.augerSpeed = 0;
+    control.frame.rootAction = 0;
+    control.frame.commandSequence++;
+    control.changeTime = micros();
+    control.stop = stop;
+    ControlSnapshot.write(control);
+    Stopped = stop;
+    StopRequested = stop;
+    xSemaphoreGive(ControlEvent);
+}
+
+bool ImuCommunication_IsStopped(void)
+{
+    return Stopped;
 }
 
 void ImuCommunication_Tx(Esp2ImuFrame_t *frame)
 {
-    frame->crc = CRC16((uint8_t*)frame, sizeof(Esp2ImuFrame_t) - sizeof(frame->crc));
-    IMU_SERIAL.write((uint8_t *)frame, sizeof(Esp2ImuFrame_t));
-    IMU_SERIAL.flush(); // Ensure all data is sent
+    uint32_t txTime = micros() + dTIMESYNC_FRAME_TIME(sizeof(Esp2ImuFrame_t), LinkSpeed_GetBaud(&Speed));
+
+    // frames of other tasks would interleave on the UART and race the link state
+    configASSERT(xTaskGetCurrentTaskHandle() == LinkTask);
+    SpeedSwitching = LinkSpeed_Stamp(&Speed, &frame->link, millis());
+    TimeSync_Stamp(&Sync, &frame->sync, txTime, txTime, TimeBase_GetWeekTime(), 0);
+    Esp2ImuFrame_Seal(frame);
+    uart_write_bytes(IMU_UART, frame, sizeof(Esp2ImuFrame_t));
+}
+
+void ImuCommunication_Write(const uint8_t *data, size_t length)
+{
+    ImuWrite_t write;
+
+    if (xTaskGetCurrentTaskHandle() == LinkTask)
+    {
+        uart_write_bytes(IMU_UART, data, length);
+        return;
+    }
+    // other tasks never write to the UART themselves, a full queue drops
+    write.length = (uint8_t)min(length, sizeof(write.data));
+    memcpy(write.data, data, write.length);
+    xQueueSend(WriteQueue, &write, 0);
+}
+
+void ImuCommunication_SetRaw(ImuRawHandler handler, uint8_t rate)
+{
+    uart_wait_tx_done(IMU_UART, pdMS_TO_TICKS(IMU_CONTROL_PERIOD));
+    if (handler != NULL)
+    {
+        uart_set_baudrate(IMU_UART, LinkSpeed_RateToBaud(rate));
+    }
+    else
+    {
+        // IMU application starts at base rate, negotiation runs again
+        LinkSpeed_Init(&Speed, true, IMU_MAX_RATE, millis());
+        uart_set_baudrate(IMU_UART, LinkSpeed_GetBaud(&Speed));
+        PeerKnown = false;
+        PeerFeatures = 0;
+    }
+    uart_flush_input(IMU_UART);
+    RxLength = 0;
+    RxSynchronised = true;
+    RawHandler = handler;
+    Stats.baud = (handler != NULL) ? LinkSpeed_RateToBaud(rate) : LinkSpeed_GetBaud(&Speed);
+    Stats.rateChanges++;
+}
+
+bool ImuCommunication_GetPeer(ProtocolHello_t *peer)
+{
+    return PeerSnapshot.read(*peer) > 0;
+}
+
+void ImuCommunication_GetStats(ImuLinkStats *stats, bool reset)
+{
+    StatsSnapshot.read(*stats);
+    if (reset)
+    {
+        StatsReset = true;
+    }
 }
@@ -5,12 +5,65 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
-extern Imu2EspFrame_t Imu2EspFrame;
-extern Esp2ImuFrame_t Esp2ImuFrame;
+// IMU link runs in its own task pinned to IMU_LINK_CORE and is woken by the
+// UART event queue. Network tasks on the other core exchange data with it
+// only through the functions below (lock free snapshots).
 
-void ImuCommunication_Init(void);
-bool ImuCommunication_Rx(Imu2EspFrame_t *frame);
+#define IMU_LINK_CORE       1
+#define IMU_LINK_PRIORITY   10
+#define IMU_LINK_PERIOD     10  // [ms] handler is called at least this often
+#define IMU_CONTROL_PERIOD  100 // [ms] keep-alive control frame period when control does not change
+#define IMU_CONTROL_MIN_INTERVAL 8 // [ms] between control frames, changes in between are coalesced
+#define IMU_HELLO_PERIOD    1000 // [ms] protocol hello repeat until IMU answers
+#define IMU_LINK_TIMEOUT    3000 // [ms] without valid IMU frame protocol hello starts again
+#define IMU_STOP_REACTION_BUDGET 10000 // [us] emergency stop request to stop commands queued on PMB
+
+// Called in link task after each valid IMU frame and at least every IMU_LINK_PERIOD,
+// frame is the latest valid IMU frame
+typedef void (*ImuLinkHandler)(const Imu2EspFrame_t *frame, bool frameReceived);
+// Called in link task with the bytes received while the link is raw
+typedef void (*ImuRawHandler)(const uint8_t *data, size_t length);
+
+typedef struct {
+    uint32_t frames;          // valid IMU frames
+    uint32_t crcErrors;       // resynchronisations after CRC error
+    uint32_t overflows;       // UART FIFO or ring buffer overflows
+    uint32_t minFrameGap;     // [ms] shortest time between valid frames
+    uint32_t maxFrameGap;     // [ms] longest time between valid frames
+    uint32_t maxControlDelay; // [us] longest time from control change to UART write
+    uint32_t maxCommandAck;   // [us] longest time from control change to IMU acknowledge (includes PMB round trip)
+    uint32_t baud;            // current baud rate of the link
+    uint32_t rateChanges;     // baud rate changes including fallbacks to base rate
+    uint32_t stops;           // emergency stops with reaction reported by PMB
+    uint32_t maxStopReaction; // [us] longest time from stop request to stop commands queued on PMB
+} ImuLinkStats;
+
+void ImuCommunication_Init(ImuLinkHandler handler);
+// Copies latest valid IMU frame, returns number of frames received so far (0: none yet)
+uint32_t ImuCommunication_GetStatus(Imu2EspFrame_t *frame);
+void ImuCommunication_GetControl(Esp2ImuFrame_t *frame);
+// Changed control is sent to IMU at once with new commandSequence, call from network task context only
+void ImuCommunication_SetControl(const Esp2ImuFrame_t *frame);
+// Emergency stop, sent at once and repeated instead of control frames until
+// released. Control changes are ignored while stopped. Network task context only.
+void ImuCommunication_SetStop(bool stop);
+bool ImuCommunication_IsStopped(void);
+// Sends frame, link task context only (ImuLinkHandler). Other tasks hand
+// their data over to the handler, see RouteUpload_Start.
 void ImuCommunication_Tx(Esp2ImuFrame_t *frame);
+// Sends raw bytes. From other tasks up to 32 bytes are queued and written by
+// the link task between frames.
+void ImuCommunication_Write(const uint8_t *data, size_t length);
+// Raw link for the firmware loader (Melkens_Lib/FwUpdate): no frames, control,
+// hello or baud rate negotiation, received bytes go to handler, UART runs at
+// rate (dLINK_RATE_...). NULL goes back to frames at base rate, hello starts
+// again. Link task context only, ImuLinkHandler keeps being called.
+void ImuCommunication_SetRaw(ImuRawHandler handler, uint8_t rate);
+// Last protocol hello answered by IMU, false when IMU never answered
+bool ImuCommunication_GetPeer(ProtocolHello_t *peer);
+// Statistics since last reset
+void ImuCommunication_GetStats(ImuLinkStats *stats, bool reset);
 
 #endif // IMU_COMMUNICATION_H
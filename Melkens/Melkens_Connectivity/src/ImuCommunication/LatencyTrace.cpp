@@ -0,0 +1,113 @@
+#include "LatencyTrace.h"
+#include "Snapshot.h"
+#include <Arduino.h>
+#include <atomic>
+
+
+#define LATENCY_TRACE_TIME_RANGE 0x10000 // [us] 16 bit board times wrap around
+
+const uint32_t LatencyTrace_BucketLimits[LATENCY_TRACE_BUCKETS - 1] = {500, 1000, 2000, 5000, 10000, 20000, 50000, 100000};
+
+static const char *const SegmentNames[LatencyTrace_NumOf] = {
+    "esp", "espLink", "imu", "pmbLink", "pmb", "imuReturn", "roundTrip"
+};
+
+static Snapshot<LatencyTraceStats> StatsSnapshot;
+static std::atomic<bool> StatsReset;
+
+// Link task only
+static LatencyTraceStats Stats;
+
+static void LatencyTrace_Record(LatencyTraceSegment segment, uint32_t time)
+{
+    LatencyHistogram *histogram = &Stats.segments[segment];
+    uint8_t bucket = 0;
+
+    while (bucket < (LATENCY_TRACE_BUCKETS - 1) && time > LatencyTrace_BucketLimits[bucket])
+    {
+        bucket++;
+    }
+
+    histogram->count++;
+    histogram->last = time;
+    histogram->max = max(histogram->max, time);
+    histogram->sum += time;
+    histogram->histogram[bucket]++;
+}
+
+void LatencyTrace_Add(const LatencyTrace_t *trace, uint32_t changeTime, uint32_t txTime, uint32_t rxTime)
+{
+    uint32_t espRoundTrip = rxTime - txTime;
+    uint16_t imuTotal = trace->imuTxTime - trace->imuRxTime;
+    uint16_t imuPmbRoundTrip = trace->imuPmbRxTime - trace->imuPmbTxTime;
+    uint16_t pmb = trace->pmbTxTime - trace->pmbRxTime;
+
+    if (espRoundTrip >= LATENCY_TRACE_TIME_RANGE || imuTotal > espRoundTrip || pmb > imuPmbRoundTrip)
+    {
+        Stats.invalid++;
+    }
+    else
+    {
+        Stats.traces++;
+        LatencyTrace_Record(LatencyTrace_Esp, txTime - changeTime);
+        LatencyTrace_Record(LatencyTrace_EspLink, espRoundTrip - imuTotal);
+        LatencyTrace_Record(LatencyTrace_Imu, (uint16_t)(trace->imuPmbTxTime - trace->imuRxTime));
+        LatencyTrace_Record(LatencyTrace_PmbLink, imuPmbRoundTrip - pmb);
+        LatencyTrace_Record(LatencyTrace_Pmb, pmb);
+        LatencyTrace_Record(LatencyTrace_ImuReturn, (uint16_t)(trace->imuTxTime - trace->imuPmbRxTime));
+        LatencyTrace_Record(LatencyTrace_RoundTrip, rxTime - changeTime);
+    }
+
+    StatsSnapshot.write(Stats);
+}
+
+void LatencyTrace_Perform(void)
+{
+    if (StatsReset.exchange(false))
+    {
+        memset(&Stats, 0, sizeof(Stats));
+        StatsSnapshot.write(Stats);
+    }
+}
+
+void LatencyTrace_GetStats(LatencyTraceStats *stats)
+{
+    StatsSnapshot.read(*stats);
+}
+
+void LatencyTrace_Reset(void)
+{
+    StatsReset = true;
+}
+
+void LatencyTrace_ToJson(JsonObject json)
+{
+    LatencyTraceStats stats;
+
+    LatencyTrace_GetStats(&stats);
+    json["traces"] = stats.traces;
+    json["invalid"] = stats.invalid;
+
+    JsonArray limits = json["bucketLimits"].to<JsonArray>();
+    for (uint8_t bucket = 0; bucket < (LATENCY_TRACE_BUCKETS - 1); bucket++)
+    {
+        limits.add(LatencyTrace_BucketLimits[bucket]);
+    }
+
+    JsonObject segments = json["segments"].to<JsonObject>();
+    for (uint8_t segment = 0; segment < LatencyTrace_NumOf; segment++)
+    {
+        const LatencyHistogram *histogram = &stats.segments[segment];
+        JsonObject item = segments[SegmentNames[segment]].to<JsonObject>();
+
+        item["count"] = histogram->count;
+        item["last"] = histogram->last;
+        item["avg"] = histogram->count ? (uint32_t)(histogram->sum / histogram->count) : 0;
+        item["max"] = histogram->max;
+        JsonArray buckets = item["histogram"].to<JsonArray>();
+        for (uint8_t bucket = 0; bucket < LATENCY_TRACE_BUCKETS; bucket++)
+        {
+            buckets.add(histogram->histogram[bucket]);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include "src/Melkens_Lib/Types/MessageTypes.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <ArduinoJson.h>
+
+// Per hop latency of control commands. The IMU returns a LatencyTrace_t for
+// each new commandSequence; the link task adds ESP times and splits the round
+// trip into segments. Times of different boards are never compared directly,
+// link segments are the round trip of a hop minus the time spent on the far board.
+
+#define LATENCY_TRACE_BUCKETS 9 // last bucket counts everything above LatencyTrace_BucketLimits
+
+typedef enum {
+    LatencyTrace_Esp = 0,   // control change to UART write
+    LatencyTrace_EspLink,   // ESP <-> IMU both directions, includes IMU main loop pick up
+    LatencyTrace_Imu,       // command applied to Imu2PmbFrame sent
+    LatencyTrace_PmbLink,   // IMU <-> PMB both directions
+    LatencyTrace_Pmb,       // Imu2PmbFrame taken to motors set and answer sent
+    LatencyTrace_ImuReturn, // Pmb2ImuFrame received to Imu2EspFrame sent
+    LatencyTrace_RoundTrip, // control change to Imu2EspFrame with trace received
+    LatencyTrace_NumOf
+} LatencyTraceSegment;
+
+typedef struct {
+    uint32_t count;
+    uint32_t last;  // [us]
+    uint32_t max;   // [us]
+    uint64_t sum;   // [us]
+    uint32_t histogram[LATENCY_TRACE_BUCKETS];
+} LatencyHistogram;
+
+typedef struct {
+    uint32_t traces;  // complete traces
+    uint32_t invalid; // traces with inconsistent times (16 bit wrap, lost frames)
+    LatencyHistogram segments[LatencyTrace_NumOf];
+} LatencyTraceStats;
+
+extern const uint32_t LatencyTrace_BucketLimits[LATENCY_TRACE_BUCKETS - 1]; // [us] upper bucket limits
+
+// Link task only, times are ESP micros() of the traced control change, its
+// first UART write and reception of the Imu2EspFrame carrying trace
+void LatencyTrace_Add(const LatencyTrace_t *trace, uint32_t changeTime, uint32_t txTime, uint32_t rxTime);
+// Link task only, applies LatencyTrace_Reset
+void LatencyTrace_Perform(void);
+// Any task
+void LatencyTrace_GetStats(LatencyTraceStats *stats);
+void LatencyTrace_Reset(void);
+void LatencyTrace_ToJson(JsonObject json);
+
+#endif // LATENCY_TRACE_H
@@ -0,0 +1,46 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Lock free snapshot (sequence lock) for passing a struct between tasks on
+// different cores. One writer task, any number of readers; the writer never
+// waits, a reader copies again when the writer updated the value meanwhile.
+template <typename T>
+class Snapshot
+{
+public:
+    void write(const T &value)
+    {
+        uint32_t sequence = this->sequence.load(std::memory_order_relaxed);
+
+        this->sequence.store(sequence + 1, std::memory_order_relaxed); // odd: update in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data, &value, sizeof(T));
+        this->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Returns number of writes so far, 0 when value was never written
+    uint32_t read(T &value) const
+    {
+        uint32_t before, after;
+
+        do
+        {
+            before = sequence.load(std::memory_order_acquire);
+            memcpy(&value, &data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1U) || (before != after));
+
+        return before / 2;
+    }
+
+private:
+    std::atomic<uint32_t> sequence{0};
+    T data;
+};
+
+#endif // SNAPSHOT_H
@@ -3,6 +3,9 @@
 #include <ArduinoMqttClient.h>
 #include <ArduinoJson.h>
 #include <WiFiClient.h>
+#include <LittleFS.h>
+#include "src/RouteUpload/RouteUpload.h"
+#include "src/ImuCommunication/LatencyTrace.h"
 
 WiFiClient wifiClient;
 MqttClient mqttClient(wifiClient);
@@ -15,6 +18,39 @@ const char* topic_manual = "/moover/data/manual";
 const char* topic_route = "/moover/data/route";
 const char* topic_status = "/moover/status";
 const char* topic_charger = "/moover/charger";
+const char* topic_routes = "/moover/routes"; // binary route store image, forwarded to IMU
+const char* topic_latency = "/moover/diag/latency";
+
+static void MqttNode_OnMessage(int messageSize)
+{
+    uint8_t buffer[128];
+    int length;
+
+    if (mqttClient.messageTopic() != topic_routes)
+    {
+        return;
+    }
+
+    File file = LittleFS.open(routesFile, "w");
+    if (!file)
+    {
+        Serial.printf("Failed to open file for writing: %s\n", routesFile);
+        return;
+    }
+    while (mqttClient.available())
+    {
+        length = mqttClient.read(buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            break;
+        }
+        file.write(buffer, length);
+    }
+    file.close();
+
+    Serial.printf("Routes received over mqtt: %d bytes\n", messageSize);
+    RouteUpload_Start();
+}
 
 /*
 MqttNode_Send()
@@ -94,25 +130,38 @@ bool MqttNode_Connect(IPAddress broker, int port)
         }
     }
     Serial.println("Connection to broker established...");
+    mqttClient.onMessage(MqttNode_OnMessage);
+    mqttClient.subscribe(topic_routes);
     return true;
 }
 
+void MqttNode_Poll(void)
+{
+    mqttClient.poll();
+}
+
 void MqttNode_Publish(const char *publishTopic)
 {
     JsonDocument doc;
+    Imu2EspFrame_t imu;
 
+    ImuCommunication_GetStatus(&imu);
     JsonObject doc_0 = doc.add<JsonObject>();
 
-    doc_0["magnetBarStatus"] = Imu2EspFrame.magnetBarStatus;
-    doc_0["pmbConnection"] = Imu2EspFrame.pmbConnection;
-    doc_0["motorRightSpeed"] = Imu2EspFrame.motorRightSpeed;
-    doc_0["motorLeftSpeed"] = Imu2EspFrame.motorLeftSpeed;
-    doc_0["batteryVoltage"] = Imu2EspFrame.batteryVoltage;
-    doc_0["adcCurrent"] = Imu2EspFrame.adcCurrent;
-    doc_0["thumbleCurrent"] = Imu2EspFrame.thumbleCurrent;
-    doc_0["crcImu2PmbErrorCount"] = Imu2EspFrame.crcImu2PmbErrorCount;
-    doc_0["crcPmb2ImuErrorCount"] = Imu2EspFrame.crcPmb2ImuErrorCount;
-    doc_0["crcEsp2ImuErrorCount"] = Imu2EspFrame.crcEsp2ImuErrorCount;
+    doc_0["magnetBarStatus"] = imu.magnetBarStatus;
+    doc_0["pmbConnection"] = imu.pmbConnection;
+    doc_0["motorRightSpeed"] = imu.motorRightSpeed;
+    doc_0["motorLeftSpeed"] = imu.motorLeftSpeed;
+    doc_0["batteryVoltage"] = imu.batteryVoltage;
+    doc_0["adcCurrent"] = imu.adcCurrent;
+    doc_0["thumbleCurrent"] = imu.thumbleCurrent;
+    doc_0["crcImu2PmbErrorCount"] = imu.crcImu2PmbErrorCount;
+    doc_0["crcPmb2ImuErrorCount"] = imu.crcPmb2ImuErrorCount;
+    doc_0["crcEsp2ImuErrorCount"] = imu.crcEsp2ImuErrorCount;
+    doc_0["collision"] = imu.collision;
+    doc_0["pmbLoopMaxTime"] = imu.pmbLoopMaxTime;
+    doc_0["pmbMissedTicks"] = imu.pmbMissedTicks;
+    doc_0["pmbTaskMisses"] = imu.pmbTaskMisses;
 
     doc[1]["tag1"] = "Imu2EspFrame";
 
@@ -121,4 +170,15 @@ void MqttNode_Publish(const char *publishTopic)
     mqttClient.beginMessage(publishTopic);
     serializeJson(doc, mqttClient);
     mqttClient.endMessage();
-}
\ No newline at end of file
+}
+
+void MqttNode_PublishLatency(void)
+{
+    JsonDocument doc;
+
+    LatencyTrace_ToJson(doc.to<JsonObject>());
+
+    mqttClient.beginMessage(topic_latency);
+    serializeJson(doc, mqttClient);
+    mqttClient.endMessage();
+}
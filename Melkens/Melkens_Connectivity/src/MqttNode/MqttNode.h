@@ -8,5 +8,9 @@
 
 bool MqttNode_Connect(IPAddress broker, int port);
 void MqttNode_Publish(const char* publishTopic);
+// Control command latency histograms on /moover/diag/latency
+void MqttNode_PublishLatency(void);
+// Receives subscribed topics, route store image on /moover/routes
+void MqttNode_Poll(void);
 
 #endif // MQTTNODE_H
@@ -0,0 +1,249 @@
+#include "RouteUpload.h"
+#include "src/ImuCommunication/ImuCommunication.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define ROUTE_STORE_MAGIC       0x5354524DUL // "MRTS", see IMU RouteStore.h
+#define ROUTE_STORE_HEADER_SIZE 32
+#define ROUTE_STORE_SIZE_OFFSET 12           // RouteStoreHeader.PayloadSize
+#define ROUTE_STORE_SLOT_SIZE   0x8000UL     // image has to fit in one IMU slot
+
+#define ROUTE_UPLOAD_WINDOW     2    // blocks sent ahead of IMU acknowledge, IMU has one receive buffer
+#define ROUTE_UPLOAD_TIMEOUT    100  // [ms] without progress, resend from acknowledged block (> page erase + ack latency)
+#define ROUTE_UPLOAD_RETRIES    20
+
+const char* routesFile = "/routes.bin";
+
+typedef struct {
+    volatile RouteUploadStep step;
+    uint8_t *image;                 // header and payload loaded from routesFile
+    uint32_t payloadSize;
+    volatile uint16_t blockCount;
+    uint16_t nextBlock;             // next block to send
+    volatile uint16_t ackedBlocks;  // blocks written by IMU
+    uint32_t lastProgress;          // [ms]
+    uint8_t retries;
+} RouteUpload_t;
+
+static RouteUpload_t Upload;        // link task
+static Esp2ImuFrame_t RouteFrame;
+static uint8_t *PendingImage;       // passed from RouteUpload_Start to link task
+static portMUX_TYPE PendingLock = portMUX_INITIALIZER_UNLOCKED;
+
+static void RouteUpload_Send(uint8_t command, uint16_t sequence, const uint8_t *data, uint8_t length)
+{
+    RouteFrame.frameType = dESP2IMU_FRAME_ROUTE_BLOCK;
+    RouteFrame.routeBlock.command = command;
+    RouteFrame.routeBlock.length = length;
+    RouteFrame.routeBlock.sequence = sequence;
+    memset(RouteFrame.routeBlock.data, 0xFF, sizeof(RouteFrame.routeBlock.data));
+    if (length)
+    {
+        memcpy(RouteFrame.routeBlock.data, data, length);
+    }
+    ImuCommunication_Tx(&RouteFrame);
+}
+
+static void RouteUpload_SendBlock(uint16_t block)
+{
+    uint32_t offset = (uint32_t)block * dROUTE_BLOCK_DATA_SIZE;
+    uint8_t length = (uint8_t)min((uint32_t)dROUTE_BLOCK_DATA_SIZE, Upload.payloadSize - offset);
+
+    RouteUpload_Send(dROUTE_BLOCK_DATA, block, &Upload.image[ROUTE_STORE_HEADER_SIZE + offset], length);
+}
+
+static void RouteUpload_Finish(RouteUploadStep step)
+{
+    free(Upload.image);
+    Upload.image = NULL;
+    Upload.step = step;
+    Serial.printf("Route upload %s, %u/%u blocks\n", (step == RouteUpload_Done) ? "done" : "failed",
+                  Upload.ackedBlocks, Upload.blockCount);
+}
+
+// true when there was no progress for ROUTE_UPLOAD_TIMEOUT, gives up after ROUTE_UPLOAD_RETRIES
+static bool RouteUpload_IsTimeout(void)
+{
+    if ((millis() - Upload.lastProgress) < ROUTE_UPLOAD_TIMEOUT)
+    {
+        return false;
+    }
+    Upload.lastProgress = millis();
+    if (++Upload.retries > ROUTE_UPLOAD_RETRIES)
+    {
+        RouteUpload_Finish(RouteUpload_Failed);
+        return false;
+    }
+    return true;
+}
+
+static void RouteUpload_Progress(void)
+{
+    Upload.lastProgress = millis();
+    Upload.retries = 0;
+}
+
+static void RouteUpload_StartImage(uint8_t *image)
+{
+    free(Upload.image);
+    Upload.image = image;
+    memcpy(&Upload.payloadSize, &image[ROUTE_STORE_SIZE_OFFSET], sizeof(Upload.payloadSize));
+    Upload.blockCount = (Upload.payloadSize + dROUTE_BLOCK_DATA_SIZE - 1) / dROUTE_BLOCK_DATA_SIZE;
+    Upload.nextBlock = 0;
+    Upload.ackedBlocks = 0;
+    Upload.retries = 0;
+    Upload.step = RouteUpload_Begin;
+    RouteUpload_Send(dROUTE_BLOCK_BEGIN, 0, image, ROUTE_STORE_HEADER_SIZE);
+    RouteUpload_Progress();
+}
+
+bool RouteUpload_Start(void)
+{
+    File file = LittleFS.open(routesFile, "r");
+    uint8_t *image, *previous;
+    uint32_t magic, payloadSize;
+    size_t size = file ? file.size() : 0;
+
+    if (size < ROUTE_STORE_HEADER_SIZE || size > ROUTE_STORE_SLOT_SIZE)
+    {
+        Serial.println("Route upload: not a route store image");
+        return false;
+    }
+
+    image = (uint8_t*)malloc(size);
+    if (image == NULL || file.read(image, size) != size)
+    {
+        Serial.println("Route upload: cannot read route file");
+        free(image);
+        return false;
+    }
+    file.close();
+
+    memcpy(&magic, &image[0], sizeof(magic));
+    memcpy(&payloadSize, &image[ROUTE_STORE_SIZE_OFFSET], sizeof(payloadSize));
+    if (magic != ROUTE_STORE_MAGIC || size != ROUTE_STORE_HEADER_SIZE + payloadSize)
+    {
+        Serial.println("Route upload: not a route store image");
+        free(image);
+        return false;
+    }
+
+    // image not yet taken by link task is replaced
+    portENTER_CRITICAL(&PendingLock);
+    previous = PendingImage;
+    PendingImage = image;
+    portEXIT_CRITICAL(&PendingLock);
+    free(previous);
+    return true;
+}
+
+void RouteUpload_Perform(const Imu2EspFrame_t *frame, bool frameReceived)
+{
+    uint8_t imuState = frame->routeUploadState;
+    uint8_t *image;
+
+    if (ImuCommunication_IsStopped())
+    {
+        // link is kept free for the stop, upload continues after release
+        RouteUpload_Progress();
+        return;
+    }
+
+    portENTER_CRITICAL(&PendingLock);
+    image = PendingImage;
+    PendingImage = NULL;
+    portEXIT_CRITICAL(&PendingLock);
+    if (image != NULL)
+    {
+        RouteUpload_StartImage(image);
+        return;
+    }
+
+    switch (Upload.step)
+    {
+    case RouteUpload_Begin:
+        if (frameReceived && imuState == dROUTE_UPLOAD_RECEIVING && frame->routeUploadAck == 0)
+        {
+            Upload.step = RouteUpload_Data;
+            RouteUpload_Progress();
+        }
+        else if (RouteUpload_IsTimeout())
+        {
+            // error state can be left from previous upload, trust it only after timeout
+            if (imuState >= dROUTE_UPLOAD_ERROR_BUSY)
+            {
+                RouteUpload_Finish(RouteUpload_Failed);
+            }
+            else
+            {
+                RouteUpload_Send(dROUTE_BLOCK_BEGIN, 0, Upload.image, ROUTE_STORE_HEADER_SIZE);
+            }
+        }
+        break;
+
+    case RouteUpload_Data:
+        if (frameReceived)
+        {
+            if (imuState != dROUTE_UPLOAD_RECEIVING)
+            {
+                RouteUpload_Finish(RouteUpload_Failed);
+                break;
+            }
+            if (frame->routeUploadAck > Upload.ackedBlocks)
+            {
+                Upload.ackedBlocks = frame->routeUploadAck;
+                RouteUpload_Progress();
+            }
+        }
+        if (Upload.ackedBlocks >= Upload.blockCount)
+        {
+            Upload.step = RouteUpload_Commit;
+            RouteUpload_Send(dROUTE_BLOCK_COMMIT, Upload.blockCount, NULL, 0);
+            break;
+        }
+        if (RouteUpload_IsTimeout() || Upload.nextBlock < Upload.ackedBlocks)
+        {
+            // go back to first block IMU did not write
+            Upload.nextBlock = Upload.ackedBlocks;
+        }
+        while (Upload.step == RouteUpload_Data && Upload.nextBlock < Upload.blockCount &&
+               Upload.nextBlock < Upload.ackedBlocks + ROUTE_UPLOAD_WINDOW)
+        {
+            RouteUpload_SendBlock(Upload.nextBlock++);
+        }
+        break;
+
+    case RouteUpload_Commit:
+        if (frameReceived && imuState == dROUTE_UPLOAD_DONE)
+        {
+            RouteUpload_Finish(RouteUpload_Done);
+        }
+        else if (frameReceived && imuState != dROUTE_UPLOAD_RECEIVING)
+        {
+            RouteUpload_Finish(RouteUpload_Failed);
+        }
+        else if (RouteUpload_IsTimeout())
+        {
+            RouteUpload_Send(dROUTE_BLOCK_COMMIT, Upload.blockCount, NULL, 0);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+RouteUploadStep RouteUpload_GetStep(void)
+{
+    return Upload.step;
+}
+
+uint16_t RouteUpload_GetBlockCount(void)
+{
+    return Upload.blockCount;
+}
+
+uint16_t RouteUpload_GetAckedBlocks(void)
+{
+    return Upload.ackedBlocks;
+}
@@ -0,0 +1,34 @@
+#ifndef ROUTE_UPLOAD_H
+#define ROUTE_UPLOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "src/Melkens_Lib/Types/MessageTypes.h"
+
+// Sends route store image (built by Tools/RouteCompiler/route_pack.py) from
+// LittleFS to IMU in dROUTE_BLOCK_DATA_SIZE blocks. Every block is a
+// separate CRC protected Esp2ImuFrame_t, IMU acknowledges the next expected
+// block in Imu2EspFrame_t and lost blocks are resent from that point.
+// RouteUpload_Perform runs in IMU link task, the other functions can be
+// called from any task.
+
+typedef enum RouteUploadStep_t {
+    RouteUpload_Idle = 0,
+    RouteUpload_Begin,
+    RouteUpload_Data,
+    RouteUpload_Commit,
+    RouteUpload_Done,
+    RouteUpload_Failed,
+} RouteUploadStep;
+
+extern const char* routesFile;
+
+// Loads routesFile and hands it over to link task, false if file is not a route store image
+bool RouteUpload_Start(void);
+// ImuLinkHandler, frameReceived when frame was just received
+void RouteUpload_Perform(const Imu2EspFrame_t *frame, bool frameReceived);
+RouteUploadStep RouteUpload_GetStep(void);
+uint16_t RouteUpload_GetBlockCount(void);
+uint16_t RouteUpload_GetAckedBlocks(void);
+
+#endif // ROUTE_UPLOAD_H
@@ -3,5 +3,9 @@
 
 #define FIRMWARE_V "0.2.0"
 //#define BLE_SERIAL
+//#define LINK_STATS   // prints IMU link and network task timing every 10 s
+
+#define NTP_SERVER "pool.ntp.org"
+#define TIME_ZONE  "CET-1CEST,M3.5.0,M10.5.0/3" // POSIX TZ, week time sent to PMB scheduler is local
 
 #endif // SETTINGS_H
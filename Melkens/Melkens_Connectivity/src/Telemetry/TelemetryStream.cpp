@@ -0,0 +1,230 @@
+#include "TelemetryStream.h"
+#include "src/Melkens_Lib/Types/MessageCodec.h"
+#include <string.h>
+#include <mutex>
+
+typedef struct {
+    bool used;
+    uint32_t client;
+    uint32_t period; // [ms]
+    uint32_t due;    // [ms]
+    uint8_t head;
+    uint8_t count;
+    uint8_t frames[TELEMETRY_QUEUE_DEPTH][TELEMETRY_FRAME_SIZE];
+} TelemetrySlot;
+
+// std::mutex rather than portMUX, sending is not done under it and the host
+// build of Tools/Telemetry has no FreeRTOS
+static std::mutex Lock;
+static TelemetrySlot Slots[TELEMETRY_MAX_CLIENTS];
+static TelemetryStats Stats;
+
+static TelemetrySlot *TelemetryStream_Find(uint32_t client)
+{
+    for (uint8_t i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+    {
+        if (Slots[i].used && Slots[i].client == client)
+        {
+            return &Slots[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t TelemetryStream_CountSubscribers(void)
+{
+    uint32_t subscribers = 0;
+
+    for (uint8_t i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+    {
+        subscribers += Slots[i].used ? 1U : 0U;
+    }
+    return subscribers;
+}
+
+static bool TelemetryStream_IsSlotDue(const TelemetrySlot *slot, uint32_t now)
+{
+    return slot->used && (int32_t)(now - slot->due) >= 0;
+}
+
+void TelemetryStream_Encode(uint8_t *buffer, const Imu2EspFrame_t *imu, uint16_t sequence, uint32_t time,
+                            uint32_t imuFrames, uint8_t flags)
+{
+    buffer[0] = TELEMETRY_MAGIC;
+    buffer[1] = TELEMETRY_FORMAT;
+    Message_Put16(buffer + 2, sequence);
+    Message_Put32(buffer + 4, time);
+    Message_Put32(buffer + 8, imu->magnetBarStatus);
+    Message_Put16(buffer + 12, imu->pmbConnection);
+    Message_Put16(buffer + 14, (uint16_t)imu->motorRightSpeed);
+    Message_Put16(buffer + 16, (uint16_t)imu->motorLeftSpeed);
+    Message_Put16(buffer + 18, imu->batteryVoltage);
+    Message_Put16(buffer + 20, imu->adcCurrent);
+    Message_Put16(buffer + 22, imu->thumbleCurrent);
+    Message_Put16(buffer + 24, imu->crcImu2PmbErrorCount);
+    Message_Put16(buffer + 26, imu->crcPmb2ImuErrorCount);
+    Message_Put16(buffer + 28, imu->crcEsp2ImuErrorCount);
+    buffer[30] = imu->collision;
+    buffer[31] = imu->routeUploadState;
+    buffer[32] = imu->routeCount;
+    buffer[33] = flags;
+    Message_Put16(buffer + 34, imu->stopReaction);
+    Message_Put32(buffer + 36, imuFrames);
+    Message_Put16(buffer + 40, imu->pmbLoopMaxTime);
+    Message_Put16(buffer + 42, imu->pmbMissedTicks);
+    Message_Put16(buffer + 44, imu->pmbTaskMisses);
+}
+
+bool TelemetryStream_Subscribe(uint32_t client, uint16_t rate, uint32_t now)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+    TelemetrySlot *slot = TelemetryStream_Find(client);
+
+    if (rate == 0)
+    {
+        if (slot != NULL)
+        {
+            slot->used = false;
+        }
+        return true;
+    }
+    if (slot == NULL)
+    {
+        for (uint8_t i = 0; i < TELEMETRY_MAX_CLIENTS && slot == NULL; i++)
+        {
+            if (!Slots[i].used)
+            {
+                slot = &Slots[i];
+            }
+        }
+        if (slot == NULL)
+        {
+            return false;
+        }
+        slot->used = true;
+        slot->client = client;
+        slot->head = 0;
+        slot->count = 0;
+    }
+    if (rate > TELEMETRY_MAX_RATE)
+    {
+        rate = TELEMETRY_MAX_RATE;
+    }
+    slot->period = 1000U / rate;
+    slot->due = now;
+    return true;
+}
+
+void TelemetryStream_Unsubscribe(uint32_t client)
+{
+    TelemetryStream_Subscribe(client, 0, 0);
+}
+
+uint32_t TelemetryStream_GetSubscribers(void)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+
+    return TelemetryStream_CountSubscribers();
+}
+
+bool TelemetryStream_IsDue(uint32_t now)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+
+    for (uint8_t i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+    {
+        if (TelemetryStream_IsSlotDue(&Slots[i], now))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TelemetryStream_Push(const uint8_t *frame, uint32_t now)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+
+    for (uint8_t i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+    {
+        TelemetrySlot *slot = &Slots[i];
+
+        if (!TelemetryStream_IsSlotDue(slot, now))
+        {
+            continue;
+        }
+        if (slot->count == TELEMETRY_QUEUE_DEPTH)
+        {
+            // drop oldest
+            slot->head = (slot->head + 1) % TELEMETRY_QUEUE_DEPTH;
+            slot->count--;
+            Stats.dropped++;
+        }
+        memcpy(slot->frames[(slot->head + slot->count) % TELEMETRY_QUEUE_DEPTH], frame, TELEMETRY_FRAME_SIZE);
+        slot->count++;
+        Stats.frames++;
+
+        slot->due += slot->period;
+        if ((int32_t)(now - slot->due) >= 0)
+        {
+            // network task was late, no bursts to catch up
+            slot->due = now + slot->period;
+        }
+    }
+}
+
+void TelemetryStream_Drain(TelemetrySend send, void *context)
+{
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+
+    for (uint8_t i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+    {
+        for (;;)
+        {
+            uint32_t client;
+            {
+                std::lock_guard<std::mutex> guard(Lock);
+                if (!Slots[i].used || Slots[i].count == 0)
+                {
+                    break;
+                }
+                client = Slots[i].client;
+                memcpy(frame, Slots[i].frames[Slots[i].head], TELEMETRY_FRAME_SIZE);
+            }
+
+            if (!send(client, frame, TELEMETRY_FRAME_SIZE, context))
+            {
+                break;
+            }
+
+            std::lock_guard<std::mutex> guard(Lock);
+            // Push runs in the same task, but the client may have unsubscribed meanwhile
+            if (Slots[i].used && Slots[i].client == client && Slots[i].count > 0)
+            {
+                Slots[i].head = (Slots[i].head + 1) % TELEMETRY_QUEUE_DEPTH;
+                Slots[i].count--;
+            }
+            Stats.sent++;
+        }
+    }
+}
+
+void TelemetryStream_GetStats(TelemetryStats *stats, bool reset)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+
+    *stats = Stats;
+    stats->subscribers = TelemetryStream_CountSubscribers();
+    if (reset)
+    {
+        memset(&Stats, 0, sizeof(Stats));
+    }
+}
+
+void TelemetryStream_Reset(void)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+
+    memset(Slots, 0, sizeof(Slots));
+    memset(&Stats, 0, sizeof(Stats));
+}
@@ -0,0 +1,73 @@
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include "src/Melkens_Lib/Types/MessageTypes.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Binary live telemetry for the web page. A WebSocket client subscribes with
+// {"type":"telemetry","rate":<Hz>} and gets Imu2EspFrame_t status as fixed
+// layout frames at that rate, 0 unsubscribes. Every client has a short frame
+// queue; when the client does not keep up the oldest frame is dropped, so a
+// slow client sees the newest state and never holds frames of the others.
+// No Arduino dependencies, Tools/Telemetry builds this file on the host.
+//
+// Frame layout, little endian, TELEMETRY_FRAME_SIZE bytes:
+//   0  u8  TELEMETRY_MAGIC          20  u16 adcCurrent
+//   1  u8  TELEMETRY_FORMAT         22  u16 thumbleCurrent
+//   2  u16 sequence                 24  u16 crcImu2PmbErrorCount
+//   4  u32 ESP time [ms]            26  u16 crcPmb2ImuErrorCount
+//   8  u32 magnetBarStatus          28  u16 crcEsp2ImuErrorCount
+//  12  u16 pmbConnection            30  u8  collision
+//  14  i16 motorRightSpeed          31  u8  routeUploadState
+//  16  i16 motorLeftSpeed           32  u8  routeCount
+//  18  u16 batteryVoltage           33  u8  TELEMETRY_FLAG_...
+//                                   34  u16 stopReaction
+//                                   36  u32 IMU frames received
+//                                   40  u16 pmbLoopMaxTime
+//                                   42  u16 pmbMissedTicks
+//                                   44  u16 pmbTaskMisses
+// The layout is independent of the link frames, a new field is appended and
+// TELEMETRY_FORMAT increased.
+
+#define TELEMETRY_MAGIC 0x54 // 'T', text frames start with '{'
+#define TELEMETRY_FORMAT 2
+#define TELEMETRY_FRAME_SIZE 46
+#define TELEMETRY_MAX_CLIENTS 8 // DEFAULT_MAX_WS_CLIENTS
+#define TELEMETRY_QUEUE_DEPTH 4 // frames per client
+#define TELEMETRY_MAX_RATE 50   // [Hz]
+
+#define TELEMETRY_FLAG_STOPPED 0x01 // emergency stop requested on ESP
+
+typedef struct {
+    uint32_t subscribers;
+    uint32_t frames;  // frames queued
+    uint32_t sent;
+    uint32_t dropped; // oldest frames dropped from full client queues
+} TelemetryStats;
+
+// Returns false when the client cannot take a frame now, it stays queued
+typedef bool (*TelemetrySend)(uint32_t client, const uint8_t *frame, size_t length, void *context);
+
+void TelemetryStream_Encode(uint8_t *buffer, const Imu2EspFrame_t *imu, uint16_t sequence, uint32_t time,
+                            uint32_t imuFrames, uint8_t flags);
+
+// Any task. Rate is limited to TELEMETRY_MAX_RATE, 0 unsubscribes. Returns
+// false when all TELEMETRY_MAX_CLIENTS slots are taken.
+bool TelemetryStream_Subscribe(uint32_t client, uint16_t rate, uint32_t now);
+void TelemetryStream_Unsubscribe(uint32_t client);
+uint32_t TelemetryStream_GetSubscribers(void);
+
+// Network task: when a subscriber is due, encode one frame and push it, it is
+// queued for all due subscribers. Drain sends queued frames until the clients
+// are busy.
+bool TelemetryStream_IsDue(uint32_t now);
+void TelemetryStream_Push(const uint8_t *frame, uint32_t now);
+void TelemetryStream_Drain(TelemetrySend send, void *context);
+
+void TelemetryStream_GetStats(TelemetryStats *stats, bool reset);
+void TelemetryStream_Reset(void);
+
+#endif // TELEMETRY_STREAM_H
@@ -0,0 +1,26 @@
+#include "TimeBase.h"
+#include "src/Settings.h"
+#include "src/Melkens_Lib/Types/MessageTypes.h"
+#include <Arduino.h>
+#include <time.h>
+
+
+#define TIME_BASE_VALID_YEAR 2024 // clock before this year is not set yet
+
+void TimeBase_StartSntp(void)
+{
+    configTzTime(TIME_ZONE, NTP_SERVER);
+}
+
+uint32_t TimeBase_GetWeekTime(void)
+{
+    time_t now = time(NULL);
+    struct tm local;
+
+    localtime_r(&now, &local);
+    if (local.tm_year + 1900 < TIME_BASE_VALID_YEAR)
+    {
+        return dSYNC_UNKNOWN_WEEK_TIME;
+    }
+    return ((uint32_t)local.tm_wday * 86400u) + ((uint32_t)local.tm_hour * 3600u) + ((uint32_t)local.tm_min * 60u) + (uint32_t)local.tm_sec;
+}
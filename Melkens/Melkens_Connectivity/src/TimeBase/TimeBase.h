@@ -0,0 +1,15 @@
+#ifndef TIME_BASE_H
+#define TIME_BASE_H
+
+#include <stdint.h>
+
+// Wall clock of the robot. ESP is the time master of the IMU and PMB links,
+// it keeps its clock by SNTP in STA mode and sends the local week time in
+// every SyncStamp_t, PMB uses it for its scheduler.
+
+// After STA connection
+void TimeBase_StartSntp(void);
+// [s] since Sunday 00:00 local time, dSYNC_UNKNOWN_WEEK_TIME until SNTP has set the clock
+uint32_t TimeBase_GetWeekTime(void);
+
+#endif // TIME_BASE_H
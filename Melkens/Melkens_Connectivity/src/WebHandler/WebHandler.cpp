@@ -3,10 +3,13 @@
 #include <AsyncTCP.h>          // https://github.com/ESP32Async/AsyncTCP.git
 #include <ESPAsyncWebServer.h> // https://github.com/ESP32Async/ESPAsyncWebServer.git
 ///#include "src/WebPage/http_header.h"
-#include "src/WebPage/http_settings.h"
-#include "src/WebPage/IndexHtml.h"
+#include "src/WebPage/WebAssets.h"
 #include "src/Settings.h"
 #include "src/ImuCommunication/ImuCommunication.h"
+#include "src/ImuCommunication/LatencyTrace.h"
+#include "src/RouteUpload/RouteUpload.h"
+#include "src/FirmwareUpload/FirmwareUpload.h"
+#include "src/Telemetry/TelemetryStream.h"
 #include <LittleFS.h>
 #include <Update.h>
 #include <ArduinoJson.h>
@@ -41,16 +44,48 @@ const char* defaultConfig = R"rawliteral(
 AsyncWebServer server(80); //Default port number
 AsyncWebSocket ws("/ws");
 
-void handleRoot(AsyncWebServerRequest *request)
+static WebServedStats ServedStats;
+
+/* gzipped page from flash, revalidated by the browser with its ETag */
+void handleAsset(AsyncWebServerRequest *request, const WebAsset *asset)
 {
-    Serial.println("Handling root");
-    request->send(200, "text/html", html);
+    const AsyncWebHeader *match = request->getHeader("If-None-Match");
+
+    ServedStats.requests++;
+    if (match != NULL && match->value() == asset->etag)
+    {
+        ServedStats.notModified++;
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", asset->etag);
+        request->send(response);
+        return;
+    }
+
+    ServedStats.bytes += asset->length;
+    AsyncWebServerResponse *response = request->beginResponse(200, asset->contentType, asset->data, asset->length);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", "no-cache"); // always revalidate, a new firmware changes the ETag
+    request->send(response);
 }
 
-void handleSettings(AsyncWebServerRequest *request)
+/* values the settings page used to get by string replacement */
+void handleSettingsJson(AsyncWebServerRequest *request)
 {
-    Serial.println("Handling settings");
-    request->send(200, "text/html", settings_html);
+    JsonDocument settings;
+
+    settings["ssid"] = ssid;
+    settings["password"] = password;
+    settings["broker"] = broker.toString();
+    settings["espIp"] = espIp.toString();
+    settings["gatewayIp"] = gatewayIp.toString();
+    settings["firmware"] = FIRMWARE_V;
+
+    String json;
+    serializeJson(settings, json);
+    ServedStats.requests++;
+    ServedStats.bytes += json.length();
+    request->send(200, "application/json", json);
 }
 
 // XML page to listen for motor commands
@@ -62,14 +97,14 @@ void handleMotors(AsyncWebServerRequest *request)
 
     if (t_state.startsWith("V")) // Drive Forward (UP Arrow)
     {
-        Serial1.print("V");
-        Serial1.write((uint8_t)t_state.substring(1).toInt());
+        uint8_t command[] = {'V', (uint8_t)t_state.substring(1).toInt()};
+        ImuCommunication_Write(command, sizeof(command));
         Serial.println(t_state.substring(1).toInt());
     }
     else if (t_state.startsWith("X"))
     {
-        Serial1.print("X");
-        Serial1.write((uint8_t)t_state.substring(1).toInt());
+        uint8_t command[] = {'X', (uint8_t)t_state.substring(1).toInt()};
+        ImuCommunication_Write(command, sizeof(command));
         Serial.println(t_state.substring(1).toInt());
     }
     else if (t_state.startsWith("W"))
@@ -84,11 +119,11 @@ void handleMotors(AsyncWebServerRequest *request)
             Serial.println("Stan niski");
             /// sendPinStateOverMQTT(false); //todo
         }
-        Serial1.print(t_state);
+        ImuCommunication_Write((const uint8_t *)t_state.c_str(), t_state.length());
     }
     else
     {
-        Serial1.print(t_state);
+        ImuCommunication_Write((const uint8_t *)t_state.c_str(), t_state.length());
     }
     request->send(200, "text/plain", motorState); // Send web page
 }
@@ -195,6 +230,117 @@ void handleUpdateConfig(AsyncWebServerRequest *request, String filename, size_t
     }
 }
 
+void handleUpdateRoutes(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final)
+{
+    static File file;
+    if (index == 0)
+    {
+        file = LittleFS.open(routesFile, "w");
+    }
+    if (file)
+    {
+        file.write(data, len);
+    }
+    if (final)
+    {
+        if (file)
+            file.close();
+        if (RouteUpload_Start())
+        {
+            request->send(200, "text/plain", "Routes uploaded, sending to IMU");
+        }
+        else
+        {
+            request->send(400, "text/plain", "Not a route store image");
+        }
+    }
+}
+
+void handleRoutesStatus(AsyncWebServerRequest *request)
+{
+    JsonDocument status;
+    Imu2EspFrame_t imu;
+
+    ImuCommunication_GetStatus(&imu);
+    status["step"] = RouteUpload_GetStep();
+    status["blocks"] = RouteUpload_GetBlockCount();
+    status["acked"] = RouteUpload_GetAckedBlocks();
+    status["imuState"] = imu.routeUploadState;
+    status["routeCount"] = imu.routeCount;
+
+    String json;
+    serializeJson(status, json);
+    request->send(200, "application/json", json);
+}
+
+/* IMU or PMB image to LittleFS, sent to the loader once complete */
+void handleUpdateFirmware(AsyncWebServerRequest *request, uint8_t target, size_t index, uint8_t *data, size_t len, bool final)
+{
+    static File file;
+    if (index == 0)
+    {
+        file = LittleFS.open((target == dFW_TARGET_PMB) ? pmbFirmwareFile : imuFirmwareFile, "w");
+    }
+    if (file)
+    {
+        file.write(data, len);
+    }
+    if (final)
+    {
+        if (file)
+            file.close();
+        if (FirmwareUpload_Start(target))
+        {
+            request->send(200, "text/plain", "Firmware uploaded, sending to loader");
+        }
+        else
+        {
+            request->send(409, "text/plain", "Firmware update off, running or empty image");
+        }
+    }
+}
+
+void handleUpdateImu(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final)
+{
+    handleUpdateFirmware(request, dFW_TARGET_IMU, index, data, len, final);
+}
+
+void handleUpdatePmb(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final)
+{
+    handleUpdateFirmware(request, dFW_TARGET_PMB, index, data, len, final);
+}
+
+void handleFirmwareStatus(AsyncWebServerRequest *request)
+{
+    JsonDocument status;
+
+    status["step"] = FirmwareUpload_GetStep();
+    status["target"] = FirmwareUpload_GetTarget();
+    status["blocks"] = FirmwareUpload_GetBlockCount();
+    status["acked"] = FirmwareUpload_GetAckedBlocks();
+    status["loaderState"] = FirmwareUpload_GetLoaderState();
+
+    String json;
+    serializeJson(status, json);
+    request->send(200, "application/json", json);
+}
+
+/* control command latency histograms, ?reset=1 starts new statistics */
+void handleDiagLatency(AsyncWebServerRequest *request)
+{
+    JsonDocument latency;
+
+    LatencyTrace_ToJson(latency.to<JsonObject>());
+    if (request->hasParam("reset") && request->getParam("reset")->value() == "1")
+    {
+        LatencyTrace_Reset();
+    }
+
+    String json;
+    serializeJson(latency, json);
+    request->send(200, "application/json", json);
+}
+
 /* cannot handle request so return 404 */
 void handleNotFound(AsyncWebServerRequest *request)
 {
@@ -240,13 +386,6 @@ void initLittleFS(void)
   espIp.fromString(doc["network"]["espIp"].as<String>());
   gatewayIp.fromString(doc["network"]["gatewayIp"].as<String>());
 
-  settings_html.replace("%SSID%", ssid);
-  settings_html.replace("%PASSWORD%", password);
-  settings_html.replace("%BROKER%", broker.toString());
-  settings_html.replace("%ESP_IP%", espIp.toString());
-  settings_html.replace("%GATEWAY_IP%", gatewayIp.toString());
-  settings_html.replace("%FIRMWARE_VERSION%", FIRMWARE_V);
-
   Serial.println("SSID: " + ssid);
   Serial.println("Password: " + password);
   Serial.print("Broker: "); Serial.println(broker);
@@ -271,7 +410,7 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len) {
 }
 */
 
-void handleWebSocketMessage(void *arg, uint8_t *data, size_t len)
+void handleWebSocketMessage(AsyncWebSocketClient *client, void *arg, uint8_t *data, size_t len)
 {
     AwsFrameInfo *info = (AwsFrameInfo *)arg;
     if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT)
@@ -280,23 +419,43 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len)
         DeserializationError error = deserializeJson(doc, data);
         if (!error)
         {
+            Esp2ImuFrame_t control;
             const char* type = doc["type"] | "";
+
+            // stop goes out before anything else is parsed or printed
+            if (strcmp(type, "stop") == 0) {
+                ImuCommunication_SetStop(true);
+                Serial.println("Emergency stop");
+                return;
+            } else if (strcmp(type, "release") == 0) {
+                ImuCommunication_SetStop(false);
+                Serial.println("Emergency stop released");
+                return;
+            } else if (strcmp(type, "telemetry") == 0) {
+                uint16_t rate = doc["rate"] | 0;
+                if (!TelemetryStream_Subscribe(client->id(), rate, millis())) {
+                    Serial.printf("WebSocket client #%u: no telemetry slot left\n", client->id());
+                }
+                return;
+            }
+
+            ImuCommunication_GetControl(&control);
             if (strcmp(type, "joystick") == 0) {
-                Esp2ImuFrame.moveX = doc["x"];
-                Esp2ImuFrame.moveY = doc["y"];
+                control.moveX = doc["x"];
+                control.moveY = doc["y"];
             } else if (strcmp(type, "auger") == 0) {
                 Serial.print("Auger Speed: ");
                 uint16_t augerSpeed = doc["value"];
-                Esp2ImuFrame.augerSpeed = augerSpeed;
+                control.augerSpeed = augerSpeed;
                 Serial.println(augerSpeed);
             } else if (strcmp(type, "route") == 0) {
                 Serial.print("route: ");
                 uint8_t route = doc["value"];
-                Esp2ImuFrame.rootNumber = route;
+                control.rootNumber = route;
                 Serial.println(route);
             } else if (strcmp(type, "button") == 0) {
                 uint8_t button = doc["value"];
-                Esp2ImuFrame.rootAction = button;
+                control.rootAction = button;
                 Serial.print("Button: ");
                 Serial.println(button);
             } else if (strcmp(type, "checkbox") == 0) {
@@ -304,17 +463,28 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len)
                 bool value = doc["value"];
                 Serial.printf("Checkbox %s = %s\n", id.c_str(), value ? "ON" : "OFF");
                 if (id == "power") {
-                  Esp2ImuFrame.power = value;
+                  control.power = value;
                 } else if (id == "charging") {
-                  Esp2ImuFrame.charging = value;
+                  control.charging = value;
                 }   
             } else {
                 Serial.println("undefined WebSocket message type");
             }
+            ImuCommunication_SetControl(&control);
         }
     }
 }
 
+void stopMoving(void)
+{
+    Esp2ImuFrame_t control;
+
+    ImuCommunication_GetControl(&control);
+    control.moveX = 0;
+    control.moveY = 0;
+    ImuCommunication_SetControl(&control);
+}
+
 void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len) {
   switch (type) {
     case WS_EVT_CONNECT:
@@ -322,16 +492,15 @@ void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType
       break;
     case WS_EVT_DISCONNECT:
       Serial.printf("WebSocket client #%u disconnected\n", client->id());
-      Esp2ImuFrame.moveX = 0;
-      Esp2ImuFrame.moveY = 0;
+      TelemetryStream_Unsubscribe(client->id());
+      stopMoving();
       break;
     case WS_EVT_DATA:
-      handleWebSocketMessage(arg, data, len);
+      handleWebSocketMessage(client, arg, data, len);
       break;
     case WS_EVT_PONG:
     case WS_EVT_ERROR:
-      Esp2ImuFrame.moveX = 0;
-      Esp2ImuFrame.moveY = 0;
+      stopMoving();
       break;
   }
 }
@@ -350,8 +519,12 @@ void WebHandler_Init(void)
     /* register the callbacks to process client request */
     /* root request we will read the memory card to get
     the content of index.html and respond that content to client */
-    server.on("/", handleRoot);
-    server.on("/settings", handleSettings);
+    for (size_t i = 0; i < WEB_ASSETS_NUM_OF; i++)
+    {
+        const WebAsset *asset = &WebAssets[i];
+        server.on(asset->path, HTTP_GET, [asset](AsyncWebServerRequest *request) { handleAsset(request, asset); });
+    }
+    server.on("/settings.json", HTTP_GET, handleSettingsJson);
     server.on("/setMotors", handleMotors);
     server.on("/submit", handleSubmit);
 
@@ -370,9 +543,13 @@ void WebHandler_Init(void)
 
     server.on("/config", HTTP_POST, [](AsyncWebServerRequest *request) {}, handleUpdateConfig);
 
-    // server.on("/updateImu", HTTP_POST, []() {
-    //   server.send(200, "text/plain", "File uploaded");
-    // }, HandleUpdateImu);
+    server.on("/routes", HTTP_POST, [](AsyncWebServerRequest *request) {}, handleUpdateRoutes);
+    server.on("/routes/status", HTTP_GET, handleRoutesStatus);
+    server.on("/diag/latency", HTTP_GET, handleDiagLatency);
+
+    server.on("/updateImu", HTTP_POST, [](AsyncWebServerRequest *request) {}, handleUpdateImu);
+    server.on("/updatePmb", HTTP_POST, [](AsyncWebServerRequest *request) {}, handleUpdatePmb);
+    server.on("/firmware/status", HTTP_GET, handleFirmwareStatus);
 
     server.onNotFound(handleNotFound);
     server.begin();
@@ -382,22 +559,77 @@ void WebHandler_Init(void)
 void WebHandler_SendData(void)
 {
   DynamicJsonDocument doc(512);
-  doc["magnetBarStatus"] = Imu2EspFrame.magnetBarStatus;
-  doc["pmbConnection"] = Imu2EspFrame.pmbConnection;
-  doc["motorRightSpeed"] = Imu2EspFrame.motorRightSpeed;
-  doc["motorLeftSpeed"] = Imu2EspFrame.motorLeftSpeed;
-  doc["batteryVoltage"] = Imu2EspFrame.batteryVoltage;
-  doc["adcCurrent"] = Imu2EspFrame.adcCurrent;
-  doc["thumbleCurrent"] = Imu2EspFrame.thumbleCurrent;
-  doc["crcImu2PmbErrorCount"] = Imu2EspFrame.crcImu2PmbErrorCount;
-  doc["crcPmb2ImuErrorCount"] = Imu2EspFrame.crcPmb2ImuErrorCount;
-  doc["crcEsp2ImuErrorCount"] = Imu2EspFrame.crcEsp2ImuErrorCount;
+  Imu2EspFrame_t imu;
+
+  // clients on binary telemetry do not need it, no JSON built for nobody
+  if (ws.count() <= TelemetryStream_GetSubscribers())
+  {
+    return;
+  }
+
+  ImuCommunication_GetStatus(&imu);
+  doc["magnetBarStatus"] = imu.magnetBarStatus;
+  doc["pmbConnection"] = imu.pmbConnection;
+  doc["motorRightSpeed"] = imu.motorRightSpeed;
+  doc["motorLeftSpeed"] = imu.motorLeftSpeed;
+  doc["batteryVoltage"] = imu.batteryVoltage;
+  doc["adcCurrent"] = imu.adcCurrent;
+  doc["thumbleCurrent"] = imu.thumbleCurrent;
+  doc["crcImu2PmbErrorCount"] = imu.crcImu2PmbErrorCount;
+  doc["crcPmb2ImuErrorCount"] = imu.crcPmb2ImuErrorCount;
+  doc["crcEsp2ImuErrorCount"] = imu.crcEsp2ImuErrorCount;
+  doc["collision"] = imu.collision;
+  doc["pmbLoopMaxTime"] = imu.pmbLoopMaxTime;
+  doc["pmbMissedTicks"] = imu.pmbMissedTicks;
+  doc["pmbTaskMisses"] = imu.pmbTaskMisses;
 
   String json;
   serializeJson(doc, json);
   ws.textAll(json); // Send data to all connected WebSocket clients
 }
 
+static bool sendTelemetry(uint32_t id, const uint8_t *frame, size_t length, void *context)
+{
+    AsyncWebSocketClient *client = ws.client(id);
+
+    if (client == NULL)
+    {
+        return true; // gone, frame discarded until disconnect unsubscribes it
+    }
+    if (client->queueIsFull())
+    {
+        return false;
+    }
+    return client->binary(frame, length);
+}
+
+void WebHandler_SendTelemetry(void)
+{
+    static uint16_t sequence;
+    uint32_t now = millis();
+
+    if (TelemetryStream_IsDue(now))
+    {
+        Imu2EspFrame_t imu;
+        uint8_t frame[TELEMETRY_FRAME_SIZE];
+        uint32_t imuFrames = ImuCommunication_GetStatus(&imu);
+
+        TelemetryStream_Encode(frame, &imu, sequence++, now, imuFrames,
+                               ImuCommunication_IsStopped() ? TELEMETRY_FLAG_STOPPED : 0);
+        TelemetryStream_Push(frame, now);
+    }
+    TelemetryStream_Drain(sendTelemetry, NULL);
+}
+
+void WebHandler_GetServedStats(WebServedStats *stats, bool reset)
+{
+    *stats = ServedStats;
+    if (reset)
+    {
+        memset(&ServedStats, 0, sizeof(ServedStats));
+    }
+}
+
 void WebHandler_CleanupClients(void)
 {
     // Cleanup disconnected clients
@@ -17,9 +17,18 @@ extern IPAddress gatewayIp;
 
 extern const char* configFile;
 
+typedef struct {
+    uint32_t requests;    // pages and settings
+    uint32_t notModified; // answered 304 from the ETag
+    uint32_t bytes;       // body bytes sent
+} WebServedStats;
+
 void WebHandler_Init(void);
 void WebHandler_SendData(void);
+// Network task every 10 ms, binary telemetry of subscribed clients
+void WebHandler_SendTelemetry(void);
 void WebHandler_CleanupClients(void);
+void WebHandler_GetServedStats(WebServedStats *stats, bool reset);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,357 @@
+// Generated by Tools/WebAssets/web_assets.py from src/WebPage, do not edit.
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+typedef struct {
+    const char *path;
+    const char *contentType;
+    const uint8_t *data; // gzip
+    size_t length;
+    const char *etag;
+} WebAsset;
+
+// index.html, 13959 bytes, 3691 gzipped
+static const uint8_t WebAsset_index_html[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xc5, 0x5b, 0x5d, 0x72, 0x1b, 0x37,
+    0x12, 0x7e, 0xf7, 0x29, 0xe0, 0xf1, 0xd6, 0x7a, 0x98, 0xf0, 0x5f, 0x3f, 0xf1, 0x92, 0x14, 0x53,
+    0x12, 0xad, 0x24, 0xca, 0x4a, 0x96, 0x4a, 0x52, 0xbc, 0x51, 0xb9, 0x5c, 0x09, 0x38, 0x03, 0x92,
+    0x88, 0x86, 0x33, 0xcc, 0x0c, 0x28, 0x92, 0x71, 0xf4, 0xba, 0xaf, 0xa9, 0xda, 0x87, 0x3d, 0xca,
+    0x56, 0xf6, 0x3a, 0xbe, 0xc0, 0x5e, 0x61, 0xbb, 0x81, 0x99, 0x01, 0xe6, 0x87, 0x14, 0xed, 0x28,
+    0xe5, 0x2a, 0x97, 0x45, 0x02, 0xdd, 0x1f, 0xba, 0x1b, 0x8d, 0x46, 0x37, 0x00, 0xf6, 0x9e, 0xbe,
+    0x3c, 0x1f, 0x5c, 0xdf, 0x5c, 0x1c, 0x93, 0x89, 0x98, 0x7a, 0xfd, 0x27, 0x3d, 0xf5, 0x07, 0xfe,
+    0x32, 0xea, 0xf6, 0x9f, 0x10, 0xd2, 0x9b, 0x32, 0x41, 0x89, 0x33, 0xa1, 0x61, 0xc4, 0xc4, 0x81,
+    0xf5, 0xdd, 0xf5, 0x57, 0xb5, 0x17, 0x96, 0xec, 0x10, 0x5c, 0x78, 0xac, 0xff, 0x6d, 0xb0, 0x8a,
+    0x04, 0x77, 0x6e, 0xc9, 0x3f, 0xd8, 0xf0, 0x2a, 0x70, 0x6e, 0x99, 0xe8, 0x35, 0x54, 0x0f, 0xd2,
+    0x44, 0x62, 0xa5, 0x3e, 0x11, 0x32, 0x0c, 0xdc, 0x15, 0x79, 0x27, 0x3f, 0x12, 0x32, 0x0a, 0x7c,
+    0x51, 0x1b, 0xd1, 0x29, 0xf7, 0x56, 0x1d, 0x72, 0x18, 0x72, 0xea, 0x55, 0x49, 0x44, 0xfd, 0xa8,
+    0x16, 0xb1, 0x90, 0x8f, 0xba, 0x31, 0x95, 0x60, 0x4b, 0x51, 0xa3, 0x1e, 0x1f, 0xfb, 0x1d, 0xe2,
+    0x30, 0x5f, 0xb0, 0x30, 0xe9, 0x99, 0xd2, 0x70, 0xcc, 0xfd, 0x9a, 0x08, 0x66, 0x1d, 0xb2, 0xd3,
+    0x9c, 0x2d, 0x93, 0xf6, 0x39, 0xf0, 0x03, 0x86, 0xc7, 0x1c, 0xd1, 0x21, 0x7e, 0xe0, 0x33, 0xd5,
+    0x71, 0xff, 0x44, 0xfe, 0x71, 0xa8, 0x7f, 0x47, 0xa3, 0x54, 0x88, 0x61, 0x10, 0xba, 0x2c, 0xec,
+    0x90, 0xd6, 0x6c, 0x49, 0xa2, 0xc0, 0xe3, 0x2e, 0x79, 0xd6, 0x6c, 0x36, 0xd3, 0xc1, 0x83, 0xb9,
+    0x33, 0xa9, 0x51, 0x47, 0xf0, 0xc0, 0x2f, 0xc1, 0xaa, 0x0f, 0xb9, 0x48, 0x91, 0x16, 0xdc, 0x15,
+    0x93, 0x0e, 0x69, 0x1b, 0x92, 0x4c, 0x18, 0x1f, 0x4f, 0x44, 0xb6, 0x4d, 0x0d, 0x58, 0x0b, 0xa9,
+    0xcb, 0xe7, 0x51, 0x87, 0xec, 0x1a, 0x3d, 0xd4, 0xb9, 0x1d, 0x87, 0xc1, 0xdc, 0x77, 0x6b, 0x4e,
+    0xe0, 0x05, 0x20, 0xd4, 0xb3, 0xe1, 0x70, 0xd8, 0x5d, 0x2f, 0xe8, 0xfe, 0xfe, 0x7e, 0x2a, 0x68,
+    0x08, 0x86, 0xe3, 0x4a, 0xcc, 0x3c, 0x0e, 0x69, 0xd6, 0xdb, 0x51, 0x41, 0xee, 0x7a, 0xe0, 0x6b,
+    0x23, 0x14, 0x47, 0xde, 0x75, 0xe8, 0x68, 0xaf, 0x99, 0xe1, 0x7a, 0xc6, 0xa6, 0x2c, 0x1c, 0x33,
+    0xdf, 0x59, 0x5d, 0x81, 0xcd, 0x8f, 0xe6, 0x42, 0x18, 0x10, 0x89, 0xf6, 0xfb, 0x25, 0xea, 0xbf,
+    0x30, 0xda, 0xe4, 0xa4, 0x47, 0xfc, 0x17, 0x06, 0xb4, 0xbb, 0xb9, 0xe6, 0x45, 0x4c, 0x3f, 0x0c,
+    0x3c, 0x37, 0xe9, 0x48, 0xe4, 0x19, 0x8d, 0x46, 0x1b, 0xec, 0xe4, 0xee, 0xb4, 0x47, 0xed, 0x51,
+    0xde, 0x54, 0x3b, 0xda, 0x54, 0x5f, 0x8c, 0x9a, 0xc6, 0xb4, 0xe6, 0xe6, 0xe0, 0x45, 0x22, 0xc7,
+    0x3d, 0xba, 0x6b, 0x23, 0xf6, 0xd7, 0x5e, 0x43, 0xb9, 0xff, 0x93, 0x1e, 0x7a, 0xad, 0xf4, 0x64,
+    0x97, 0xdf, 0x11, 0xee, 0x1e, 0x58, 0x8b, 0xe8, 0x4a, 0x50, 0x31, 0x8f, 0x2c, 0x22, 0x69, 0x0f,
+    0xac, 0x58, 0x8e, 0x90, 0xb9, 0xdd, 0x32, 0x87, 0x2d, 0x51, 0x8f, 0xb8, 0x3c, 0x9a, 0x79, 0x74,
+    0x15, 0x7b, 0x95, 0xa5, 0xd6, 0x47, 0xba, 0x7e, 0xb0, 0xdb, 0x09, 0x7c, 0x1f, 0x7c, 0x98, 0xb9,
+    0x75, 0x72, 0xe1, 0x31, 0x1a, 0x31, 0xc0, 0x1f, 0x85, 0x2c, 0x9a, 0x10, 0x31, 0x61, 0x64, 0x46,
+    0xc7, 0xac, 0x2e, 0xe5, 0x05, 0xa9, 0xa4, 0x74, 0x93, 0x56, 0xff, 0x2c, 0x40, 0x17, 0x20, 0x03,
+    0x18, 0x2e, 0x0c, 0x3c, 0x8f, 0x85, 0xa0, 0x44, 0x2b, 0x15, 0xdd, 0xf1, 0x68, 0x14, 0x1d, 0x58,
+    0x43, 0x39, 0x73, 0x5a, 0xf8, 0x78, 0x1d, 0x0d, 0x03, 0x68, 0x9e, 0xc6, 0xce, 0x1a, 0xcb, 0xd3,
+    0x53, 0xb4, 0x52, 0xe9, 0x92, 0xd9, 0xb7, 0xfa, 0xc7, 0x67, 0xc7, 0x97, 0x5f, 0x1f, 0xbf, 0x1a,
+    0xdc, 0x90, 0xab, 0xeb, 0xf3, 0x8b, 0x5e, 0x43, 0xd1, 0x17, 0x99, 0x43, 0x26, 0x35, 0x48, 0xd8,
+    0x2e, 0xd5, 0x57, 0x93, 0x5e, 0xeb, 0x11, 0xaf, 0x50, 0x64, 0xfb, 0x29, 0x0e, 0x2c, 0x96, 0xf2,
+    0xaf, 0x03, 0x6b, 0xa7, 0xd9, 0xb4, 0x62, 0xbf, 0x52, 0x5f, 0xfa, 0xbd, 0x86, 0xa2, 0x97, 0xac,
+    0xb3, 0xfe, 0xf7, 0x1d, 0x08, 0x38, 0x33, 0xaa, 0x46, 0x5d, 0xbe, 0xa6, 0x9e, 0xd5, 0x6f, 0xc2,
+    0x94, 0x42, 0x0b, 0x50, 0xce, 0x62, 0xa2, 0x1b, 0x93, 0x68, 0x55, 0x24, 0xca, 0x19, 0x2c, 0x02,
+    0x17, 0x02, 0x77, 0x81, 0xf9, 0x10, 0x94, 0xfb, 0x2c, 0x4c, 0x8c, 0xe3, 0xd1, 0x21, 0xf3, 0x60,
+    0x6e, 0x43, 0x20, 0x99, 0x31, 0xe6, 0x5e, 0x49, 0x3a, 0xab, 0x7f, 0x38, 0x1f, 0xb3, 0x90, 0x5c,
+    0x61, 0x53, 0xa7, 0xd7, 0x90, 0x54, 0x31, 0x07, 0xf7, 0x67, 0x73, 0x41, 0xc4, 0x6a, 0x06, 0x66,
+    0x87, 0x15, 0x3b, 0x66, 0x96, 0x14, 0x81, 0x22, 0xc3, 0x95, 0x01, 0x41, 0xa6, 0xdc, 0x3f, 0xb0,
+    0x40, 0xd5, 0x29, 0x5d, 0x1e, 0x58, 0xad, 0x3d, 0xd4, 0xfa, 0x8e, 0x7a, 0x73, 0x60, 0xdb, 0x83,
+    0x8f, 0x81, 0x2f, 0x81, 0x0e, 0xac, 0xf9, 0xcc, 0xa5, 0x82, 0x49, 0xce, 0xd7, 0xd8, 0x6d, 0x8b,
+    0x09, 0x8f, 0xea, 0x92, 0xb2, 0x92, 0x48, 0xf9, 0xb4, 0x56, 0xd3, 0xca, 0x46, 0x29, 0xa9, 0xd5,
+    0xdf, 0x4b, 0x74, 0x26, 0xb5, 0x9a, 0x31, 0x03, 0xa6, 0xa3, 0xc3, 0x2a, 0x13, 0x2c, 0x75, 0x94,
+    0x32, 0xcf, 0x2e, 0x04, 0xe1, 0x64, 0xd8, 0xc9, 0x4e, 0xff, 0x4a, 0xc6, 0x60, 0x72, 0x89, 0x20,
+    0x60, 0x08, 0x68, 0x51, 0x81, 0xa4, 0x07, 0x26, 0x9b, 0x6a, 0xfc, 0xf3, 0x19, 0x3a, 0x6d, 0x64,
+    0xc5, 0x8b, 0x33, 0x1e, 0x2c, 0x5d, 0x1f, 0x23, 0x8f, 0x2d, 0xbb, 0xe4, 0xa7, 0x39, 0x38, 0xc2,
+    0x68, 0x25, 0x27, 0x01, 0x86, 0xd6, 0x02, 0x8c, 0x29, 0x8c, 0xdc, 0xc2, 0x91, 0x25, 0x65, 0x6d,
+    0x11, 0x62, 0x03, 0xfe, 0x9f, 0x0a, 0x57, 0xe6, 0xd9, 0xc9, 0xf4, 0xf5, 0x73, 0x73, 0xe2, 0xf2,
+    0xc0, 0x22, 0x3e, 0x9d, 0xb2, 0x8c, 0x70, 0x89, 0xf5, 0x9b, 0x7d, 0x72, 0x98, 0x99, 0xd1, 0x8f,
+    0x83, 0x69, 0xf5, 0xc9, 0xd1, 0x23, 0xc0, 0xb4, 0xfb, 0x64, 0xf0, 0x08, 0x30, 0x3b, 0x7d, 0xf2,
+    0xf2, 0x11, 0x60, 0x76, 0xfb, 0xe4, 0xab, 0x47, 0x80, 0xd9, 0xeb, 0x93, 0xaf, 0x1f, 0x01, 0x66,
+    0xbf, 0x4f, 0xbe, 0x79, 0x04, 0x98, 0x2f, 0xfa, 0xe4, 0xe4, 0x11, 0x60, 0x5e, 0xf4, 0xc9, 0xb7,
+    0x8f, 0x00, 0xf3, 0xb7, 0x3e, 0xf9, 0x7b, 0x36, 0xa0, 0x34, 0x70, 0x29, 0x25, 0xcb, 0xaa, 0x24,
+    0xc6, 0xa7, 0xa3, 0x19, 0xb1, 0x18, 0x97, 0x55, 0x12, 0x88, 0xdf, 0xff, 0xfb, 0x3f, 0xff, 0xfb,
+    0xfd, 0x37, 0xd8, 0x5f, 0xe8, 0x2a, 0x1b, 0xbc, 0x73, 0x2c, 0x74, 0xae, 0x83, 0xf7, 0xfb, 0xdf,
+    0x7e, 0x97, 0x3c, 0xd8, 0xb6, 0x89, 0x29, 0x32, 0xf6, 0x89, 0xf7, 0xbf, 0xfd, 0x17, 0x79, 0x70,
+    0xeb, 0xc8, 0x6d, 0x12, 0x69, 0xd8, 0xd7, 0xd1, 0x47, 0x86, 0x0e, 0x21, 0xb8, 0x3f, 0x8e, 0xe2,
+    0xb0, 0x91, 0x55, 0x4e, 0x04, 0xe3, 0xb1, 0xc7, 0x8a, 0xf1, 0xd8, 0x34, 0xa5, 0x33, 0x61, 0xce,
+    0xed, 0x30, 0x58, 0xaa, 0x00, 0x3b, 0x0b, 0x16, 0x2c, 0x1c, 0xa4, 0x4d, 0xca, 0xc0, 0x77, 0x6c,
+    0xc2, 0x1d, 0x8f, 0xb5, 0xd2, 0xd0, 0x8a, 0x82, 0x16, 0x22, 0x7b, 0x4a, 0xd5, 0xbf, 0x40, 0x90,
+    0xc4, 0xfc, 0xbd, 0x61, 0xf8, 0xe0, 0xa8, 0x98, 0x30, 0x43, 0xfc, 0x19, 0xff, 0xd1, 0x81, 0x07,
+    0x31, 0x4e, 0x6e, 0xec, 0x5c, 0xbc, 0x4e, 0x77, 0x73, 0x88, 0x81, 0x2a, 0x19, 0xdb, 0x6d, 0xca,
+    0xb0, 0xa8, 0xa2, 0x60, 0x87, 0xd0, 0xb9, 0x08, 0xb2, 0xe9, 0x89, 0xc7, 0x46, 0xa2, 0x9b, 0xcd,
+    0xc3, 0x8d, 0x04, 0xdc, 0x8c, 0xe4, 0x32, 0xdd, 0x49, 0x27, 0x43, 0x6e, 0xa2, 0x17, 0x67, 0x47,
+    0x98, 0x68, 0x60, 0x8a, 0x22, 0xd3, 0x4e, 0xbd, 0xc9, 0xcc, 0xa6, 0x43, 0xdd, 0x61, 0xf5, 0x61,
+    0xff, 0xc9, 0x6c, 0xc0, 0x92, 0x1b, 0x32, 0x15, 0xc8, 0x4c, 0x2f, 0x71, 0x23, 0x8f, 0x77, 0x4a,
+    0x03, 0x60, 0x8a, 0x9d, 0xb2, 0x4f, 0x76, 0x19, 0x10, 0xe4, 0xf2, 0xe2, 0xac, 0x08, 0x73, 0x0a,
+    0x7a, 0xac, 0x41, 0xc1, 0xae, 0x87, 0x40, 0x8e, 0xa8, 0x80, 0xad, 0x64, 0x45, 0x5e, 0x07, 0x9e,
+    0x80, 0xac, 0xca, 0xc4, 0x18, 0xaa, 0xae, 0xb8, 0xc7, 0xc4, 0x98, 0xbe, 0x36, 0x21, 0x0e, 0x5f,
+    0x0e, 0xc8, 0x60, 0x1e, 0x86, 0x72, 0x6b, 0xd2, 0xec, 0xd4, 0x75, 0xe2, 0xd6, 0x0c, 0xeb, 0xa1,
+    0xc9, 0x7a, 0x3d, 0x99, 0x4f, 0x87, 0x1e, 0x2b, 0x63, 0x17, 0xaa, 0xeb, 0x41, 0x88, 0xc1, 0xe5,
+    0x80, 0x9c, 0x9c, 0x7d, 0x47, 0xde, 0xff, 0xf3, 0x5f, 0x04, 0xa7, 0xe5, 0x38, 0x0c, 0x83, 0x30,
+    0x32, 0x91, 0x9c, 0xd0, 0x39, 0x99, 0xce, 0xdb, 0x17, 0xd3, 0xa1, 0xec, 0x1b, 0x40, 0xf6, 0x2c,
+    0xd6, 0xcc, 0x0c, 0x82, 0x21, 0x08, 0x82, 0x21, 0x68, 0x29, 0x18, 0x00, 0xb5, 0x01, 0x70, 0x2b,
+    0xb0, 0xe3, 0xab, 0x8b, 0xcd, 0x60, 0xc7, 0xd1, 0x6c, 0x3b, 0x30, 0x48, 0x69, 0x79, 0x94, 0x73,
+    0x36, 0x27, 0x69, 0x5c, 0xc3, 0x84, 0xaa, 0x9c, 0x06, 0xc1, 0x8c, 0x9c, 0xd1, 0x65, 0xce, 0x49,
+    0xb1, 0x19, 0x5a, 0xaf, 0xf9, 0x34, 0x33, 0xb3, 0xf3, 0x28, 0xcf, 0x7f, 0xc6, 0xa3, 0x88, 0xb9,
+    0xe4, 0x1a, 0x32, 0xd1, 0x28, 0x87, 0xa1, 0xba, 0x64, 0xcf, 0x06, 0x01, 0xae, 0x69, 0x74, 0xab,
+    0x50, 0xf2, 0xfc, 0xd8, 0xa3, 0x3a, 0x8a, 0xec, 0xd9, 0x90, 0x78, 0x46, 0xc7, 0x3e, 0x14, 0x06,
+    0x47, 0x34, 0xcc, 0x06, 0x45, 0xe9, 0xa6, 0x5c, 0x9c, 0xf8, 0x2e, 0x77, 0xa8, 0x40, 0x0b, 0x26,
+    0x61, 0x71, 0xdb, 0xbc, 0x2d, 0x93, 0xf1, 0x1b, 0x90, 0xa7, 0x18, 0x6d, 0x74, 0x9d, 0x90, 0xcb,
+    0xc8, 0x64, 0xe2, 0xb5, 0x3f, 0xdb, 0x94, 0x9b, 0x19, 0xc5, 0x5e, 0x6b, 0x57, 0x87, 0xa2, 0x34,
+    0x21, 0xdb, 0x33, 0xc6, 0x4d, 0xf6, 0x81, 0x35, 0x5a, 0x6d, 0x94, 0x62, 0x77, 0x93, 0x14, 0x58,
+    0x22, 0x14, 0xf7, 0x98, 0xc8, 0x09, 0xf9, 0x4c, 0xa8, 0x01, 0x81, 0x23, 0x12, 0xc9, 0xc1, 0xc0,
+    0x01, 0x71, 0x03, 0x67, 0x3e, 0x05, 0xde, 0xfa, 0x98, 0x89, 0x63, 0x8f, 0xe1, 0xc7, 0xa3, 0xd5,
+    0x89, 0x6b, 0xeb, 0x6a, 0xa4, 0xd2, 0x35, 0xf9, 0xc4, 0x12, 0x98, 0x14, 0x37, 0xb2, 0xa0, 0xfd,
+    0xc1, 0xe0, 0xb6, 0xd5, 0x76, 0x73, 0x84, 0x52, 0x9e, 0xef, 0x35, 0xb1, 0x0c, 0xd3, 0xa4, 0x41,
+    0xda, 0x45, 0xaa, 0x1b, 0x4d, 0xa5, 0xaa, 0x9d, 0x3c, 0x99, 0xaa, 0x5d, 0x81, 0xaa, 0x95, 0x94,
+    0xb5, 0xaa, 0x7d, 0x42, 0x7d, 0xd7, 0x63, 0x97, 0x49, 0x6f, 0x3b, 0xee, 0xf4, 0xc0, 0x73, 0x1c,
+    0x15, 0x46, 0xa4, 0x00, 0x4a, 0x94, 0x42, 0xdf, 0x4d, 0xda, 0x77, 0xa3, 0xfb, 0xdc, 0x90, 0x8e,
+    0x71, 0xfb, 0x81, 0xbe, 0x11, 0xf5, 0x22, 0xd6, 0x55, 0xe9, 0x46, 0xa3, 0x61, 0x94, 0xab, 0xf3,
+    0x08, 0x09, 0xa0, 0x94, 0x25, 0x11, 0x03, 0x2c, 0x46, 0x9c, 0x74, 0x03, 0x30, 0x84, 0x1b, 0x43,
+    0xb1, 0xb2, 0xa0, 0x2b, 0x00, 0xfa, 0x71, 0x11, 0x75, 0x1a, 0x8d, 0xbf, 0xbc, 0x5b, 0x70, 0xdf,
+    0x0d, 0x16, 0x75, 0x2f, 0x80, 0x49, 0x06, 0xda, 0xfa, 0x24, 0x88, 0x04, 0x6e, 0x92, 0xf7, 0x8d,
+    0x45, 0xf4, 0xa3, 0xa9, 0xd7, 0x82, 0x0d, 0x23, 0x35, 0xd4, 0x01, 0xf1, 0xd9, 0x42, 0x0f, 0x6d,
+    0xc7, 0xa0, 0xb1, 0xa9, 0x53, 0xba, 0xfa, 0x90, 0xfb, 0x34, 0x5c, 0x5d, 0xc3, 0xbe, 0x0c, 0x2c,
+    0x16, 0x0d, 0x43, 0xba, 0x1a, 0xce, 0x47, 0x23, 0x58, 0x17, 0x5a, 0x01, 0x45, 0x03, 0xae, 0x85,
+    0xdb, 0x1b, 0x19, 0x85, 0x30, 0x72, 0x54, 0x25, 0xd7, 0x0c, 0x67, 0x5d, 0x84, 0x50, 0xe9, 0x86,
+    0x8c, 0x4e, 0xeb, 0x13, 0x43, 0x8e, 0xeb, 0xe3, 0x53, 0xa8, 0x79, 0xaf, 0x2f, 0x6f, 0x7e, 0x38,
+    0x3b, 0xfc, 0xfa, 0x64, 0x00, 0xd0, 0xcd, 0xe5, 0xde, 0x6e, 0xb7, 0x94, 0xe2, 0xab, 0xf3, 0xcb,
+    0xb3, 0xc3, 0x6b, 0x9c, 0x85, 0xf2, 0xfe, 0xcb, 0xc3, 0xeb, 0x63, 0x35, 0x47, 0x28, 0xcb, 0x9b,
+    0x6f, 0x7e, 0x79, 0xfb, 0x24, 0xa7, 0x43, 0xe0, 0x07, 0x33, 0xe6, 0x03, 0x8d, 0x5d, 0x21, 0x07,
+    0xfd, 0xf4, 0xb0, 0x05, 0x81, 0x02, 0x8f, 0x81, 0xd9, 0xc6, 0xb6, 0xa5, 0x27, 0x41, 0xdb, 0x9c,
+    0x20, 0x1b, 0x4b, 0xfd, 0x8f, 0xac, 0xf7, 0xe9, 0xf4, 0x28, 0xa3, 0x52, 0x97, 0x0b, 0xac, 0x1e,
+    0xaf, 0x2f, 0xb4, 0x19, 0x9e, 0x4c, 0x58, 0x09, 0x82, 0x16, 0x2a, 0x62, 0xbe, 0x6b, 0x7f, 0x7b,
+    0x75, 0xfe, 0x0a, 0x38, 0x42, 0x98, 0x76, 0x58, 0x74, 0xf6, 0x3b, 0x99, 0x00, 0x75, 0x08, 0xc4,
+    0x9a, 0xd8, 0x76, 0x56, 0x15, 0x7c, 0x14, 0xea, 0xbe, 0xbc, 0xbe, 0xf7, 0x95, 0x58, 0xa8, 0xfb,
+    0x6e, 0x51, 0x5b, 0xc7, 0x0b, 0x22, 0xb6, 0x56, 0xdd, 0x05, 0x0d, 0x7d, 0x53, 0x5f, 0xf3, 0x8c,
+    0xe4, 0x0f, 0xaa, 0x3a, 0x04, 0x0f, 0xbc, 0xb5, 0xd6, 0x0b, 0xc6, 0x70, 0x6f, 0x42, 0xc1, 0xe4,
+    0x87, 0x52, 0xe9, 0x64, 0x8f, 0x29, 0x9e, 0x6c, 0xe8, 0x80, 0x1d, 0x14, 0xcf, 0xa3, 0xcb, 0x07,
+    0x3e, 0xe3, 0x0e, 0xce, 0x4f, 0x4f, 0x4f, 0xae, 0x4e, 0xce, 0x5f, 0xfd, 0x50, 0xaf, 0xd7, 0xc1,
+    0xe2, 0x58, 0x33, 0x10, 0x1e, 0x11, 0x99, 0xb0, 0xbb, 0x04, 0xf6, 0x52, 0xee, 0x11, 0x04, 0x31,
+    0x23, 0x4c, 0xb2, 0x63, 0xbe, 0x42, 0x77, 0x07, 0xf4, 0x37, 0x6a, 0xa6, 0xab, 0xc4, 0xe2, 0xd3,
+    0x19, 0x75, 0x04, 0x7e, 0x5a, 0x4c, 0x18, 0x24, 0xa2, 0xb0, 0x30, 0x3c, 0x0f, 0xbf, 0xca, 0x13,
+    0x0a, 0x12, 0xdc, 0xb1, 0xd0, 0x0b, 0xa8, 0x6b, 0xbd, 0x8d, 0x45, 0x18, 0xcd, 0x7d, 0xe5, 0x6f,
+    0x2e, 0x73, 0x02, 0x97, 0xa5, 0x0b, 0xc7, 0x56, 0x2b, 0xad, 0x92, 0x31, 0x92, 0x20, 0x77, 0x1c,
+    0x56, 0xae, 0x5a, 0xbf, 0x2f, 0xa9, 0xa0, 0xaf, 0xe1, 0x6b, 0x42, 0x99, 0x58, 0x87, 0x8f, 0x48,
+    0xdc, 0x54, 0x1f, 0xae, 0x04, 0x3b, 0x65, 0xfe, 0x18, 0x62, 0x64, 0x8f, 0xec, 0xee, 0x93, 0x5f,
+    0x7f, 0x95, 0x00, 0x68, 0xb7, 0xef, 0xb8, 0x2f, 0x5e, 0xd8, 0xcd, 0x0a, 0x79, 0x7a, 0x70, 0x50,
+    0x58, 0x92, 0x05, 0xba, 0x56, 0x9e, 0x4e, 0x2d, 0x4c, 0x2d, 0x1d, 0x21, 0x21, 0x13, 0xf3, 0xd0,
+    0x27, 0xfe, 0xdc, 0xf3, 0x12, 0x49, 0xee, 0x9f, 0x64, 0xba, 0x34, 0xed, 0x54, 0x6e, 0xc4, 0xb0,
+    0x0f, 0xc7, 0x59, 0x71, 0x66, 0xb4, 0x9d, 0xb6, 0xfd, 0xa2, 0x4a, 0x44, 0x38, 0x67, 0x95, 0x6a,
+    0xca, 0x91, 0x49, 0x88, 0xb3, 0xf4, 0xad, 0x7d, 0xbb, 0xd5, 0x2e, 0x30, 0xe4, 0x12, 0x60, 0xcd,
+    0x72, 0xa2, 0x38, 0x76, 0xcb, 0x39, 0xd2, 0x64, 0xb7, 0xc0, 0xb0, 0x5f, 0x60, 0xc8, 0x66, 0xb6,
+    0x45, 0xa1, 0x8a, 0x5a, 0xe8, 0x64, 0xb6, 0x40, 0xdd, 0x6e, 0x16, 0xa8, 0xb3, 0xb9, 0x6b, 0x91,
+    0xa3, 0xa8, 0x74, 0x59, 0x8e, 0x5a, 0xe4, 0xdb, 0x2d, 0xe3, 0x2b, 0xa4, 0xa3, 0x45, 0xbe, 0xfd,
+    0x32, 0xbe, 0x42, 0xe6, 0x59, 0xe4, 0x2b, 0xda, 0xc1, 0xd1, 0x69, 0x68, 0xd6, 0xcf, 0x76, 0x9a,
+    0xd9, 0x39, 0x37, 0xf2, 0xcb, 0x02, 0xee, 0x6e, 0xb3, 0xcc, 0x4b, 0x8c, 0x6c, 0xb2, 0xc8, 0xd1,
+    0x2e, 0xe3, 0xd0, 0xf9, 0x63, 0x91, 0x21, 0x31, 0x55, 0xe2, 0xd0, 0x99, 0xd3, 0x7c, 0x33, 0xba,
+    0x41, 0x18, 0x88, 0xc0, 0x09, 0x70, 0x83, 0x4f, 0x16, 0xb4, 0xcd, 0xee, 0x60, 0xda, 0xf4, 0x12,
+    0x81, 0x45, 0x6d, 0x2c, 0x01, 0xb5, 0x9c, 0x5d, 0x58, 0xc3, 0x32, 0x26, 0x22, 0x69, 0x5d, 0x7e,
+    0xe3, 0xd0, 0x4e, 0x7d, 0x87, 0x05, 0x23, 0x72, 0x88, 0x3b, 0xee, 0x51, 0x1c, 0x07, 0xbe, 0x2c,
+    0x44, 0x08, 0xcd, 0x54, 0x21, 0x1d, 0x22, 0xb7, 0x93, 0x19, 0xde, 0x2f, 0x99, 0x1d, 0xdd, 0x74,
+    0x40, 0x0c, 0x0b, 0x4f, 0x15, 0xb1, 0x96, 0x22, 0x59, 0x9b, 0x9a, 0xec, 0x3e, 0xfd, 0xa4, 0x4e,
+    0x46, 0x8f, 0x8c, 0x0c, 0x32, 0xb2, 0x91, 0xbf, 0x9e, 0x5b, 0xbd, 0xc6, 0x18, 0x6b, 0x03, 0x73,
+    0xb6, 0x9e, 0xad, 0xd4, 0x39, 0x7c, 0x0e, 0xaf, 0x21, 0xc7, 0xc3, 0x64, 0x11, 0x31, 0x33, 0x04,
+    0x5b, 0x00, 0xe6, 0xeb, 0xdb, 0x12, 0xc8, 0x1c, 0xc9, 0xb6, 0xa0, 0xba, 0xdc, 0x5d, 0x87, 0x99,
+    0x52, 0x6c, 0x01, 0x99, 0xab, 0x7e, 0x4b, 0x20, 0xb3, 0x14, 0x5b, 0x40, 0x1a, 0x15, 0x71, 0x09,
+    0x9c, 0xee, 0xdd, 0x02, 0x2a, 0x57, 0x1d, 0x97, 0xc0, 0x65, 0x29, 0xb6, 0x80, 0x2c, 0x2d, 0x93,
+    0x4b, 0x80, 0xcb, 0xe8, 0xb6, 0x83, 0x2f, 0x16, 0xce, 0xe5, 0xf0, 0x05, 0xba, 0xed, 0xe0, 0x8b,
+    0xa5, 0x74, 0x39, 0x7c, 0x81, 0x6e, 0x1b, 0xf8, 0xb4, 0xd2, 0xce, 0x62, 0x66, 0xf3, 0x89, 0x37,
+    0x6a, 0x88, 0xa4, 0xed, 0x2d, 0x6e, 0xc7, 0xd9, 0xa6, 0xed, 0x56, 0x9c, 0x59, 0x9c, 0x97, 0x2f,
+    0x39, 0x83, 0x62, 0x3b, 0x48, 0xb3, 0x56, 0x2f, 0x87, 0x34, 0x28, 0xb6, 0x83, 0x34, 0xca, 0xf7,
+    0x72, 0x44, 0x4d, 0x90, 0xe6, 0x15, 0x50, 0xd8, 0x09, 0x67, 0x02, 0x61, 0xb3, 0x92, 0x8b, 0xa8,
+    0x46, 0x16, 0x29, 0x27, 0x86, 0x60, 0x40, 0xc4, 0xba, 0x2a, 0xae, 0x4f, 0x10, 0x53, 0xe6, 0x93,
+    0x95, 0x6c, 0x8e, 0x72, 0x9f, 0xcf, 0xc6, 0x30, 0x43, 0x4f, 0xee, 0xe4, 0x31, 0xd1, 0xb2, 0x97,
+    0x55, 0xb2, 0xca, 0x27, 0x63, 0x33, 0xba, 0xc2, 0x5c, 0x0e, 0x64, 0x5d, 0x97, 0xcb, 0xa7, 0xf5,
+    0x6e, 0x95, 0x2c, 0x3b, 0x04, 0x31, 0x3a, 0x64, 0x05, 0x09, 0xbc, 0x99, 0xab, 0xe9, 0x6d, 0x04,
+    0x4a, 0x25, 0x77, 0x85, 0x41, 0x15, 0xf6, 0x11, 0xc8, 0xb6, 0xd2, 0x3c, 0xb8, 0x7e, 0x7e, 0x71,
+    0xfc, 0xca, 0x54, 0x35, 0x57, 0x49, 0xc4, 0x72, 0xe4, 0x75, 0x2a, 0x51, 0x49, 0xde, 0xab, 0xd9,
+    0xfa, 0xb2, 0xec, 0xc3, 0x35, 0x92, 0xbc, 0xa0, 0x8e, 0x3c, 0x77, 0xed, 0x48, 0xfb, 0x32, 0xc8,
+    0x90, 0x32, 0x98, 0x9f, 0x4e, 0x3f, 0x79, 0x51, 0x66, 0xcb, 0x1c, 0xfe, 0xc3, 0x55, 0x53, 0x57,
+    0x75, 0xa9, 0x6a, 0xaa, 0x12, 0xf8, 0x74, 0xba, 0xa8, 0x83, 0x7f, 0x5b, 0x1d, 0xf5, 0x63, 0x60,
+    0xf8, 0x70, 0x8d, 0x14, 0xaf, 0x56, 0x49, 0x63, 0x7d, 0x42, 0xbd, 0xf0, 0x06, 0xc3, 0xd6, 0x48,
+    0x8f, 0x33, 0xfc, 0xf3, 0x77, 0x16, 0xea, 0x6c, 0x75, 0xe4, 0x9d, 0x89, 0x75, 0xff, 0x7c, 0x1b,
+    0x67, 0x51, 0x57, 0xe8, 0x7f, 0xa2, 0x2c, 0xf1, 0x9d, 0xfd, 0x76, 0xe2, 0x24, 0x77, 0x1c, 0x72,
+    0x44, 0x9b, 0xbb, 0x55, 0x22, 0xef, 0x42, 0x3e, 0x66, 0x91, 0xa6, 0x97, 0x28, 0x55, 0xc2, 0xa1,
+    0x92, 0x41, 0xac, 0xd8, 0x03, 0x62, 0xc8, 0x4f, 0x34, 0xfd, 0x6e, 0x48, 0x17, 0x49, 0x54, 0xcd,
+    0x47, 0x54, 0xb1, 0xac, 0x3b, 0x60, 0xad, 0xf0, 0x12, 0x72, 0x40, 0x1b, 0x52, 0x7b, 0xf8, 0x67,
+    0x1e, 0xf2, 0x55, 0xb3, 0x87, 0x79, 0xe9, 0x40, 0xc8, 0x37, 0x64, 0x63, 0xee, 0x5f, 0x50, 0x31,
+    0xb1, 0x33, 0xcd, 0x34, 0x74, 0xec, 0xf8, 0x98, 0xae, 0x9a, 0x9c, 0xc9, 0x55, 0xe3, 0x63, 0x3f,
+    0x89, 0x7f, 0x06, 0x2c, 0xf5, 0x8b, 0x13, 0xf2, 0x19, 0x69, 0x67, 0x18, 0xc1, 0xa2, 0xc1, 0x2d,
+    0xb3, 0xb7, 0x1d, 0x03, 0x15, 0xa9, 0x66, 0x8e, 0x0d, 0x37, 0xa2, 0x8f, 0xb8, 0xe7, 0x5d, 0xe1,
+    0xe9, 0x84, 0x3a, 0x95, 0x98, 0xeb, 0x03, 0xa2, 0xa4, 0x37, 0x19, 0x22, 0x6f, 0x3e, 0x35, 0xc4,
+    0x59, 0x70, 0xc7, 0xec, 0x42, 0x30, 0x08, 0xf1, 0x9d, 0x80, 0x79, 0x88, 0x7a, 0x84, 0xcf, 0x7b,
+    0xf0, 0xea, 0xcc, 0xe3, 0xa0, 0xba, 0xb4, 0xaa, 0x16, 0x43, 0x9d, 0x62, 0xc8, 0x1e, 0x3c, 0xcc,
+    0x64, 0x75, 0xf9, 0x4c, 0x8b, 0x45, 0x50, 0x65, 0xa4, 0x9f, 0xdf, 0x34, 0xdf, 0xd6, 0x13, 0x92,
+    0x0e, 0x34, 0xc7, 0x9f, 0xcb, 0x30, 0x6e, 0x1e, 0xc6, 0xb8, 0x31, 0x30, 0x6e, 0xb2, 0x18, 0xf2,
+    0xf0, 0x37, 0x1e, 0xa8, 0x26, 0x15, 0xa9, 0xcb, 0x6b, 0xb5, 0x0c, 0xd1, 0x2a, 0x25, 0xba, 0x49,
+    0x88, 0x60, 0xa1, 0xc7, 0xdb, 0x76, 0x5a, 0x4e, 0x21, 0xd4, 0x12, 0xfa, 0x33, 0xa7, 0xb3, 0x69,
+    0x2f, 0x62, 0xac, 0xd2, 0xde, 0x9c, 0x14, 0x2e, 0x57, 0x75, 0x17, 0xd0, 0xc8, 0x99, 0x9b, 0x72,
+    0xdf, 0x96, 0x1f, 0xa2, 0x9f, 0x43, 0x61, 0x03, 0xf2, 0x67, 0x08, 0xff, 0x39, 0xa2, 0xc0, 0xa7,
+    0x55, 0x25, 0xf1, 0xa4, 0x4a, 0x4e, 0x06, 0xea, 0x8f, 0xbd, 0x14, 0x04, 0x32, 0x07, 0xbf, 0x6d,
+    0xbb, 0xe0, 0x1e, 0xee, 0x52, 0x5b, 0xbf, 0x70, 0x8a, 0x8c, 0xb0, 0xc9, 0xf0, 0x9f, 0x29, 0x4e,
+    0x27, 0x88, 0x6c, 0x09, 0x95, 0x67, 0x33, 0x0e, 0x98, 0x4b, 0xd8, 0x20, 0xd9, 0x49, 0xd9, 0x32,
+    0x62, 0xf9, 0x41, 0x38, 0xfd, 0x3e, 0x11, 0x4b, 0x3e, 0xfd, 0xb2, 0x6d, 0x3b, 0x95, 0x24, 0xb5,
+    0x58, 0x85, 0x34, 0x12, 0xbd, 0x00, 0xb2, 0xd5, 0x6c, 0xe6, 0x7c, 0x06, 0x61, 0x6e, 0x0a, 0x30,
+    0xb1, 0x38, 0xb5, 0x54, 0xc6, 0x12, 0x18, 0x3c, 0x6c, 0xbb, 0x81, 0x89, 0xbb, 0x63, 0x90, 0x31,
+    0xb8, 0x4f, 0x1e, 0x3a, 0xca, 0x93, 0x0f, 0x8f, 0x2a, 0x75, 0xbc, 0x07, 0x18, 0xa8, 0xeb, 0x08,
+    0x3c, 0xf6, 0x42, 0x25, 0x1e, 0x3c, 0x05, 0x5c, 0xad, 0x63, 0x4d, 0x67, 0x3c, 0x13, 0x87, 0x12,
+    0x23, 0x54, 0xb5, 0xf4, 0x09, 0x5d, 0x21, 0x0b, 0x94, 0x02, 0x54, 0x15, 0xd8, 0x9a, 0x45, 0x1a,
+    0xb2, 0x88, 0x89, 0x14, 0xdc, 0x58, 0xa6, 0x6b, 0xee, 0x0e, 0xc8, 0xda, 0x9b, 0x83, 0xed, 0xe5,
+    0xfc, 0x30, 0x2b, 0x36, 0x3f, 0xce, 0x82, 0xcd, 0xb5, 0x56, 0xc1, 0x68, 0x5d, 0x29, 0x79, 0x22,
+    0x0a, 0xc5, 0xa8, 0x7b, 0x8c, 0x67, 0x11, 0xa7, 0xe0, 0xa5, 0x0c, 0x32, 0x7b, 0x2c, 0xb1, 0xf1,
+    0x54, 0x35, 0x58, 0x60, 0x52, 0xa2, 0x8e, 0xa8, 0x8d, 0xbb, 0x11, 0x79, 0xd4, 0xd2, 0xdd, 0x02,
+    0x60, 0x3e, 0x4b, 0xd9, 0xdf, 0x15, 0x2f, 0x57, 0xf2, 0x53, 0xd0, 0x4d, 0x77, 0xbb, 0xcd, 0xa8,
+    0xb0, 0xfb, 0xdc, 0xb1, 0x3f, 0x03, 0x78, 0x1a, 0x28, 0x5c, 0x16, 0x03, 0xe3, 0x96, 0x9b, 0x80,
+    0x57, 0xb2, 0x51, 0x5d, 0x41, 0x6e, 0xc6, 0x94, 0xb1, 0x15, 0x96, 0x7d, 0x28, 0x4c, 0xd0, 0x9c,
+    0x1d, 0xbb, 0x65, 0xb8, 0x0f, 0xc3, 0xc2, 0xd4, 0x3e, 0xb2, 0x05, 0x24, 0xac, 0x83, 0x31, 0xca,
+    0xfb, 0x33, 0x90, 0x3f, 0xce, 0xb6, 0x0f, 0x2f, 0xac, 0x27, 0x9b, 0xcf, 0x60, 0xf2, 0xcf, 0x0d,
+    0x2b, 0x25, 0xf2, 0xc9, 0x67, 0x2d, 0x86, 0x6c, 0xc6, 0xf2, 0x51, 0x75, 0x18, 0x6c, 0x93, 0x34,
+    0x04, 0xe8, 0xf8, 0xb9, 0x61, 0xbc, 0x82, 0x0a, 0x83, 0xff, 0x3c, 0x67, 0xe1, 0x4a, 0xbd, 0x04,
+    0x0c, 0xc2, 0x43, 0x48, 0x0f, 0x14, 0xf2, 0x1b, 0xf9, 0x14, 0xe6, 0xb9, 0xf1, 0xc8, 0xe9, 0xf9,
+    0x5b, 0x90, 0x63, 0x14, 0x84, 0xc7, 0xd4, 0x99, 0xd8, 0xcc, 0x33, 0x07, 0x65, 0x5e, 0x89, 0x80,
+    0xce, 0x44, 0x3e, 0xa0, 0x4c, 0x66, 0x45, 0x17, 0x50, 0x40, 0xad, 0x44, 0xca, 0xcb, 0x04, 0x31,
+    0x7c, 0x16, 0x70, 0x8c, 0x51, 0xb8, 0x86, 0xc9, 0x88, 0xc3, 0xac, 0x91, 0x21, 0x83, 0x31, 0x19,
+    0xee, 0xce, 0xce, 0x2d, 0xc6, 0x46, 0xb2, 0xa0, 0x5c, 0xe0, 0x0b, 0x1c, 0xf9, 0xca, 0x36, 0x7e,
+    0xce, 0x24, 0x02, 0xa0, 0x23, 0x71, 0x42, 0xec, 0x6e, 0xb6, 0x6e, 0xd9, 0x3b, 0xd9, 0x32, 0x03,
+    0x1b, 0xa2, 0x80, 0x12, 0x49, 0x6d, 0x11, 0xcb, 0xbc, 0x16, 0x3d, 0xfb, 0x90, 0xb6, 0x0c, 0x57,
+    0x6a, 0x12, 0x23, 0xc6, 0x45, 0xc2, 0x43, 0xa0, 0xc6, 0x8b, 0xb0, 0x4d, 0x88, 0xda, 0xd0, 0x71,
+    0x75, 0xd7, 0xae, 0x3c, 0x88, 0x6c, 0x3c, 0x1c, 0xfb, 0x20, 0xe8, 0xd6, 0x83, 0xd0, 0xd1, 0x66,
+    0xf3, 0xae, 0x45, 0x6e, 0x3e, 0x2c, 0x74, 0xe6, 0xb5, 0x58, 0x65, 0x93, 0xef, 0xe9, 0xf3, 0x72,
+    0xd8, 0x2b, 0x4b, 0x0a, 0x21, 0x85, 0x05, 0x84, 0xf2, 0x61, 0x6e, 0x52, 0x12, 0xe9, 0xf0, 0xb0,
+    0xfe, 0xb0, 0x2d, 0xff, 0x76, 0xec, 0x8f, 0x89, 0x91, 0xc0, 0x95, 0x4b, 0x62, 0x5c, 0x0e, 0xa6,
+    0xcf, 0x3e, 0x36, 0x3d, 0x84, 0xd0, 0x6f, 0x43, 0x32, 0x0f, 0x1c, 0xcc, 0xf7, 0x1a, 0x0f, 0xb0,
+    0xeb, 0x77, 0x1d, 0xc9, 0xf0, 0xb8, 0xe2, 0x6c, 0x7c, 0x6e, 0xc0, 0x81, 0x75, 0xa7, 0xd5, 0x85,
+    0xbf, 0x7d, 0xdc, 0xb6, 0x09, 0xaf, 0xd5, 0x74, 0x1e, 0x02, 0x4b, 0x58, 0x8d, 0x1c, 0x7f, 0x47,
+    0x06, 0xf5, 0x66, 0xce, 0x18, 0xcf, 0x81, 0x3a, 0x50, 0xb0, 0x78, 0x48, 0xdb, 0x72, 0xf9, 0x9d,
+    0xbe, 0x1d, 0x96, 0xc4, 0xf1, 0xfd, 0xaa, 0x7a, 0x7f, 0x01, 0x75, 0x0c, 0x3e, 0x80, 0xb1, 0xcc,
+    0x92, 0x12, 0xc6, 0x26, 0xad, 0xfd, 0x4a, 0x4c, 0x6d, 0x9e, 0xeb, 0x59, 0xa7, 0x16, 0x24, 0xae,
+    0x40, 0x50, 0x43, 0x82, 0x6e, 0x1a, 0xa0, 0x22, 0x16, 0x33, 0x62, 0xe1, 0xb9, 0x86, 0xb5, 0x69,
+    0x65, 0xe8, 0x4b, 0x28, 0x2e, 0x24, 0x78, 0x6b, 0x0f, 0xd0, 0x79, 0x0a, 0x9e, 0x5a, 0xbb, 0x4e,
+    0x67, 0x33, 0x39, 0xb5, 0xdc, 0x73, 0x6d, 0xc9, 0xad, 0xf3, 0x64, 0x30, 0x8c, 0xbe, 0xe9, 0x30,
+    0x8c, 0x83, 0xbf, 0x50, 0xd9, 0xd2, 0x34, 0xf8, 0xa3, 0x10, 0xf9, 0xc2, 0x52, 0x1e, 0xb1, 0x60,
+    0x79, 0xc7, 0x85, 0x65, 0x76, 0x72, 0x37, 0x69, 0x05, 0x29, 0xb9, 0xd9, 0x23, 0x7f, 0xec, 0x83,
+    0x9d, 0x47, 0x30, 0x5c, 0xa1, 0x77, 0x93, 0xb5, 0x75, 0x7f, 0xfc, 0xce, 0x65, 0x3d, 0x81, 0xfa,
+    0xd5, 0x46, 0xfa, 0xb4, 0xc5, 0xda, 0xdd, 0x40, 0x85, 0xfd, 0xc6, 0x2f, 0x65, 0x1c, 0xc7, 0x29,
+    0x23, 0x4d, 0x7f, 0x48, 0x32, 0x90, 0xbf, 0x93, 0x01, 0x9e, 0x67, 0x8c, 0x31, 0x93, 0x32, 0xb5,
+    0x69, 0xc6, 0xf6, 0xd0, 0xb1, 0x26, 0x7f, 0x2e, 0xbb, 0x76, 0x52, 0x9b, 0x91, 0xf1, 0xb3, 0x27,
+    0xc3, 0xd1, 0xd1, 0xbf, 0x49, 0x8f, 0xec, 0xb4, 0xe1, 0xef, 0xe7, 0x9f, 0x57, 0x0a, 0x57, 0x6c,
+    0x6a, 0xfa, 0x14, 0x04, 0xe9, 0xf7, 0xc1, 0x2b, 0xc8, 0x5f, 0x49, 0xab, 0x5b, 0xa4, 0x8a, 0xa7,
+    0xf4, 0x81, 0x65, 0x27, 0xa7, 0x26, 0x77, 0xad, 0xa6, 0x99, 0xb3, 0x77, 0x6b, 0xba, 0x7d, 0xad,
+    0xb9, 0x50, 0xba, 0x2f, 0xc1, 0x68, 0xea, 0xc7, 0x42, 0x16, 0x14, 0xc9, 0x59, 0x03, 0xea, 0x0b,
+    0xb9, 0x7b, 0xf3, 0xf7, 0x35, 0xf1, 0xd3, 0xab, 0x5e, 0x43, 0xfd, 0xb0, 0xa6, 0xd7, 0x50, 0xbf,
+    0x37, 0xfb, 0x3f, 0x3f, 0xcc, 0x4c, 0xe7, 0x87, 0x36, 0x00, 0x00,
+};
+
+// settings.html, 2614 bytes, 824 gzipped
+static const uint8_t WebAsset_settings_html[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xdd, 0x56, 0x51, 0x6f, 0xd3, 0x30,
+    0x10, 0x7e, 0xdf, 0xaf, 0x38, 0xfc, 0xd4, 0x4a, 0x4b, 0x23, 0xd8, 0xdb, 0x48, 0x22, 0xb1, 0x31,
+    0xd0, 0x1e, 0xd0, 0x2a, 0x75, 0x3c, 0x20, 0x84, 0x90, 0x1b, 0x5f, 0x1b, 0x43, 0x62, 0x47, 0xb6,
+    0xd3, 0x52, 0x21, 0xfe, 0x3b, 0x67, 0x27, 0x69, 0xbd, 0x22, 0x06, 0x45, 0x3c, 0x20, 0xa4, 0x4a,
+    0xb5, 0x7d, 0x77, 0xdf, 0xe7, 0xfb, 0x7c, 0x67, 0x27, 0x7b, 0xf2, 0xf2, 0xee, 0xfa, 0xfe, 0xdd,
+    0xfc, 0x06, 0x2a, 0xd7, 0xd4, 0xc5, 0x59, 0x36, 0xfe, 0x21, 0x17, 0xc5, 0x19, 0x40, 0xe6, 0xa4,
+    0xab, 0xb1, 0x58, 0xa0, 0x73, 0x52, 0xad, 0x6d, 0x96, 0xf6, 0x73, 0x6f, 0x69, 0xd0, 0x71, 0x50,
+    0xbc, 0xc1, 0x9c, 0x6d, 0x24, 0x6e, 0x5b, 0x6d, 0x1c, 0x83, 0x52, 0x2b, 0x87, 0xca, 0xe5, 0x6c,
+    0x2b, 0x85, 0xab, 0x72, 0x81, 0x1b, 0x59, 0x62, 0x12, 0x26, 0xe7, 0x20, 0x95, 0x74, 0x92, 0xd7,
+    0x89, 0x2d, 0x79, 0x8d, 0xf9, 0x53, 0x16, 0x60, 0x6a, 0xa9, 0x3e, 0x83, 0xc1, 0x3a, 0x67, 0x92,
+    0x82, 0x19, 0x54, 0x06, 0x57, 0x39, 0x13, 0xdc, 0xf1, 0xcb, 0xf3, 0x63, 0x0f, 0xeb, 0x76, 0x35,
+    0xda, 0x0a, 0x91, 0x98, 0xdc, 0xae, 0x25, 0x66, 0x87, 0x5f, 0x5c, 0x5a, 0x5a, 0x3b, 0xc6, 0x05,
+    0x8f, 0x99, 0x5f, 0xa0, 0x24, 0xd2, 0x3e, 0x8b, 0x6c, 0xa9, 0xc5, 0x2e, 0x20, 0x09, 0xb9, 0x81,
+    0xb2, 0xe6, 0xd6, 0x52, 0xa0, 0x6e, 0x15, 0xdf, 0x04, 0x02, 0x32, 0x54, 0x4f, 0xa3, 0x14, 0x69,
+    0xe2, 0x9d, 0x53, 0xf2, 0x3e, 0x8e, 0x1a, 0xd2, 0x1b, 0xc3, 0x62, 0x0b, 0x37, 0x22, 0x59, 0x1b,
+    0x29, 0x06, 0xdb, 0x8f, 0xd6, 0xbd, 0x81, 0x4c, 0x2b, 0x6d, 0x1a, 0xe0, 0xa5, 0x93, 0x5a, 0xe5,
+    0x2c, 0xb5, 0xdd, 0xb2, 0x91, 0x94, 0x12, 0x29, 0x5a, 0x69, 0x91, 0xb3, 0xf9, 0xdd, 0xe2, 0x3e,
+    0xf2, 0x26, 0xff, 0x36, 0x9e, 0x79, 0x49, 0xf8, 0x12, 0x6b, 0x20, 0x14, 0xca, 0xd8, 0x7a, 0xce,
+    0xc5, 0xe2, 0xf6, 0x65, 0x96, 0x86, 0xe5, 0x23, 0x57, 0xa9, 0xda, 0xce, 0x45, 0x6a, 0x31, 0x90,
+    0x62, 0x88, 0x1a, 0x4e, 0xaf, 0x47, 0xc8, 0x96, 0xe6, 0xe7, 0x24, 0x2d, 0x65, 0xb1, 0xd5, 0x3e,
+    0x87, 0xf9, 0x30, 0x3a, 0x85, 0x6c, 0x1f, 0x3d, 0x10, 0x1e, 0xd0, 0x1e, 0x25, 0x5d, 0x1a, 0xfd,
+    0x19, 0x0d, 0x2b, 0xae, 0xc2, 0x3f, 0xdc, 0xce, 0xe1, 0x85, 0x10, 0x06, 0xad, 0x3d, 0x85, 0x7b,
+    0x00, 0x19, 0x98, 0x47, 0xc8, 0x47, 0x79, 0xd1, 0xb6, 0xb7, 0x2d, 0x2b, 0x6e, 0x16, 0xf3, 0x3f,
+    0xe4, 0xec, 0x01, 0x06, 0xca, 0x01, 0xed, 0x51, 0xc6, 0x35, 0x77, 0xb8, 0xe5, 0x3b, 0xef, 0xf7,
+    0xba, 0x1f, 0xfe, 0x21, 0xf3, 0x01, 0x68, 0x60, 0x8f, 0x90, 0x7f, 0xdc, 0x41, 0x8c, 0x31, 0xd6,
+    0xe0, 0x86, 0xd7, 0x1d, 0x4d, 0x17, 0xfd, 0xf4, 0x41, 0x11, 0xa6, 0x51, 0x15, 0x66, 0xa9, 0x2f,
+    0xe1, 0x68, 0x5e, 0x45, 0xe0, 0xd9, 0x93, 0x24, 0x81, 0xbb, 0xfb, 0x17, 0xf0, 0xb6, 0xa5, 0x3e,
+    0x46, 0x58, 0x60, 0xa8, 0x74, 0x9f, 0x2b, 0x78, 0x55, 0x5f, 0x49, 0xd3, 0x6c, 0xb9, 0x41, 0x48,
+    0x92, 0x18, 0xe1, 0x62, 0xec, 0x16, 0xdf, 0xb6, 0x68, 0x3e, 0x36, 0x28, 0x64, 0xd7, 0xb0, 0xe2,
+    0xba, 0x33, 0x86, 0x9a, 0xce, 0x87, 0x5e, 0x3c, 0x3b, 0x04, 0x6f, 0xd0, 0x58, 0x42, 0xbd, 0x84,
+    0xcc, 0xb6, 0x5c, 0x85, 0xf4, 0x57, 0x83, 0x8d, 0x15, 0x49, 0x92, 0xa5, 0x7e, 0xb9, 0xa0, 0x76,
+    0xbe, 0x38, 0x6e, 0xbc, 0x07, 0x7d, 0x76, 0x68, 0xc3, 0x2e, 0xec, 0xf6, 0xc6, 0x92, 0x78, 0xa8,
+    0xca, 0x5e, 0x96, 0xa6, 0xab, 0x9d, 0x6c, 0xb9, 0x71, 0x21, 0xdf, 0xc4, 0x5f, 0x4b, 0x0f, 0x45,
+    0x89, 0x35, 0x5c, 0xc9, 0x1a, 0x47, 0xe1, 0x7b, 0xb0, 0x5e, 0xf5, 0x23, 0xe5, 0x1f, 0xd3, 0xfd,
+    0x15, 0x29, 0x50, 0xb1, 0xbf, 0xa0, 0xf3, 0xb5, 0x56, 0x2b, 0xb9, 0xee, 0x0c, 0x0f, 0x2b, 0xbf,
+    0x29, 0x74, 0x1c, 0x73, 0x82, 0x70, 0x65, 0x88, 0xfb, 0x1f, 0x54, 0x9b, 0xbf, 0xb9, 0x3a, 0xb5,
+    0x3a, 0xe3, 0x90, 0x93, 0x8b, 0x6d, 0xde, 0x2c, 0xff, 0x59, 0xd9, 0xf6, 0x0f, 0x60, 0xfc, 0x16,
+    0xee, 0x07, 0xb6, 0x34, 0xb2, 0x75, 0xbd, 0x39, 0x4d, 0xa1, 0xe5, 0x6b, 0x04, 0x69, 0xa1, 0xe4,
+    0x65, 0x85, 0xe2, 0x1c, 0xca, 0xa1, 0x67, 0x03, 0x13, 0x2d, 0xeb, 0x06, 0x61, 0x65, 0x74, 0x03,
+    0x7d, 0xad, 0xcc, 0x3e, 0x59, 0x52, 0x9c, 0x7e, 0xd4, 0xd3, 0x01, 0x62, 0x85, 0xae, 0xac, 0x26,
+    0xf4, 0x14, 0x0e, 0xaf, 0x70, 0x70, 0x60, 0xd3, 0x61, 0x2b, 0x33, 0x57, 0xa1, 0x9a, 0x4c, 0xe8,
+    0x36, 0x6c, 0xb5, 0xb2, 0x38, 0x85, 0xbc, 0x80, 0x71, 0x12, 0x3c, 0x27, 0xd3, 0x23, 0xd7, 0x11,
+    0x27, 0xb8, 0x7e, 0xdd, 0x67, 0xe8, 0xcf, 0x78, 0x42, 0x5b, 0xb0, 0x8e, 0xee, 0x0b, 0xd0, 0x2b,
+    0x78, 0xdf, 0xbf, 0x7e, 0xe7, 0x70, 0x78, 0x94, 0x68, 0x3c, 0x3c, 0x13, 0x34, 0xea, 0x6f, 0x6f,
+    0x1a, 0x1c, 0x2e, 0xd2, 0x0f, 0xd3, 0x08, 0x10, 0x40, 0xe8, 0xb2, 0x6b, 0x28, 0xd5, 0xd9, 0x1a,
+    0xdd, 0x4d, 0x8d, 0x7e, 0x78, 0xb5, 0xbb, 0x15, 0x13, 0x29, 0xa6, 0xb3, 0x90, 0x3d, 0xe4, 0x30,
+    0xee, 0xe6, 0xbd, 0x14, 0x1f, 0x9e, 0xef, 0x63, 0xbf, 0x9d, 0xfd, 0x0a, 0xe3, 0x70, 0xa1, 0x4d,
+    0x67, 0x52, 0x29, 0x34, 0xf7, 0x74, 0xd3, 0x47, 0x78, 0xb3, 0xd1, 0x3e, 0x82, 0x7e, 0xdb, 0xcb,
+    0x50, 0x72, 0x2f, 0xe8, 0x04, 0x8d, 0xd1, 0x26, 0x88, 0xe0, 0xb3, 0xd6, 0xf4, 0x6d, 0x14, 0x56,
+    0x26, 0xec, 0x9a, 0x2b, 0xa5, 0x1d, 0xd4, 0x9a, 0x8b, 0x3d, 0xdc, 0x25, 0x25, 0xda, 0x07, 0x4c,
+    0x9f, 0x87, 0xc3, 0x1e, 0x0f, 0x39, 0x4b, 0xfb, 0x4f, 0x28, 0xaa, 0xef, 0xf0, 0x79, 0xf8, 0x1d,
+    0x9c, 0xab, 0x65, 0xbc, 0x36, 0x0a, 0x00, 0x00,
+};
+
+// style.css, 1652 bytes, 616 gzipped
+static const uint8_t WebAsset_style_css[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x9d, 0x53, 0x6d, 0x6f, 0x9b, 0x30,
+    0x10, 0xfe, 0x9e, 0x5f, 0x61, 0x29, 0xaa, 0x94, 0x4a, 0x31, 0x02, 0x12, 0xb2, 0x88, 0x68, 0x1f,
+    0xba, 0x69, 0xd5, 0xfe, 0xc3, 0xd4, 0x0f, 0x06, 0x1f, 0x70, 0xaa, 0xb1, 0x91, 0x31, 0x79, 0xe9,
+    0xd4, 0xff, 0x3e, 0xdb, 0x90, 0x95, 0x34, 0xa5, 0xca, 0x26, 0x64, 0x10, 0x77, 0xcf, 0xdd, 0x3d,
+    0x77, 0xf7, 0xb8, 0x32, 0xb5, 0x20, 0xbf, 0x67, 0x84, 0x14, 0x4a, 0x1a, 0x5a, 0xb0, 0x1a, 0xc5,
+    0x29, 0x25, 0x0f, 0x1a, 0x99, 0x58, 0x92, 0x9f, 0x20, 0xf6, 0x60, 0x30, 0x67, 0x4b, 0xd2, 0x32,
+    0xd9, 0xd2, 0x16, 0x34, 0x16, 0x3b, 0x0b, 0xe6, 0xd8, 0x36, 0x82, 0x59, 0x20, 0x4a, 0x81, 0x12,
+    0x68, 0x26, 0x54, 0xfe, 0xec, 0x1c, 0x06, 0x8e, 0x86, 0x32, 0x81, 0xa5, 0x4c, 0x49, 0x0e, 0xd2,
+    0x80, 0xde, 0xcd, 0x5e, 0x67, 0xb3, 0x2a, 0x7a, 0xab, 0xd1, 0xe2, 0x0b, 0xa4, 0x24, 0x0a, 0xb6,
+    0x1a, 0x6a, 0x17, 0x92, 0x2b, 0xa1, 0x74, 0x4a, 0x0e, 0x15, 0x1a, 0xf0, 0xe0, 0xe6, 0x1a, 0xbb,
+    0xf6, 0x58, 0xeb, 0x0b, 0x8c, 0x6a, 0x24, 0xdb, 0x7b, 0x84, 0xda, 0x83, 0x2e, 0x84, 0x3a, 0xa4,
+    0xa4, 0x42, 0xce, 0x41, 0xba, 0x64, 0x19, 0xcb, 0x9f, 0x4b, 0xad, 0x3a, 0xc9, 0xe9, 0x90, 0x77,
+    0x1e, 0x15, 0xab, 0xcd, 0x86, 0xf9, 0xe8, 0x4c, 0xf1, 0x93, 0x0f, 0xad, 0x99, 0x2e, 0xd1, 0x52,
+    0x0c, 0xfb, 0xa4, 0xb9, 0xad, 0x65, 0xc9, 0x7a, 0x57, 0xc3, 0x38, 0x47, 0x59, 0xa6, 0x24, 0xb9,
+    0x1b, 0x9c, 0x4c, 0x73, 0x5a, 0x6a, 0xe4, 0x43, 0xe4, 0x91, 0x1e, 0x90, 0x9b, 0x2a, 0x25, 0xdb,
+    0x30, 0x6c, 0x8e, 0xbb, 0x71, 0x36, 0xc2, 0x3a, 0xa3, 0x2e, 0xe6, 0xe3, 0xe2, 0x9c, 0xc1, 0x7d,
+    0x69, 0xc9, 0x9a, 0x94, 0xc4, 0x43, 0xdb, 0xde, 0x62, 0xa0, 0xb6, 0x38, 0x03, 0x8e, 0x6c, 0x57,
+    0xcb, 0x36, 0x25, 0x1a, 0x1a, 0x60, 0x66, 0xe1, 0x12, 0xd1, 0x02, 0xcd, 0x92, 0xd4, 0x28, 0x6d,
+    0xcd, 0xc5, 0xca, 0x15, 0x5b, 0x92, 0xa8, 0xd0, 0xf7, 0xf7, 0x6f, 0xbc, 0x3c, 0xa5, 0xeb, 0x9e,
+    0x87, 0x59, 0x5a, 0x97, 0x3a, 0xd2, 0xb6, 0x62, 0xdc, 0x0d, 0x29, 0x6e, 0x8e, 0xfe, 0x44, 0xfe,
+    0x65, 0x8f, 0x2e, 0x33, 0xb6, 0x88, 0xd6, 0xe1, 0xf2, 0x7c, 0x82, 0x64, 0x94, 0x9a, 0x1a, 0x34,
+    0x02, 0xae, 0x57, 0x71, 0xe6, 0xef, 0x8d, 0x07, 0xc0, 0xb2, 0x32, 0xa9, 0xad, 0x23, 0xf8, 0x68,
+    0x97, 0xf3, 0x70, 0xb5, 0x0e, 0xbf, 0x6c, 0x5d, 0x2e, 0x94, 0x4d, 0x67, 0x7e, 0x99, 0x53, 0x03,
+    0x5f, 0xdb, 0x2e, 0xab, 0xd1, 0x3c, 0xf5, 0x9c, 0x95, 0xe6, 0x60, 0x91, 0x52, 0x49, 0x18, 0x07,
+    0x3e, 0xfe, 0x78, 0xfc, 0xfe, 0xf8, 0x6d, 0x62, 0x93, 0x7d, 0xd6, 0xdd, 0x78, 0x49, 0x51, 0xe2,
+    0x9a, 0x49, 0xfa, 0x3d, 0x7c, 0x24, 0xbe, 0xc1, 0xca, 0x21, 0x57, 0x9a, 0x19, 0x54, 0xf2, 0xad,
+    0xe6, 0xa4, 0x88, 0xc7, 0xfd, 0x6e, 0xfa, 0xd4, 0xc3, 0xca, 0xa3, 0xcb, 0x95, 0x53, 0xdd, 0xb7,
+    0x1f, 0x0d, 0xd6, 0xbe, 0x2b, 0xaa, 0x19, 0xc7, 0xce, 0xee, 0x72, 0x3d, 0xd0, 0xd2, 0xf6, 0xee,
+    0xa0, 0xab, 0x4d, 0x79, 0x77, 0x26, 0x11, 0x06, 0xeb, 0x76, 0xf7, 0xf1, 0x80, 0xd2, 0xca, 0x29,
+    0x7b, 0x62, 0xb5, 0xf3, 0x28, 0xde, 0xc6, 0x0f, 0xf1, 0xfb, 0x50, 0xd7, 0xe4, 0xd3, 0x92, 0x8c,
+    0x2c, 0xb2, 0xab, 0x33, 0xd0, 0xd6, 0xd6, 0x82, 0x80, 0xbc, 0xd7, 0xf6, 0xd0, 0x45, 0x12, 0xde,
+    0x5d, 0x0e, 0xd1, 0x4b, 0xe3, 0x9d, 0x98, 0xa3, 0x6d, 0xff, 0x3f, 0x39, 0xa5, 0xf3, 0x0a, 0x9d,
+    0x94, 0x5a, 0x25, 0xec, 0xfd, 0x98, 0xe7, 0x79, 0x3e, 0x3d, 0x06, 0xaf, 0x45, 0x7c, 0xf1, 0x15,
+    0x07, 0x84, 0x35, 0xf9, 0x46, 0x04, 0xcb, 0x40, 0x4c, 0x49, 0xed, 0x75, 0x16, 0xec, 0x99, 0xe8,
+    0x60, 0x52, 0x89, 0xd7, 0x93, 0x09, 0x5a, 0x63, 0x2f, 0x15, 0xf9, 0x87, 0x88, 0xac, 0x33, 0x46,
+    0xc9, 0x1b, 0xa5, 0x79, 0xa9, 0xbe, 0x55, 0xfc, 0x99, 0xfa, 0x6e, 0xd0, 0xd2, 0x7f, 0xa8, 0x26,
+    0xe8, 0xf9, 0xd2, 0x33, 0xe5, 0xe9, 0xbb, 0x32, 0xc6, 0xde, 0x2a, 0xac, 0xbf, 0x11, 0x45, 0x31,
+    0x05, 0xde, 0x26, 0xee, 0x79, 0x07, 0xfe, 0x3c, 0x7f, 0x9c, 0xd8, 0x67, 0xed, 0x42, 0xfe, 0x00,
+    0x97, 0x06, 0x73, 0x1e, 0x74, 0x06, 0x00, 0x00,
+};
+
+static const WebAsset WebAssets[] = {
+    {"/", "text/html", WebAsset_index_html, sizeof(WebAsset_index_html), "\"85cf9f3b5e36ab5b\""},
+    {"/settings", "text/html", WebAsset_settings_html, sizeof(WebAsset_settings_html), "\"3dd0e451adb2c787\""},
+    {"/style.css", "text/css", WebAsset_style_css, sizeof(WebAsset_style_css), "\"107e3d0eebc1846c\""},
+};
+#define WEB_ASSETS_NUM_OF (sizeof(WebAssets) / sizeof(WebAssets[0]))
+
+#endif // WEB_ASSETS_H
@@ -0,0 +1,55 @@
+/*
+ * CollisionDetector.h
+ *
+ * Collision and stall detection for the route manager. Impacts are found in
+ * every accelerometer sample from the FIFO (416 Hz, LPF2 of the sensor off)
+ * after a 19 Hz low pass of the detector itself, the AHRS filters its copy
+ * to 2 Hz on its own: a jump of the horizontal acceleration between two
+ * samples (jerk) that also leaves the slow baseline of the horizontal
+ * acceleration (tilt, gravity) far enough.
+ * Wheel stall and auger overload come from every Pmb2ImuFrame_t: wheels
+ * commanded, rail current high and encoders not moving for a while, auger
+ * current high for a while.
+ *
+ * The first event is latched until CollisionDetector_Clear. No hardware
+ * access, Tools/CollisionDetect builds this file on the host and replays
+ * recorded or simulated traces against it to tune CollisionParams.
+ */
+
+#ifndef INC_COLLISIONDETECTOR_H_
+#define INC_COLLISIONDETECTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MessageTypes.h"
+
+#define dCOLLISION_INPUT_SHIFT		2		/* input low pass 1/4 per sample, 19 Hz */
+#define dCOLLISION_BASE_SHIFT		6		/* baseline follows horizontal acceleration with 1/64 per sample, 150 ms */
+#define dCOLLISION_ENCODER_RANGE	10000	/* Pmb2ImuFrame_t rotation counts wrap here, see updatePosition */
+
+typedef struct CollisionParams_t{
+	uint16_t ImpactJerk;		/* [LSB] |dX| + |dY| between two samples, 2 g range: 16384 LSB/g */
+	uint16_t ImpactAccel;		/* [LSB] |X| + |Y| off the baseline at the same sample */
+	uint16_t StallMinSpeed;		/* wheel speed command checked for stall */
+	uint16_t StallCurrent;		/* [ADC counts] Pmb2ImuFrame_t.adcCurrent, power stage on: A = counts * 100 / 1484 - 131, 0: not checked */
+	uint16_t StallTravel;		/* [counts] encoder travel of both wheels below which they stall */
+	uint16_t StallTime;			/* [ms] */
+	uint16_t AugerCurrent;		/* |Pmb2ImuFrame_t.thumbleCurrent|, inverter units as PMB overcurrent check */
+	uint16_t AugerTime;			/* [ms] */
+}CollisionParams;
+
+extern const CollisionParams CollisionDetector_Defaults;
+
+void CollisionDetector_Init(const CollisionParams* Params);
+/* Raw accelerometer sample in FIFO order */
+void CollisionDetector_AccSample(int16_t X, int16_t Y, int16_t Z, uint32_t Now);
+/* Every valid Pmb2ImuFrame_t with the wheel speeds sent in the last Imu2PmbFrame_t */
+void CollisionDetector_PmbFrame(const Pmb2ImuFrame_t* Frame, int16_t LeftSpeed, int16_t RightSpeed, uint32_t Now);
+/* dCOLLISION_..., latched */
+uint8_t CollisionDetector_GetEvent(void);
+/* [ms] Now of the call that raised the event */
+uint32_t CollisionDetector_GetEventTime(void);
+/* Back to watching, baseline and stall timers restart */
+void CollisionDetector_Clear(void);
+
+#endif /* INC_COLLISIONDETECTOR_H_ */
@@ -8,7 +8,9 @@
 #ifndef INC_CONNECTIVITYHANDLER_H_
 #define INC_CONNECTIVITYHANDLER_H_
 
+#include <stdbool.h>
 #include "RoutesDataTypes.h"
+#include "MessageTypes.h"
 
 void connectivityHandlerPerform();
 void connectivityHandlerInit();
@@ -18,6 +20,19 @@ int8_t getJoystickY(void);
 int16_t getThumbleSetting(void);
 Route_ID getSelectedRoute(void);
 uint8_t getRouteAction(void);
+uint16_t getCommandSequence(void);
+/* [us] TimeManager_GetMicros when current command was applied */
+uint16_t getCommandRxTime(void);
+/* Emergency stop from ESP, latched until released by a newer control frame */
+bool connectivityHandlerIsStopped(void);
+/* [us] shared time the latched stop was requested on ESP */
+uint32_t connectivityHandlerGetStopTime(void);
+/* True once per ESP protocol hello, caller answers with ProtocolHello_t */
+bool connectivityHandlerTakeHelloRequest(void);
+/* Baud rate negotiation field of status frame to ESP */
+void connectivityHandlerStampLink(LinkControl_t* Control);
+/* Current ESP link baud rate */
+uint32_t connectivityHandlerGetEspBaud(void);
 
 
 
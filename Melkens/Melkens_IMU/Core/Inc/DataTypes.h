@@ -12,7 +12,7 @@
 
 #define UART1_RX_MESSAGE_LEN 		sizeof(Esp2ImuFrame_t) /* E;RRRRR;LLLLL;33 -> Encoder;RightWheel int16, LeftWheel int16, Dummy CRC */
 #define UART2_RX_MESSAGE_LEN 		sizeof(Pmb2ImuFrame_t) /* GET_ENCO -> Getter message, always constant length of 8 bytes */
-#define UART3_RX_MESSAGE_LEN 		15 		/* W;RRR;LLL;33\n -> WheelSpeed; RightWheel int8, LeftWheel int8, Dummy CRC */
+#define UART3_RX_MESSAGE_LEN 		20 		/* Scope command from PC, dSCOPE_COMMAND_SIZE */
 #define UART5_RX_MESSAGE_LEN 		12
 
 #define UART1_TX_MESSAGE_LEN 		sizeof(Imu2EspFrame_t) /* E;RRRRR;LLLLL;33 -> Encoder;RightWheel int16, LeftWheel int16, Dummy CRC */
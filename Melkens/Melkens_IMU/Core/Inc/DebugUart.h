@@ -0,0 +1,34 @@
+/*
+ * DebugUart.h
+ *
+ * USART3 debug output. BINLOG records (Melkens_Lib/BinLog) are packed into
+ * frames and sent by DMA when the UART is free, from the main loop between
+ * ticks. Tools/BinLog/binlog.py decodes the stream with the format strings of
+ * the ELF.
+ *
+ * Scope frames (Melkens_Lib/Scope) go out before log frames: variables
+ * registered with Scope_Register, selected by Tools/Scope/scope.py with a
+ * command received on USART3, sampled by the 1ms task up to every tick. The
+ * scope keeps dDEBUG_UART_SCOPE_BUDGET of the line, the rest is for log.
+ */
+
+#ifndef INC_DEBUGUART_H_
+#define INC_DEBUGUART_H_
+
+#include <stdint.h>
+#include "BinLog.h"
+#include "Scope.h"
+
+#define dDEBUG_UART_BYTES_PER_SECOND	46080u	/* 460800 baud, 10 bits per byte */
+#define dDEBUG_UART_SCOPE_BUDGET		(dDEBUG_UART_BYTES_PER_SECOND * 8u / 10u)
+
+/* After the DWT cycle counter is enabled, measures the cost of a record */
+void DebugUart_Init(void);
+/* Main loop, every pass: scope commands, then scope and log frames out */
+void DebugUart_Perform(void);
+/* 1ms task, after the tasks whose variables are sampled */
+void DebugUart_Sample1ms(void);
+/* [cycles] BINLOG call with two arguments, measured by DebugUart_Init */
+uint32_t DebugUart_GetRecordCycles(void);
+
+#endif /* INC_DEBUGUART_H_ */
@@ -0,0 +1,30 @@
+/*
+ * FlashPage.h
+ *
+ * Page erase and programming of the data pages at the top of IMU flash
+ * (MAGCAL and ROUTES in STM32G473RCTX_FLASH.ld). The linker script uses
+ * flash as one continuous 256 KB region, that is single bank mode
+ * (DBANK = 0, 4 KB pages). With DBANK set the second bank starts at
+ * 0x08040000 and the data pages are not there, nothing is read or written.
+ *
+ * Erase and programming stall the CPU, code runs from the same bank.
+ * A page erase takes about 20 ms.
+ */
+
+#ifndef INC_FLASHPAGE_H_
+#define INC_FLASHPAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define dFLASH_PAGE_SIZE		0x1000UL	/* FLASH_PAGE_SIZE_128_BITS, single bank */
+
+/* Option bytes select single bank mode, data pages can be used */
+bool FlashPage_IsSingleBank(void);
+/* Erases the page holding Address */
+bool FlashPage_Erase(uint32_t Address);
+/* Address has to be 8 byte aligned, last double word is padded with 0xFF.
+ * True when flash reads back as Data. */
+bool FlashPage_Program(uint32_t Address, const uint8_t* Data, uint32_t Length);
+
+#endif /* INC_FLASHPAGE_H_ */
@@ -57,7 +57,18 @@ void IMU_ResetDataReady(void);
 void IMU_InitLoopTick(void);
 
 void IMU_SendDataToPMB(void);
-void IMU_SendDataToPC(void);
+/* PMB link baud rate negotiation, IMU is master */
+void IMU_InitPmbLink(void);
+/* Route driven or wheel speeds sent to PMB: flash is not erased, the ~20 ms
+ * stall of a page erase would hit the control loop */
+bool IMU_IsFlashLocked(void);
+/* Sends Imu2PmbFrame from IMU_SendRequestedDataToPMB 1ms task, rate limited */
+void IMU_RequestSendToPMB(void);
+void IMU_SendRequestedDataToPMB(void);
+/* Sends Imu2PmbFrame from IMU_Perform once UART is free, no rate limit */
+void IMU_RequestStopToPMB(void);
+/* Scope channels of sensors, AHRS and wheel speeds, see DebugUart.h */
+void IMU_RegisterScopeChannels(void);
 
 void IMU_AHRS_Calculation(void);
 void IMU_RouteCalculation(void);
@@ -0,0 +1,23 @@
+/*
+ * Loader.h
+ *
+ * Boot confirmation for the firmware loader, see Melkens_Lib/FwUpdate.
+ * The boot word lives in TAMP backup register 0, it is kept over resets.
+ * The loader counts starts of the application, the application confirms
+ * once the ESP link is up.
+ *
+ * The loader itself is not in this tree. Until it is, the application has
+ * no way to reset into it and dESP2IMU_FRAME_FW_UPDATE is ignored.
+ */
+
+#ifndef INC_LOADER_H_
+#define INC_LOADER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void Loader_Init(void);
+/* Clears the start count of the loader, once per start */
+void Loader_ConfirmBoot(void);
+
+#endif /* INC_LOADER_H_ */
@@ -0,0 +1,85 @@
+/*
+ * MagCalibration.h
+ *
+ * Online hard and soft iron calibration of the LIS3MDL and detection of
+ * local field disturbances for Magnetometer.c.
+ *
+ * The robot only turns about the vertical axis, so the field is only
+ * observed in the horizontal plane: the two horizontal axes (picked from
+ * gravity, MagCalibration_SetVerticalAxis) trace an ellipse while the robot
+ * turns. Samples are collected into the normal equations of the conic
+ *   a u^2 + b u v + c v^2 + d u + e v = 1
+ * and solved once enough of the heading circle is covered
+ * (MinSectors of dMAG_CALIBRATION_SECTORS, MinSamples). The fit gives the
+ * hard iron Center and the soft iron Matrix mapping the ellipse onto a
+ * circle of Radius; it is taken only when it is plausible (positive
+ * definite, MaxAxisRatio, MaxResidual), blended into the calibration by
+ * FitWeight and then collected again, so the calibration follows the robot
+ * as it is loaded or its payload changes.
+ *
+ * Near steel (stalls, gates, feeding tables) the field is bent. A sample is
+ * disturbed when its calibrated magnitude is off Radius by more than
+ * DisturbanceRatio or when the magnetic heading leaves a heading turned by
+ * the gyro and slowly pulled to the magnetic one by more than HeadingLimit.
+ * Fusion is then off until no disturbance was seen for ClearTime, disturbed
+ * samples are not fitted. Disturbed for InvalidTime without a break means
+ * the calibration is wrong (stored one from another payload), it is dropped
+ * and fitted again from scratch.
+ *
+ * No hardware access, Tools/MagCalibration runs it on the host.
+ */
+
+#ifndef INC_MAGCALIBRATION_H_
+#define INC_MAGCALIBRATION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define dMAG_CALIBRATION_SECTORS		8
+#define dMAG_CALIBRATION_SECTOR_MIN		8	/* samples in a sector to count it covered */
+#define dMAG_CALIBRATION_NO_AXIS		0xFF
+
+typedef struct MagCalibrationParams_t{
+	uint16_t MinSamples;		/* samples of one fit */
+	uint8_t MinSectors;			/* heading sectors covered */
+	float MaxAxisRatio;			/* ellipse axes, larger over smaller */
+	float MaxResidual;			/* RMS radius error of the fitted samples, share of Radius */
+	float MinRadius;			/* [mG] horizontal field accepted */
+	float MaxRadius;			/* [mG] */
+	float DisturbanceRatio;		/* share of Radius */
+	float HeadingLimit;			/* [rad] magnetic heading off the gyro tracked one */
+	uint16_t ClearTime;			/* [ms] */
+	uint32_t InvalidTime;		/* [ms] disturbed without a break, calibration is dropped */
+	float FitWeight;			/* share of a new fit blended into the calibration */
+}MagCalibrationParams;
+
+/* Stored in flash by Magnetometer.c, field order kept */
+typedef struct MagCalibrationData_t{
+	uint8_t VerticalAxis;		/* 0 X, 1 Y, 2 Z of the sensor */
+	uint8_t Reserved[3];
+	float Center[2];			/* [mG] hard iron of the horizontal axes */
+	float Matrix[2][2];			/* soft iron, symmetric */
+	float Radius;				/* [mG] calibrated horizontal field */
+}MagCalibrationData;
+
+extern const MagCalibrationParams MagCalibration_Defaults;
+
+/* Stored: last calibration or NULL */
+void MagCalibration_Init(const MagCalibrationParams* Params, const MagCalibrationData* Stored);
+/* From gravity, a change drops the calibration and the samples collected */
+void MagCalibration_SetVerticalAxis(uint8_t Axis);
+/* Field [mG] of the sensor axes, Gyro [rad/s] in the same axes, Tick [ms] */
+void MagCalibration_AddSample(const float Field[3], const float Gyro[3], uint32_t Tick);
+/* Calibrated horizontal field [mG] with the vertical axis 0,
+ * false without calibration or while disturbed */
+bool MagCalibration_GetField(float Field[3]);
+bool MagCalibration_IsValid(void);
+bool MagCalibration_IsDisturbed(void);
+/* Calibration fitted since the last call, to be stored */
+bool MagCalibration_TakeNew(MagCalibrationData* Data);
+/* Fits taken, changes the heading reference */
+uint8_t MagCalibration_GetFitCount(void);
+/* Heading sectors covered by the samples of the current fit */
+uint8_t MagCalibration_GetCoverage(void);
+
+#endif /* INC_MAGCALIBRATION_H_ */
@@ -0,0 +1,43 @@
+/*
+ * Magnetometer.h
+ *
+ * LIS3MDL on its own bus (I2C4), read without blocking: every
+ * dMAGNETOMETER_PERIOD Magnetometer_Perform starts an interrupt driven read
+ * of STATUS_REG and the six output registers and hands the previous result
+ * to MagCalibration. The blocking LSM6DSR FIFO reads on I2C2 are not held
+ * up by it. A transfer not finished within dMAGNETOMETER_TIMEOUT is aborted
+ * and counted, a missing sensor leaves the AHRS on gyro and accelerometer.
+ *
+ * A calibration fitted by MagCalibration is stored in its own flash page
+ * and loaded at start; it is written only while no route is driven, the
+ * page erase stalls flash for about 20 ms.
+ */
+
+#ifndef INC_MAGNETOMETER_H_
+#define INC_MAGNETOMETER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Last 4 KB page below the route store, reserved in STM32G473RCTX_FLASH.ld,
+ * written through FlashPage.h */
+#define dMAGNETOMETER_STORE_ADDRESS		0x0802F000UL
+#define dMAGNETOMETER_STORE_MAGIC		0x4C43474DUL /* "MGCL" */
+#define dMAGNETOMETER_STORE_VERSION		1
+
+#define dMAGNETOMETER_PERIOD			25		/* [ms] LIS3MDL output data rate 40 Hz */
+#define dMAGNETOMETER_TIMEOUT			10		/* [ms] transfer takes about 0.3 ms */
+#define dMAGNETOMETER_STALE_TIME		200		/* [ms] no sample since, field is not used */
+
+/* Blocking configuration at start, false when the sensor does not answer */
+bool Magnetometer_Init(void);
+/* Main loop. Gyro [rad/s] as given to the AHRS, for the disturbance check */
+void Magnetometer_Perform(const float Gyro[3]);
+/* Gravity in sensor axes, any unit: picks the vertical axis of the calibration */
+void Magnetometer_SetGravity(float X, float Y, float Z);
+/* Calibrated horizontal field [mG], false when not calibrated, disturbed or stale */
+bool Magnetometer_GetField(float* X, float* Y, float* Z);
+bool Magnetometer_IsCalibrated(void);
+uint16_t Magnetometer_GetErrorCount(void);
+
+#endif /* INC_MAGNETOMETER_H_ */
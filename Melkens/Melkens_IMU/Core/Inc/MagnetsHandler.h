@@ -17,6 +17,8 @@
 
 #define dMAGNET_BAR_OFFSET_DISTANCE 20 //distance between robot axle and magnet sens bar in cm
 
+#define dMAGNET_STATUS_ERROR 0xA5A5A5A5U /* status when magnet bar does not answer */
+
 typedef enum MagnetName_t{
 	Magnet1 = 0,
 	Magnet2,
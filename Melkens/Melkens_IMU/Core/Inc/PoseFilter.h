@@ -0,0 +1,77 @@
+/*
+ * PoseFilter.h
+ *
+ * Extended Kalman filter of the robot pose on the route for Navigation.c.
+ * State: X, Y [cm] and Angle [rad] in the Navigation frame (Robot_Angle pi
+ * drives +X), odometry Scale (true cm per encoder count over CmPerCount) and
+ * Bias [rad/s], drift of the AHRS yaw. Every updatePosition predicts from
+ * the wheel travel and the AHRS yaw increment, so scale and drift errors
+ * are learned instead of growing the position error without bound.
+ *
+ * A magnet seen by the magnet bar is an absolute fix. It is matched against
+ * the route magnets (RouteData.Magnet) of the steps around the robot, the
+ * candidate with the smallest Mahalanobis distance is taken and only when
+ * it is within Gate, so false hits and magnets of other steps are rejected.
+ * A false hit that passes the gate can pull the pose so far that the real
+ * magnets are rejected from then on: after dPOSE_FILTER_LOST_REJECTS
+ * rejected fixes in a row the pose deviation is widened by LostDeviation
+ * and LostAngleDeviation and the next real magnet is taken again.
+ *
+ * Fixed size float math on the FPU: predict is one 5x5 covariance
+ * propagation, a fix at most dPOSE_FILTER_MAGNET_WINDOW 2x2 gating tests and
+ * one update. Navigation measures both with the DWT cycle counter, scope
+ * channels pose.predict.cycles and pose.fix.cycles with their maximum. No
+ * hardware access and no state outside the module, Tools/PoseFilter replays
+ * traces on the host.
+ */
+
+#ifndef INC_POSEFILTER_H_
+#define INC_POSEFILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "RoutesDataTypes.h"
+
+#define dPOSE_FILTER_STATES			5
+#define dPOSE_FILTER_MAGNET_WINDOW	4		/* magnets of steps before and after the current one */
+#define dPOSE_FILTER_LOST_REJECTS	3		/* rejected fixes in a row, position is lost */
+#define dPOSE_FILTER_NO_MAGNET		-1
+
+typedef struct PoseFilterParams_t{
+	float CmPerCount;			/* [cm] wheel travel per encoder count, Scale 1 */
+	float DistanceNoise;		/* share of distance, along the travel */
+	float SlipNoise;			/* share of distance, across the travel */
+	float YawNoise;				/* [rad/sqrt(s)] AHRS yaw increments */
+	float ScaleWalk;			/* [1/sqrt(cm)] */
+	float BiasWalk;				/* [rad/s/sqrt(s)] */
+	float MagnetNoise;			/* [cm] magnet fix, bar sensor pitch and sampling along the travel */
+	float Gate;					/* Mahalanobis distance squared, chi2 of 2 degrees of freedom */
+	float ScaleDeviation;		/* initial standard deviations */
+	float BiasDeviation;		/* [rad/s] */
+	float LostDeviation;		/* [cm] added to the position deviation when lost */
+	float LostAngleDeviation;	/* [rad] */
+}PoseFilterParams;
+
+extern const PoseFilterParams PoseFilter_Defaults;
+
+void PoseFilter_Init(const PoseFilterParams* Params);
+/* Route start, position and angle known, Scale and Bias are kept */
+void PoseFilter_Reset(float X, float Y, float Angle);
+/* Counts: encoder travel of both wheels on average, forward positive. YawIncrement: AHRS yaw change [rad] in Dt [s] */
+void PoseFilter_Predict(float Counts, float YawIncrement, float Dt);
+/* Magnet seen at BarPosition [cm] along the bar (MagnetsHandler_GetAvreageDistance),
+ * BarOffset [cm] from the axle. Candidates are Route magnets First..Last.
+ * Returns the magnet used or dPOSE_FILTER_NO_MAGNET when rejected. */
+int16_t PoseFilter_MagnetFix(const RouteData* Route, uint16_t First, uint16_t Last, float BarPosition, float BarOffset);
+
+float PoseFilter_GetX(void);
+float PoseFilter_GetY(void);
+float PoseFilter_GetAngle(void);
+float PoseFilter_GetScale(void);
+float PoseFilter_GetBias(void);
+/* [cm] standard deviation of the position, larger axis */
+float PoseFilter_GetPositionDeviation(void);
+uint16_t PoseFilter_GetFixCount(void);
+uint16_t PoseFilter_GetRejectCount(void);
+
+#endif /* INC_POSEFILTER_H_ */
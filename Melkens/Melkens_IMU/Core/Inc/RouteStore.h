@@ -0,0 +1,68 @@
+/*
+ * RouteStore.h
+ *
+ * Routes uploaded at run time over the ESP, kept in two flash slots (A/B)
+ * in the top of IMU flash. Upload is always written to the inactive slot,
+ * slot header is programmed last, after payload CRC check, so switching
+ * to the new routes is atomic and a broken upload keeps the old routes.
+ * Routes are read directly from flash, RouteData points into the slot.
+ *
+ * Route store image (little endian, built by Tools/RouteCompiler/route_pack.py):
+ *   RouteStoreHeader
+ *   RouteStoreEntry[RouteCount]
+ *   route data, per route: RouteStep[StepCount], RoutePoint[StepCount + 1]
+ *   magnets, RoutePoint[PointCount] pursuit points
+ * Entry offsets are counted from the first byte after the header.
+ */
+
+#ifndef INC_ROUTESTORE_H_
+#define INC_ROUTESTORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "RoutesDataTypes.h"
+#include "MessageTypes.h"
+
+/* Top 64 KB of 256 KB flash, reserved in STM32G473RCTX_FLASH.ld. Needs
+ * single bank mode, see FlashPage.h; otherwise no route is stored and
+ * uploads end in dROUTE_UPLOAD_ERROR_FLASH. */
+#define dROUTE_STORE_ADDRESS        0x08030000UL
+#define dROUTE_STORE_SLOT_SIZE      0x8000UL
+#define dROUTE_STORE_SLOT_NUMOF     2
+
+#define dROUTE_STORE_MAGIC          0x5354524DUL /* "MRTS" */
+#define dROUTE_STORE_VERSION        1
+#define dROUTE_STORE_MAX_ROUTES     64
+
+typedef struct RouteStoreHeader_t{
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t RouteCount;
+    uint32_t Sequence;      /* Set by IMU, slot with highest sequence is active */
+    uint32_t PayloadSize;   /* Bytes after header */
+    uint16_t PayloadCrc;
+    uint8_t Reserved[12];
+    uint16_t HeaderCrc;     /* CRC16 of header without this field */
+} RouteStoreHeader;
+
+typedef struct RouteStoreEntry_t{
+    uint16_t ID;            /* Esp2ImuFrame_t.rootNumber selecting the route */
+    uint16_t StepCount;
+    uint16_t PointCount;
+    uint16_t Reserved;
+    uint32_t Offset;        /* Route data offset in payload */
+} RouteStoreEntry;
+
+void RouteStore_Init(void);
+/* Fills Data with route from active slot, false if route is not stored */
+bool RouteStore_GetRoute(uint16_t ID, RouteData* Data);
+uint8_t RouteStore_GetRouteCount(void);
+
+/* Handles route upload block received from ESP. Locked while the robot
+ * moves: a page erase stalls the main loop, the inactive slot can hold the
+ * route being driven. Checked for every block, not only at begin. */
+void RouteStore_ProcessBlock(const RouteBlock_t* Block, bool Locked);
+uint8_t RouteStore_GetUploadState(void);
+uint16_t RouteStore_GetUploadAck(void);
+
+#endif /* INC_ROUTESTORE_H_ */
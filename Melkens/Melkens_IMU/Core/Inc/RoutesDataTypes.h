@@ -14,17 +14,12 @@
 #define TH_ON 1500
 #define TH_OFF 0
 
-#define dMAGNET_R5 5*2.17
-#define dMAGNET_R10 10*2.17
-#define dMAGNET_L5 -5*2.17
-#define dMAGNET_L10 -10*2.17
-#define dMAGNET_MID 0
-#define dMAGNET_L1 -1*2.17
-#define dMAGNET_L2 -2*2.17
-#define dMAGNET_L3 -3*2.17
-#define dMAGNET_L4 -4*2.17
-#define dMAGNET_L6 -6*2.17
-#define dMAGNET_L7 -7*2.17
+/* RouteStep.MagnetOffset when magnet correction is not used in step */
+#define dROUTE_MAGNET_NONE INT16_MAX
+/* Route points are generated every 10 cm by Tools/RouteCompiler, distance is baked into Routes.c */
+#define dROUTE_POINTS_DISTANCE 10
+/* Pi of the Navigation frame angles [rad] */
+#define dROUTE_PI 3.14159265f
 
 
 void RouteManager_StateMachine(void);
@@ -45,20 +40,31 @@ typedef enum RouteStates_t
     RouteState_Pause,
     RouteState_BuzzerLampInication,
     RouteState_Drive,
+    RouteState_BackOff,     /* collision or stall while driving, then pause */
 } RouteStates;
 
+/* Route tables (Routes.c) are generated by Tools/RouteCompiler from Routes/ */
 typedef struct RouteStep_t{
-    int dX;            /* X coord change */
-    int dY;            /* Y coord change */
-    int16_t Speed;         /* Speed */
+    int16_t Speed;         /* Speed, negative when driving backwards */
     uint16_t ThumbleSpeed; /* Thumble speed */
-    float MagnetCorrectionOffset;   /* Correction of angle when magnet bar detection is not in the middle */
+    uint16_t Length;       /* Step length [cm] */
+    int16_t Heading;       /* Step heading [1e-4 rad] */
+    int16_t MagnetOffset;  /* Expected magnet bar position [0.1mm], dROUTE_MAGNET_NONE if not used */
 } RouteStep;
 
+typedef struct RoutePoint_t{
+    int16_t X;             /* [cm] */
+    int16_t Y;             /* [cm] */
+    uint16_t StepNumber;
+} RoutePoint;
+
 typedef struct RouteData_t{
     Route_ID ID;
     uint16_t StepCount;
+    uint16_t PointCount;
     const RouteStep* Step;
+    const RoutePoint* Magnet;  /* StepCount + 1 magnet points, end of each step */
+    const RoutePoint* Point;   /* PointCount pursuit points */
 }RouteData;
 
 void Route_SetRoutePointer(RouteData* Data ,Route_ID RouteSelected);
@@ -0,0 +1,31 @@
+/*
+ * TimeBase.h
+ *
+ * Shared timebase of the robot. ESP is time master of the ESP link, IMU
+ * follows it and is time master of the PMB link, see TimeSync.h. Shared time
+ * is [us] on ESP micros(), week time is ESP wall clock from SNTP.
+ */
+
+#ifndef INC_TIMEBASE_H_
+#define INC_TIMEBASE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MessageTypes.h"
+
+void TimeBase_Init(void);
+
+/* Stamp of a valid Esp2ImuFrame, received at TimeManager_GetMicros */
+void TimeBase_EspFrameReceived(const SyncStamp_t* Stamp, uint32_t RxTime);
+/* Stamp of a valid Pmb2ImuFrame */
+void TimeBase_PmbFrameReceived(const SyncStamp_t* Stamp, uint32_t RxTime);
+/* Fill stamp right before frame is handed to DMA, Baud of the link (LinkSpeed) */
+void TimeBase_StampEspFrame(SyncStamp_t* Stamp, uint32_t Baud);
+void TimeBase_StampPmbFrame(SyncStamp_t* Stamp, uint32_t Baud);
+
+/* Shared [us] time of TimeManager_GetMicros value, false when not synchronised */
+bool TimeBase_ToShared(uint32_t Local, uint32_t* Shared);
+/* [us] worst case error of TimeBase_ToShared, UINT32_MAX when not synchronised */
+uint32_t TimeBase_GetErrorBound(void);
+
+#endif /* INC_TIMEBASE_H_ */
@@ -13,6 +13,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 
 void TimeManager_Init(void);
 void TimeManager_DeInit(void);
@@ -22,5 +23,9 @@ bool TimeManager_Is1msPassed(void);
 bool TimeManager_Is10msPassed(void);
 bool TimeManager_Is100msPassed(void);
 bool TimeManager_IsTickReloaded(void);
+/* Free running 1ms tick */
+uint32_t TimeManager_GetSystemTick(void);
+/* Free running [us] time from 1ms tick and TIM7 counter, for latency traces */
+uint32_t TimeManager_GetMicros(void);
 
 #endif /* INC_TIMEMANAGER_H_ */
@@ -25,6 +25,7 @@ typedef enum
 
 //void UartHandler_SendMessage(uint8_t MessageID);
 void UartHandler_SendMessage(UartName UartNum, char* Message, uint8_t Len);
+void UartHandler_SendBuffer(UartName UartNum, const uint8_t* Data, uint16_t Len);
 int16_t UartHandler_GetValueFromBuffer(UartName Uart, uint8_t Offset,  uint8_t Size);
 void UartHandler_GetRxBuffer(UartName Uart, uint8_t* dest, uint8_t Size);
 void UartHandler_SetMessage(char *Message, char *Type);
@@ -35,6 +36,9 @@ void UartHandler_SetDataRequest(UartName Uart, bool State);
 uint32_t UartHandler_GetSendBufferAddress(UartName UartNum);
 uint32_t UartHandler_GetReceiveBufferAddress(UartName UartNum);
 void UartHandler_ReloadReceiveChannel(UartName Uart);
+bool UartHandler_IsSendDone(UartName Uart);
+bool UartHandler_SetBaudRate(UartName Uart, uint32_t BaudRate);
+void UartHandler_DropPartialFrame(UartName Uart);
 void UartHandler_ClearRXBuffer(UartName Uart);
 void UartHandler_Check_Overrun();
 
@@ -0,0 +1,59 @@
+/*
+ * VelocityPlanner.h
+ *
+ * Speed along the route for pure pursuit (Navigation.c). At loadRoute the
+ * route points are planned once: curvature of every point from its
+ * neighbours gives a speed limit from lateral acceleration and from the
+ * outer wheel speed, the step speed stays the upper limit. A backward and a
+ * forward pass over the points keep acceleration along the route within
+ * MaxAccel, so the robot slows down before turns, reversals and the route
+ * end and speeds up after them. Lookahead of the pursuit point grows with
+ * the planned speed: short in turns to cut less of the corner, long on
+ * straights to keep the robot calm at speed.
+ *
+ * Step speeds are an upper limit now, straight feed alleys can be given a
+ * higher speed than turns could take. Disabled, the step speed and the
+ * fixed dVELOCITY_PLANNER_FIXED_LOOKAHEAD are used as before.
+ * No hardware access, Tools/VelocityPlanner builds it with Navigation.c
+ * on the host and drives the stored routes with a robot model.
+ */
+
+#ifndef INC_VELOCITYPLANNER_H_
+#define INC_VELOCITYPLANNER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "RoutesDataTypes.h"
+
+#define dVELOCITY_PLANNER_MAX_POINTS		2048	/* longer routes are driven with step speeds */
+#define dVELOCITY_PLANNER_CURVATURE_SPAN	3		/* [points] curvature from points this far on both sides */
+#define dVELOCITY_PLANNER_FIXED_LOOKAHEAD	5		/* [points] pursuitPointIncrement without the planner */
+
+typedef struct VelocityPlannerParams_t{
+	float DistancePerRotation;	/* [cm] per 10000 encoder counts, as in updatePosition */
+	float TrackWidth;			/* [cm] between wheel contact points */
+	float MaxLateralAccel;		/* [cm/s^2] */
+	float MaxAccel;				/* [cm/s^2] along the route, speeding up and slowing down */
+	uint16_t MaxWheelSpeed;		/* outer wheel command limit in turns, PMB dSPEED_CONTROL_MAX_SPEED */
+	uint16_t MinSpeed;			/* at start, reversals and route end, planned speed stays above it */
+	float LookaheadTime;		/* [s] lookahead distance is planned speed times this */
+	uint8_t MinLookahead;		/* [points] */
+	uint8_t MaxLookahead;		/* [points] */
+}VelocityPlannerParams;
+
+extern const VelocityPlannerParams VelocityPlanner_Defaults;
+
+void VelocityPlanner_Init(const VelocityPlannerParams* Params);
+void VelocityPlanner_SetEnabled(bool Enabled);
+bool VelocityPlanner_IsEnabled(void);
+/* Once per route in loadRoute, false when the route has too many points */
+bool VelocityPlanner_Plan(const RouteData* Route);
+/* Speed command at route point, sign of the step speed */
+int16_t VelocityPlanner_GetSpeed(const RouteData* Route, uint16_t Point);
+/* Speed limited for the turn commanded now, wheels at Speed * (1 +- Steering).
+ * Off the route pursuit turns harder than the route, plan alone is not enough. */
+int16_t VelocityPlanner_LimitSteering(int16_t Speed, float Steering);
+/* [points] pursuit point increment for the speed command */
+uint8_t VelocityPlanner_GetLookahead(int16_t Speed);
+
+#endif /* INC_VELOCITYPLANNER_H_ */
@@ -8,7 +8,13 @@
 #ifndef INC_ROUTEMANAGER_H_
 #define INC_ROUTEMANAGER_H_
 
+#include <stdbool.h>
+
 void RouteManager_Perform1ms(void);
 void RouteManager_Init(void);
+/* Route data in use, route store can not be changed */
+bool RouteManager_IsDriving(void);
+/* dCOLLISION_... the route is stopped for, until it is resumed */
+uint8_t RouteManager_GetCollision(void);
 
 #endif /* INC_ROUTEMANAGER_H_ */
@@ -0,0 +1,166 @@
+/*
+ * CollisionDetector.c
+ *
+ * Impact, wheel stall and auger overload detection, see CollisionDetector.h.
+ * Integer only, runs for every accelerometer sample.
+ */
+
+#include <stdlib.h>
+#include "CollisionDetector.h"
+
+const CollisionParams CollisionDetector_Defaults = {
+	.ImpactJerk = 1200,		/* 0.07 g in 2.4 ms, driving and floor bumps stay below 0.05 g through the input filter */
+	.ImpactAccel = 6500,	/* 0.4 g, front and side hits of 0.8 g and more reach it while still rising */
+	.StallMinSpeed = 100,
+	.StallCurrent = 2315,	/* 25 A */
+	.StallTravel = 20,
+	.StallTime = 500,
+	.AugerCurrent = 45,		/* PMB route manager retries the step above it */
+	.AugerTime = 300,
+};
+
+static CollisionParams Params;
+static uint8_t Event;
+static uint32_t EventTime;
+
+static bool IsAccStarted;
+static int32_t InputX, InputY;	/* << dCOLLISION_INPUT_SHIFT */
+static int16_t LastX, LastY;
+static int32_t BaseX, BaseY;	/* << dCOLLISION_BASE_SHIFT */
+
+static bool IsPmbStarted;
+static uint32_t LastLeft, LastRight;
+static bool IsStalling;
+static uint32_t StallStart;
+static uint32_t StallTravel;
+static bool IsOverloading;
+static uint32_t OverloadStart;
+
+static void CollisionDetector_Raise(uint8_t NewEvent, uint32_t Now)
+{
+	if(Event == dCOLLISION_NONE)
+	{
+		Event = NewEvent;
+		EventTime = Now;
+	}
+}
+
+/* Encoder increment, counts wrap at dCOLLISION_ENCODER_RANGE */
+static uint32_t CollisionDetector_Travel(uint32_t Now, uint32_t Last)
+{
+	int32_t Increment = (int32_t)Now - (int32_t)Last;
+
+	if(Increment < -(dCOLLISION_ENCODER_RANGE / 2))
+		Increment += dCOLLISION_ENCODER_RANGE;
+	else if(Increment > (dCOLLISION_ENCODER_RANGE / 2))
+		Increment -= dCOLLISION_ENCODER_RANGE;
+	return (uint32_t)abs(Increment);
+}
+
+void CollisionDetector_Init(const CollisionParams* NewParams)
+{
+	Params = *NewParams;
+	IsPmbStarted = false;
+	CollisionDetector_Clear();
+}
+
+void CollisionDetector_AccSample(int16_t X, int16_t Y, int16_t Z, uint32_t Now)
+{
+	int32_t Jerk, Deviation;
+
+	(void)Z;	/* floor bumps and lifting, not collisions */
+	if(!IsAccStarted)
+	{
+		IsAccStarted = true;
+		InputX = (int32_t)X << dCOLLISION_INPUT_SHIFT;
+		InputY = (int32_t)Y << dCOLLISION_INPUT_SHIFT;
+		BaseX = (int32_t)X << dCOLLISION_BASE_SHIFT;
+		BaseY = (int32_t)Y << dCOLLISION_BASE_SHIFT;
+	}
+	else
+	{
+		InputX += (int32_t)X - (InputX >> dCOLLISION_INPUT_SHIFT);
+		InputY += (int32_t)Y - (InputY >> dCOLLISION_INPUT_SHIFT);
+		X = (int16_t)(InputX >> dCOLLISION_INPUT_SHIFT);
+		Y = (int16_t)(InputY >> dCOLLISION_INPUT_SHIFT);
+		Jerk = abs((int32_t)X - LastX) + abs((int32_t)Y - LastY);
+		Deviation = abs((int32_t)X - (BaseX >> dCOLLISION_BASE_SHIFT)) + abs((int32_t)Y - (BaseY >> dCOLLISION_BASE_SHIFT));
+		if(Jerk >= Params.ImpactJerk && Deviation >= Params.ImpactAccel)
+			CollisionDetector_Raise(dCOLLISION_IMPACT, Now);
+		BaseX += (int32_t)X - (BaseX >> dCOLLISION_BASE_SHIFT);
+		BaseY += (int32_t)Y - (BaseY >> dCOLLISION_BASE_SHIFT);
+	}
+	LastX = X;
+	LastY = Y;
+}
+
+void CollisionDetector_PmbFrame(const Pmb2ImuFrame_t* Frame, int16_t LeftSpeed, int16_t RightSpeed, uint32_t Now)
+{
+	uint32_t Travel = 0;
+	bool IsDriven = abs(LeftSpeed) >= Params.StallMinSpeed || abs(RightSpeed) >= Params.StallMinSpeed;
+
+	if(IsPmbStarted)
+		Travel = CollisionDetector_Travel(Frame->motorLeftRotation, LastLeft) + CollisionDetector_Travel(Frame->motorRightRotation, LastRight);
+	IsPmbStarted = true;
+	LastLeft = Frame->motorLeftRotation;
+	LastRight = Frame->motorRightRotation;
+
+	if(IsDriven && Frame->adcCurrent >= Params.StallCurrent)
+	{
+		if(!IsStalling)
+		{
+			IsStalling = true;
+			StallStart = Now;
+			StallTravel = 0;
+		}
+		else
+		{
+			StallTravel += Travel;
+		}
+		if((Now - StallStart) >= Params.StallTime)
+		{
+			if(StallTravel < Params.StallTravel)
+				CollisionDetector_Raise(dCOLLISION_WHEEL_STALL, Now);
+			/* Moving under load, next window */
+			StallStart = Now;
+			StallTravel = 0;
+		}
+	}
+	else
+	{
+		IsStalling = false;
+	}
+
+	if(abs((int16_t)Frame->thumbleCurrent) >= Params.AugerCurrent)
+	{
+		if(!IsOverloading)
+		{
+			IsOverloading = true;
+			OverloadStart = Now;
+		}
+		if((Now - OverloadStart) >= Params.AugerTime)
+			CollisionDetector_Raise(dCOLLISION_AUGER_OVERLOAD, Now);
+	}
+	else
+	{
+		IsOverloading = false;
+	}
+}
+
+uint8_t CollisionDetector_GetEvent(void)
+{
+	return Event;
+}
+
+uint32_t CollisionDetector_GetEventTime(void)
+{
+	return EventTime;
+}
+
+void CollisionDetector_Clear(void)
+{
+	Event = dCOLLISION_NONE;
+	IsAccStarted = false;
+	IsStalling = false;
+	IsOverloading = false;
+}
@@ -11,44 +11,164 @@
 #include "UartHandler.h"
 #include "math.h"
 #include "MessageTypes.h"
-#include "CRC16.h"
+#include "MessageCodec.h"
 #include "IMU_func.h"
 #include "RoutesDataTypes.h"
-
-Esp2ImuFrame_t Esp2ImuFrame;
+#include "RouteStore.h"
+#include "routeManager.h"
+#include "TimeManager.h"
+#include "TimeBase.h"
+#include "LinkSpeed.h"
+#include "Loader.h"
+#include "BinLog.h"
+
+/* ESP sends control frame on every change and at least every 100ms */
+#define dESP_COMMAND_TIMEOUT	300		/* [ms] without control frame joystick is released */
+
+Esp2ImuFrame_t Esp2ImuFrame;	/* Last control frame */
+static Esp2ImuFrame_t Esp2ImuRxFrame;
+static bool CommandValid;		/* Control frame received within dESP_COMMAND_TIMEOUT */
+static uint32_t CommandTick;
+static uint16_t CommandRxTime;
+static bool HelloRequested;		/* ESP hello received, answer with next status frame */
+static LinkSpeed EspLink;		/* ESP is master of baud rate negotiation */
+static bool IsEspBaudPending;	/* New baud rate waits for status frame being sent */
+static bool IsStopped;			/* Emergency stop latched until a newer control frame */
+static uint32_t StopTime;		/* [us] shared, Esp2ImuFrame_t.stopTime of latched stop */
 
 Route_ID SelectedRoute = RouteA;
 
 
 void connectivityHandlerInit()
 {
-
+	LinkSpeed_Init(&EspLink, false, dLINK_RATE_2000000, TimeManager_GetSystemTick());
 }
 
 
 void connectivityHandlerPerform()
 {
+	UartHandler_DropPartialFrame(Uart_ConnectivityESP);
 	connectivityHandlerRecieveData();
 
+	if(LinkSpeed_Perform(&EspLink, TimeManager_GetSystemTick()))
+		IsEspBaudPending = true;
+	if(IsEspBaudPending)
+	{
+		IsEspBaudPending = !UartHandler_SetBaudRate(Uart_ConnectivityESP, LinkSpeed_GetBaud(&EspLink));
+		if(!IsEspBaudPending)
+			BINLOG("esp link: %u baud", LinkSpeed_GetBaud(&EspLink));
+	}
+
+	if(CommandValid && (TimeManager_GetSystemTick() - CommandTick) > dESP_COMMAND_TIMEOUT)
+	{
+		/* ESP link lost, stop manual driving */
+		BINLOG("esp link: no control frame for %u ms", TimeManager_GetSystemTick() - CommandTick);
+		CommandValid = false;
+		Esp2ImuFrame.moveX = 0;
+		Esp2ImuFrame.moveY = 0;
+		IMU_RequestSendToPMB();
+	}
+}
+
+/* Returns false for frames older than the applied one, sequence is only
+ * trusted while commands keep coming, so ESP restart is accepted after timeout */
+static bool connectivityHandlerApplyCommand(const Esp2ImuFrame_t* Frame)
+{
+	int16_t Age = (int16_t)(Esp2ImuFrame.commandSequence - Frame->commandSequence);
+	bool Changed = !CommandValid || Age != 0;
+
+	if(CommandValid && Age > 0)
+		return false;
+
+	CommandValid = true;
+	CommandTick = TimeManager_GetSystemTick();
+	memcpy(&Esp2ImuFrame, Frame, sizeof(Esp2ImuFrame_t));
+
+	if(Changed)
+	{
+		/* Control frame newer than the stop releases it */
+		IsStopped = false;
+		CommandRxTime = (uint16_t)TimeManager_GetMicros();
+		/* New wheel speeds go to PMB right after next RouteManager tick */
+		IMU_RequestSendToPMB();
+	}
+	return true;
+}
+
+/* Stop is ordered like control frames, repeated copies only keep the command alive */
+static void connectivityHandlerApplyStop(const Esp2ImuFrame_t* Frame)
+{
+	int16_t Age = (int16_t)(Esp2ImuFrame.commandSequence - Frame->stopSequence);
+
+	if(CommandValid && Age > 0)
+		return;
+
+	CommandValid = true;
+	CommandTick = TimeManager_GetSystemTick();
+	if(IsStopped && Age == 0)
+		return;
+
+	Esp2ImuFrame.moveX = 0;
+	Esp2ImuFrame.moveY = 0;
+	Esp2ImuFrame.augerSpeed = 0;
+	Esp2ImuFrame.rootAction = 0;
+	Esp2ImuFrame.commandSequence = Frame->stopSequence;
+	CommandRxTime = (uint16_t)TimeManager_GetMicros();
+	IsStopped = true;
+	StopTime = Frame->stopTime;
+	BINLOG("esp link: stop %u latched", Frame->stopSequence);
+	/* Not rate limited and ahead of RouteManager, speeds are zeroed when sent */
+	IMU_RequestStopToPMB();
 }
 
 void connectivityHandlerRecieveData()
 {
 	if (UartHandler_IsDataReceived(Uart_ConnectivityESP))
 	{
-		UartHandler_GetRxBuffer(Uart_ConnectivityESP, (uint8_t *)&Esp2ImuFrame, sizeof(Esp2ImuFrame_t));
-		if (Esp2ImuFrame.crc == CRC16((uint8_t *)&Esp2ImuFrame, sizeof(Esp2ImuFrame_t) - sizeof(Esp2ImuFrame.crc)))
+		uint32_t RxTime = TimeManager_GetMicros();
+
+		UartHandler_GetRxBuffer(Uart_ConnectivityESP, (uint8_t *)&Esp2ImuRxFrame, sizeof(Esp2ImuFrame_t));
+		/* Frame is copied, receive next one while route block is written to flash */
+		UartHandler_ReloadReceiveChannel(Uart_ConnectivityESP);
+
+		if (Esp2ImuFrame_IsValid(&Esp2ImuRxFrame))
 		{
-			if(Esp2ImuFrame.rootNumber == 0)
-				SelectedRoute = RouteA;
-			else if(Esp2ImuFrame.rootNumber == 1)
-				SelectedRoute = RouteB;
-			else if(Esp2ImuFrame.rootNumber == 2)
-				SelectedRoute = RouteC;
-			else if(Esp2ImuFrame.rootNumber == 3)
-				SelectedRoute = RouteD;
+			LinkSpeed_Receive(&EspLink, &Esp2ImuRxFrame.link, TimeManager_GetSystemTick());
+			/* Application is up and talks to the ESP, the loader does not take it back */
+			Loader_ConfirmBoot();
+			TimeBase_EspFrameReceived(&Esp2ImuRxFrame.sync, RxTime);
+			if (Esp2ImuRxFrame.frameType == dESP2IMU_FRAME_ROUTE_BLOCK)
+			{
+				RouteStore_ProcessBlock(&Esp2ImuRxFrame.routeBlock, IMU_IsFlashLocked());
+			}
+			else if (Esp2ImuRxFrame.frameType == dESP2IMU_FRAME_STOP)
+			{
+				connectivityHandlerApplyStop(&Esp2ImuRxFrame);
+			}
+			/* dESP2IMU_FRAME_FW_UPDATE is ignored, there is no loader to reset into
+			 * and dPROTOCOL_FEATURE_FW_UPDATE is not offered */
+			else if (Esp2ImuRxFrame.frameType == dESP2IMU_FRAME_HELLO)
+			{
+				/* ESP compares layouts and picks common features from the answer */
+				HelloRequested = ProtocolHello_Check(&Esp2ImuRxFrame.hello);
+			}
+			else if (Esp2ImuRxFrame.frameType == dESP2IMU_FRAME_CONTROL && connectivityHandlerApplyCommand(&Esp2ImuRxFrame))
+			{
+				if(Esp2ImuFrame.rootNumber < Route_NumOf)
+					SelectedRoute = (Route_ID)Esp2ImuFrame.rootNumber;
+				else
+				{
+					RouteData Route;
+					/* Routes above compiled in ones come from route store */
+					if(RouteStore_GetRoute(Esp2ImuFrame.rootNumber, &Route))
+						SelectedRoute = (Route_ID)Esp2ImuFrame.rootNumber;
+				}
+			}
+		}
+		else
+		{
+			LinkSpeed_Error(&EspLink, TimeManager_GetSystemTick());
 		}
-		UartHandler_ReloadReceiveChannel(Uart_ConnectivityESP);
 	}
 }
 
@@ -78,4 +198,40 @@ uint8_t getRouteAction(void)
 	return Esp2ImuFrame.rootAction;
 }
 
+uint16_t getCommandSequence(void)
+{
+	return Esp2ImuFrame.commandSequence;
+}
+
+uint16_t getCommandRxTime(void)
+{
+	return CommandRxTime;
+}
+
+bool connectivityHandlerIsStopped(void)
+{
+	return IsStopped;
+}
+
+uint32_t connectivityHandlerGetStopTime(void)
+{
+	return StopTime;
+}
+
+bool connectivityHandlerTakeHelloRequest(void)
+{
+	bool Requested = HelloRequested;
+
+	HelloRequested = false;
+	return Requested;
+}
 
+void connectivityHandlerStampLink(LinkControl_t* Control)
+{
+	LinkSpeed_Stamp(&EspLink, Control, TimeManager_GetSystemTick());
+}
+
+uint32_t connectivityHandlerGetEspBaud(void)
+{
+	return LinkSpeed_GetBaud(&EspLink);
+}
@@ -0,0 +1,92 @@
+/*
+ * DebugUart.c
+ *
+ * BINLOG drain and scope on USART3, see DebugUart.h.
+ */
+
+#include "main.h"
+#include "DebugUart.h"
+#include "UartHandler.h"
+#include "DataTypes.h"
+#include "TimeManager.h"
+
+#define dDEBUG_UART_FRAME_SIZE			256		/* [bytes] 5.6ms at 460800 baud */
+#define dDEBUG_UART_CALIBRATION_RECORDS	16
+
+#if UART3_RX_MESSAGE_LEN != dSCOPE_COMMAND_SIZE
+#error "USART3 receive DMA length has to be the scope command size"
+#endif
+
+static uint8_t Frame[dDEBUG_UART_FRAME_SIZE];	/* sent from here by DMA */
+static uint32_t RecordCycles;
+static bool IsScopeSending;
+
+static uint32_t DebugUart_GetCycles(void)
+{
+	return DWT->CYCCNT;
+}
+
+void DebugUart_Init(void)
+{
+	uint32_t Start;
+	uint32_t i;
+
+	BinLog_Init(DebugUart_GetCycles);
+	Scope_Init(1000u, dDEBUG_UART_SCOPE_BUDGET);
+
+	/* Back to back records without interrupts, loop overhead included */
+	__disable_irq();
+	Start = DWT->CYCCNT;
+	for(i = 0; i < dDEBUG_UART_CALIBRATION_RECORDS; i++)
+		BINLOG("binlog calibration %u %u", i, Start);
+	RecordCycles = (DWT->CYCCNT - Start) / dDEBUG_UART_CALIBRATION_RECORDS;
+	__enable_irq();
+
+	BINLOG("binlog: %u cycles per record, %u ns", RecordCycles, RecordCycles * 1000u / (SystemCoreClock / 1000000u));
+}
+
+void DebugUart_Perform(void)
+{
+	uint8_t Command[UART3_RX_MESSAGE_LEN];
+	const uint8_t *ScopeFrame;
+	uint16_t Length;
+
+	UartHandler_DropPartialFrame(Uart_3);
+	if(UartHandler_IsDataReceived(Uart_3))
+	{
+		UartHandler_GetRxBuffer(Uart_3, Command, sizeof(Command));
+		UartHandler_ReloadReceiveChannel(Uart_3);
+		Scope_Command(Command, sizeof(Command));
+	}
+
+	if(!UartHandler_IsSendDone(Uart_3))
+		return;
+	if(IsScopeSending)
+	{
+		IsScopeSending = false;
+		Scope_FrameSent();
+	}
+
+	ScopeFrame = Scope_GetFrame(&Length);
+	if(ScopeFrame != NULL)
+	{
+		IsScopeSending = true;
+		UartHandler_SendBuffer(Uart_3, ScopeFrame, Length);
+		return;
+	}
+	if(BinLog_IsEmpty())
+		return;
+	Length = BinLog_Drain(Frame, sizeof(Frame), TimeManager_GetSystemTick());
+	if(Length > 0)
+		UartHandler_SendBuffer(Uart_3, Frame, Length);
+}
+
+void DebugUart_Sample1ms(void)
+{
+	Scope_Sample(TimeManager_GetSystemTick());
+}
+
+uint32_t DebugUart_GetRecordCycles(void)
+{
+	return RecordCycles;
+}
@@ -0,0 +1,63 @@
+/*
+ * FlashPage.c
+ *
+ * Flash data pages, see FlashPage.h.
+ */
+
+#include "FlashPage.h"
+#include "main.h"
+
+#include <string.h>
+
+bool FlashPage_IsSingleBank(void)
+{
+	return (FLASH->OPTR & FLASH_OPTR_DBANK) == 0;
+}
+
+bool FlashPage_Erase(uint32_t Address)
+{
+	FLASH_EraseInitTypeDef Erase;
+	uint32_t PageError;
+	HAL_StatusTypeDef Status;
+
+	if(!FlashPage_IsSingleBank())
+		return false;
+
+	Erase.TypeErase = FLASH_TYPEERASE_PAGES;
+	Erase.Banks = FLASH_BANK_1;
+	Erase.Page = (Address - FLASH_BASE) / dFLASH_PAGE_SIZE;
+	Erase.NbPages = 1;
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+	Status = HAL_FLASHEx_Erase(&Erase, &PageError);
+	HAL_FLASH_Lock();
+
+	return Status == HAL_OK;
+}
+
+bool FlashPage_Program(uint32_t Address, const uint8_t* Data, uint32_t Length)
+{
+	uint64_t DoubleWord;
+	uint32_t Chunk;
+	HAL_StatusTypeDef Status = HAL_OK;
+
+	if(!FlashPage_IsSingleBank())
+		return false;
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+	for(uint32_t Offset = 0; Offset < Length && Status == HAL_OK; Offset += sizeof(DoubleWord))
+	{
+		Chunk = Length - Offset;
+		if(Chunk > sizeof(DoubleWord))
+			Chunk = sizeof(DoubleWord);
+
+		DoubleWord = UINT64_MAX;
+		memcpy(&DoubleWord, &Data[Offset], Chunk);
+		Status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, Address + Offset, DoubleWord);
+	}
+	HAL_FLASH_Lock();
+
+	return Status == HAL_OK && memcmp((const void*)Address, Data, Length) == 0;
+}
@@ -14,7 +14,16 @@
 #include "MadgwickAHRS.h"
 #include "MagnetsHandler.h"
 #include "ConnectivityHandler.h"
-#include "CRC16.h"
+#include "MessageCodec.h"
+#include "RouteStore.h"
+#include "TimeManager.h"
+#include "TimeBase.h"
+#include "LinkSpeed.h"
+#include "CollisionDetector.h"
+#include "routeManager.h"
+#include "Magnetometer.h"
+#include "Scope.h"
+#include "BinLog.h"
 //assign the structures
 //UART_HandleTypeDef huart1;
 
@@ -25,10 +34,15 @@
 #define dFILTER_COUNT 4
 #define dFILTRATED_TABLE_LEN dFIFO_DEPTH/dFILTER_COUNT
 #define dGRAVITY_COMPENSATION_STEPS 100
+#define dACC_LOW_PASS_SHIFT 5 /* 1/32 per sample, 2 Hz at 416 Hz as LPF2 at ODR/200 */
+#define dPMB_FRAME_MIN_INTERVAL 5 /* [ms] between frames sent on request, PMB frame takes 1.2ms */
 #define SAMPLING_RATE 1 /* 1ms */
 #define POSITIVE_LIMIT_ACC 1.0f
 #define NEGATIVE_LIMIT_ACC -1.0f
 #define RAD_TO_DEG 57.295779513082320876798154814105
+#define dMAG_FUSION_BETA 0.01f /* betaDef of MadgwickAHRS.c */
+#define dMAG_ALIGN_BETA 2.5f
+#define dMAG_ALIGN_UPDATES 260 /* AHRS updates, about 10 s */
 
 //#define DELIMITER 0x0A0D //"\r\n"
 
@@ -38,19 +52,18 @@ I2C_HandleTypeDef hi2c4;
 
 //AHRS=============
 
-// Soft iron error compensation matrix
-float mag_softiron_matrix[3][3] = { { 1.0, 0.0, 0.0 },
-                                    { 0.0, 1.0, 0.0 },
-                                    { 0.0, 0.0, 1.0 } };
 float pitch, yaw, roll = 3.14;
 
 float abias[3] = {0, 0, 0}, gbias[3] = {0, 0, 0};
 float ax, ay, az, gx, gy, gz, mx, my, mz; // variables to hold latest sensor data values
-float magBias[3] = {-166, 1459, 1005.5}; //for hard iron calibration
 
 int calibration_samples = 1000;
 int calibration_sample_count = 0;
 float gxSum = 0, gySum = 0, gzSum = 0, magxSum = 0, magySum = 0, magzSum = 0;
+float accxSum = 0, accySum = 0, acczSum = 0;
+static float AhrsGyro[3]; /* as given to MadgwickAHRSupdate, for the magnetometer disturbance check */
+static bool IsMagAligned;
+static uint16_t MagAlignUpdates;
 
 float magXinit = 0, magYinit = 0, magZinit = 0;
 float first_compass_reading = 0;
@@ -61,7 +74,6 @@ float gyroConversionFactor = 0.000285;//for calculating dps(degrees per second)
 
 
 uint8_t whoamI;
-uint8_t whoamI2;
 uint8_t GravCompensationCounter = 0;
 int32_t CompensationX,CompensationY,CompensationZ;
 
@@ -74,7 +86,6 @@ Imu2PCFrame_t Imu2PCFrame;//debug communication
 int16_t Timer1000ms = 10000;
 
 stmdev_lsm_ctx_t dev_ctx;
-stmdev_lis_ctx_t dev_ctx2;
 
 static uint8_t tx_buffer[100];
 
@@ -148,12 +159,10 @@ static float angular_rate_mdps[3];
 int16_t angular_rate_dps[3];
 int16_t data_raw_acceleration[3];
 int16_t data_raw_acceleration_debug[3];
-int16_t data_raw_magnetic[3];
 static int16_t data_raw_angular_rate[3];
 static int16_t data_raw_temperature[3];
 static float velocity2[3] = {0.0f, 0.0f, 0.0f};
 static float prev_velocity2[3] = {0.0f, 0.0f, 0.0f};
-static float magnetic_mG[3];
 
 int16_t  AccDataTemp[3];
 int16_t  GyroDataTemp[3];
@@ -182,46 +191,12 @@ uint8_t rst;
 
 /* Private functions ---------------------------------------------------------*/
 void lsm6dsr_Init(void);
-void lis3mdl_Init(void);
 
 void IMU_i2c_init(void)
 {
 	  lsm6dsr_Init();
 
-	  //lis3mdl_Init();
-}
-
-void lis3mdl_Init(void)
-{
-	  dev_ctx2.handle = &hi2c4;
-	  dev_ctx2.write_reg = platform_write_lis3mdl;
-	  dev_ctx2.read_reg = platform_read_lis3mdl;
-	  rst = 1;
-
-	  HAL_Delay(BOOT_TIME);
-	  lis3mdl_reset_set(&dev_ctx2, PROPERTY_ENABLE);
-	  whoamI = 0;
-	  do {
-		  lis3mdl_reset_get(&dev_ctx2, &rst);
-	  } while (rst);
-
-	  lis3mdl_device_id_get(&dev_ctx2, &whoamI2);
-
-	  if (whoamI2 != LIS3MDL_ID)
-	    while (1); /*manage here device not found */
-
-	  /* Enable Block Data Update */
-	  lis3mdl_block_data_update_set(&dev_ctx2, PROPERTY_ENABLE);
-	  /* Set Output Data Rate */
-	  lis3mdl_data_rate_set(&dev_ctx2, LIS3MDL_HP_40Hz);
-	  /* Set full scale */
-	  lis3mdl_full_scale_set(&dev_ctx2, LIS3MDL_4_GAUSS);
-	  /* Enable temperature sensor */
-	  lis3mdl_temperature_meas_set(&dev_ctx2, PROPERTY_ENABLE);
-	  /* Set device in continuous mode */
-	  lis3mdl_operating_mode_set(&dev_ctx2, LIS3MDL_CONTINUOUS_MODE);
-
-
+	  Magnetometer_Init();
 }
 
 void lsm6dsr_Init(void)
@@ -285,8 +260,8 @@ void lsm6dsr_Init(void)
 
 	  lsm6dsr_gy_filter_lp1_set(&dev_ctx, PROPERTY_ENABLE);
 
-	  lsm6dsr_xl_hp_path_on_out_set(&dev_ctx, LSM6DSR_LP_ODR_DIV_200);
-	  lsm6dsr_xl_filter_lp2_set(&dev_ctx, PROPERTY_ENABLE);
+	  /* LPF2 off, CollisionDetector needs more than 2 Hz, AHRS gets its ODR/200 in IMU_AccLowPass */
+	  lsm6dsr_xl_filter_lp2_set(&dev_ctx, PROPERTY_DISABLE);
 
 
 }
@@ -381,6 +356,31 @@ void IMU_StoreGyroData(int16_t *Value, int16_t Index)
 	GyroscopeData[Index].Zaxis = Value[2];
 }
 
+/* Accelerometer samples of the FIFO low passed in place for gravity compensation and AHRS,
+ * the bandwidth they had from LPF2 at ODR/200 */
+static void IMU_AccLowPass(void)
+{
+	static int32_t StateX, StateY, StateZ;	/* << dACC_LOW_PASS_SHIFT */
+	static bool IsStarted;
+
+	for(uint16_t i = 0; i < AccCounter && i < dFIFO_DEPTH; i++)
+	{
+		if(!IsStarted)
+		{
+			IsStarted = true;
+			StateX = (int32_t)AccelerationData[i].Xaxis << dACC_LOW_PASS_SHIFT;
+			StateY = (int32_t)AccelerationData[i].Yaxis << dACC_LOW_PASS_SHIFT;
+			StateZ = (int32_t)AccelerationData[i].Zaxis << dACC_LOW_PASS_SHIFT;
+		}
+		StateX += AccelerationData[i].Xaxis - (StateX >> dACC_LOW_PASS_SHIFT);
+		StateY += AccelerationData[i].Yaxis - (StateY >> dACC_LOW_PASS_SHIFT);
+		StateZ += AccelerationData[i].Zaxis - (StateZ >> dACC_LOW_PASS_SHIFT);
+		AccelerationData[i].Xaxis = (int16_t)(StateX >> dACC_LOW_PASS_SHIFT);
+		AccelerationData[i].Yaxis = (int16_t)(StateY >> dACC_LOW_PASS_SHIFT);
+		AccelerationData[i].Zaxis = (int16_t)(StateZ >> dACC_LOW_PASS_SHIFT);
+	}
+}
+
 void IMU_SetDataReadyFlag(void)
 {
 	DataReady = true;
@@ -465,25 +465,6 @@ void IMU_InitLoopTick(void)
 }
 
 
-void IMU_CollectMagnetometer(void)
-{
-    uint8_t reg;
-    /* Read output only if new value is available */
-    lis3mdl_mag_data_ready_get(&dev_ctx2, &reg);
-
-    if (reg) {
-        /* Read magnetic field data */
-        lis3mdl_magnetic_raw_get(&dev_ctx2, data_raw_magnetic);
-        magnetic_mG[0] = 1000 * lis3mdl_from_fs16_to_gauss(
-                           data_raw_magnetic[0]);
-        magnetic_mG[1] = 1000 * lis3mdl_from_fs16_to_gauss(
-                           data_raw_magnetic[1]);
-        magnetic_mG[2] = 1000 * lis3mdl_from_fs16_to_gauss(
-                           data_raw_magnetic[2]);
-    }
-
-
-}
 void IMU_CollectFromFIFO(void)
 {
 AccCounter = 0;
@@ -528,13 +509,79 @@ void IMU_Perform1ms(void){
 
 }
 
+static uint16_t PmbTaskMisses;	/* Pmb2ImuFrame.taskMisses already logged */
+
+/* Latency trace of the last new command, see LatencyTrace_t */
+static LatencyTrace_t Trace;
+static bool IsTraceWaitingForPmb;
+static bool IsTraceToSend;
+
+/* Called for valid Pmb2ImuFrame */
+static void IMU_UpdateTrace(void)
+{
+	if(IsTraceWaitingForPmb && (Pmb2ImuFrame.traceId == Trace.traceId)){
+		IsTraceWaitingForPmb = false;
+		Trace.pmbRxTime = Pmb2ImuFrame.traceRxTime;
+		Trace.pmbTxTime = Pmb2ImuFrame.traceTxTime;
+		Trace.imuPmbRxTime = (uint16_t)TimeManager_GetMicros();
+		IsTraceToSend = true;
+	}
+}
+
+static void IMU_UpdateEspStatus(void)
+{
+	if(IsTraceToSend){
+		IsTraceToSend = false;
+		Imu2EspFrame.trace = Trace;
+		Imu2EspFrame.trace.imuTxTime = (uint16_t)TimeManager_GetMicros();
+	}
+	Imu2EspFrame.commandSequence = getCommandSequence();
+	Imu2EspFrame.routeUploadAck = RouteStore_GetUploadAck();
+	Imu2EspFrame.routeUploadState = RouteStore_GetUploadState();
+	Imu2EspFrame.routeCount = RouteStore_GetRouteCount();
+	Imu2EspFrame.collision = RouteManager_GetCollision();
+}
+
+static LinkSpeed PmbLink;		/* IMU is master of PMB baud rate negotiation */
+static bool IsPmbBaudPending;	/* New baud rate waits for frame being sent */
+static bool PmbStopRequested;	/* Emergency stop goes out as soon as UART is free */
+
+void IMU_InitPmbLink(void)
+{
+	LinkSpeed_Init(&PmbLink, true, dLINK_RATE_2000000, TimeManager_GetSystemTick());
+}
+
+bool IMU_IsFlashLocked(void)
+{
+	return RouteManager_IsDriving() || Imu2PmbFrame.motorLeftSpeed != 0 || Imu2PmbFrame.motorRightSpeed != 0;
+}
+
+/* Status frame to ESP, a requested protocol hello goes alone in its place */
+static void IMU_SendToEsp(void)
+{
+	if( connectivityHandlerTakeHelloRequest() ){
+		ProtocolHello_t Hello;
+
+		ProtocolHello_Make(&Hello);
+		UartHandler_SendMessage(Uart_ConnectivityESP, (char*)&Hello, sizeof(ProtocolHello_t));
+		return;
+	}
+	connectivityHandlerStampLink(&Imu2EspFrame.link);
+	TimeBase_StampEspFrame(&Imu2EspFrame.sync, connectivityHandlerGetEspBaud());
+	Imu2EspFrame_Seal(&Imu2EspFrame);
+	UartHandler_SendMessage(Uart_ConnectivityESP, (char*)&Imu2EspFrame, sizeof(Imu2EspFrame_t));
+}
+
 bool IMU_Perform(void)
 {
+	UartHandler_DropPartialFrame(Uart_PMB);
 	if( UartHandler_IsDataReceived(Uart_PMB) )
 	{
+		uint32_t RxTime = TimeManager_GetMicros();
+
 		UartHandler_GetRxBuffer(Uart_PMB, (uint8_t*)&Pmb2ImuFrame, sizeof(Pmb2ImuFrame_t));
 		/* Process data */
-		if( Pmb2ImuFrame.crc == CRC16((uint8_t*)&Pmb2ImuFrame, sizeof(Pmb2ImuFrame_t) - sizeof(Pmb2ImuFrame.crc)) ){
+		if( Pmb2ImuFrame_IsValid(&Pmb2ImuFrame) ){
 			//todo: [PM] update data from received structure
             // = Pmb2ImuFrame.motorRightRotation;
 			// = Pmb2ImuFrame.motorRightRotation;
@@ -550,13 +597,28 @@ bool IMU_Perform(void)
 			Imu2EspFrame.adcCurrent = Pmb2ImuFrame.adcCurrent;
 			Imu2EspFrame.thumbleCurrent = Pmb2ImuFrame.thumbleCurrent;
 			Imu2EspFrame.crcImu2PmbErrorCount = Pmb2ImuFrame.crcImu2PmbErrorCount;
-			Imu2EspFrame.crc = CRC16((uint8_t*)&Imu2EspFrame, sizeof(Imu2EspFrame_t) - sizeof(Imu2EspFrame.crc));
-			
-			UartHandler_SendMessage(Uart_ConnectivityESP, (char*)&Imu2EspFrame, sizeof(Imu2EspFrame_t));
+			Imu2EspFrame.stopTime = Pmb2ImuFrame.stopTime;
+			Imu2EspFrame.stopReaction = Pmb2ImuFrame.stopReaction;
+			Imu2EspFrame.pmbLoopMaxTime = Pmb2ImuFrame.loopMaxTime;
+			Imu2EspFrame.pmbMissedTicks = Pmb2ImuFrame.missedTicks;
+			Imu2EspFrame.pmbTaskMisses = Pmb2ImuFrame.taskMisses;
+			if(Pmb2ImuFrame.taskMisses != PmbTaskMisses)
+			{
+				PmbTaskMisses = Pmb2ImuFrame.taskMisses;
+				BINLOG("pmb: %u task misses, loop max %u us, %u missed ticks", PmbTaskMisses,
+						Pmb2ImuFrame.loopMaxTime, Pmb2ImuFrame.missedTicks);
+			}
+			TimeBase_PmbFrameReceived(&Pmb2ImuFrame.sync, RxTime);
+			LinkSpeed_Receive(&PmbLink, &Pmb2ImuFrame.link, TimeManager_GetSystemTick());
+			CollisionDetector_PmbFrame(&Pmb2ImuFrame, (int16_t)Imu2PmbFrame.motorLeftSpeed, (int16_t)Imu2PmbFrame.motorRightSpeed, TimeManager_GetSystemTick());
+			IMU_UpdateTrace();
+			IMU_UpdateEspStatus();
+			IMU_SendToEsp();
 			Timer1000ms = 1000;
 		}
 		else{
 			Imu2EspFrame.crcPmb2ImuErrorCount++;
+			LinkSpeed_Error(&PmbLink, TimeManager_GetSystemTick());
 		}
 
 		UartHandler_ReloadReceiveChannel(Uart_PMB);
@@ -567,18 +629,36 @@ bool IMU_Perform(void)
 		
 		if( Timer1000ms <= 0 ){
 			Imu2EspFrame.pmbConnection = false; 
-			Imu2EspFrame.crc = CRC16((uint8_t*)&Imu2EspFrame, sizeof(Imu2EspFrame_t) - sizeof(Imu2EspFrame.crc));
-			UartHandler_SendMessage(Uart_ConnectivityESP, (char*)&Imu2EspFrame, sizeof(Imu2EspFrame_t));
+			IMU_UpdateEspStatus();
+			IMU_SendToEsp();
 			Timer1000ms = 1000;
 		}
 
 	}
 
+	if( LinkSpeed_Perform(&PmbLink, TimeManager_GetSystemTick()) )
+		IsPmbBaudPending = true;
+	if( IsPmbBaudPending )
+		IsPmbBaudPending = !UartHandler_SetBaudRate(Uart_PMB, LinkSpeed_GetBaud(&PmbLink));
+	/* Not before a pending baud rate is set, PMB already listens at the new one */
+	if( PmbStopRequested && !IsPmbBaudPending && UartHandler_IsSendDone(Uart_PMB) ){
+		PmbStopRequested = false;
+		IMU_SendDataToPMB();
+		/* Second copy after dPMB_FRAME_MIN_INTERVAL in case this one is corrupted */
+		IMU_RequestSendToPMB();
+	}
+
+	/* Interrupt driven on I2C4, runs next to the blocking FIFO reads on I2C2 */
+	Magnetometer_Perform(AhrsGyro);
+
 	if( DataReady )
 	{
 		DataReady = false;
 		IMU_CollectFromFIFO();
-		//IMU_CollectMagnetometer();
+		/* Full bandwidth samples, the detector has its own input filter */
+		for(uint16_t i = 0; i < AccCounter && i < dFIFO_DEPTH; i++)
+			CollisionDetector_AccSample(AccelerationData[i].Xaxis, AccelerationData[i].Yaxis, AccelerationData[i].Zaxis, TimeManager_GetSystemTick());
+		IMU_AccLowPass();
 
 		if( IsPeripheralReady )
 		{
@@ -619,6 +699,8 @@ bool IMU_Perform(void)
 }
 uint16_t MagnetsLow;
 uint16_t MagnetsHigh;
+static bool PmbSendRequested;
+static uint32_t PmbLastSendTick;
 
 void IMU_SendDataToPMB(void){
     //todo: [PM] update this structure before sending
@@ -626,21 +708,107 @@ void IMU_SendDataToPMB(void){
 	// Imu2PmbFrame.motorLeftSpeed =
 	// ...
 
-	Imu2PmbFrame.crc = CRC16((uint8_t*)&Imu2PmbFrame, sizeof(Imu2PmbFrame_t) - sizeof(Imu2PmbFrame.crc));
+	Imu2PmbFrame.traceId = getCommandSequence();
+	if(Imu2PmbFrame.traceId != Trace.traceId){
+		/* First frame after a new command starts its trace, PMB echoes traceId */
+		Trace.traceId = Imu2PmbFrame.traceId;
+		Trace.imuRxTime = getCommandRxTime();
+		Trace.imuPmbTxTime = (uint16_t)TimeManager_GetMicros();
+		IsTraceWaitingForPmb = true;
+	}
+	if( connectivityHandlerIsStopped() ){
+		/* PMB ignores speeds while stopped, zeroed anyway for ESP status and release */
+		Imu2PmbFrame.motorRightSpeed = 0;
+		Imu2PmbFrame.motorLeftSpeed = 0;
+		Imu2PmbFrame.motorThumbleSpeed = 0;
+		Imu2PmbFrame.motorLiftSpeed = 0;
+		Imu2PmbFrame.motorBelt1Speed = 0;
+		Imu2PmbFrame.motorBelt2Speed = 0;
+		Imu2PmbFrame.stop = dSTOP_REQUESTED;
+		Imu2PmbFrame.stopTime = connectivityHandlerGetStopTime();
+	}
+	else{
+		Imu2PmbFrame.stop = dSTOP_NONE;
+	}
+	/* PMB loader is not in the tree, its start is never requested */
+	Imu2PmbFrame.fwTarget = dFW_TARGET_NONE;
+	Imu2PmbFrame.fwRate = 0;
+	/* SWITCH is repeated in the next frame without waiting for the frame period */
+	bool isSwitching = LinkSpeed_Stamp(&PmbLink, &Imu2PmbFrame.link, TimeManager_GetSystemTick());
+	TimeBase_StampPmbFrame(&Imu2PmbFrame.sync, LinkSpeed_GetBaud(&PmbLink));
+	Imu2PmbFrame_Seal(&Imu2PmbFrame);
 		
 	UartHandler_SendMessage(Uart_PMB, (char*)&Imu2PmbFrame, sizeof(Imu2PmbFrame));
+	PmbLastSendTick = TimeManager_GetSystemTick();
+	/* SWITCH just went out, UART follows once the frame is sent */
+	if( LinkSpeed_Perform(&PmbLink, PmbLastSendTick) )
+		IsPmbBaudPending = true;
+	else if( isSwitching )
+		IMU_RequestSendToPMB();
 }
 
-void IMU_SendDataToPC(void){
-    //todo: [PM] update this structure before sending
-    // Imu2PCFrame.motorRightSpeed =
-	// Imu2PCFrame.motorLeftSpeed =
-	// ...
+void IMU_RequestSendToPMB(void){
+	PmbSendRequested = true;
+}
+
+void IMU_RequestStopToPMB(void){
+	PmbStopRequested = true;
+}
 
-	//Imu2PCFrame.crc = CRC16((uint8_t*)&Imu2PCFrame, sizeof(Imu2PCFrame_t) - sizeof(Imu2PCFrame.crc));
-	Imu2PCFrame.crc = '\n\r';
+/* 1ms task placed after RouteManager_Perform1ms, new command reaches PMB in the same tick */
+void IMU_SendRequestedDataToPMB(void){
+	if(PmbSendRequested && (TimeManager_GetSystemTick() - PmbLastSendTick) >= dPMB_FRAME_MIN_INTERVAL){
+		PmbSendRequested = false;
+		IMU_SendDataToPMB();
+	}
+}
 
-	UartHandler_SendMessage(Uart_3, (char*)&Imu2PCFrame, sizeof(Imu2PCFrame));
+/* Variables the PC scope can select, packed frame members are read unaligned */
+void IMU_RegisterScopeChannels(void)
+{
+	Scope_Register("imu.gx", &gx, dSCOPE_TYPE_FLOAT);
+	Scope_Register("imu.gy", &gy, dSCOPE_TYPE_FLOAT);
+	Scope_Register("imu.gz", &gz, dSCOPE_TYPE_FLOAT);
+	Scope_Register("imu.yaw", &yaw, dSCOPE_TYPE_FLOAT);
+	Scope_Register("imu.pitch", &pitch, dSCOPE_TYPE_FLOAT);
+	Scope_Register("imu.roll", &roll, dSCOPE_TYPE_FLOAT);
+	Scope_Register("pmb.right.speed", &Imu2PmbFrame.motorRightSpeed, dSCOPE_TYPE_INT16);
+	Scope_Register("pmb.left.speed", &Imu2PmbFrame.motorLeftSpeed, dSCOPE_TYPE_INT16);
+	Scope_Register("pmb.right.rotation", &Pmb2ImuFrame.motorRightRotation, dSCOPE_TYPE_UINT32);
+	Scope_Register("pmb.left.rotation", &Pmb2ImuFrame.motorLeftRotation, dSCOPE_TYPE_UINT32);
+	Scope_Register("pmb.battery", &Pmb2ImuFrame.batteryVoltage, dSCOPE_TYPE_UINT16);
+	Scope_Register("debug.x1", &Imu2PCFrame.Xpos1, dSCOPE_TYPE_UINT16);
+	Scope_Register("debug.y1", &Imu2PCFrame.Ypos1, dSCOPE_TYPE_UINT16);
+	Scope_Register("debug.x2", &Imu2PCFrame.Xpos2, dSCOPE_TYPE_UINT16);
+	Scope_Register("debug.y2", &Imu2PCFrame.Ypos2, dSCOPE_TYPE_UINT16);
+}
+
+/* Calibrated field for the AHRS, zeros when there is none (disturbed, not calibrated): gyro and
+ * accelerometer only. The AHRS heading is pulled onto the magnetic one once with a high gain while
+ * no route is driven, with the normal gain it would take minutes and show in Navigation as a turn. */
+static void IMU_MagneticField(void)
+{
+	bool IsField = Magnetometer_GetField(&mx, &my, &mz);
+
+	if(!Magnetometer_IsCalibrated())
+		IsMagAligned = false;
+	if(IsField && !IsMagAligned)
+	{
+		if(RouteManager_IsDriving())
+			IsField = false;
+		else if(++MagAlignUpdates >= dMAG_ALIGN_UPDATES)
+		{
+			IsMagAligned = true;
+			MagAlignUpdates = 0;
+		}
+	}
+	beta = (IsField && !IsMagAligned) ? dMAG_ALIGN_BETA : dMAG_FUSION_BETA;
+	if(!IsField)
+	{
+		mx = 0;
+		my = 0;
+		mz = 0;
+	}
 }
 
 void IMU_AHRS_Calculation(void){
@@ -653,13 +821,13 @@ void IMU_AHRS_Calculation(void){
 	    ay = AccelerationFiltered[0].Yaxis / 16000 + abias[1];
 	    az = AccelerationFiltered[0].Zaxis / 16000 + abias[2];
 
-	    mx = 0;//magnetic_mG[0] + magBias[0];// Convert to Gauss and correct for calibration
-	    my = 0;//magnetic_mG[1] + magBias[1];
-	    mz = 0;//magnetic_mG[2] + magBias[2];
+	    AhrsGyro[0] = gx;
+	    AhrsGyro[1] = gy;
+	    AhrsGyro[2] = -gz;
 
-	    // mx=x;// =x*mag_softiron_matrix[0][0] + y * mag_softiron_matrix[0][1] + z * mag_softiron_matrix[0][2];     // Convert to Gauss and correct for calibration
-	    // my=y;// =x*mag_softiron_matrix[1][0] + y * mag_softiron_matrix[1][1] + z * mag_softiron_matrix[1][2];
-	    // mz=z;// =x*mag_softiron_matrix[2][0] + y * mag_softiron_matrix[2][1] + z * mag_softiron_matrix[2][2];
+	    mx = 0;
+	    my = 0;
+	    mz = 0;
 
 	    if(calibration_sample_count < calibration_samples)
 	    {
@@ -673,6 +841,10 @@ void IMU_AHRS_Calculation(void){
 			gySum += gy;
 			gzSum += gz;
 
+			accxSum += AccelerationFiltered[0].Xaxis;
+			accySum += AccelerationFiltered[0].Yaxis;
+			acczSum += AccelerationFiltered[0].Zaxis;
+
 	    	calibration_sample_count++;
 
 			if(calibration_sample_count == calibration_samples)
@@ -686,6 +858,7 @@ void IMU_AHRS_Calculation(void){
 				magZinit = magzSum/calibration_samples;
 
 				first_compass_reading = atan2(magYinit, magXinit)-3.1415;
+				Magnetometer_SetGravity(accxSum, accySum, acczSum);
 
 				roll = first_compass_reading;
 
@@ -724,6 +897,7 @@ void IMU_AHRS_Calculation(void){
 	    	if(gz < 0.002 && gz > -0.002)
 	    		gz = 0;
 
+	    	IMU_MagneticField();
 	    	MadgwickAHRSupdate(gx, gy, -gz, ax, ay, az, mx, my, mz);
 
 	    	 // Roll (x-axis rotation)
@@ -0,0 +1,29 @@
+/*
+ * Loader.c
+ *
+ * Boot word of the firmware loader, see Loader.h.
+ */
+
+#include "main.h"
+#include "Loader.h"
+#include "FwUpdate.h"
+
+#define dLOADER_BOOT_WORD	(TAMP->BKP0R)
+
+static bool IsConfirmed;
+
+void Loader_Init(void)
+{
+	/* Backup registers are written through the backup domain */
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+	__HAL_RCC_RTCAPB_CLK_ENABLE();
+}
+
+void Loader_ConfirmBoot(void)
+{
+	if(IsConfirmed)
+		return;
+	IsConfirmed = true;
+	dLOADER_BOOT_WORD = FwBoot_Confirm();
+}
@@ -0,0 +1,407 @@
+/*
+ * MagCalibration.c
+ *
+ * Ellipse fit and disturbance detection of the horizontal field, see
+ * MagCalibration.h. Samples u, v are taken in gauss relative to Ref, the
+ * center of the calibration or the first sample, and fitted as
+ *   A (u^2 - v^2) + B u v + D u + E v + F = -v^2
+ * which is the conic of the header with a + c = 1 instead of the right
+ * side 1, so Ref may lie on the ellipse. Heading sectors are counted from
+ * the integrated gyro, the calibration is not needed for the coverage.
+ */
+
+#include <stddef.h>
+#include "math.h"
+#include "MagCalibration.h"
+
+#define PI_F					3.14159265f
+#define dMAG_FIT_TERMS			5
+#define dMAG_MAX_SAMPLE_GAP		200		/* [ms] longer gap restarts gyro and heading tracking */
+#define dMAG_HEADING_GAIN		0.01f	/* per sample, reference heading to magnetic heading */
+
+const MagCalibrationParams MagCalibration_Defaults = {
+	.MinSamples = 240,			/* 6 s at 40 Hz, a full turn of the robot */
+	.MinSectors = 6,
+	.MaxAxisRatio = 2.0f,
+	.MaxResidual = 0.05f,
+	.MinRadius = 50.0f,			/* horizontal field in Europe is about 200 mG */
+	.MaxRadius = 1000.0f,
+	.DisturbanceRatio = 0.15f,	/* 5x the noise of the 4 gauss range */
+	.HeadingLimit = 0.15f,		/* 9 deg */
+	.ClearTime = 2000,
+	.InvalidTime = 60000,		/* longer than the robot stays next to steel */
+	.FitWeight = 0.3f,
+};
+
+static MagCalibrationParams Params;
+static MagCalibrationData Data;
+static bool IsValid;
+static bool IsNew;
+static uint8_t FitCount;
+static uint8_t AxisU, AxisV;
+
+/* Fit in progress */
+static float Ref[2];
+static float N[dMAG_FIT_TERMS][dMAG_FIT_TERMS];
+static float R[dMAG_FIT_TERMS];
+static float SumY2;
+static uint16_t Count;
+static uint16_t SectorCount[dMAG_CALIBRATION_SECTORS];
+static float GyroHeading;
+
+/* Disturbance */
+static uint32_t LastTick;
+static bool IsTracking;
+static float Heading;
+static uint32_t DisturbedTick;
+static uint32_t DisturbedSince;
+static bool IsDisturbed;
+static float Calibrated[2];
+
+static float MagCalibration_Wrap(float Angle)
+{
+	while(Angle > PI_F)
+		Angle -= 2.0f * PI_F;
+	while(Angle <= -PI_F)
+		Angle += 2.0f * PI_F;
+	return Angle;
+}
+
+static void MagCalibration_Restart(void)
+{
+	for(uint8_t i = 0; i < dMAG_FIT_TERMS; i++)
+	{
+		for(uint8_t j = 0; j < dMAG_FIT_TERMS; j++)
+			N[i][j] = 0.0f;
+		R[i] = 0.0f;
+	}
+	for(uint8_t i = 0; i < dMAG_CALIBRATION_SECTORS; i++)
+		SectorCount[i] = 0;
+	SumY2 = 0.0f;
+	Count = 0;
+}
+
+static void MagCalibration_SetAxes(uint8_t Axis)
+{
+	AxisU = (uint8_t)((Axis + 1U) % 3U);
+	AxisV = (uint8_t)((Axis + 2U) % 3U);
+}
+
+/* Gaussian elimination with partial pivoting, N and R are destroyed */
+static bool MagCalibration_Solve(float Theta[dMAG_FIT_TERMS])
+{
+	for(uint8_t Col = 0; Col < dMAG_FIT_TERMS; Col++)
+	{
+		uint8_t Pivot = Col;
+
+		for(uint8_t Row = Col + 1; Row < dMAG_FIT_TERMS; Row++)
+			if(fabsf(N[Row][Col]) > fabsf(N[Pivot][Col]))
+				Pivot = Row;
+		if(fabsf(N[Pivot][Col]) < 1e-9f)
+			return false;
+		if(Pivot != Col)
+		{
+			for(uint8_t j = 0; j < dMAG_FIT_TERMS; j++)
+			{
+				float Swap = N[Col][j];
+
+				N[Col][j] = N[Pivot][j];
+				N[Pivot][j] = Swap;
+			}
+			float Swap = R[Col];
+
+			R[Col] = R[Pivot];
+			R[Pivot] = Swap;
+		}
+		for(uint8_t Row = Col + 1; Row < dMAG_FIT_TERMS; Row++)
+		{
+			float Factor = N[Row][Col] / N[Col][Col];
+
+			for(uint8_t j = Col; j < dMAG_FIT_TERMS; j++)
+				N[Row][j] -= Factor * N[Col][j];
+			R[Row] -= Factor * R[Col];
+		}
+	}
+	for(int8_t Row = dMAG_FIT_TERMS - 1; Row >= 0; Row--)
+	{
+		float Sum = R[Row];
+
+		for(uint8_t j = (uint8_t)(Row + 1); j < dMAG_FIT_TERMS; j++)
+			Sum -= N[Row][j] * Theta[j];
+		Theta[Row] = Sum / N[Row][Row];
+	}
+	return true;
+}
+
+/* Conic to Center, Matrix and Radius, false when the fit is not plausible */
+static bool MagCalibration_Fit(MagCalibrationData* Fit)
+{
+	float Theta[dMAG_FIT_TERMS];
+	float Residual = SumY2;
+
+	/* Residual from the sums before they are solved in place: |Z t - y|^2 */
+	float NTheta;
+	float Copy[dMAG_FIT_TERMS][dMAG_FIT_TERMS + 1];
+
+	for(uint8_t i = 0; i < dMAG_FIT_TERMS; i++)
+	{
+		for(uint8_t j = 0; j < dMAG_FIT_TERMS; j++)
+			Copy[i][j] = N[i][j];
+		Copy[i][dMAG_FIT_TERMS] = R[i];
+	}
+	if(!MagCalibration_Solve(Theta))
+		return false;
+	for(uint8_t i = 0; i < dMAG_FIT_TERMS; i++)
+	{
+		NTheta = 0.0f;
+		for(uint8_t j = 0; j < dMAG_FIT_TERMS; j++)
+			NTheta += Copy[i][j] * Theta[j];
+		Residual += Theta[i] * (NTheta - 2.0f * Copy[i][dMAG_FIT_TERMS]);
+	}
+
+	/* x' Q x + L x + F with Q = [A, B/2; B/2, 1 - A] */
+	float Qa = Theta[0], Qb = Theta[1] * 0.5f, Qc = 1.0f - Theta[0];
+	float Det = Qa * Qc - Qb * Qb;
+
+	if(Det <= 0.0f)
+		return false;
+	/* Center: 2 Q x0 = -L */
+	float X0 = -(Qc * Theta[2] - Qb * Theta[3]) / (2.0f * Det);
+	float Y0 = -(Qa * Theta[3] - Qb * Theta[2]) / (2.0f * Det);
+	float G = -(Theta[4] + 0.5f * (Theta[2] * X0 + Theta[3] * Y0));
+
+	if(G <= 0.0f)
+		return false;
+	/* (x - x0)' M (x - x0) = 1 */
+	float Ma = Qa / G, Mb = Qb / G, Mc = Qc / G;
+	float DetM = Ma * Mc - Mb * Mb;
+	float Half = (Ma + Mc) * 0.5f;
+	float Spread = sqrtf(fmaxf(Half * Half - DetM, 0.0f));
+	float Radius = 1.0f / sqrtf(sqrtf(DetM));	/* geometric mean of the semi axes */
+
+	if(Half - Spread <= 0.0f || (Half + Spread) > Params.MaxAxisRatio * Params.MaxAxisRatio * (Half - Spread))
+		return false;
+	/* Conic value at a radius error share e is about 2 G e */
+	if(sqrtf(fmaxf(Residual, 0.0f) / (float)Count) > Params.MaxResidual * 2.0f * G)
+		return false;
+	Radius *= 1000.0f;
+	if(Radius < Params.MinRadius || Radius > Params.MaxRadius)
+		return false;
+
+	/* Matrix = sqrt(M) * Radius maps the ellipse onto the circle */
+	float S = sqrtf(DetM);
+	float T = sqrtf(Ma + Mc + 2.0f * S);
+	float Scale = Radius / 1000.0f / T;
+
+	Fit->VerticalAxis = Data.VerticalAxis;
+	Fit->Reserved[0] = Fit->Reserved[1] = Fit->Reserved[2] = 0;
+	Fit->Center[0] = Ref[0] + X0 * 1000.0f;
+	Fit->Center[1] = Ref[1] + Y0 * 1000.0f;
+	Fit->Matrix[0][0] = (Ma + S) * Scale;
+	Fit->Matrix[0][1] = Mb * Scale;
+	Fit->Matrix[1][0] = Mb * Scale;
+	Fit->Matrix[1][1] = (Mc + S) * Scale;
+	Fit->Radius = Radius;
+	return true;
+}
+
+static void MagCalibration_Collect(float U, float V, float Yaw)
+{
+	uint8_t Sector = (uint8_t)((Yaw + PI_F) * (dMAG_CALIBRATION_SECTORS / (2.0f * PI_F))) % dMAG_CALIBRATION_SECTORS;
+	uint16_t Limit = Params.MinSamples / Params.MinSectors;
+	uint8_t Covered = 0;
+
+	/* Equal weight of the headings, a long straight run does not swamp the turns */
+	if(SectorCount[Sector] >= Limit)
+		return;
+	if(Count == 0)
+	{
+		Ref[0] = IsValid ? Data.Center[0] : U;
+		Ref[1] = IsValid ? Data.Center[1] : V;
+	}
+	U = (U - Ref[0]) / 1000.0f;
+	V = (V - Ref[1]) / 1000.0f;
+
+	float Z[dMAG_FIT_TERMS] = { U * U - V * V, U * V, U, V, 1.0f };
+	float Y = -V * V;
+
+	for(uint8_t i = 0; i < dMAG_FIT_TERMS; i++)
+	{
+		for(uint8_t j = i; j < dMAG_FIT_TERMS; j++)
+			N[i][j] += Z[i] * Z[j];
+		R[i] += Z[i] * Y;
+	}
+	SumY2 += Y * Y;
+	SectorCount[Sector]++;
+	Count++;
+
+	for(uint8_t i = 0; i < dMAG_CALIBRATION_SECTORS; i++)
+		if(SectorCount[i] >= dMAG_CALIBRATION_SECTOR_MIN)
+			Covered++;
+	if(Count < Params.MinSamples || Covered < Params.MinSectors)
+		return;
+
+	MagCalibrationData Fit;
+
+	for(uint8_t i = 1; i < dMAG_FIT_TERMS; i++)
+		for(uint8_t j = 0; j < i; j++)
+			N[i][j] = N[j][i];
+	if(MagCalibration_Fit(&Fit))
+	{
+		if(IsValid)
+		{
+			/* Noise of one fit is averaged out over a few, a real change still gets through */
+			Data.Center[0] += Params.FitWeight * (Fit.Center[0] - Data.Center[0]);
+			Data.Center[1] += Params.FitWeight * (Fit.Center[1] - Data.Center[1]);
+			for(uint8_t i = 0; i < 2; i++)
+				for(uint8_t j = 0; j < 2; j++)
+					Data.Matrix[i][j] += Params.FitWeight * (Fit.Matrix[i][j] - Data.Matrix[i][j]);
+			Data.Radius += Params.FitWeight * (Fit.Radius - Data.Radius);
+		}
+		else
+			Data = Fit;
+		IsValid = true;
+		IsNew = true;
+		IsTracking = false;
+		FitCount++;
+	}
+	MagCalibration_Restart();
+}
+
+void MagCalibration_Init(const MagCalibrationParams* NewParams, const MagCalibrationData* Stored)
+{
+	Params = *NewParams;
+	IsValid = false;
+	IsNew = false;
+	IsTracking = false;
+	IsDisturbed = false;
+	FitCount = 0;
+	GyroHeading = 0.0f;
+	Data.VerticalAxis = dMAG_CALIBRATION_NO_AXIS;
+	if(Stored != NULL && Stored->VerticalAxis < 3U &&
+	   Stored->Radius >= Params.MinRadius && Stored->Radius <= Params.MaxRadius)
+	{
+		Data = *Stored;
+		IsValid = true;
+		MagCalibration_SetAxes(Data.VerticalAxis);
+	}
+	MagCalibration_Restart();
+}
+
+void MagCalibration_SetVerticalAxis(uint8_t Axis)
+{
+	if(Axis >= 3U || Axis == Data.VerticalAxis)
+		return;
+	/* Sensor mounted differently than when calibrated */
+	Data.VerticalAxis = Axis;
+	MagCalibration_SetAxes(Axis);
+	IsValid = false;
+	IsTracking = false;
+	MagCalibration_Restart();
+}
+
+void MagCalibration_AddSample(const float Field[3], const float Gyro[3], uint32_t Tick)
+{
+	float Dt = (float)(Tick - LastTick) / 1000.0f;
+	bool IsGap = !IsTracking || (Tick - LastTick) > dMAG_MAX_SAMPLE_GAP;
+	bool IsSampleDisturbed = false;
+
+	if(Data.VerticalAxis >= 3U)
+		return;
+	LastTick = Tick;
+	if(!IsGap)
+		GyroHeading = MagCalibration_Wrap(GyroHeading + Gyro[Data.VerticalAxis] * Dt);
+
+	if(IsValid)
+	{
+		float U = Field[AxisU] - Data.Center[0];
+		float V = Field[AxisV] - Data.Center[1];
+		float Magnitude;
+		float MagHeading;
+
+		Calibrated[0] = Data.Matrix[0][0] * U + Data.Matrix[0][1] * V;
+		Calibrated[1] = Data.Matrix[1][0] * U + Data.Matrix[1][1] * V;
+		Magnitude = sqrtf(Calibrated[0] * Calibrated[0] + Calibrated[1] * Calibrated[1]);
+		MagHeading = atan2f(Calibrated[1], Calibrated[0]);
+
+		if(fabsf(Magnitude - Data.Radius) > Params.DisturbanceRatio * Data.Radius)
+			IsSampleDisturbed = true;
+		if(IsGap)
+			Heading = MagHeading;
+		else
+		{
+			/* Field turns against the sensor: heading falls with a positive rate */
+			Heading = MagCalibration_Wrap(Heading - Gyro[Data.VerticalAxis] * Dt);
+			float Error = MagCalibration_Wrap(MagHeading - Heading);
+
+			if(fabsf(Error) > Params.HeadingLimit)
+				IsSampleDisturbed = true;
+			Heading = MagCalibration_Wrap(Heading + dMAG_HEADING_GAIN * Error);
+		}
+	}
+	IsTracking = true;
+
+	if(IsSampleDisturbed)
+	{
+		if(!IsDisturbed)
+			DisturbedSince = Tick;
+		IsDisturbed = true;
+		DisturbedTick = Tick;
+		/* Disturbed everywhere: the calibration no longer fits the robot */
+		if((Tick - DisturbedSince) >= Params.InvalidTime)
+		{
+			IsValid = false;
+			IsDisturbed = false;
+			MagCalibration_Restart();
+		}
+	}
+	else if(IsDisturbed && (Tick - DisturbedTick) >= Params.ClearTime)
+		IsDisturbed = false;
+
+	if(!IsValid || !IsDisturbed)
+		MagCalibration_Collect(Field[AxisU], Field[AxisV], GyroHeading);
+}
+
+bool MagCalibration_GetField(float Field[3])
+{
+	if(!IsValid || IsDisturbed || !IsTracking)
+		return false;
+	Field[Data.VerticalAxis] = 0.0f;
+	Field[AxisU] = Calibrated[0];
+	Field[AxisV] = Calibrated[1];
+	return true;
+}
+
+bool MagCalibration_IsValid(void)
+{
+	return IsValid;
+}
+
+bool MagCalibration_IsDisturbed(void)
+{
+	return IsDisturbed;
+}
+
+bool MagCalibration_TakeNew(MagCalibrationData* NewData)
+{
+	if(!IsNew)
+		return false;
+	IsNew = false;
+	*NewData = Data;
+	return true;
+}
+
+uint8_t MagCalibration_GetFitCount(void)
+{
+	return FitCount;
+}
+
+uint8_t MagCalibration_GetCoverage(void)
+{
+	uint8_t Covered = 0;
+
+	for(uint8_t i = 0; i < dMAG_CALIBRATION_SECTORS; i++)
+		if(SectorCount[i] >= dMAG_CALIBRATION_SECTOR_MIN)
+			Covered++;
+	return Covered;
+}
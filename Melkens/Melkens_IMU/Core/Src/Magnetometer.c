@@ -0,0 +1,231 @@
+/*
+ * Magnetometer.c
+ *
+ * LIS3MDL acquisition and calibration store, see Magnetometer.h.
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include "math.h"
+#include "main.h"
+#include "IMU_func.h"
+#include "lis3mdl_reg.h"
+#include "Magnetometer.h"
+#include "MagCalibration.h"
+#include "FlashPage.h"
+#include "TimeManager.h"
+#include "CRC16.h"
+
+#define dMAGNETOMETER_READ_LENGTH		7		/* STATUS_REG, OUT_X_L .. OUT_Z_H */
+#define dMAGNETOMETER_AUTO_INCREMENT	0x80	/* sub address MSB, multiple byte read */
+#define dMAGNETOMETER_ZYXDA				0x08	/* STATUS_REG, new X, Y and Z data */
+#define dMAGNETOMETER_RESET_TRIES		10
+#define dMAGNETOMETER_STORE_CHANGE		0.02f	/* share of Radius, smaller changes are not written */
+
+#define dMAG_READ_IDLE		0
+#define dMAG_READ_BUSY		1
+#define dMAG_READ_DONE		2
+#define dMAG_READ_ERROR		3
+
+/* 40 bytes, whole double words of flash programming */
+typedef struct MagnetometerStore_t{
+	uint32_t Magic;
+	uint16_t Version;
+	uint16_t Crc;				/* CRC16 of Data */
+	MagCalibrationData Data;
+}MagnetometerStore;
+
+extern I2C_HandleTypeDef hi2c4;
+
+static stmdev_lis_ctx_t MagCtx;
+static bool IsPresent;
+static volatile uint8_t ReadState;
+static uint8_t ReadBuffer[dMAGNETOMETER_READ_LENGTH];
+static uint32_t ReadTick;
+static uint32_t SampleTick;
+static bool IsSample;
+static uint16_t ErrorCount;
+static MagCalibrationData Pending;
+static bool IsSavePending;
+
+static const MagnetometerStore* Magnetometer_Stored(void)
+{
+	const MagnetometerStore* Store = (const MagnetometerStore*)dMAGNETOMETER_STORE_ADDRESS;
+
+	/* Dual bank: the page is not mapped */
+	if(!FlashPage_IsSingleBank())
+		return NULL;
+	if(Store->Magic != dMAGNETOMETER_STORE_MAGIC || Store->Version != dMAGNETOMETER_STORE_VERSION)
+		return NULL;
+	if(Store->Crc != CRC16((const uint8_t*)&Store->Data, sizeof(Store->Data)))
+		return NULL;
+	return Store;
+}
+
+/* Flash wears, a new fit is written only when it moves the calibration */
+static bool Magnetometer_IsStoreNeeded(const MagCalibrationData* Data)
+{
+	const MagnetometerStore* Store = Magnetometer_Stored();
+	float Limit = dMAGNETOMETER_STORE_CHANGE * Data->Radius;
+
+	if(Store == NULL || Store->Data.VerticalAxis != Data->VerticalAxis)
+		return true;
+	if(fabsf(Store->Data.Center[0] - Data->Center[0]) > Limit || fabsf(Store->Data.Center[1] - Data->Center[1]) > Limit)
+		return true;
+	if(fabsf(Store->Data.Radius - Data->Radius) > Limit)
+		return true;
+	for(uint8_t i = 0; i < 2; i++)
+		for(uint8_t j = 0; j < 2; j++)
+			if(fabsf(Store->Data.Matrix[i][j] - Data->Matrix[i][j]) > dMAGNETOMETER_STORE_CHANGE)
+				return true;
+	return false;
+}
+
+static bool Magnetometer_Save(const MagCalibrationData* Data)
+{
+	MagnetometerStore Store;
+
+	Store.Magic = dMAGNETOMETER_STORE_MAGIC;
+	Store.Version = dMAGNETOMETER_STORE_VERSION;
+	Store.Data = *Data;
+	Store.Crc = CRC16((const uint8_t*)&Store.Data, sizeof(Store.Data));
+
+	return FlashPage_Erase(dMAGNETOMETER_STORE_ADDRESS) &&
+		   FlashPage_Program(dMAGNETOMETER_STORE_ADDRESS, (const uint8_t*)&Store, sizeof(Store));
+}
+
+bool Magnetometer_Init(void)
+{
+	const MagnetometerStore* Store = Magnetometer_Stored();
+	uint8_t Id = 0;
+	uint8_t Reset = 1;
+
+	MagCalibration_Init(&MagCalibration_Defaults, (Store != NULL) ? &Store->Data : NULL);
+
+	MagCtx.handle = &hi2c4;
+	MagCtx.write_reg = platform_write_lis3mdl;
+	MagCtx.read_reg = platform_read_lis3mdl;
+
+	HAL_Delay(BOOT_TIME);
+	/* Not fitted or not answering: AHRS runs without it */
+	lis3mdl_device_id_get(&MagCtx, &Id);
+	if(Id != LIS3MDL_ID)
+		return false;
+
+	lis3mdl_reset_set(&MagCtx, PROPERTY_ENABLE);
+	for(uint8_t i = 0; i < dMAGNETOMETER_RESET_TRIES && Reset; i++)
+		lis3mdl_reset_get(&MagCtx, &Reset);
+
+	lis3mdl_block_data_update_set(&MagCtx, PROPERTY_ENABLE);
+	lis3mdl_data_rate_set(&MagCtx, LIS3MDL_HP_40Hz);
+	lis3mdl_full_scale_set(&MagCtx, LIS3MDL_4_GAUSS);
+	lis3mdl_temperature_meas_set(&MagCtx, PROPERTY_ENABLE);
+	lis3mdl_operating_mode_set(&MagCtx, LIS3MDL_CONTINUOUS_MODE);
+
+	ReadState = dMAG_READ_IDLE;
+	IsPresent = true;
+	return true;
+}
+
+void Magnetometer_Perform(const float Gyro[3])
+{
+	uint32_t Tick = TimeManager_GetSystemTick();
+	float Field[3];
+
+	if(!IsPresent)
+		return;
+
+	if(ReadState == dMAG_READ_DONE)
+	{
+		if(ReadBuffer[0] & dMAGNETOMETER_ZYXDA)
+		{
+			for(uint8_t i = 0; i < 3; i++)
+				Field[i] = 1000.0f * lis3mdl_from_fs4_to_gauss((int16_t)(ReadBuffer[1 + 2 * i] | (ReadBuffer[2 + 2 * i] << 8)));
+			MagCalibration_AddSample(Field, Gyro, ReadTick);
+			SampleTick = ReadTick;
+			IsSample = true;
+		}
+		ReadState = dMAG_READ_IDLE;
+	}
+	else if(ReadState == dMAG_READ_ERROR)
+	{
+		ErrorCount++;
+		ReadState = dMAG_READ_IDLE;
+	}
+	else if(ReadState == dMAG_READ_BUSY && (Tick - ReadTick) > dMAGNETOMETER_TIMEOUT)
+	{
+		/* Stuck bus, next read waits until the abort is done */
+		HAL_I2C_Master_Abort_IT(&hi2c4, LIS3MDL_I2C_ADD_H);
+		ErrorCount++;
+		ReadState = dMAG_READ_IDLE;
+	}
+
+	if(ReadState == dMAG_READ_IDLE && (Tick - ReadTick) >= dMAGNETOMETER_PERIOD)
+	{
+		ReadTick = Tick;
+		ReadState = dMAG_READ_BUSY;
+		if(HAL_I2C_Mem_Read_IT(&hi2c4, LIS3MDL_I2C_ADD_H, LIS3MDL_STATUS_REG | dMAGNETOMETER_AUTO_INCREMENT,
+							   I2C_MEMADD_SIZE_8BIT, ReadBuffer, dMAGNETOMETER_READ_LENGTH) != HAL_OK)
+		{
+			ErrorCount++;
+			ReadState = dMAG_READ_IDLE;
+		}
+	}
+
+	if(MagCalibration_TakeNew(&Pending))
+		IsSavePending = true;
+	if(IsSavePending && !IMU_IsFlashLocked())
+	{
+		IsSavePending = false;
+		if(Magnetometer_IsStoreNeeded(&Pending) && !Magnetometer_Save(&Pending))
+			ErrorCount++;
+	}
+}
+
+void Magnetometer_SetGravity(float X, float Y, float Z)
+{
+	uint8_t Axis = 0;
+
+	if(fabsf(Y) > fabsf(X) && fabsf(Y) > fabsf(Z))
+		Axis = 1;
+	else if(fabsf(Z) > fabsf(X))
+		Axis = 2;
+	MagCalibration_SetVerticalAxis(Axis);
+}
+
+bool Magnetometer_GetField(float* X, float* Y, float* Z)
+{
+	float Field[3];
+
+	if(!IsSample || (TimeManager_GetSystemTick() - SampleTick) > dMAGNETOMETER_STALE_TIME)
+		return false;
+	if(!MagCalibration_GetField(Field))
+		return false;
+	*X = Field[0];
+	*Y = Field[1];
+	*Z = Field[2];
+	return true;
+}
+
+bool Magnetometer_IsCalibrated(void)
+{
+	return MagCalibration_IsValid();
+}
+
+uint16_t Magnetometer_GetErrorCount(void)
+{
+	return ErrorCount;
+}
+
+/* Only I2C4 runs in interrupt mode */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	if(hi2c == &hi2c4)
+		ReadState = dMAG_READ_DONE;
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	if(hi2c == &hi2c4 && ReadState == dMAG_READ_BUSY)
+		ReadState = dMAG_READ_ERROR;
+}
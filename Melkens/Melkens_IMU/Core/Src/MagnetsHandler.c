@@ -135,7 +135,7 @@ void MagnetsHandler_Perform1ms(void){
 		CounterToMagnetsError++;
 		if( CounterToMagnetsError == 50 ){
 		/* 10s since last message from magnets bar */
-			MagnetStatus.status = 0xA5A5A5A5;
+			MagnetStatus.status = dMAGNET_STATUS_ERROR;
 			CounterToMagnetsError = 0;
 		}
 	}
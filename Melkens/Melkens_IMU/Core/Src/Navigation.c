@@ -13,26 +13,24 @@
 #include "main.h"
 #include "MagnetsHandler.h"
 #include "ConnectivityHandler.h"
+#include "VelocityPlanner.h"
+#include "PoseFilter.h"
+#include "Scope.h"
 
 float Robot_X, Robot_Y;
 float Robot_Angle;
 
-#define ROUTE_POINTS_DISTANCE 10 // each step is divided into smaller sections with distance in between of 10 cm for example
-
-uint8_t pursuitPointIncrement = 5; //robot will pursuit a point that is located ahead for example 5 points
+uint8_t pursuitPointIncrement = dVELOCITY_PLANNER_FIXED_LOOKAHEAD; //robot will pursuit a point that is located ahead, grows with planned speed
 uint16_t closestPoint = 0; //route point that is the closest
 uint16_t pursuitPoint = 0;// index of a point that robot will pursuit
 
 uint16_t routePointsAmount;
-#define ROUTE_POINTS_MAX_AMOUNT 10000
-Point RoutePoints[ROUTE_POINTS_MAX_AMOUNT];
-
 uint16_t magnetPointsAmount;
-#define MAGNET_POINTS_MAX_AMOUNT 500
-Point MagnetPoints[MAGNET_POINTS_MAX_AMOUNT];
 
 int last_enco_left_val = 0;
 int last_enco_right_val = 0;
+float last_robot_angle = 0;
+uint32_t last_magnet_status = 0;
 
 int left_wheel_distance = 0;
 int right_wheel_distance = 0;
@@ -40,12 +38,17 @@ int right_wheel_distance = 0;
 float X_POSITION_ENCO = 0;
 float Y_POSITION_ENCO = 0;
 
+/* Cost of the pose filter [cycles], DWT cycle counter, last call and the largest since start */
+static uint32_t PosePredictCycles, PosePredictCyclesMax;
+static uint32_t PoseFixCycles, PoseFixCyclesMax;
+
 float moover_velocity = 0;
 
 bool isRouteFinished;
 
 float angleToPoint;
 float DeltaAngle;
+float CrossTrackError; //[cm] robot to route segment at the closest point, positive left of driving direction
 
 RouteData CurrentRoute;
 
@@ -61,8 +64,18 @@ magnetPointsAmount = 0;
 
 last_enco_left_val = getLeftEncoder();
 last_enco_right_val = getRightEncoder();
-
-
+last_robot_angle = getRobotAngle();
+
+Scope_Register("nav.x", &Robot_X, dSCOPE_TYPE_FLOAT);
+Scope_Register("nav.y", &Robot_Y, dSCOPE_TYPE_FLOAT);
+Scope_Register("nav.angle", &Robot_Angle, dSCOPE_TYPE_FLOAT);
+Scope_Register("nav.xte", &CrossTrackError, dSCOPE_TYPE_FLOAT);
+Scope_Register("nav.steer", &DeltaAngle, dSCOPE_TYPE_FLOAT);
+Scope_Register("nav.closest", &closestPoint, dSCOPE_TYPE_UINT16);
+Scope_Register("pose.predict.cycles", &PosePredictCycles, dSCOPE_TYPE_UINT32);
+Scope_Register("pose.predict.max", &PosePredictCyclesMax, dSCOPE_TYPE_UINT32);
+Scope_Register("pose.fix.cycles", &PoseFixCycles, dSCOPE_TYPE_UINT32);
+Scope_Register("pose.fix.max", &PoseFixCyclesMax, dSCOPE_TYPE_UINT32);
 }
 
 void loadRoute(Route_ID RouteSelected)
@@ -74,91 +87,77 @@ void loadRoute(Route_ID RouteSelected)
 	Robot_X = 0;
 	Robot_Y = 0;
 	closestPoint = 0;
-	routePointsAmount = 0;
 
 	isRouteFinished = false;
 
+	/* Magnet and pursuit points are precomputed in route tables */
 	magnetPointsAmount = CurrentRoute.StepCount+1;
-	int x = 0;
-	int y = 0;
-
-	MagnetPoints[0].X = x;
-	MagnetPoints[0].Y = y;
-	MagnetPoints[0].stepNumber = 0;
+	routePointsAmount = CurrentRoute.PointCount;
+	VelocityPlanner_Plan(&CurrentRoute);
 
-	for(int i = 0; i<CurrentRoute.StepCount; i++)//fill all the magnet points
-	{
-		x += CurrentRoute.Step[i].dX;
-		y += CurrentRoute.Step[i].dY;
+	Robot_Angle = 3.1415;
+	PoseFilter_Reset(Robot_X, Robot_Y, Robot_Angle);
+}
 
-		MagnetPoints[i+1].X = x;
-		MagnetPoints[i+1].Y = y;
-		MagnetPoints[i+1].stepNumber = i;
+/* Signed distance to the line through the route segment at the closest point,
+ * distance to the point itself on a route of one point */
+static void updateCrossTrackError(float distanceToClosest)
+{
+	uint16_t from = (closestPoint + 1 < routePointsAmount) ? closestPoint : closestPoint - 1;
+	float segmentX, segmentY, segmentLength;
 
+	if(routePointsAmount < 2)
+	{
+		CrossTrackError = distanceToClosest;
+		return;
 	}
-
-	int dx, dy;
-	float stepDistance;
-	int amountOfIntermediateSteps;
-	int intermediateStepX, intermediateStepY;
-	for(int i = 0; i<CurrentRoute.StepCount; i++)//fill all the Intermediate points
+	segmentX = CurrentRoute.Point[from + 1].X - CurrentRoute.Point[from].X;
+	segmentY = CurrentRoute.Point[from + 1].Y - CurrentRoute.Point[from].Y;
+	segmentLength = sqrtf(segmentX*segmentX + segmentY*segmentY);
+	if(segmentLength <= 0.0f)
 	{
-		dx = MagnetPoints[i].X - MagnetPoints[i+1].X;
-		dy = MagnetPoints[i].Y - MagnetPoints[i+1].Y;
-		stepDistance = sqrt(dx*dx+dy*dy);
-		amountOfIntermediateSteps = (int)(stepDistance / ROUTE_POINTS_DISTANCE);
-
-		for(int a = 0; a<amountOfIntermediateSteps; a++)
-		{
-			intermediateStepX = MagnetPoints[i].X - (dx/amountOfIntermediateSteps) * a;
-			intermediateStepY = MagnetPoints[i].Y - (dy/amountOfIntermediateSteps) * a;
-
-			RoutePoints[routePointsAmount].X = intermediateStepX;
-			RoutePoints[routePointsAmount].Y = intermediateStepY;
-			RoutePoints[routePointsAmount].stepNumber = i;
-			routePointsAmount++;
-		}
-
+		CrossTrackError = distanceToClosest;
+		return;
 	}
-
-	RoutePoints[routePointsAmount].X = MagnetPoints[magnetPointsAmount-1].X;
-	RoutePoints[routePointsAmount].Y = MagnetPoints[magnetPointsAmount-1].Y;
-	RoutePoints[routePointsAmount].stepNumber = MagnetPoints[magnetPointsAmount-1].stepNumber;;
-	routePointsAmount++;
-
-	Robot_Angle = 3.1415;
+	CrossTrackError = (segmentX*(Robot_Y - CurrentRoute.Point[from].Y) - segmentY*(Robot_X - CurrentRoute.Point[from].X)) / segmentLength;
 }
 
 void navigationPerform1ms(void)
 {
 	updatePosition();
 
-	//if magnet was found
-	if(MagnetsHandler_GetSatus() != 0)
+	//if magnet was found, first status of a magnet pass is a position fix
+	uint32_t magnetStatus = MagnetsHandler_GetSatus();
+	if(magnetStatus != 0 && last_magnet_status == 0 && magnetStatus != dMAGNET_STATUS_ERROR)
 	{
-		Point detectionPoint = calculatePoint(Robot_Angle, Robot_X, Robot_Y, MagnetsHandler_GetAvreageDistance(), dMAGNET_BAR_OFFSET_DISTANCE);
-		uint16_t closestMagnet = findNearestMagnet(detectionPoint);
-
-		int dx = detectionPoint.X - MagnetPoints[closestMagnet].X;
-		int dy = detectionPoint.Y - MagnetPoints[closestMagnet].Y;
-
-		//Robot_X += dx;
-		//Robot_Y += dy;//TODO: sprawdzić czy to jest ok
-
+		uint16_t step = CurrentRoute.Point[closestPoint].StepNumber;
+		uint16_t firstMagnet = (step > 0) ? step - 1 : 0;
+		uint32_t start = DWT->CYCCNT;
+
+		PoseFilter_MagnetFix(&CurrentRoute, firstMagnet, firstMagnet + dPOSE_FILTER_MAGNET_WINDOW - 1,
+							 MagnetsHandler_GetAvreageDistance(), dMAGNET_BAR_OFFSET_DISTANCE);
+		PoseFixCycles = DWT->CYCCNT - start;
+		if(PoseFixCycles > PoseFixCyclesMax)
+			PoseFixCyclesMax = PoseFixCycles;
+		Robot_X = PoseFilter_GetX();
+		Robot_Y = PoseFilter_GetY();
+		Robot_Angle = PoseFilter_GetAngle();
 	}
-
-	Robot_Angle = angleWrap(getRobotAngle()-RouteStartAngle);
+	last_magnet_status = magnetStatus;
 
 	int dx, dy;
 	float lastDistanceToPoint;
 	float distanceToPoint;
-	uint8_t searchRange; // closest point search range
+	uint16_t searchRange; // closest point search range
 
-	dx = RoutePoints[0].X - Robot_X;
-	dy = RoutePoints[0].Y - Robot_Y;
+	dx = CurrentRoute.Point[0].X - Robot_X;
+	dy = CurrentRoute.Point[0].Y - Robot_Y;
 
 	lastDistanceToPoint = sqrt(dx*dx+dy*dy);
 
+	/* Lookahead follows the speed planned at the closest point */
+	pursuitPointIncrement = VelocityPlanner_GetLookahead(VelocityPlanner_GetSpeed(&CurrentRoute, closestPoint));
+
 	if(closestPoint+pursuitPointIncrement > routePointsAmount)
 		searchRange = routePointsAmount;
 	else
@@ -166,8 +165,8 @@ void navigationPerform1ms(void)
 
 	for(int i = closestPoint; i<searchRange; i++)
 	{
-		dx = RoutePoints[i].X - Robot_X;
-		dy = RoutePoints[i].Y - Robot_Y;
+		dx = CurrentRoute.Point[i].X - Robot_X;
+		dy = CurrentRoute.Point[i].Y - Robot_Y;
 
 		distanceToPoint = sqrt(dx*dx+dy*dy);
 
@@ -178,6 +177,8 @@ void navigationPerform1ms(void)
 		}
 	}
 
+	updateCrossTrackError(lastDistanceToPoint);
+
 	if(closestPoint < routePointsAmount - pursuitPointIncrement - 1)
 		pursuitPoint = closestPoint + pursuitPointIncrement;
 	else
@@ -188,10 +189,10 @@ void navigationPerform1ms(void)
 //	float angleToPoint;
 //	float DeltaAngle;
 
-	int speed = CurrentRoute.Step[RoutePoints[closestPoint].stepNumber].Speed;
+	int speed = VelocityPlanner_GetSpeed(&CurrentRoute, closestPoint);
 
-	dx = RoutePoints[pursuitPoint].X - Robot_X;
-	dy = RoutePoints[pursuitPoint].Y - Robot_Y;
+	dx = CurrentRoute.Point[pursuitPoint].X - Robot_X;
+	dy = CurrentRoute.Point[pursuitPoint].Y - Robot_Y;
 
 	angleToPoint = atan2(dx, dy) - 3.1415/2;
 
@@ -207,6 +208,8 @@ void navigationPerform1ms(void)
 	if(DeltaAngle<-3.1415/8)
 		DeltaAngle = -3.1415/8;
 
+	speed = VelocityPlanner_LimitSteering(speed, DeltaAngle/(3.1415/8));
+
 	if(speed>0)
 	{
 		setRightWheelSpeed(speed-((DeltaAngle/(3.1415/8))*speed));
@@ -219,7 +222,7 @@ void navigationPerform1ms(void)
 	}
 
 
-	setThumbleSpeed(CurrentRoute.Step[RoutePoints[closestPoint].stepNumber].ThumbleSpeed);//set thumble speed
+	setThumbleSpeed(CurrentRoute.Step[CurrentRoute.Point[closestPoint].StepNumber].ThumbleSpeed);//set thumble speed
 
 	if(closestPoint == routePointsAmount-1)//finish route
 	{
@@ -257,15 +260,15 @@ uint16_t findNearestMagnet(Point point)
 	float distanceToMagnet;
 	uint16_t closestMagnet;
 
-	dx = MagnetPoints[0].X - Robot_X;
-	dy = MagnetPoints[0].Y - Robot_Y;
+	dx = CurrentRoute.Magnet[0].X - Robot_X;
+	dy = CurrentRoute.Magnet[0].Y - Robot_Y;
 
 	closestDistanceToMagnet = sqrt(dx*dx+dy*dy);
 
 	for(int i = 0; i<magnetPointsAmount; i++)
 	{
-		dx = MagnetPoints[i].X - Robot_X;
-		dy = MagnetPoints[i].Y - Robot_Y;
+		dx = CurrentRoute.Magnet[i].X - Robot_X;
+		dy = CurrentRoute.Magnet[i].Y - Robot_Y;
 
 		distanceToMagnet = sqrt(dx*dx+dy*dy);
 
@@ -298,6 +301,24 @@ void updatePosition()
 	last_enco_left_val = getLeftEncoder();
 	last_enco_right_val = getRightEncoder();
 
+	/* Not angleWrap, its float rounding near pi loses increments of a slow drift */
+	float yaw_increment = getRobotAngle() - last_robot_angle;
+	if(yaw_increment > dROUTE_PI)
+		yaw_increment -= 2.0f * dROUTE_PI;
+	else if(yaw_increment < -dROUTE_PI)
+		yaw_increment += 2.0f * dROUTE_PI;
+	last_robot_angle = getRobotAngle();
+
+	/* Scale of counts and AHRS drift are estimated by the filter */
+	uint32_t start = DWT->CYCCNT;
+	PoseFilter_Predict((increment_L - increment_R) * 0.5f, yaw_increment, 0.001f);
+	PosePredictCycles = DWT->CYCCNT - start;
+	if(PosePredictCycles > PosePredictCyclesMax)
+		PosePredictCyclesMax = PosePredictCycles;
+	Robot_X = PoseFilter_GetX();
+	Robot_Y = PoseFilter_GetY();
+	Robot_Angle = PoseFilter_GetAngle();
+
 	moover_velocity = -(increment_R-increment_L) * 0.5 * 0.00018996; //pomnożyć przez jakąć stałą żeby się dystans zgadzał
 	//moover_velocity = (getLeftWheelSpeed()+getRightWheelSpeed())*0.5*0.00001;//pomnożyć przez jakąć stałą żeby się dystans zgadzał
 
@@ -307,14 +328,8 @@ void updatePosition()
 	int wheel_distane_diff = left_wheel_distance - right_wheel_distance;
 	float moover_angle_encoders = 3.1415 / 227 * wheel_distane_diff;
 
-	float velocity_x = moover_velocity * cos(getRobotAngle()-RouteStartAngle);
-	float velocity_y = moover_velocity * sin(getRobotAngle()-RouteStartAngle);
-
-	Robot_X -= velocity_x;
-	Robot_Y += velocity_y;
-
-	velocity_x = moover_velocity * cos(moover_angle_encoders);
-	velocity_y = moover_velocity * sin(moover_angle_encoders);
+	float velocity_x = moover_velocity * cos(moover_angle_encoders);
+	float velocity_y = moover_velocity * sin(moover_angle_encoders);
 
 	X_POSITION_ENCO += velocity_x;
 	Y_POSITION_ENCO += velocity_y;
@@ -346,7 +361,7 @@ bool isRouteFinnished(void)
 
 uint16_t getCurrentStep(void)
 {
-	return RoutePoints[closestPoint].stepNumber;
+	return CurrentRoute.Point[closestPoint].StepNumber;
 }
 uint8_t getRouteProgressPercentage(void)
 {
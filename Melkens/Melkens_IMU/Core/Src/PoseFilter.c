@@ -0,0 +1,284 @@
+/*
+ * PoseFilter.c
+ *
+ * EKF of robot pose, odometry scale and AHRS drift, see PoseFilter.h.
+ * Motion as in updatePosition: X -= d cos(Angle), Y += d sin(Angle) with
+ * d = Counts * CmPerCount * Scale, Angle += YawIncrement - Bias * Dt.
+ * Magnet position from the pose as in calculatePoint:
+ *   Mx = X + sin(Angle) * BarPosition + cos(Angle) * BarOffset
+ *   My = Y + cos(Angle) * BarPosition - sin(Angle) * BarOffset
+ */
+
+#include "math.h"
+#include "PoseFilter.h"
+
+enum { StateX = 0, StateY, StateAngle, StateScale, StateBias };
+
+const PoseFilterParams PoseFilter_Defaults = {
+	.CmPerCount = 0.00018996f,	/* updatePosition before the filter */
+	.DistanceNoise = 0.01f,
+	.SlipNoise = 0.005f,
+	.YawNoise = 0.0005f,
+	.ScaleWalk = 0.0001f,
+	.BiasWalk = 0.00002f,
+	.MagnetNoise = 1.5f,		/* bar pitch 2.5 cm, 1 cm of travel between status samples */
+	.Gate = 13.8f,				/* 99.9 % of true fixes pass */
+	.ScaleDeviation = 0.05f,
+	.BiasDeviation = 0.0005f,	/* 2 deg/min */
+	.LostDeviation = 30.0f,		/* still well within half of the magnet distance */
+	.LostAngleDeviation = 0.05f,
+};
+
+static PoseFilterParams Params;
+static float State[dPOSE_FILTER_STATES];
+static float P[dPOSE_FILTER_STATES][dPOSE_FILTER_STATES];
+static uint16_t FixCount;
+static uint16_t RejectCount;
+static uint8_t RejectsInRow;
+
+static float PoseFilter_Wrap(float Angle)
+{
+	while(Angle > dROUTE_PI)
+		Angle -= 2.0f * dROUTE_PI;
+	while(Angle <= -dROUTE_PI)
+		Angle += 2.0f * dROUTE_PI;
+	return Angle;
+}
+
+static void PoseFilter_Symmetrize(void)
+{
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+		for(uint8_t j = i + 1; j < dPOSE_FILTER_STATES; j++)
+		{
+			float Mean = (P[i][j] + P[j][i]) * 0.5f;
+
+			P[i][j] = Mean;
+			P[j][i] = Mean;
+		}
+}
+
+void PoseFilter_Init(const PoseFilterParams* NewParams)
+{
+	Params = *NewParams;
+	State[StateScale] = 1.0f;
+	State[StateBias] = 0.0f;
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+		for(uint8_t j = 0; j < dPOSE_FILTER_STATES; j++)
+			P[i][j] = 0.0f;
+	P[StateScale][StateScale] = Params.ScaleDeviation * Params.ScaleDeviation;
+	P[StateBias][StateBias] = Params.BiasDeviation * Params.BiasDeviation;
+	PoseFilter_Reset(0.0f, 0.0f, dROUTE_PI);
+}
+
+void PoseFilter_Reset(float X, float Y, float Angle)
+{
+	State[StateX] = X;
+	State[StateY] = Y;
+	State[StateAngle] = PoseFilter_Wrap(Angle);
+	/* Pose is known exactly, learned Scale and Bias stay with their covariance */
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+		for(uint8_t j = 0; j < dPOSE_FILTER_STATES; j++)
+			if(i <= StateAngle || j <= StateAngle)
+				P[i][j] = 0.0f;
+	FixCount = 0;
+	RejectCount = 0;
+	RejectsInRow = 0;
+}
+
+void PoseFilter_Predict(float Counts, float YawIncrement, float Dt)
+{
+	float F[dPOSE_FILTER_STATES][dPOSE_FILTER_STATES] = {{0.0f}};
+	float FP[dPOSE_FILTER_STATES][dPOSE_FILTER_STATES];
+	float Raw = Counts * Params.CmPerCount;
+	float Distance = Raw * State[StateScale];
+	float Cos = cosf(State[StateAngle]);
+	float Sin = sinf(State[StateAngle]);
+	float Along = Params.DistanceNoise * Raw;
+	float Across = Params.SlipNoise * Raw;
+
+	State[StateX] -= Distance * Cos;
+	State[StateY] += Distance * Sin;
+	State[StateAngle] = PoseFilter_Wrap(State[StateAngle] + YawIncrement - State[StateBias] * Dt);
+
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+		F[i][i] = 1.0f;
+	F[StateX][StateAngle] = Distance * Sin;
+	F[StateX][StateScale] = -Raw * Cos;
+	F[StateY][StateAngle] = Distance * Cos;
+	F[StateY][StateScale] = Raw * Sin;
+	F[StateAngle][StateBias] = -Dt;
+
+	/* P = F P F' + Q */
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+		for(uint8_t j = 0; j < dPOSE_FILTER_STATES; j++)
+		{
+			float Sum = 0.0f;
+
+			for(uint8_t k = 0; k < dPOSE_FILTER_STATES; k++)
+				Sum += F[i][k] * P[k][j];
+			FP[i][j] = Sum;
+		}
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+		for(uint8_t j = 0; j < dPOSE_FILTER_STATES; j++)
+		{
+			float Sum = 0.0f;
+
+			for(uint8_t k = 0; k < dPOSE_FILTER_STATES; k++)
+				Sum += FP[i][k] * F[j][k];
+			P[i][j] = Sum;
+		}
+
+	/* Travel noise along (-cos, sin) and across (sin, cos) the heading */
+	Along *= Along;
+	Across *= Across;
+	P[StateX][StateX] += Along * Cos * Cos + Across * Sin * Sin;
+	P[StateY][StateY] += Along * Sin * Sin + Across * Cos * Cos;
+	P[StateX][StateY] += (Across - Along) * Sin * Cos;
+	P[StateY][StateX] = P[StateX][StateY];
+	P[StateAngle][StateAngle] += Params.YawNoise * Params.YawNoise * Dt;
+	P[StateScale][StateScale] += Params.ScaleWalk * Params.ScaleWalk * fabsf(Raw);
+	P[StateBias][StateBias] += Params.BiasWalk * Params.BiasWalk * Dt;
+	PoseFilter_Symmetrize();
+}
+
+/* Innovation covariance S = H P H' + R of a fix, H = [1 0 Hx 0 0; 0 1 Hy 0 0]. PH = P H' */
+static float PoseFilter_Innovation(float Position, float BarOffset, float PH[dPOSE_FILTER_STATES][2], float S[3])
+{
+	float Cos = cosf(State[StateAngle]);
+	float Sin = sinf(State[StateAngle]);
+	float Hx = Cos * Position - Sin * BarOffset;
+	float Hy = -Sin * Position - Cos * BarOffset;
+	float R = Params.MagnetNoise * Params.MagnetNoise;
+
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+	{
+		PH[i][0] = P[i][StateX] + P[i][StateAngle] * Hx;
+		PH[i][1] = P[i][StateY] + P[i][StateAngle] * Hy;
+	}
+	S[0] = PH[StateX][0] + Hx * PH[StateAngle][0] + R;
+	S[1] = PH[StateX][1] + Hx * PH[StateAngle][1];
+	S[2] = PH[StateY][1] + Hy * PH[StateAngle][1] + R;
+	return S[0] * S[2] - S[1] * S[1];
+}
+
+int16_t PoseFilter_MagnetFix(const RouteData* Route, uint16_t First, uint16_t Last, float BarPosition, float BarOffset)
+{
+	float Cos = cosf(State[StateAngle]);
+	float Sin = sinf(State[StateAngle]);
+	float PH[dPOSE_FILTER_STATES][2], BestPH[dPOSE_FILTER_STATES][2] = {{0.0f}};
+	float S[3], BestS[3] = {0.0f};
+	float K[dPOSE_FILTER_STATES][2];
+	float Determinant, BestDeterminant = 0.0f;
+	float BestDistance = 0.0f, BestNx = 0.0f, BestNy = 0.0f;
+	int16_t Best = dPOSE_FILTER_NO_MAGNET;
+
+	if(Last > Route->StepCount)
+		Last = Route->StepCount;
+	if(Last >= First + dPOSE_FILTER_MAGNET_WINDOW)
+		Last = First + dPOSE_FILTER_MAGNET_WINDOW - 1;
+
+	for(uint16_t i = First; i <= Last; i++)
+	{
+		int16_t Expected = Route->Step[Route->Magnet[i].StepNumber].MagnetOffset;
+		float Position, Nx, Ny, Distance;
+
+		if(Expected == dROUTE_MAGNET_NONE)
+			continue;
+		/* Bar reads the expected offset when the robot is on the route */
+		Position = BarPosition - (float)Expected / 100.0f;
+		Determinant = PoseFilter_Innovation(Position, BarOffset, PH, S);
+		if(Determinant <= 0.0f)
+			continue;
+		Nx = (float)Route->Magnet[i].X - (State[StateX] + Sin * Position + Cos * BarOffset);
+		Ny = (float)Route->Magnet[i].Y - (State[StateY] + Cos * Position - Sin * BarOffset);
+		Distance = (Nx * Nx * S[2] - 2.0f * Nx * Ny * S[1] + Ny * Ny * S[0]) / Determinant;
+		if(Best == dPOSE_FILTER_NO_MAGNET || Distance < BestDistance)
+		{
+			Best = (int16_t)i;
+			BestDistance = Distance;
+			BestNx = Nx;
+			BestNy = Ny;
+			BestDeterminant = Determinant;
+			for(uint8_t j = 0; j < 3; j++)
+				BestS[j] = S[j];
+			for(uint8_t j = 0; j < dPOSE_FILTER_STATES; j++)
+			{
+				BestPH[j][0] = PH[j][0];
+				BestPH[j][1] = PH[j][1];
+			}
+		}
+	}
+
+	if(Best == dPOSE_FILTER_NO_MAGNET || BestDistance > Params.Gate)
+	{
+		RejectCount++;
+		if(++RejectsInRow >= dPOSE_FILTER_LOST_REJECTS)
+		{
+			P[StateX][StateX] += Params.LostDeviation * Params.LostDeviation;
+			P[StateY][StateY] += Params.LostDeviation * Params.LostDeviation;
+			P[StateAngle][StateAngle] += Params.LostAngleDeviation * Params.LostAngleDeviation;
+			RejectsInRow = 0;
+		}
+		return dPOSE_FILTER_NO_MAGNET;
+	}
+
+	/* K = P H' S^-1, x += K v, P -= K H P */
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+	{
+		K[i][0] = (BestPH[i][0] * BestS[2] - BestPH[i][1] * BestS[1]) / BestDeterminant;
+		K[i][1] = (BestPH[i][1] * BestS[0] - BestPH[i][0] * BestS[1]) / BestDeterminant;
+		State[i] += K[i][0] * BestNx + K[i][1] * BestNy;
+	}
+	State[StateAngle] = PoseFilter_Wrap(State[StateAngle]);
+	for(uint8_t i = 0; i < dPOSE_FILTER_STATES; i++)
+		for(uint8_t j = 0; j < dPOSE_FILTER_STATES; j++)
+			P[i][j] -= K[i][0] * BestPH[j][0] + K[i][1] * BestPH[j][1];
+	PoseFilter_Symmetrize();
+
+	FixCount++;
+	RejectsInRow = 0;
+	return Best;
+}
+
+float PoseFilter_GetX(void)
+{
+	return State[StateX];
+}
+
+float PoseFilter_GetY(void)
+{
+	return State[StateY];
+}
+
+float PoseFilter_GetAngle(void)
+{
+	return State[StateAngle];
+}
+
+float PoseFilter_GetScale(void)
+{
+	return State[StateScale];
+}
+
+float PoseFilter_GetBias(void)
+{
+	return State[StateBias];
+}
+
+float PoseFilter_GetPositionDeviation(void)
+{
+	float Mean = (P[StateX][StateX] + P[StateY][StateY]) * 0.5f;
+	float Half = (P[StateX][StateX] - P[StateY][StateY]) * 0.5f;
+
+	return sqrtf(Mean + sqrtf(Half * Half + P[StateX][StateY] * P[StateX][StateY]));
+}
+
+uint16_t PoseFilter_GetFixCount(void)
+{
+	return FixCount;
+}
+
+uint16_t PoseFilter_GetRejectCount(void)
+{
+	return RejectCount;
+}
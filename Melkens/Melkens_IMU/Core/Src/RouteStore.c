@@ -0,0 +1,269 @@
+/*
+ * RouteStore.c
+ *
+ * Flash route store with A/B slots, see RouteStore.h for image layout.
+ */
+
+#include "RouteStore.h"
+#include "FlashPage.h"
+#include "CRC16.h"
+
+#include <string.h>
+#include <stddef.h>
+
+#define RouteStore_SlotAddress(Slot)	(dROUTE_STORE_ADDRESS + (uint32_t)(Slot) * dROUTE_STORE_SLOT_SIZE)
+#define dROUTE_STORE_PAYLOAD_MAX		(dROUTE_STORE_SLOT_SIZE - sizeof(RouteStoreHeader))
+
+typedef struct RouteUpload_t{
+	uint8_t State;
+	uint8_t Slot;				/* Slot being written */
+	uint16_t NextSequence;		/* Next expected data block */
+	uint32_t Received;			/* Payload bytes written */
+	uint32_t Erased;			/* Slot bytes erased */
+	uint16_t Crc;
+	RouteStoreHeader Header;
+} RouteUpload;
+
+static RouteUpload Upload;
+static const RouteStoreHeader* ActiveHeader;	/* NULL when no valid slot */
+static uint8_t ActiveSlot;
+static bool IsAvailable;						/* Flash in single bank mode */
+
+static bool RouteStore_IsHeaderValid(const RouteStoreHeader* Header)
+{
+	if(Header->Magic != dROUTE_STORE_MAGIC || Header->Version != dROUTE_STORE_VERSION)
+		return false;
+	if(Header->HeaderCrc != CRC16((const uint8_t*)Header, offsetof(RouteStoreHeader, HeaderCrc)))
+		return false;
+	if(Header->RouteCount == 0 || Header->RouteCount > dROUTE_STORE_MAX_ROUTES)
+		return false;
+	if(Header->PayloadSize > dROUTE_STORE_PAYLOAD_MAX ||
+	   Header->PayloadSize < Header->RouteCount * sizeof(RouteStoreEntry))
+		return false;
+	return true;
+}
+
+/* Entries are checked in place, in flash */
+static bool RouteStore_AreEntriesValid(const RouteStoreHeader* Header, const uint8_t* Payload)
+{
+	const RouteStoreEntry* Entry = (const RouteStoreEntry*)Payload;
+	uint32_t Size;
+
+	for(uint16_t i = 0; i < Header->RouteCount; i++, Entry++)
+	{
+		Size = Entry->StepCount * sizeof(RouteStep) +
+			   (Entry->StepCount + 1U + Entry->PointCount) * sizeof(RoutePoint);
+
+		if(Entry->StepCount == 0 || Entry->PointCount == 0 || (Entry->Offset & 1U) != 0)
+			return false;
+		if(Entry->Offset > Header->PayloadSize || Size > Header->PayloadSize - Entry->Offset)
+			return false;
+	}
+	return true;
+}
+
+static bool RouteStore_IsSlotValid(uint8_t Slot)
+{
+	const RouteStoreHeader* Header = (const RouteStoreHeader*)RouteStore_SlotAddress(Slot);
+
+	if(!RouteStore_IsHeaderValid(Header))
+		return false;
+	if(Header->PayloadCrc != CRC16((const uint8_t*)(Header + 1), (uint16_t)Header->PayloadSize))
+		return false;
+	return RouteStore_AreEntriesValid(Header, (const uint8_t*)(Header + 1));
+}
+
+static void RouteStore_Begin(const RouteBlock_t* Block, bool Locked)
+{
+	if(Locked)
+	{
+		/* Inactive slot can still hold the route being driven */
+		Upload.State = dROUTE_UPLOAD_ERROR_BUSY;
+		return;
+	}
+
+	memcpy(&Upload.Header, Block->data, sizeof(RouteStoreHeader));
+	if(Block->length != sizeof(RouteStoreHeader) || !RouteStore_IsHeaderValid(&Upload.Header))
+	{
+		Upload.State = dROUTE_UPLOAD_ERROR_HEADER;
+		return;
+	}
+
+	Upload.Slot = (ActiveHeader == NULL) ? 0 : (ActiveSlot ^ 1U);
+	Upload.NextSequence = 0;
+	Upload.Received = 0;
+	Upload.Erased = 0;
+	Upload.Crc = dCRC16_INIT;
+	Upload.State = dROUTE_UPLOAD_RECEIVING;
+}
+
+/* Route started or robot driven during upload, nothing more is written */
+static bool RouteStore_IsLocked(bool Locked)
+{
+	if(Locked && Upload.State == dROUTE_UPLOAD_RECEIVING)
+		Upload.State = dROUTE_UPLOAD_ERROR_BUSY;
+	return Locked;
+}
+
+static void RouteStore_Data(const RouteBlock_t* Block, bool Locked)
+{
+	uint32_t Offset = sizeof(RouteStoreHeader) + Upload.Received;
+	uint32_t SlotAddress = RouteStore_SlotAddress(Upload.Slot);
+
+	if(RouteStore_IsLocked(Locked))
+		return;
+	/* Out of order blocks are dropped, ESP resends from acknowledged sequence */
+	if(Upload.State != dROUTE_UPLOAD_RECEIVING || Block->sequence != Upload.NextSequence)
+		return;
+
+	if(Block->length == 0 || Block->length > dROUTE_BLOCK_DATA_SIZE ||
+	   Block->length > Upload.Header.PayloadSize - Upload.Received ||
+	   (Block->length < dROUTE_BLOCK_DATA_SIZE && Upload.Received + Block->length != Upload.Header.PayloadSize))
+	{
+		Upload.State = dROUTE_UPLOAD_ERROR_HEADER;
+		return;
+	}
+
+	/* Pages are erased when first written, a block is smaller than a page so
+	 * one block erases at most one page and stalls the main loop once for ~20 ms */
+	while(Upload.Erased < Offset + Block->length)
+	{
+		if(!FlashPage_Erase(SlotAddress + Upload.Erased))
+		{
+			Upload.State = dROUTE_UPLOAD_ERROR_FLASH;
+			return;
+		}
+		Upload.Erased += dFLASH_PAGE_SIZE;
+	}
+
+	if(!FlashPage_Program(SlotAddress + Offset, Block->data, Block->length))
+	{
+		Upload.State = dROUTE_UPLOAD_ERROR_FLASH;
+		return;
+	}
+
+	Upload.Crc = CRC16_Update(Upload.Crc, Block->data, Block->length);
+	Upload.Received += Block->length;
+	Upload.NextSequence++;
+}
+
+static void RouteStore_Commit(bool Locked)
+{
+	const RouteStoreHeader* Header = (const RouteStoreHeader*)RouteStore_SlotAddress(Upload.Slot);
+
+	if(RouteStore_IsLocked(Locked) || Upload.State != dROUTE_UPLOAD_RECEIVING)
+		return;
+
+	if(Upload.Received != Upload.Header.PayloadSize || Upload.Crc != Upload.Header.PayloadCrc ||
+	   !RouteStore_AreEntriesValid(&Upload.Header, (const uint8_t*)(Header + 1)))
+	{
+		Upload.State = dROUTE_UPLOAD_ERROR_CRC;
+		return;
+	}
+
+	Upload.Header.Sequence = (ActiveHeader == NULL) ? 1U : ActiveHeader->Sequence + 1U;
+	Upload.Header.HeaderCrc = CRC16((const uint8_t*)&Upload.Header, offsetof(RouteStoreHeader, HeaderCrc));
+
+	/* Header written last, from now on the new slot is valid and newer */
+	if(!FlashPage_Program(RouteStore_SlotAddress(Upload.Slot), (const uint8_t*)&Upload.Header, sizeof(RouteStoreHeader)))
+	{
+		Upload.State = dROUTE_UPLOAD_ERROR_FLASH;
+		return;
+	}
+
+	ActiveSlot = Upload.Slot;
+	ActiveHeader = Header;
+	Upload.State = dROUTE_UPLOAD_DONE;
+}
+
+void RouteStore_Init(void)
+{
+	const RouteStoreHeader* Header;
+
+	ActiveHeader = NULL;
+	memset(&Upload, 0, sizeof(Upload));
+	Upload.State = dROUTE_UPLOAD_IDLE;
+
+	/* Dual bank: slot addresses are not mapped, not even read */
+	IsAvailable = FlashPage_IsSingleBank();
+	if(!IsAvailable)
+		return;
+
+	for(uint8_t Slot = 0; Slot < dROUTE_STORE_SLOT_NUMOF; Slot++)
+	{
+		Header = (const RouteStoreHeader*)RouteStore_SlotAddress(Slot);
+		if(RouteStore_IsSlotValid(Slot) && (ActiveHeader == NULL || Header->Sequence > ActiveHeader->Sequence))
+		{
+			ActiveHeader = Header;
+			ActiveSlot = Slot;
+		}
+	}
+}
+
+bool RouteStore_GetRoute(uint16_t ID, RouteData* Data)
+{
+	const RouteStoreEntry* Entry;
+	const uint8_t* Payload;
+
+	if(ActiveHeader == NULL)
+		return false;
+
+	Payload = (const uint8_t*)(ActiveHeader + 1);
+	Entry = (const RouteStoreEntry*)Payload;
+	for(uint16_t i = 0; i < ActiveHeader->RouteCount; i++, Entry++)
+	{
+		if(Entry->ID == ID)
+		{
+			Data->ID = (Route_ID)ID;
+			Data->StepCount = Entry->StepCount;
+			Data->PointCount = Entry->PointCount;
+			Data->Step = (const RouteStep*)&Payload[Entry->Offset];
+			Data->Magnet = (const RoutePoint*)(Data->Step + Entry->StepCount);
+			Data->Point = Data->Magnet + Entry->StepCount + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+uint8_t RouteStore_GetRouteCount(void)
+{
+	return (ActiveHeader == NULL) ? 0 : (uint8_t)ActiveHeader->RouteCount;
+}
+
+void RouteStore_ProcessBlock(const RouteBlock_t* Block, bool Locked)
+{
+	if(!IsAvailable)
+	{
+		Upload.State = dROUTE_UPLOAD_ERROR_FLASH;
+		return;
+	}
+
+	switch(Block->command)
+	{
+	case dROUTE_BLOCK_BEGIN:
+		RouteStore_Begin(Block, Locked);
+		break;
+	case dROUTE_BLOCK_DATA:
+		RouteStore_Data(Block, Locked);
+		break;
+	case dROUTE_BLOCK_COMMIT:
+		RouteStore_Commit(Locked);
+		break;
+	case dROUTE_BLOCK_ABORT:
+		Upload.State = dROUTE_UPLOAD_IDLE;
+		break;
+	default:
+		break;
+	}
+}
+
+uint8_t RouteStore_GetUploadState(void)
+{
+	return Upload.State;
+}
+
+uint16_t RouteStore_GetUploadAck(void)
+{
+	return Upload.NextSequence;
+}
@@ -9,14 +9,70 @@
 #include "Navigation.h"
 #include "routeManager.h"
 #include "ConnectivityHandler.h"
+#include "CollisionDetector.h"
+#include "VelocityPlanner.h"
+#include "PoseFilter.h"
+#include "IMU_func.h"
+
+#define dROUTE_BACKOFF_SPEED	200		/* wheel speed driving away from obstacle */
+#define dROUTE_BACKOFF_TIME		1000	/* [ms] */
 
 RouteStates RouteState;
+static uint8_t Collision;			/* dCOLLISION_... route was stopped for */
+static int16_t BackOffSpeed;
+static uint16_t BackOffTimer;		/* [ms] */
+static bool IsPlayReleased;			/* play is a level, after a collision it has to be pressed again */
 
 void RouteManager_Init(void)
 {
     RouteState = RouteState_Idle;
     navigationInit();
+    CollisionDetector_Init(&CollisionDetector_Defaults);
+    VelocityPlanner_Init(&VelocityPlanner_Defaults);
+    PoseFilter_Init(&PoseFilter_Defaults);
+
+}
+
+/* Wheels and auger stop at once, after impact or stall the robot backs off
+ * against the direction it was driving, the route is paused afterwards */
+static void RouteManager_StartBackOff(uint8_t Event)
+{
+    int16_t Speed = getLeftWheelSpeed() + getRightWheelSpeed();
+
+    Collision = Event;
+    IsPlayReleased = false;
+    BackOffSpeed = 0;
+    BackOffTimer = 0;
+    if(Event != dCOLLISION_AUGER_OVERLOAD)
+    {
+        BackOffSpeed = (Speed > 0) ? -dROUTE_BACKOFF_SPEED : dROUTE_BACKOFF_SPEED;
+        BackOffTimer = dROUTE_BACKOFF_TIME;
+    }
+    setLeftWheelSpeed(BackOffSpeed);
+    setRightWheelSpeed(BackOffSpeed);
+    setThumbleSpeed(0);
+    IMU_RequestSendToPMB();
+    /* Watching again, an obstacle behind ends the back off */
+    CollisionDetector_Clear();
+    RouteState = RouteState_BackOff;
+}
+
+/* Back off ends with the wheels stopped in NextState */
+static void RouteManager_StopBackOff(RouteStates NextState)
+{
+    BackOffTimer = 0;
+    setLeftWheelSpeed(0);
+    setRightWheelSpeed(0);
+    IMU_RequestSendToPMB();
+    RouteState = NextState;
+}
 
+/* Route continues from where it stopped, detector watches again */
+static void RouteManager_Resume(void)
+{
+    Collision = dCOLLISION_NONE;
+    CollisionDetector_Clear();
+    RouteState = RouteState_Drive;
 }
 
 void RouteManager_Perform1ms(void)
@@ -26,6 +82,16 @@ void RouteManager_Perform1ms(void)
 
 }
 
+bool RouteManager_IsDriving(void)
+{
+	return RouteState == RouteState_Drive || RouteState == RouteState_Pause || RouteState == RouteState_BackOff;
+}
+
+uint8_t RouteManager_GetCollision(void)
+{
+	return Collision;
+}
+
 void RouteManager_StateMachine(void){
 
 
@@ -34,6 +100,8 @@ void RouteManager_StateMachine(void){
 
 
     	loadRoute(getSelectedRoute());
+    	Collision = dCOLLISION_NONE;
+    	CollisionDetector_Clear();
 
 
     	//RouteState = RouteState_Idle;
@@ -42,6 +110,8 @@ void RouteManager_StateMachine(void){
     case RouteState_Idle:
 
     	manualNavigation();
+    	/* Operator drives and sees the robot, events matter only on a route */
+    	CollisionDetector_Clear();
 
     	if(getRouteAction()==2)
     		RouteState = RouteState_Init;
@@ -54,8 +124,10 @@ void RouteManager_StateMachine(void){
     case RouteState_Pause:
     	manualNavigation();
 
-    	if(getRouteAction()==2)
-    	    RouteState = RouteState_Drive;
+    	if(getRouteAction()!=2)
+    		IsPlayReleased = true;
+    	if(getRouteAction()==2 && IsPlayReleased)
+    	    RouteManager_Resume();
         break;
     case RouteState_Drive:
 
@@ -67,8 +139,22 @@ void RouteManager_StateMachine(void){
     		RouteState = RouteState_Idle;
     	if(getRouteAction()==1)
     		RouteState = RouteState_Pause;
+    	if(RouteState == RouteState_Drive && CollisionDetector_GetEvent() != dCOLLISION_NONE)
+    		RouteManager_StartBackOff(CollisionDetector_GetEvent());
 
         break;
+    case RouteState_BackOff:
+    	/* Stop and pause of the operator take effect at once */
+    	if(getRouteAction()==0)
+    		RouteManager_StopBackOff(RouteState_Idle);
+    	else if(getRouteAction()==1 || CollisionDetector_GetEvent() != dCOLLISION_NONE)
+    		RouteManager_StopBackOff(RouteState_Pause);
+    	else if(BackOffTimer > 0)
+    		BackOffTimer--;
+    	else
+    		/* Operator resumes with play once the obstacle is cleared */
+    		RouteManager_StopBackOff(RouteState_Pause);
+        break;
     default:
         break;
     }
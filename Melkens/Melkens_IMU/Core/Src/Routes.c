@@ -1,93 +1,369 @@
 /*
  * Routes.c
  *
- *  Created on: May 26, 2025
- *      Author: kolodzio
+ * Generated by Tools/RouteCompiler/route_compiler.py from:
+ *   Routes/IMU_A.csv
+ *   Routes/IMU_B.csv
+ *   Routes/IMU_C.csv
+ *   Routes/IMU_D.csv
+ * Do not edit, change the route description and run the compiler again.
  */
 
 
 #include "RoutesDataTypes.h"
+#include "RouteStore.h"
 
 #include <string.h>
 
 
 #define STEPS_ROUTE_A 19
+#define POINTS_ROUTE_A 101
 static const RouteStep RouteStepsA[STEPS_ROUTE_A] =
 {
-//       dx,  dy,  speed, thumble, offset
-		{20, 0, 300, TH_OFF, 0},//0
-		{20, 0, 300, TH_OFF, 0},//1
-		{20, 0, 300, TH_OFF, 0},//2
-		{50, 0, 300, TH_OFF, 0},//3
-		{50, 0, 300, TH_OFF, 0},//4
-		{50, 0, 300, TH_OFF, 0},//5
-		{57, -9, 300, TH_OFF, 0},//6
-		{57, -9, 300, TH_OFF, 0},//7
-		{57, -9, 300, TH_OFF, 0},//8
-
-		{-108, -95, -300, TH_OFF, 0},//9
-		{-48, -34, -300, TH_OFF, 0},//10
-		{-48, -34, -300, TH_OFF, 0},//11
-		{-48, -34, -300, TH_OFF, 0},//12
-		{-48, -34, -300, TH_OFF, 0},//13
-
-		{76, -57, 300, TH_ON, 0},//14
-		{60, 0, 300, TH_ON, 0},//15
-		{50, 0, 300, TH_ON, 0},//16
-		{50, 0, 300, TH_ON, 0},//17
-		{50, 0, 300, TH_ON, 0},//18
+//		speed, thumble, length, heading, magnet
+		{300, TH_OFF, 20, 0, 0},//0
+		{300, TH_OFF, 20, 0, 0},//1
+		{300, TH_OFF, 20, 0, 0},//2
+		{300, TH_OFF, 50, 0, 0},//3
+		{300, TH_OFF, 50, 0, 0},//4
+		{300, TH_OFF, 50, 0, 0},//5
+		{300, TH_OFF, 58, -1566, 0},//6
+		{300, TH_OFF, 58, -1566, 0},//7
+		{300, TH_OFF, 58, -1566, 0},//8
+		{-300, TH_OFF, 144, -24201, 0},//9
+		{-300, TH_OFF, 59, -25253, 0},//10
+		{-300, TH_OFF, 59, -25253, 0},//11
+		{-300, TH_OFF, 59, -25253, 0},//12
+		{-300, TH_OFF, 59, -25253, 0},//13
+		{300, TH_ON, 95, -6435, 0},//14
+		{300, TH_ON, 60, 0, 0},//15
+		{300, TH_ON, 50, 0, 0},//16
+		{300, TH_ON, 50, 0, 0},//17
+		{300, TH_ON, 50, 0, 0},//18
+};
 
+static const RoutePoint RouteMagnetsA[STEPS_ROUTE_A + 1] =
+{
+		{0, 0, 0},
+		{20, 0, 0},
+		{40, 0, 1},
+		{60, 0, 2},
+		{110, 0, 3},
+		{160, 0, 4},
+		{210, 0, 5},
+		{267, -9, 6},
+		{324, -18, 7},
+		{381, -27, 8},
+		{273, -122, 9},
+		{225, -156, 10},
+		{177, -190, 11},
+		{129, -224, 12},
+		{81, -258, 13},
+		{157, -315, 14},
+		{217, -315, 15},
+		{267, -315, 16},
+		{317, -315, 17},
+		{367, -315, 18},
+};
 
+static const RoutePoint RoutePointsA[POINTS_ROUTE_A] =
+{
+		{0, 0, 0},
+		{10, 0, 0},
+		{20, 0, 1},
+		{30, 0, 1},
+		{40, 0, 2},
+		{50, 0, 2},
+		{60, 0, 3},
+		{70, 0, 3},
+		{80, 0, 3},
+		{90, 0, 3},
+		{100, 0, 3},
+		{110, 0, 4},
+		{120, 0, 4},
+		{130, 0, 4},
+		{140, 0, 4},
+		{150, 0, 4},
+		{160, 0, 5},
+		{170, 0, 5},
+		{180, 0, 5},
+		{190, 0, 5},
+		{200, 0, 5},
+		{210, 0, 6},
+		{221, -1, 6},
+		{232, -2, 6},
+		{243, -3, 6},
+		{254, -4, 6},
+		{267, -9, 7},
+		{278, -10, 7},
+		{289, -11, 7},
+		{300, -12, 7},
+		{311, -13, 7},
+		{324, -18, 8},
+		{335, -19, 8},
+		{346, -20, 8},
+		{357, -21, 8},
+		{368, -22, 8},
+		{381, -27, 9},
+		{374, -33, 9},
+		{367, -39, 9},
+		{360, -45, 9},
+		{353, -51, 9},
+		{346, -57, 9},
+		{339, -63, 9},
+		{332, -69, 9},
+		{325, -75, 9},
+		{318, -81, 9},
+		{311, -87, 9},
+		{304, -93, 9},
+		{297, -99, 9},
+		{290, -105, 9},
+		{273, -122, 10},
+		{264, -128, 10},
+		{255, -134, 10},
+		{246, -140, 10},
+		{237, -146, 10},
+		{225, -156, 11},
+		{216, -162, 11},
+		{207, -168, 11},
+		{198, -174, 11},
+		{189, -180, 11},
+		{177, -190, 12},
+		{168, -196, 12},
+		{159, -202, 12},
+		{150, -208, 12},
+		{141, -214, 12},
+		{129, -224, 13},
+		{120, -230, 13},
+		{111, -236, 13},
+		{102, -242, 13},
+		{93, -248, 13},
+		{81, -258, 14},
+		{89, -264, 14},
+		{97, -270, 14},
+		{105, -276, 14},
+		{113, -282, 14},
+		{121, -288, 14},
+		{129, -294, 14},
+		{137, -300, 14},
+		{145, -306, 14},
+		{157, -315, 15},
+		{167, -315, 15},
+		{177, -315, 15},
+		{187, -315, 15},
+		{197, -315, 15},
+		{207, -315, 15},
+		{217, -315, 16},
+		{227, -315, 16},
+		{237, -315, 16},
+		{247, -315, 16},
+		{257, -315, 16},
+		{267, -315, 17},
+		{277, -315, 17},
+		{287, -315, 17},
+		{297, -315, 17},
+		{307, -315, 17},
+		{317, -315, 18},
+		{327, -315, 18},
+		{337, -315, 18},
+		{347, -315, 18},
+		{357, -315, 18},
+		{367, -315, 18},
 };
 
 #define STEPS_ROUTE_B 5
+#define POINTS_ROUTE_B 51
 static const RouteStep RouteStepsB[STEPS_ROUTE_B] =
 {
-		{100, 0, 300, TH_ON, 0},
-		{100, 0, 300, TH_ON, 0},
-		{100, 0, 300, TH_ON, 0},
-		{100, 0, 300, TH_ON, 0},
-		{100, 0, 300, TH_ON, 0},
+//		speed, thumble, length, heading, magnet
+		{300, TH_ON, 100, 0, 0},//0
+		{300, TH_ON, 100, 0, 0},//1
+		{300, TH_ON, 100, 0, 0},//2
+		{300, TH_ON, 100, 0, 0},//3
+		{300, TH_ON, 100, 0, 0},//4
+};
+
+static const RoutePoint RouteMagnetsB[STEPS_ROUTE_B + 1] =
+{
+		{0, 0, 0},
+		{100, 0, 0},
+		{200, 0, 1},
+		{300, 0, 2},
+		{400, 0, 3},
+		{500, 0, 4},
+};
 
+static const RoutePoint RoutePointsB[POINTS_ROUTE_B] =
+{
+		{0, 0, 0},
+		{10, 0, 0},
+		{20, 0, 0},
+		{30, 0, 0},
+		{40, 0, 0},
+		{50, 0, 0},
+		{60, 0, 0},
+		{70, 0, 0},
+		{80, 0, 0},
+		{90, 0, 0},
+		{100, 0, 1},
+		{110, 0, 1},
+		{120, 0, 1},
+		{130, 0, 1},
+		{140, 0, 1},
+		{150, 0, 1},
+		{160, 0, 1},
+		{170, 0, 1},
+		{180, 0, 1},
+		{190, 0, 1},
+		{200, 0, 2},
+		{210, 0, 2},
+		{220, 0, 2},
+		{230, 0, 2},
+		{240, 0, 2},
+		{250, 0, 2},
+		{260, 0, 2},
+		{270, 0, 2},
+		{280, 0, 2},
+		{290, 0, 2},
+		{300, 0, 3},
+		{310, 0, 3},
+		{320, 0, 3},
+		{330, 0, 3},
+		{340, 0, 3},
+		{350, 0, 3},
+		{360, 0, 3},
+		{370, 0, 3},
+		{380, 0, 3},
+		{390, 0, 3},
+		{400, 0, 4},
+		{410, 0, 4},
+		{420, 0, 4},
+		{430, 0, 4},
+		{440, 0, 4},
+		{450, 0, 4},
+		{460, 0, 4},
+		{470, 0, 4},
+		{480, 0, 4},
+		{490, 0, 4},
+		{500, 0, 4},
 };
 
 #define STEPS_ROUTE_C 4
+#define POINTS_ROUTE_C 41
 static const RouteStep RouteStepsC[STEPS_ROUTE_C] =
 {
-		{100, 0, 200, TH_OFF, 0},
-		{0, -100, 200, TH_OFF, 0},
-		{-100, 0, 200, TH_OFF, 0},
-		{0, 100, 200, TH_OFF, 0},
-
+//		speed, thumble, length, heading, magnet
+		{200, TH_OFF, 100, 0, 0},//0
+		{200, TH_OFF, 100, -15708, 0},//1
+		{200, TH_OFF, 100, 31416, 0},//2
+		{200, TH_OFF, 100, 15708, 0},//3
 };
 
+static const RoutePoint RouteMagnetsC[STEPS_ROUTE_C + 1] =
+{
+		{0, 0, 0},
+		{100, 0, 0},
+		{100, -100, 1},
+		{0, -100, 2},
+		{0, 0, 3},
+};
 
+static const RoutePoint RoutePointsC[POINTS_ROUTE_C] =
+{
+		{0, 0, 0},
+		{10, 0, 0},
+		{20, 0, 0},
+		{30, 0, 0},
+		{40, 0, 0},
+		{50, 0, 0},
+		{60, 0, 0},
+		{70, 0, 0},
+		{80, 0, 0},
+		{90, 0, 0},
+		{100, 0, 1},
+		{100, -10, 1},
+		{100, -20, 1},
+		{100, -30, 1},
+		{100, -40, 1},
+		{100, -50, 1},
+		{100, -60, 1},
+		{100, -70, 1},
+		{100, -80, 1},
+		{100, -90, 1},
+		{100, -100, 2},
+		{90, -100, 2},
+		{80, -100, 2},
+		{70, -100, 2},
+		{60, -100, 2},
+		{50, -100, 2},
+		{40, -100, 2},
+		{30, -100, 2},
+		{20, -100, 2},
+		{10, -100, 2},
+		{0, -100, 3},
+		{0, -90, 3},
+		{0, -80, 3},
+		{0, -70, 3},
+		{0, -60, 3},
+		{0, -50, 3},
+		{0, -40, 3},
+		{0, -30, 3},
+		{0, -20, 3},
+		{0, -10, 3},
+		{0, 0, 3},
+};
 
 #define STEPS_ROUTE_D 5
+#define POINTS_ROUTE_D 11
 static const RouteStep RouteStepsD[STEPS_ROUTE_D] =
 {
-		{-20, 0, -500, TH_OFF, 0},
-		{-20, 0, -500, TH_OFF, 0},
-		{-20, 0, -500, TH_OFF, 0},
-		{-20, 0, -500, TH_OFF, 0},
-		{-20, 0, -500, TH_OFF, 0},
+//		speed, thumble, length, heading, magnet
+		{-500, TH_OFF, 20, 31416, 0},//0
+		{-500, TH_OFF, 20, 31416, 0},//1
+		{-500, TH_OFF, 20, 31416, 0},//2
+		{-500, TH_OFF, 20, 31416, 0},//3
+		{-500, TH_OFF, 20, 31416, 0},//4
+};
 
+static const RoutePoint RouteMagnetsD[STEPS_ROUTE_D + 1] =
+{
+		{0, 0, 0},
+		{-20, 0, 0},
+		{-40, 0, 1},
+		{-60, 0, 2},
+		{-80, 0, 3},
+		{-100, 0, 4},
+};
 
+static const RoutePoint RoutePointsD[POINTS_ROUTE_D] =
+{
+		{0, 0, 0},
+		{-10, 0, 0},
+		{-20, 0, 1},
+		{-30, 0, 1},
+		{-40, 0, 2},
+		{-50, 0, 2},
+		{-60, 0, 3},
+		{-70, 0, 3},
+		{-80, 0, 4},
+		{-90, 0, 4},
+		{-100, 0, 4},
 };
 
 
 static const RouteData Routes[Route_NumOf]   =
     {
-     [RouteA] = {.ID = RouteA, .StepCount = STEPS_ROUTE_A, .Step = &RouteStepsA[0]},
-     [RouteB] = {.ID = RouteB, .StepCount = STEPS_ROUTE_B, .Step = &RouteStepsB[0]},
-     [RouteC] = {.ID = RouteC, .StepCount = STEPS_ROUTE_C, .Step = &RouteStepsC[0]},
-     [RouteD] = {.ID = RouteD, .StepCount = STEPS_ROUTE_D, .Step = &RouteStepsD[0]}
+     [RouteA] = {.ID = RouteA, .StepCount = STEPS_ROUTE_A, .PointCount = POINTS_ROUTE_A, .Step = &RouteStepsA[0], .Magnet = &RouteMagnetsA[0], .Point = &RoutePointsA[0]},
+     [RouteB] = {.ID = RouteB, .StepCount = STEPS_ROUTE_B, .PointCount = POINTS_ROUTE_B, .Step = &RouteStepsB[0], .Magnet = &RouteMagnetsB[0], .Point = &RoutePointsB[0]},
+     [RouteC] = {.ID = RouteC, .StepCount = STEPS_ROUTE_C, .PointCount = POINTS_ROUTE_C, .Step = &RouteStepsC[0], .Magnet = &RouteMagnetsC[0], .Point = &RoutePointsC[0]},
+     [RouteD] = {.ID = RouteD, .StepCount = STEPS_ROUTE_D, .PointCount = POINTS_ROUTE_D, .Step = &RouteStepsD[0], .Magnet = &RouteMagnetsD[0], .Point = &RoutePointsD[0]}
     };
 
-RouteData dummy2;
-
 void Route_SetRoutePointer(RouteData* Data ,Route_ID RouteSelected){
+    /* Uploaded routes replace compiled in routes with the same ID */
+    if(RouteStore_GetRoute(RouteSelected, Data))
+        return;
+    if(RouteSelected >= Route_NumOf)
+        RouteSelected = RouteA;
     memcpy(Data, &Routes[RouteSelected], sizeof(RouteData));
-//    Data->Step += Offset; /* no 0 step on display, but here steps are from 0 */
-//    Data->CurrentStepCount = Offset;
 }
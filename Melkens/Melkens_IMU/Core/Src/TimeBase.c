@@ -0,0 +1,61 @@
+/*
+ * TimeBase.c
+ *
+ * Shared timebase follower of ESP and master of PMB, see TimeBase.h.
+ */
+
+#include "TimeBase.h"
+#include "TimeSync.h"
+#include "TimeManager.h"
+
+static TimeSync EspSync;	/* ESP is master, estimate of shared time */
+static TimeSync PmbSync;	/* IMU is master, only echoes PMB stamps */
+
+void TimeBase_Init(void)
+{
+	TimeSync_Init(&EspSync);
+	TimeSync_Init(&PmbSync);
+}
+
+void TimeBase_EspFrameReceived(const SyncStamp_t* Stamp, uint32_t RxTime)
+{
+	TimeSync_Receive(&EspSync, Stamp, RxTime, true);
+}
+
+void TimeBase_PmbFrameReceived(const SyncStamp_t* Stamp, uint32_t RxTime)
+{
+	TimeSync_Receive(&PmbSync, Stamp, RxTime, false);
+}
+
+void TimeBase_StampEspFrame(SyncStamp_t* Stamp, uint32_t Baud)
+{
+	uint32_t TxTime = TimeManager_GetMicros() + dTIMESYNC_FRAME_TIME(sizeof(Imu2EspFrame_t), Baud);
+
+	TimeSync_Stamp(&EspSync, Stamp, TxTime, TxTime, dSYNC_UNKNOWN_WEEK_TIME, dSYNC_NOT_SYNCHRONISED);
+}
+
+void TimeBase_StampPmbFrame(SyncStamp_t* Stamp, uint32_t Baud)
+{
+	uint32_t Local = TimeManager_GetMicros() + dTIMESYNC_FRAME_TIME(sizeof(Imu2PmbFrame_t), Baud);
+	uint32_t Shared = Local;
+	uint32_t ErrorBound = dSYNC_NOT_SYNCHRONISED;
+
+	/* Bound above 16 bit is sent as not synchronised, PMB takes no sample from it */
+	if(TimeSync_ToShared(&EspSync, Local, &Shared))
+	{
+		ErrorBound = TimeSync_GetErrorBound(&EspSync, Local);
+		if(ErrorBound > dSYNC_NOT_SYNCHRONISED)
+			ErrorBound = dSYNC_NOT_SYNCHRONISED;
+	}
+	TimeSync_Stamp(&PmbSync, Stamp, Shared, Local, TimeSync_GetWeekTime(&EspSync, Local), (uint16_t)ErrorBound);
+}
+
+bool TimeBase_ToShared(uint32_t Local, uint32_t* Shared)
+{
+	return TimeSync_ToShared(&EspSync, Local, Shared);
+}
+
+uint32_t TimeBase_GetErrorBound(void)
+{
+	return TimeSync_GetErrorBound(&EspSync, TimeManager_GetMicros());
+}
@@ -6,6 +6,7 @@
  */
 #include "TimeManager.h"
 #include "stm32g4xx_ll_cortex.h"
+#include "stm32g4xx_ll_tim.h"
 #include "main.h"
 
 #include <stdint.h>
@@ -32,6 +33,7 @@ typedef struct TimeManager
    bool ReloadTick;
    TimeManager_Flags_t TemporaryFlags;
    TimeManager_Flags_t CalculatedFlags;
+   uint32_t SystemTick;
 } TimeManager_t;
 
 static TimeManager_t TimeManager;
@@ -42,6 +44,7 @@ void TimeManager_Init(void)
 	TimeManager.TickCount = 0;
 	TimeManager.TemporaryFlags.FlagsRegister = 0;
 	TimeManager.CalculatedFlags.FlagsRegister = 0;
+	TimeManager.SystemTick = 0;
 
 	/* TBD: Here SYSTICK should be started */
 }
@@ -55,6 +58,7 @@ extern void TimeManager_SYSTICK_Handler( void )
 {
 
 	TimeManager.TickCount++;
+	TimeManager.SystemTick++;
 	TimeManager.TemporaryFlags.Bits.Flag1ms = 1;
 
 	if (0 == (TimeManager.TickCount % 10))
@@ -101,3 +105,29 @@ bool TimeManager_Is100msPassed(void)
 	return TimeManager.CalculatedFlags.Bits.Flag100ms;
 }
 
+uint32_t TimeManager_GetSystemTick(void)
+{
+	return TimeManager.SystemTick;
+}
+
+uint32_t TimeManager_GetMicros(void)
+{
+	volatile uint32_t* SystemTick = &TimeManager.SystemTick;
+	uint32_t Period = LL_TIM_GetAutoReload(TIM7) + 1;
+	uint32_t Tick;
+	uint32_t Counter;
+	bool IsTickPending;
+
+	do{
+		Tick = *SystemTick;
+		Counter = LL_TIM_GetCounter(TIM7);
+		IsTickPending = LL_TIM_IsActiveFlag_UPDATE(TIM7);
+	}while(Tick != *SystemTick);
+
+	/* Timer already rolled over but TIM7 interrupt not serviced yet */
+	if(IsTickPending && (Counter < (Period / 2))){
+		Tick++;
+	}
+
+	return (Tick * 1000) + ((Counter * 1000) / Period);
+}
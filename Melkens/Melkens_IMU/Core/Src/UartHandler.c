@@ -13,6 +13,8 @@
 #include <stdbool.h>
 #include "stm32g4xx_ll_dma.h"
 #include "stm32g4xx_ll_usart.h"
+#include "stm32g4xx_ll_lpuart.h"
+#include "stm32g4xx_ll_rcc.h"
 
 const char *Ack_Message = "INFO_ACK";
 //const char *Get_Enco_Message = "GET_ENCO";
@@ -165,6 +167,83 @@ void UartHandler_ReloadReceiveChannel(UartName Uart)
 
 }
 
+/* Last frame sent is out on the line, transmit buffer may be written again */
+bool UartHandler_IsSendDone(UartName Uart)
+{
+	switch(Uart)
+	{
+		case Uart_ConnectivityESP:
+			return !LL_DMA_IsEnabledChannel(DMA1, LL_DMA_CHANNEL_2) && LL_LPUART_IsActiveFlag_TC(LPUART1);
+		case Uart_PMB:
+			return !LL_DMA_IsEnabledChannel(DMA2, LL_DMA_CHANNEL_2) && LL_USART_IsActiveFlag_TC(USART2);
+		case Uart_3:
+			return !LL_DMA_IsEnabledChannel(DMA1, LL_DMA_CHANNEL_3) && LL_USART_IsActiveFlag_TC(USART3);
+		default:
+			return false;
+	}
+}
+
+/* Baud rate of LinkSpeed negotiated links, false while a frame is still being sent */
+bool UartHandler_SetBaudRate(UartName Uart, uint32_t BaudRate)
+{
+	if(!UartHandler_IsSendDone(Uart))
+		return false;
+	switch(Uart)
+	{
+		case Uart_ConnectivityESP:
+			LL_LPUART_Disable(LPUART1);
+			LL_LPUART_SetBaudRate(LPUART1, LL_RCC_GetLPUARTClockFreq(LL_RCC_LPUART1_CLKSOURCE), LL_LPUART_PRESCALER_DIV1, BaudRate);
+			LL_LPUART_Enable(LPUART1);
+			break;
+		case Uart_PMB:
+			LL_USART_Disable(USART2);
+			LL_USART_SetBaudRate(USART2, LL_RCC_GetUSARTClockFreq(LL_RCC_USART2_CLKSOURCE), LL_USART_PRESCALER_DIV1, LL_USART_OVERSAMPLING_16, BaudRate);
+			LL_USART_Enable(USART2);
+			break;
+		default:
+			return false;
+	}
+	/* Bytes received at the old rate are garbage, next frame starts at buffer start */
+	UartHandler_ReloadReceiveChannel(Uart);
+	return true;
+}
+
+/* Receive DMA is fixed length, bytes of a broken frame (line noise, frame sent
+ * at other baud rate) would shift all following frames. Line idle in the middle
+ * of a frame drops it. Call often, frames are sent back to back. */
+void UartHandler_DropPartialFrame(UartName Uart)
+{
+	switch(Uart)
+	{
+		case Uart_ConnectivityESP:
+			if(LL_LPUART_IsActiveFlag_IDLE(LPUART1))
+			{
+				LL_LPUART_ClearFlag_IDLE(LPUART1);
+				if(!UartHandler_MessageReceivedFlag_UART1 && LL_DMA_GetDataLength(DMA1, LL_DMA_CHANNEL_1) != UART1_RX_MESSAGE_LEN)
+					UartHandler_ReloadReceiveChannel(Uart);
+			}
+			break;
+		case Uart_PMB:
+			if(LL_USART_IsActiveFlag_IDLE(USART2))
+			{
+				LL_USART_ClearFlag_IDLE(USART2);
+				if(!UartHandler_MessageReceivedFlag_UART2 && LL_DMA_GetDataLength(DMA2, LL_DMA_CHANNEL_1) != UART2_RX_MESSAGE_LEN)
+					UartHandler_ReloadReceiveChannel(Uart);
+			}
+			break;
+		case Uart_3:
+			if(LL_USART_IsActiveFlag_IDLE(USART3))
+			{
+				LL_USART_ClearFlag_IDLE(USART3);
+				if(!UartHandler_MessageReceivedFlag_UART3 && LL_DMA_GetDataLength(DMA1, LL_DMA_CHANNEL_4) != UART3_RX_MESSAGE_LEN)
+					UartHandler_ReloadReceiveChannel(Uart);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
 /*void UartHandler_SetMessage(char *Message, char *Type)
 {
 	 N
@@ -265,6 +344,7 @@ void UartHandler_GetRxBuffer(UartName Uart, uint8_t* dest, uint8_t Size)
 			memcpy(dest, Receive_Buff_UART2, Size);
 			break;
 		case Uart_3:
+			memcpy(dest, Receive_Buff_UART3, Size);
 			break;
 		case Uart_5:
 			memcpy(dest, Receive_Buff_UART2, Size);
@@ -299,6 +379,8 @@ void UartHandler_SendMessage(UartName UartNum, char* Message, uint8_t Len)
 		else if(  Uart_3 == UartNum )
 		{
 			memcpy(&Send_Buff_UART3, Message, Len);
+			/* UartHandler_SendBuffer points the channel elsewhere */
+			LL_DMA_SetMemoryAddress(DMA1, LL_DMA_CHANNEL_3, (uint32_t)&Send_Buff_UART3[0]);
 			LL_DMA_SetDataLength(DMA1, LL_DMA_CHANNEL_3, Len);
 			LL_DMA_EnableChannel(DMA1, LL_DMA_CHANNEL_3);
 
@@ -318,6 +400,18 @@ void UartHandler_SendMessage(UartName UartNum, char* Message, uint8_t Len)
 
 }
 
+/* Sends Len bytes straight from Data, no copy: Data stays untouched until
+ * UartHandler_IsSendDone. Debug UART only, its frames do not fit Send_Buff_UART3. */
+void UartHandler_SendBuffer(UartName UartNum, const uint8_t* Data, uint16_t Len)
+{
+	if( Uart_3 == UartNum )
+	{
+		LL_DMA_SetMemoryAddress(DMA1, LL_DMA_CHANNEL_3, (uint32_t)Data);
+		LL_DMA_SetDataLength(DMA1, LL_DMA_CHANNEL_3, Len);
+		LL_DMA_EnableChannel(DMA1, LL_DMA_CHANNEL_3);
+	}
+}
+
 uint32_t UartHandler_GetSendBufferAddress(UartName UartNum)
 {
 	if( UartNum < Uart_NumOf)
@@ -0,0 +1,216 @@
+/*
+ * VelocityPlanner.c
+ *
+ * Speed plan of route points, see VelocityPlanner.h. Planned speeds are kept
+ * in RPM like step speeds, limits and passes are computed in cm/s.
+ * Curvature (Menger, three points) is taken only between points driven in
+ * the same direction, a reversal is a stop and not a turn.
+ */
+
+#include <stdlib.h>
+#include "math.h"
+#include "VelocityPlanner.h"
+
+const VelocityPlannerParams VelocityPlanner_Defaults = {
+	.DistancePerRotation = 1.8996f,
+	.TrackWidth = 60.0f,
+	.MaxLateralAccel = 3.0f,	/* peak in turns of the stored routes at 300 RPM without the planner */
+	.MaxAccel = 10.0f,			/* 0 to 600 RPM in 18 cm */
+	.MaxWheelSpeed = 3000,
+	.MinSpeed = 150,
+	.LookaheadTime = 2.5f,		/* 3 points in turns, 5 at 600 RPM */
+	.MinLookahead = 3,
+	.MaxLookahead = 8,
+};
+
+static VelocityPlannerParams Params;
+static bool IsEnabled = true;
+static bool IsPlanned;
+static uint16_t PlannedSpeed[dVELOCITY_PLANNER_MAX_POINTS];
+
+static int8_t VelocityPlanner_Direction(const RouteData* Route, uint16_t Point)
+{
+	int16_t Speed = Route->Step[Route->Point[Point].StepNumber].Speed;
+
+	return (Speed > 0) ? 1 : ((Speed < 0) ? -1 : 0);
+}
+
+static float VelocityPlanner_Distance(const RoutePoint* A, const RoutePoint* B)
+{
+	float dx = (float)(B->X - A->X);
+	float dy = (float)(B->Y - A->Y);
+
+	return sqrtf(dx*dx + dy*dy);
+}
+
+/* [1/cm] circle through A, B, C, 0 on a straight line */
+static float VelocityPlanner_Curvature(const RoutePoint* A, const RoutePoint* B, const RoutePoint* C)
+{
+	float Cross = (float)(B->X - A->X) * (float)(C->Y - A->Y) - (float)(B->Y - A->Y) * (float)(C->X - A->X);
+	float Product = VelocityPlanner_Distance(A, B) * VelocityPlanner_Distance(B, C) * VelocityPlanner_Distance(A, C);
+
+	if(Product < 1.0f)
+		return 0.0f;
+	return 2.0f * fabsf(Cross) / Product;
+}
+
+/* [cm/s] speed limit of curvature from lateral acceleration and outer wheel speed */
+static float VelocityPlanner_TurnLimit(float Curvature)
+{
+	float Limit = (float)Params.MaxWheelSpeed * Params.DistancePerRotation / 60.0f / (1.0f + Curvature * Params.TrackWidth / 2.0f);
+
+	if(Curvature > 0.0f && sqrtf(Params.MaxLateralAccel / Curvature) < Limit)
+		Limit = sqrtf(Params.MaxLateralAccel / Curvature);
+	return Limit;
+}
+
+/* [rad] heading change of a reversal at Point, first point of the new direction */
+static float VelocityPlanner_ReversalAngle(const RouteData* Route, uint16_t Point)
+{
+	const RoutePoint* Before = &Route->Point[Point - 1];
+	const RoutePoint* After = &Route->Point[Point + 1];
+	float In = atan2f((float)(Route->Point[Point].Y - Before->Y), (float)(Route->Point[Point].X - Before->X));
+	float Out = atan2f((float)(After->Y - Route->Point[Point].Y), (float)(After->X - Route->Point[Point].X));
+	float Angle = fabsf(Out - In);
+
+	if(Angle > dROUTE_PI)
+		Angle = 2.0f * dROUTE_PI - Angle;
+	/* Driven backwards, heading is opposite to the new direction */
+	return dROUTE_PI - Angle;
+}
+
+void VelocityPlanner_Init(const VelocityPlannerParams* NewParams)
+{
+	Params = *NewParams;
+	IsPlanned = false;
+}
+
+void VelocityPlanner_SetEnabled(bool Enabled)
+{
+	IsEnabled = Enabled;
+}
+
+bool VelocityPlanner_IsEnabled(void)
+{
+	return IsEnabled;
+}
+
+bool VelocityPlanner_Plan(const RouteData* Route)
+{
+	const float CmPerRpm = Params.DistancePerRotation / 60.0f;
+	uint16_t Count = Route->PointCount;
+	uint16_t SegmentStart = 0;
+	uint16_t SegmentEnd;
+	float Speed, Limit, Reachable;
+
+	IsPlanned = false;
+	if(Count == 0 || Count > dVELOCITY_PLANNER_MAX_POINTS || Params.DistancePerRotation <= 0.0f)
+		return false;
+
+	/* Limits of every point, segment is driven in one direction */
+	while(SegmentStart < Count)
+	{
+		SegmentEnd = SegmentStart;
+		while(SegmentEnd + 1 < Count && VelocityPlanner_Direction(Route, SegmentEnd + 1) == VelocityPlanner_Direction(Route, SegmentStart))
+			SegmentEnd++;
+
+		for(uint16_t i = SegmentStart; i <= SegmentEnd; i++)
+		{
+			uint16_t Before = (i >= SegmentStart + dVELOCITY_PLANNER_CURVATURE_SPAN) ? (i - dVELOCITY_PLANNER_CURVATURE_SPAN) : SegmentStart;
+			uint16_t After = (i + dVELOCITY_PLANNER_CURVATURE_SPAN <= SegmentEnd) ? (i + dVELOCITY_PLANNER_CURVATURE_SPAN) : SegmentEnd;
+
+			Speed = (float)abs(Route->Step[Route->Point[i].StepNumber].Speed) * CmPerRpm;
+			if(Before < i && i < After)
+			{
+				Limit = VelocityPlanner_TurnLimit(VelocityPlanner_Curvature(&Route->Point[Before], &Route->Point[i], &Route->Point[After]));
+				if(Limit < Speed)
+					Speed = Limit;
+			}
+			PlannedSpeed[i] = (uint16_t)(Speed / CmPerRpm + 0.5f);
+		}
+		/* After a reversal the robot turns by the angle between the segments at the start of the new one */
+		if(SegmentStart > 0 && SegmentStart < SegmentEnd)
+		{
+			Limit = VelocityPlanner_TurnLimit(VelocityPlanner_ReversalAngle(Route, SegmentStart) / (2.0f * dVELOCITY_PLANNER_CURVATURE_SPAN * dROUTE_POINTS_DISTANCE));
+			for(uint16_t i = SegmentStart; i <= SegmentEnd && i <= SegmentStart + 2 * dVELOCITY_PLANNER_CURVATURE_SPAN; i++)
+				if((float)PlannedSpeed[i] * CmPerRpm > Limit)
+					PlannedSpeed[i] = (uint16_t)(Limit / CmPerRpm + 0.5f);
+		}
+		/* Pursuit turns towards a point up to MaxLookahead ahead, the turn limit holds from there */
+		for(uint16_t i = SegmentStart; i <= SegmentEnd; i++)
+			for(uint16_t j = i + 1; j <= SegmentEnd && j <= i + Params.MaxLookahead; j++)
+				if(PlannedSpeed[j] < PlannedSpeed[i])
+					PlannedSpeed[i] = PlannedSpeed[j];
+		/* Stop to reverse, start and end of the route */
+		PlannedSpeed[SegmentStart] = 0;
+		PlannedSpeed[SegmentEnd] = 0;
+		SegmentStart = SegmentEnd + 1;
+	}
+
+	/* Backward pass, slow down in time, then forward pass, speed up no faster than MaxAccel */
+	for(int32_t i = (int32_t)Count - 2; i >= 0; i--)
+	{
+		Speed = (float)PlannedSpeed[i + 1] * CmPerRpm;
+		Reachable = sqrtf(Speed*Speed + 2.0f * Params.MaxAccel * VelocityPlanner_Distance(&Route->Point[i], &Route->Point[i + 1]));
+		if((float)PlannedSpeed[i] * CmPerRpm > Reachable)
+			PlannedSpeed[i] = (uint16_t)(Reachable / CmPerRpm);
+	}
+	for(uint16_t i = 1; i < Count; i++)
+	{
+		Speed = (float)PlannedSpeed[i - 1] * CmPerRpm;
+		Reachable = sqrtf(Speed*Speed + 2.0f * Params.MaxAccel * VelocityPlanner_Distance(&Route->Point[i - 1], &Route->Point[i]));
+		if((float)PlannedSpeed[i] * CmPerRpm > Reachable)
+			PlannedSpeed[i] = (uint16_t)(Reachable / CmPerRpm);
+	}
+
+	IsPlanned = true;
+	return true;
+}
+
+int16_t VelocityPlanner_GetSpeed(const RouteData* Route, uint16_t Point)
+{
+	int16_t StepSpeed = Route->Step[Route->Point[Point].StepNumber].Speed;
+	uint16_t Speed;
+
+	if(!IsEnabled || !IsPlanned || Point >= Route->PointCount)
+		return StepSpeed;
+
+	/* Never stand still on the route, pursuit would stop there */
+	Speed = PlannedSpeed[Point];
+	if(Speed < Params.MinSpeed)
+		Speed = Params.MinSpeed;
+	if(Speed > abs(StepSpeed))
+		Speed = (uint16_t)abs(StepSpeed);
+	return (StepSpeed < 0) ? -(int16_t)Speed : (int16_t)Speed;
+}
+
+int16_t VelocityPlanner_LimitSteering(int16_t Speed, float Steering)
+{
+	float Limit;
+
+	if(!IsEnabled || !IsPlanned)
+		return Speed;
+
+	/* Wheels at Speed (1 +- Steering) drive a curvature of 2 Steering / TrackWidth */
+	Limit = VelocityPlanner_TurnLimit(2.0f * fabsf(Steering) / Params.TrackWidth) * 60.0f / Params.DistancePerRotation;
+	if(Limit < Params.MinSpeed)
+		Limit = Params.MinSpeed;
+	if(abs(Speed) <= Limit)
+		return Speed;
+	return (Speed < 0) ? -(int16_t)Limit : (int16_t)Limit;
+}
+
+uint8_t VelocityPlanner_GetLookahead(int16_t Speed)
+{
+	float Points;
+
+	if(!IsEnabled || !IsPlanned)
+		return dVELOCITY_PLANNER_FIXED_LOOKAHEAD;
+
+	Points = (float)abs(Speed) * Params.DistancePerRotation / 60.0f * Params.LookaheadTime / dROUTE_POINTS_DISTANCE + 0.5f;
+	if(Points < Params.MinLookahead)
+		return Params.MinLookahead;
+	if(Points > Params.MaxLookahead)
+		return Params.MaxLookahead;
+	return (uint8_t)Points;
+}
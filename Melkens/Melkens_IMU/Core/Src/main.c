@@ -25,12 +25,19 @@
 #include "lis3mdl_reg.h"
 #include "IMU_func.h"
 #include "TimeManager.h"
+#include "TimeBase.h"
 #include "UartHandler.h"
 #include "MagnetsHandler.h"
 #include "ConnectivityHandler.h"
 #include "DataTypes.h"
 #include <stdio.h>
 #include "routeManager.h"
+#include "RouteStore.h"
+#include "TaskScheduler.h"
+#include "CRC16.h"
+#include "Loader.h"
+#include "DebugUart.h"
+#include "BinLog.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -40,6 +47,8 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+/* Task budgets are measured with DWT cycle counter (HCLK 160MHz) */
+#define TASK_BUDGET_US(us)	((uint32_t)(us) * 160u)
 
 /* USER CODE END PD */
 
@@ -51,6 +60,28 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
+static void Main_ToggleLed(void);
+static uint32_t Main_GetCycles(void);
+static void Main_ReportTasks(void);
+
+/* 100ms tasks are spread with phase offsets instead of firing in one tick */
+static const Task MainTasks[] = {
+	/* Function					Period	Phase	Budget				Policy */
+	{ IMU_Perform1ms,			1,		0,		TASK_BUDGET_US(200),	TaskPolicy_Skip, 0 },
+	{ RouteManager_Perform1ms,	1,		0,		TASK_BUDGET_US(200),	TaskPolicy_Skip, 0 },
+	{ IMU_SendRequestedDataToPMB,1,		0,		TASK_BUDGET_US(50),		TaskPolicy_Skip, 0 },
+	{ UartHandler_Check_Overrun,100,	3,		TASK_BUDGET_US(20),		TaskPolicy_Skip, 0 },
+	{ Main_ToggleLed,			100,	3,		0,						TaskPolicy_Skip, 0 },
+	{ MagnetsHandler_Perform1ms,100,	21,		TASK_BUDGET_US(50),		TaskPolicy_Skip, 0 },
+	{ IMU_SendDataToPMB,		100,	41,		TASK_BUDGET_US(50),		TaskPolicy_Skip, 0 },
+	{ Main_ReportTasks,			10000,	61,		0,						TaskPolicy_Skip, 0 },
+	{ DebugUart_Sample1ms,		1,		0,		TASK_BUDGET_US(20),		TaskPolicy_Skip, 0 },
+};
+
+#define MAIN_TASKS_NUM (sizeof(MainTasks) / sizeof(MainTasks[0]))
+
+static TaskControl MainTasksControl[MAIN_TASKS_NUM];
+static TaskScheduler MainScheduler;
 
 /* USER CODE END PV */
 
@@ -68,6 +99,30 @@ static void MX_LPUART1_UART_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+static void Main_ToggleLed(void)
+{
+	HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
+}
+
+static uint32_t Main_GetCycles(void)
+{
+	return DWT->CYCCNT;
+}
+
+/* Task stats of the last 10 s to the debug log, then a new window */
+static void Main_ReportTasks(void)
+{
+	const TaskStats *Stats;
+	uint8_t i;
+
+	for(i = 0; i < MAIN_TASKS_NUM; i++)
+	{
+		Stats = TaskScheduler_GetStats(&MainScheduler, i);
+		BINLOG("task %u: max %u cycles, %u overruns, %u late or skipped", i, Stats->MaxTime,
+				Stats->BudgetOverruns, Stats->Late + Stats->Skipped);
+	}
+	TaskScheduler_ResetStats(&MainScheduler);
+}
 
 /* USER CODE END 0 */
 
@@ -127,13 +182,31 @@ int main(void)
   IMU_i2c_init();
 
   TimeManager_Init();
+  CRC16_Init();
+  TimeBase_Init();
+  IMU_InitPmbLink();
+  IMU_RegisterScopeChannels();
   connectivityHandlerInit();
+  Loader_Init();
   IMU_ResetDataReady();
   NVIC_EnableIRQ(EXTI9_5_IRQn);
   MagnetsHandler_Init();
   HAL_GPIO_WritePin(LED3_GPIO_Port, LED3_Pin,GPIO_PIN_RESET);
+  RouteStore_Init();
   RouteManager_Init();
 
+  /* Cycle counter used for task execution time measurement */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  DebugUart_Init();
+  TaskScheduler_Init(&MainScheduler, MainTasks, MainTasksControl, MAIN_TASKS_NUM, Main_GetCycles, TimeManager_GetSystemTick());
+  /* Cost of the 1ms tasks on the scope, the sampling task included [cycles] */
+  Scope_Register("task.imu.cycles", &TaskScheduler_GetStats(&MainScheduler, 0)->LastTime, dSCOPE_TYPE_UINT32);
+  Scope_Register("task.route.cycles", &TaskScheduler_GetStats(&MainScheduler, 1)->LastTime, dSCOPE_TYPE_UINT32);
+  Scope_Register("task.scope.cycles", &TaskScheduler_GetStats(&MainScheduler, MAIN_TASKS_NUM - 1)->LastTime, dSCOPE_TYPE_UINT32);
+
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -147,25 +220,12 @@ int main(void)
 
 	  if(TimeManager_Is1msPassed())
 	  {
-      IMU_Perform1ms();
-      RouteManager_Perform1ms();
-
+		  /* Periodic tasks, see MainTasks table for periods and phase offsets */
+		  TaskScheduler_Perform(&MainScheduler, TimeManager_GetSystemTick());
 	  }
-	  if(TimeManager_Is10msPassed())
-	  {
 
-	  }
-	  if(TimeManager_Is100msPassed())
-	  {
-
-		  UartHandler_Check_Overrun();
-
-		  HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
-
-		  MagnetsHandler_Perform1ms();//1ms?????
-		  IMU_SendDataToPMB();
-		  IMU_SendDataToPC();
-	  }
+	  /* Log records go out whenever the debug UART is free */
+	  DebugUart_Perform();
 
 	  TimeManager_UpdateFlags();
 
@@ -784,7 +844,7 @@ static void MX_USART3_UART_Init(void)
 
 
    LL_DMA_SetDataLength(DMA1, LL_DMA_CHANNEL_3, UART3_TX_MESSAGE_LEN); /* 13Bytes -> W;RRR;LLL;33\n -> WheelSpeed; RightWheel int8, LeftWheel int8, Dummy CRC  */
-   LL_DMA_SetDataLength(DMA1, LL_DMA_CHANNEL_4, UART3_RX_MESSAGE_LEN); /* Currently only 1-way communication */
+   LL_DMA_SetDataLength(DMA1, LL_DMA_CHANNEL_4, UART3_RX_MESSAGE_LEN); /* Scope commands from PC */
 
 
    LL_USART_EnableDMAReq_RX(USART3);
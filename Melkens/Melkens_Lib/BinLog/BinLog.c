@@ -0,0 +1,200 @@
+#include "BinLog.h"
+#include "../CRC16/CRC16.h"
+#include <stddef.h>
+
+#define dBINLOG_RING_MASK       (BINLOG_RING_WORDS - 1u)
+#define dBINLOG_WORDS_MASK      0x0Fu
+
+#if (BINLOG_RING_WORDS & dBINLOG_RING_MASK) != 0u || BINLOG_RING_WORDS > 0x8000u
+#error "BINLOG_RING_WORDS must be a power of 2 up to 32768"
+#endif
+
+// Head and Tail run free, Head - Tail words are in use. Producers reserve with
+// a compare and swap on Head (LDREX/STREX on Cortex-M, no interrupt lock) and
+// store the record header last; a zero header is a record still being written.
+// The consumer zeroes the words it took before it moves Tail.
+static uint32_t Ring[BINLOG_RING_WORDS];
+static uint32_t Head;
+static uint32_t Tail;
+static uint32_t Dropped;        // since last frame
+static BinLog_TimeSource GetTime;
+static BinLogStats Stats;
+static uint8_t Sequence;
+
+static void BinLog_Put16(uint8_t *data, uint16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void BinLog_Put32(uint8_t *data, uint32_t value)
+{
+    BinLog_Put16(data, (uint16_t)value);
+    BinLog_Put16(&data[2], (uint16_t)(value >> 16));
+}
+
+// Index of the first word of a free record, false when the ring is full
+static bool BinLog_Reserve(uint32_t words, uint32_t *head)
+{
+    uint32_t start = __atomic_load_n(&Head, __ATOMIC_RELAXED);
+
+    do {
+        if ((start + words - __atomic_load_n(&Tail, __ATOMIC_ACQUIRE)) > BINLOG_RING_WORDS) {
+            __atomic_fetch_add(&Dropped, 1u, __ATOMIC_RELAXED);
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(&Head, &start, start + words, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    *head = start;
+    return true;
+}
+
+static void BinLog_Commit(uint32_t head, uint16_t id, uint32_t words)
+{
+    __atomic_store_n(&Ring[head & dBINLOG_RING_MASK], ((uint32_t)id << 16) | words, __ATOMIC_RELEASE);
+}
+
+void BinLog_Init(BinLog_TimeSource getTime)
+{
+    uint32_t i;
+
+    for (i = 0; i < BINLOG_RING_WORDS; i++) {
+        Ring[i] = 0;
+    }
+    Head = 0;
+    Tail = 0;
+    Dropped = 0;
+    Sequence = 0;
+    Stats.Records = 0;
+    Stats.Dropped = 0;
+    Stats.MaxUsed = 0;
+    GetTime = getTime;
+}
+
+void BinLog_Write0(uint16_t id)
+{
+    uint32_t head;
+
+    if (BinLog_Reserve(2u, &head)) {
+        Ring[(head + 1u) & dBINLOG_RING_MASK] = GetTime();
+        BinLog_Commit(head, id, 2u);
+    }
+}
+
+void BinLog_Write1(uint16_t id, uint32_t a)
+{
+    uint32_t head;
+
+    if (BinLog_Reserve(3u, &head)) {
+        Ring[(head + 1u) & dBINLOG_RING_MASK] = GetTime();
+        Ring[(head + 2u) & dBINLOG_RING_MASK] = a;
+        BinLog_Commit(head, id, 3u);
+    }
+}
+
+void BinLog_Write2(uint16_t id, uint32_t a, uint32_t b)
+{
+    uint32_t head;
+
+    if (BinLog_Reserve(4u, &head)) {
+        Ring[(head + 1u) & dBINLOG_RING_MASK] = GetTime();
+        Ring[(head + 2u) & dBINLOG_RING_MASK] = a;
+        Ring[(head + 3u) & dBINLOG_RING_MASK] = b;
+        BinLog_Commit(head, id, 4u);
+    }
+}
+
+void BinLog_Write3(uint16_t id, uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t head;
+
+    if (BinLog_Reserve(5u, &head)) {
+        Ring[(head + 1u) & dBINLOG_RING_MASK] = GetTime();
+        Ring[(head + 2u) & dBINLOG_RING_MASK] = a;
+        Ring[(head + 3u) & dBINLOG_RING_MASK] = b;
+        Ring[(head + 4u) & dBINLOG_RING_MASK] = c;
+        BinLog_Commit(head, id, 5u);
+    }
+}
+
+void BinLog_Write4(uint16_t id, uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+    uint32_t head;
+
+    if (BinLog_Reserve(6u, &head)) {
+        Ring[(head + 1u) & dBINLOG_RING_MASK] = GetTime();
+        Ring[(head + 2u) & dBINLOG_RING_MASK] = a;
+        Ring[(head + 3u) & dBINLOG_RING_MASK] = b;
+        Ring[(head + 4u) & dBINLOG_RING_MASK] = c;
+        Ring[(head + 5u) & dBINLOG_RING_MASK] = d;
+        BinLog_Commit(head, id, 6u);
+    }
+}
+
+bool BinLog_IsEmpty(void)
+{
+    return (__atomic_load_n(&Head, __ATOMIC_RELAXED) == Tail) && (__atomic_load_n(&Dropped, __ATOMIC_RELAXED) == 0u);
+}
+
+uint16_t BinLog_MakeFrame(uint8_t *frame, uint8_t type, uint8_t sequence, uint16_t length)
+{
+    uint16_t crcOffset = (uint16_t)(dBINLOG_FRAME_HEADER_SIZE + length);
+
+    frame[0] = dBINLOG_FRAME_SYNC0;
+    frame[1] = dBINLOG_FRAME_SYNC1;
+    frame[2] = type;
+    frame[3] = sequence;
+    BinLog_Put16(&frame[4], length);
+    BinLog_Put16(&frame[crcOffset], CRC16(&frame[2], (uint16_t)(crcOffset - 2u)));
+    return (uint16_t)(crcOffset + dBINLOG_FRAME_CRC_SIZE);
+}
+
+uint16_t BinLog_Drain(uint8_t *frame, uint16_t size, uint32_t tick)
+{
+    uint8_t *payload = &frame[dBINLOG_FRAME_HEADER_SIZE];
+    uint16_t length = dBINLOG_LOG_HEADER_SIZE;
+    uint16_t room = (uint16_t)(size - dBINLOG_FRAME_OVERHEAD);
+    uint32_t used = __atomic_load_n(&Head, __ATOMIC_RELAXED) - Tail;
+    uint32_t tail = Tail;
+    uint32_t dropped;
+    uint32_t header, words, i;
+
+    if (used > Stats.MaxUsed) {
+        Stats.MaxUsed = (uint16_t)used;
+    }
+    while ((header = __atomic_load_n(&Ring[tail & dBINLOG_RING_MASK], __ATOMIC_ACQUIRE)) != 0u) {
+        words = header & dBINLOG_WORDS_MASK;
+        if ((uint32_t)(length + words * 4u) > room) {
+            break;
+        }
+        for (i = 0; i < words; i++) {
+            BinLog_Put32(&payload[length], Ring[(tail + i) & dBINLOG_RING_MASK]);
+            Ring[(tail + i) & dBINLOG_RING_MASK] = 0;
+            length = (uint16_t)(length + 4u);
+        }
+        tail += words;
+        Stats.Records++;
+    }
+    __atomic_store_n(&Tail, tail, __ATOMIC_RELEASE);
+
+    dropped = __atomic_exchange_n(&Dropped, 0u, __ATOMIC_RELAXED);
+    if (dropped > UINT16_MAX) {
+        // rest goes with the next frame
+        __atomic_fetch_add(&Dropped, dropped - UINT16_MAX, __ATOMIC_RELAXED);
+        dropped = UINT16_MAX;
+    }
+    Stats.Dropped += dropped;
+    if (length == dBINLOG_LOG_HEADER_SIZE && dropped == 0u) {
+        return 0;
+    }
+    BinLog_Put32(&payload[0], tick);
+    BinLog_Put32(&payload[4], GetTime());
+    BinLog_Put16(&payload[8], (uint16_t)dropped);
+    BinLog_Put16(&payload[10], 0);
+    return BinLog_MakeFrame(frame, dBINLOG_FRAME_LOG, Sequence++, length);
+}
+
+void BinLog_GetStats(BinLogStats *stats)
+{
+    *stats = Stats;
+}
@@ -0,0 +1,128 @@
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deferred binary log. BINLOG("fmt", args) stores the id of its format string,
+// a timestamp of the time source and up to 4 arguments as raw 32-bit words in
+// a ring; formatting is done on the PC by Tools/BinLog/binlog.py, which reads
+// the format strings from the ELF (section binlog, not loaded on the MCU).
+// Any context may log, interrupts included: a record is reserved with one
+// compare and swap on the ring head and written in place, no lock, no
+// formatting, about 60 cycles on the IMU. A full ring drops the record and
+// counts it. BinLog_Drain packs records into frames from the main loop.
+//
+// Arguments are integers or floats (sent as float bits, use %f, %e or %g for
+// them). The host takes %d/%i as signed, %u/%x/%X/%c as unsigned;
+// no strings, no 64-bit values. The format must not be empty.
+//
+// Frame, little endian, also carries other debug streams of the same UART:
+//
+//   0  u8  dBINLOG_FRAME_SYNC0
+//   1  u8  dBINLOG_FRAME_SYNC1
+//   2  u8  type, dBINLOG_FRAME_...
+//   3  u8  sequence, counts frames of the type
+//   4  u16 length of payload
+//   6      payload
+//   6+length u16 CRC16 of bytes 2 .. 6+length-1
+//
+// LOG payload: u32 tick [ms] and u32 time source at drain, u16 records dropped
+// since last frame, u16 reserved, then records: u32 header (format id << 16,
+// record words in bits 3..0), u32 time source at the call, u32 arguments.
+
+#define dBINLOG_FRAME_SYNC0         0x42    // "BL"
+#define dBINLOG_FRAME_SYNC1         0x4C
+#define dBINLOG_FRAME_HEADER_SIZE   6u
+#define dBINLOG_FRAME_CRC_SIZE      2u
+#define dBINLOG_FRAME_OVERHEAD      (dBINLOG_FRAME_HEADER_SIZE + dBINLOG_FRAME_CRC_SIZE)
+
+#define dBINLOG_FRAME_LOG           1
+#define dBINLOG_FRAME_SCOPE_DATA    2       // Melkens_Lib/Scope
+#define dBINLOG_FRAME_SCOPE_INFO    3
+#define dBINLOG_FRAME_SCOPE_LIST    4       // PC to MCU
+#define dBINLOG_FRAME_SCOPE_SELECT  5       // PC to MCU
+
+#define dBINLOG_LOG_HEADER_SIZE     12u     // tick, time, dropped, reserved
+#define dBINLOG_MAX_ARGS            4u
+#define dBINLOG_RECORD_MAX          ((2u + dBINLOG_MAX_ARGS) * 4u)
+
+// Ring size in 32-bit words, power of 2. A record takes 2 words + 1 per argument.
+#ifndef BINLOG_RING_WORDS
+#define BINLOG_RING_WORDS           512u
+#endif
+
+typedef uint32_t (*BinLog_TimeSource)(void);
+
+typedef struct BinLogStats_t {
+    uint32_t Records;       // written to frames
+    uint32_t Dropped;       // ring was full
+    uint16_t MaxUsed;       // [words] ring fill seen by BinLog_Drain
+} BinLogStats;
+
+// Before the first record, getTime gives the record timestamps (cycle counter)
+void BinLog_Init(BinLog_TimeSource getTime);
+void BinLog_Write0(uint16_t id);
+void BinLog_Write1(uint16_t id, uint32_t a);
+void BinLog_Write2(uint16_t id, uint32_t a, uint32_t b);
+void BinLog_Write3(uint16_t id, uint32_t a, uint32_t b, uint32_t c);
+void BinLog_Write4(uint16_t id, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+
+bool BinLog_IsEmpty(void);
+// One consumer only. Writes a LOG frame of the records logged so far to frame
+// (size bytes, at least dBINLOG_FRAME_OVERHEAD + dBINLOG_LOG_HEADER_SIZE +
+// dBINLOG_RECORD_MAX), returns its length, 0 when there is nothing to send.
+// A record still being written ends the frame, it goes with the next one.
+uint16_t BinLog_Drain(uint8_t *frame, uint16_t size, uint32_t tick);
+// Adds sync, type, sequence, length and CRC around length payload bytes
+// already at frame + dBINLOG_FRAME_HEADER_SIZE, returns the frame length
+uint16_t BinLog_MakeFrame(uint8_t *frame, uint8_t type, uint8_t sequence, uint16_t length);
+void BinLog_GetStats(BinLogStats *stats);
+
+// Offset of the format in section binlog. The MCU linker script places the
+// section at address 0 (INFO, no flash used) and provides __start_binlog,
+// other GNU linkers provide it for the orphan section.
+extern const char __start_binlog[];
+#define BINLOG_ID(format)   ((uint16_t)((uintptr_t)(format) - (uintptr_t)__start_binlog))
+
+static inline uint32_t BinLog_Word(uint32_t value)
+{
+    return value;
+}
+
+static inline uint32_t BinLog_Float(float value)
+{
+    union { float f; uint32_t u; } bits = { value };
+
+    return bits.u;
+}
+
+// Integers as they are, floats and doubles as float bits; cast pointers to uintptr_t
+#define BINLOG_ARG(x)   _Generic((x), float: BinLog_Float, double: BinLog_Float, default: BinLog_Word)(x)
+
+#define BINLOG_COUNT(...)                       BINLOG_COUNT_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define BINLOG_COUNT_(_0, _1, _2, _3, _4, n, ...)  n
+#define BINLOG_CALL(n)                          BINLOG_CALL_(n)
+#define BINLOG_CALL_(n)                         BINLOG_WRITE##n
+
+#define BINLOG_WRITE0(id)               BinLog_Write0(id)
+#define BINLOG_WRITE1(id, a)            BinLog_Write1(id, BINLOG_ARG(a))
+#define BINLOG_WRITE2(id, a, b)         BinLog_Write2(id, BINLOG_ARG(a), BINLOG_ARG(b))
+#define BINLOG_WRITE3(id, a, b, c)      BinLog_Write3(id, BINLOG_ARG(a), BINLOG_ARG(b), BINLOG_ARG(c))
+#define BINLOG_WRITE4(id, a, b, c, d)   BinLog_Write4(id, BINLOG_ARG(a), BINLOG_ARG(b), BINLOG_ARG(c), BINLOG_ARG(d))
+
+#define BINLOG(format, ...) \
+    do { \
+        static const char BinLog_Format[] __attribute__((section("binlog"), used)) = format; \
+        BINLOG_CALL(BINLOG_COUNT(__VA_ARGS__))(BINLOG_ID(BinLog_Format), ##__VA_ARGS__); \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BINLOG_H
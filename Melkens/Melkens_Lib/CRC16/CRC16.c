@@ -1,6 +1,13 @@
 
 #include "CRC16.h"
 
+#define dCRC16_POLY 0x8005
+
+#define CRC16_IS_SLICING    ((CRC16_BACKEND == dCRC16_BACKEND_SLICING4) || (CRC16_BACKEND == dCRC16_BACKEND_SLICING8))
+#define CRC16_IS_HARDWARE   ((CRC16_BACKEND == dCRC16_BACKEND_STM32) || (CRC16_BACKEND == dCRC16_BACKEND_DSPIC))
+#define CRC16_IS_TABLE      ((CRC16_BACKEND == dCRC16_BACKEND_TABLE) || CRC16_IS_SLICING)
+
+#if CRC16_IS_TABLE
 // Tabela CRC-16/MODBUS, polinom 0xA001 (reversed 0x8005)
 static const uint16_t crc16_table[256] = {
     0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
@@ -36,12 +43,114 @@ static const uint16_t crc16_table[256] = {
     0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
     0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
 };
+#endif
 
-uint16_t CRC16(const uint8_t *data, uint16_t length) {
-    uint16_t crc = 0xFFFF;
+#if CRC16_IS_SLICING
+#if CRC16_BACKEND == dCRC16_BACKEND_SLICING4
+#define dCRC16_SLICES 4
+#else
+#define dCRC16_SLICES 8
+#endif
+// crc16_slices[k][i]: byte i followed by k zero bytes, crc16_slices[0] is crc16_table
+static uint16_t crc16_slices[dCRC16_SLICES][256];
+#endif
+
+#if CRC16_IS_HARDWARE
+// CRC16_Stm32.c / CRC16_dsPIC.c
+void CRC16_InitHardware(void);
+uint16_t CRC16_UpdateHardware(uint16_t crc, const uint8_t *data, uint16_t length);
+#endif
+
+uint16_t CRC16_Reflect(uint16_t value) {
+    static const uint8_t nibbles[16] = {
+        0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+    };
+
+    return (uint16_t)(((uint16_t)nibbles[value & 0xF] << 12) | ((uint16_t)nibbles[(value >> 4) & 0xF] << 8)
+                      | ((uint16_t)nibbles[(value >> 8) & 0xF] << 4) | nibbles[value >> 12]);
+}
+
+#if CRC16_IS_TABLE
+static uint16_t CRC16_UpdateTable(uint16_t crc, const uint8_t *data, uint16_t length) {
     while (length--) {
         uint8_t index = crc ^ *data++;
         crc = (crc >> 8) ^ crc16_table[index];
     }
     return crc;
-}
\ No newline at end of file
+}
+#endif
+
+#if CRC16_IS_SLICING
+static uint16_t CRC16_UpdateSlicing(uint16_t crc, const uint8_t *data, uint16_t length) {
+    const uint16_t (*t)[256] = crc16_slices;
+
+    while (length >= dCRC16_SLICES) {
+        // First two bytes meet the register, the rest only need their own table
+        crc ^= (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+#if dCRC16_SLICES == 4
+        crc = t[3][crc & 0xFF] ^ t[2][crc >> 8] ^ t[1][data[2]] ^ t[0][data[3]];
+#else
+        crc = t[7][crc & 0xFF] ^ t[6][crc >> 8] ^ t[5][data[2]] ^ t[4][data[3]]
+              ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+#endif
+        data += dCRC16_SLICES;
+        length -= dCRC16_SLICES;
+    }
+    return CRC16_UpdateTable(crc, data, length);
+}
+#endif
+
+#if CRC16_BACKEND == dCRC16_BACKEND_BITWISE
+// Same configuration as the hardware backends: MSB first register with
+// poly 0x8005, each byte fed LSB first, register reflected in and out
+static uint16_t CRC16_UpdateBitwise(uint16_t crc, const uint8_t *data, uint16_t length) {
+    uint16_t reg = CRC16_Reflect(crc);
+    uint8_t bit;
+
+    while (length--) {
+        uint8_t byte = *data++;
+        for (bit = 0; bit < 8; bit++) {
+            uint16_t feedback = (uint16_t)(((reg >> 15) ^ byte) & 1);
+            reg <<= 1;
+            if (feedback) {
+                reg ^= dCRC16_POLY;
+            }
+            byte >>= 1;
+        }
+    }
+    return CRC16_Reflect(reg);
+}
+#endif
+
+void CRC16_Init(void) {
+#if CRC16_IS_SLICING
+    uint16_t i;
+    uint8_t slice;
+
+    for (i = 0; i < 256; i++) {
+        crc16_slices[0][i] = crc16_table[i];
+        for (slice = 1; slice < dCRC16_SLICES; slice++) {
+            uint16_t previous = crc16_slices[slice - 1][i];
+            crc16_slices[slice][i] = (previous >> 8) ^ crc16_table[previous & 0xFF];
+        }
+    }
+#elif CRC16_IS_HARDWARE
+    CRC16_InitHardware();
+#endif
+}
+
+uint16_t CRC16(const uint8_t *data, uint16_t length) {
+    return CRC16_Update(dCRC16_INIT, data, length);
+}
+
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint16_t length) {
+#if CRC16_IS_SLICING
+    return CRC16_UpdateSlicing(crc, data, length);
+#elif CRC16_BACKEND == dCRC16_BACKEND_BITWISE
+    return CRC16_UpdateBitwise(crc, data, length);
+#elif CRC16_IS_HARDWARE
+    return CRC16_UpdateHardware(crc, data, length);
+#else
+    return CRC16_UpdateTable(crc, data, length);
+#endif
+}
@@ -7,7 +7,39 @@
 extern "C" {
 #endif
 
+// CRC-16/MODBUS (poly 0x8005 reflected, init 0xFFFF, no final xor) with a
+// backend chosen at build time, all backends give the same result.
+// Hardware backends use the single CRC unit of the MCU, call CRC16 from one
+// context only (main loop on IMU and PMB).
+
+#define dCRC16_INIT 0xFFFF
+
+#define dCRC16_BACKEND_TABLE      0   // byte table, 512 B
+#define dCRC16_BACKEND_SLICING4   1   // 4 bytes per step, 2 KB tables in RAM
+#define dCRC16_BACKEND_SLICING8   2   // 8 bytes per step, 4 KB tables in RAM
+#define dCRC16_BACKEND_BITWISE    3   // model of the hardware configuration, reference only
+#define dCRC16_BACKEND_STM32      4   // STM32G4 CRC unit, CRC16_Stm32.c
+#define dCRC16_BACKEND_DSPIC      5   // dsPIC33CK CRC module, CRC16_dsPIC.c
+
+// Override with -DCRC16_BACKEND=dCRC16_BACKEND_...
+#ifndef CRC16_BACKEND
+#if defined(__XC16__)
+#define CRC16_BACKEND dCRC16_BACKEND_DSPIC
+#elif defined(STM32G473xx)
+#define CRC16_BACKEND dCRC16_BACKEND_STM32
+#else
+#define CRC16_BACKEND dCRC16_BACKEND_SLICING8   // ESP32 and host
+#endif
+#endif
+
+// Once before first CRC16, builds slicing tables or configures the CRC unit
+void CRC16_Init(void);
 uint16_t CRC16(const uint8_t *data, uint16_t length);
+/* Continues CRC16 over next part of data, start with dCRC16_INIT */
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint16_t length);
+
+// Hardware units run the CRC MSB first: reflected register in and out
+uint16_t CRC16_Reflect(uint16_t value);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,39 @@
+
+#include "CRC16.h"
+
+#if CRC16_BACKEND == dCRC16_BACKEND_STM32
+#include <string.h>
+#include "stm32g4xx.h"
+#include "stm32g4xx_ll_bus.h"
+
+// STM32G4 CRC unit: 16 bit poly 0x8005, input bit reversed per byte, output
+// reversed. INIT is not reversed by the unit, it gets the reflected running
+// value. The unit takes a 32 bit word per AHB write, so the CPU feeds it
+// directly, DMA setup would cost more than a whole frame.
+
+void CRC16_InitHardware(void) {
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_CRC);
+    CRC->POL = 0x8005;
+    CRC->CR = CRC_CR_POLYSIZE_0 | CRC_CR_REV_IN_0 | CRC_CR_REV_OUT;
+}
+
+uint16_t CRC16_UpdateHardware(uint16_t crc, const uint8_t *data, uint16_t length) {
+    uint32_t word;
+
+    CRC->INIT = CRC16_Reflect(crc);
+    CRC->CR |= CRC_CR_RESET;
+
+    while (length >= sizeof(word)) {
+        memcpy(&word, data, sizeof(word));
+        // First byte in memory has to be shifted in first, from the top of DR
+        CRC->DR = __REV(word);
+        data += sizeof(word);
+        length -= sizeof(word);
+    }
+    while (length--) {
+        *(__IO uint8_t *)&CRC->DR = *data++;
+    }
+    return (uint16_t)CRC->DR;
+}
+
+#endif
@@ -0,0 +1,46 @@
+
+#include "CRC16.h"
+
+#if CRC16_BACKEND == dCRC16_BACKEND_DSPIC
+#include <xc.h>
+
+// dsPIC33CK programmable CRC module in alternate mode: 16 bit poly 0x8005,
+// 8 bit data shifted LSb first, register reflected in and out in software.
+// The module shifts while the CPU fills its FIFO, CRCIF is set when done.
+
+void CRC16_InitHardware(void) {
+    CRCCONL = 0;
+    CRCCONH = 0;
+    CRCCONLbits.MOD = 1;        // result ready without shifting in zeros
+    CRCCONLbits.LENDIAN = 1;    // data LSb first
+    CRCCONLbits.CRCISEL = 1;    // CRCIF when last bit is shifted
+    CRCCONHbits.PLEN = 15;      // 16 bit polynomial
+    CRCCONHbits.DWIDTH = 7;     // 8 bit data
+    CRCXORL = 0x8005;
+    CRCXORH = 0;
+    CRCCONLbits.CRCEN = 1;
+}
+
+uint16_t CRC16_UpdateHardware(uint16_t crc, const uint8_t *data, uint16_t length) {
+    if (length == 0) {
+        return crc;
+    }
+
+    CRCWDATL = CRC16_Reflect(crc);
+    CRCWDATH = 0;
+    _CRCIF = 0;
+    CRCCONLbits.CRCGO = 1;
+    while (length--) {
+        while (CRCCONLbits.CRCFUL) {
+        }
+        *(volatile uint8_t *)&CRCDATL = *data++;
+    }
+    while (!_CRCIF) {
+    }
+    CRCCONLbits.CRCGO = 0;
+    _CRCIF = 0;
+
+    return CRC16_Reflect(CRCWDATL);
+}
+
+#endif
@@ -0,0 +1,653 @@
+#include "FwUpdate.h"
+#include "../CRC16/CRC16.h"
+#include <string.h>
+
+#define dFW_READ_CHUNK      64u     // bytes read at once for CRC and erase checks
+#define dFW_PROGRAM_MAX     16u
+
+static void FwUpdate_Put16(uint8_t *data, uint16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void FwUpdate_Put32(uint8_t *data, uint32_t value)
+{
+    FwUpdate_Put16(data, (uint16_t)value);
+    FwUpdate_Put16(&data[2], (uint16_t)(value >> 16));
+}
+
+static uint16_t FwUpdate_Get16(const uint8_t *data)
+{
+    return (uint16_t)(data[0] | ((uint16_t)data[1] << 8));
+}
+
+static uint32_t FwUpdate_Get32(const uint8_t *data)
+{
+    return FwUpdate_Get16(data) | ((uint32_t)FwUpdate_Get16(&data[2]) << 16);
+}
+
+static bool FwUpdate_IsErased(const uint8_t *data, uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0; i < length; i++) {
+        if (data[i] != 0xFFu) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Packets */
+
+void FwParser_Init(FwParser *parser)
+{
+    parser->Length = 0;
+    parser->IsComplete = false;
+}
+
+// 1: packet complete and valid, 0: more bytes needed, -1: bytes do not start a packet
+static int FwParser_Check(const FwParser *parser)
+{
+    uint16_t length, total;
+
+    if (parser->Length >= 1u && parser->Buffer[0] != dFW_PACKET_SYNC0) {
+        return -1;
+    }
+    if (parser->Length >= 2u && parser->Buffer[1] != dFW_PACKET_SYNC1) {
+        return -1;
+    }
+    if (parser->Length < dFW_PACKET_HEADER_SIZE) {
+        return 0;
+    }
+    length = FwUpdate_Get16(&parser->Buffer[6]);
+    if (length > dFW_BLOCK_SIZE) {
+        return -1;
+    }
+    total = (uint16_t)(dFW_PACKET_HEADER_SIZE + length + dFW_PACKET_CRC_SIZE);
+    if (parser->Length < total) {
+        return 0;
+    }
+    if (FwUpdate_Get16(&parser->Buffer[total - dFW_PACKET_CRC_SIZE]) !=
+        CRC16(&parser->Buffer[2], (uint16_t)(total - dFW_PACKET_CRC_SIZE - 2u))) {
+        return -1;
+    }
+    return 1;
+}
+
+bool FwParser_Feed(FwParser *parser, uint8_t byte)
+{
+    uint16_t skip;
+    int check;
+
+    if (parser->IsComplete) {
+        parser->Length = 0;
+        parser->IsComplete = false;
+    }
+    parser->Buffer[parser->Length++] = byte;
+
+    for (;;) {
+        check = FwParser_Check(parser);
+        if (check >= 0) {
+            parser->IsComplete = (check > 0);
+            return parser->IsComplete;
+        }
+        // start again at the next sync byte, a packet may begin inside the bad one
+        for (skip = 1; skip < parser->Length && parser->Buffer[skip] != dFW_PACKET_SYNC0; skip++) {
+        }
+        parser->Length = (uint16_t)(parser->Length - skip);
+        memmove(parser->Buffer, &parser->Buffer[skip], parser->Length);
+    }
+}
+
+uint16_t FwPacket_Make(uint8_t *packet, uint8_t command, uint8_t target, uint16_t sequence,
+                       const uint8_t *data, uint16_t length)
+{
+    uint16_t crcOffset = (uint16_t)(dFW_PACKET_HEADER_SIZE + length);
+
+    packet[0] = dFW_PACKET_SYNC0;
+    packet[1] = dFW_PACKET_SYNC1;
+    packet[2] = command;
+    packet[3] = target;
+    FwUpdate_Put16(&packet[4], sequence);
+    FwUpdate_Put16(&packet[6], length);
+    if (length > 0u) {
+        memcpy(&packet[dFW_PACKET_HEADER_SIZE], data, length);
+    }
+    FwUpdate_Put16(&packet[crcOffset], CRC16(&packet[2], (uint16_t)(crcOffset - 2u)));
+    return (uint16_t)(crcOffset + dFW_PACKET_CRC_SIZE);
+}
+
+/* Image */
+
+static uint16_t FwImage_BlockCount(uint32_t size)
+{
+    return (uint16_t)((size + dFW_BLOCK_SIZE - 1u) / dFW_BLOCK_SIZE);
+}
+
+static uint16_t FwImage_HeaderCrc(const FwImageHeader *header)
+{
+    return CRC16((const uint8_t *)header, (uint16_t)offsetof(FwImageHeader, HeaderCrc));
+}
+
+// CRC16 of the image in flash
+static uint16_t FwImage_FlashCrc(const FwFlash *flash, uint32_t size)
+{
+    uint8_t chunk[dFW_READ_CHUNK];
+    uint16_t crc = dCRC16_INIT;
+    uint32_t offset, length;
+
+    for (offset = 0; offset < size; offset += length) {
+        length = size - offset;
+        if (length > dFW_READ_CHUNK) {
+            length = dFW_READ_CHUNK;
+        }
+        flash->Read(flash->ImageAddress + offset, chunk, length);
+        crc = CRC16_Update(crc, chunk, (uint16_t)length);
+    }
+    return crc;
+}
+
+static bool FwImage_IsCommitted(const FwFlash *flash)
+{
+    uint8_t mark[4];
+
+    flash->Read(flash->RecordAddress + sizeof(FwImageHeader), mark, sizeof(mark));
+    return FwUpdate_Get32(mark) == dFW_COMMIT_MAGIC;
+}
+
+void FwImage_MakeHeader(FwImageHeader *header, uint8_t target, uint32_t version, uint32_t size, uint16_t crc)
+{
+    memset(header, 0, sizeof(FwImageHeader));
+    header->Magic = dFW_IMAGE_MAGIC;
+    header->Target = target;
+    header->Version = version;
+    header->Size = size;
+    header->Crc = crc;
+    header->HeaderCrc = FwImage_HeaderCrc(header);
+}
+
+bool FwImage_IsHeaderValid(const FwImageHeader *header)
+{
+    return header->Magic == dFW_IMAGE_MAGIC && header->Size > 0u && header->HeaderCrc == FwImage_HeaderCrc(header);
+}
+
+bool FwImage_IsValid(const FwFlash *flash, FwImageHeader *header)
+{
+    flash->Read(flash->RecordAddress, (uint8_t *)header, sizeof(FwImageHeader));
+    if (!FwImage_IsHeaderValid(header) || header->Size > flash->ImageSize || !FwImage_IsCommitted(flash)) {
+        return false;
+    }
+    return FwImage_FlashCrc(flash, header->Size) == header->Crc;
+}
+
+/* Loader */
+
+// Programs data at address in ProgramSize units. Units already holding the
+// data are skipped, so a block written before a reset can be written again.
+static bool FwReceiver_Write(const FwFlash *flash, uint32_t address, const uint8_t *data, uint32_t length)
+{
+    uint8_t unit[dFW_PROGRAM_MAX], held[dFW_PROGRAM_MAX];
+    uint32_t offset, chunk;
+
+    for (offset = 0; offset < length; offset += flash->ProgramSize) {
+        chunk = length - offset;
+        if (chunk > flash->ProgramSize) {
+            chunk = flash->ProgramSize;
+        }
+        memset(unit, 0xFF, flash->ProgramSize);
+        memcpy(unit, &data[offset], chunk);
+
+        flash->Read(address + offset, held, flash->ProgramSize);
+        if (memcmp(held, unit, flash->ProgramSize) == 0) {
+            continue;
+        }
+        if (!FwUpdate_IsErased(held, flash->ProgramSize) || !flash->Program(address + offset, unit)) {
+            return false;
+        }
+        flash->Read(address + offset, held, flash->ProgramSize);
+        if (memcmp(held, unit, flash->ProgramSize) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t FwReceiver_BlockLength(const FwReceiver *receiver, uint16_t block)
+{
+    uint32_t offset = (uint32_t)block * dFW_BLOCK_SIZE;
+    uint32_t length = receiver->Header.Size - offset;
+
+    return (length > dFW_BLOCK_SIZE) ? dFW_BLOCK_SIZE : length;
+}
+
+static bool FwReceiver_IsBlockErased(const FwReceiver *receiver, uint16_t block)
+{
+    uint8_t chunk[dFW_READ_CHUNK];
+    uint32_t address = receiver->Flash->ImageAddress + (uint32_t)block * dFW_BLOCK_SIZE;
+    uint32_t blockLength = FwReceiver_BlockLength(receiver, block);
+    uint32_t offset, length;
+
+    for (offset = 0; offset < blockLength; offset += length) {
+        length = blockLength - offset;
+        if (length > dFW_READ_CHUNK) {
+            length = dFW_READ_CHUNK;
+        }
+        receiver->Flash->Read(address + offset, chunk, length);
+        if (!FwUpdate_IsErased(chunk, length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Blocks are written in order: the last one not erased may be partly
+// written, it is written again. Blocks of 0xFF in the image are taken as
+// written, the search runs from the end.
+static uint16_t FwReceiver_ResumeBlock(const FwReceiver *receiver)
+{
+    uint16_t block = receiver->BlockCount;
+
+    while (block > 0u && FwReceiver_IsBlockErased(receiver, (uint16_t)(block - 1u))) {
+        block--;
+    }
+    return (block > 0u) ? (uint16_t)(block - 1u) : 0u;
+}
+
+static uint16_t FwReceiver_Status(const FwReceiver *receiver, uint8_t flags, uint8_t *reply)
+{
+    uint8_t data[sizeof(FwStatus)];
+
+    data[0] = receiver->State;
+    data[1] = flags;
+    FwUpdate_Put16(&data[2], receiver->Next);
+    FwUpdate_Put32(&data[4], (receiver->Header.Magic == dFW_IMAGE_MAGIC) ? receiver->Header.Version : 0u);
+    return FwPacket_Make(reply, dFW_COMMAND_STATUS, receiver->Target, receiver->Next, data, sizeof(data));
+}
+
+// New image: record first, a reset while erasing leaves nothing to resume
+static bool FwReceiver_Erase(const FwReceiver *receiver, uint32_t size)
+{
+    const FwFlash *flash = receiver->Flash;
+    uint32_t offset;
+
+    if (!flash->Erase(flash->RecordAddress)) {
+        return false;
+    }
+    for (offset = 0; offset < size; offset += flash->PageSize) {
+        if (!flash->Erase(flash->ImageAddress + offset)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void FwReceiver_Begin(FwReceiver *receiver, const uint8_t *data, uint16_t length)
+{
+    const FwFlash *flash = receiver->Flash;
+    FwImageHeader header;
+
+    receiver->IsGap = false;
+    receiver->Next = 0;
+    if (length != sizeof(FwImageHeader)) {
+        receiver->State = dFW_STATE_ERROR_HEADER;
+        return;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (!FwImage_IsHeaderValid(&header) || header.Target != receiver->Target || header.Size > flash->ImageSize) {
+        receiver->State = dFW_STATE_ERROR_HEADER;
+        return;
+    }
+
+    receiver->BlockCount = FwImage_BlockCount(header.Size);
+    if (memcmp(&header, &receiver->Header, sizeof(header)) == 0) {
+        if (FwImage_IsCommitted(flash)) {
+            receiver->Next = receiver->BlockCount;
+            receiver->State = dFW_STATE_DONE;
+        } else {
+            receiver->Next = FwReceiver_ResumeBlock(receiver);
+            receiver->State = dFW_STATE_RECEIVING;
+        }
+        return;
+    }
+
+    memset(&receiver->Header, 0, sizeof(receiver->Header));
+    if (!FwReceiver_Erase(receiver, header.Size) ||
+        !FwReceiver_Write(flash, flash->RecordAddress, (const uint8_t *)&header, sizeof(header))) {
+        receiver->State = dFW_STATE_ERROR_FLASH;
+        return;
+    }
+    receiver->Header = header;
+    receiver->State = dFW_STATE_RECEIVING;
+}
+
+// Returns false when nothing is answered
+static bool FwReceiver_Data(FwReceiver *receiver, uint16_t sequence, const uint8_t *data, uint16_t length,
+                            uint8_t *flags)
+{
+    if (receiver->State != dFW_STATE_RECEIVING) {
+        return true;
+    }
+    if (sequence != receiver->Next) {
+        // repeated block acknowledged again, first block after a gap reported
+        // once; again when the sender went back and lost the block once more
+        if (sequence < receiver->Next) {
+            return true;
+        }
+        if (receiver->IsGap && sequence > receiver->GapBlock) {
+            return false;
+        }
+        receiver->IsGap = true;
+        receiver->GapBlock = sequence;
+        *flags = dFW_STATUS_GAP;
+        return true;
+    }
+
+    if (sequence >= receiver->BlockCount || length != FwReceiver_BlockLength(receiver, sequence)) {
+        receiver->State = dFW_STATE_ERROR_HEADER;
+        return true;
+    }
+    if (!FwReceiver_Write(receiver->Flash, receiver->Flash->ImageAddress + (uint32_t)sequence * dFW_BLOCK_SIZE,
+                          data, length)) {
+        receiver->State = dFW_STATE_ERROR_FLASH;
+        return true;
+    }
+    receiver->Next++;
+    receiver->IsGap = false;
+    return true;
+}
+
+static void FwReceiver_Commit(FwReceiver *receiver)
+{
+    const FwFlash *flash = receiver->Flash;
+    uint8_t mark[dFW_PROGRAM_MAX];
+
+    if (receiver->State != dFW_STATE_RECEIVING || receiver->Next != receiver->BlockCount) {
+        return;
+    }
+    if (FwImage_FlashCrc(flash, receiver->Header.Size) != receiver->Header.Crc) {
+        receiver->State = dFW_STATE_ERROR_CRC;
+        return;
+    }
+
+    memset(mark, 0xFF, sizeof(mark));
+    FwUpdate_Put32(mark, dFW_COMMIT_MAGIC);
+    if (!FwReceiver_Write(flash, flash->RecordAddress + sizeof(FwImageHeader), mark, flash->ProgramSize)) {
+        receiver->State = dFW_STATE_ERROR_FLASH;
+        return;
+    }
+    receiver->State = dFW_STATE_DONE;
+}
+
+void FwReceiver_Init(FwReceiver *receiver, const FwFlash *flash, uint8_t target)
+{
+    memset(receiver, 0, sizeof(FwReceiver));
+    receiver->Flash = flash;
+    receiver->Target = target;
+    receiver->State = dFW_STATE_IDLE;
+    FwParser_Init(&receiver->Parser);
+
+    flash->Read(flash->RecordAddress, (uint8_t *)&receiver->Header, sizeof(FwImageHeader));
+    if (!FwImage_IsHeaderValid(&receiver->Header) || receiver->Header.Target != target ||
+        receiver->Header.Size > flash->ImageSize) {
+        memset(&receiver->Header, 0, sizeof(FwImageHeader));
+    }
+}
+
+uint16_t FwReceiver_Receive(FwReceiver *receiver, uint8_t byte, uint8_t *reply)
+{
+    const uint8_t *packet = receiver->Parser.Buffer;
+    uint16_t length;
+    uint8_t flags = 0;
+
+    if (!FwParser_Feed(&receiver->Parser, byte) || packet[3] != receiver->Target) {
+        return 0;
+    }
+    length = FwUpdate_Get16(&packet[6]);
+
+    switch (packet[2]) {
+    case dFW_COMMAND_BEGIN:
+        FwReceiver_Begin(receiver, &packet[dFW_PACKET_HEADER_SIZE], length);
+        break;
+    case dFW_COMMAND_DATA:
+        if (!FwReceiver_Data(receiver, FwUpdate_Get16(&packet[4]), &packet[dFW_PACKET_HEADER_SIZE], length, &flags)) {
+            return 0;
+        }
+        break;
+    case dFW_COMMAND_COMMIT:
+        FwReceiver_Commit(receiver);
+        break;
+    case dFW_COMMAND_ABORT:
+        receiver->State = dFW_STATE_IDLE;
+        break;
+    case dFW_COMMAND_QUERY:
+        break;
+    default:
+        return 0;
+    }
+    return FwReceiver_Status(receiver, flags, reply);
+}
+
+/* Sender */
+
+static void FwSender_Progress(FwSender *sender, uint32_t now)
+{
+    sender->ProgressTime = now;
+    sender->Retries = 0;
+}
+
+void FwSender_Start(FwSender *sender, const FwImageHeader *header, FwImageRead read, uint8_t window, uint32_t now)
+{
+    memset(sender, 0, sizeof(FwSender));
+    FwParser_Init(&sender->Parser);
+    sender->Read = read;
+    sender->Header = *header;
+    sender->BlockCount = FwImage_BlockCount(header->Size);
+    sender->Window = (window > 0u) ? window : 1u;
+    sender->LoaderState = dFW_STATE_IDLE;
+    sender->Step = FwSender_Begin;
+    sender->IsPending = true;
+    FwSender_Progress(sender, now);
+}
+
+static void FwSender_Status(FwSender *sender, const uint8_t *data, uint32_t now)
+{
+    uint8_t state = data[0];
+    uint8_t flags = data[1];
+    uint16_t next = FwUpdate_Get16(&data[2]);
+    bool isImage = FwUpdate_Get32(&data[4]) == sender->Header.Version;
+
+    sender->LoaderState = state;
+    if (state >= dFW_STATE_ERROR_HEADER) {
+        sender->Step = FwSender_Failed;
+        return;
+    }
+
+    switch (sender->Step) {
+    case FwSender_Begin:
+        // status of an earlier transfer still on the way is not taken
+        if (isImage && state == dFW_STATE_RECEIVING && next <= sender->BlockCount) {
+            sender->AckedBlocks = next;
+            sender->NextBlock = next;
+            sender->Step = FwSender_Data;
+            FwSender_Progress(sender, now);
+        } else if (isImage && state == dFW_STATE_DONE) {
+            sender->AckedBlocks = sender->BlockCount;
+            sender->Step = FwSender_Commit;
+            sender->IsPending = true;
+            FwSender_Progress(sender, now);
+        }
+        break;
+
+    case FwSender_Data:
+        if (state == dFW_STATE_IDLE) {
+            // loader restarted, BEGIN resumes at its last block
+            sender->Step = FwSender_Begin;
+            sender->IsPending = true;
+            break;
+        }
+        if (state != dFW_STATE_RECEIVING) {
+            sender->Step = FwSender_Failed;
+            break;
+        }
+        if (next > sender->BlockCount) {
+            break;
+        }
+        // statuses arrive in order, a smaller next is a loader that went back
+        // (resumed after BEGIN), blocks from there on are sent again
+        if (next > sender->AckedBlocks) {
+            FwSender_Progress(sender, now);
+        }
+        if ((next < sender->AckedBlocks || (flags & dFW_STATUS_GAP)) && next < sender->NextBlock) {
+            sender->Resent = (uint16_t)(sender->Resent + (sender->NextBlock - next));
+            sender->NextBlock = next;
+        }
+        sender->AckedBlocks = next;
+        if (sender->AckedBlocks >= sender->BlockCount) {
+            sender->Step = FwSender_Commit;
+            sender->IsPending = true;
+        }
+        break;
+
+    case FwSender_Commit:
+        if (state == dFW_STATE_DONE) {
+            sender->Step = FwSender_Done;
+        } else if (state == dFW_STATE_IDLE) {
+            sender->Step = FwSender_Begin;
+            sender->IsPending = true;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void FwSender_Receive(FwSender *sender, const uint8_t *data, size_t length, uint32_t now)
+{
+    const uint8_t *packet = sender->Parser.Buffer;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        if (FwParser_Feed(&sender->Parser, data[i]) && packet[2] == dFW_COMMAND_STATUS &&
+            packet[3] == sender->Header.Target && FwUpdate_Get16(&packet[6]) >= sizeof(FwStatus)) {
+            FwSender_Status(sender, &packet[dFW_PACKET_HEADER_SIZE], now);
+        }
+    }
+}
+
+// True when there was no progress for timeout, gives up after dFW_SENDER_RETRIES
+static bool FwSender_IsTimeout(FwSender *sender, uint32_t timeout, uint32_t now)
+{
+    if ((now - sender->ProgressTime) < timeout) {
+        return false;
+    }
+    sender->ProgressTime = now;
+    if (++sender->Retries > dFW_SENDER_RETRIES) {
+        sender->Step = FwSender_Failed;
+        return false;
+    }
+    return true;
+}
+
+uint16_t FwSender_Poll(FwSender *sender, uint8_t *packet, uint32_t now)
+{
+    uint8_t target = sender->Header.Target;
+    uint8_t data[dFW_BLOCK_SIZE];
+    uint32_t offset, length;
+    uint16_t block;
+
+    switch (sender->Step) {
+    case FwSender_Begin:
+        if (sender->IsPending || FwSender_IsTimeout(sender, dFW_SENDER_BEGIN_TIMEOUT, now)) {
+            sender->IsPending = false;
+            return FwPacket_Make(packet, dFW_COMMAND_BEGIN, target, 0, (const uint8_t *)&sender->Header,
+                                 sizeof(FwImageHeader));
+        }
+        break;
+
+    case FwSender_Data:
+        if (FwSender_IsTimeout(sender, dFW_SENDER_TIMEOUT, now) || sender->NextBlock < sender->AckedBlocks) {
+            // go back to the first block the loader did not write
+            if (sender->NextBlock > sender->AckedBlocks) {
+                sender->Resent = (uint16_t)(sender->Resent + (sender->NextBlock - sender->AckedBlocks));
+            }
+            sender->NextBlock = sender->AckedBlocks;
+        }
+        if (sender->Step == FwSender_Data && sender->NextBlock < sender->BlockCount &&
+            sender->NextBlock < (uint32_t)sender->AckedBlocks + sender->Window) {
+            block = sender->NextBlock++;
+            offset = (uint32_t)block * dFW_BLOCK_SIZE;
+            length = sender->Header.Size - offset;
+            if (length > dFW_BLOCK_SIZE) {
+                length = dFW_BLOCK_SIZE;
+            }
+            if (!sender->Read(offset, data, (uint16_t)length)) {
+                sender->Step = FwSender_Failed;
+                break;
+            }
+            return FwPacket_Make(packet, dFW_COMMAND_DATA, target, block, data, (uint16_t)length);
+        }
+        break;
+
+    case FwSender_Commit:
+        // CRC of the whole image is checked before the answer
+        if (sender->IsPending || FwSender_IsTimeout(sender, dFW_SENDER_COMMIT_TIMEOUT, now)) {
+            sender->IsPending = false;
+            return FwPacket_Make(packet, dFW_COMMAND_COMMIT, target, sender->BlockCount, NULL, 0);
+        }
+        break;
+
+    default:
+        break;
+    }
+    return 0;
+}
+
+/* Boot word */
+
+#define FwBoot_Magic(word)      ((uint16_t)((word) >> 16))
+#define FwBoot_Trials(word)     ((uint8_t)((word) >> 8))
+#define FwBoot_Rate(word)       ((uint8_t)(((word) >> 4) & 0x0Fu))
+#define FwBoot_Target(word)     ((uint8_t)((word) & 0x0Fu))
+
+uint32_t FwBoot_Request(uint8_t target, uint8_t rate)
+{
+    return ((uint32_t)dFW_BOOT_MAGIC << 16) | ((uint32_t)(rate & 0x0Fu) << 4) | (target & 0x0Fu);
+}
+
+uint8_t FwBoot_Decide(uint32_t *word, bool isImageValid, uint8_t *target, uint8_t *rate)
+{
+    uint32_t value = *word;
+    uint8_t trials;
+
+    *target = dFW_TARGET_NONE;
+    *rate = dLINK_RATE_115200;
+    if (FwBoot_Magic(value) != dFW_BOOT_MAGIC) {
+        // power on, persistent RAM holds anything
+        value = (uint32_t)dFW_BOOT_MAGIC << 16;
+    }
+    trials = FwBoot_Trials(value);
+
+    if (FwBoot_Target(value) != dFW_TARGET_NONE) {
+        *target = FwBoot_Target(value);
+        if (FwBoot_Rate(value) < dLINK_RATE_NUM_OF) {
+            *rate = FwBoot_Rate(value);
+        }
+        *word = value & 0xFFFFFF00UL;
+        return dFW_BOOT_LOADER;
+    }
+    if (!isImageValid || trials >= dFW_BOOT_TRIALS) {
+        *word = value;
+        return dFW_BOOT_LOADER;
+    }
+
+    *word = (value & 0xFFFF00FFUL) | ((uint32_t)(trials + 1u) << 8);
+    return dFW_BOOT_APPLICATION;
+}
+
+uint32_t FwBoot_Confirm(void)
+{
+    return (uint32_t)dFW_BOOT_MAGIC << 16;
+}
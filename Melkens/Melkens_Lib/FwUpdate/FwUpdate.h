@@ -0,0 +1,209 @@
+#ifndef FWUPDATE_H
+#define FWUPDATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../Types/MessageTypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Firmware transfer from the ESP to the loaders of IMU and PMB over the
+// existing links (LPUART1 ESP - IMU, USART2 IMU - PMB, bridged by the IMU
+// loader). The application is asked to start its loader with
+// dESP2IMU_FRAME_FW_UPDATE (Imu2PmbFrame_t.fwTarget towards PMB), from then
+// on the link carries only packets of this stream, no frames, so a transfer
+// runs close to the link rate:
+//
+//   0  u8  dFW_PACKET_SYNC0
+//   1  u8  dFW_PACKET_SYNC1
+//   2  u8  command, dFW_COMMAND_...
+//   3  u8  target, dFW_TARGET_...
+//   4  u16 sequence, block of DATA
+//   6  u16 length of data, up to dFW_BLOCK_SIZE
+//   8      data
+//   8+length u16 CRC16 of bytes 2 .. 8+length-1
+//
+// Little endian. The sender keeps up to a window of DATA blocks in flight,
+// the loader answers every in order block with STATUS (next expected
+// block) and the first block after a gap with STATUS and dFW_STATUS_GAP, the
+// sender goes back to that block. Lost STATUS is covered by the next one or
+// a timeout. BEGIN with the header of the image the loader already holds
+// resumes at the last block written, so a transfer broken by a reset of
+// either end costs one block. COMMIT checks the CRC16 of the whole image in
+// flash before the image is marked complete.
+//
+// The loader writes the image where the application runs. The ESP keeps the
+// image last confirmed by the application and sends it again when a new one
+// does not come up (FwBoot_Decide keeps a failing image in the loader).
+
+#define dFW_PACKET_SYNC0        0x46    // "FU"
+#define dFW_PACKET_SYNC1        0x55
+#define dFW_PACKET_HEADER_SIZE  8u
+#define dFW_PACKET_CRC_SIZE     2u
+#define dFW_BLOCK_SIZE          256u
+#define dFW_PACKET_MAX          (dFW_PACKET_HEADER_SIZE + dFW_BLOCK_SIZE + dFW_PACKET_CRC_SIZE)
+
+// ESP to loader
+#define dFW_COMMAND_QUERY       1       // STATUS without changing anything
+#define dFW_COMMAND_BEGIN       2       // data: FwImageHeader
+#define dFW_COMMAND_DATA        3       // data: image bytes from sequence * dFW_BLOCK_SIZE
+#define dFW_COMMAND_COMMIT      4       // check image CRC, mark image complete
+#define dFW_COMMAND_ABORT       5
+// Loader to ESP
+#define dFW_COMMAND_STATUS      0x81    // data: FwStatus
+
+// FwStatus.state
+#define dFW_STATE_IDLE          0
+#define dFW_STATE_RECEIVING     1
+#define dFW_STATE_DONE          2       // image complete and checked
+#define dFW_STATE_ERROR_HEADER  3       // bad header, other target or image too large
+#define dFW_STATE_ERROR_FLASH   4
+#define dFW_STATE_ERROR_CRC     5
+
+// FwStatus.flags
+#define dFW_STATUS_GAP          0x01    // block out of order, next is the first one missing
+
+#define dFW_IMAGE_MAGIC         0x4957464DUL    // "MFWI"
+#define dFW_COMMIT_MAGIC        0x54494D43UL    // "CMIT"
+
+#define dFW_SENDER_TIMEOUT        200u  // [ms] without progress, resend from the last acknowledged block
+#define dFW_SENDER_BEGIN_TIMEOUT  3000u // [ms] loader erases the image area before answering BEGIN
+#define dFW_SENDER_COMMIT_TIMEOUT 500u  // [ms] loader reads the image for its CRC before answering COMMIT
+#define dFW_SENDER_RETRIES        20u
+
+// Image description, BEGIN data and first part of the loader record
+typedef struct FwImageHeader_t {
+    uint32_t Magic;         // dFW_IMAGE_MAGIC
+    uint8_t Target;         // dFW_TARGET_...
+    uint8_t Reserved[3];
+    uint32_t Version;       // build of the image, free form
+    uint32_t Size;          // image bytes
+    uint16_t Crc;           // CRC16 of the image
+    uint8_t Reserved2[12];
+    uint16_t HeaderCrc;     // CRC16 of the header without this field
+} FwImageHeader;            // 32 bytes
+
+typedef struct FwStatus_t {
+    uint8_t State;          // dFW_STATE_...
+    uint8_t Flags;          // dFW_STATUS_...
+    uint16_t Next;          // next expected block, blocks below are written
+    uint32_t Version;       // FwImageHeader.Version of the image held, 0 none
+} FwStatus;                 // 8 bytes
+
+// Flash of a loader. Addresses are in the units of the interface, the
+// record holds the FwImageHeader of the image followed by the commit mark
+// and is alone in its page. Program writes ProgramSize bytes (divides
+// dFW_BLOCK_SIZE, at most 16) to a ProgramSize aligned address.
+typedef struct FwFlash_t {
+    uint32_t ImageAddress;
+    uint32_t ImageSize;     // room for the image, whole pages
+    uint32_t RecordAddress;
+    uint32_t PageSize;
+    uint8_t ProgramSize;
+    bool (*Erase)(uint32_t address);    // page starting at address
+    bool (*Program)(uint32_t address, const uint8_t *data);
+    void (*Read)(uint32_t address, uint8_t *data, uint32_t length);
+} FwFlash;
+
+// Packet search in a byte stream, resynchronises on the next sync after bad bytes
+typedef struct FwParser_t {
+    uint16_t Length;
+    bool IsComplete;        // Buffer holds a packet, dropped with the next byte
+    uint8_t Buffer[dFW_PACKET_MAX];
+} FwParser;
+
+typedef struct FwReceiver_t {
+    const FwFlash *Flash;
+    uint8_t Target;         // dFW_TARGET_... this loader writes
+    uint8_t State;
+    bool IsGap;             // STATUS with dFW_STATUS_GAP sent for the current gap
+    uint16_t GapBlock;      // block it was sent for
+    uint16_t Next;
+    uint16_t BlockCount;
+    FwImageHeader Header;
+    FwParser Parser;
+} FwReceiver;
+
+// Image bytes for the sender, false when they cannot be read
+typedef bool (*FwImageRead)(uint32_t offset, uint8_t *data, uint16_t length);
+
+typedef enum {
+    FwSender_Idle = 0,
+    FwSender_Begin,         // BEGIN repeated until the loader answers
+    FwSender_Data,
+    FwSender_Commit,
+    FwSender_Done,
+    FwSender_Failed
+} FwSenderStep;
+
+typedef struct FwSender_t {
+    FwSenderStep Step;
+    uint8_t LoaderState;    // dFW_STATE_... last reported
+    uint8_t Window;         // blocks in flight, the loader buffers as many packets
+    uint8_t Retries;
+    FwImageRead Read;
+    FwImageHeader Header;
+    uint16_t BlockCount;
+    uint16_t NextBlock;     // next block to send
+    uint16_t AckedBlocks;   // blocks written by the loader
+    uint16_t Resent;        // blocks sent again, statistics
+    bool IsPending;         // packet for the current step is due
+    uint32_t ProgressTime;  // [ms]
+    FwParser Parser;
+} FwSender;
+
+void FwParser_Init(FwParser *parser);
+// One received byte, true when Buffer holds a packet with valid CRC
+bool FwParser_Feed(FwParser *parser, uint8_t byte);
+// Writes a packet, returns its length
+uint16_t FwPacket_Make(uint8_t *packet, uint8_t command, uint8_t target, uint16_t sequence,
+                       const uint8_t *data, uint16_t length);
+
+// Crc: CRC16 of the image, sizes are above CRC16 length, run CRC16_Update over parts
+void FwImage_MakeHeader(FwImageHeader *header, uint8_t target, uint32_t version, uint32_t size, uint16_t crc);
+bool FwImage_IsHeaderValid(const FwImageHeader *header);
+// Record holds a complete image with matching CRC, loader start check
+bool FwImage_IsValid(const FwFlash *flash, FwImageHeader *header);
+
+// Loader side, Init looks at the record: an unfinished image is resumed
+void FwReceiver_Init(FwReceiver *receiver, const FwFlash *flash, uint8_t target);
+// One received byte, returns the length of an answer written to reply
+// (dFW_PACKET_MAX bytes), 0 when there is none. Flash work is done in here,
+// bytes arriving meanwhile have to be buffered.
+uint16_t FwReceiver_Receive(FwReceiver *receiver, uint8_t byte, uint8_t *reply);
+
+// ESP side, blocks are read when sent, from the image the header was made of
+void FwSender_Start(FwSender *sender, const FwImageHeader *header, FwImageRead read, uint8_t window, uint32_t now);
+void FwSender_Receive(FwSender *sender, const uint8_t *data, size_t length, uint32_t now);
+// Next packet to send written to packet (dFW_PACKET_MAX bytes), 0: nothing now
+uint16_t FwSender_Poll(FwSender *sender, uint8_t *packet, uint32_t now);
+
+// Boot word of application and loader, kept over resets (STM32 TAMP backup
+// register, dsPIC persistent RAM):
+//   31..16 dFW_BOOT_MAGIC  15..8 trials  7..4 loader dLINK_RATE_...  3..0 requested dFW_TARGET_...
+// The loader counts starts of the application, an application not calling
+// FwBoot_Confirm within dFW_BOOT_TRIALS starts (watchdog resets) is taken
+// as failed and the loader waits for an image.
+#define dFW_BOOT_MAGIC          0x4642u // "FB"
+#define dFW_BOOT_TRIALS         3u
+
+#define dFW_BOOT_APPLICATION    0
+#define dFW_BOOT_LOADER         1
+
+// Word the application writes before reset to start the loader
+uint32_t FwBoot_Request(uint8_t target, uint8_t rate);
+// Loader at start, returns dFW_BOOT_... and the updated word to keep, target
+// and rate the loader runs with (dFW_TARGET_NONE, base rate unless requested)
+uint8_t FwBoot_Decide(uint32_t *word, bool isImageValid, uint8_t *target, uint8_t *rate);
+// Word to keep once the application is up, trials cleared. Also written by
+// the loader after a new image is committed.
+uint32_t FwBoot_Confirm(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FWUPDATE_H
@@ -0,0 +1,266 @@
+#include "LinkSpeed.h"
+#include <string.h>
+
+static const uint32_t LinkSpeed_Bauds[dLINK_RATE_NUM_OF] = {115200u, 460800u, 921600u, 2000000u};
+
+static bool LinkSpeed_IsSettling(const LinkSpeed *link, uint32_t now)
+{
+    return (now - link->RateTime) < dLINK_SPEED_SETTLE;
+}
+
+static void LinkSpeed_StartWindow(LinkSpeed *link, uint32_t now)
+{
+    link->WindowStart = now;
+    link->Frames = 0;
+    link->Errors = 0;
+    link->Sent = 0;
+    link->IsPeerErrorsKnown = false;
+}
+
+static void LinkSpeed_SetRate(LinkSpeed *link, uint8_t rate, uint32_t now)
+{
+    link->Rate = rate;
+    link->RateTime = now;
+    link->LastRxTime = now;
+    link->IsLinkUp = false;
+    link->IsSwitchPending = false;
+    link->IsProbing = (rate != dLINK_RATE_115200);
+    link->State = LinkSpeed_Idle;
+    link->StateTime = now;
+    link->Answer = dLINK_COMMAND_NONE;
+    link->SwitchFrames = 0;
+    link->Switches++;
+    LinkSpeed_StartWindow(link, now);
+}
+
+// Rate failed, it is not proposed again for dLINK_SPEED_RETRY, doubled for
+// every further failure of the rate until it passes a window check
+static void LinkSpeed_LowerCap(LinkSpeed *link, uint8_t failed, uint32_t now)
+{
+    if (link->IsFailed[failed] && (link->Failures[failed] < dLINK_SPEED_RETRY_MAX_SHIFT)) {
+        link->Failures[failed]++;
+    }
+    link->IsFailed[failed] = true;
+    link->Cap = (failed > dLINK_RATE_115200) ? (uint8_t)(failed - 1u) : dLINK_RATE_115200;
+    link->CapTime = now;
+    link->Fallbacks++;
+}
+
+// Per mille of frames with CRC error, both directions together. A single
+// error says nothing about a short window.
+static bool LinkSpeed_IsErrorRateHigh(const LinkSpeed *link)
+{
+    uint32_t peerErrors = link->IsPeerErrorsKnown ? (uint8_t)(link->PeerErrors - link->PeerErrorsStart) : 0u;
+    uint32_t errors = link->Errors + peerErrors;
+    uint32_t frames = (uint32_t)link->Frames + link->Errors + link->Sent;
+
+    return (errors >= dLINK_SPEED_MIN_ERRORS) && ((errors * 1000u) > (dLINK_SPEED_MAX_ERRORS * frames));
+}
+
+static void LinkSpeed_Judge(LinkSpeed *link, uint32_t now)
+{
+    bool isComplete = (link->Frames >= dLINK_SPEED_PROBE_FRAMES) && (link->Sent >= dLINK_SPEED_PROBE_FRAMES);
+
+    // Checked all the time, a bad rate is left as soon as its errors show
+    if (isComplete && LinkSpeed_IsErrorRateHigh(link) && (link->Rate != dLINK_RATE_115200)) {
+        LinkSpeed_LowerCap(link, link->Rate, now);
+        link->Target = link->Cap;
+        link->State = LinkSpeed_Switch;
+        return;
+    }
+    if (link->IsProbing ? !isComplete : ((now - link->WindowStart) < dLINK_SPEED_WINDOW)) {
+        return;
+    }
+
+    if (link->IsProbing && (link->LostRate == link->Rate)) {
+        link->LostRate = dLINK_RATE_NUM_OF;
+    }
+    if (!link->IsProbing) {
+        link->IsFailed[link->Rate] = false;
+        link->Failures[link->Rate] = 0;
+    }
+    link->IsProbing = false;
+    LinkSpeed_StartWindow(link, now);
+}
+
+static void LinkSpeed_PerformMaster(LinkSpeed *link, uint32_t now)
+{
+    // Failed rates come back one at a time, each after its own retry time
+    if ((link->Cap < link->MaxRate) && ((now - link->CapTime) >= (dLINK_SPEED_RETRY << link->Failures[link->Cap + 1u]))) {
+        link->Cap++;
+        link->CapTime = now;
+    }
+
+    switch (link->State) {
+    case LinkSpeed_Propose:
+        if ((now - link->StateTime) >= dLINK_SPEED_PROPOSE_TIMEOUT) {
+            link->State = LinkSpeed_Idle;
+            link->StateTime = now;
+        }
+        break;
+    case LinkSpeed_Idle:
+        if (LinkSpeed_IsSettling(link, now)) {
+            break;
+        }
+        LinkSpeed_Judge(link, now);
+        if ((link->State == LinkSpeed_Idle) && !link->IsProbing && link->IsLinkUp && (link->Rate < link->Cap) &&
+            ((now - link->StateTime) >= dLINK_SPEED_START)) {
+            link->Target = (uint8_t)(link->Rate + 1u);
+            link->Sequence++;
+            link->State = LinkSpeed_Propose;
+            link->StateTime = now;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void LinkSpeed_Init(LinkSpeed *link, bool isMaster, uint8_t maxRate, uint32_t now)
+{
+    memset(link, 0, sizeof(LinkSpeed));
+    link->IsMaster = isMaster;
+    link->MaxRate = (maxRate < dLINK_RATE_NUM_OF) ? maxRate : (uint8_t)(dLINK_RATE_NUM_OF - 1);
+    link->Cap = link->MaxRate;
+    link->LostRate = dLINK_RATE_NUM_OF;
+    LinkSpeed_SetRate(link, dLINK_RATE_115200, now);
+    link->Switches = 0;
+}
+
+bool LinkSpeed_Stamp(LinkSpeed *link, LinkControl_t *control, uint32_t now)
+{
+    control->command = dLINK_COMMAND_NONE;
+    control->rate = link->Rate;
+    control->sequence = link->Sequence;
+    control->errors = link->ErrorCounter;
+
+    if (link->IsMaster) {
+        if (!LinkSpeed_IsSettling(link, now)) {
+            link->Sent++;
+        }
+        if (link->State == LinkSpeed_Propose) {
+            control->command = dLINK_COMMAND_PROPOSE;
+            control->rate = link->Target;
+        } else if (link->State == LinkSpeed_Switch) {
+            // Repeated for dLINK_SPEED_SWITCH_FRAMES, copies the slave gets
+            // after switching are garbage to it. If all are lost both ends
+            // time out to base rate.
+            control->command = dLINK_COMMAND_SWITCH;
+            control->rate = link->Target;
+            link->SwitchFrames++;
+            link->IsSwitchPending = (link->SwitchFrames >= dLINK_SPEED_SWITCH_FRAMES);
+            return true;
+        }
+    } else if (link->Answer != dLINK_COMMAND_NONE) {
+        control->command = link->Answer;
+        control->rate = link->AnswerRate;
+        control->sequence = link->AnswerSequence;
+    }
+    return false;
+}
+
+void LinkSpeed_Receive(LinkSpeed *link, const LinkControl_t *control, uint32_t now)
+{
+    link->LastRxTime = now;
+    link->IsLinkUp = true;
+
+    if (link->IsMaster) {
+        if (LinkSpeed_IsSettling(link, now)) {
+            return;
+        }
+        link->Frames++;
+        if (!link->IsPeerErrorsKnown) {
+            link->PeerErrorsStart = control->errors;
+            link->IsPeerErrorsKnown = true;
+        }
+        link->PeerErrors = control->errors;
+
+        if ((link->State == LinkSpeed_Propose) && (control->sequence == link->Sequence)) {
+            if ((control->command == dLINK_COMMAND_ACCEPT) && (control->rate == link->Target)) {
+                link->State = LinkSpeed_Switch;
+            } else if (control->command == dLINK_COMMAND_REJECT) {
+                link->Cap = (control->rate < link->Cap) ? control->rate : link->Cap;
+                link->CapTime = now;
+                link->State = LinkSpeed_Idle;
+                link->StateTime = now;
+            }
+        }
+        return;
+    }
+
+    switch (control->command) {
+    case dLINK_COMMAND_PROPOSE:
+        link->AnswerSequence = control->sequence;
+        if (control->rate <= link->MaxRate) {
+            link->Answer = dLINK_COMMAND_ACCEPT;
+            link->AnswerRate = control->rate;
+        } else {
+            link->Answer = dLINK_COMMAND_REJECT;
+            link->AnswerRate = link->MaxRate;
+        }
+        break;
+    case dLINK_COMMAND_SWITCH:
+        link->Answer = dLINK_COMMAND_NONE;
+        if ((control->rate <= link->MaxRate) && (control->rate != link->Rate)) {
+            link->Target = control->rate;
+            link->IsSwitchPending = true;
+        }
+        break;
+    default:
+        link->Answer = dLINK_COMMAND_NONE;
+        break;
+    }
+}
+
+bool LinkSpeed_Error(LinkSpeed *link, uint32_t now)
+{
+    link->ErrorCounter++;
+    if (!link->IsLinkUp) {
+        return false;
+    }
+    if (!LinkSpeed_IsSettling(link, now)) {
+        link->Errors++;
+    }
+    return true;
+}
+
+bool LinkSpeed_Perform(LinkSpeed *link, uint32_t now)
+{
+    if (link->IsSwitchPending) {
+        LinkSpeed_SetRate(link, link->Target, now);
+        return true;
+    }
+
+    if ((link->Rate != dLINK_RATE_115200) && ((now - link->LastRxTime) >= dLINK_SPEED_TIMEOUT)) {
+        // A rate that passed probation lost the peer (cable, reset), it is
+        // proposed again. Nothing received after a switch is a lost SWITCH,
+        // dLINK_SPEED_LOST_TRIES times in a row a rate that does not work.
+        if (link->IsMaster && link->IsProbing) {
+            if (link->LostRate != link->Rate) {
+                link->LostRate = link->Rate;
+                link->Lost = 0;
+            }
+            if (link->IsLinkUp || (++link->Lost >= dLINK_SPEED_LOST_TRIES)) {
+                link->LostRate = dLINK_RATE_NUM_OF;
+                LinkSpeed_LowerCap(link, link->Rate, now);
+            }
+        }
+        LinkSpeed_SetRate(link, dLINK_RATE_115200, now);
+        return true;
+    }
+
+    if (link->IsMaster) {
+        LinkSpeed_PerformMaster(link, now);
+    }
+    return false;
+}
+
+uint32_t LinkSpeed_GetBaud(const LinkSpeed *link)
+{
+    return LinkSpeed_RateToBaud(link->Rate);
+}
+
+uint32_t LinkSpeed_RateToBaud(uint8_t rate)
+{
+    return LinkSpeed_Bauds[(rate < dLINK_RATE_NUM_OF) ? rate : dLINK_RATE_115200];
+}
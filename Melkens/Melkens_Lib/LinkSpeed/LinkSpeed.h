@@ -0,0 +1,106 @@
+#ifndef LINKSPEED_H
+#define LINKSPEED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Types/MessageTypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Baud rate negotiation of one UART link end, carried in the LinkControl_t of
+// every frame. Links start at dLINK_RATE_115200, the time master of the link
+// (TimeSync) is also master here:
+//   master PROPOSE(next rate) -> slave ACCEPT, or REJECT with its highest rate
+//   master SWITCH(rate) in dLINK_SPEED_SWITCH_FRAMES frames, the slave
+//   reconfigures its UART on the first one, the master after the last one
+// A new rate is on probation until dLINK_SPEED_PROBE_FRAMES frames went each
+// way. Frames with CRC error, own and the slave's count in LinkControl_t.errors,
+// must stay below dLINK_SPEED_MAX_ERRORS per mille of all frames sent and
+// received, then the next rate is proposed. Afterwards the check runs over
+// windows of dLINK_SPEED_WINDOW. A rate failing it is stepped down from and
+// not proposed for dLINK_SPEED_RETRY, doubled up to dLINK_SPEED_RETRY_MAX_SHIFT
+// times while it keeps failing without passing a window check in between.
+// Either end without a valid frame for dLINK_SPEED_TIMEOUT falls back to the
+// base rate, which recovers a lost SWITCH, a lost peer and rates that do not
+// work at all (stepped down from after dLINK_SPEED_LOST_TRIES in a row).
+// Times are [ms] and wrap around at 32 bit.
+
+#define dLINK_SPEED_TIMEOUT         2500u   // [ms] above base rate without valid frame: back to base rate
+#define dLINK_SPEED_START           1000u   // [ms] link up at a rate before next rate is proposed
+#define dLINK_SPEED_PROPOSE_TIMEOUT 1000u   // [ms] unanswered proposal is dropped, proposed again after dLINK_SPEED_START
+#define dLINK_SPEED_SETTLE          50u     // [ms] after switch frames and errors are not counted
+#define dLINK_SPEED_PROBE_FRAMES    20u     // frames each way before a rate is judged
+#define dLINK_SPEED_WINDOW          30000u  // [ms] error rate window after probation
+#define dLINK_SPEED_MAX_ERRORS      20u     // [per mille] frames with CRC error a rate may have
+#define dLINK_SPEED_MIN_ERRORS      4u      // frames with CRC error in a window before a rate can fail
+#define dLINK_SPEED_RETRY           60000u  // [ms] failed rate is not proposed again
+#define dLINK_SPEED_RETRY_MAX_SHIFT 4u      // retry time doubles up to 16 x for a rate failing again
+#define dLINK_SPEED_SWITCH_FRAMES   2u      // frames carrying SWITCH
+#define dLINK_SPEED_LOST_TRIES      3u      // switches to a rate without any frame back before it failed
+
+typedef enum {
+    LinkSpeed_Idle = 0,     // at Rate, judging it
+    LinkSpeed_Propose,      // PROPOSE(Target) sent until slave answers
+    LinkSpeed_Switch        // SWITCH(Target) goes with next frame
+} LinkSpeedState;
+
+typedef struct LinkSpeed_t {
+    bool IsMaster;
+    uint8_t MaxRate;            // highest dLINK_RATE_... this end supports
+    uint8_t Rate;               // current dLINK_RATE_...
+    uint8_t Target;             // rate proposed or switched to
+    bool IsSwitchPending;       // LinkSpeed_Perform reconfigures to Target
+    uint32_t RateTime;          // [ms] Rate was set
+    uint32_t LastRxTime;        // [ms] last valid frame
+    bool IsLinkUp;              // valid frame received at Rate
+    uint8_t ErrorCounter;       // own CRC errors, wraps, sent to peer
+    // Master
+    LinkSpeedState State;
+    uint32_t StateTime;         // [ms]
+    uint8_t Sequence;           // of current proposal
+    uint8_t Cap;                // highest rate to propose
+    uint32_t CapTime;           // [ms] Cap was lowered
+    uint8_t LostRate;           // rate timed out without any frame, dLINK_RATE_NUM_OF: none
+    uint8_t Lost;               // times in a row LostRate did
+    bool IsFailed[dLINK_RATE_NUM_OF];   // rate failed and did not pass a window check since
+    uint8_t Failures[dLINK_RATE_NUM_OF]; // further failures, doubles retry time
+    uint8_t SwitchFrames;       // frames sent with SWITCH
+    bool IsProbing;             // Rate is on probation
+    uint32_t WindowStart;       // [ms]
+    uint16_t Frames;            // valid frames received in window
+    uint16_t Errors;            // CRC errors in window
+    uint16_t Sent;              // frames sent in window
+    uint8_t PeerErrorsStart;    // slave ErrorCounter at window start
+    uint8_t PeerErrors;         // latest slave ErrorCounter
+    bool IsPeerErrorsKnown;
+    // Slave answer, repeated while master proposes
+    uint8_t Answer;             // dLINK_COMMAND_ACCEPT, _REJECT, _NONE
+    uint8_t AnswerRate;
+    uint8_t AnswerSequence;
+    // Statistics
+    uint16_t Switches;          // rate changes including fallbacks
+    uint16_t Fallbacks;         // rate failed probation, window check or timed out
+} LinkSpeed;
+
+void LinkSpeed_Init(LinkSpeed *link, bool isMaster, uint8_t maxRate, uint32_t now);
+// Fills control field of every frame sent to peer. True while the master
+// sends SWITCH: next frame should follow at once, not after the frame period.
+bool LinkSpeed_Stamp(LinkSpeed *link, LinkControl_t *control, uint32_t now);
+// Control field of a valid frame from peer
+void LinkSpeed_Receive(LinkSpeed *link, const LinkControl_t *control, uint32_t now);
+// Frame from peer with CRC error. False when expected: no valid frame yet at
+// current rate, the peer may still send at the old one (repeated SWITCH).
+bool LinkSpeed_Error(LinkSpeed *link, uint32_t now);
+// Call after frames are sent and received. True: reconfigure the UART to
+// LinkSpeed_GetBaud now, after the frame being transmitted is out.
+bool LinkSpeed_Perform(LinkSpeed *link, uint32_t now);
+uint32_t LinkSpeed_GetBaud(const LinkSpeed *link);
+uint32_t LinkSpeed_RateToBaud(uint8_t rate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LINKSPEED_H
@@ -0,0 +1,334 @@
+#include "Scope.h"
+#include "../CRC16/CRC16.h"
+#include <stddef.h>
+
+#define dSCOPE_DATA_ROOM    (dSCOPE_FRAME_SIZE - dBINLOG_FRAME_OVERHEAD - dSCOPE_DATA_HEADER_SIZE)
+
+// One DATA buffer fills while the other one waits for the UART or is sent.
+// A filled buffer meets the other one still busy: its samples are dropped.
+typedef enum {
+    ScopeBuffer_Free = 0,
+    ScopeBuffer_Filling,
+    ScopeBuffer_Ready,
+    ScopeBuffer_Sending
+} ScopeBufferState;
+
+static ScopeChannel Channels[dSCOPE_CHANNELS_MAX];
+static uint8_t ChannelCount;
+
+static uint16_t TicksPerSecond;
+static uint32_t Budget;             // [bytes per second]
+static uint8_t Status;              // of the last command
+static uint8_t Selection;
+static uint8_t SelectedCount;
+static uint8_t Selected[dSCOPE_SELECT_MAX];
+static uint16_t Period;             // [ticks]
+static uint8_t SampleSize;          // [bytes]
+
+static uint8_t Buffer[2][dSCOPE_FRAME_SIZE];
+static ScopeBufferState BufferState[2];
+static uint8_t Fill;                // buffer being filled
+static uint16_t FillLength;         // [bytes] samples in it
+static uint8_t FillSamples;
+static uint32_t FillTick;           // first sample
+static uint16_t FrameLength[2];
+static uint8_t DataSequence;
+
+static uint8_t Info[dSCOPE_FRAME_SIZE];
+static uint8_t InfoSequence;
+static bool IsInfoPending;
+static bool IsInfoSending;
+
+static ScopeStats Stats;
+
+static void Scope_Put16(uint8_t *data, uint16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void Scope_Put32(uint8_t *data, uint32_t value)
+{
+    Scope_Put16(data, (uint16_t)value);
+    Scope_Put16(&data[2], (uint16_t)(value >> 16));
+}
+
+static uint16_t Scope_Get16(const uint8_t *data)
+{
+    return (uint16_t)(data[0] | ((uint16_t)data[1] << 8));
+}
+
+static uint8_t Scope_ChannelSize(uint8_t channel)
+{
+    return (uint8_t)(Channels[channel].Type & dSCOPE_TYPE_SIZE_MASK);
+}
+
+static void Scope_StartBuffer(uint8_t index, uint32_t tick)
+{
+    Fill = index;
+    BufferState[index] = ScopeBuffer_Filling;
+    FillLength = 0;
+    FillSamples = 0;
+    FillTick = tick;
+}
+
+static void Scope_CloseBuffer(void)
+{
+    uint8_t *payload = &Buffer[Fill][dBINLOG_FRAME_HEADER_SIZE];
+    uint8_t other = (uint8_t)(Fill ^ 1u);
+
+    if (BufferState[other] != ScopeBuffer_Free) {
+        // UART behind, the budget leaves room for log frames only
+        Stats.Lost += FillSamples;
+        FillLength = 0;
+        FillSamples = 0;
+        return;
+    }
+    payload[0] = Selection;
+    payload[1] = FillSamples;
+    Scope_Put16(&payload[2], Period);
+    Scope_Put32(&payload[4], FillTick);
+    FrameLength[Fill] = BinLog_MakeFrame(Buffer[Fill], dBINLOG_FRAME_SCOPE_DATA, DataSequence++,
+                                         (uint16_t)(dSCOPE_DATA_HEADER_SIZE + FillLength));
+    BufferState[Fill] = ScopeBuffer_Ready;
+    Scope_StartBuffer(other, 0);
+}
+
+static void Scope_BuildInfo(void)
+{
+    uint8_t *payload = &Info[dBINLOG_FRAME_HEADER_SIZE];
+    uint16_t length = dSCOPE_INFO_HEADER_SIZE;
+    uint16_t room = dSCOPE_FRAME_SIZE - dBINLOG_FRAME_OVERHEAD;
+    uint8_t i;
+
+    payload[0] = Status;
+    payload[1] = Selection;
+    Scope_Put16(&payload[2], Period);
+    payload[4] = SelectedCount;
+    for (i = 0; i < dSCOPE_SELECT_MAX; i++) {
+        payload[5 + i] = (i < SelectedCount) ? Selected[i] : 0u;
+    }
+    Scope_Put16(&payload[14], TicksPerSecond);
+    Scope_Put32(&payload[16], Scope_GetRate(SelectedCount, Selected, Period));
+    Scope_Put32(&payload[20], Budget);
+    // names that do not fit are left out, the count tells
+    for (i = 0; i < ChannelCount; i++) {
+        const char *name = Channels[i].Name;
+        uint16_t start = length;
+
+        if (length + 2u > room) {
+            break;
+        }
+        payload[length++] = Channels[i].Type;
+        while (*name != '\0' && length < room - 1u) {
+            payload[length++] = (uint8_t)*name++;
+        }
+        if (*name != '\0') {
+            length = start;
+            break;
+        }
+        payload[length++] = 0;
+    }
+    payload[13] = i;
+    BinLog_MakeFrame(Info, dBINLOG_FRAME_SCOPE_INFO, InfoSequence++, length);
+}
+
+static uint8_t Scope_Select(const uint8_t *payload)
+{
+    uint16_t period = Scope_Get16(&payload[0]);
+    uint8_t count = payload[2];
+    uint8_t i;
+
+    if (count > dSCOPE_SELECT_MAX) {
+        return dSCOPE_STATUS_BAD_CHANNEL;
+    }
+    for (i = 0; i < count; i++) {
+        if (payload[4 + i] >= ChannelCount) {
+            return dSCOPE_STATUS_BAD_CHANNEL;
+        }
+    }
+    if (count > 0u && (period == 0u || period > dSCOPE_PERIOD_MAX)) {
+        return dSCOPE_STATUS_BAD_PERIOD;
+    }
+    if (count > 0u && Scope_GetRate(count, &payload[4], period) > Budget) {
+        return dSCOPE_STATUS_OVER_BUDGET;
+    }
+
+    SelectedCount = count;
+    SampleSize = 0;
+    for (i = 0; i < count; i++) {
+        Selected[i] = payload[4 + i];
+        SampleSize = (uint8_t)(SampleSize + Scope_ChannelSize(Selected[i]));
+    }
+    Period = period;
+    Selection++;
+    // samples of the old selection go, a buffer waiting for the UART stays
+    if (BufferState[Fill] == ScopeBuffer_Filling) {
+        Stats.Lost += FillSamples;
+        Scope_StartBuffer(Fill, 0);
+    }
+    return dSCOPE_STATUS_OK;
+}
+
+bool Scope_Register(const char *name, const volatile void *address, uint8_t type)
+{
+    uint8_t i;
+
+    for (i = 0; i < ChannelCount; i++) {
+        if (Channels[i].Name == name) {
+            return true;
+        }
+    }
+    if (ChannelCount >= dSCOPE_CHANNELS_MAX) {
+        return false;
+    }
+    Channels[ChannelCount].Name = name;
+    Channels[ChannelCount].Address = address;
+    Channels[ChannelCount].Type = type;
+    ChannelCount++;
+    return true;
+}
+
+void Scope_Init(uint16_t ticksPerSecond, uint32_t budget)
+{
+    TicksPerSecond = ticksPerSecond;
+    Budget = budget;
+    Status = dSCOPE_STATUS_OK;
+    Selection = 0;
+    SelectedCount = 0;
+    Period = 0;
+    SampleSize = 0;
+    BufferState[0] = ScopeBuffer_Free;
+    BufferState[1] = ScopeBuffer_Free;
+    Scope_StartBuffer(0, 0);
+    IsInfoPending = false;
+    IsInfoSending = false;
+    Stats.Samples = 0;
+    Stats.Lost = 0;
+    Stats.Frames = 0;
+}
+
+uint32_t Scope_GetRate(uint8_t count, const uint8_t *channels, uint16_t period)
+{
+    uint32_t sampleSize = 0;
+    uint32_t samplesPerFrame, samplesPerSecond, framesPerSecond;
+    uint8_t i;
+
+    if (count == 0u || period == 0u) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        sampleSize += (channels[i] < ChannelCount) ? Scope_ChannelSize(channels[i]) : 4u;
+    }
+    samplesPerFrame = dSCOPE_DATA_ROOM / sampleSize;
+    if (samplesPerFrame > (dSCOPE_FRAME_AGE + period - 1u) / period) {
+        samplesPerFrame = (dSCOPE_FRAME_AGE + period - 1u) / period;
+    }
+    samplesPerSecond = ((uint32_t)TicksPerSecond + period - 1u) / period;
+    framesPerSecond = (samplesPerSecond + samplesPerFrame - 1u) / samplesPerFrame;
+    return samplesPerSecond * sampleSize + framesPerSecond * (dBINLOG_FRAME_OVERHEAD + dSCOPE_DATA_HEADER_SIZE);
+}
+
+bool Scope_Command(const uint8_t *frame, uint16_t length)
+{
+    if (length != dSCOPE_COMMAND_SIZE || frame[0] != dBINLOG_FRAME_SYNC0 || frame[1] != dBINLOG_FRAME_SYNC1 ||
+        Scope_Get16(&frame[4]) != (dSCOPE_COMMAND_SIZE - dBINLOG_FRAME_OVERHEAD) ||
+        CRC16(&frame[2], (uint16_t)(length - 4u)) != Scope_Get16(&frame[length - 2u])) {
+        return false;
+    }
+    if (frame[2] == dBINLOG_FRAME_SCOPE_SELECT) {
+        Status = Scope_Select(&frame[dBINLOG_FRAME_HEADER_SIZE]);
+    } else if (frame[2] == dBINLOG_FRAME_SCOPE_LIST) {
+        Status = dSCOPE_STATUS_OK;
+    } else {
+        return false;
+    }
+    IsInfoPending = true;
+    return true;
+}
+
+void Scope_Sample(uint32_t tick)
+{
+    uint8_t *sample;
+    const volatile void *address;
+    uint8_t i;
+
+    if (SelectedCount == 0u || (tick % Period) != 0u) {
+        return;
+    }
+    if (FillSamples > 0u && tick != FillTick + (uint32_t)FillSamples * Period) {
+        // tick was skipped, samples of a frame are period apart
+        Scope_CloseBuffer();
+    }
+    if (FillSamples == 0u) {
+        FillTick = tick;
+    }
+
+    sample = &Buffer[Fill][dBINLOG_FRAME_HEADER_SIZE + dSCOPE_DATA_HEADER_SIZE + FillLength];
+    for (i = 0; i < SelectedCount; i++) {
+        address = Channels[Selected[i]].Address;
+        switch (Channels[Selected[i]].Type & dSCOPE_TYPE_SIZE_MASK) {
+        case 1:
+            *sample++ = *(const volatile uint8_t *)address;
+            break;
+        case 2:
+            Scope_Put16(sample, *(const volatile uint16_t *)address);
+            sample += 2;
+            break;
+        default:
+            Scope_Put32(sample, *(const volatile uint32_t *)address);
+            sample += 4;
+            break;
+        }
+    }
+    FillLength = (uint16_t)(FillLength + SampleSize);
+    FillSamples++;
+    Stats.Samples++;
+
+    // full, or the next sample would make the frame too old
+    if (FillLength + SampleSize > dSCOPE_DATA_ROOM || (tick + Period - FillTick) >= dSCOPE_FRAME_AGE) {
+        Scope_CloseBuffer();
+    }
+}
+
+const uint8_t *Scope_GetFrame(uint16_t *length)
+{
+    uint8_t i;
+
+    if (IsInfoPending) {
+        IsInfoPending = false;
+        IsInfoSending = true;
+        Scope_BuildInfo();
+        *length = (uint16_t)(Scope_Get16(&Info[4]) + dBINLOG_FRAME_OVERHEAD);
+        return Info;
+    }
+    for (i = 0; i < 2u; i++) {
+        if (BufferState[i] == ScopeBuffer_Ready) {
+            BufferState[i] = ScopeBuffer_Sending;
+            Stats.Frames++;
+            *length = FrameLength[i];
+            return Buffer[i];
+        }
+    }
+    return NULL;
+}
+
+void Scope_FrameSent(void)
+{
+    uint8_t i;
+
+    if (IsInfoSending) {
+        IsInfoSending = false;
+        return;
+    }
+    for (i = 0; i < 2u; i++) {
+        if (BufferState[i] == ScopeBuffer_Sending) {
+            BufferState[i] = ScopeBuffer_Free;
+        }
+    }
+}
+
+void Scope_GetStats(ScopeStats *stats)
+{
+    *stats = Stats;
+}
@@ -0,0 +1,107 @@
+#ifndef SCOPE_H
+#define SCOPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../BinLog/BinLog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Live scope of registered variables on the debug UART. Modules register
+// variables at start, the PC (Tools/Scope/scope.py) lists them and selects up
+// to dSCOPE_SELECT_MAX with a sample period in ticks. Scope_Sample, called
+// every tick from one task, copies the selected values into DATA frames of
+// the BinLog frame format, so they share the UART with log frames.
+//
+// A selection whose bytes per second, frame overhead included, exceed the
+// budget given to Scope_Init is refused, which bounds the UART share. The CPU
+// cost is the execution time of the task calling Scope_Sample (TaskScheduler
+// stats); register that time as a channel to watch it on the scope itself.
+// Samples of a tick that was skipped or of a frame that could not be sent go
+// missing, the PC sees the gap in the sample ticks.
+//
+// PC to MCU, dSCOPE_COMMAND_SIZE bytes (fixed length receive DMA), frame
+// type dBINLOG_FRAME_SCOPE_LIST or dBINLOG_FRAME_SCOPE_SELECT, payload:
+//   0  u16 period [ticks], 1 .. dSCOPE_PERIOD_MAX
+//   2  u8  count of channels, 0 stops the scope
+//   3  u8  reserved
+//   4  u8  channel[dSCOPE_SELECT_MAX], index in the list
+// Both are answered with INFO:
+//   0  u8  status of the command, dSCOPE_STATUS_...
+//   1  u8  selection, counts accepted selections
+//   2  u16 period [ticks]
+//   4  u8  count
+//   5  u8  channel[dSCOPE_SELECT_MAX]
+//   13 u8  channels registered
+//   14 u16 ticks per second
+//   16 u32 bytes per second of the selection
+//   20 u32 budget [bytes per second]
+//   24     per registered channel: u8 type dSCOPE_TYPE_..., name with NUL
+// DATA:
+//   0  u8  selection the samples belong to
+//   1  u8  samples in the frame
+//   2  u16 period [ticks]
+//   4  u32 tick of the first sample, the others follow period apart
+//   8      samples: selected values in order, little endian, sizes of their types
+
+#define dSCOPE_CHANNELS_MAX     32
+#define dSCOPE_SELECT_MAX       8
+#define dSCOPE_PERIOD_MAX       1000u
+#define dSCOPE_FRAME_SIZE       256u    // [bytes] DATA and INFO frames
+#define dSCOPE_FRAME_AGE        50u     // [ticks] DATA frame goes out at least this often
+#define dSCOPE_COMMAND_SIZE     (dBINLOG_FRAME_OVERHEAD + 4u + dSCOPE_SELECT_MAX)
+#define dSCOPE_DATA_HEADER_SIZE 8u
+#define dSCOPE_INFO_HEADER_SIZE 24u
+
+// Size in bits 3..0, float and signed flags above
+#define dSCOPE_TYPE_UINT8       0x01
+#define dSCOPE_TYPE_UINT16      0x02
+#define dSCOPE_TYPE_UINT32      0x04
+#define dSCOPE_TYPE_INT8        0x11
+#define dSCOPE_TYPE_INT16       0x12
+#define dSCOPE_TYPE_INT32       0x14
+#define dSCOPE_TYPE_FLOAT       0x24
+#define dSCOPE_TYPE_SIZE_MASK   0x0F
+
+#define dSCOPE_STATUS_OK            0
+#define dSCOPE_STATUS_BAD_CHANNEL   1   // index not registered or count above dSCOPE_SELECT_MAX
+#define dSCOPE_STATUS_BAD_PERIOD    2
+#define dSCOPE_STATUS_OVER_BUDGET   3   // selection needs more bytes per second than the budget
+
+typedef struct ScopeChannel_t {
+    const char *Name;
+    const volatile void *Address;   // aligned to the size of Type where the core needs it
+    uint8_t Type;                   // dSCOPE_TYPE_...
+} ScopeChannel;
+
+typedef struct ScopeStats_t {
+    uint32_t Samples;       // taken
+    uint32_t Lost;          // taken but not sent: previous frame still not out, new selection
+    uint32_t Frames;        // DATA frames handed out
+} ScopeStats;
+
+// Any time before or after Scope_Init, name and variable stay valid; false
+// when the table is full. Registering the same name again changes nothing.
+bool Scope_Register(const char *name, const volatile void *address, uint8_t type);
+// Clears the selection, channels stay registered
+void Scope_Init(uint16_t ticksPerSecond, uint32_t budget);
+// Received command frame, false when it is none (bad CRC, length or type)
+bool Scope_Command(const uint8_t *frame, uint16_t length);
+// Every tick, from one task (not interrupts)
+void Scope_Sample(uint32_t tick);
+// Frame to send, INFO before DATA, NULL when none. Stays untouched until
+// Scope_FrameSent, which is called once the UART has sent it. Same context
+// as Scope_Sample.
+const uint8_t *Scope_GetFrame(uint16_t *length);
+void Scope_FrameSent(void);
+// Bytes per second a selection takes on the UART, frame overhead included
+uint32_t Scope_GetRate(uint8_t count, const uint8_t *channels, uint16_t period);
+void Scope_GetStats(ScopeStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCOPE_H
@@ -0,0 +1,138 @@
+#include "TaskScheduler.h"
+#include <stddef.h>
+
+// True when tick a is at or after tick b, safe across counter wrap
+#define TICK_REACHED(a, b)  ((int32_t)((uint32_t)(a) - (uint32_t)(b)) >= 0)
+
+static void TaskScheduler_Run(const TaskScheduler *scheduler, const Task *task, TaskStats *stats)
+{
+    uint32_t start = 0;
+    uint32_t elapsed;
+
+    if (scheduler->GetTime != NULL) {
+        start = scheduler->GetTime();
+    }
+
+    task->Function();
+
+    stats->Runs++;
+    if (scheduler->GetTime != NULL) {
+        elapsed = scheduler->GetTime() - start;
+        stats->LastTime = elapsed;
+        if (elapsed > stats->MaxTime) {
+            stats->MaxTime = elapsed;
+        }
+        if ((task->Budget != 0) && (elapsed > task->Budget) && (stats->BudgetOverruns < UINT16_MAX)) {
+            stats->BudgetOverruns++;
+        }
+    }
+}
+
+static void TaskScheduler_AddSkipped(TaskStats *stats, uint32_t count)
+{
+    if (count > (uint32_t)(UINT16_MAX - stats->Skipped)) {
+        stats->Skipped = UINT16_MAX;
+    } else {
+        stats->Skipped += (uint16_t)count;
+    }
+}
+
+void TaskScheduler_Init(TaskScheduler *scheduler, const Task *tasks, TaskControl *control,
+                        uint8_t taskCount, TaskScheduler_TimeSource getTime, uint32_t currentTick)
+{
+    uint8_t i;
+
+    scheduler->Tasks = tasks;
+    scheduler->Control = control;
+    scheduler->TaskCount = taskCount;
+    scheduler->GetTime = getTime;
+
+    for (i = 0; i < taskCount; i++) {
+        uint16_t period = (tasks[i].Period != 0) ? tasks[i].Period : 1;
+        // First release is the next tick matching the phase
+        control[i].NextRelease = currentTick + ((tasks[i].Phase + period - (currentTick % period)) % period);
+    }
+    TaskScheduler_ResetStats(scheduler);
+}
+
+void TaskScheduler_Perform(TaskScheduler *scheduler, uint32_t currentTick)
+{
+    uint8_t i;
+
+    // Table order is priority order within a tick
+    for (i = 0; i < scheduler->TaskCount; i++) {
+        const Task *task = &scheduler->Tasks[i];
+        TaskControl *control = &scheduler->Control[i];
+        uint16_t period = (task->Period != 0) ? task->Period : 1;
+        uint32_t missed;
+
+        if (!TICK_REACHED(currentTick, control->NextRelease)) {
+            continue;
+        }
+
+        if ((currentTick != control->NextRelease) && (control->Stats.Late < UINT16_MAX)) {
+            control->Stats.Late++;
+        }
+
+        // Releases fully passed before the current one
+        missed = (currentTick - control->NextRelease) / period;
+
+        if (task->Policy == TaskPolicy_CatchUp) {
+            uint8_t runs = 0;
+            uint8_t maxRuns = (task->MaxCatchUp != 0) ? task->MaxCatchUp : 1;
+
+            while (TICK_REACHED(currentTick, control->NextRelease) && (runs < maxRuns)) {
+                TaskScheduler_Run(scheduler, task, &control->Stats);
+                control->NextRelease += period;
+                runs++;
+            }
+            if (TICK_REACHED(currentTick, control->NextRelease)) {
+                // Catch-up limit reached, realign to the grid and drop the rest
+                missed = ((currentTick - control->NextRelease) / period) + 1;
+                TaskScheduler_AddSkipped(&control->Stats, missed);
+                control->NextRelease += missed * period;
+            }
+        } else {
+            TaskScheduler_Run(scheduler, task, &control->Stats);
+            TaskScheduler_AddSkipped(&control->Stats, missed);
+            control->NextRelease += (missed + 1) * period;
+        }
+    }
+}
+
+const TaskStats *TaskScheduler_GetStats(const TaskScheduler *scheduler, uint8_t taskIndex)
+{
+    if (taskIndex >= scheduler->TaskCount) {
+        return NULL;
+    }
+    return &scheduler->Control[taskIndex].Stats;
+}
+
+uint16_t TaskScheduler_GetMissCount(const TaskScheduler *scheduler)
+{
+    uint32_t count = 0;
+    uint8_t i;
+
+    for (i = 0; i < scheduler->TaskCount; i++) {
+        const TaskStats *stats = &scheduler->Control[i].Stats;
+
+        count += (uint32_t)stats->Late + stats->Skipped + stats->BudgetOverruns;
+    }
+    return (count > UINT16_MAX) ? UINT16_MAX : (uint16_t)count;
+}
+
+void TaskScheduler_ResetStats(TaskScheduler *scheduler)
+{
+    uint8_t i;
+
+    for (i = 0; i < scheduler->TaskCount; i++) {
+        TaskStats *stats = &scheduler->Control[i].Stats;
+
+        stats->Runs = 0;
+        stats->Skipped = 0;
+        stats->Late = 0;
+        stats->BudgetOverruns = 0;
+        stats->LastTime = 0;
+        stats->MaxTime = 0;
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cooperative, table driven scheduler shared by all boards.
+// Time is given in ticks by the caller (1 tick = 1 ms on PMB and IMU), so the
+// same table can be driven from SYSTICK on target or from a simulated counter
+// on host. Phase offsets spread tasks of the same period over different ticks.
+
+typedef void (*TaskScheduler_Function)(void);
+typedef uint32_t (*TaskScheduler_TimeSource)(void);
+
+typedef enum TaskMissPolicy_t {
+    TaskPolicy_Skip = 0,    // run once, drop releases that were missed
+    TaskPolicy_CatchUp      // run once for every missed release (bounded by MaxCatchUp)
+} TaskMissPolicy;
+
+typedef struct Task_t {
+    TaskScheduler_Function Function;
+    uint16_t Period;        // [ticks]
+    uint16_t Phase;         // [ticks] offset of first release, < Period
+    uint32_t Budget;        // [time source units] 0 - not checked
+    TaskMissPolicy Policy;
+    uint8_t MaxCatchUp;     // runs per TaskScheduler_Perform call for CatchUp policy
+} Task;
+
+typedef struct TaskStats_t {
+    uint32_t Runs;
+    uint16_t Skipped;           // releases dropped by Skip policy or catch-up limit
+    uint16_t Late;              // runs started at least one tick after release
+    uint16_t BudgetOverruns;
+    uint32_t LastTime;          // [time source units]
+    uint32_t MaxTime;           // [time source units]
+} TaskStats;
+
+typedef struct TaskControl_t {
+    uint32_t NextRelease;
+    TaskStats Stats;
+} TaskControl;
+
+typedef struct TaskScheduler_t {
+    const Task *Tasks;
+    TaskControl *Control;       // one entry per task, owned by caller
+    uint8_t TaskCount;
+    TaskScheduler_TimeSource GetTime;   // NULL - no execution time measurement
+} TaskScheduler;
+
+void TaskScheduler_Init(TaskScheduler *scheduler, const Task *tasks, TaskControl *control,
+                        uint8_t taskCount, TaskScheduler_TimeSource getTime, uint32_t currentTick);
+void TaskScheduler_Perform(TaskScheduler *scheduler, uint32_t currentTick);
+const TaskStats *TaskScheduler_GetStats(const TaskScheduler *scheduler, uint8_t taskIndex);
+// Late and skipped releases plus budget overruns of all tasks, saturates at UINT16_MAX
+uint16_t TaskScheduler_GetMissCount(const TaskScheduler *scheduler);
+void TaskScheduler_ResetStats(TaskScheduler *scheduler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,179 @@
+#include "TimeSync.h"
+#include <stddef.h>
+#include <string.h>
+
+#define dTIMESYNC_WEEK              604800u     // [s]
+
+static uint32_t TimeSync_Abs(int32_t value)
+{
+    return (value < 0) ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+}
+
+static void TimeSync_Start(TimeSync *sync, const TimeSyncSample *sample)
+{
+    sync->IsSynchronised = true;
+    sync->Drift = 0;
+    sync->DriftError = dTIMESYNC_MAX_DRIFT * 1000u;
+    sync->Offset = sample->Offset;
+    sync->LastLocal = sample->Local;
+    sync->ErrorBound = sample->Bound;
+    sync->RefOffset = sample->Offset;
+    sync->RefBound = sync->ErrorBound;
+    sync->RefLocal = sample->Local;
+    sync->Updates++;
+}
+
+static void TimeSync_Update(TimeSync *sync, const TimeSyncSample *sample)
+{
+    uint32_t elapsed;
+    int32_t measured;
+    uint32_t measuredError;
+    uint32_t predicted;
+
+    if (!TimeSync_IsSynchronised(sync, sample->Local)) {
+        TimeSync_Start(sync, sample);
+        return;
+    }
+
+    // Prediction is kept when it is still better than the sample
+    if (sample->Bound > TimeSync_GetErrorBound(sync, sample->Local)) {
+        TimeSync_ToShared(sync, sample->Local, &predicted);
+        sync->ErrorBound = TimeSync_GetErrorBound(sync, sample->Local);
+        sync->Offset = (int32_t)(predicted - sample->Local);
+        sync->LastLocal = sample->Local;
+        return;
+    }
+
+    elapsed = sample->Local - sync->RefLocal;
+    if (elapsed >= dTIMESYNC_DRIFT_INTERVAL) {
+        measured = (int32_t)(((int64_t)(sample->Offset - sync->RefOffset) * 1000000000LL) / (int64_t)elapsed);
+        measuredError = (uint32_t)(((uint64_t)(sync->RefBound + sample->Bound) * 1000000000ULL) / elapsed)
+                        + (dTIMESYNC_DRIFT_WANDER * 1000u);
+        if (sync->DriftError == (dTIMESYNC_MAX_DRIFT * 1000u)) {
+            sync->Drift = measured;
+            sync->DriftError = measuredError;
+        } else {
+            // Error of the filtered value is bounded by the same mix of both bounds
+            sync->Drift += (measured - sync->Drift) / dTIMESYNC_DRIFT_FILTER;
+            sync->DriftError = (uint32_t)((int32_t)sync->DriftError + (dTIMESYNC_DRIFT_WANDER * 1000)
+                               + (((int32_t)measuredError - (int32_t)sync->DriftError) / dTIMESYNC_DRIFT_FILTER));
+        }
+        if (sync->DriftError > (dTIMESYNC_MAX_DRIFT * 1000u)) {
+            sync->Drift = 0;
+            sync->DriftError = dTIMESYNC_MAX_DRIFT * 1000u;
+        }
+        sync->RefOffset = sample->Offset;
+        sync->RefBound = sample->Bound;
+        sync->RefLocal = sample->Local;
+    }
+
+    sync->Offset = sample->Offset;
+    sync->LastLocal = sample->Local;
+    sync->ErrorBound = sample->Bound;
+    sync->Updates++;
+}
+
+static void TimeSync_AddSample(TimeSync *sync, const TimeSyncSample *sample)
+{
+    sync->Samples++;
+
+    if (!TimeSync_IsSynchronised(sync, sample->Local)) {
+        TimeSync_Start(sync, sample);
+        sync->WindowStart = sample->Local;
+        sync->IsCandidate = false;
+        return;
+    }
+
+    if (!sync->IsCandidate || (sample->Bound < sync->Candidate.Bound)) {
+        sync->Candidate = *sample;
+        sync->IsCandidate = true;
+    }
+
+    if ((sample->Local - sync->WindowStart) >= dTIMESYNC_WINDOW) {
+        TimeSync_Update(sync, &sync->Candidate);
+        sync->IsCandidate = false;
+        sync->WindowStart = sample->Local;
+    }
+}
+
+void TimeSync_Init(TimeSync *sync)
+{
+    memset(sync, 0, sizeof(TimeSync));
+    sync->WeekTime = dSYNC_UNKNOWN_WEEK_TIME;
+}
+
+void TimeSync_Stamp(const TimeSync *sync, SyncStamp_t *stamp, uint32_t txTime, uint32_t localTxTime,
+                    uint32_t weekTime, uint16_t errorBound)
+{
+    stamp->txTime = txTime;
+    if (sync->IsPeerReceived) {
+        stamp->echoTime = sync->PeerTxTime;
+        stamp->echoDelay = localTxTime - sync->PeerRxTime;
+    } else {
+        stamp->echoTime = 0;
+        stamp->echoDelay = dSYNC_NO_ECHO;
+    }
+    stamp->weekTime = weekTime;
+    stamp->errorBound = errorBound;
+}
+
+void TimeSync_Receive(TimeSync *sync, const SyncStamp_t *stamp, uint32_t localRxTime, bool isMaster)
+{
+    TimeSyncSample sample;
+    uint32_t roundTrip;
+
+    if (isMaster) {
+        sync->WeekTime = stamp->weekTime;
+        sync->WeekTimeLocal = localRxTime;
+
+        // echoTime is our own local txTime
+        roundTrip = localRxTime - stamp->echoTime;
+        if ((stamp->echoDelay != dSYNC_NO_ECHO) && (stamp->errorBound != dSYNC_NOT_SYNCHRONISED) &&
+            (stamp->echoDelay <= roundTrip) && (roundTrip < dTIMESYNC_TIMEOUT)) {
+            sample.Delay = roundTrip - stamp->echoDelay;
+            sample.Offset = (int32_t)(stamp->txTime + (sample.Delay / 2u) - localRxTime);
+            sample.Local = localRxTime;
+            // Peer residence is measured on peer clock running at up to dTIMESYNC_MAX_DRIFT different rate
+            sample.Bound = ((sample.Delay + 1u) / 2u) + dTIMESYNC_RESOLUTION + stamp->errorBound
+                           + (uint32_t)(((uint64_t)stamp->echoDelay * dTIMESYNC_MAX_DRIFT) / 2000000u);
+            TimeSync_AddSample(sync, &sample);
+        }
+    }
+
+    sync->PeerTxTime = stamp->txTime;
+    sync->PeerRxTime = localRxTime;
+    sync->IsPeerReceived = true;
+}
+
+bool TimeSync_IsSynchronised(const TimeSync *sync, uint32_t local)
+{
+    return sync->IsSynchronised && ((local - sync->LastLocal) < dTIMESYNC_TIMEOUT);
+}
+
+bool TimeSync_ToShared(const TimeSync *sync, uint32_t local, uint32_t *shared)
+{
+    int32_t elapsed = (int32_t)(local - sync->LastLocal);
+
+    if (!TimeSync_IsSynchronised(sync, local)) {
+        return false;
+    }
+    *shared = local + (uint32_t)sync->Offset + (uint32_t)(int32_t)(((int64_t)sync->Drift * elapsed) / 1000000000LL);
+    return true;
+}
+
+uint32_t TimeSync_GetErrorBound(const TimeSync *sync, uint32_t local)
+{
+    if (!TimeSync_IsSynchronised(sync, local)) {
+        return UINT32_MAX;
+    }
+    return sync->ErrorBound +
+           (uint32_t)(((uint64_t)TimeSync_Abs((int32_t)(local - sync->LastLocal)) * sync->DriftError) / 1000000000ULL);
+}
+
+uint32_t TimeSync_GetWeekTime(const TimeSync *sync, uint32_t local)
+{
+    if (sync->WeekTime == dSYNC_UNKNOWN_WEEK_TIME) {
+        return dSYNC_UNKNOWN_WEEK_TIME;
+    }
+    return (sync->WeekTime + ((local - sync->WeekTimeLocal) / 1000000u)) % dTIMESYNC_WEEK;
+}
@@ -0,0 +1,88 @@
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Types/MessageTypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Two way time synchronisation piggy-backed on UART frames, one TimeSync per
+// link end. Every frame carries a SyncStamp_t: sender time at the end of the
+// frame, txTime of the last frame received from the peer (echo) and how long
+// ago that frame was received. A master frame echoing the slave's own frame
+// gives the slave one round trip:
+//   delay  = (rxTime - echoTime) - echoDelay
+//   offset = txTime + delay / 2 - rxTime       (shared - local)
+// The true offset is within +-delay/2 of the sample whatever the asymmetry, so
+// the lowest delay sample of each dTIMESYNC_WINDOW is used, drift is measured
+// between those samples and the error bound grows with the drift uncertainty
+// (bounds of the two samples over their distance, plus dTIMESYNC_DRIFT_WANDER).
+// All times are [us] and wrap around at 32 bit.
+
+#define dTIMESYNC_WINDOW            1000000u    // [us] best sample of each window updates estimate
+#define dTIMESYNC_TIMEOUT           10000000u   // [us] without update the estimate is dropped
+#define dTIMESYNC_RESOLUTION        3u          // [us] timestamp resolution of both link ends and rounding
+#define dTIMESYNC_MAX_DRIFT         200         // [ppm] rate difference before drift is measured
+#define dTIMESYNC_DRIFT_INTERVAL    30000000u   // [us] drift is measured between updates this far apart
+#define dTIMESYNC_DRIFT_WANDER      2           // [ppm] drift change allowed between drift measurements
+#define dTIMESYNC_DRIFT_FILTER      4           // drift += (measured - drift) / dTIMESYNC_DRIFT_FILTER
+
+// Frame duration added to send time, txTime is the end of the frame
+#define dTIMESYNC_FRAME_TIME(Bytes, Baud)   ((uint32_t)(((uint32_t)(Bytes) * 10000000u) / (uint32_t)(Baud)))
+
+typedef struct TimeSyncSample_t {
+    int32_t Offset;         // [us] shared - local
+    uint32_t Delay;         // [us] round trip without peer residence time
+    uint32_t Local;         // [us] local time of sample
+    uint32_t Bound;         // [us] Offset error: half of Delay, master error, resolution and drift over residence
+} TimeSyncSample;
+
+typedef struct TimeSync_t {
+    // Link
+    uint32_t PeerTxTime;    // txTime of last frame received from peer
+    uint32_t PeerRxTime;    // [us local] reception of that frame
+    bool IsPeerReceived;
+    uint32_t WeekTime;      // [s] master wall clock of last master frame
+    uint32_t WeekTimeLocal; // [us local] reception of that frame
+    // Estimate, slave end only
+    bool IsSynchronised;
+    bool IsCandidate;
+    TimeSyncSample Candidate;   // best sample of current window
+    uint32_t WindowStart;       // [us local]
+    uint32_t LastLocal;         // [us local] of last update
+    int32_t Offset;             // [us] shared - local at LastLocal
+    int32_t Drift;              // [ppb] shared clock rate relative to local
+    uint32_t DriftError;        // [ppb] bound of Drift error
+    uint32_t ErrorBound;        // [us] at LastLocal
+    int32_t RefOffset;          // update drift is measured from
+    uint32_t RefBound;          // [us]
+    uint32_t RefLocal;          // [us local]
+    uint32_t Samples;
+    uint32_t Updates;
+} TimeSync;
+
+void TimeSync_Init(TimeSync *sync);
+// Fills stamp of a frame to peer. txTime is in shared timebase on master end
+// and local on slave end, localTxTime is the same instant on local clock.
+// errorBound: master end error to shared timebase, dSYNC_NOT_SYNCHRONISED on slave end.
+void TimeSync_Stamp(const TimeSync *sync, SyncStamp_t *stamp, uint32_t txTime, uint32_t localTxTime,
+                    uint32_t weekTime, uint16_t errorBound);
+// Stamp of a valid frame from peer, isMaster: peer is master of this link
+void TimeSync_Receive(TimeSync *sync, const SyncStamp_t *stamp, uint32_t localRxTime, bool isMaster);
+
+bool TimeSync_IsSynchronised(const TimeSync *sync, uint32_t local);
+// Converts local time to shared timebase, false when not synchronised
+bool TimeSync_ToShared(const TimeSync *sync, uint32_t local, uint32_t *shared);
+// [us] worst case error of TimeSync_ToShared(local), UINT32_MAX when not synchronised
+uint32_t TimeSync_GetErrorBound(const TimeSync *sync, uint32_t local);
+// [s] master wall clock at local time, dSYNC_UNKNOWN_WEEK_TIME when master does not know it
+uint32_t TimeSync_GetWeekTime(const TimeSync *sync, uint32_t local);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMESYNC_H
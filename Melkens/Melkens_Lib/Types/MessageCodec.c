@@ -0,0 +1,389 @@
+/*
+ * MessageCodec.c
+ *
+ * Generated by Tools/MessageGen/message_gen.py from MessageSchema.json, do not edit.
+ */
+
+#include "MessageCodec.h"
+#include "../CRC16/CRC16.h"
+#include <string.h>
+
+void SyncStamp_Pack(const SyncStamp_t *value, uint8_t *buffer)
+{
+  Message_Put32(buffer + 0, (uint32_t)value->txTime);
+  Message_Put32(buffer + 4, (uint32_t)value->echoTime);
+  Message_Put32(buffer + 8, (uint32_t)value->echoDelay);
+  Message_Put32(buffer + 12, (uint32_t)value->weekTime);
+  Message_Put16(buffer + 16, (uint16_t)value->errorBound);
+}
+
+void SyncStamp_Unpack(SyncStamp_t *value, const uint8_t *buffer)
+{
+  value->txTime = (uint32_t)Message_Get32(buffer + 0);
+  value->echoTime = (uint32_t)Message_Get32(buffer + 4);
+  value->echoDelay = (uint32_t)Message_Get32(buffer + 8);
+  value->weekTime = (uint32_t)Message_Get32(buffer + 12);
+  value->errorBound = (uint16_t)Message_Get16(buffer + 16);
+}
+
+void LatencyTrace_Pack(const LatencyTrace_t *value, uint8_t *buffer)
+{
+  Message_Put16(buffer + 0, (uint16_t)value->traceId);
+  Message_Put16(buffer + 2, (uint16_t)value->imuRxTime);
+  Message_Put16(buffer + 4, (uint16_t)value->imuPmbTxTime);
+  Message_Put16(buffer + 6, (uint16_t)value->pmbRxTime);
+  Message_Put16(buffer + 8, (uint16_t)value->pmbTxTime);
+  Message_Put16(buffer + 10, (uint16_t)value->imuPmbRxTime);
+  Message_Put16(buffer + 12, (uint16_t)value->imuTxTime);
+}
+
+void LatencyTrace_Unpack(LatencyTrace_t *value, const uint8_t *buffer)
+{
+  value->traceId = (uint16_t)Message_Get16(buffer + 0);
+  value->imuRxTime = (uint16_t)Message_Get16(buffer + 2);
+  value->imuPmbTxTime = (uint16_t)Message_Get16(buffer + 4);
+  value->pmbRxTime = (uint16_t)Message_Get16(buffer + 6);
+  value->pmbTxTime = (uint16_t)Message_Get16(buffer + 8);
+  value->imuPmbRxTime = (uint16_t)Message_Get16(buffer + 10);
+  value->imuTxTime = (uint16_t)Message_Get16(buffer + 12);
+}
+
+void LinkControl_Pack(const LinkControl_t *value, uint8_t *buffer)
+{
+  buffer[0] = (uint8_t)value->command;
+  buffer[1] = (uint8_t)value->rate;
+  buffer[2] = (uint8_t)value->sequence;
+  buffer[3] = (uint8_t)value->errors;
+}
+
+void LinkControl_Unpack(LinkControl_t *value, const uint8_t *buffer)
+{
+  value->command = (uint8_t)buffer[0];
+  value->rate = (uint8_t)buffer[1];
+  value->sequence = (uint8_t)buffer[2];
+  value->errors = (uint8_t)buffer[3];
+}
+
+void ProtocolHello_Pack(const ProtocolHello_t *value, uint8_t *buffer)
+{
+  Message_Put16(buffer + 0, (uint16_t)value->magic);
+  Message_Put16(buffer + 2, (uint16_t)value->version);
+  Message_Put16(buffer + 4, (uint16_t)value->layoutHash);
+  Message_Put16(buffer + 6, (uint16_t)value->features);
+  Message_Put16(buffer + 8, (uint16_t)value->crc);
+}
+
+void ProtocolHello_Unpack(ProtocolHello_t *value, const uint8_t *buffer)
+{
+  value->magic = (uint16_t)Message_Get16(buffer + 0);
+  value->version = (uint16_t)Message_Get16(buffer + 2);
+  value->layoutHash = (uint16_t)Message_Get16(buffer + 4);
+  value->features = (uint16_t)Message_Get16(buffer + 6);
+  value->crc = (uint16_t)Message_Get16(buffer + 8);
+}
+
+void ProtocolHello_Seal(ProtocolHello_t *frame)
+{
+  frame->crc = CRC16((const uint8_t *)frame, offsetof(ProtocolHello_t, crc));
+}
+
+bool ProtocolHello_IsValid(const ProtocolHello_t *frame)
+{
+  return frame->crc == CRC16((const uint8_t *)frame, offsetof(ProtocolHello_t, crc));
+}
+
+void Imu2PmbFrame_Pack(const Imu2PmbFrame_t *value, uint8_t *buffer)
+{
+  Message_Put16(buffer + 0, (uint16_t)value->motorRightSpeed);
+  Message_Put16(buffer + 2, (uint16_t)value->motorLeftSpeed);
+  Message_Put16(buffer + 4, (uint16_t)value->motorThumbleSpeed);
+  Message_Put16(buffer + 6, (uint16_t)value->motorLiftSpeed);
+  Message_Put16(buffer + 8, (uint16_t)value->motorBelt1Speed);
+  Message_Put16(buffer + 10, (uint16_t)value->motorBelt2Speed);
+  Message_Put16(buffer + 12, (uint16_t)value->traceId);
+  buffer[14] = (uint8_t)value->stop;
+  Message_Put32(buffer + 15, (uint32_t)value->stopTime);
+  buffer[19] = (uint8_t)value->fwTarget;
+  buffer[20] = (uint8_t)value->fwRate;
+  SyncStamp_Pack(&value->sync, buffer + 21);
+  LinkControl_Pack(&value->link, buffer + 39);
+  Message_Put16(buffer + 43, (uint16_t)value->crc);
+}
+
+void Imu2PmbFrame_Unpack(Imu2PmbFrame_t *value, const uint8_t *buffer)
+{
+  value->motorRightSpeed = (int16_t)Message_Get16(buffer + 0);
+  value->motorLeftSpeed = (int16_t)Message_Get16(buffer + 2);
+  value->motorThumbleSpeed = (uint16_t)Message_Get16(buffer + 4);
+  value->motorLiftSpeed = (uint16_t)Message_Get16(buffer + 6);
+  value->motorBelt1Speed = (uint16_t)Message_Get16(buffer + 8);
+  value->motorBelt2Speed = (uint16_t)Message_Get16(buffer + 10);
+  value->traceId = (uint16_t)Message_Get16(buffer + 12);
+  value->stop = (uint8_t)buffer[14];
+  value->stopTime = (uint32_t)Message_Get32(buffer + 15);
+  value->fwTarget = (uint8_t)buffer[19];
+  value->fwRate = (uint8_t)buffer[20];
+  SyncStamp_Unpack(&value->sync, buffer + 21);
+  LinkControl_Unpack(&value->link, buffer + 39);
+  value->crc = (uint16_t)Message_Get16(buffer + 43);
+}
+
+void Imu2PmbFrame_Seal(Imu2PmbFrame_t *frame)
+{
+  frame->crc = CRC16((const uint8_t *)frame, offsetof(Imu2PmbFrame_t, crc));
+}
+
+bool Imu2PmbFrame_IsValid(const Imu2PmbFrame_t *frame)
+{
+  return frame->crc == CRC16((const uint8_t *)frame, offsetof(Imu2PmbFrame_t, crc));
+}
+
+void Pmb2ImuFrame_Pack(const Pmb2ImuFrame_t *value, uint8_t *buffer)
+{
+  Message_Put32(buffer + 0, (uint32_t)value->motorRightRotation);
+  Message_Put32(buffer + 4, (uint32_t)value->motorLeftRotation);
+  Message_Put16(buffer + 8, (uint16_t)value->batteryVoltage);
+  Message_Put16(buffer + 10, (uint16_t)value->adcCurrent);
+  Message_Put16(buffer + 12, (uint16_t)value->thumbleCurrent);
+  Message_Put16(buffer + 14, (uint16_t)value->crcImu2PmbErrorCount);
+  Message_Put16(buffer + 16, (uint16_t)value->loopMaxTime);
+  Message_Put16(buffer + 18, (uint16_t)value->missedTicks);
+  Message_Put16(buffer + 20, (uint16_t)value->taskMisses);
+  Message_Put16(buffer + 22, (uint16_t)value->traceId);
+  Message_Put16(buffer + 24, (uint16_t)value->traceRxTime);
+  Message_Put16(buffer + 26, (uint16_t)value->traceTxTime);
+  Message_Put32(buffer + 28, (uint32_t)value->stopTime);
+  Message_Put16(buffer + 32, (uint16_t)value->stopReaction);
+  SyncStamp_Pack(&value->sync, buffer + 34);
+  LinkControl_Pack(&value->link, buffer + 52);
+  Message_Put16(buffer + 56, (uint16_t)value->crc);
+}
+
+void Pmb2ImuFrame_Unpack(Pmb2ImuFrame_t *value, const uint8_t *buffer)
+{
+  value->motorRightRotation = (uint32_t)Message_Get32(buffer + 0);
+  value->motorLeftRotation = (uint32_t)Message_Get32(buffer + 4);
+  value->batteryVoltage = (uint16_t)Message_Get16(buffer + 8);
+  value->adcCurrent = (uint16_t)Message_Get16(buffer + 10);
+  value->thumbleCurrent = (uint16_t)Message_Get16(buffer + 12);
+  value->crcImu2PmbErrorCount = (uint16_t)Message_Get16(buffer + 14);
+  value->loopMaxTime = (uint16_t)Message_Get16(buffer + 16);
+  value->missedTicks = (uint16_t)Message_Get16(buffer + 18);
+  value->taskMisses = (uint16_t)Message_Get16(buffer + 20);
+  value->traceId = (uint16_t)Message_Get16(buffer + 22);
+  value->traceRxTime = (uint16_t)Message_Get16(buffer + 24);
+  value->traceTxTime = (uint16_t)Message_Get16(buffer + 26);
+  value->stopTime = (uint32_t)Message_Get32(buffer + 28);
+  value->stopReaction = (uint16_t)Message_Get16(buffer + 32);
+  SyncStamp_Unpack(&value->sync, buffer + 34);
+  LinkControl_Unpack(&value->link, buffer + 52);
+  value->crc = (uint16_t)Message_Get16(buffer + 56);
+}
+
+void Pmb2ImuFrame_Seal(Pmb2ImuFrame_t *frame)
+{
+  frame->crc = CRC16((const uint8_t *)frame, offsetof(Pmb2ImuFrame_t, crc));
+}
+
+bool Pmb2ImuFrame_IsValid(const Pmb2ImuFrame_t *frame)
+{
+  return frame->crc == CRC16((const uint8_t *)frame, offsetof(Pmb2ImuFrame_t, crc));
+}
+
+void Imu2EspFrame_Pack(const Imu2EspFrame_t *value, uint8_t *buffer)
+{
+  Message_Put32(buffer + 0, (uint32_t)value->magnetBarStatus);
+  Message_Put16(buffer + 4, (uint16_t)value->pmbConnection);
+  Message_Put16(buffer + 6, (uint16_t)value->motorRightSpeed);
+  Message_Put16(buffer + 8, (uint16_t)value->motorLeftSpeed);
+  Message_Put16(buffer + 10, (uint16_t)value->batteryVoltage);
+  Message_Put16(buffer + 12, (uint16_t)value->adcCurrent);
+  Message_Put16(buffer + 14, (uint16_t)value->thumbleCurrent);
+  Message_Put16(buffer + 16, (uint16_t)value->crcImu2PmbErrorCount);
+  Message_Put16(buffer + 18, (uint16_t)value->crcPmb2ImuErrorCount);
+  Message_Put16(buffer + 20, (uint16_t)value->crcEsp2ImuErrorCount);
+  Message_Put16(buffer + 22, (uint16_t)value->routeUploadAck);
+  buffer[24] = (uint8_t)value->routeUploadState;
+  buffer[25] = (uint8_t)value->routeCount;
+  Message_Put16(buffer + 26, (uint16_t)value->commandSequence);
+  LatencyTrace_Pack(&value->trace, buffer + 28);
+  Message_Put32(buffer + 42, (uint32_t)value->stopTime);
+  Message_Put16(buffer + 46, (uint16_t)value->stopReaction);
+  buffer[48] = (uint8_t)value->collision;
+  Message_Put16(buffer + 49, (uint16_t)value->pmbLoopMaxTime);
+  Message_Put16(buffer + 51, (uint16_t)value->pmbMissedTicks);
+  Message_Put16(buffer + 53, (uint16_t)value->pmbTaskMisses);
+  SyncStamp_Pack(&value->sync, buffer + 55);
+  LinkControl_Pack(&value->link, buffer + 73);
+  Message_Put16(buffer + 77, (uint16_t)value->crc);
+}
+
+void Imu2EspFrame_Unpack(Imu2EspFrame_t *value, const uint8_t *buffer)
+{
+  value->magnetBarStatus = (uint32_t)Message_Get32(buffer + 0);
+  value->pmbConnection = (uint16_t)Message_Get16(buffer + 4);
+  value->motorRightSpeed = (int16_t)Message_Get16(buffer + 6);
+  value->motorLeftSpeed = (int16_t)Message_Get16(buffer + 8);
+  value->batteryVoltage = (uint16_t)Message_Get16(buffer + 10);
+  value->adcCurrent = (uint16_t)Message_Get16(buffer + 12);
+  value->thumbleCurrent = (uint16_t)Message_Get16(buffer + 14);
+  value->crcImu2PmbErrorCount = (uint16_t)Message_Get16(buffer + 16);
+  value->crcPmb2ImuErrorCount = (uint16_t)Message_Get16(buffer + 18);
+  value->crcEsp2ImuErrorCount = (uint16_t)Message_Get16(buffer + 20);
+  value->routeUploadAck = (uint16_t)Message_Get16(buffer + 22);
+  value->routeUploadState = (uint8_t)buffer[24];
+  value->routeCount = (uint8_t)buffer[25];
+  value->commandSequence = (uint16_t)Message_Get16(buffer + 26);
+  LatencyTrace_Unpack(&value->trace, buffer + 28);
+  value->stopTime = (uint32_t)Message_Get32(buffer + 42);
+  value->stopReaction = (uint16_t)Message_Get16(buffer + 46);
+  value->collision = (uint8_t)buffer[48];
+  value->pmbLoopMaxTime = (uint16_t)Message_Get16(buffer + 49);
+  value->pmbMissedTicks = (uint16_t)Message_Get16(buffer + 51);
+  value->pmbTaskMisses = (uint16_t)Message_Get16(buffer + 53);
+  SyncStamp_Unpack(&value->sync, buffer + 55);
+  LinkControl_Unpack(&value->link, buffer + 73);
+  value->crc = (uint16_t)Message_Get16(buffer + 77);
+}
+
+void Imu2EspFrame_Seal(Imu2EspFrame_t *frame)
+{
+  frame->crc = CRC16((const uint8_t *)frame, offsetof(Imu2EspFrame_t, crc));
+}
+
+bool Imu2EspFrame_IsValid(const Imu2EspFrame_t *frame)
+{
+  return frame->crc == CRC16((const uint8_t *)frame, offsetof(Imu2EspFrame_t, crc));
+}
+
+void RouteBlock_Pack(const RouteBlock_t *value, uint8_t *buffer)
+{
+  buffer[0] = (uint8_t)value->command;
+  buffer[1] = (uint8_t)value->length;
+  Message_Put16(buffer + 2, (uint16_t)value->sequence);
+  memcpy(buffer + 4, value->data, 64);
+}
+
+void RouteBlock_Unpack(RouteBlock_t *value, const uint8_t *buffer)
+{
+  value->command = (uint8_t)buffer[0];
+  value->length = (uint8_t)buffer[1];
+  value->sequence = (uint16_t)Message_Get16(buffer + 2);
+  memcpy(value->data, buffer + 4, 64);
+}
+
+void Esp2ImuFrame_Pack(const Esp2ImuFrame_t *value, uint8_t *buffer)
+{
+  buffer[0] = (uint8_t)value->frameType;
+  memset(buffer + 1, 0, 68);
+  if (value->frameType == dESP2IMU_FRAME_CONTROL) {
+    buffer[1] = (uint8_t)value->moveX;
+    buffer[2] = (uint8_t)value->moveY;
+    Message_Put16(buffer + 3, (uint16_t)value->augerSpeed);
+    buffer[5] = (uint8_t)value->rootNumber;
+    buffer[6] = (uint8_t)value->rootAction;
+    buffer[7] = (uint8_t)value->power;
+    buffer[8] = (uint8_t)value->charging;
+    Message_Put16(buffer + 9, (uint16_t)value->commandSequence);
+  } else if (value->frameType == dESP2IMU_FRAME_ROUTE_BLOCK) {
+    RouteBlock_Pack(&value->routeBlock, buffer + 1);
+  } else if (value->frameType == dESP2IMU_FRAME_HELLO) {
+    ProtocolHello_Pack(&value->hello, buffer + 1);
+  } else if (value->frameType == dESP2IMU_FRAME_STOP) {
+    Message_Put16(buffer + 1, (uint16_t)value->stopSequence);
+    Message_Put32(buffer + 3, (uint32_t)value->stopTime);
+  } else if (value->frameType == dESP2IMU_FRAME_FW_UPDATE) {
+    buffer[1] = (uint8_t)value->fwTarget;
+    buffer[2] = (uint8_t)value->fwRate;
+  }
+  SyncStamp_Pack(&value->sync, buffer + 69);
+  LinkControl_Pack(&value->link, buffer + 87);
+  Message_Put16(buffer + 91, (uint16_t)value->crc);
+}
+
+void Esp2ImuFrame_Unpack(Esp2ImuFrame_t *value, const uint8_t *buffer)
+{
+  value->frameType = (uint8_t)buffer[0];
+  memset(&value->moveX, 0, 68);
+  if (value->frameType == dESP2IMU_FRAME_CONTROL) {
+    value->moveX = (int8_t)buffer[1];
+    value->moveY = (int8_t)buffer[2];
+    value->augerSpeed = (uint16_t)Message_Get16(buffer + 3);
+    value->rootNumber = (uint8_t)buffer[5];
+    value->rootAction = (uint8_t)buffer[6];
+    value->power = (uint8_t)buffer[7];
+    value->charging = (uint8_t)buffer[8];
+    value->commandSequence = (uint16_t)Message_Get16(buffer + 9);
+  } else if (value->frameType == dESP2IMU_FRAME_ROUTE_BLOCK) {
+    RouteBlock_Unpack(&value->routeBlock, buffer + 1);
+  } else if (value->frameType == dESP2IMU_FRAME_HELLO) {
+    ProtocolHello_Unpack(&value->hello, buffer + 1);
+  } else if (value->frameType == dESP2IMU_FRAME_STOP) {
+    value->stopSequence = (uint16_t)Message_Get16(buffer + 1);
+    value->stopTime = (uint32_t)Message_Get32(buffer + 3);
+  } else if (value->frameType == dESP2IMU_FRAME_FW_UPDATE) {
+    value->fwTarget = (uint8_t)buffer[1];
+    value->fwRate = (uint8_t)buffer[2];
+  }
+  SyncStamp_Unpack(&value->sync, buffer + 69);
+  LinkControl_Unpack(&value->link, buffer + 87);
+  value->crc = (uint16_t)Message_Get16(buffer + 91);
+}
+
+void Esp2ImuFrame_Seal(Esp2ImuFrame_t *frame)
+{
+  frame->crc = CRC16((const uint8_t *)frame, offsetof(Esp2ImuFrame_t, crc));
+}
+
+bool Esp2ImuFrame_IsValid(const Esp2ImuFrame_t *frame)
+{
+  return frame->crc == CRC16((const uint8_t *)frame, offsetof(Esp2ImuFrame_t, crc));
+}
+
+void Imu2PCFrame_Pack(const Imu2PCFrame_t *value, uint8_t *buffer)
+{
+  Message_Put16(buffer + 0, (uint16_t)value->motorRightSpeed);
+  Message_Put16(buffer + 2, (uint16_t)value->motorLeftSpeed);
+  Message_Put16(buffer + 4, (uint16_t)value->Xpos1);
+  Message_Put16(buffer + 6, (uint16_t)value->Ypos1);
+  Message_Put16(buffer + 8, (uint16_t)value->Xpos2);
+  Message_Put16(buffer + 10, (uint16_t)value->Ypos2);
+  Message_Put16(buffer + 12, (uint16_t)value->angle);
+  Message_Put16(buffer + 14, (uint16_t)value->motorBelt2Speed);
+  Message_Put16(buffer + 16, (uint16_t)value->delimiter);
+}
+
+void Imu2PCFrame_Unpack(Imu2PCFrame_t *value, const uint8_t *buffer)
+{
+  value->motorRightSpeed = (uint16_t)Message_Get16(buffer + 0);
+  value->motorLeftSpeed = (uint16_t)Message_Get16(buffer + 2);
+  value->Xpos1 = (uint16_t)Message_Get16(buffer + 4);
+  value->Ypos1 = (uint16_t)Message_Get16(buffer + 6);
+  value->Xpos2 = (uint16_t)Message_Get16(buffer + 8);
+  value->Ypos2 = (uint16_t)Message_Get16(buffer + 10);
+  value->angle = (uint16_t)Message_Get16(buffer + 12);
+  value->motorBelt2Speed = (uint16_t)Message_Get16(buffer + 14);
+  value->delimiter = (uint16_t)Message_Get16(buffer + 16);
+}
+
+void ProtocolHello_Make(ProtocolHello_t *hello)
+{
+  hello->magic = dPROTOCOL_HELLO_MAGIC;
+  hello->version = PROTOCOL_VERSION;
+  hello->layoutHash = dPROTOCOL_LAYOUT_HASH;
+  hello->features = dPROTOCOL_FEATURES;
+  ProtocolHello_Seal(hello);
+}
+
+bool ProtocolHello_Check(const ProtocolHello_t *hello)
+{
+  return (hello->magic == dPROTOCOL_HELLO_MAGIC) && ProtocolHello_IsValid(hello);
+}
+
+uint16_t ProtocolHello_CommonFeatures(const ProtocolHello_t *peer)
+{
+  if (peer->layoutHash != dPROTOCOL_LAYOUT_HASH) {
+    return 0;
+  }
+  return (uint16_t)(peer->features & dPROTOCOL_FEATURES);
+}
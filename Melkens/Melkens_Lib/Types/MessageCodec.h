@@ -0,0 +1,352 @@
+/*
+ * MessageCodec.h
+ *
+ * Generated by Tools/MessageGen/message_gen.py from MessageSchema.json, do not edit.
+ *
+ * <Type>_Pack/_Unpack  struct <-> little endian bytes, independent of
+ *                      compiler layout, union by its discriminator
+ * <Type>View_Get/Set   zero-copy access to a field of a received byte buffer,
+ *                      any alignment
+ * <Frame>_Seal/IsValid CRC16 of a frame struct
+ */
+
+#ifndef MESSAGECODEC_H
+#define MESSAGECODEC_H
+
+#include "MessageTypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define dSYNC_STAMP_SIZE 18
+void SyncStamp_Pack(const SyncStamp_t *value, uint8_t *buffer);
+void SyncStamp_Unpack(SyncStamp_t *value, const uint8_t *buffer);
+
+#define dLATENCY_TRACE_SIZE 14
+void LatencyTrace_Pack(const LatencyTrace_t *value, uint8_t *buffer);
+void LatencyTrace_Unpack(LatencyTrace_t *value, const uint8_t *buffer);
+
+#define dLINK_CONTROL_SIZE 4
+void LinkControl_Pack(const LinkControl_t *value, uint8_t *buffer);
+void LinkControl_Unpack(LinkControl_t *value, const uint8_t *buffer);
+
+#define dPROTOCOL_HELLO_SIZE 10
+void ProtocolHello_Pack(const ProtocolHello_t *value, uint8_t *buffer);
+void ProtocolHello_Unpack(ProtocolHello_t *value, const uint8_t *buffer);
+void ProtocolHello_Seal(ProtocolHello_t *frame);
+bool ProtocolHello_IsValid(const ProtocolHello_t *frame);
+
+#define dIMU2PMB_FRAME_SIZE 45
+void Imu2PmbFrame_Pack(const Imu2PmbFrame_t *value, uint8_t *buffer);
+void Imu2PmbFrame_Unpack(Imu2PmbFrame_t *value, const uint8_t *buffer);
+void Imu2PmbFrame_Seal(Imu2PmbFrame_t *frame);
+bool Imu2PmbFrame_IsValid(const Imu2PmbFrame_t *frame);
+
+#define dPMB2IMU_FRAME_SIZE 58
+void Pmb2ImuFrame_Pack(const Pmb2ImuFrame_t *value, uint8_t *buffer);
+void Pmb2ImuFrame_Unpack(Pmb2ImuFrame_t *value, const uint8_t *buffer);
+void Pmb2ImuFrame_Seal(Pmb2ImuFrame_t *frame);
+bool Pmb2ImuFrame_IsValid(const Pmb2ImuFrame_t *frame);
+
+#define dIMU2ESP_FRAME_SIZE 79
+void Imu2EspFrame_Pack(const Imu2EspFrame_t *value, uint8_t *buffer);
+void Imu2EspFrame_Unpack(Imu2EspFrame_t *value, const uint8_t *buffer);
+void Imu2EspFrame_Seal(Imu2EspFrame_t *frame);
+bool Imu2EspFrame_IsValid(const Imu2EspFrame_t *frame);
+
+#define dROUTE_BLOCK_SIZE 68
+void RouteBlock_Pack(const RouteBlock_t *value, uint8_t *buffer);
+void RouteBlock_Unpack(RouteBlock_t *value, const uint8_t *buffer);
+
+#define dESP2IMU_FRAME_SIZE 93
+void Esp2ImuFrame_Pack(const Esp2ImuFrame_t *value, uint8_t *buffer);
+void Esp2ImuFrame_Unpack(Esp2ImuFrame_t *value, const uint8_t *buffer);
+void Esp2ImuFrame_Seal(Esp2ImuFrame_t *frame);
+bool Esp2ImuFrame_IsValid(const Esp2ImuFrame_t *frame);
+
+#define dIMU2PC_FRAME_SIZE 18
+void Imu2PCFrame_Pack(const Imu2PCFrame_t *value, uint8_t *buffer);
+void Imu2PCFrame_Unpack(Imu2PCFrame_t *value, const uint8_t *buffer);
+
+// Own hello: magic, PROTOCOL_VERSION, dPROTOCOL_LAYOUT_HASH, dPROTOCOL_FEATURES, sealed
+void ProtocolHello_Make(ProtocolHello_t *hello);
+// Valid hello with magic, whatever the peer version
+bool ProtocolHello_Check(const ProtocolHello_t *hello);
+// Features both ends support, 0 when frame layouts differ
+uint16_t ProtocolHello_CommonFeatures(const ProtocolHello_t *peer);
+
+static inline uint16_t Message_Get16(const uint8_t *buffer)
+{
+  return (uint16_t)(buffer[0] | ((uint16_t)buffer[1] << 8));
+}
+
+static inline uint32_t Message_Get32(const uint8_t *buffer)
+{
+  return (uint32_t)Message_Get16(buffer) | ((uint32_t)Message_Get16(buffer + 2) << 16);
+}
+
+static inline void Message_Put16(uint8_t *buffer, uint16_t value)
+{
+  buffer[0] = (uint8_t)value;
+  buffer[1] = (uint8_t)(value >> 8);
+}
+
+static inline void Message_Put32(uint8_t *buffer, uint32_t value)
+{
+  Message_Put16(buffer, (uint16_t)value);
+  Message_Put16(buffer + 2, (uint16_t)(value >> 16));
+}
+
+// ProtocolHello_t views
+static inline uint16_t ProtocolHelloView_GetMagic(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 0); }
+static inline void ProtocolHelloView_SetMagic(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 0, (uint16_t)value); }
+static inline uint16_t ProtocolHelloView_GetVersion(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 2); }
+static inline void ProtocolHelloView_SetVersion(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 2, (uint16_t)value); }
+static inline uint16_t ProtocolHelloView_GetLayoutHash(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 4); }
+static inline void ProtocolHelloView_SetLayoutHash(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 4, (uint16_t)value); }
+static inline uint16_t ProtocolHelloView_GetFeatures(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 6); }
+static inline void ProtocolHelloView_SetFeatures(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 6, (uint16_t)value); }
+static inline uint16_t ProtocolHelloView_GetCrc(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 8); }
+static inline void ProtocolHelloView_SetCrc(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 8, (uint16_t)value); }
+
+// Imu2PmbFrame_t views
+static inline int16_t Imu2PmbFrameView_GetMotorRightSpeed(const uint8_t *buffer) { return (int16_t)Message_Get16(buffer + 0); }
+static inline void Imu2PmbFrameView_SetMotorRightSpeed(uint8_t *buffer, int16_t value) { Message_Put16(buffer + 0, (uint16_t)value); }
+static inline int16_t Imu2PmbFrameView_GetMotorLeftSpeed(const uint8_t *buffer) { return (int16_t)Message_Get16(buffer + 2); }
+static inline void Imu2PmbFrameView_SetMotorLeftSpeed(uint8_t *buffer, int16_t value) { Message_Put16(buffer + 2, (uint16_t)value); }
+static inline uint16_t Imu2PmbFrameView_GetMotorThumbleSpeed(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 4); }
+static inline void Imu2PmbFrameView_SetMotorThumbleSpeed(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 4, (uint16_t)value); }
+static inline uint16_t Imu2PmbFrameView_GetMotorLiftSpeed(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 6); }
+static inline void Imu2PmbFrameView_SetMotorLiftSpeed(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 6, (uint16_t)value); }
+static inline uint16_t Imu2PmbFrameView_GetMotorBelt1Speed(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 8); }
+static inline void Imu2PmbFrameView_SetMotorBelt1Speed(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 8, (uint16_t)value); }
+static inline uint16_t Imu2PmbFrameView_GetMotorBelt2Speed(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 10); }
+static inline void Imu2PmbFrameView_SetMotorBelt2Speed(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 10, (uint16_t)value); }
+static inline uint16_t Imu2PmbFrameView_GetTraceId(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 12); }
+static inline void Imu2PmbFrameView_SetTraceId(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 12, (uint16_t)value); }
+static inline uint8_t Imu2PmbFrameView_GetStop(const uint8_t *buffer) { return (uint8_t)buffer[14]; }
+static inline void Imu2PmbFrameView_SetStop(uint8_t *buffer, uint8_t value) { buffer[14] = (uint8_t)value; }
+static inline uint32_t Imu2PmbFrameView_GetStopTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 15); }
+static inline void Imu2PmbFrameView_SetStopTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 15, (uint32_t)value); }
+static inline uint8_t Imu2PmbFrameView_GetFwTarget(const uint8_t *buffer) { return (uint8_t)buffer[19]; }
+static inline void Imu2PmbFrameView_SetFwTarget(uint8_t *buffer, uint8_t value) { buffer[19] = (uint8_t)value; }
+static inline uint8_t Imu2PmbFrameView_GetFwRate(const uint8_t *buffer) { return (uint8_t)buffer[20]; }
+static inline void Imu2PmbFrameView_SetFwRate(uint8_t *buffer, uint8_t value) { buffer[20] = (uint8_t)value; }
+static inline uint32_t Imu2PmbFrameView_GetSyncTxTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 21); }
+static inline void Imu2PmbFrameView_SetSyncTxTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 21, (uint32_t)value); }
+static inline uint32_t Imu2PmbFrameView_GetSyncEchoTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 25); }
+static inline void Imu2PmbFrameView_SetSyncEchoTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 25, (uint32_t)value); }
+static inline uint32_t Imu2PmbFrameView_GetSyncEchoDelay(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 29); }
+static inline void Imu2PmbFrameView_SetSyncEchoDelay(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 29, (uint32_t)value); }
+static inline uint32_t Imu2PmbFrameView_GetSyncWeekTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 33); }
+static inline void Imu2PmbFrameView_SetSyncWeekTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 33, (uint32_t)value); }
+static inline uint16_t Imu2PmbFrameView_GetSyncErrorBound(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 37); }
+static inline void Imu2PmbFrameView_SetSyncErrorBound(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 37, (uint16_t)value); }
+static inline uint8_t Imu2PmbFrameView_GetLinkCommand(const uint8_t *buffer) { return (uint8_t)buffer[39]; }
+static inline void Imu2PmbFrameView_SetLinkCommand(uint8_t *buffer, uint8_t value) { buffer[39] = (uint8_t)value; }
+static inline uint8_t Imu2PmbFrameView_GetLinkRate(const uint8_t *buffer) { return (uint8_t)buffer[40]; }
+static inline void Imu2PmbFrameView_SetLinkRate(uint8_t *buffer, uint8_t value) { buffer[40] = (uint8_t)value; }
+static inline uint8_t Imu2PmbFrameView_GetLinkSequence(const uint8_t *buffer) { return (uint8_t)buffer[41]; }
+static inline void Imu2PmbFrameView_SetLinkSequence(uint8_t *buffer, uint8_t value) { buffer[41] = (uint8_t)value; }
+static inline uint8_t Imu2PmbFrameView_GetLinkErrors(const uint8_t *buffer) { return (uint8_t)buffer[42]; }
+static inline void Imu2PmbFrameView_SetLinkErrors(uint8_t *buffer, uint8_t value) { buffer[42] = (uint8_t)value; }
+static inline uint16_t Imu2PmbFrameView_GetCrc(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 43); }
+static inline void Imu2PmbFrameView_SetCrc(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 43, (uint16_t)value); }
+
+// Pmb2ImuFrame_t views
+static inline uint32_t Pmb2ImuFrameView_GetMotorRightRotation(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 0); }
+static inline void Pmb2ImuFrameView_SetMotorRightRotation(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 0, (uint32_t)value); }
+static inline uint32_t Pmb2ImuFrameView_GetMotorLeftRotation(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 4); }
+static inline void Pmb2ImuFrameView_SetMotorLeftRotation(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 4, (uint32_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetBatteryVoltage(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 8); }
+static inline void Pmb2ImuFrameView_SetBatteryVoltage(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 8, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetAdcCurrent(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 10); }
+static inline void Pmb2ImuFrameView_SetAdcCurrent(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 10, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetThumbleCurrent(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 12); }
+static inline void Pmb2ImuFrameView_SetThumbleCurrent(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 12, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetCrcImu2PmbErrorCount(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 14); }
+static inline void Pmb2ImuFrameView_SetCrcImu2PmbErrorCount(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 14, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetLoopMaxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 16); }
+static inline void Pmb2ImuFrameView_SetLoopMaxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 16, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetMissedTicks(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 18); }
+static inline void Pmb2ImuFrameView_SetMissedTicks(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 18, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetTaskMisses(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 20); }
+static inline void Pmb2ImuFrameView_SetTaskMisses(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 20, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetTraceId(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 22); }
+static inline void Pmb2ImuFrameView_SetTraceId(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 22, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetTraceRxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 24); }
+static inline void Pmb2ImuFrameView_SetTraceRxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 24, (uint16_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetTraceTxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 26); }
+static inline void Pmb2ImuFrameView_SetTraceTxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 26, (uint16_t)value); }
+static inline uint32_t Pmb2ImuFrameView_GetStopTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 28); }
+static inline void Pmb2ImuFrameView_SetStopTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 28, (uint32_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetStopReaction(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 32); }
+static inline void Pmb2ImuFrameView_SetStopReaction(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 32, (uint16_t)value); }
+static inline uint32_t Pmb2ImuFrameView_GetSyncTxTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 34); }
+static inline void Pmb2ImuFrameView_SetSyncTxTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 34, (uint32_t)value); }
+static inline uint32_t Pmb2ImuFrameView_GetSyncEchoTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 38); }
+static inline void Pmb2ImuFrameView_SetSyncEchoTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 38, (uint32_t)value); }
+static inline uint32_t Pmb2ImuFrameView_GetSyncEchoDelay(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 42); }
+static inline void Pmb2ImuFrameView_SetSyncEchoDelay(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 42, (uint32_t)value); }
+static inline uint32_t Pmb2ImuFrameView_GetSyncWeekTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 46); }
+static inline void Pmb2ImuFrameView_SetSyncWeekTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 46, (uint32_t)value); }
+static inline uint16_t Pmb2ImuFrameView_GetSyncErrorBound(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 50); }
+static inline void Pmb2ImuFrameView_SetSyncErrorBound(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 50, (uint16_t)value); }
+static inline uint8_t Pmb2ImuFrameView_GetLinkCommand(const uint8_t *buffer) { return (uint8_t)buffer[52]; }
+static inline void Pmb2ImuFrameView_SetLinkCommand(uint8_t *buffer, uint8_t value) { buffer[52] = (uint8_t)value; }
+static inline uint8_t Pmb2ImuFrameView_GetLinkRate(const uint8_t *buffer) { return (uint8_t)buffer[53]; }
+static inline void Pmb2ImuFrameView_SetLinkRate(uint8_t *buffer, uint8_t value) { buffer[53] = (uint8_t)value; }
+static inline uint8_t Pmb2ImuFrameView_GetLinkSequence(const uint8_t *buffer) { return (uint8_t)buffer[54]; }
+static inline void Pmb2ImuFrameView_SetLinkSequence(uint8_t *buffer, uint8_t value) { buffer[54] = (uint8_t)value; }
+static inline uint8_t Pmb2ImuFrameView_GetLinkErrors(const uint8_t *buffer) { return (uint8_t)buffer[55]; }
+static inline void Pmb2ImuFrameView_SetLinkErrors(uint8_t *buffer, uint8_t value) { buffer[55] = (uint8_t)value; }
+static inline uint16_t Pmb2ImuFrameView_GetCrc(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 56); }
+static inline void Pmb2ImuFrameView_SetCrc(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 56, (uint16_t)value); }
+
+// Imu2EspFrame_t views
+static inline uint32_t Imu2EspFrameView_GetMagnetBarStatus(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 0); }
+static inline void Imu2EspFrameView_SetMagnetBarStatus(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 0, (uint32_t)value); }
+static inline uint16_t Imu2EspFrameView_GetPmbConnection(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 4); }
+static inline void Imu2EspFrameView_SetPmbConnection(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 4, (uint16_t)value); }
+static inline int16_t Imu2EspFrameView_GetMotorRightSpeed(const uint8_t *buffer) { return (int16_t)Message_Get16(buffer + 6); }
+static inline void Imu2EspFrameView_SetMotorRightSpeed(uint8_t *buffer, int16_t value) { Message_Put16(buffer + 6, (uint16_t)value); }
+static inline int16_t Imu2EspFrameView_GetMotorLeftSpeed(const uint8_t *buffer) { return (int16_t)Message_Get16(buffer + 8); }
+static inline void Imu2EspFrameView_SetMotorLeftSpeed(uint8_t *buffer, int16_t value) { Message_Put16(buffer + 8, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetBatteryVoltage(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 10); }
+static inline void Imu2EspFrameView_SetBatteryVoltage(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 10, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetAdcCurrent(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 12); }
+static inline void Imu2EspFrameView_SetAdcCurrent(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 12, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetThumbleCurrent(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 14); }
+static inline void Imu2EspFrameView_SetThumbleCurrent(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 14, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetCrcImu2PmbErrorCount(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 16); }
+static inline void Imu2EspFrameView_SetCrcImu2PmbErrorCount(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 16, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetCrcPmb2ImuErrorCount(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 18); }
+static inline void Imu2EspFrameView_SetCrcPmb2ImuErrorCount(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 18, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetCrcEsp2ImuErrorCount(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 20); }
+static inline void Imu2EspFrameView_SetCrcEsp2ImuErrorCount(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 20, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetRouteUploadAck(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 22); }
+static inline void Imu2EspFrameView_SetRouteUploadAck(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 22, (uint16_t)value); }
+static inline uint8_t Imu2EspFrameView_GetRouteUploadState(const uint8_t *buffer) { return (uint8_t)buffer[24]; }
+static inline void Imu2EspFrameView_SetRouteUploadState(uint8_t *buffer, uint8_t value) { buffer[24] = (uint8_t)value; }
+static inline uint8_t Imu2EspFrameView_GetRouteCount(const uint8_t *buffer) { return (uint8_t)buffer[25]; }
+static inline void Imu2EspFrameView_SetRouteCount(uint8_t *buffer, uint8_t value) { buffer[25] = (uint8_t)value; }
+static inline uint16_t Imu2EspFrameView_GetCommandSequence(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 26); }
+static inline void Imu2EspFrameView_SetCommandSequence(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 26, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetTraceTraceId(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 28); }
+static inline void Imu2EspFrameView_SetTraceTraceId(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 28, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetTraceImuRxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 30); }
+static inline void Imu2EspFrameView_SetTraceImuRxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 30, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetTraceImuPmbTxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 32); }
+static inline void Imu2EspFrameView_SetTraceImuPmbTxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 32, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetTracePmbRxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 34); }
+static inline void Imu2EspFrameView_SetTracePmbRxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 34, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetTracePmbTxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 36); }
+static inline void Imu2EspFrameView_SetTracePmbTxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 36, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetTraceImuPmbRxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 38); }
+static inline void Imu2EspFrameView_SetTraceImuPmbRxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 38, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetTraceImuTxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 40); }
+static inline void Imu2EspFrameView_SetTraceImuTxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 40, (uint16_t)value); }
+static inline uint32_t Imu2EspFrameView_GetStopTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 42); }
+static inline void Imu2EspFrameView_SetStopTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 42, (uint32_t)value); }
+static inline uint16_t Imu2EspFrameView_GetStopReaction(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 46); }
+static inline void Imu2EspFrameView_SetStopReaction(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 46, (uint16_t)value); }
+static inline uint8_t Imu2EspFrameView_GetCollision(const uint8_t *buffer) { return (uint8_t)buffer[48]; }
+static inline void Imu2EspFrameView_SetCollision(uint8_t *buffer, uint8_t value) { buffer[48] = (uint8_t)value; }
+static inline uint16_t Imu2EspFrameView_GetPmbLoopMaxTime(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 49); }
+static inline void Imu2EspFrameView_SetPmbLoopMaxTime(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 49, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetPmbMissedTicks(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 51); }
+static inline void Imu2EspFrameView_SetPmbMissedTicks(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 51, (uint16_t)value); }
+static inline uint16_t Imu2EspFrameView_GetPmbTaskMisses(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 53); }
+static inline void Imu2EspFrameView_SetPmbTaskMisses(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 53, (uint16_t)value); }
+static inline uint32_t Imu2EspFrameView_GetSyncTxTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 55); }
+static inline void Imu2EspFrameView_SetSyncTxTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 55, (uint32_t)value); }
+static inline uint32_t Imu2EspFrameView_GetSyncEchoTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 59); }
+static inline void Imu2EspFrameView_SetSyncEchoTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 59, (uint32_t)value); }
+static inline uint32_t Imu2EspFrameView_GetSyncEchoDelay(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 63); }
+static inline void Imu2EspFrameView_SetSyncEchoDelay(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 63, (uint32_t)value); }
+static inline uint32_t Imu2EspFrameView_GetSyncWeekTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 67); }
+static inline void Imu2EspFrameView_SetSyncWeekTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 67, (uint32_t)value); }
+static inline uint16_t Imu2EspFrameView_GetSyncErrorBound(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 71); }
+static inline void Imu2EspFrameView_SetSyncErrorBound(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 71, (uint16_t)value); }
+static inline uint8_t Imu2EspFrameView_GetLinkCommand(const uint8_t *buffer) { return (uint8_t)buffer[73]; }
+static inline void Imu2EspFrameView_SetLinkCommand(uint8_t *buffer, uint8_t value) { buffer[73] = (uint8_t)value; }
+static inline uint8_t Imu2EspFrameView_GetLinkRate(const uint8_t *buffer) { return (uint8_t)buffer[74]; }
+static inline void Imu2EspFrameView_SetLinkRate(uint8_t *buffer, uint8_t value) { buffer[74] = (uint8_t)value; }
+static inline uint8_t Imu2EspFrameView_GetLinkSequence(const uint8_t *buffer) { return (uint8_t)buffer[75]; }
+static inline void Imu2EspFrameView_SetLinkSequence(uint8_t *buffer, uint8_t value) { buffer[75] = (uint8_t)value; }
+static inline uint8_t Imu2EspFrameView_GetLinkErrors(const uint8_t *buffer) { return (uint8_t)buffer[76]; }
+static inline void Imu2EspFrameView_SetLinkErrors(uint8_t *buffer, uint8_t value) { buffer[76] = (uint8_t)value; }
+static inline uint16_t Imu2EspFrameView_GetCrc(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 77); }
+static inline void Imu2EspFrameView_SetCrc(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 77, (uint16_t)value); }
+
+// Esp2ImuFrame_t views
+static inline uint8_t Esp2ImuFrameView_GetFrameType(const uint8_t *buffer) { return (uint8_t)buffer[0]; }
+static inline void Esp2ImuFrameView_SetFrameType(uint8_t *buffer, uint8_t value) { buffer[0] = (uint8_t)value; }
+static inline int8_t Esp2ImuFrameView_GetMoveX(const uint8_t *buffer) { return (int8_t)buffer[1]; }
+static inline void Esp2ImuFrameView_SetMoveX(uint8_t *buffer, int8_t value) { buffer[1] = (uint8_t)value; }
+static inline int8_t Esp2ImuFrameView_GetMoveY(const uint8_t *buffer) { return (int8_t)buffer[2]; }
+static inline void Esp2ImuFrameView_SetMoveY(uint8_t *buffer, int8_t value) { buffer[2] = (uint8_t)value; }
+static inline uint16_t Esp2ImuFrameView_GetAugerSpeed(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 3); }
+static inline void Esp2ImuFrameView_SetAugerSpeed(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 3, (uint16_t)value); }
+static inline uint8_t Esp2ImuFrameView_GetRootNumber(const uint8_t *buffer) { return (uint8_t)buffer[5]; }
+static inline void Esp2ImuFrameView_SetRootNumber(uint8_t *buffer, uint8_t value) { buffer[5] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetRootAction(const uint8_t *buffer) { return (uint8_t)buffer[6]; }
+static inline void Esp2ImuFrameView_SetRootAction(uint8_t *buffer, uint8_t value) { buffer[6] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetPower(const uint8_t *buffer) { return (uint8_t)buffer[7]; }
+static inline void Esp2ImuFrameView_SetPower(uint8_t *buffer, uint8_t value) { buffer[7] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetCharging(const uint8_t *buffer) { return (uint8_t)buffer[8]; }
+static inline void Esp2ImuFrameView_SetCharging(uint8_t *buffer, uint8_t value) { buffer[8] = (uint8_t)value; }
+static inline uint16_t Esp2ImuFrameView_GetCommandSequence(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 9); }
+static inline void Esp2ImuFrameView_SetCommandSequence(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 9, (uint16_t)value); }
+static inline uint8_t Esp2ImuFrameView_GetRouteBlockCommand(const uint8_t *buffer) { return (uint8_t)buffer[1]; }
+static inline void Esp2ImuFrameView_SetRouteBlockCommand(uint8_t *buffer, uint8_t value) { buffer[1] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetRouteBlockLength(const uint8_t *buffer) { return (uint8_t)buffer[2]; }
+static inline void Esp2ImuFrameView_SetRouteBlockLength(uint8_t *buffer, uint8_t value) { buffer[2] = (uint8_t)value; }
+static inline uint16_t Esp2ImuFrameView_GetRouteBlockSequence(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 3); }
+static inline void Esp2ImuFrameView_SetRouteBlockSequence(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 3, (uint16_t)value); }
+#define dESP2IMU_FRAME_ROUTE_BLOCK_DATA_OFFSET 5
+static inline uint16_t Esp2ImuFrameView_GetHelloMagic(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 1); }
+static inline void Esp2ImuFrameView_SetHelloMagic(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 1, (uint16_t)value); }
+static inline uint16_t Esp2ImuFrameView_GetHelloVersion(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 3); }
+static inline void Esp2ImuFrameView_SetHelloVersion(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 3, (uint16_t)value); }
+static inline uint16_t Esp2ImuFrameView_GetHelloLayoutHash(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 5); }
+static inline void Esp2ImuFrameView_SetHelloLayoutHash(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 5, (uint16_t)value); }
+static inline uint16_t Esp2ImuFrameView_GetHelloFeatures(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 7); }
+static inline void Esp2ImuFrameView_SetHelloFeatures(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 7, (uint16_t)value); }
+static inline uint16_t Esp2ImuFrameView_GetHelloCrc(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 9); }
+static inline void Esp2ImuFrameView_SetHelloCrc(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 9, (uint16_t)value); }
+static inline uint16_t Esp2ImuFrameView_GetStopSequence(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 1); }
+static inline void Esp2ImuFrameView_SetStopSequence(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 1, (uint16_t)value); }
+static inline uint32_t Esp2ImuFrameView_GetStopTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 3); }
+static inline void Esp2ImuFrameView_SetStopTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 3, (uint32_t)value); }
+static inline uint8_t Esp2ImuFrameView_GetFwTarget(const uint8_t *buffer) { return (uint8_t)buffer[1]; }
+static inline void Esp2ImuFrameView_SetFwTarget(uint8_t *buffer, uint8_t value) { buffer[1] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetFwRate(const uint8_t *buffer) { return (uint8_t)buffer[2]; }
+static inline void Esp2ImuFrameView_SetFwRate(uint8_t *buffer, uint8_t value) { buffer[2] = (uint8_t)value; }
+static inline uint32_t Esp2ImuFrameView_GetSyncTxTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 69); }
+static inline void Esp2ImuFrameView_SetSyncTxTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 69, (uint32_t)value); }
+static inline uint32_t Esp2ImuFrameView_GetSyncEchoTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 73); }
+static inline void Esp2ImuFrameView_SetSyncEchoTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 73, (uint32_t)value); }
+static inline uint32_t Esp2ImuFrameView_GetSyncEchoDelay(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 77); }
+static inline void Esp2ImuFrameView_SetSyncEchoDelay(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 77, (uint32_t)value); }
+static inline uint32_t Esp2ImuFrameView_GetSyncWeekTime(const uint8_t *buffer) { return (uint32_t)Message_Get32(buffer + 81); }
+static inline void Esp2ImuFrameView_SetSyncWeekTime(uint8_t *buffer, uint32_t value) { Message_Put32(buffer + 81, (uint32_t)value); }
+static inline uint16_t Esp2ImuFrameView_GetSyncErrorBound(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 85); }
+static inline void Esp2ImuFrameView_SetSyncErrorBound(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 85, (uint16_t)value); }
+static inline uint8_t Esp2ImuFrameView_GetLinkCommand(const uint8_t *buffer) { return (uint8_t)buffer[87]; }
+static inline void Esp2ImuFrameView_SetLinkCommand(uint8_t *buffer, uint8_t value) { buffer[87] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetLinkRate(const uint8_t *buffer) { return (uint8_t)buffer[88]; }
+static inline void Esp2ImuFrameView_SetLinkRate(uint8_t *buffer, uint8_t value) { buffer[88] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetLinkSequence(const uint8_t *buffer) { return (uint8_t)buffer[89]; }
+static inline void Esp2ImuFrameView_SetLinkSequence(uint8_t *buffer, uint8_t value) { buffer[89] = (uint8_t)value; }
+static inline uint8_t Esp2ImuFrameView_GetLinkErrors(const uint8_t *buffer) { return (uint8_t)buffer[90]; }
+static inline void Esp2ImuFrameView_SetLinkErrors(uint8_t *buffer, uint8_t value) { buffer[90] = (uint8_t)value; }
+static inline uint16_t Esp2ImuFrameView_GetCrc(const uint8_t *buffer) { return (uint16_t)Message_Get16(buffer + 91); }
+static inline void Esp2ImuFrameView_SetCrc(uint8_t *buffer, uint16_t value) { Message_Put16(buffer + 91, (uint16_t)value); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESSAGECODEC_H */
@@ -3,16 +3,152 @@
  *
  *  Created on: May 20, 2025
  *      Author: piomod
+ *
+ * Generated by Tools/MessageGen/message_gen.py from MessageSchema.json, do not edit.
+ * Change the schema and run: python3 Tools/MessageGen/message_gen.py generate
  */
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifndef MESSAGETYPES_H
 #define MESSAGETYPES_H
 
-#define PROTOCOL_VERSION 001
+#define PROTOCOL_VERSION 13
+#define dPROTOCOL_LAYOUT_HASH 0xF94D /* CRC16 of all frame layouts */
+
+/* ProtocolHello_t.features */
+#define dPROTOCOL_FEATURE_TRACE          (1u << 0) /* LatencyTrace_t in Imu2EspFrame_t, traceId on PMB link */
+#define dPROTOCOL_FEATURE_SYNC           (1u << 1) /* SyncStamp_t in every frame */
+#define dPROTOCOL_FEATURE_ROUTE_UPLOAD   (1u << 2) /* dESP2IMU_FRAME_ROUTE_BLOCK */
+#define dPROTOCOL_FEATURE_LINK_SPEED     (1u << 3) /* LinkControl_t baud rate negotiation */
+#define dPROTOCOL_FEATURE_STOP           (1u << 4) /* dESP2IMU_FRAME_STOP, emergency stop fields on PMB link */
+#define dPROTOCOL_FEATURE_COLLISION      (1u << 5) /* collision and stall events in Imu2EspFrame_t */
+#define dPROTOCOL_FEATURE_FW_UPDATE      (1u << 6) /* dESP2IMU_FRAME_FW_UPDATE, fwTarget on PMB link, not offered: IMU and PMB loaders are not in the tree */
+#define dPROTOCOL_FEATURE_PMB_PROFILE    (1u << 7) /* PMB main loop and task timing in Imu2EspFrame_t */
+#define dPROTOCOL_FEATURES (dPROTOCOL_FEATURE_TRACE | dPROTOCOL_FEATURE_SYNC | dPROTOCOL_FEATURE_ROUTE_UPLOAD | dPROTOCOL_FEATURE_LINK_SPEED | dPROTOCOL_FEATURE_STOP | dPROTOCOL_FEATURE_COLLISION | dPROTOCOL_FEATURE_PMB_PROFILE)
+
+/* Esp2ImuFrame_t.frameType */
+#define dESP2IMU_FRAME_CONTROL      0
+#define dESP2IMU_FRAME_ROUTE_BLOCK  1
+#define dESP2IMU_FRAME_HELLO        2    /* protocol handshake, IMU answers with ProtocolHello_t */
+#define dESP2IMU_FRAME_STOP         3    /* emergency stop, sent in place of control frames until a control frame releases it */
+#define dESP2IMU_FRAME_FW_UPDATE    4    /* IMU starts its loader, the link carries Melkens_Lib/FwUpdate packets from then on */
+
+/* Imu2PmbFrame_t.stop */
+#define dSTOP_NONE                  0
+#define dSTOP_REQUESTED             1    /* emergency stop from ESP, latched by IMU until released */
+
+/* Esp2ImuFrame_t.fwTarget, Imu2PmbFrame_t.fwTarget, see Melkens_Lib/FwUpdate */
+#define dFW_TARGET_NONE             0
+#define dFW_TARGET_IMU              1
+#define dFW_TARGET_PMB              2    /* IMU loader bridges the stream to the PMB loader */
+
+/* Pmb2ImuFrame_t.stopReaction, Imu2EspFrame_t.stopReaction */
+#define dSTOP_REACTION_UNKNOWN      UINT16_MAX /* no stop yet or PMB not synchronised */
+
+/* Imu2EspFrame_t.collision */
+#define dCOLLISION_NONE             0
+#define dCOLLISION_IMPACT           1    /* horizontal acceleration spike */
+#define dCOLLISION_WHEEL_STALL      2    /* wheel current high while encoders do not move */
+#define dCOLLISION_AUGER_OVERLOAD   3    /* auger current high */
+
+/* RouteBlock_t.command */
+#define dROUTE_BLOCK_BEGIN          1    /* data: route store header, sequence 0 */
+#define dROUTE_BLOCK_DATA           2    /* data: payload bytes from sequence * dROUTE_BLOCK_DATA_SIZE */
+#define dROUTE_BLOCK_COMMIT         3    /* check payload CRC and switch to the new route store */
+#define dROUTE_BLOCK_ABORT          4
+
+#define dROUTE_BLOCK_DATA_SIZE      64
+
+/* Imu2EspFrame_t.routeUploadState */
+#define dROUTE_UPLOAD_IDLE          0
+#define dROUTE_UPLOAD_RECEIVING     1
+#define dROUTE_UPLOAD_DONE          2
+#define dROUTE_UPLOAD_ERROR_BUSY    3    /* route is driven, route store can not be changed */
+#define dROUTE_UPLOAD_ERROR_HEADER  4
+#define dROUTE_UPLOAD_ERROR_FLASH   5
+#define dROUTE_UPLOAD_ERROR_CRC     6
+
+/* SyncStamp_t */
+#define dSYNC_NO_ECHO               UINT32_MAX /* echoDelay: no frame received from peer yet */
+#define dSYNC_UNKNOWN_WEEK_TIME     UINT32_MAX
+#define dSYNC_NOT_SYNCHRONISED      UINT16_MAX /* errorBound */
+
+/* LinkControl_t.command, see Melkens_Lib/LinkSpeed */
+#define dLINK_COMMAND_NONE          0    /* rate: current rate of sender */
+#define dLINK_COMMAND_PROPOSE       1    /* master: rate is proposed */
+#define dLINK_COMMAND_ACCEPT        2    /* slave: proposal with sequence accepted */
+#define dLINK_COMMAND_REJECT        3    /* slave: proposal refused, rate: highest slave rate */
+#define dLINK_COMMAND_SWITCH        4    /* master: both ends go to rate after this frame */
+
+/* LinkControl_t.rate */
+#define dLINK_RATE_115200           0    /* base rate, every link starts here */
+#define dLINK_RATE_460800           1
+#define dLINK_RATE_921600           2
+#define dLINK_RATE_2000000          3
+#define dLINK_RATE_NUM_OF           4
+
+/* ProtocolHello_t.magic, "MH" */
+#define dPROTOCOL_HELLO_MAGIC       0x484D
+
+/* Imu2PCFrame_t.delimiter, "\r\n" on the line */
+#define dIMU2PC_DELIMITER           0x0A0D
+
+/* All boards are little endian, frames go on the line as their struct memory */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "Message frames need a little endian target"
+#endif
 
 #pragma pack(push,1)
+//---------------------------------------------------------
+// Time synchronisation stamp carried by every frame, see Melkens_Lib/TimeSync.
+// ESP is master of ESP <-> IMU link, IMU is master of IMU <-> PMB link.
+typedef struct {
+  uint32_t txTime; //[us] end of this frame; master: shared (ESP) timebase, slave: local clock
+  uint32_t echoTime; //txTime of last frame received from peer
+  uint32_t echoDelay; //[us] from reception of that frame to txTime, dSYNC_NO_ECHO
+  uint32_t weekTime; //[s] master local wall clock since Sunday 00:00, dSYNC_UNKNOWN_WEEK_TIME
+  uint16_t errorBound; //[us] master txTime error to ESP timebase, dSYNC_NOT_SYNCHRONISED
+} SyncStamp_t;
+
+//---------------------------------------------------------
+// Latency trace of one control command, carried back to ESP in Imu2EspFrame_t.
+// Times are [us] of the local clock of each board, 16 bit wrap around,
+// so only differences of times taken on the same board are meaningful.
+typedef struct {
+  uint16_t traceId; //commandSequence of traced control command
+  uint16_t imuRxTime; //IMU: control frame applied
+  uint16_t imuPmbTxTime; //IMU: first Imu2PmbFrame with traceId sent
+  uint16_t pmbRxTime; //PMB: Imu2PmbFrame with traceId taken by main loop
+  uint16_t pmbTxTime; //PMB: motors set, Pmb2ImuFrame echoing traceId sent
+  uint16_t imuPmbRxTime; //IMU: that Pmb2ImuFrame received
+  uint16_t imuTxTime; //IMU: first Imu2EspFrame carrying this trace sent
+} LatencyTrace_t;
+
+//---------------------------------------------------------
+// Baud rate negotiation carried by every frame, see Melkens_Lib/LinkSpeed.
+// Master of a link is the TimeSync master.
+typedef struct {
+  uint8_t command; //dLINK_COMMAND_...
+  uint8_t rate; //dLINK_RATE_...
+  uint8_t sequence; //of the proposal sent or answered
+  uint8_t errors; //frames with CRC error received by sender, wraps around
+} LinkControl_t;
+
+//---------------------------------------------------------
+// Protocol handshake. ESP sends it as dESP2IMU_FRAME_HELLO, IMU answers with
+// this struct alone on the line, ESP finds it by magic and CRC whatever the
+// IMU frame layout is. Layout must never change.
+typedef struct {
+  uint16_t magic; //dPROTOCOL_HELLO_MAGIC
+  uint16_t version; //PROTOCOL_VERSION
+  uint16_t layoutHash; //dPROTOCOL_LAYOUT_HASH, frames are compatible only when equal
+  uint16_t features; //dPROTOCOL_FEATURE_... of the sender
+  ////////
+  uint16_t crc;
+} ProtocolHello_t;
+
 //---------------------------------------------------------
 // IMU ---> PMB
 typedef struct {
@@ -22,10 +158,18 @@ typedef struct {
   uint16_t motorLiftSpeed;
   uint16_t motorBelt1Speed;
   uint16_t motorBelt2Speed;
+  uint16_t traceId; //commandSequence the speeds come from
+  uint8_t stop; //dSTOP_..., speeds are ignored while not dSTOP_NONE
+  uint32_t stopTime; //[us] shared time the latched stop was requested on ESP
+  uint8_t fwTarget; //dFW_TARGET_PMB: PMB starts its loader
+  uint8_t fwRate; //dLINK_RATE_... the loaders run at
+  SyncStamp_t sync;
+  LinkControl_t link;
   ////////
   uint16_t crc;
 } Imu2PmbFrame_t;
 
+//---------------------------------------------------------
 // IMU <--- PMB
 typedef struct {
   uint32_t motorRightRotation;
@@ -34,43 +178,92 @@ typedef struct {
   uint16_t adcCurrent;
   uint16_t thumbleCurrent;
   uint16_t crcImu2PmbErrorCount;
+  uint16_t loopMaxTime; //[us] worst case PMB main loop iteration
+  uint16_t missedTicks; //1ms slots lost by PMB main loop
+  uint16_t taskMisses; //late and skipped releases and budget overruns of PMB tasks, saturates
+  uint16_t traceId; //echo of last valid Imu2PmbFrame_t.traceId
+  uint16_t traceRxTime; //[us] PMB time that frame was taken
+  uint16_t traceTxTime; //[us] PMB time this frame was sent
+  uint32_t stopTime; //Imu2PmbFrame_t.stopTime of last stop carried out
+  uint16_t stopReaction; //[us] that stop, request on ESP to stop commands queued for all inverters, dSTOP_REACTION_UNKNOWN
+  SyncStamp_t sync;
+  LinkControl_t link;
   ////////
   uint16_t crc;
 } Pmb2ImuFrame_t;
 
 //---------------------------------------------------------
 // IMU ---> ESP
-
 typedef struct {
   uint32_t magnetBarStatus;
   uint16_t pmbConnection;
-  uint16_t motorRightSpeed;
-  uint16_t motorLeftSpeed;
+  int16_t motorRightSpeed; //Imu2PmbFrame_t.motorRightSpeed
+  int16_t motorLeftSpeed; //Imu2PmbFrame_t.motorLeftSpeed
   uint16_t batteryVoltage;
   uint16_t adcCurrent;
   uint16_t thumbleCurrent;
   uint16_t crcImu2PmbErrorCount;
   uint16_t crcPmb2ImuErrorCount;
   uint16_t crcEsp2ImuErrorCount;
+  uint16_t routeUploadAck; //next expected route block sequence
+  uint8_t routeUploadState; //dROUTE_UPLOAD_...
+  uint8_t routeCount; //routes in active route store
+  uint16_t commandSequence; //last control command applied by IMU
+  LatencyTrace_t trace; //latest completed trace, repeated until next one
+  uint32_t stopTime; //Pmb2ImuFrame_t.stopTime
+  uint16_t stopReaction; //Pmb2ImuFrame_t.stopReaction
+  uint8_t collision; //dCOLLISION_... route is stopped for, until resumed
+  uint16_t pmbLoopMaxTime; //Pmb2ImuFrame_t.loopMaxTime
+  uint16_t pmbMissedTicks; //Pmb2ImuFrame_t.missedTicks
+  uint16_t pmbTaskMisses; //Pmb2ImuFrame_t.taskMisses
+  SyncStamp_t sync;
+  LinkControl_t link;
   ////////
   uint16_t crc;
 } Imu2EspFrame_t;
 
+//---------------------------------------------------------
+// Route upload block, carried in Esp2ImuFrame_t
+typedef struct {
+  uint8_t command; //dROUTE_BLOCK_...
+  uint8_t length; //valid bytes in data
+  uint16_t sequence;
+  uint8_t data[dROUTE_BLOCK_DATA_SIZE];
+} RouteBlock_t;
+
+//---------------------------------------------------------
 // IMU <--- ESP
+// All frames have the same size, IMU receives them with fixed length DMA
 typedef struct {
-  int8_t moveX;
-  int8_t moveY;
-  uint16_t augerSpeed; //0-1500
-  uint8_t rootNumber; //a=0, b=1, c=2, ...
-  uint8_t rootAction; //stop=0, play=1, pause=2
-  uint8_t power; //off=0, on=1
-  uint8_t charging; //off=0, on=1
+  uint8_t frameType; //dESP2IMU_FRAME_...
+  union { //by frameType
+    struct { //dESP2IMU_FRAME_CONTROL
+      int8_t moveX;
+      int8_t moveY;
+      uint16_t augerSpeed; //0-1500
+      uint8_t rootNumber; //a=0, b=1, c=2, ... also routes from route store
+      uint8_t rootAction; //stop=0, play=1, pause=2
+      uint8_t power; //off=0, on=1
+      uint8_t charging; //off=0, on=1
+      uint16_t commandSequence; //incremented by ESP on every control change, repeated in keep-alive frames
+    };
+    RouteBlock_t routeBlock; //dESP2IMU_FRAME_ROUTE_BLOCK
+    ProtocolHello_t hello; //dESP2IMU_FRAME_HELLO
+    struct { //dESP2IMU_FRAME_STOP
+      uint16_t stopSequence; //commandSequence of the stop, ESP increments it like for control changes
+      uint32_t stopTime; //[us] ESP micros() the stop was requested, shared timebase
+    };
+    struct { //dESP2IMU_FRAME_FW_UPDATE
+      uint8_t fwTarget; //dFW_TARGET_...
+      uint8_t fwRate; //dLINK_RATE_... the loaders run at, current rate of the link
+    };
+  };
+  SyncStamp_t sync;
+  LinkControl_t link;
   ////////
   uint16_t crc;
 } Esp2ImuFrame_t;
 
-//---------------------------------------------------------
-
 //---------------------------------------------------------
 // IMU ---> PC Debug communication
 typedef struct {
@@ -82,10 +275,171 @@ typedef struct {
   uint16_t Ypos2;
   uint16_t angle;
   uint16_t motorBelt2Speed;
-  ////////
-  uint16_t crc;
+  uint16_t delimiter; //dIMU2PC_DELIMITER, read by terminal as text lines
 } Imu2PCFrame_t;
-//---------------------------------------------------------
+
 #pragma pack(pop)
 
+// Compile time layout check on every target, C89 compatible for XC16
+#define MESSAGE_ASSERT(Condition, Name) typedef char MessageAssert_##Name[(Condition) ? 1 : -1]
+
+MESSAGE_ASSERT(sizeof(SyncStamp_t) == 18, SyncStamp_size);
+MESSAGE_ASSERT(offsetof(SyncStamp_t, txTime) == 0, SyncStamp_txTime);
+MESSAGE_ASSERT(offsetof(SyncStamp_t, echoTime) == 4, SyncStamp_echoTime);
+MESSAGE_ASSERT(offsetof(SyncStamp_t, echoDelay) == 8, SyncStamp_echoDelay);
+MESSAGE_ASSERT(offsetof(SyncStamp_t, weekTime) == 12, SyncStamp_weekTime);
+MESSAGE_ASSERT(offsetof(SyncStamp_t, errorBound) == 16, SyncStamp_errorBound);
+MESSAGE_ASSERT(sizeof(LatencyTrace_t) == 14, LatencyTrace_size);
+MESSAGE_ASSERT(offsetof(LatencyTrace_t, traceId) == 0, LatencyTrace_traceId);
+MESSAGE_ASSERT(offsetof(LatencyTrace_t, imuRxTime) == 2, LatencyTrace_imuRxTime);
+MESSAGE_ASSERT(offsetof(LatencyTrace_t, imuPmbTxTime) == 4, LatencyTrace_imuPmbTxTime);
+MESSAGE_ASSERT(offsetof(LatencyTrace_t, pmbRxTime) == 6, LatencyTrace_pmbRxTime);
+MESSAGE_ASSERT(offsetof(LatencyTrace_t, pmbTxTime) == 8, LatencyTrace_pmbTxTime);
+MESSAGE_ASSERT(offsetof(LatencyTrace_t, imuPmbRxTime) == 10, LatencyTrace_imuPmbRxTime);
+MESSAGE_ASSERT(offsetof(LatencyTrace_t, imuTxTime) == 12, LatencyTrace_imuTxTime);
+MESSAGE_ASSERT(sizeof(LinkControl_t) == 4, LinkControl_size);
+MESSAGE_ASSERT(offsetof(LinkControl_t, command) == 0, LinkControl_command);
+MESSAGE_ASSERT(offsetof(LinkControl_t, rate) == 1, LinkControl_rate);
+MESSAGE_ASSERT(offsetof(LinkControl_t, sequence) == 2, LinkControl_sequence);
+MESSAGE_ASSERT(offsetof(LinkControl_t, errors) == 3, LinkControl_errors);
+MESSAGE_ASSERT(sizeof(ProtocolHello_t) == 10, ProtocolHello_size);
+MESSAGE_ASSERT(offsetof(ProtocolHello_t, magic) == 0, ProtocolHello_magic);
+MESSAGE_ASSERT(offsetof(ProtocolHello_t, version) == 2, ProtocolHello_version);
+MESSAGE_ASSERT(offsetof(ProtocolHello_t, layoutHash) == 4, ProtocolHello_layoutHash);
+MESSAGE_ASSERT(offsetof(ProtocolHello_t, features) == 6, ProtocolHello_features);
+MESSAGE_ASSERT(offsetof(ProtocolHello_t, crc) == 8, ProtocolHello_crc);
+MESSAGE_ASSERT(sizeof(Imu2PmbFrame_t) == 45, Imu2PmbFrame_size);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, motorRightSpeed) == 0, Imu2PmbFrame_motorRightSpeed);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, motorLeftSpeed) == 2, Imu2PmbFrame_motorLeftSpeed);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, motorThumbleSpeed) == 4, Imu2PmbFrame_motorThumbleSpeed);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, motorLiftSpeed) == 6, Imu2PmbFrame_motorLiftSpeed);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, motorBelt1Speed) == 8, Imu2PmbFrame_motorBelt1Speed);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, motorBelt2Speed) == 10, Imu2PmbFrame_motorBelt2Speed);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, traceId) == 12, Imu2PmbFrame_traceId);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, stop) == 14, Imu2PmbFrame_stop);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, stopTime) == 15, Imu2PmbFrame_stopTime);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, fwTarget) == 19, Imu2PmbFrame_fwTarget);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, fwRate) == 20, Imu2PmbFrame_fwRate);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, sync.txTime) == 21, Imu2PmbFrame_sync_txTime);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, sync.echoTime) == 25, Imu2PmbFrame_sync_echoTime);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, sync.echoDelay) == 29, Imu2PmbFrame_sync_echoDelay);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, sync.weekTime) == 33, Imu2PmbFrame_sync_weekTime);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, sync.errorBound) == 37, Imu2PmbFrame_sync_errorBound);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, link.command) == 39, Imu2PmbFrame_link_command);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, link.rate) == 40, Imu2PmbFrame_link_rate);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, link.sequence) == 41, Imu2PmbFrame_link_sequence);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, link.errors) == 42, Imu2PmbFrame_link_errors);
+MESSAGE_ASSERT(offsetof(Imu2PmbFrame_t, crc) == 43, Imu2PmbFrame_crc);
+MESSAGE_ASSERT(sizeof(Pmb2ImuFrame_t) == 58, Pmb2ImuFrame_size);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, motorRightRotation) == 0, Pmb2ImuFrame_motorRightRotation);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, motorLeftRotation) == 4, Pmb2ImuFrame_motorLeftRotation);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, batteryVoltage) == 8, Pmb2ImuFrame_batteryVoltage);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, adcCurrent) == 10, Pmb2ImuFrame_adcCurrent);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, thumbleCurrent) == 12, Pmb2ImuFrame_thumbleCurrent);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, crcImu2PmbErrorCount) == 14, Pmb2ImuFrame_crcImu2PmbErrorCount);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, loopMaxTime) == 16, Pmb2ImuFrame_loopMaxTime);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, missedTicks) == 18, Pmb2ImuFrame_missedTicks);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, taskMisses) == 20, Pmb2ImuFrame_taskMisses);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, traceId) == 22, Pmb2ImuFrame_traceId);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, traceRxTime) == 24, Pmb2ImuFrame_traceRxTime);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, traceTxTime) == 26, Pmb2ImuFrame_traceTxTime);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, stopTime) == 28, Pmb2ImuFrame_stopTime);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, stopReaction) == 32, Pmb2ImuFrame_stopReaction);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, sync.txTime) == 34, Pmb2ImuFrame_sync_txTime);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, sync.echoTime) == 38, Pmb2ImuFrame_sync_echoTime);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, sync.echoDelay) == 42, Pmb2ImuFrame_sync_echoDelay);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, sync.weekTime) == 46, Pmb2ImuFrame_sync_weekTime);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, sync.errorBound) == 50, Pmb2ImuFrame_sync_errorBound);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, link.command) == 52, Pmb2ImuFrame_link_command);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, link.rate) == 53, Pmb2ImuFrame_link_rate);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, link.sequence) == 54, Pmb2ImuFrame_link_sequence);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, link.errors) == 55, Pmb2ImuFrame_link_errors);
+MESSAGE_ASSERT(offsetof(Pmb2ImuFrame_t, crc) == 56, Pmb2ImuFrame_crc);
+MESSAGE_ASSERT(sizeof(Imu2EspFrame_t) == 79, Imu2EspFrame_size);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, magnetBarStatus) == 0, Imu2EspFrame_magnetBarStatus);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, pmbConnection) == 4, Imu2EspFrame_pmbConnection);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, motorRightSpeed) == 6, Imu2EspFrame_motorRightSpeed);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, motorLeftSpeed) == 8, Imu2EspFrame_motorLeftSpeed);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, batteryVoltage) == 10, Imu2EspFrame_batteryVoltage);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, adcCurrent) == 12, Imu2EspFrame_adcCurrent);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, thumbleCurrent) == 14, Imu2EspFrame_thumbleCurrent);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, crcImu2PmbErrorCount) == 16, Imu2EspFrame_crcImu2PmbErrorCount);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, crcPmb2ImuErrorCount) == 18, Imu2EspFrame_crcPmb2ImuErrorCount);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, crcEsp2ImuErrorCount) == 20, Imu2EspFrame_crcEsp2ImuErrorCount);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, routeUploadAck) == 22, Imu2EspFrame_routeUploadAck);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, routeUploadState) == 24, Imu2EspFrame_routeUploadState);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, routeCount) == 25, Imu2EspFrame_routeCount);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, commandSequence) == 26, Imu2EspFrame_commandSequence);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, trace.traceId) == 28, Imu2EspFrame_trace_traceId);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, trace.imuRxTime) == 30, Imu2EspFrame_trace_imuRxTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, trace.imuPmbTxTime) == 32, Imu2EspFrame_trace_imuPmbTxTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, trace.pmbRxTime) == 34, Imu2EspFrame_trace_pmbRxTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, trace.pmbTxTime) == 36, Imu2EspFrame_trace_pmbTxTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, trace.imuPmbRxTime) == 38, Imu2EspFrame_trace_imuPmbRxTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, trace.imuTxTime) == 40, Imu2EspFrame_trace_imuTxTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, stopTime) == 42, Imu2EspFrame_stopTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, stopReaction) == 46, Imu2EspFrame_stopReaction);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, collision) == 48, Imu2EspFrame_collision);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, pmbLoopMaxTime) == 49, Imu2EspFrame_pmbLoopMaxTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, pmbMissedTicks) == 51, Imu2EspFrame_pmbMissedTicks);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, pmbTaskMisses) == 53, Imu2EspFrame_pmbTaskMisses);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, sync.txTime) == 55, Imu2EspFrame_sync_txTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, sync.echoTime) == 59, Imu2EspFrame_sync_echoTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, sync.echoDelay) == 63, Imu2EspFrame_sync_echoDelay);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, sync.weekTime) == 67, Imu2EspFrame_sync_weekTime);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, sync.errorBound) == 71, Imu2EspFrame_sync_errorBound);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, link.command) == 73, Imu2EspFrame_link_command);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, link.rate) == 74, Imu2EspFrame_link_rate);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, link.sequence) == 75, Imu2EspFrame_link_sequence);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, link.errors) == 76, Imu2EspFrame_link_errors);
+MESSAGE_ASSERT(offsetof(Imu2EspFrame_t, crc) == 77, Imu2EspFrame_crc);
+MESSAGE_ASSERT(sizeof(RouteBlock_t) == 68, RouteBlock_size);
+MESSAGE_ASSERT(offsetof(RouteBlock_t, command) == 0, RouteBlock_command);
+MESSAGE_ASSERT(offsetof(RouteBlock_t, length) == 1, RouteBlock_length);
+MESSAGE_ASSERT(offsetof(RouteBlock_t, sequence) == 2, RouteBlock_sequence);
+MESSAGE_ASSERT(offsetof(RouteBlock_t, data) == 4, RouteBlock_data);
+MESSAGE_ASSERT(sizeof(Esp2ImuFrame_t) == 93, Esp2ImuFrame_size);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, frameType) == 0, Esp2ImuFrame_frameType);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, moveX) == 1, Esp2ImuFrame_moveX);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, moveY) == 2, Esp2ImuFrame_moveY);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, augerSpeed) == 3, Esp2ImuFrame_augerSpeed);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, rootNumber) == 5, Esp2ImuFrame_rootNumber);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, rootAction) == 6, Esp2ImuFrame_rootAction);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, power) == 7, Esp2ImuFrame_power);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, charging) == 8, Esp2ImuFrame_charging);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, commandSequence) == 9, Esp2ImuFrame_commandSequence);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, routeBlock.command) == 1, Esp2ImuFrame_routeBlock_command);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, routeBlock.length) == 2, Esp2ImuFrame_routeBlock_length);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, routeBlock.sequence) == 3, Esp2ImuFrame_routeBlock_sequence);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, routeBlock.data) == 5, Esp2ImuFrame_routeBlock_data);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, hello.magic) == 1, Esp2ImuFrame_hello_magic);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, hello.version) == 3, Esp2ImuFrame_hello_version);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, hello.layoutHash) == 5, Esp2ImuFrame_hello_layoutHash);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, hello.features) == 7, Esp2ImuFrame_hello_features);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, hello.crc) == 9, Esp2ImuFrame_hello_crc);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, stopSequence) == 1, Esp2ImuFrame_stopSequence);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, stopTime) == 3, Esp2ImuFrame_stopTime);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, fwTarget) == 1, Esp2ImuFrame_fwTarget);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, fwRate) == 2, Esp2ImuFrame_fwRate);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, sync.txTime) == 69, Esp2ImuFrame_sync_txTime);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, sync.echoTime) == 73, Esp2ImuFrame_sync_echoTime);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, sync.echoDelay) == 77, Esp2ImuFrame_sync_echoDelay);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, sync.weekTime) == 81, Esp2ImuFrame_sync_weekTime);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, sync.errorBound) == 85, Esp2ImuFrame_sync_errorBound);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, link.command) == 87, Esp2ImuFrame_link_command);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, link.rate) == 88, Esp2ImuFrame_link_rate);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, link.sequence) == 89, Esp2ImuFrame_link_sequence);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, link.errors) == 90, Esp2ImuFrame_link_errors);
+MESSAGE_ASSERT(offsetof(Esp2ImuFrame_t, crc) == 91, Esp2ImuFrame_crc);
+MESSAGE_ASSERT(sizeof(Imu2PCFrame_t) == 18, Imu2PCFrame_size);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, motorRightSpeed) == 0, Imu2PCFrame_motorRightSpeed);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, motorLeftSpeed) == 2, Imu2PCFrame_motorLeftSpeed);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, Xpos1) == 4, Imu2PCFrame_Xpos1);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, Ypos1) == 6, Imu2PCFrame_Ypos1);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, Xpos2) == 8, Imu2PCFrame_Xpos2);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, Ypos2) == 10, Imu2PCFrame_Ypos2);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, angle) == 12, Imu2PCFrame_angle);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, motorBelt2Speed) == 14, Imu2PCFrame_motorBelt2Speed);
+MESSAGE_ASSERT(offsetof(Imu2PCFrame_t, delimiter) == 16, Imu2PCFrame_delimiter);
+
 #endif /* MESSAGETYPES_H */
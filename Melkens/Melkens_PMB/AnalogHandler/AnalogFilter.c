@@ -0,0 +1,44 @@
+#include "AnalogFilter.h"
+
+void AnalogFilter_Init(AnalogFilter *Filter)
+{
+    Filter->Accumulator = 0;
+    Filter->SampleCount = 0;
+    Filter->Initialized = false;
+    Filter->IIRState = 0;
+    Filter->Output = 0;
+}
+
+bool AnalogFilter_AddSample(AnalogFilter *Filter, const AnalogFilterConfig *Config, uint16_t Sample)
+{
+    int32_t Decimated;
+    uint8_t Decimation = (Config->Decimation != 0) ? Config->Decimation : 1;
+
+    Filter->Accumulator += Sample;
+    Filter->SampleCount++;
+    if (Filter->SampleCount < Decimation){
+        return false;
+    }
+
+    /* Average of decimation window with extra fraction bits kept */
+    Decimated = (int32_t)((Filter->Accumulator << dANALOG_FILTER_FRACTION_BITS) / Decimation);
+    Filter->Accumulator = 0;
+    Filter->SampleCount = 0;
+
+    if (!Filter->Initialized){
+        /* Start from first value instead of ramping up from zero */
+        Filter->IIRState = Decimated << Config->IIRShift;
+        Filter->Initialized = true;
+    }
+    else{
+        /* State is scaled by 2^IIRShift so the shift drops no bits of the
+         * difference, y += (x - y) >> IIRShift stalled up to 2^IIRShift - 1
+         * below a rising input */
+        Filter->IIRState += Decimated - (Filter->IIRState >> Config->IIRShift);
+    }
+
+    /* Round back to ADC counts */
+    Filter->Output = (uint16_t)((Filter->IIRState + (1 << (dANALOG_FILTER_FRACTION_BITS + Config->IIRShift - 1)))
+                              >> (dANALOG_FILTER_FRACTION_BITS + Config->IIRShift));
+    return true;
+}
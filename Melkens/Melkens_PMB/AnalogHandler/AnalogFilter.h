@@ -0,0 +1,43 @@
+/* 
+ * File:   AnalogFilter.h
+ *
+ * Fixed point decimation + IIR filter used by AnalogHandler. Pure C without
+ * register access so it can be compiled and checked on host.
+ */
+
+#ifndef ANALOGFILTER_H
+#define	ANALOGFILTER_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define dANALOG_FILTER_FRACTION_BITS  4   /* IIR state keeps 4 extra bits of resolution */
+
+typedef struct AnalogFilterConfig_t
+{
+    uint8_t Decimation;     /* Samples summed per output (boxcar / 1st order CIC), 1..16 */
+    uint8_t IIRShift;       /* y += (x - y) >> IIRShift, 0 disables IIR */
+}AnalogFilterConfig;
+
+typedef struct AnalogFilter_t
+{
+    uint32_t Accumulator;
+    uint8_t SampleCount;
+    bool Initialized;
+    int32_t IIRState;       /* Q(dANALOG_FILTER_FRACTION_BITS + IIRShift) */
+    uint16_t Output;
+}AnalogFilter;
+
+void AnalogFilter_Init(AnalogFilter *Filter);
+/* Returns true when decimator produced new output value */
+bool AnalogFilter_AddSample(AnalogFilter *Filter, const AnalogFilterConfig *Config, uint16_t Sample);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* ANALOGFILTER_H */
@@ -1,67 +1,74 @@
 #include "AnalogHandler.h"
+#include "AnalogFilter.h"
 #include "../mcc_generated_files/adc1.h"
 
-#define STATE_INIT     0
-#define STATE_MEASURE  1
-#define STATE_IDLE     2
-
-#define ENABLE 1
-#define DISABLE 0
-
-/* How many loops before average enabled */
-#define AVERAGE_FILTER_COUNT 10
-#define INIT_DEBOUNCE_COUNT  10
+/*
+ * All channels are converted continuously: every SYSTICK (1ms) results of the
+ * previous scan are collected from the TMR1 interrupt and the next scan is
+ * triggered, so the main loop never waits for the ADC. Each channel is
+ * decimated and IIR filtered in fixed point, see FilterConfig.
+ *
+ * 1kHz is the only supported scan rate, FilterConfig time constants assume
+ * it. TMR1 is also the millisecond tick and the microsecond base of
+ * TimeManager and Profiler (PR1 + 1 counts per ms), so it cannot be sped up
+ * for the ADC alone. The ADC keeps one result per channel, a faster scan
+ * would need its own timer trigger and the ADC interrupt, neither is
+ * configured in mcc_generated_files.
+ */
 
 bool SafetySwitchState;
 
 typedef struct AnalogMeasurement_t
 {
-    ADC1_CHANNEL Channel;
-    uint16_t CurrentRoughValue;
-    uint16_t PreviousRoughValue;
     uint16_t UpperThreshold;
     uint16_t LowerThreshold;
     
-    bool Initialized;
     bool UpperThresholdExceeded;
     bool LowerThresholdExceeded;
     
-    uint16_t FilteredValue;
-    uint32_t FilterAccumulator;
+    AnalogFilter Filter;
 }AnalogMeasurement;
 
+static const AnalogFilterConfig FilterConfig[ADC1_ChannelNumOf] =
+{
+    /* Decimation   IIRShift */
+    { 4,            3 },    /* DC_STATUS_HS */
+    { 1,            0 },    /* StatSw2 */
+    { 1,            0 },    /* StatSw1 */
+    { 4,            3 },    /* DC_STATUS_LS */
+    { 4,            2 },    /* IM_SENSE   250Hz, ~16ms time constant */
+    { 1,            0 },    /* StatSw3 */
+    { 10,           4 },    /* CHAR_AN */
+    { 10,           5 },    /* BAT_STATUS 100Hz, ~320ms time constant */
+    { 1,            0 },    /* StatSw4 */
+};
+
 AnalogMeasurement Measurements[ADC1_ChannelNumOf];
-uint8_t State;
-uint8_t InitDebounce;
 
-void AnalogHandler_CalculateAverageAll( void );
-void AnalogHandler_AddToFilterAll( void );
-void AnalogHandler_AddToFiter(uint16_t Measurement, ADC1_CHANNEL Name);
-void AnalogHandler_DoMeasureBlocking( void );
-void AnalogHandler_UpdateAndCalculateAverageAll( void );
-void AnalogHandler_UpdateAndCalculateAverage(ADC1_CHANNEL Name);
+/* Written only from interrupt, Sequence is odd while update is in progress */
+static volatile AnalogSnapshot Snapshot;
+static volatile uint16_t SnapshotSequence;
+static volatile bool IsSamplingEnabled = false;
+static bool IsConversionStarted;
 
 
 void AnalogHandler_Init(void)
 {
-    State = STATE_INIT;
-    InitDebounce = AVERAGE_FILTER_COUNT;
-    
-    Measurements[DC_STATUS_HS].UpperThresholdExceeded =  false;
-    Measurements[StatSw2].UpperThresholdExceeded =       false;
-    Measurements[StatSw1].UpperThresholdExceeded =       false;
-    Measurements[DC_STATUS_LS].UpperThresholdExceeded =  false;
-    Measurements[IM_SENSE].UpperThresholdExceeded =      false;
-    Measurements[StatSw3].UpperThresholdExceeded =       false;
-    Measurements[StatSw4].UpperThresholdExceeded =       false;
-    
-    Measurements[DC_STATUS_HS].LowerThresholdExceeded =  false;
-    Measurements[StatSw2].LowerThresholdExceeded =       false;
-    Measurements[StatSw1].LowerThresholdExceeded =       false;
-    Measurements[DC_STATUS_LS].LowerThresholdExceeded =  false;
-    Measurements[IM_SENSE].LowerThresholdExceeded =      false;
-    Measurements[StatSw3].LowerThresholdExceeded =       false;
-    Measurements[StatSw4].LowerThresholdExceeded =       false;
+    ADC1_CHANNEL Idx;
+
+    IsSamplingEnabled = false;
+    IsConversionStarted = false;
+    SnapshotSequence = 0;
+
+    for(Idx = DC_STATUS_HS; Idx < ADC1_ChannelNumOf; Idx++ )
+    {
+        Measurements[Idx].UpperThresholdExceeded = false;
+        Measurements[Idx].LowerThresholdExceeded = false;
+        AnalogFilter_Init(&Measurements[Idx].Filter);
+        Snapshot.Filtered[Idx] = 0;
+        Snapshot.Rough[Idx] = 0;
+    }
+    Snapshot.SampleCount = 0;
     
     AnalogHandler_SetChannelUpperThreshold(DC_STATUS_HS, 2500);
     AnalogHandler_SetChannelUpperThreshold(StatSw2,      2500);
@@ -78,119 +85,77 @@ void AnalogHandler_Init(void)
     AnalogHandler_SetChannelLowerThreshold(StatSw3,      1000);
     AnalogHandler_SetChannelLowerThreshold(StatSw3,      1000);
 
-    
-    
+    IsSamplingEnabled = true;
 }
 
-void AnalogHandler_Perform100ms(void)
+/* Called from TMR1 interrupt every 1ms */
+void AnalogHandler_SYSTICK_Handler(void)
 {
-    switch(State)
+    ADC1_CHANNEL Idx;
+    uint16_t Sample;
+
+    if( !IsSamplingEnabled )
+    {
+        return;
+    }
+
+    if( IsConversionStarted )
     {
-        case STATE_INIT:
-            
-            
-            AnalogHandler_DoMeasureBlocking();
-            AnalogHandler_AddToFilterAll();
-            if( InitDebounce > 10 )
+        SnapshotSequence++;
+        for(Idx = DC_STATUS_HS; Idx < ADC1_ChannelNumOf; Idx++ )
+        {
+            if( !ADC1_IsConversionComplete(Idx) )
             {
-                InitDebounce++;
-                
+                /* Should not happen, scan takes few us. Keep previous value */
+                continue;
             }
-            
-            else
+            Sample = ADC1_ConversionResultGet(Idx);
+            Snapshot.Rough[Idx] = Sample;
+
+            if( AnalogFilter_AddSample(&Measurements[Idx].Filter, &FilterConfig[Idx], Sample) )
             {
-                /*  Done! Calculate average*/
-                AnalogHandler_CalculateAverageAll();
-                State = STATE_MEASURE;
+                Snapshot.Filtered[Idx] = Measurements[Idx].Filter.Output;
             }
-            break;
-            
-        case STATE_MEASURE:
-            AnalogHandler_DoMeasureBlocking();
-            AnalogHandler_UpdateAndCalculateAverageAll(); 
-            
-         
-            //AnalogHandler_CalculateThresholds(dMEASUREMENT_ROUGH);
-            
-            
-            break;
-            
-        case STATE_IDLE:
-            break;
-        default:
-            break;
-    }
-}
-
-void AnalogHandler_AddToFilterAll( void )
-{
-    ADC1_CHANNEL Idx;
-
-    for(Idx = DC_STATUS_HS; Idx < ADC1_ChannelNumOf; Idx++ )
-    {
-        Measurements[Idx].FilterAccumulator += Measurements[Idx].CurrentRoughValue;
+        }
+        Snapshot.SampleCount++;
+        SnapshotSequence++;
     }
-}
 
-void AnalogHandler_AddToFiter(uint16_t Measurement, ADC1_CHANNEL Name)
-{
-    Measurements[Name].FilterAccumulator += Measurement;
-}
-
-void AnalogHandler_DoMeasureBlocking( void )
-{
-    ADC1_CHANNEL Idx;
-    
+    /* Start next scan, results are collected on next tick */
     ADC1_SoftwareTriggerEnable();
-    /* TODO: pawelton Check where this function should be called */
     ADC1_SoftwareTriggerDisable();
-    /* Go through all channels and gather results */
-    for(Idx = DC_STATUS_HS; Idx < ADC1_ChannelNumOf; Idx++ )
-    {
-        while(!ADC1_IsConversionComplete(Idx));
-                
-        Measurements[Idx].CurrentRoughValue = ADC1_ConversionResultGet(Idx);
-    }
+    IsConversionStarted = true;
 }
 
-void AnalogHandler_CalculateAverageAll( void )
+void AnalogHandler_GetSnapshot(AnalogSnapshot *pSnapshot)
 {
-    for(ADC1_CHANNEL CurrentName = 0; CurrentName<ADC1_ChannelNumOf; CurrentName++)
-    {
-        Measurements[CurrentName].FilteredValue = 
-                (uint16_t)(Measurements[CurrentName].FilterAccumulator / INIT_DEBOUNCE_COUNT);
-    }
-}
-
-void AnalogHandler_UpdateAndCalculateAverageAll( void )
-{   
+    uint16_t SequenceBefore;
+    uint16_t SequenceAfter;
     ADC1_CHANNEL Idx;
 
-    for(Idx = DC_STATUS_HS; Idx < ADC1_ChannelNumOf; Idx++ )
+    /* Lock free read, repeat if sampling interrupt updated data in between */
+    do
     {
-        Measurements[Idx].FilterAccumulator -= Measurements[Idx].FilteredValue;
-        Measurements[Idx].FilterAccumulator += Measurements[Idx].CurrentRoughValue;
-        Measurements[Idx].FilteredValue = 
-        (uint16_t)(Measurements[Idx].FilterAccumulator / AVERAGE_FILTER_COUNT);        
-    }
-}
-
-void AnalogHandler_UpdateAndCalculateAverage(ADC1_CHANNEL Name)
-{   
-    Measurements[Name].FilterAccumulator -= Measurements[Name].FilteredValue;
-    Measurements[Name].FilterAccumulator += Measurements[Name].CurrentRoughValue;
-    Measurements[Name].FilteredValue = 
-            (uint16_t)(Measurements[Name].FilterAccumulator / AVERAGE_FILTER_COUNT);
+        SequenceBefore = SnapshotSequence;
+        for(Idx = DC_STATUS_HS; Idx < ADC1_ChannelNumOf; Idx++ )
+        {
+            pSnapshot->Filtered[Idx] = Snapshot.Filtered[Idx];
+            pSnapshot->Rough[Idx] = Snapshot.Rough[Idx];
+        }
+        pSnapshot->SampleCount = Snapshot.SampleCount;
+        SequenceAfter = SnapshotSequence;
+    }while( (SequenceBefore != SequenceAfter) || (SequenceBefore & 1u) );
 }
 
 uint16_t AnalogHandler_GetADCFiltered(ADC1_CHANNEL Name)
 {
-    return Measurements[Name].FilteredValue;
+    /* Single 16-bit read is atomic */
+    return Snapshot.Filtered[Name];
 }
 
 uint16_t AnalogHandler_GetADCRough(ADC1_CHANNEL Name)
 {
-    return Measurements[Name].CurrentRoughValue;
+    return Snapshot.Rough[Name];
 }
 
 //void AnalogHandler_CalculateThresholds(uint8_t MeasurementType)
@@ -238,7 +203,7 @@ bool AnalogHandler_IsUpperThresholdExceeded(ADC1_CHANNEL Name, uint8_t Measureme
     
     if( MeasurementType == dMEASUREMENT_FILTERED )
     {
-        if( pMeasurement->FilteredValue > pMeasurement->UpperThreshold )
+        if( Snapshot.Filtered[Name] > pMeasurement->UpperThreshold )
         {
             RetFlag = true;
         }
@@ -246,7 +211,7 @@ bool AnalogHandler_IsUpperThresholdExceeded(ADC1_CHANNEL Name, uint8_t Measureme
     }
     else if( MeasurementType == dMEASUREMENT_ROUGH )
     {
-        if( pMeasurement->CurrentRoughValue > pMeasurement->UpperThreshold )
+        if( Snapshot.Rough[Name] > pMeasurement->UpperThreshold )
         {
             RetFlag = true;
         }
@@ -264,7 +229,7 @@ bool AnalogHandler_IsLowerThresholdExceeded(ADC1_CHANNEL Name, uint8_t Measureme
     
     if( MeasurementType == dMEASUREMENT_FILTERED )
     {
-        if( pMeasurement->FilteredValue < pMeasurement->LowerThreshold )
+        if( Snapshot.Filtered[Name] < pMeasurement->LowerThreshold )
         {
             RetFlag = true;
         }
@@ -272,7 +237,7 @@ bool AnalogHandler_IsLowerThresholdExceeded(ADC1_CHANNEL Name, uint8_t Measureme
     }
     else if( MeasurementType == dMEASUREMENT_ROUGH )
     {
-        if( pMeasurement->CurrentRoughValue < pMeasurement->LowerThreshold )
+        if( Snapshot.Rough[Name] < pMeasurement->LowerThreshold )
         {
             RetFlag = true;
         }
@@ -19,6 +19,14 @@ extern "C" {
 #define dMEASUREMENT_FILTERED      1    
      
 extern bool SafetySwitchState;
+
+/* Consistent copy of all channels taken at one sampling tick */
+typedef struct AnalogSnapshot_t
+{
+    uint16_t Filtered[ADC1_ChannelNumOf];
+    uint16_t Rough[ADC1_ChannelNumOf];
+    uint16_t SampleCount;
+}AnalogSnapshot;
     
 uint16_t AnalogHandler_GetADCFiltered(ADC1_CHANNEL Name);
 uint16_t AnalogHandler_GetADCRough(ADC1_CHANNEL Name);
@@ -28,7 +36,8 @@ bool AnalogHandler_IsUpperThresholdExceeded(ADC1_CHANNEL Name, uint8_t Measureme
 bool AnalogHandler_IsLowerThresholdExceeded(ADC1_CHANNEL Name, uint8_t MeasurementType);
 bool AnalogHandler_IsSafetyActivated();
 void AnalogHandler_Init(void);
-void AnalogHandler_Perform100ms(void);
+void AnalogHandler_SYSTICK_Handler(void);
+void AnalogHandler_GetSnapshot(AnalogSnapshot *Snapshot);
 
 #ifdef	__cplusplus
 }
@@ -0,0 +1,129 @@
+/*
+ * EmergencyStop.c
+ *
+ * A stop is carried out in the call that receives it: CAN TXQ abort and
+ * stop commands for all inverters. When the abort of a frame already on the
+ * bus is still in progress the remaining commands go out from the next
+ * EmergencyStop_Perform1ms. The reaction reported to ESP is measured in the
+ * shared timebase from the request on ESP to the last stop command queued.
+ */
+#include "EmergencyStop.h"
+#include "../pmb_MotorManager.h"
+#include "../IMUHandler/IMUHandler.h"
+
+#define dESTOP_ALL_MOTORS   ((uint8_t)((1u << Motor_NumOf) - 1u))
+
+static EmergencyStopSource Source;
+static uint8_t PendingMotors;   /* Stop command not queued yet, bit per MotorName */
+static bool IsTxAborted;        /* CAN TXQ emptied for current stop */
+static bool IsMeasuring;        /* Stop from ESP, reaction taken when all commands are queued */
+static uint32_t RequestTime;    /* [us] shared, Imu2PmbFrame_t.stopTime of current stop */
+static uint32_t StopTime;
+static uint16_t Reaction;
+
+static void EmergencyStop_Measure(uint32_t Now)
+{
+    uint32_t Shared;
+    int32_t Elapsed;
+
+    IsMeasuring = false;
+    StopTime = RequestTime;
+    Reaction = dSTOP_REACTION_UNKNOWN;
+    if (IMUHandler_ToSharedTime(Now, &Shared)) {
+        /* Within sync error bound a stop may seem to react before request */
+        Elapsed = (int32_t)(Shared - RequestTime);
+        if (Elapsed < 0) {
+            Elapsed = 0;
+        }
+        Reaction = (Elapsed < (int32_t)dSTOP_REACTION_UNKNOWN) ? (uint16_t)Elapsed : (uint16_t)(dSTOP_REACTION_UNKNOWN - 1u);
+    }
+}
+
+static void EmergencyStop_Send(uint32_t Now)
+{
+    uint8_t Mot;
+
+    if (!IsTxAborted) {
+        IsTxAborted = MotorManager_AbortCanTx();
+        if (!IsTxAborted) {
+            return;
+        }
+    }
+    for (Mot = 0; Mot < Motor_NumOf; Mot++) {
+        if ((PendingMotors & (1u << Mot)) && MotorManager_SendStop((MotorName)Mot)) {
+            PendingMotors &= (uint8_t)~(1u << Mot);
+        }
+    }
+    if ((PendingMotors == 0u) && IsMeasuring) {
+        EmergencyStop_Measure(Now);
+    }
+}
+
+static void EmergencyStop_Start(EmergencyStopSource NewSource, uint32_t Now)
+{
+    Source = NewSource;
+    PendingMotors = dESTOP_ALL_MOTORS;
+    IsTxAborted = false;
+    EmergencyStop_Send(Now);
+}
+
+void EmergencyStop_Init(void)
+{
+    Source = EmergencyStop_None;
+    PendingMotors = 0;
+    IsTxAborted = false;
+    IsMeasuring = false;
+    StopTime = 0;
+    Reaction = dSTOP_REACTION_UNKNOWN;
+}
+
+bool EmergencyStop_Frame(const Imu2PmbFrame_t *Frame, uint32_t Now)
+{
+    if (Frame->stop == dSTOP_NONE) {
+        Source = EmergencyStop_None;
+        PendingMotors = 0;
+        IsMeasuring = false;
+        return false;
+    }
+
+    /* Repeated in every frame while latched by IMU, carried out once */
+    if ((Source != EmergencyStop_Esp) || (Frame->stopTime != RequestTime)) {
+        RequestTime = Frame->stopTime;
+        IsMeasuring = true;
+        EmergencyStop_Start(EmergencyStop_Esp, Now);
+    }
+    return true;
+}
+
+void EmergencyStop_Trigger(EmergencyStopSource NewSource, uint32_t Now)
+{
+    /* Stop from ESP stays the reason, commands are sent again anyway */
+    EmergencyStop_Start((Source == EmergencyStop_None) ? NewSource : Source, Now);
+}
+
+void EmergencyStop_Perform1ms(uint32_t Now)
+{
+    if (PendingMotors != 0u) {
+        EmergencyStop_Send(Now);
+    }
+}
+
+bool EmergencyStop_IsActive(void)
+{
+    return Source != EmergencyStop_None;
+}
+
+EmergencyStopSource EmergencyStop_GetSource(void)
+{
+    return Source;
+}
+
+uint32_t EmergencyStop_GetStopTime(void)
+{
+    return StopTime;
+}
+
+uint16_t EmergencyStop_GetReaction(void)
+{
+    return Reaction;
+}
@@ -0,0 +1,54 @@
+/*
+ * File:   EmergencyStop.h
+ *
+ * Emergency stop of all inverters. The stop comes from ESP in every
+ * Imu2PmbFrame_t while IMU has it latched, or from PMB itself when the IMU
+ * link is lost. Frames waiting in CAN TXQ (speeds, inquiries) are dropped
+ * first, so no stale speed command can follow, then the stop command is
+ * queued for every inverter. Speeds from IMU are ignored until a valid frame
+ * with stop dSTOP_NONE arrives. While active MotorManager sends no speed or
+ * enable frame, whoever asks for it (route manager, keyboard, display,
+ * remote, speed loop), and a running route is paused.
+ *
+ * Hardware access goes through MotorManager_AbortCanTx/MotorManager_SendStop
+ * and IMUHandler_ToSharedTime only, Tools/EmergencyStop builds this file on
+ * the host against a model of the CAN TXQ.
+ */
+
+#ifndef EMERGENCYSTOP_H
+#define	EMERGENCYSTOP_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Melkens_Lib/Types/MessageTypes.h"
+
+#define dESTOP_REACTION_BUDGET  10000u  /* [us] ESP request to stop commands queued for all inverters */
+
+typedef enum EmergencyStopSource_t{
+    EmergencyStop_None = 0,
+    EmergencyStop_Esp,          /* Imu2PmbFrame_t.stop */
+    EmergencyStop_LinkLost      /* no valid Imu2PmbFrame_t in time or frame with CRC error */
+}EmergencyStopSource;
+
+void EmergencyStop_Init(void);
+/* Every valid Imu2PmbFrame_t, Now is TimeManager_GetMicros.
+ * True while stopped, speeds of the frame must be ignored. */
+bool EmergencyStop_Frame(const Imu2PmbFrame_t *Frame, uint32_t Now);
+void EmergencyStop_Trigger(EmergencyStopSource Source, uint32_t Now);
+/* Queues stop commands that did not fit while CAN TXQ was being aborted */
+void EmergencyStop_Perform1ms(uint32_t Now);
+bool EmergencyStop_IsActive(void);
+EmergencyStopSource EmergencyStop_GetSource(void);
+/* Last stop from ESP carried out, for Pmb2ImuFrame_t */
+uint32_t EmergencyStop_GetStopTime(void);
+uint16_t EmergencyStop_GetReaction(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* EMERGENCYSTOP_H */
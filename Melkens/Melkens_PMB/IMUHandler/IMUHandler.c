@@ -7,14 +7,21 @@
 #include "../pmb_Functions.h"
 #include "../DmaController/DmaController.h"
 #include "../mcc_generated_files/uart3.h"
+#include "../mcc_generated_files/clock.h"
 #include "../mcc_generated_files/pin_manager.h"
 #include "../pmb_System.h"
 #include "../AnalogHandler/AnalogHandler.h"
 #include "../DiagnosticsHandler.h"
 #include "../pmb_MotorManager.h"
-#include "../Melkens_Lib/Types/MessageTypes.h"
-#include "../Melkens_Lib/CRC16/CRC16.h"
+#include "../Melkens_Lib/Types/MessageCodec.h"
+#include "../Melkens_Lib/TimeSync/TimeSync.h"
+#include "../Melkens_Lib/LinkSpeed/LinkSpeed.h"
+#include "../Melkens_Lib/FwUpdate/FwUpdate.h"
+#include "../EmergencyStop/EmergencyStop.h"
 #include "../RoutesDataTypes.h"
+#include "../Profiler/Profiler.h"
+#include "../TimeManager/TimeManager.h"
+#include "../pmb_Scheduler.h"
 
 #define ENCODER_ONE_WHEEL_LEN 2
 #define ENCODER_LEFT_BEGIN 4
@@ -22,10 +29,24 @@
 
 #define PI 3.14159265359
 
+#define IMU_UART_CLOCK CLOCK_PeripheralFrequencyGet() /* UART3 BCLKSEL FOSC/2 */
+#define SECONDS_IN_DAY 86400u
+#define BOOT_WORD_ADDRESS 0x1000   /* first RAM word, the loader keeps its boot word there too */
+
 //static char GetEncoderDataMessage[8] = "GET_ENCO";
 
 Pmb2ImuFrame_t Pmb2ImuFrame;
 Imu2PmbFrame_t Imu2PmbFrame;
+static uint32_t RxTime;         /* [us] TimeManager_GetMicros of last Imu2PmbFrame */
+static TimeSync ImuSync;        /* IMU is time master, shared time and week time */
+static uint32_t SchedulerMinute = dSYNC_UNKNOWN_WEEK_TIME;
+static LinkSpeed ImuLink;       /* IMU is master of baud rate negotiation */
+static bool IsBaudPending;      /* New baud rate waits for answer being sent */
+static uint16_t RxCount;        /* DMACNT1 at last 1ms tick, partial frame detection */
+static uint16_t TaskMisses;     /* TaskScheduler_GetMissCount of the main loop */
+/* Melkens_Lib/FwUpdate boot word, kept over resets */
+static uint32_t BootWord __attribute__((persistent, address(BOOT_WORD_ADDRESS)));
+static bool IsBootConfirmed;
 
 bool IsInitialized = false;
 bool IsDataSend = false;
@@ -123,6 +144,33 @@ void IMUHandler_Process( void )
 
 }
 
+/* Next byte from UART3 goes to start of Imu2PmbFrame */
+static void IMUHandler_RestartReceive(void)
+{
+    DMACH1bits.CHEN = 0;
+    DMADST1 = (uint16_t)&Imu2PmbFrame;
+    DMACNT1 = sizeof(Imu2PmbFrame_t);
+    DMA_ResetTransferStatus(DMA_CHANNEL_1);
+    DMACH1bits.CHEN = 1;
+    RxCount = sizeof(Imu2PmbFrame_t);
+}
+
+/* Fractional baud rate generator, exact for 2M, -1.4% for 921600 and 460800.
+ * False while the answer frame is still being sent. */
+static bool IMUHandler_SetBaudRate(uint32_t Baud)
+{
+    if (DMACH0bits.CHEN || !U3STAbits.TRMT) {
+        return false;
+    }
+    U3MODEbits.UARTEN = 0;
+    U3MODEHbits.BCLKMOD = 1;
+    U3BRG = (uint16_t)((IMU_UART_CLOCK + Baud / 2u) / Baud);
+    U3BRGH = 0;
+    U3MODEbits.UARTEN = 1;
+    IMUHandler_RestartReceive();
+    return true;
+}
+
 bool IMUHandler_IsInitialized( void )
 {
 	return IsInitialized;
@@ -130,6 +178,7 @@ bool IMUHandler_IsInitialized( void )
 
 void IMUHandler_Init( void )
 {
+    TimeSync_Init(&ImuSync);
     /* Set transmit buffer address as source for DMA0 (sending data from) */
     DmaController_SetSourceAddress((uint16_t)&Pmb2ImuFrame,DMA_CHANNEL_0);
     /* Set UART3 TX address as destination for DMA0 (sending data to) */
@@ -150,6 +199,10 @@ void IMUHandler_Init( void )
     U3MODEbits.URXEN = 1;
     U3MODEbits.UTXEN = 1;
 
+    LinkSpeed_Init(&ImuLink, false, dLINK_RATE_2000000, TimeManager_GetSystemTick());
+    EmergencyStop_Init();
+    RxCount = sizeof(Imu2PmbFrame_t);
+
      TimerSetCounter(&IMU_ReceiveTimeout, 100);
     //TimerSetCounter(&IMU_ReceiveTimeout, dIMU_NO_COMM_TIMEOUT);    // DMA_ChannelEnable(DMA_CHANNEL_0);
 
@@ -166,6 +219,10 @@ void IMUHandler_SetThumbleCurrent(int16_t Current ){
     CurrentData.ThumbleCurrent = Current;
 }
 
+void IMUHandler_SetTaskMisses(uint16_t Misses){
+    TaskMisses = Misses;
+}
+
 void IMUHandler_ReadEncoderValues(uint16_t RightEncoder, uint16_t LeftEncoder ){
     Encoder.Left = LeftEncoder;
     Encoder.Right = RightEncoder;
@@ -303,11 +360,27 @@ void IMUHandler_Perform100ms( void )
 //    MotorManager_StartMotorKeepDirection(Motor_Right);
 }
 
+/* Called for valid Imu2PmbFrame, scheduler clock follows ESP wall clock */
+static void IMUHandler_UpdateTime(void)
+{
+    uint32_t WeekTime;
+
+    TimeSync_Receive(&ImuSync, &Imu2PmbFrame.sync, RxTime, true);
+
+    WeekTime = TimeSync_GetWeekTime(&ImuSync, RxTime);
+    if ((WeekTime != dSYNC_UNKNOWN_WEEK_TIME) && ((WeekTime / 60u) != SchedulerMinute)) {
+        SchedulerMinute = WeekTime / 60u;
+        Scheduler_SetCurrentTime((uint8_t)(WeekTime / SECONDS_IN_DAY), (uint8_t)((WeekTime % SECONDS_IN_DAY) / 3600u),
+                                 (uint8_t)((WeekTime % 3600u) / 60u));
+    }
+}
+
 void IMUHandler_Perform1ms( void )
 {
     /* Get values from encoder and send them through UART if request received */    
     if(DMA_IsTransferComplete(DMA_CHANNEL_1))
     {
+        RxTime = TimeManager_GetMicros();
         /* Received data from IMU */
         //IMUHandler_MessageReceivedHandler();
         IMUHandler_ProcessReceivedData();
@@ -336,6 +409,32 @@ void IMUHandler_Perform1ms( void )
         U3MODEbits.UARTEN = 1;
         DMA_ChannelEnable(DMA_CHANNEL_1);
     }
+
+    /* Frames come back to back, a partial frame not growing for a tick is
+     * noise or sent at another baud rate and would shift all following ones */
+    if ((DMACNT1 != sizeof(Imu2PmbFrame_t)) && (DMACNT1 == RxCount) && !DMA_IsTransferComplete(DMA_CHANNEL_1)) {
+        IMUHandler_RestartReceive();
+    }
+    RxCount = DMACNT1;
+
+    EmergencyStop_Perform1ms(TimeManager_GetMicros());
+
+    if (LinkSpeed_Perform(&ImuLink, TimeManager_GetSystemTick())) {
+        IsBaudPending = true;
+    }
+    if (IsBaudPending) {
+        IsBaudPending = !IMUHandler_SetBaudRate(LinkSpeed_GetBaud(&ImuLink));
+    }
+}
+
+bool IMUHandler_ToSharedTime(uint32_t Local, uint32_t *Shared)
+{
+    return TimeSync_ToShared(&ImuSync, Local, Shared);
+}
+
+uint32_t IMUHandler_GetTimeErrorBound(void)
+{
+    return TimeSync_GetErrorBound(&ImuSync, TimeManager_GetMicros());
 }
 
 int16_t IMUHandler_Get1msRotationTics(bool Wheel)
@@ -357,6 +456,8 @@ extern uint16_t BateryVoltage;
 
 void IMUHandler_MessageReceivedHandler( void )
 {
+    uint32_t TxTime;
+
     /* Check if received message is request for encoder values */
     //if(!strcmp(ReceiveBufferEncoder, "GET_ENCO"))
     if(1)
@@ -369,9 +470,19 @@ void IMUHandler_MessageReceivedHandler( void )
         Pmb2ImuFrame.batteryVoltage = BateryVoltage;
         Pmb2ImuFrame.adcCurrent = AnalogHandler_GetADCFiltered(IM_SENSE);
         Pmb2ImuFrame.thumbleCurrent = CurrentData.ThumbleCurrent;
+        Pmb2ImuFrame.loopMaxTime = Profiler_GetLoopMaxTime();
+        Pmb2ImuFrame.missedTicks = TimeManager_GetMissedTicks();
+        Pmb2ImuFrame.taskMisses = TaskMisses;
+        Pmb2ImuFrame.traceRxTime = (uint16_t)RxTime;
+        Pmb2ImuFrame.traceTxTime = (uint16_t)TimeManager_GetMicros();
+        Pmb2ImuFrame.stopTime = EmergencyStop_GetStopTime();
+        Pmb2ImuFrame.stopReaction = EmergencyStop_GetReaction();
         // todo: [PM] update values to transmit
 
-        Pmb2ImuFrame.crc = CRC16((uint8_t*)&Pmb2ImuFrame, sizeof(Pmb2ImuFrame_t) - sizeof(Pmb2ImuFrame.crc));
+        LinkSpeed_Stamp(&ImuLink, &Pmb2ImuFrame.link, TimeManager_GetSystemTick());
+        TxTime = TimeManager_GetMicros() + dTIMESYNC_FRAME_TIME(sizeof(Pmb2ImuFrame_t), LinkSpeed_GetBaud(&ImuLink));
+        TimeSync_Stamp(&ImuSync, &Pmb2ImuFrame.sync, TxTime, TxTime, dSYNC_UNKNOWN_WEEK_TIME, dSYNC_NOT_SYNCHRONISED);
+        Pmb2ImuFrame_Seal(&Pmb2ImuFrame);
                 
         _LATC12 = 0;
 
@@ -385,64 +496,87 @@ void IMUHandler_MessageReceivedHandler( void )
 
 }
 
+/* Valid Imu2PmbFrame, stopped or not */
+static void IMUHandler_AcceptFrame(void){
+    Pmb2ImuFrame.traceId = Imu2PmbFrame.traceId;
+    IMUHandler_UpdateTime();
+    LinkSpeed_Receive(&ImuLink, &Imu2PmbFrame.link, TimeManager_GetSystemTick());
+}
+
 void IMUHandler_ProcessReceivedData(void){
     
-    if(Imu2PmbFrame.crc == CRC16((uint8_t*)&Imu2PmbFrame, sizeof(Imu2PmbFrame_t) - sizeof(Imu2PmbFrame.crc))){
-        
-//        MotorManager_SetDirection(Motor_Right, R_REV);
-//        MotorManager_SetDirection(Motor_Left, L_REV);
-        
-        if(Imu2PmbFrame.motorRightSpeed>0)
-        {
-            MotorManager_SetDirection(Motor_Right, R_FOR);
-            
-            MotorManager_SetSpeed(Motor_Right, Imu2PmbFrame.motorRightSpeed);
-            MotorManager_StartMotorKeepDirection(Motor_Right);
-            
+    if(Imu2PmbFrame_IsValid(&Imu2PmbFrame)){
+        /* Application is up and talks to the IMU, the loader does not take it back */
+        if(!IsBootConfirmed){
+            IsBootConfirmed = true;
+            BootWord = FwBoot_Confirm();
         }
-        else
-        {
-            MotorManager_SetDirection(Motor_Right, R_REV);
-            
-            MotorManager_SetSpeed(Motor_Right, abs(Imu2PmbFrame.motorRightSpeed));
-            MotorManager_StartMotorKeepDirection(Motor_Right);
-            
+        /* fwTarget is ignored, the PMB loader is not in the tree */
+        /* Stop goes to the inverters before anything else, speeds wait for release */
+        if(EmergencyStop_Frame(&Imu2PmbFrame, TimeManager_GetMicros())){
+            IMUHandler_AcceptFrame();
         }
-        
-        if(Imu2PmbFrame.motorLeftSpeed>0)
-        {
-            MotorManager_SetDirection(Motor_Left, L_FOR);
-            
-            MotorManager_SetSpeed(Motor_Left, Imu2PmbFrame.motorLeftSpeed);
-            MotorManager_StartMotorKeepDirection(Motor_Left);
-        }
-        else
-        {
-            MotorManager_SetDirection(Motor_Left, L_REV);
-            
-            MotorManager_SetSpeed(Motor_Left, abs(Imu2PmbFrame.motorLeftSpeed));
-            MotorManager_StartMotorKeepDirection(Motor_Left);
+        else{
+
+    //        MotorManager_SetDirection(Motor_Right, R_REV);
+    //        MotorManager_SetDirection(Motor_Left, L_REV);
+
+            if(Imu2PmbFrame.motorRightSpeed>0)
+            {
+                MotorManager_SetDirection(Motor_Right, R_FOR);
+
+                MotorManager_SetSpeed(Motor_Right, Imu2PmbFrame.motorRightSpeed);
+                MotorManager_StartMotorKeepDirection(Motor_Right);
+
+            }
+            else
+            {
+                MotorManager_SetDirection(Motor_Right, R_REV);
+
+                MotorManager_SetSpeed(Motor_Right, abs(Imu2PmbFrame.motorRightSpeed));
+                MotorManager_StartMotorKeepDirection(Motor_Right);
+
+            }
+
+            if(Imu2PmbFrame.motorLeftSpeed>0)
+            {
+                MotorManager_SetDirection(Motor_Left, L_FOR);
+
+                MotorManager_SetSpeed(Motor_Left, Imu2PmbFrame.motorLeftSpeed);
+                MotorManager_StartMotorKeepDirection(Motor_Left);
+            }
+            else
+            {
+                MotorManager_SetDirection(Motor_Left, L_REV);
+
+                MotorManager_SetSpeed(Motor_Left, abs(Imu2PmbFrame.motorLeftSpeed));
+                MotorManager_StartMotorKeepDirection(Motor_Left);
+            }
+
+    //        MotorManager_SetSpeed(Motor_Right, Imu2PmbFrame.motorRightSpeed);
+    //        MotorManager_StartMotorKeepDirection(Motor_Right);
+    //        MotorManager_SetSpeed(Motor_Left, Imu2PmbFrame.motorLeftSpeed);
+    //        MotorManager_StartMotorKeepDirection(Motor_Left);
+            MotorManager_StartMotor(Motor_Thumble, dRIGHT);
+            MotorManager_SetSpeed(Motor_Thumble, Imu2PmbFrame.motorThumbleSpeed);
+            MotorManager_StartMotorKeepDirection(Motor_Thumble);
+
+            MotorManager_SetSpeed(Motor_Lift, Imu2PmbFrame.motorLiftSpeed);
+            MotorManager_SetSpeed(Motor_Belt1, Imu2PmbFrame.motorBelt1Speed);
+            MotorManager_SetSpeed(Motor_Belt2, Imu2PmbFrame.motorBelt2Speed);
+
+            MotorManager_TriggerEnableMessageSend(0);
+            IMUHandler_AcceptFrame();
+
+            //todo: [PM] serve rest of the data
         }
-        
-//        MotorManager_SetSpeed(Motor_Right, Imu2PmbFrame.motorRightSpeed);
-//        MotorManager_StartMotorKeepDirection(Motor_Right);
-//        MotorManager_SetSpeed(Motor_Left, Imu2PmbFrame.motorLeftSpeed);
-//        MotorManager_StartMotorKeepDirection(Motor_Left);
-        MotorManager_StartMotor(Motor_Thumble, dRIGHT);
-        MotorManager_SetSpeed(Motor_Thumble, Imu2PmbFrame.motorThumbleSpeed);
-        MotorManager_StartMotorKeepDirection(Motor_Thumble);
-        
-        MotorManager_SetSpeed(Motor_Lift, Imu2PmbFrame.motorLiftSpeed);
-        MotorManager_SetSpeed(Motor_Belt1, Imu2PmbFrame.motorBelt1Speed);
-        MotorManager_SetSpeed(Motor_Belt2, Imu2PmbFrame.motorBelt2Speed);
-        
-        MotorManager_TriggerEnableMessageSend(0);
-        
-        //todo: [PM] serve rest of the data
     }
     else{
         Pmb2ImuFrame.crcImu2PmbErrorCount++;
-        IMUHandler_EmergencyStop();
+        /* Garbage right after a baud rate change is expected */
+        if (LinkSpeed_Error(&ImuLink, TimeManager_GetSystemTick())) {
+            IMUHandler_EmergencyStop();
+        }
     }
     LED3_Toggle();
 }
@@ -503,6 +637,23 @@ float IMUHandler_CalculateAngle(float prevDegree, float currentDegree) {
 
     return angle;
 }
+
+q16_t IMUHandler_GetAngleQ16(void){
+    return CalculateDegreeFromPiQ16(IMUData.Roll);
+}
+
+q16_t IMUHandler_CalculateAngleQ16(q16_t prevDegree, q16_t currentDegree) {
+    q16_t angle = currentDegree - prevDegree;
+
+    // Normalize the angle to be between -180 and 180 degrees
+    if (angle <= dQ16_FROM_INT(-180)) {
+        angle += dQ16_FROM_INT(360);
+    } else if (angle > dQ16_FROM_INT(180)) {
+        angle -= dQ16_FROM_INT(360);
+    }
+
+    return angle;
+}
     uint8_t speed;
     uint8_t route_step;
     uint16_t isV;
@@ -641,6 +792,6 @@ void IMUHandler_SetCurrentRouteStep(uint8_t Step){
 }
 
 void IMUHandler_EmergencyStop(void){
-    MotorManager_StopAllMotors();
+    EmergencyStop_Trigger(EmergencyStop_LinkLost, TimeManager_GetMicros());
     // todo: [PM] add indication
 }
\ No newline at end of file
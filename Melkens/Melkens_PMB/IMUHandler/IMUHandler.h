@@ -13,6 +13,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include "../Tools/FixedPoint.h"
 
 #define LEFT_ENCODER 0
 #define RIGHT_ENCODER 1
@@ -180,6 +181,10 @@ void IMUHandler_SetMessageReceived(void);
 void IMUHandler_Init( void );
 bool IMUHandler_IsInitialized( void );
 int16_t IMUHandler_Get1msRotationTics(bool Wheel);
+/* Shared [us] timebase of ESP, Local is TimeManager_GetMicros, false when not synchronised */
+bool IMUHandler_ToSharedTime(uint32_t Local, uint32_t *Shared);
+/* [us] worst case error of IMUHandler_ToSharedTime, UINT32_MAX when not synchronised */
+uint32_t IMUHandler_GetTimeErrorBound(void);
 uint16_t IMUHandler_GetReceiveBufferAddress( void );
 uint16_t IMUHandler_GetTransmitBufferAddress( void );
 void IMUHandler_ProcessReceivedData(void);
@@ -197,6 +202,8 @@ MagnetsStatus GetMagnets(void);
 void Remote_ClearEvent(void);
 float IMUHandler_GetAngle(void);
 float IMUHandler_CalculateAngle(float prevDegree, float currentDegree);
+q16_t IMUHandler_GetAngleQ16(void);
+q16_t IMUHandler_CalculateAngleQ16(q16_t prevDegree, q16_t currentDegree);
 RemoteButton IMUHandler_GetRemoteMessage();
 uint8_t Remote_GetSpeed();
 uint8_t Remote_GetRouteStep();
@@ -207,6 +214,7 @@ bool IMUHandler_IsRouteSelectButton(void);
 
 void IMUHandler_SetThumbleCurrent(int16_t Current );
 void IMUHandler_SetOverallCurrent(int16_t Current );
+void IMUHandler_SetTaskMisses(uint16_t Misses);
 
 
 #ifdef	__cplusplus
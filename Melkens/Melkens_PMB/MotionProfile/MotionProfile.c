@@ -0,0 +1,84 @@
+/*
+ * MotionProfile.c
+ *
+ * Peak of v dv/ds on a ramp of length L from Low * v to v is 0.846 v^2 / L
+ * for Low 0.2 (near 60 % of the ramp, not in the middle where S is
+ * steepest). Speed is taken in cm/min from RPM, so L = v^2 / (4255 a) in cm.
+ * With both ramps each gets at most half of the step, a ramp that does not
+ * fit is steeper but still without an acceleration step.
+ */
+#include "MotionProfile.h"
+
+static q15_t MotionProfile_SCurve(q15_t Position);
+
+/* 60^2 s^2/min^2 / 0.846, valid for dMOTION_PROFILE_LOW_FACTOR 0.2 */
+#define dMOTION_PROFILE_RAMP_DIVISOR    (4255uL * dMOTION_PROFILE_MAX_ACCEL)
+
+static q15_t MotionProfile_Ramp(uint16_t Position, uint16_t Length)
+{
+    q15_t Factor;
+
+    /* Position < Length, Q16 quotient below 1 */
+    Factor = MotionProfile_SCurve((q15_t)(FixedPoint_Q16Div(Position, Length) >> 1));
+    return dMOTION_PROFILE_LOW_FACTOR + FixedPoint_Q15Mul(dQ15_ONE - dMOTION_PROFILE_LOW_FACTOR, Factor);
+}
+
+void MotionProfile_Plan(MotionProfile *Profile, uint16_t Length, uint16_t Speed, q16_t DistancePerRotation,
+                        bool Accelerate, bool Decelerate)
+{
+    uint32_t SpeedCmMin;
+    uint32_t Ramp;
+    uint16_t MaxRamp;
+
+    SpeedCmMin = (uint32_t)FixedPoint_Q16Mul(Speed, DistancePerRotation);
+    Ramp = (SpeedCmMin * SpeedCmMin) / dMOTION_PROFILE_RAMP_DIVISOR;
+    if (Ramp < dMOTION_PROFILE_MIN_RAMP) {
+        Ramp = dMOTION_PROFILE_MIN_RAMP;
+    }
+
+    MaxRamp = (Accelerate && Decelerate) ? (Length / 2u) : Length;
+    if (Ramp > MaxRamp) {
+        Ramp = MaxRamp;
+    }
+
+    Profile->Length = Length;
+    Profile->AccelLength = Accelerate ? (uint16_t)Ramp : 0u;
+    Profile->DecelLength = Decelerate ? (uint16_t)Ramp : 0u;
+}
+
+q15_t MotionProfile_GetFactor(const MotionProfile *Profile, uint16_t Travelled)
+{
+    q15_t Factor = dQ15_ONE;
+    q15_t DecelFactor;
+    uint16_t Remaining;
+
+    if (Travelled < Profile->AccelLength) {
+        Factor = MotionProfile_Ramp(Travelled, Profile->AccelLength);
+    }
+    if (Profile->DecelLength != 0u) {
+        /* Past the step end keep the low speed until the step is finished */
+        Remaining = (Travelled < Profile->Length) ? (uint16_t)(Profile->Length - Travelled) : 0u;
+        if (Remaining < Profile->DecelLength) {
+            DecelFactor = MotionProfile_Ramp(Remaining, Profile->DecelLength);
+            if (DecelFactor < Factor) {
+                Factor = DecelFactor;
+            }
+        }
+    }
+    return Factor;
+}
+
+/* Smoothstep of Position 0..dQ15_ONE */
+static q15_t MotionProfile_SCurve(q15_t Position)
+{
+    uint32_t Product;
+    q15_t Square;
+
+    if (Position <= 0) {
+        return 0;
+    }
+    Square = FixedPoint_Q15Mul(Position, Position);
+    /* x^2 (3 - 2x) = x^2 (1.5 - x) * 2, (1.5 - x) in Q15 fits 16 bits unsigned */
+    Product = ((uint32_t)(uint16_t)Square * (uint16_t)(49152u - (uint16_t)Position)) >> 14;
+    return (Product > (uint32_t)dQ15_ONE) ? dQ15_ONE : (q15_t)Product;
+}
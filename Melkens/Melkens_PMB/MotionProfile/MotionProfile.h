@@ -0,0 +1,52 @@
+/*
+ * File:   MotionProfile.h
+ *
+ * Jerk limited (S-curve) speed profile of a route step. The profile is
+ * planned once per step against distance: speed factor rises from
+ * dMOTION_PROFILE_LOW_FACTOR to 1 over the acceleration length and falls back
+ * over the deceleration length before the step end, shaped by smoothstep
+ * S(x) = x^2 (3 - 2x). Slope of S is 0 at both ends of a ramp, so wheel
+ * acceleration starts and ends at 0 instead of jumping as with a linear ramp.
+ *
+ * Ramp length comes from step speed and dMOTION_PROFILE_MAX_ACCEL, not from a
+ * share of the step, so long steps do not creep and short steps do not slip.
+ * Peak acceleration of the S-curve, v dv/ds, is 0.846 v^2 / Length.
+ *
+ * Integer only: planning has one 32 bit division, MotionProfile_GetFactor
+ * one Q16 division and three 16x16 multiplications per call.
+ * Tools/MotionProfile builds this file on the host.
+ */
+
+#ifndef MOTIONPROFILE_H
+#define	MOTIONPROFILE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Tools/FixedPoint.h"
+
+#define dMOTION_PROFILE_LOW_FACTOR  dQ15(0.2)   /* speed at step start and end, share of step speed */
+#define dMOTION_PROFILE_MAX_ACCEL   3u          /* [cm/s^2] peak wheel acceleration of a ramp */
+#define dMOTION_PROFILE_MIN_RAMP    20u         /* [cm] shortest ramp, if the step is long enough */
+
+typedef struct MotionProfile_t{
+    uint16_t Length;        /* [cm] step length */
+    uint16_t AccelLength;   /* [cm] 0 - no acceleration ramp */
+    uint16_t DecelLength;   /* [cm] 0 - no deceleration ramp */
+}MotionProfile;
+
+/* Once per step. Speed is the faster wheel step speed [RPM],
+ * DistancePerRotation is cm per rotation count (dDISTANCE_PER_MOTOR_ROTATION_Q16) */
+void MotionProfile_Plan(MotionProfile *Profile, uint16_t Length, uint16_t Speed, q16_t DistancePerRotation,
+                        bool Accelerate, bool Decelerate);
+/* Speed factor after Travelled [cm] of the step, dQ15_ONE between the ramps */
+q15_t MotionProfile_GetFactor(const MotionProfile *Profile, uint16_t Travelled);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* MOTIONPROFILE_H */
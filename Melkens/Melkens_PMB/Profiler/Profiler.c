@@ -0,0 +1,162 @@
+/*
+ * Profiler.c
+ *
+ * Timestamps are built from the free running SYSTICK counter and the TMR1
+ * counter (FOSC/2 with 1:8 prescaler -> 0.8us per count, PR1 + 1 counts per
+ * 1ms). Checkpoints measure the time elapsed since the previous checkpoint,
+ * so every function called in the main loop needs only one line to profile.
+ */
+#include "Profiler.h"
+
+#if COMPILE_SWITCH_PROFILER
+
+#include <xc.h>
+#include "../TimeManager/TimeManager.h"
+#include "../mcc_generated_files/tmr1.h"
+
+#define dPROFILER_US_NUM 4u /* 1 TMR1 count = 4/5 us */
+#define dPROFILER_US_DEN 5u
+
+typedef struct ProfilerAccumulator_t{
+    uint16_t Last;
+    uint16_t Max;
+    uint16_t Average;
+    uint16_t Calls;
+    uint16_t WindowCalls;
+    uint32_t WindowSum;
+}ProfilerAccumulator;
+
+static ProfilerAccumulator Accumulators[Profiler_NumOf];
+static uint32_t CountsPerTick;
+static uint32_t LoopStart;
+static uint32_t LastCheckpoint;
+static uint16_t OverrunCount;
+
+static uint16_t Profiler_CountsToUs(uint32_t Counts)
+{
+    uint32_t Us = (Counts * dPROFILER_US_NUM) / dPROFILER_US_DEN;
+    return (Us > UINT16_MAX) ? UINT16_MAX : (uint16_t)Us;
+}
+
+static void Profiler_Record(ProfilerSlot Slot, uint16_t Time)
+{
+    ProfilerAccumulator *Acc = &Accumulators[Slot];
+
+    Acc->Last = Time;
+    if (Time > Acc->Max){
+        Acc->Max = Time;
+    }
+    if (Acc->WindowCalls < UINT16_MAX){
+        Acc->WindowSum += Time;
+        Acc->WindowCalls++;
+    }
+}
+
+void Profiler_Init(void)
+{
+    CountsPerTick = (uint32_t)TMR1_Period16BitGet() + 1u;
+    OverrunCount = 0;
+    Profiler_Reset();
+    LoopStart = Profiler_GetTimestamp();
+    LastCheckpoint = LoopStart;
+}
+
+void Profiler_Reset(void)
+{
+    uint8_t Slot;
+
+    for (Slot = 0; Slot < Profiler_NumOf; Slot++){
+        Accumulators[Slot].Last = 0;
+        Accumulators[Slot].Max = 0;
+        Accumulators[Slot].Average = 0;
+        Accumulators[Slot].Calls = 0;
+        Accumulators[Slot].WindowCalls = 0;
+        Accumulators[Slot].WindowSum = 0;
+    }
+    OverrunCount = 0;
+    TimeManager_ResetMissedTicks();
+}
+
+uint32_t Profiler_GetTimestamp(void)
+{
+    uint32_t Tick;
+    uint16_t Counter;
+    bool IsTickPending;
+
+    do{
+        Tick = TimeManager_GetSystemTick();
+        Counter = TMR1_Counter16BitGet();
+        IsTickPending = IFS0bits.T1IF;
+    }while (Tick != TimeManager_GetSystemTick());
+
+    /* Timer already rolled over but SYSTICK not serviced yet (interrupts disabled) */
+    if (IsTickPending && (Counter < (CountsPerTick / 2u))){
+        Tick++;
+    }
+
+    return (Tick * CountsPerTick) + Counter;
+}
+
+void Profiler_BeginLoop(void)
+{
+    LoopStart = Profiler_GetTimestamp();
+    LastCheckpoint = LoopStart;
+}
+
+void Profiler_Checkpoint(ProfilerSlot Slot)
+{
+    uint32_t Now = Profiler_GetTimestamp();
+
+    Profiler_Record(Slot, Profiler_CountsToUs(Now - LastCheckpoint));
+    LastCheckpoint = Now;
+}
+
+void Profiler_EndLoop(void)
+{
+    uint32_t Elapsed = Profiler_GetTimestamp() - LoopStart;
+
+    Profiler_Record(Profiler_MainLoop, Profiler_CountsToUs(Elapsed));
+
+    /* Single iteration longer than the 1ms slot */
+    if ((Elapsed > CountsPerTick) && (OverrunCount < UINT16_MAX)){
+        OverrunCount++;
+    }
+}
+
+/* Latch averages of the finished window and start a new one */
+void Profiler_Perform1s(void)
+{
+    uint8_t Slot;
+
+    for (Slot = 0; Slot < Profiler_NumOf; Slot++){
+        ProfilerAccumulator *Acc = &Accumulators[Slot];
+
+        Acc->Calls = Acc->WindowCalls;
+        Acc->Average = (Acc->WindowCalls != 0) ? (uint16_t)(Acc->WindowSum / Acc->WindowCalls) : 0;
+        Acc->WindowCalls = 0;
+        Acc->WindowSum = 0;
+    }
+}
+
+void Profiler_GetStats(ProfilerSlot Slot, ProfilerStats *Stats)
+{
+    if (Slot >= Profiler_NumOf){
+        return;
+    }
+    Stats->Last = Accumulators[Slot].Last;
+    Stats->Max = Accumulators[Slot].Max;
+    Stats->Average = Accumulators[Slot].Average;
+    Stats->Calls = Accumulators[Slot].Calls;
+}
+
+uint16_t Profiler_GetLoopMaxTime(void)
+{
+    return Accumulators[Profiler_MainLoop].Max;
+}
+
+uint16_t Profiler_GetOverrunCount(void)
+{
+    return OverrunCount;
+}
+
+#endif
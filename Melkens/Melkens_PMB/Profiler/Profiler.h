@@ -0,0 +1,72 @@
+/* 
+ * File:   Profiler.h
+ *
+ * Execution time profiler for the main loop. Uses TMR1 (1ms SYSTICK,
+ * 0.8us resolution) together with the free running SYSTICK counter.
+ */
+
+#ifndef PROFILER_H
+#define	PROFILER_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../pmb_System.h"
+
+typedef enum ProfilerSlot_t{
+    Profiler_ScheduledTasks = 0,    /* Per task times are kept by TaskScheduler stats */
+    Profiler_StateMachines,
+    Profiler_MainLoop,          /* Whole loop iteration, filled by Profiler_EndLoop */
+    Profiler_NumOf
+}ProfilerSlot;
+
+typedef struct ProfilerStats_t{
+    uint16_t Last;      /* [us] */
+    uint16_t Max;       /* [us] worst case since last Profiler_Reset */
+    uint16_t Average;   /* [us] average over last 1s window */
+    uint16_t Calls;     /* number of calls in last 1s window */
+}ProfilerStats;
+
+/* Timestamp unit is one TMR1 count (0.8us) */
+#define dPROFILER_US_TO_COUNTS(Us)  (((uint32_t)(Us) * 5u) / 4u)
+
+#if COMPILE_SWITCH_PROFILER
+
+#define Profiler_TimeSource     Profiler_GetTimestamp
+
+void Profiler_Init(void);
+void Profiler_Reset(void);
+void Profiler_BeginLoop(void);
+void Profiler_Checkpoint(ProfilerSlot Slot);
+void Profiler_EndLoop(void);
+void Profiler_Perform1s(void);
+
+uint32_t Profiler_GetTimestamp(void);
+void Profiler_GetStats(ProfilerSlot Slot, ProfilerStats *Stats);
+uint16_t Profiler_GetLoopMaxTime(void);
+uint16_t Profiler_GetOverrunCount(void);
+
+#else
+
+#define Profiler_TimeSource     NULL
+
+#define Profiler_Init()
+#define Profiler_Reset()
+#define Profiler_BeginLoop()
+#define Profiler_Checkpoint(Slot)
+#define Profiler_EndLoop()
+#define Profiler_Perform1s()
+#define Profiler_GetLoopMaxTime()   (0u)
+#define Profiler_GetOverrunCount()  (0u)
+
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PROFILER_H */
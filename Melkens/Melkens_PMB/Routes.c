@@ -1,926 +1,1393 @@
+/*
+ * File:   Routes.c
+ *
+ * Generated by Tools/RouteCompiler/route_compiler.py from:
+ *   Routes/PMB_A.csv
+ *   Routes/PMB_B.csv
+ *   Routes/PMB_C.csv
+ *   Routes/PMB_D.csv
+ *   Routes/PMB_E.csv
+ *   Routes/PMB_F.csv
+ *   Routes/PMB_G.csv
+ *   Routes/PMB_H.csv
+ *   Routes/PMB_I.csv
+ *   Routes/PMB_J.csv
+ *   Routes/PMB_K.csv
+ * Do not edit, change the route description and run the compiler again.
+ */
+
 #include "RoutesDataTypes.h"
 
 #include <string.h>
 
-//TRASY KUZNIA RACIBORSKA 24.04.2025
 
-#define STEPS_ROUTE_A 140 //GRUPY 123 SZYBKO V1.2
+//TRASY KUZNIA RACIBORSKA 24.04.2025, GRUPY 123 SZYBKO V1.2
+#define STEPS_ROUTE_A 140
 static const RouteStep RouteStepsA[STEPS_ROUTE_A] = {
-//0 WYJAZD Z ?ADOWARKI
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0 WYJAZD Z LADOWARKI
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //1
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //2
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //3
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //4
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //5
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_OFF, 10, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_OFF, 0, 0, 300, 300, 10, dROUTE_MAGNET_NONE},
 //6
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //7
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //8
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //9
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 45, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 45, dROUTE_MAGNET_NONE},
 //10
-{NORM, 140, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 140, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //11
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //12
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //13
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //14
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //15
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 105, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 105, dROUTE_MAGNET_NONE},
 //16
-{NORM, 90, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 90, 0, 300, 300, 0, 0},
 //17
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 35, dMAGNET_NO_CORRECTION},
-
-//18    PODGARNIANIE GRUP 12
-{NORM, 60, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 35, dROUTE_MAGNET_NONE},
+//18 PODGARNIANIE GRUP 12
+{NORM, R_FOR, L_FOR, TH_ON, 60, 0, 300, 300, 0, 0},
 //19
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //20
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //21
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //22
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //23
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //24
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //25
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //26
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //27
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //28
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //29
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //30
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //31
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //32
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //33
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //34
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //35
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //36
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //37
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //38
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //39
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //40
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //41
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //42
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //43
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //44
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //45
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //46
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //47
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //48
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //49
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //50
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //51
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //52
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //53
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //54
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //55
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //56
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //57
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //58
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //59
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //60
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //61
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //62
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //63
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //64
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //65
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //66
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //67
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //68
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //69
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //70
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
-
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //71 MANEWRY DO SRODKA
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_ON, 44, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_ON, 0, 0, 300, 300, 44, dROUTE_MAGNET_NONE},
 //72
-{NORM, 135, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_REV, L_REV, TH_OFF, 135, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //73
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_OFF, 130, dMAGNET_NO_CORRECTION},
-
-//74    JAZDA WZDLUZ STOLU PO SRODKU
-{NORM, 80, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_OFF, 0, 0, 300, 300, 130, dROUTE_MAGNET_NONE},
+//74 JAZDA WZDLUZ STOLU PO SRODKU
+{NORM, R_FOR, L_FOR, TH_OFF, 80, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //75
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //76
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //77
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //78
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //79
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //80
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //81
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //82
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //83
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //84
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //85
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //86
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //87
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //88
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //89
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //90
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //91
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //92
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //93
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //94
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //95
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //96
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
-
-//97    MANEWRY - ZJAZD DO GRUPY 3
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_OFF, 42, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
+//97 MANEWRY - ZJAZD DO GRUPY 3
+{L_90, R_FOR, L_REV, TH_OFF, 0, 0, 300, 300, 42, dROUTE_MAGNET_NONE},
 //98
-{NORM, 140, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 140, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //99
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 26, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 26, dROUTE_MAGNET_NONE},
 //100
-{NORM, 105, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 105, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //101
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 17, dMAGNET_NO_CORRECTION},
-
-//102   PODGARNIANIE GRUPY 3
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 17, dROUTE_MAGNET_NONE},
+//102 PODGARNIANIE GRUPY 3
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //103
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //104
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //105
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //106
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //107
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //108
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //109
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //110
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //111
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //112
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //113
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //114
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //115
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //116
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //117
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //118
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //119
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //120
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //121
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //122
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //123
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //124
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
-
-//125 POWROT DO ?ADOWARKI
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_ON, 9, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
+//125 POWROT DO LADOWARKI
+{L_90, R_FOR, L_REV, TH_ON, 0, 0, 300, 300, 9, dROUTE_MAGNET_NONE},
 //126
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //127
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //128
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //129
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //130
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //131
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //132
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //133
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //134
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 9, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 9, dROUTE_MAGNET_NONE},
 //135
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //136
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //137
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //138
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //139
-{NORM, 20, 0, 100, 100, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION}
-};                                             
-        
-#define STEPS_ROUTE_B 131 //GRUPA 4 SZYBKO V1.1
-static const RouteStep RouteStepsB[STEPS_ROUTE_B] = 
-{
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesA[STEPS_ROUTE_A] = {
+//{X, Y, Heading} at the end of step
+{-20, 0, 0}, //0
+{-40, 0, 0}, //1
+{-60, 0, 0}, //2
+{-80, 0, 0}, //3
+{-130, 0, 0}, //4
+{-130, 0, -10}, //5
+{-179, 9, -10}, //6
+{-228, 17, -10}, //7
+{-278, 26, -10}, //8
+{-278, 26, 35}, //9
+{-163, 106, 35}, //10
+{-122, 135, 35}, //11
+{-81, 164, 35}, //12
+{-40, 192, 35}, //13
+{1, 221, 35}, //14
+{1, 221, 140}, //15
+{-68, 279, 140}, //16
+{-68, 279, 175}, //17
+{-128, 284, 175}, //18
+{-178, 289, 175}, //19
+{-228, 293, 175}, //20
+{-277, 297, 175}, //21
+{-327, 302, 175}, //22
+{-427, 310, 175}, //23
+{-526, 319, 175}, //24
+{-626, 328, 175}, //25
+{-726, 336, 175}, //26
+{-825, 345, 175}, //27
+{-925, 354, 175}, //28
+{-1025, 363, 175}, //29
+{-1124, 371, 175}, //30
+{-1224, 380, 175}, //31
+{-1323, 389, 175}, //32
+{-1423, 397, 175}, //33
+{-1523, 406, 175}, //34
+{-1622, 415, 175}, //35
+{-1722, 424, 175}, //36
+{-1821, 432, 175}, //37
+{-1921, 441, 175}, //38
+{-2021, 450, 175}, //39
+{-2120, 458, 175}, //40
+{-2220, 467, 175}, //41
+{-2320, 476, 175}, //42
+{-2419, 485, 175}, //43
+{-2519, 493, 175}, //44
+{-2618, 502, 175}, //45
+{-2718, 511, 175}, //46
+{-2818, 519, 175}, //47
+{-2917, 528, 175}, //48
+{-3017, 537, 175}, //49
+{-3117, 546, 175}, //50
+{-3216, 554, 175}, //51
+{-3316, 563, 175}, //52
+{-3415, 572, 175}, //53
+{-3515, 580, 175}, //54
+{-3615, 589, 175}, //55
+{-3714, 598, 175}, //56
+{-3814, 607, 175}, //57
+{-3913, 615, 175}, //58
+{-4013, 624, 175}, //59
+{-4113, 633, 175}, //60
+{-4212, 641, 175}, //61
+{-4312, 650, 175}, //62
+{-4412, 659, 175}, //63
+{-4511, 668, 175}, //64
+{-4611, 676, 175}, //65
+{-4710, 685, 175}, //66
+{-4810, 694, 175}, //67
+{-4910, 702, 175}, //68
+{-5009, 711, 175}, //69
+{-5109, 720, 175}, //70
+{-5109, 720, 131}, //71
+{-5020, 618, 131}, //72
+{-5020, 618, 1}, //73
+{-4940, 619, 1}, //74
+{-4890, 620, 1}, //75
+{-4840, 621, 1}, //76
+{-4790, 622, 1}, //77
+{-4740, 623, 1}, //78
+{-4640, 625, 1}, //79
+{-4540, 626, 1}, //80
+{-4440, 628, 1}, //81
+{-4340, 630, 1}, //82
+{-4240, 632, 1}, //83
+{-4140, 633, 1}, //84
+{-4040, 635, 1}, //85
+{-3940, 637, 1}, //86
+{-3841, 639, 1}, //87
+{-3741, 640, 1}, //88
+{-3641, 642, 1}, //89
+{-3541, 644, 1}, //90
+{-3441, 646, 1}, //91
+{-3341, 647, 1}, //92
+{-3241, 649, 1}, //93
+{-3141, 651, 1}, //94
+{-3041, 653, 1}, //95
+{-2941, 654, 1}, //96
+{-2941, 654, -41}, //97
+{-2835, 562, -41}, //98
+{-2835, 562, -15}, //99
+{-2734, 535, -15}, //100
+{-2734, 535, 2}, //101
+{-2634, 539, 2}, //102
+{-2534, 542, 2}, //103
+{-2434, 546, 2}, //104
+{-2334, 549, 2}, //105
+{-2234, 553, 2}, //106
+{-2134, 556, 2}, //107
+{-2034, 560, 2}, //108
+{-1934, 563, 2}, //109
+{-1834, 567, 2}, //110
+{-1734, 570, 2}, //111
+{-1634, 574, 2}, //112
+{-1534, 577, 2}, //113
+{-1434, 581, 2}, //114
+{-1334, 584, 2}, //115
+{-1234, 588, 2}, //116
+{-1135, 591, 2}, //117
+{-1035, 595, 2}, //118
+{-935, 598, 2}, //119
+{-835, 602, 2}, //120
+{-735, 605, 2}, //121
+{-635, 609, 2}, //122
+{-535, 612, 2}, //123
+{-435, 616, 2}, //124
+{-435, 616, -7}, //125
+{-410, 613, -7}, //126
+{-385, 609, -7}, //127
+{-361, 606, -7}, //128
+{-336, 603, -7}, //129
+{-286, 597, -7}, //130
+{-236, 591, -7}, //131
+{-187, 585, -7}, //132
+{-137, 579, -7}, //133
+{-137, 579, 2}, //134
+{-87, 581, 2}, //135
+{-67, 581, 2}, //136
+{-47, 582, 2}, //137
+{-27, 583, 2}, //138
+{-7, 584, 2}, //139
+};
+
+//GRUPA 4 SZYBKO V1.1
+#define STEPS_ROUTE_B 131
+static const RouteStep RouteStepsB[STEPS_ROUTE_B] = {
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
 //0 WYJAZD Z LADOWARKI
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //1
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //2
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //3
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //4
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //5
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_OFF, 10, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_OFF, 0, 0, 300, 300, 10, dROUTE_MAGNET_NONE},
 //6
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //7
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //8
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //9
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 45, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 45, dROUTE_MAGNET_NONE},
 //10
-{NORM, 140, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 140, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //11
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //12
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //13
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_OFF, 37, dMAGNET_NO_CORRECTION},
-
-//14    JAZDA WZDLUZ STOLU TYLEM SRODKIEM
-{NORM, 150, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_OFF, 0, 0, 300, 300, 37, dROUTE_MAGNET_NONE},
+//14 JAZDA WZDLUZ STOLU TYLEM SRODKIEM
+{NORM, R_REV, L_REV, TH_OFF, 150, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //15
-{NORM, 100, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //16
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //17
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //18
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //19
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //20
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //21
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //22
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //23
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //24
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //25
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //26
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //27
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //28
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //29
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //30
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //31
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //32
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //33
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //34
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //35
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //36
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //37
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //38
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //39
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //40
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //41
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //42
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //43
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //44
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //45
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //46
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //47
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //48
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //49
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //50
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //51
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //52
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //53
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //54
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //55
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //56
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //57
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //58
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-  //59
-  {NORM, 100, 0, 600, 600, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-
-  //60
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 300, 300, 0, 0},
+//16
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//17
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//18
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//19
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//20
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//21
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//22
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//23
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//24
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//25
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//26
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//27
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//28
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//29
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//30
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//31
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//32
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//33
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//34
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//35
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//36
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//37
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//38
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//39
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//40
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//41
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//42
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//43
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//44
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//45
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//46
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//47
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//48
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//49
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//50
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//51
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//52
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//53
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//54
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//55
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//56
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//57
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//58
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//59
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 600, 600, 0, 0},
+//60
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //61
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //62
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //63
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //64
-{NORM, 100, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
-
-//65    MANEWRY - WJAZD W GRUPE 4
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_ON, 42, dMAGNET_NO_CORRECTION},
+{NORM, R_REV, L_REV, TH_OFF, 100, 0, 300, 300, 0, 0},
+//65 MANEWRY - WJAZD W GRUPE 4
+{L_90, R_FOR, L_REV, TH_ON, 0, 0, 300, 300, 42, dROUTE_MAGNET_NONE},
 //66
-{NORM, 145, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 145, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //67
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 42, dMAGNET_NO_CORRECTION},
-
-//68    PODGARNIANIE GRUPY 4
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 42, dROUTE_MAGNET_NONE},
+//68 PODGARNIANIE GRUPY 4
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //69
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //70
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //71
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //72
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //73
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //74
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //75
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //76
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //77
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //78
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //79
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //80
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //81
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //82
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //83
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //84
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //85
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //86
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //87
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //88
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
-
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //89 MANEWRY WYJAZD  GRUPY 4 DO SRODKA
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 42, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 42, dROUTE_MAGNET_NONE},
 //90
-{NORM, 150, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 150, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //91
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_OFF, 42, dMAGNET_NO_CORRECTION},
-
-//92    JAZDA WZDLUZ STOLU SRODKIEM
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_OFF, 0, 0, 300, 300, 42, dROUTE_MAGNET_NONE},
+//92 JAZDA WZDLUZ STOLU SRODKIEM
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //93
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 300, 300, 0, 0},
 //94
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //95
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //96
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //97
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //98
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //99
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //100
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //101
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //102
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //103
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //104
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //105
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //106
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //107
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //108
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //109
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //110
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //111
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //112
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
 //113
-{NORM, 100, 0, 600, 600, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
-
-//114   WJAZD DO LADOWARKI
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_ON, 50, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 100, 0, 600, 600, 0, 0},
+//114 WJAZD DO LADOWARKI
+{L_90, R_FOR, L_REV, TH_ON, 0, 0, 300, 300, 50, dROUTE_MAGNET_NONE},
 //115
-{NORM, 170, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 170, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //116
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 36, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 36, dROUTE_MAGNET_NONE},
 //117
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //118
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //119
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //120
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //121
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //122
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //123
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //124
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //125
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 9, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 9, dROUTE_MAGNET_NONE},
 //126
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //127
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //128
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //129
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //130
-{NORM, 20, 0, 100, 100, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION}
-
-                                    };
-
-#define STEPS_ROUTE_C 140    //TRASA 1234 V1.0
-static const RouteStep RouteStepsC[STEPS_ROUTE_C] = 
-{
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesB[STEPS_ROUTE_B] = {
+//{X, Y, Heading} at the end of step
+{-20, 0, 0}, //0
+{-40, 0, 0}, //1
+{-60, 0, 0}, //2
+{-80, 0, 0}, //3
+{-130, 0, 0}, //4
+{-130, 0, -10}, //5
+{-179, 9, -10}, //6
+{-228, 17, -10}, //7
+{-278, 26, -10}, //8
+{-278, 26, 35}, //9
+{-163, 106, 35}, //10
+{-122, 135, 35}, //11
+{-81, 164, 35}, //12
+{-81, 164, -2}, //13
+{-231, 169, -2}, //14
+{-331, 172, -2}, //15
+{-431, 176, -2}, //16
+{-531, 179, -2}, //17
+{-631, 183, -2}, //18
+{-731, 186, -2}, //19
+{-831, 190, -2}, //20
+{-931, 193, -2}, //21
+{-1031, 197, -2}, //22
+{-1130, 200, -2}, //23
+{-1230, 204, -2}, //24
+{-1330, 207, -2}, //25
+{-1430, 211, -2}, //26
+{-1530, 214, -2}, //27
+{-1630, 218, -2}, //28
+{-1730, 221, -2}, //29
+{-1830, 225, -2}, //30
+{-1930, 228, -2}, //31
+{-2030, 232, -2}, //32
+{-2130, 235, -2}, //33
+{-2230, 239, -2}, //34
+{-2330, 242, -2}, //35
+{-2430, 246, -2}, //36
+{-2530, 249, -2}, //37
+{-2630, 253, -2}, //38
+{-2730, 256, -2}, //39
+{-2829, 260, -2}, //40
+{-2929, 263, -2}, //41
+{-3029, 267, -2}, //42
+{-3129, 270, -2}, //43
+{-3229, 274, -2}, //44
+{-3329, 277, -2}, //45
+{-3429, 281, -2}, //46
+{-3529, 284, -2}, //47
+{-3629, 288, -2}, //48
+{-3729, 291, -2}, //49
+{-3829, 295, -2}, //50
+{-3929, 298, -2}, //51
+{-4029, 302, -2}, //52
+{-4129, 305, -2}, //53
+{-4229, 309, -2}, //54
+{-4329, 312, -2}, //55
+{-4428, 316, -2}, //56
+{-4528, 319, -2}, //57
+{-4628, 322, -2}, //58
+{-4728, 326, -2}, //59
+{-4778, 328, -2}, //60
+{-4828, 329, -2}, //61
+{-4878, 331, -2}, //62
+{-4928, 333, -2}, //63
+{-5028, 336, -2}, //64
+{-5028, 336, -44}, //65
+{-4924, 236, -44}, //66
+{-4924, 236, -2}, //67
+{-4824, 232, -2}, //68
+{-4724, 229, -2}, //69
+{-4624, 225, -2}, //70
+{-4524, 222, -2}, //71
+{-4424, 218, -2}, //72
+{-4324, 215, -2}, //73
+{-4224, 211, -2}, //74
+{-4124, 208, -2}, //75
+{-4024, 204, -2}, //76
+{-3924, 201, -2}, //77
+{-3824, 197, -2}, //78
+{-3725, 194, -2}, //79
+{-3625, 190, -2}, //80
+{-3525, 187, -2}, //81
+{-3425, 183, -2}, //82
+{-3325, 180, -2}, //83
+{-3225, 176, -2}, //84
+{-3125, 173, -2}, //85
+{-3025, 169, -2}, //86
+{-2925, 166, -2}, //87
+{-2825, 162, -2}, //88
+{-2825, 162, 40}, //89
+{-2710, 259, 40}, //90
+{-2710, 259, -2}, //91
+{-2610, 255, -2}, //92
+{-2510, 252, -2}, //93
+{-2410, 248, -2}, //94
+{-2310, 245, -2}, //95
+{-2210, 241, -2}, //96
+{-2111, 238, -2}, //97
+{-2011, 234, -2}, //98
+{-1911, 231, -2}, //99
+{-1811, 227, -2}, //100
+{-1711, 224, -2}, //101
+{-1611, 220, -2}, //102
+{-1511, 217, -2}, //103
+{-1411, 213, -2}, //104
+{-1311, 210, -2}, //105
+{-1211, 207, -2}, //106
+{-1111, 203, -2}, //107
+{-1011, 200, -2}, //108
+{-911, 196, -2}, //109
+{-811, 193, -2}, //110
+{-711, 189, -2}, //111
+{-611, 186, -2}, //112
+{-512, 182, -2}, //113
+{-512, 182, -52}, //114
+{-407, 48, -52}, //115
+{-407, 48, -16}, //116
+{-383, 41, -16}, //117
+{-359, 34, -16}, //118
+{-335, 27, -16}, //119
+{-311, 21, -16}, //120
+{-263, 7, -16}, //121
+{-215, -7, -16}, //122
+{-167, -21, -16}, //123
+{-118, -35, -16}, //124
+{-118, -35, -7}, //125
+{-69, -41, -7}, //126
+{-49, -43, -7}, //127
+{-29, -46, -7}, //128
+{-9, -48, -7}, //129
+{11, -50, -7}, //130
+};
 
-//0 WYJAZD Z ?ADOWARKI
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+//TRASA 1234 V1.0
+#define STEPS_ROUTE_C 140
+static const RouteStep RouteStepsC[STEPS_ROUTE_C] = {
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0 WYJAZD Z LADOWARKI
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //1
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //2
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //3
-{NORM, 20, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 20, 0, 300, 300, 0, 0},
 //4
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //5
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_OFF, 10, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_OFF, 0, 0, 300, 300, 10, dROUTE_MAGNET_NONE},
 //6
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //7
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //8
-{NORM, 50, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_REV, L_REV, TH_OFF, 50, 0, 300, 300, 0, 0},
 //9
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 45, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 45, dROUTE_MAGNET_NONE},
 //10
-{NORM, 140, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 140, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //11
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //12
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //13
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //14
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //15
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 105, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 105, dROUTE_MAGNET_NONE},
 //16
-{NORM, 90, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 90, 0, 300, 300, 0, 0},
 //17
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 35, dMAGNET_NO_CORRECTION},
-
-//18    PODGARNIANIE GRUP 12
-{NORM, 60, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 35, dROUTE_MAGNET_NONE},
+//18 PODGARNIANIE GRUP 12
+{NORM, R_FOR, L_FOR, TH_ON, 60, 0, 300, 300, 0, 0},
 //19
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //20
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //21
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //22
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 50, 0, 300, 300, 0, 0},
 //23
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //24
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //25
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //26
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //27
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //28
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //29
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //30
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //31
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //32
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //33
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //34
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //35
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //36
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //37
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //38
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //39
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //40
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //41
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //42
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //43
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //44
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //45
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //46
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //47
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //48
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //49
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //50
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //51
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //52
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //53
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //54
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //55
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //56
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //57
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //58
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //59
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //60
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //61
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //62
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //63
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //64
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //65
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //66
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //67
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //68
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //69
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //70
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
-
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //71 MANEWRY DOJAZD DO GRUPY 4
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_ON, 45, dMAGNET_NO_CORRECTION},
+{L_90, R_FOR, L_REV, TH_ON, 0, 0, 300, 300, 45, dROUTE_MAGNET_NONE},
 //72
-{NORM, 135, 0, 300, 300, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_REV, L_REV, TH_OFF, 135, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //73
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 45, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 45, dROUTE_MAGNET_NONE},
 //74
-{NORM, 150, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 150, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //75
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 112, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 112, dROUTE_MAGNET_NONE},
 //76
-{NORM, 115, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 115, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //77
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_ON, 65, dMAGNET_NO_CORRECTION},
-
-//78    PODGARNIANIE GRUPY 4
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_ON, 0, 0, 300, 300, 65, dROUTE_MAGNET_NONE},
+//78 PODGARNIANIE GRUPY 4
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //79
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //80
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //81
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //82
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //83
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //84
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //85
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //86
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //87
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //88
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //89
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //90
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //91
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //92
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //93
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //94
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //95
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //96
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //97
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //98
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //99
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //100
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
 //101
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_R10},
-
-//102   PODGARNIANIE GRUPY 3
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 2170},
+//102 PODGARNIANIE GRUPY 3
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //103
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //104
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //105
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //106
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //107
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //108
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //109
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //110
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //111
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //112
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //113
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //114
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //115
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //116
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //117
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //118
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //119
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //120
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //121
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //122
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //123
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
 //124
-{NORM, 100, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
-
-//125   POWROT DO LADOWARKI
-{L_90, 0, 0, 300, 300, R_FOR, L_REV, TH_ON, 9, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 100, 0, 300, 300, 0, 0},
+//125 POWROT DO LADOWARKI
+{L_90, R_FOR, L_REV, TH_ON, 0, 0, 300, 300, 9, dROUTE_MAGNET_NONE},
 //126
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //127
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //128
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //129
-{NORM, 25, 0, 300, 300, R_FOR, L_FOR, TH_ON, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_ON, 25, 0, 300, 300, 0, 0},
 //130
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //131
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //132
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, 0},
 //133
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //134
-{R_90, 0, 0, 300, 300, R_REV, L_FOR, TH_OFF, 9, dMAGNET_NO_CORRECTION},
+{R_90, R_REV, L_FOR, TH_OFF, 0, 0, 300, 300, 9, dROUTE_MAGNET_NONE},
 //135
-{NORM, 50, 0, 300, 300, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION},
+{NORM, R_FOR, L_FOR, TH_OFF, 50, 0, 300, 300, 0, dROUTE_MAGNET_NONE},
 //136
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //137
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //138
-{NORM, 20, 0, 200, 200, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_MID},
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 200, 200, 0, 0},
 //139
-{NORM, 20, 0, 100, 100, R_FOR, L_FOR, TH_OFF, 0, dMAGNET_NO_CORRECTION}
-                                    };
+{NORM, R_FOR, L_FOR, TH_OFF, 20, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesC[STEPS_ROUTE_C] = {
+//{X, Y, Heading} at the end of step
+{-20, 0, 0}, //0
+{-40, 0, 0}, //1
+{-60, 0, 0}, //2
+{-80, 0, 0}, //3
+{-130, 0, 0}, //4
+{-130, 0, -10}, //5
+{-179, 9, -10}, //6
+{-228, 17, -10}, //7
+{-278, 26, -10}, //8
+{-278, 26, 35}, //9
+{-163, 106, 35}, //10
+{-122, 135, 35}, //11
+{-81, 164, 35}, //12
+{-40, 192, 35}, //13
+{1, 221, 35}, //14
+{1, 221, 140}, //15
+{-68, 279, 140}, //16
+{-68, 279, 175}, //17
+{-128, 284, 175}, //18
+{-178, 289, 175}, //19
+{-228, 293, 175}, //20
+{-277, 297, 175}, //21
+{-327, 302, 175}, //22
+{-427, 310, 175}, //23
+{-526, 319, 175}, //24
+{-626, 328, 175}, //25
+{-726, 336, 175}, //26
+{-825, 345, 175}, //27
+{-925, 354, 175}, //28
+{-1025, 363, 175}, //29
+{-1124, 371, 175}, //30
+{-1224, 380, 175}, //31
+{-1323, 389, 175}, //32
+{-1423, 397, 175}, //33
+{-1523, 406, 175}, //34
+{-1622, 415, 175}, //35
+{-1722, 424, 175}, //36
+{-1821, 432, 175}, //37
+{-1921, 441, 175}, //38
+{-2021, 450, 175}, //39
+{-2120, 458, 175}, //40
+{-2220, 467, 175}, //41
+{-2320, 476, 175}, //42
+{-2419, 485, 175}, //43
+{-2519, 493, 175}, //44
+{-2618, 502, 175}, //45
+{-2718, 511, 175}, //46
+{-2818, 519, 175}, //47
+{-2917, 528, 175}, //48
+{-3017, 537, 175}, //49
+{-3117, 546, 175}, //50
+{-3216, 554, 175}, //51
+{-3316, 563, 175}, //52
+{-3415, 572, 175}, //53
+{-3515, 580, 175}, //54
+{-3615, 589, 175}, //55
+{-3714, 598, 175}, //56
+{-3814, 607, 175}, //57
+{-3913, 615, 175}, //58
+{-4013, 624, 175}, //59
+{-4113, 633, 175}, //60
+{-4212, 641, 175}, //61
+{-4312, 650, 175}, //62
+{-4412, 659, 175}, //63
+{-4511, 668, 175}, //64
+{-4611, 676, 175}, //65
+{-4710, 685, 175}, //66
+{-4810, 694, 175}, //67
+{-4910, 702, 175}, //68
+{-5009, 711, 175}, //69
+{-5109, 720, 175}, //70
+{-5109, 720, 130}, //71
+{-5022, 617, 130}, //72
+{-5022, 617, 175}, //73
+{-5172, 630, 175}, //74
+{-5172, 630, -73}, //75
+{-5138, 520, -73}, //76
+{-5138, 520, -8}, //77
+{-5039, 506, -8}, //78
+{-4940, 492, -8}, //79
+{-4841, 478, -8}, //80
+{-4742, 464, -8}, //81
+{-4643, 450, -8}, //82
+{-4544, 436, -8}, //83
+{-4445, 422, -8}, //84
+{-4346, 408, -8}, //85
+{-4247, 394, -8}, //86
+{-4148, 380, -8}, //87
+{-4049, 367, -8}, //88
+{-3950, 353, -8}, //89
+{-3851, 339, -8}, //90
+{-3752, 325, -8}, //91
+{-3653, 311, -8}, //92
+{-3553, 297, -8}, //93
+{-3454, 283, -8}, //94
+{-3355, 269, -8}, //95
+{-3256, 255, -8}, //96
+{-3157, 241, -8}, //97
+{-3058, 227, -8}, //98
+{-2959, 213, -8}, //99
+{-2860, 200, -8}, //100
+{-2761, 186, -8}, //101
+{-2662, 172, -8}, //102
+{-2563, 158, -8}, //103
+{-2464, 144, -8}, //104
+{-2365, 130, -8}, //105
+{-2266, 116, -8}, //106
+{-2167, 102, -8}, //107
+{-2068, 88, -8}, //108
+{-1969, 74, -8}, //109
+{-1870, 60, -8}, //110
+{-1771, 46, -8}, //111
+{-1672, 32, -8}, //112
+{-1573, 19, -8}, //113
+{-1474, 5, -8}, //114
+{-1375, -9, -8}, //115
+{-1276, -23, -8}, //116
+{-1177, -37, -8}, //117
+{-1078, -51, -8}, //118
+{-979, -65, -8}, //119
+{-880, -79, -8}, //120
+{-781, -93, -8}, //121
+{-682, -107, -8}, //122
+{-583, -121, -8}, //123
+{-484, -135, -8}, //124
+{-484, -135, -17}, //125
+{-460, -142, -17}, //126
+{-436, -149, -17}, //127
+{-412, -156, -17}, //128
+{-388, -164, -17}, //129
+{-340, -178, -17}, //130
+{-292, -193, -17}, //131
+{-245, -208, -17}, //132
+{-197, -222, -17}, //133
+{-197, -222, -8}, //134
+{-147, -229, -8}, //135
+{-127, -232, -8}, //136
+{-108, -235, -8}, //137
+{-88, -238, -8}, //138
+{-68, -240, -8}, //139
+};
 
 #define STEPS_ROUTE_D 1
 static const RouteStep RouteStepsD[STEPS_ROUTE_D] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesD[STEPS_ROUTE_D] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 #define STEPS_ROUTE_E 1
 static const RouteStep RouteStepsE[STEPS_ROUTE_E] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesE[STEPS_ROUTE_E] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 #define STEPS_ROUTE_F 1
 static const RouteStep RouteStepsF[STEPS_ROUTE_F] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesF[STEPS_ROUTE_F] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 #define STEPS_ROUTE_G 1
 static const RouteStep RouteStepsG[STEPS_ROUTE_G] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesG[STEPS_ROUTE_G] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 #define STEPS_ROUTE_H 1
 static const RouteStep RouteStepsH[STEPS_ROUTE_H] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesH[STEPS_ROUTE_H] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 #define STEPS_ROUTE_I 1
 static const RouteStep RouteStepsI[STEPS_ROUTE_I] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesI[STEPS_ROUTE_I] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 #define STEPS_ROUTE_J 1
 static const RouteStep RouteStepsJ[STEPS_ROUTE_J] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesJ[STEPS_ROUTE_J] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 #define STEPS_ROUTE_K 1
 static const RouteStep RouteStepsK[STEPS_ROUTE_K] = {
-{NORM_NOMAGNET, 1, 0, 100, 100, R_REV, L_REV, TH_OFF, 0, dMAGNET_NO_CORRECTION}
+//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}
+//0
+{NORM_NOMAGNET, R_REV, L_REV, TH_OFF, 1, 0, 100, 100, 0, dROUTE_MAGNET_NONE},
+};
+static const RoutePose RoutePosesK[STEPS_ROUTE_K] = {
+//{X, Y, Heading} at the end of step
+{-1, 0, 0}, //0
 };
 
 
 static const RouteData Routes[Route_NumOf]   = 
     {
-     [RouteA] = {.ID = RouteA, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_A, .Step = &RouteStepsA[0]},
-     [RouteB] = {.ID = RouteB, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_B, .Step = &RouteStepsB[0]},
-     [RouteC] = {.ID = RouteC, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_C, .Step = &RouteStepsC[0]},
-     [RouteD] = {.ID = RouteD, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_D, .Step = &RouteStepsD[0]},
-     [RouteE] = {.ID = RouteE, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_E, .Step = &RouteStepsE[0]},
-     [RouteF] = {.ID = RouteF, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_F, .Step = &RouteStepsF[0]},
-     [RouteG] = {.ID = RouteG, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_G, .Step = &RouteStepsG[0]},
-     [RouteH] = {.ID = RouteH, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_H, .Step = &RouteStepsH[0]},
-     [RouteI] = {.ID = RouteI, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_I, .Step = &RouteStepsI[0]},
-     [RouteJ] = {.ID = RouteJ, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_J, .Step = &RouteStepsJ[0]},
-     [RouteK] = {.ID = RouteK, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_K, .Step = &RouteStepsK[0]},
-
+     [RouteA] = {.ID = RouteA, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_A, .Step = &RouteStepsA[0], .Pose = &RoutePosesA[0]},
+     [RouteB] = {.ID = RouteB, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_B, .Step = &RouteStepsB[0], .Pose = &RoutePosesB[0]},
+     [RouteC] = {.ID = RouteC, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_C, .Step = &RouteStepsC[0], .Pose = &RoutePosesC[0]},
+     [RouteD] = {.ID = RouteD, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_D, .Step = &RouteStepsD[0], .Pose = &RoutePosesD[0]},
+     [RouteE] = {.ID = RouteE, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_E, .Step = &RouteStepsE[0], .Pose = &RoutePosesE[0]},
+     [RouteF] = {.ID = RouteF, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_F, .Step = &RouteStepsF[0], .Pose = &RoutePosesF[0]},
+     [RouteG] = {.ID = RouteG, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_G, .Step = &RouteStepsG[0], .Pose = &RoutePosesG[0]},
+     [RouteH] = {.ID = RouteH, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_H, .Step = &RouteStepsH[0], .Pose = &RoutePosesH[0]},
+     [RouteI] = {.ID = RouteI, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_I, .Step = &RouteStepsI[0], .Pose = &RoutePosesI[0]},
+     [RouteJ] = {.ID = RouteJ, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_J, .Step = &RouteStepsJ[0], .Pose = &RoutePosesJ[0]},
+     [RouteK] = {.ID = RouteK, .RepeatCount = 1, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_K, .Step = &RouteStepsK[0], .Pose = &RoutePosesK[0]},
     };
 
-RouteData dummy2;
-
 void Route_SetRoutePointer(RouteData* Data ,Route_ID RouteSelected, uint8_t Offset){
     memcpy(Data, &Routes[RouteSelected], sizeof(RouteData));
     Data->Step += Offset; /* no 0 step on display, but here steps are from 0 */
+    Data->Pose += Offset;
     Data->CurrentStepCount = Offset;
 }
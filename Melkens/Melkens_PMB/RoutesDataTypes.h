@@ -10,18 +10,11 @@
 #define TH_ON 1
 #define TH_OFF 0
 
-#define dMAGNET_NO_CORRECTION 255.0
-#define dMAGNET_R5 5*2.17
-#define dMAGNET_R10 10*2.17
-#define dMAGNET_L5 -5*2.17
-#define dMAGNET_L10 -10*2.17
-#define dMAGNET_MID 0
-#define dMAGNET_L1 -1*2.17
-#define dMAGNET_L2 -2*2.17
-#define dMAGNET_L3 -3*2.17
-#define dMAGNET_L4 -4*2.17
-#define dMAGNET_L6 -6*2.17
-#define dMAGNET_L7 -7*2.17
+/* RouteStep.MagnetCorrection when magnet correction is not used in step */
+#define dROUTE_MAGNET_NONE INT16_MAX
+/* RouteStep.MagnetCorrection units [0.1mm] in one cm */
+#define dROUTE_MAGNET_UNITS_PER_CM 100
+#define RouteStep_HasMagnetCorrection(Step) ((Step)->MagnetCorrection != dROUTE_MAGNET_NONE)
 
 
 
@@ -51,25 +44,34 @@ typedef enum Route_ID_t{
     Route_NumOf        
 }Route_ID;
 
+/* Route tables (Routes.c) are generated by Tools/RouteCompiler from Routes/ */
 typedef struct RouteStep_t{
     uint8_t OperationType;  /* MODE */
-    uint16_t dX;            /* X coord change */
-    uint16_t dY;            /* Y coord change */
-    uint16_t RightSpeed;    /* Left wheel speed */
-    uint16_t LeftSpeed;     /* Right wheel speed */
     uint8_t DirectionRight; /* Wheel spin direction */
     uint8_t DirectionLeft;  /* Wheel spin direction */
     uint8_t ThumbleEnabled; /* Enable/Disable flag for thumble motor */
-    float  Angle;
-    float MagnetCorrection;   /* Correction of angle when magnet bar detection is not in the middle */
+    uint16_t dX;            /* X coord change */
+    uint16_t dY;            /* Y coord change */
+    uint16_t RightSpeed;    /* Right wheel speed */
+    uint16_t LeftSpeed;     /* Left wheel speed */
+    int16_t Angle;          /* Turn angle [deg] */
+    int16_t MagnetCorrection;   /* Expected magnet bar position [0.1mm], dROUTE_MAGNET_NONE if not used */
 } RouteStep;
 
+/* Route position at the end of step, relative to the route start */
+typedef struct RoutePose_t{
+    int16_t X;              /* [cm] along start heading */
+    int16_t Y;              /* [cm] to the right of start heading */
+    int16_t Heading;        /* [deg] clockwise, as DesiredAngle */
+} RoutePose;
+
 typedef struct RouteData_t{
     Route_ID ID;
     uint8_t RepeatCount;
     uint8_t StepCount;
     uint8_t CurrentStepCount;
     const RouteStep* Step;
+    const RoutePose* Pose;  /* pose of Step */
 }RouteData;
 
 void Route_SetRoutePointer(RouteData* Data ,Route_ID RouteSelected, uint8_t Offset);
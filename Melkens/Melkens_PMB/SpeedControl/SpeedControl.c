@@ -0,0 +1,108 @@
+/*
+ * SpeedControl.c
+ *
+ * Integral is kept in Q15 RPM, so small Ki still integrates errors of a few
+ * RPM. It is only taken over when the new command is not saturated in the
+ * direction of the error (conditional integration).
+ */
+#include "SpeedControl.h"
+
+static int16_t SpeedControl_Limit(int32_t Value, int16_t Limit)
+{
+    if (Value > Limit) {
+        return Limit;
+    }
+    if (Value < -Limit) {
+        return (int16_t)-Limit;
+    }
+    return (int16_t)Value;
+}
+
+static uint16_t SpeedControl_Command(uint16_t FeedForward, int32_t Trim, bool *IsSaturatedHigh, bool *IsSaturatedLow)
+{
+    int32_t Command = (int32_t)FeedForward + Trim;
+
+    *IsSaturatedHigh = (Command > (int32_t)dSPEED_CONTROL_MAX_SPEED);
+    *IsSaturatedLow = (Command < 0);
+    if (*IsSaturatedHigh) {
+        return dSPEED_CONTROL_MAX_SPEED;
+    }
+    if (*IsSaturatedLow) {
+        return 0u;
+    }
+    return (uint16_t)Command;
+}
+
+void SpeedControl_Reset(SpeedController *Controller)
+{
+    Controller->Integral = 0;
+    Controller->Trim = 0;
+    Controller->PrevMeasured = 0;
+    Controller->IsStarted = false;
+}
+
+uint16_t SpeedControl_Update(SpeedController *Controller, const SpeedControlGains *Gains,
+                             uint16_t Setpoint, uint16_t Measured)
+{
+    int16_t Limit = (int16_t)Gains->TrimLimit;
+    int16_t Error;
+    int16_t Derivative = 0;
+    int32_t Integral;
+    int32_t Trim;
+    uint16_t FeedForward;
+    uint16_t Command;
+    bool IsSaturatedHigh, IsSaturatedLow;
+
+    if (Setpoint == 0u) {
+        SpeedControl_Reset(Controller);
+        return 0u;
+    }
+    if (Setpoint > dSPEED_CONTROL_MAX_SPEED) {
+        Setpoint = dSPEED_CONTROL_MAX_SPEED;
+    }
+    if (Measured > dSPEED_CONTROL_MAX_SPEED * 2u) {
+        Measured = dSPEED_CONTROL_MAX_SPEED * 2u;
+    }
+
+    Error = (int16_t)Setpoint - (int16_t)Measured;
+    if (Controller->IsStarted) {
+        Derivative = (int16_t)Measured - (int16_t)Controller->PrevMeasured;
+    }
+    Controller->PrevMeasured = Measured;
+    Controller->IsStarted = true;
+
+    Integral = Controller->Integral + (int32_t)Gains->Ki * Error;
+    if (Integral > ((int32_t)Limit << 15)) {
+        Integral = (int32_t)Limit << 15;
+    }
+    else if (Integral < -((int32_t)Limit << 15)) {
+        Integral = -((int32_t)Limit << 15);
+    }
+
+    FeedForward = FixedPoint_ScaleU16Q15(Setpoint, Gains->Kff);
+    Trim = (int32_t)FixedPoint_Q15Mul(Gains->Kp, Error) + (Integral >> 15) - FixedPoint_Q15Mul(Gains->Kd, Derivative);
+    Command = SpeedControl_Command(FeedForward, SpeedControl_Limit(Trim, Limit), &IsSaturatedHigh, &IsSaturatedLow);
+
+    IsSaturatedHigh |= (Trim > Limit);
+    IsSaturatedLow |= (Trim < -Limit);
+    if (!((IsSaturatedHigh && Error > 0) || (IsSaturatedLow && Error < 0))) {
+        Controller->Integral = Integral;
+    }
+    Controller->Trim = SpeedControl_Limit(Trim, Limit);
+    return Command;
+}
+
+uint16_t SpeedControl_GetCommand(const SpeedController *Controller, const SpeedControlGains *Gains,
+                                 uint16_t Setpoint)
+{
+    bool IsSaturatedHigh, IsSaturatedLow;
+
+    if (Setpoint == 0u) {
+        return 0u;
+    }
+    if (Setpoint > dSPEED_CONTROL_MAX_SPEED) {
+        Setpoint = dSPEED_CONTROL_MAX_SPEED;
+    }
+    return SpeedControl_Command(FixedPoint_ScaleU16Q15(Setpoint, Gains->Kff), Controller->Trim,
+                                &IsSaturatedHigh, &IsSaturatedLow);
+}
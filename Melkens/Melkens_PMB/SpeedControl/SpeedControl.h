@@ -0,0 +1,68 @@
+/*
+ * File:   SpeedControl.h
+ *
+ * Wheel speed loop around the inverters. Inverters hold the commanded speed
+ * only as well as their own loop and the load allow, so each wheel drifts
+ * differently and the difference was corrected only through heading error.
+ * Speed measured from encoder positions polled over CAN is compared with
+ * the setpoint (MotorManager_SetSpeed) every dSPEED_CONTROL_PERIOD and the
+ * command sent is feed-forward of the setpoint plus a PI(D) trim:
+ *
+ *   Command = Kff * Setpoint + Kp * e + Ki * sum(e) - Kd * d(Measured)
+ *
+ * Derivative is taken from the measurement, a setpoint change gives no kick.
+ * The trim is limited to TrimLimit and integration stops while the command
+ * is saturated (anti-windup). Gains are Q15, so each is below 1 per RPM.
+ * Tools/SpeedControl builds this file on the host against a motor model.
+ */
+
+#ifndef SPEEDCONTROL_H
+#define	SPEEDCONTROL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Tools/FixedPoint.h"
+
+#define dSPEED_CONTROL_PERIOD       10u         /* [ms] every wheel position is polled once in 10 ms */
+#define dSPEED_CONTROL_MAX_SPEED    3000u       /* [RPM] highest command sent to wheel inverters */
+#define dSPEED_CONTROL_DEADBAND     2u          /* [RPM] smaller command changes are not sent */
+
+#define dSPEED_CONTROL_KP           dQ15(0.3)
+#define dSPEED_CONTROL_KI           dQ15(0.04)  /* per control period */
+#define dSPEED_CONTROL_KD           dQ15(0.0)
+#define dSPEED_CONTROL_KFF          dQ15_ONE
+#define dSPEED_CONTROL_TRIM_LIMIT   300u        /* [RPM] */
+
+typedef struct SpeedControlGains_t{
+    q15_t Kp;
+    q15_t Ki;
+    q15_t Kd;
+    q15_t Kff;
+    uint16_t TrimLimit;
+}SpeedControlGains;
+
+typedef struct SpeedController_t{
+    int32_t Integral;       /* [RPM] Q15 */
+    int16_t Trim;           /* [RPM] correction on top of feed-forward */
+    uint16_t PrevMeasured;  /* [RPM] */
+    bool IsStarted;
+}SpeedController;
+
+void SpeedControl_Reset(SpeedController *Controller);
+/* Once per dSPEED_CONTROL_PERIOD, returns command [RPM] for the inverter.
+ * Setpoint 0 resets the controller. */
+uint16_t SpeedControl_Update(SpeedController *Controller, const SpeedControlGains *Gains,
+                             uint16_t Setpoint, uint16_t Measured);
+/* Command for a new setpoint between updates, current trim applied */
+uint16_t SpeedControl_GetCommand(const SpeedController *Controller, const SpeedControlGains *Gains,
+                                 uint16_t Setpoint);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SPEEDCONTROL_H */
@@ -31,6 +31,10 @@ typedef struct TimeManager
    bool ReloadTick;
    TimeManager_Flags_t TemporaryFlags;
    TimeManager_Flags_t CalculatedFlags;
+   uint32_t SystemTick;
+   uint8_t TicksSinceUpdate;
+   uint8_t LastLoopTicks;
+   uint16_t MissedTicks;
 } TimeManager_t;
 
 static TimeManager_t TimeManager;
@@ -41,6 +45,10 @@ void TimeManager_Init(void)
 	TimeManager.TickCount = 0;
 	TimeManager.TemporaryFlags.FlagsRegister = 0;
 	TimeManager.CalculatedFlags.FlagsRegister = 0;
+	TimeManager.SystemTick = 0;
+	TimeManager.TicksSinceUpdate = 0;
+	TimeManager.LastLoopTicks = 0;
+	TimeManager.MissedTicks = 0;
 
 	/* TBD: Here SYSTICK should be started */
 }
@@ -54,6 +62,10 @@ void TimeManager_SYSTICK_Handler( void )
 {
 
 	TimeManager.TickCount++;
+	TimeManager.SystemTick++;
+	if (TimeManager.TicksSinceUpdate < UINT8_MAX){
+		TimeManager.TicksSinceUpdate++;
+	}
 	TimeManager.TemporaryFlags.Bits.Flag1ms = 1;
 
 	if (0 == (TimeManager.TickCount % 10)){
@@ -80,6 +92,19 @@ void TimeManager_UpdateFlags(void)
 
 	TimeManager.CalculatedFlags = TimeManager.TemporaryFlags;
 	TimeManager.TemporaryFlags.FlagsRegister = 0;
+
+	/* More than one tick since last update means 1ms slot(s) were skipped */
+	TimeManager.LastLoopTicks = TimeManager.TicksSinceUpdate;
+	if (TimeManager.TicksSinceUpdate > 1){
+		uint16_t Missed = TimeManager.TicksSinceUpdate - 1;
+		if (TimeManager.MissedTicks > (UINT16_MAX - Missed)){
+			TimeManager.MissedTicks = UINT16_MAX;
+		}
+		else{
+			TimeManager.MissedTicks += Missed;
+		}
+	}
+	TimeManager.TicksSinceUpdate = 0;
     //INTERRUPT_GlobalEnable();
 }
 
@@ -102,3 +127,52 @@ bool TimeManager_Is1sPassed(void)
 {
 	return TimeManager.CalculatedFlags.Bits.Flag1s;
 }
+
+uint32_t TimeManager_GetSystemTick(void)
+{
+	uint32_t Tick;
+
+	/* 32-bit read is not atomic on dsPIC, repeat if SYSTICK hit in between */
+	do{
+		Tick = TimeManager.SystemTick;
+	}while (Tick != TimeManager.SystemTick);
+
+	return Tick;
+}
+
+uint32_t TimeManager_GetMicros(void)
+{
+	volatile uint32_t* SystemTick = &TimeManager.SystemTick;
+	uint32_t Period = (uint32_t)PR1 + 1;
+	uint32_t Tick;
+	uint32_t Counter;
+	bool IsTickPending;
+
+	do{
+		Tick = *SystemTick;
+		Counter = TMR1;
+		IsTickPending = IFS0bits.T1IF;
+	}while (Tick != *SystemTick);
+
+	/* TMR1 already rolled over but its interrupt not serviced yet */
+	if (IsTickPending && (Counter < (Period / 2))){
+		Tick++;
+	}
+
+	return (Tick * 1000) + ((Counter * 1000) / Period);
+}
+
+uint16_t TimeManager_GetMissedTicks(void)
+{
+	return TimeManager.MissedTicks;
+}
+
+uint8_t TimeManager_GetLastLoopTicks(void)
+{
+	return TimeManager.LastLoopTicks;
+}
+
+void TimeManager_ResetMissedTicks(void)
+{
+	TimeManager.MissedTicks = 0;
+}
@@ -13,6 +13,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 
 void TimeManager_Init(void);
 void TimeManager_DeInit(void);
@@ -25,6 +26,16 @@ bool TimeManager_Is100msPassed(void);
 bool TimeManager_Is1sPassed(void);
 bool TimeManager_IsTickReloaded(void);
 
+/* Free running 1ms tick, not reset every second like TickCount */
+uint32_t TimeManager_GetSystemTick(void);
+/* Free running [us] time from 1ms tick and TMR1 counter, for time sync and latency traces */
+uint32_t TimeManager_GetMicros(void);
+/* Ticks lost because main loop took longer than 1ms (cumulative) */
+uint16_t TimeManager_GetMissedTicks(void);
+/* Number of SYSTICKs seen by the last TimeManager_UpdateFlags call */
+uint8_t TimeManager_GetLastLoopTicks(void);
+void TimeManager_ResetMissedTicks(void);
+
 
 
 #ifdef	__cplusplus
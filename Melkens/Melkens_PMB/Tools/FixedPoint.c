@@ -0,0 +1,146 @@
+#include "FixedPoint.h"
+
+#if defined(__XC16__)
+#include <xc.h>
+#define FIXED_MULSS(A, B)           __builtin_mulss((A), (B))
+#define FIXED_MULSU(A, B)           __builtin_mulsu((A), (B))
+#define FIXED_MULUS(A, B)           __builtin_mulus((A), (B))
+#define FIXED_MULUU(A, B)           __builtin_muluu((A), (B))
+#define FIXED_DIVUD(Num, Den)       __builtin_divud((Num), (Den))
+#define FIXED_DIVMODUD(Num, Den, Rem) __builtin_divmodud((Num), (Den), (Rem))
+#else
+#define FIXED_MULSS(A, B)           ((int32_t)(int16_t)(A) * (int16_t)(B))
+#define FIXED_MULSU(A, B)           ((int32_t)(int16_t)(A) * (int32_t)(uint16_t)(B))
+#define FIXED_MULUS(A, B)           ((int32_t)(uint16_t)(A) * (int32_t)(int16_t)(B))
+#define FIXED_MULUU(A, B)           ((uint32_t)(uint16_t)(A) * (uint16_t)(B))
+#define FIXED_DIVUD(Num, Den)       ((uint16_t)((uint32_t)(Num) / (uint16_t)(Den)))
+static uint16_t FixedPoint_DivModUD(uint32_t Num, uint16_t Den, uint16_t *Rem){
+    *Rem = (uint16_t)(Num % Den);
+    return (uint16_t)(Num / Den);
+}
+#define FIXED_DIVMODUD(Num, Den, Rem) FixedPoint_DivModUD((Num), (Den), (Rem))
+#endif
+
+q15_t FixedPoint_Q15Mul(q15_t A, q15_t B)
+{
+    int32_t Product;
+
+    Product = FIXED_MULSS(A, B) >> 15;
+    /* -1 * -1 is the only case out of range */
+    if(Product > dQ15_ONE){
+        Product = dQ15_ONE;
+    }
+    return (q15_t)Product;
+}
+
+uint16_t FixedPoint_ScaleU16Q15(uint16_t Value, q15_t Factor)
+{
+    int32_t Product;
+
+    if(Factor <= 0){
+        return 0;
+    }
+    /* Rounded, so that dQ15_ONE keeps the value unchanged */
+    Product = FIXED_MULUS(Value, Factor) + 0x4000L;
+    return (uint16_t)(Product >> 15);
+}
+
+q16_t FixedPoint_Q16Mul(q16_t A, q16_t B)
+{
+    int16_t AHigh = (int16_t)(A >> 16);
+    uint16_t ALow = (uint16_t)A;
+    int16_t BHigh = (int16_t)(B >> 16);
+    uint16_t BLow = (uint16_t)B;
+    uint32_t Result;
+
+    /* 32x32 product built from four 16x16 hardware multiplications,
+     * low word of the 64 bit result is dropped */
+    Result = (uint32_t)FIXED_MULSS(AHigh, BHigh) << 16;
+    Result += (uint32_t)FIXED_MULSU(AHigh, BLow);
+    Result += (uint32_t)FIXED_MULUS(ALow, BHigh);
+    Result += FIXED_MULUU(ALow, BLow) >> 16;
+
+    return (q16_t)Result;
+}
+
+q16_t FixedPoint_Q16Div(int32_t Num, uint16_t Den)
+{
+    uint32_t Magnitude;
+    uint16_t Integer;
+    uint16_t Remainder;
+    uint16_t Fraction;
+    q16_t Result;
+
+    Magnitude = (Num < 0) ? (0u - (uint32_t)Num) : (uint32_t)Num;
+
+    /* Integer part has to fit in 15 bits */
+    if((Den == 0u) || ((Magnitude >> 15) >= Den)){
+        return (Num < 0) ? dQ16_MIN : dQ16_MAX;
+    }
+
+    /* Two 32/16 hardware divisions, integer part then fraction */
+    Integer = FIXED_DIVMODUD(Magnitude, Den, &Remainder);
+    Fraction = FIXED_DIVUD((uint32_t)Remainder << 16, Den);
+
+    Result = ((q16_t)Integer << 16) | Fraction;
+    return (Num < 0) ? -Result : Result;
+}
+
+q16_t FixedPoint_Q16DivQ16(q16_t Num, q16_t Den)
+{
+    uint32_t Divisor;
+    int32_t Dividend = Num;
+    q16_t Result;
+
+    Divisor = (Den < 0) ? (0u - (uint32_t)Den) : (uint32_t)Den;
+
+    /* Ratio does not depend on common scale, drop low bits of both */
+    while(Divisor > 0xFFFFu){
+        Divisor >>= 1;
+        Dividend >>= 1;
+    }
+
+    Result = FixedPoint_Q16Div(Dividend, (uint16_t)Divisor);
+    if(Den < 0){
+        Result = (Result == dQ16_MIN) ? dQ16_MAX : -Result;
+    }
+    return Result;
+}
+
+q16_t FixedPoint_Q16Abs(q16_t Value)
+{
+    if(Value < 0){
+        return (Value == dQ16_MIN) ? dQ16_MAX : -Value;
+    }
+    return Value;
+}
+
+uint16_t FixedPoint_ScaleU16(uint16_t Value, q16_t Factor)
+{
+    uint32_t Product;
+
+    if(Factor <= 0){
+        return 0;
+    }
+
+    Product = FIXED_MULUU(Value, (uint16_t)(Factor >> 16));
+    Product += FIXED_MULUU(Value, (uint16_t)Factor) >> 16;
+
+    if(Product > 0xFFFFu){
+        Product = 0xFFFFu;
+    }
+    return (uint16_t)Product;
+}
+
+q16_t FixedPoint_Q16FromFloat(float Value)
+{
+    float Scaled = Value * 65536.0f;
+
+    if(Scaled >= 2147483647.0f){
+        return dQ16_MAX;
+    }
+    if(Scaled <= -2147483648.0f){
+        return dQ16_MIN;
+    }
+    return (q16_t)((Scaled >= 0.0f) ? (Scaled + 0.5f) : (Scaled - 0.5f));
+}
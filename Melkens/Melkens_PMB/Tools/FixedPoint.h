@@ -0,0 +1,58 @@
+/*
+ * File:   FixedPoint.h
+ *
+ * Q15 and Q16.16 fixed point helpers. dsPIC33CK has no FPU, every float
+ * operation is a library call, so periodic calculations (route step
+ * progress, angle correction, speed scaling) are done with these instead.
+ * On XC16 the multiplications and divisions map to the DSP engine
+ * MUL/DIV instructions, other compilers use plain C.
+ */
+
+#ifndef FIXEDPOINT_H
+#define	FIXEDPOINT_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef int16_t q15_t;      /* 1.15, range <-1, 1) */
+typedef int32_t q16_t;      /* 16.16, range <-32768, 32768) */
+
+#define dQ15_ONE            ((q15_t)0x7FFF)
+#define dQ16_ONE            ((q16_t)0x00010000L)
+#define dQ16_MAX            ((q16_t)0x7FFFFFFFL)
+#define dQ16_MIN            ((q16_t)(-0x7FFFFFFFL - 1))
+
+/* Compile time conversion of constants, do not use with run time values */
+#define dQ15(Value)         ((q15_t)((Value) * 32768.0 + (((Value) >= 0) ? 0.5 : -0.5)))
+#define dQ16(Value)         ((q16_t)((Value) * 65536.0 + (((Value) >= 0) ? 0.5 : -0.5)))
+
+#define dQ16_FROM_INT(Value)    ((q16_t)(Value) * dQ16_ONE)
+/* Rounds towards minus infinity, same as arithmetic shift */
+#define dQ16_TO_INT(Value)      ((int32_t)((Value) >> 16))
+
+/* Q15 x Q15 -> Q15 */
+q15_t FixedPoint_Q15Mul(q15_t A, q15_t B);
+/* Unsigned value scaled by Q15 factor, rounded. Factor <= 0 returns 0 */
+uint16_t FixedPoint_ScaleU16Q15(uint16_t Value, q15_t Factor);
+
+/* Q16 x Q16 -> Q16. With one integer operand the result is integer */
+q16_t FixedPoint_Q16Mul(q16_t A, q16_t B);
+/* Integer Num / Den as Q16, saturated. Den == 0 saturates with sign of Num */
+q16_t FixedPoint_Q16Div(int32_t Num, uint16_t Den);
+/* Q16 / Q16 -> Q16, Den is normalised to 16 bits before division */
+q16_t FixedPoint_Q16DivQ16(q16_t Num, q16_t Den);
+q16_t FixedPoint_Q16Abs(q16_t Value);
+/* Unsigned value scaled by Q16 factor, truncated and saturated to uint16 */
+uint16_t FixedPoint_ScaleU16(uint16_t Value, q16_t Factor);
+/* Conversion for values that change once per route step, not for periodic code */
+q16_t FixedPoint_Q16FromFloat(float Value);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FIXEDPOINT_H */
+
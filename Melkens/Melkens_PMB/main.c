@@ -67,9 +67,68 @@
 #include "pmb_RouteManager.h"
 #include "pmb_System.h"
 #include "pmb_Scheduler.h"
+#include "Profiler/Profiler.h"
+#include "Melkens_Lib/TaskScheduler/TaskScheduler.h"
+#include "Melkens_Lib/CRC16/CRC16.h"
 
 volatile uint8_t Counter500ms = 10;
 
+static void Main_Perform100ms(void);
+static void Main_Perform1s(void);
+
+/*
+ * 100ms tasks used to fire in the same tick as the 1ms and 10ms ones which
+ * gave a latency spike every 100ms. Phase offsets below spread them over
+ * separate ticks. Order in the table is the execution order within a tick.
+ */
+static const Task MainTasks[] = {
+    /* Function                     Period  Phase   Budget                          Policy */
+    { System_Perform1ms,            1,      0,      dPROFILER_US_TO_COUNTS(100),    TaskPolicy_Skip, 0 },
+    { DriveIndicator_1msPerform,    1,      0,      dPROFILER_US_TO_COUNTS(50),     TaskPolicy_Skip, 0 },
+    //RouteManager_Perform1ms
+    { IMUHandler_Perform1ms,        1,      0,      dPROFILER_US_TO_COUNTS(200),    TaskPolicy_Skip, 0 },
+    { MotorManager_Perform1ms,      1,      0,      dPROFILER_US_TO_COUNTS(200),    TaskPolicy_Skip, 0 },
+    { CAN_Polling,                  1,      0,      dPROFILER_US_TO_COUNTS(150),    TaskPolicy_Skip, 0 },
+    //RouteManager_SendCurrentRouteStep, Read_Data_Display, Display_SendData
+    { Read_Data_Keyboard,           10,     5,      dPROFILER_US_TO_COUNTS(100),    TaskPolicy_Skip, 0 },
+    //RouteManager_Perform100ms
+    /* ADC is sampled continuously from TMR1 interrupt, see AnalogHandler */
+    { CalculateAnalogRealValues,    100,    13,     dPROFILER_US_TO_COUNTS(200),    TaskPolicy_Skip, 0 },
+    { BatteryManager_Perform100ms,  100,    17,     dPROFILER_US_TO_COUNTS(100),    TaskPolicy_Skip, 0 },
+    { MotorManager_Perform100ms,    100,    33,     dPROFILER_US_TO_COUNTS(300),    TaskPolicy_Skip, 0 },
+    { Diagnostics_Perform100ms,     100,    53,     dPROFILER_US_TO_COUNTS(100),    TaskPolicy_Skip, 0 },
+    { Main_Perform100ms,            100,    73,     dPROFILER_US_TO_COUNTS(50),     TaskPolicy_Skip, 0 },
+    { Main_Perform1s,               1000,   507,    0,                              TaskPolicy_Skip, 0 },
+};
+
+#define MAIN_TASKS_NUM (sizeof(MainTasks) / sizeof(MainTasks[0]))
+
+static TaskControl MainTasksControl[MAIN_TASKS_NUM];
+static TaskScheduler MainScheduler;
+
+static void Main_Perform100ms(void)
+{
+    if( !MotorManager_IsMotorEnabled(Motor_Thumble)){
+        IMUHandler_SetThumbleCurrent(0);
+    }
+    IMUHandler_SetTaskMisses(TaskScheduler_GetMissCount(&MainScheduler));
+
+    if(Counter500ms == 0){
+        //LED2_Toggle();
+        Counter500ms = 5;
+    }
+    else{
+        Counter500ms -= 1;
+    }
+}
+
+static void Main_Perform1s(void)
+{
+    //Scheduler_Perform1s();
+    Profiler_Perform1s();
+    //LED2_Toggle();
+}
+
 int main(void)
 {
     SYSTEM_Initialize();
@@ -84,12 +143,14 @@ int main(void)
 
     
     TimeManager_Init();
+    CRC16_Init();
     IMUHandler_Init();
     AnalogHandler_Init();
     MotorManager_Initialise();
     DriveIndicator_Init();
     BatteryManager_ResetBattery(); 
     Scheduler_Init();
+    Profiler_Init();
     #if COMPILE_SWITCH_MOONION 
 
     DBG1_SetLow();
@@ -116,55 +177,27 @@ int main(void)
     
     System_PowerRailRequestSequence(Sequence_PowerStageOn);//enable power
     
+    TaskScheduler_Init(&MainScheduler, MainTasks, MainTasksControl, MAIN_TASKS_NUM, Profiler_TimeSource, TimeManager_GetSystemTick());
+    
     while (1){
+        Profiler_BeginLoop();
         if(TimeManager_Is1msPassed()){
-            System_Perform1ms();
-            DriveIndicator_1msPerform();
-            //RouteManager_Perform1ms();
-            IMUHandler_Perform1ms();
-            
-            MotorManager_Perform1ms();
-            CAN_Polling();
-        }
-        if(TimeManager_Is10msPassed()){
-            //RouteManager_SendCurrentRouteStep();
-            Read_Data_Keyboard();
-            //Read_Data_Display();
-            //Display_SendData();
-        }
-     
-        if(TimeManager_Is100msPassed()){
-            BatteryManager_Perform100ms();
-            //RouteManager_Perform100ms();
-            MotorManager_Perform100ms();
-            AnalogHandler_Perform100ms();
-            Diagnostics_Perform100ms();
-            CalculateAnalogRealValues(); 
-            if( !MotorManager_IsMotorEnabled(Motor_Thumble)){
-                IMUHandler_SetThumbleCurrent(0);
-            }
-            if(Counter500ms == 0){
-                //LED2_Toggle();
-                Counter500ms = 5;
-            }
-            else{
-                Counter500ms -= 1;
-            }
-        }
-        
-        if(TimeManager_Is1sPassed()){
-            //Scheduler_Perform1s();
-            //LED2_Toggle();
+            /* Periodic tasks, see MainTasks table for periods and phase offsets */
+            TaskScheduler_Perform(&MainScheduler, TimeManager_GetSystemTick());
+            Profiler_Checkpoint(Profiler_ScheduledTasks);
         }
+
         /* Route and motor state machines */    
         //RouteManager_StateMachine();
         MotorManager_StateMachine();
         MotorManager_PerformAfterMainLoop();
+        Profiler_Checkpoint(Profiler_StateMachines);
 
         /* Clear display and keyboard events after all states machine handles it */
         //Display_ClearEvent();
         Keyboard_ClearEvent();
         Remote_ClearEvent();
+        Profiler_EndLoop();
 
         INTERRUPT_GlobalDisable();
 	    TimeManager_UpdateFlags();
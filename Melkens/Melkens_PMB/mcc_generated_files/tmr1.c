@@ -54,6 +54,7 @@
 #include "can_types.h"
 #include "../pmb_CAN.h"
 #include "../TimeManager/TimeManager.h"
+#include "../AnalogHandler/AnalogHandler.h"
 #include "../pmb_System.h"
 
 volatile uint8_t PowerStagesEn;
@@ -168,6 +169,7 @@ void __attribute__ ((weak)) TMR1_CallBack(void)
     
     //***User Area Begin
     TimeManager_SYSTICK_Handler();
+    AnalogHandler_SYSTICK_Handler();
     // ticker function call;
     // ticker is 1 -> Callback function gets called everytime this ISR executes
     tmr1_obj.count++;
@@ -27,6 +27,7 @@
 #include "IMUHandler/IMUHandler.h"
 #include "AnalogHandler/AnalogHandler.h"
 #include "Tools/Tools.h"
+#include "Tools/FixedPoint.h"
 #include "pmb_Scheduler.h"
 #include "RoutesDataTypes.h"
 #include "pmb_Settings.h"
@@ -49,7 +50,7 @@ extern int32_t CalulatedAngle;
 extern RouteData CurrentRoute; 
 int32_t AngleS;
 int16_t TestAngle;
-float ImportAngle;
+q16_t ImportAngle;
 uint16_t AngleInt;
 uint16_t AngleFraction;
 uint8_t AngleSign;
@@ -59,7 +60,7 @@ bool ActiveMagnets[32];
 
 const uint16_t DotPicPosition[32] = {9,43,75,108,141,173,205,239,272, 305, 338, 371, 404, 437, 469, 503, 536, 569, 602, 634, 667, 700, 733, 766, 798, 832, 865, 898, 930, 964, 996};
 
-void floatToUint16(float num, uint16_t *integerPart, uint16_t *decimalPart, uint8_t *sign);
+void q16ToUint16(q16_t num, uint16_t *integerPart, uint16_t *decimalPart, uint8_t *sign);
 void UpdateSchedulerDisplay(void);
 
 uint16_t BateryVoltage, RailCurrent;
@@ -487,11 +488,11 @@ void Display_SendData(void){
         }
     }
 
-    ImportAngle = IMUHandler_GetAngle();
+    ImportAngle = IMUHandler_GetAngleQ16();
     
     //Get rotation counts
-    RotR = MotorManager_GetRotationCountPositive(Motor_Right) * dDISTANCE_PER_MOTOR_ROTATION;
-    RotL = MotorManager_GetRotationCountPositive(Motor_Left) * dDISTANCE_PER_MOTOR_ROTATION;
+    RotR = FixedPoint_Q16Mul(MotorManager_GetRotationCountPositive(Motor_Right), dDISTANCE_PER_MOTOR_ROTATION_Q16);
+    RotL = FixedPoint_Q16Mul(MotorManager_GetRotationCountPositive(Motor_Left), dDISTANCE_PER_MOTOR_ROTATION_Q16);
     
     switch(CurrentSendDataStep){
         //1 Left Wheel Set Speed
@@ -628,8 +629,8 @@ void Display_SendData(void){
             break;
             
         case Step_ImuAngle:
-            ImportAngle = IMUHandler_GetAngle();
-            floatToUint16(ImportAngle, &AngleInt, &AngleFraction, &AngleSign);
+            ImportAngle = IMUHandler_GetAngleQ16();
+            q16ToUint16(ImportAngle, &AngleInt, &AngleFraction, &AngleSign);
             memcpy(&TransmitBufferUART2[0], &ImuAngle_ASCII, 7);            
             NumberMessageOffset = Tools_ITOAu16(AngleInt, &TransmitBufferUART2[7]);
             memcpy(&TransmitBufferUART2[7+NumberMessageOffset], &Cmd_End, 3);
@@ -782,23 +783,19 @@ void CalculateAnalogRealValues(void)
     RailCurrent = CalculateCurrent(RealCurrent);
 }
 
-void floatToUint16(float num, uint16_t *integerPart, uint16_t *decimalPart, uint8_t *sign) {
+void q16ToUint16(q16_t num, uint16_t *integerPart, uint16_t *decimalPart, uint8_t *sign) {
     // Determine the sign
     if (num < 0) {
         *sign = 1; // Negative sign
-        num = -num; // Make the number positive for further processing
+        num = FixedPoint_Q16Abs(num); // Make the number positive for further processing
     } else {
         *sign = 2; // Positive sign
     }
 
-    // Split the float into integer and decimal parts
-    float integerFloat = (float)((int)num);
-    float decimalFloat = num - integerFloat;
+    // Integer part is the high word
+    *integerPart = (uint16_t)(num >> 16);
 
-    // Convert the integer part to uint16_t
-    *integerPart = (uint16_t)integerFloat;
-
-    // Convert the decimal part to uint16_t
-    *decimalPart = (uint16_t)(decimalFloat * 10000); // Multiply by 10000 to retain four decimal places
+    // Convert the fraction (low word) to uint16_t
+    *decimalPart = (uint16_t)FixedPoint_ScaleU16(10000, num & 0xFFFF); // Multiply by 10000 to retain four decimal places
 }
 
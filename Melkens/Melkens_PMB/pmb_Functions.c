@@ -41,6 +41,19 @@ float CalculateDegreeFromPi(int32_t Degree){
      }
 }
 
+/* Same as CalculateDegreeFromPi, without float operations */
+q16_t CalculateDegreeFromPiQ16(int32_t Degree){
+    q16_t Angle;
+
+    Angle = FixedPoint_Q16Div(Degree * 180, 3141);
+    if(Angle < 0){
+        return -(Angle + dQ16_FROM_INT(180));
+    }
+    else{
+        return dQ16_FROM_INT(180) - Angle;
+    }
+}
+
 
 void PMB_Initialize(void)
 {
@@ -12,6 +12,8 @@
 extern "C" {
 #endif
 
+#include "Tools/FixedPoint.h"
+
 void EnableCharger(void);
 void EnableCharger(void);
 void DisableCharger(void);
@@ -19,6 +21,7 @@ void ResetCharger(void);
 char DecToHex(int decNum);
 uint8_t HexCharToInt(uint8_t HexChar);
 float CalculateDegreeFromPi(int32_t Degree);
+q16_t CalculateDegreeFromPiQ16(int32_t Degree);
 uint8_t HexIntToChar(uint8_t HexInt);
 uint8_t NumberOfDigits(uint16_t Int);
 
@@ -13,6 +13,7 @@
 #include "mcc_generated_files/can_types.h"
 
 #include "Tools/Timer.h"
+#include "Tools/FixedPoint.h"
 #include "TimeManager/TimeManager.h"
 #include "IMUHandler/IMUHandler.h"
 #include "AnalogHandler/AnalogHandler.h"
@@ -29,6 +30,7 @@
 #include "RoutesDataTypes.h"
 
 #include "BatteryManager/BatteryManager.h"
+#include "EmergencyStop/EmergencyStop.h"
 
 #define dTimer_5ms   5U
 #define dTimer_20ms  20U
@@ -37,6 +39,9 @@
 
 #define INCREASE_SPEED_VALUE  100U
 
+/* Older position reply does not give a speed */
+#define dSPEED_MEASURE_TIMEOUT  50000uL     //[us]
+
 typedef enum DriveType_t{
     Drive_Forward = 0,
     Drive_Backward,
@@ -71,6 +76,11 @@ typedef struct Motor_Parameters_t
     uint32_t Road_Measured;
     uint32_t Road_Saved;
     int16_t Current;
+    uint16_t MeasuredSpeed;     //[RPM] from encoder position change
+    uint32_t InquiryTime;       //[us] position inquiry sent, inverter samples position on reception
+    uint32_t PositionTime;      //[us] InquiryTime of last position reply
+    uint32_t SpeedTime;         //[us] of last reply that gave MeasuredSpeed
+    uint16_t SentSpeed;         //[RPM] in last speed frame, 0 when stopped
 }MotorParameters;
 
 MotorParameters Motor[Motor_NumOf];
@@ -93,6 +103,10 @@ CAN_MSG_OBJ CAN_Motor_Belt1;
 CAN_MSG_OBJ CAN_Motor_Belt2;
 CAN_MSG_OBJ CAN_Tx;
 
+static CAN_MSG_OBJ *const CAN_Motors[Motor_NumOf] = {
+    &CAN_Motor_Left, &CAN_Motor_Right, &CAN_Motor_Thumble, &CAN_Motor_Lift, &CAN_Motor_Belt1, &CAN_Motor_Belt2
+};
+
 uint8_t CAN_Motor_EN[8] = {0x23,0x0D,0x20,0x01,0x00,0x00,0x00,0x00};
 uint8_t CAN_Motor_DN[8] = {0x23,0x0C,0x20,0x01,0x00,0x00,0x00,0x00};
 uint8_t CAN_Motor[8] = {0x23,0x00,0x20,0x01,0x00,0x00,0x00,0x00};
@@ -108,10 +122,22 @@ bool currentSafetyState = false, previousSafetyState = false;
 
 uint16_t Correction_Cnt;
 
+static MotionProfile StepProfile;
+static bool IsStepProfileActive;
+static q15_t StepProfileFactor = dQ15_ONE;
+
+/* Wheel speed loop, index Motor_Left and Motor_Right */
+static SpeedController WheelSpeedControl[2];
+static SpeedControlGains SpeedGains = {
+    dSPEED_CONTROL_KP, dSPEED_CONTROL_KI, dSPEED_CONTROL_KD, dSPEED_CONTROL_KFF, dSPEED_CONTROL_TRIM_LIMIT
+};
+static bool IsSpeedControlEnabled = true;
+static uint8_t SpeedControlTick;
+
 //Variables used for displaying dev data on the display
 uint16_t RWheelSetSpeed = DEFAULT_SPEED, LWheelSetSpeed = DEFAULT_SPEED, AugSetSpeed = DEFAULT_SPEED_THUMBLE;
 uint16_t LastRotL = 0, LastRotR = 0;
-float CurrentAngle2 = 0, StepAngle = 0, PrevStepAngle = 0;
+q16_t CurrentAngle2 = 0, StepAngle = 0, PrevStepAngle = 0;
 int IntStepAngle = 0;
 
 //moover lift end switches variables
@@ -131,6 +157,10 @@ void MotorManager_SetDrive(DriveType Drive);
 void MotorManager_ToggleHigherSpeed(MotorName Mot);
 void MotorManager_HandleRemoteEvent(RemoteButton Event);
 void MotorManager_SendCurrentInquiry(void);
+static void MotorManager_PerformSpeedControl(MotorName Mot);
+static uint16_t MotorManager_GetCommandSpeed(MotorName Mot);
+static uint16_t MotorManager_GetProfiledSpeed(MotorName Mot);
+static q15_t MotorManager_GetStepProfileFactor(void);
 void MotorManager_ClearEventDuringError(DisplayButton *DisplayEvent, RemoteButton *RemoteEvent, KeyboardEvent *Keyboard);
 
 //Motor Functions
@@ -234,6 +264,12 @@ void MotorManager_Initialise(void){
 }
 
 void MotorManager_Perform1ms( void ){
+    if( ++SpeedControlTick >= dSPEED_CONTROL_PERIOD ){
+        SpeedControlTick = 0;
+        StepProfileFactor = IsStepProfileActive ? MotorManager_GetStepProfileFactor() : dQ15_ONE;
+        MotorManager_PerformSpeedControl(Motor_Left);
+        MotorManager_PerformSpeedControl(Motor_Right);
+    }
     if( MotorManager_IsAnyMotorEnabled() ){
         LED1_SetHigh();
         Timer_Tick(&EncoderInquiryTimer);
@@ -401,7 +437,36 @@ void MotorManager_SendData(CAN_MSG_OBJ *MotorStructure){
     }
 }
 
+/* Emergency stop: frames waiting in TXQ are aborted so no stale speed command
+ * follows the stop, a frame already on the bus is finished by the module.
+ * False until that happened. */
+bool MotorManager_AbortCanTx(void){
+    if( C1TXQCONLbits.TXREQ ){
+        C1TXQCONLbits.TXREQ = 0;
+        if( C1TXQCONLbits.TXREQ ){
+            return false;
+        }
+    }
+    /* Aborted frames are dropped, takes a few CAN clock cycles */
+    C1TXQCONLbits.FRESET = 1;
+    while( C1TXQCONLbits.FRESET ){
+    }
+    return true;
+}
+
+/* Stop command of emergency stop, false when TXQ is full */
+bool MotorManager_SendStop(MotorName Mot){
+    Motor[Mot].Enable = 0;
+    Motor[Mot].Current = 0;
+    Motor[Mot].SentSpeed = 0;
+    CAN_Motors[Mot]->data = &CAN_MotorStop[0];
+    return CAN_TX_MSG_REQUEST_SUCCESS == CAN1_Transmit(CAN1_TX_TXQ, CAN_Motors[Mot]);
+}
+
 void MotorManager_SendEnableMessage(void){
+    if( EmergencyStop_IsActive() ){
+        return;
+    }
     if( Motor[Motor_Right].Enable ){
         CAN_Motor_Right.data = &CAN_Motor_EN[0];
         MotorManager_SendData(&CAN_Motor_Right);
@@ -437,10 +502,12 @@ void MotorManager_TriggerEnableMessageSend(uint16_t Timeout){
 
 void MotorManager_SendEncoderInquiry(void){
     if( Motor[Motor_Right].Enable && EncoderToSend){
+        Motor[Motor_Right].InquiryTime = TimeManager_GetMicros();
         CAN_Motor_Right.data = &CAN_Motor_Position[0];
         MotorManager_SendData(&CAN_Motor_Right);
     }
     if( Motor[Motor_Left].Enable && !EncoderToSend){
+        Motor[Motor_Left].InquiryTime = TimeManager_GetMicros();
         CAN_Motor_Left.data = &CAN_Motor_Position[0];
         MotorManager_SendData(&CAN_Motor_Left);
     }
@@ -763,12 +830,23 @@ void MotorManager_StartMotorOpositeDirection(MotorName Mot){
 
 void MotorManager_StartMotor(MotorName Mot, uint8_t Direction){
     uint16_t CalculatedSpeed;
+    if( (Mot == Motor_Left || Mot == Motor_Right) && Motor[Mot].Direction != Direction ){
+        /* Trim of the other direction does not apply */
+        SpeedControl_Reset(&WheelSpeedControl[Mot]);
+    }
     Motor[Mot].Direction = Direction;
+    if( EmergencyStop_IsActive() ){
+        /* Stop is latched, no speed frame goes out until it is released */
+        Motor[Mot].Enable = 0;
+        Motor[Mot].SentSpeed = 0;
+        return;
+    }
     Motor[Mot].Enable = 1;
     uint8_t SpeedDataLow, SpeedDataHigh;
     /* Calculation of speed regarding forward/backward direction */
     
-    uint32_t MotorSpeed = (uint32_t)Motor[Mot].Speed;
+    Motor[Mot].SentSpeed = MotorManager_GetCommandSpeed(Mot);
+    uint32_t MotorSpeed = (uint32_t)Motor[Mot].SentSpeed;
     if( dRIGHT == Direction ){
         CalculatedSpeed = 65535 - MotorSpeed * 100 / 15;
         SpeedDataHigh = 0xFF;
@@ -836,18 +914,19 @@ void MotorManager_StartMotor(MotorName Mot, uint8_t Direction){
 void MotorManager_StopMotor(MotorName Mot){
     Motor[Mot].Enable = 0;
     Motor[Mot].Current = 0;
+    Motor[Mot].SentSpeed = 0;
     
     switch(Mot){
         case Motor_Left:
             CAN_Motor_Left.data = &CAN_MotorStop[0];
             MotorManager_SendData(&CAN_Motor_Left);
-            LastRotL = MotorManager_GetRotationCountPositive(Motor_Left) * dDISTANCE_PER_MOTOR_ROTATION;
+            LastRotL = FixedPoint_Q16Mul(MotorManager_GetRotationCountPositive(Motor_Left), dDISTANCE_PER_MOTOR_ROTATION_Q16);
             MotorManager_ResetRotationCountPositive(Motor_Left);
             break;
         case Motor_Right:
             CAN_Motor_Right.data = &CAN_MotorStop[0];
             MotorManager_SendData(&CAN_Motor_Right);
-            LastRotR = MotorManager_GetRotationCountPositive(Motor_Right) * dDISTANCE_PER_MOTOR_ROTATION;
+            LastRotR = FixedPoint_Q16Mul(MotorManager_GetRotationCountPositive(Motor_Right), dDISTANCE_PER_MOTOR_ROTATION_Q16);
             MotorManager_ResetRotationCountPositive(Motor_Right);
             break;
         case Motor_Thumble:
@@ -1024,6 +1103,7 @@ uint8_t CalculateShaftTurn( MotorName Name ){
     uint16_t Current;
     uint16_t Previous;
     int16_t  Turn;
+    uint32_t Now, Elapsed, Speed;
     //for(MotorName Name; Name < Motor_NumOf; Name++){
         Current = Motor[Name].Position_Count;//informacja z invertera
         Previous = Motor[Name].Position_CountPrev;//osatnia odczytana warto??
@@ -1050,6 +1130,17 @@ uint8_t CalculateShaftTurn( MotorName Name ){
             Ret = 0;
         }
 
+        /* Reply is taken by main loop polling, the inquiry time jitters less */
+        Now = Motor[Name].InquiryTime;
+        Elapsed = Now - Motor[Name].PositionTime;
+        if( Elapsed > 0 && Elapsed < dSPEED_MEASURE_TIMEOUT ){
+            /* ENCODER_MAX_VALUE counts per rotation */
+            Speed = (uint32_t)(diff < 0 ? -diff : diff) * (60000000uL / ENCODER_MAX_VALUE) / Elapsed;
+            Motor[Name].MeasuredSpeed = (Speed > 0xFFFFu) ? 0xFFFFu : (uint16_t)Speed;
+            Motor[Name].SpeedTime = Now;
+        }
+        Motor[Name].PositionTime = Now;
+
         Motor[Name].PositionAcc = Motor[Name].PositionAcc + diff;
 
         if( Motor[Name].PositionAcc > 10000 ){
@@ -1142,7 +1233,7 @@ void MotorManager_SetDirection(MotorName Mot, uint8_t Direction){
 }
 
 void MotorManager_SetSpeed(uint8_t Mot, uint16_t Speed){
-    if(Speed == 0){
+    if(Speed == 0 || EmergencyStop_IsActive()){
         Motor[Mot].Enable = 0;
     }
     else{
@@ -1182,6 +1273,97 @@ uint16_t MotorManager_GetStepSpeed(uint8_t Mot){
     return Motor[Mot].StepSpeed;
 }
 
+/* Wheel setpoint scaled by the step profile */
+static uint16_t MotorManager_GetProfiledSpeed(MotorName Mot){
+    if( StepProfileFactor == dQ15_ONE || (Mot != Motor_Left && Mot != Motor_Right) ){
+        return Motor[Mot].Speed;
+    }
+    return FixedPoint_ScaleU16Q15(Motor[Mot].Speed, StepProfileFactor);
+}
+
+static uint16_t MotorManager_GetCommandSpeed(MotorName Mot){
+    if( IsSpeedControlEnabled && (Mot == Motor_Left || Mot == Motor_Right) ){
+        return SpeedControl_GetCommand(&WheelSpeedControl[Mot], &SpeedGains, MotorManager_GetProfiledSpeed(Mot));
+    }
+    return MotorManager_GetProfiledSpeed(Mot);
+}
+
+/* Every dSPEED_CONTROL_PERIOD, only for a wheel that was started */
+static void MotorManager_PerformSpeedControl(MotorName Mot){
+    uint16_t Command;
+    uint16_t Change;
+
+    if( !Motor[Mot].Enable || Motor[Mot].SentSpeed == 0 ){
+        SpeedControl_Reset(&WheelSpeedControl[Mot]);
+        return;
+    }
+    if( !IsSpeedControlEnabled ){
+        /* Open loop, only the step profile changes the command */
+        SpeedControl_Reset(&WheelSpeedControl[Mot]);
+        Command = MotorManager_GetCommandSpeed(Mot);
+    }
+    else if( (TimeManager_GetMicros() - Motor[Mot].SpeedTime) >= dSPEED_MEASURE_TIMEOUT ){
+        /* No speed from position replies, keep the trim */
+        Command = MotorManager_GetCommandSpeed(Mot);
+    }
+    else{
+        Command = SpeedControl_Update(&WheelSpeedControl[Mot], &SpeedGains, MotorManager_GetProfiledSpeed(Mot), Motor[Mot].MeasuredSpeed);
+    }
+    Change = (Command > Motor[Mot].SentSpeed) ? (Command - Motor[Mot].SentSpeed) : (Motor[Mot].SentSpeed - Command);
+    if( Command != 0 && Change >= dSPEED_CONTROL_DEADBAND ){
+        MotorManager_StartMotorKeepDirection(Mot);
+    }
+}
+
+void MotorManager_SetSpeedControl(bool Enable){
+    IsSpeedControlEnabled = Enable;
+    SpeedControl_Reset(&WheelSpeedControl[Motor_Left]);
+    SpeedControl_Reset(&WheelSpeedControl[Motor_Right]);
+}
+
+bool MotorManager_IsSpeedControlEnabled(void){
+    return IsSpeedControlEnabled;
+}
+
+void MotorManager_SetSpeedControlGains(const SpeedControlGains *Gains){
+    /* Integral is kept, new gains take over without a jump */
+    SpeedGains = *Gains;
+}
+
+void MotorManager_GetSpeedControlGains(SpeedControlGains *Gains){
+    *Gains = SpeedGains;
+}
+
+uint16_t MotorManager_GetMeasuredSpeed(MotorName Mot){
+    return Motor[Mot].MeasuredSpeed;
+}
+
+void MotorManager_PlanStepProfile(uint16_t Length, bool Accelerate, bool Decelerate){
+    uint16_t Speed = Motor[Motor_Right].StepSpeed;
+
+    if(Motor[Motor_Left].StepSpeed > Speed){
+        Speed = Motor[Motor_Left].StepSpeed;
+    }
+    MotionProfile_Plan(&StepProfile, Length, Speed, dDISTANCE_PER_MOTOR_ROTATION_Q16, Accelerate, Decelerate);
+    IsStepProfileActive = true;
+    StepProfileFactor = MotorManager_GetStepProfileFactor();
+}
+
+void MotorManager_ClearStepProfile(void){
+    IsStepProfileActive = false;
+    StepProfileFactor = dQ15_ONE;
+}
+
+/* Step speed factor for the distance driven by wheels in this step */
+static q15_t MotorManager_GetStepProfileFactor(void){
+    int32_t Travelled;
+
+    /* Same distance as step completion in RouteManager_IsNormStepAchieved */
+    Travelled = Motor[Motor_Left].Rotation_Count - Motor[Motor_Right].Rotation_Count;
+    Travelled = FixedPoint_Q16Mul((Travelled < 0 ? -Travelled : Travelled) / 2, dDISTANCE_PER_MOTOR_ROTATION_Q16);
+    return MotionProfile_GetFactor(&StepProfile, (Travelled > 0xFFFF) ? 0xFFFFu : (uint16_t)Travelled);
+}
+
 uint16_t MotorManager_GetSpeed(uint8_t Mot){
     return Motor[Mot].Speed;
 }
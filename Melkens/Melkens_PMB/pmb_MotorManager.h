@@ -9,6 +9,9 @@
 
 
 #include <xc.h> // include processor files - each processor file is guarded.  
+#include "Tools/FixedPoint.h"
+#include "MotionProfile/MotionProfile.h"
+#include "SpeedControl/SpeedControl.h"
 
 #define dLEFT       1
 #define dRIGHT      2
@@ -80,6 +83,20 @@ void MotorManager_SetSpeed(uint8_t Motor, uint16_t Speed);
 uint16_t MotorManager_GetStepSpeed(uint8_t Mot);
 void MotorManager_SetStepSpeed(uint8_t Mot, uint16_t Speed);
 
+/* Jerk limited speed profile of wheel step, see MotionProfile/MotionProfile.h.
+ * Planned after step speeds are set, Length [cm]. Until cleared the wheel
+ * setpoints are scaled by the profile, updated every dSPEED_CONTROL_PERIOD */
+void MotorManager_PlanStepProfile(uint16_t Length, bool Accelerate, bool Decelerate);
+void MotorManager_ClearStepProfile(void);
+
+/* Wheel speed loop, see SpeedControl/SpeedControl.h. SetSpeed gives the
+ * setpoint, the command sent to the inverter is corrected from encoders */
+void MotorManager_SetSpeedControl(bool Enable);
+bool MotorManager_IsSpeedControlEnabled(void);
+void MotorManager_SetSpeedControlGains(const SpeedControlGains *Gains);
+void MotorManager_GetSpeedControlGains(SpeedControlGains *Gains);
+uint16_t MotorManager_GetMeasuredSpeed(MotorName Mot);
+
 void MotorManager_StartMotor(MotorName Mot, uint8_t Direction
 );
 uint8_t MotorManager_GetStepDirection(uint8_t Mot);
@@ -100,6 +117,9 @@ void MotorManager_StartMotorOpositeDirection(MotorName Mot);
 /* Stop selected motor */
 void MotorManager_StopMotor(MotorName Mot);
 void MotorManager_StopAllMotors(void);
+/* Emergency stop, see EmergencyStop/EmergencyStop.h */
+bool MotorManager_AbortCanTx(void);
+bool MotorManager_SendStop(MotorName Mot);
 uint8_t CalculateShaftTurn( MotorName Name );
 
 bool MotorManager_IsRotationCountResetRequest(void);
@@ -108,6 +128,6 @@ void MotorManager_SetRotationCountResetRequest(void);
 
 //dev variables for HMI
 extern uint16_t RWheelSetSpeed, LWheelSetSpeed, AugSetSpeed, LastRotR, LastRotL;
-extern float CurrentAngle2, StepAngle, PrevStepAngle;
+extern q16_t CurrentAngle2, StepAngle, PrevStepAngle;
 extern int IntStepAngle;
 //CurrentAngle2 because theres another variable called CurrentAngle and I don't want to mess anything up
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "pmb_Display.h"
 #include "pmb_Keyboard.h"
 #include "Tools/Timer.h"
+#include "Tools/FixedPoint.h"
 #include "pmb_Settings.h"
 #include "DriveIndicator.h"
 #include "RoutesDataTypes.h"
@@ -18,14 +19,18 @@
 #include "pmb_System.h"
 #include "mcc_generated_files/pin_manager.h"
 #include "BatteryManager/BatteryManager.h"
+#include "EmergencyStop/EmergencyStop.h"
 
 #define FULL_WHEEL_TURN 55
 
+/* On this angle, correction proportional regulation is based */
+#define dPROPORTIONAL_CORRECTION_ANGLE 3
+
 uint8_t Hourtmp, Mintmp;
 uint8_t Hour1, Min1;
 static uint8_t RouteRepetitionCount;
 bool VelocityCorrection;
-float CalulatedAngle;
+q16_t CalulatedAngle;
 int MagnetSearchWindowFlag;
 
 bool stepRepeatFlag = 0;
@@ -97,9 +102,14 @@ bool MagnetsDiscoveredLatched;
 bool MagnetsDiscovered;
 float DesiredAngle;
 float TurnAngle;
-float CurrentAngle;
+q16_t CurrentAngle;
 float AngleBeforePauseButton;
 float MagnetCorrectionAngle = 0;
+/* Fixed point copies of step data, updated once per step and used by 1ms calculations */
+q16_t DesiredAngleQ16;
+q16_t MagnetCorrectionAngleQ16;
+q16_t TurnAngleQ16;
+uint16_t StepDistance;
 bool MagnetDetection;
 bool SlowerSpeedFlag;
 bool autoRoutePlay;
@@ -112,7 +122,7 @@ int32_t RotationCountBeforePauseRight;
 RouteData CurrentRoute;
 extern uint16_t RouteStepSelected;
 
-float previusMagnetDeltaDistance = 0;
+int16_t previusMagnetDeltaDistance = 0;   /* [0.1mm], dROUTE_MAGNET_NONE if not known */
 float previusMagnetDetected = 0;
 float previusTurnAngle = 0;
 float stepDistanceOffset = 0;
@@ -125,7 +135,7 @@ bool rampEnable = false;//enable acceleration and decelaration
 bool changedDirection = false;
 bool previusStepNormInTheSameDirection = false;
 
-float EncoderFinishedPercent;
+q16_t EncoderFinishedPercent;
 
 bool RouteManager_LoadNextStepData(void);
 void RouteManager_AutomaticCorrection(float Angle);
@@ -139,8 +149,12 @@ void RouteManager_FinishRoute(void);
 bool RouteManager_IsRouteSelectButton(DisplayButton Event);
 void RouteManager_PrepareRouteSettings(Route_ID  Root);
 void RouteManager_SetMotors(void);
-void RouteManager_AutomaticCorrectionForward(float Angle);
-void RouteManager_AutomaticCorrectionReverse(float Angle);
+void RouteManager_AutomaticCorrectionForward(q16_t Angle);
+void RouteManager_AutomaticCorrectionReverse(q16_t Angle);
+static void RouteManager_UpdateStepFixedPoint(void);
+static int16_t RouteManager_GetMagnetError(const RouteStep* Step, float MagnetCM);
+static q16_t RouteManager_GetEncoderFinishedPercent(uint16_t Distance);
+static q16_t RouteManager_GetMagnetSearchStart(void);
 void RouteManager_RoutePause(void);
 void RouteManager_RoutePlay(void);
 void RouteManager_ChargeSensorHandler(void);
@@ -216,7 +230,7 @@ void RouteManager_Perform100ms(void)
 {
     /* Calculation of Read_Measured to check, if new step should be applied */
     /* Previous implementation name RouteRoutineTimer */
-    CurrentAngle = IMUHandler_GetAngle();
+    CurrentAngle = IMUHandler_GetAngleQ16();
 
     switch (Operation_Type){
     case NORM:
@@ -436,6 +450,10 @@ void RouteManager_StateMachine(void){
             }
             RouteManager_RoutePause();
         }
+        /* Emergency stop holds the motors, after release route waits for PLAY */
+        if( EmergencyStop_IsActive() && !IsRoutePause ){
+            RouteManager_RoutePause();
+        }
 
 /* ------------------------------------------------------------------------------*/
 
@@ -542,10 +560,8 @@ void RouteManager_RoutePause(void){
 bool RouteManager_IsNormStepAchieved(void)
 {
     bool Ret = false;
-    float EncoderFinishedPercent_Left;
-    float EncoderFinishedPercent_Right;
-    float MagnetsEnableMultiplier;
-    float EndStepPercent;
+    q16_t MagnetsEnableMultiplier;
+    q16_t EndStepPercent;
     bool MagnetsDiscovered = false;
     
     StatusM = GetMagnets();
@@ -567,24 +583,13 @@ bool RouteManager_IsNormStepAchieved(void)
 
     }
 
-    EncoderFinishedPercent_Left = ((float)MotorManager_GetRotationCount(Motor_Left) * dDISTANCE_PER_MOTOR_ROTATION) / (float)(cor_dX + stepDistanceOffset) ;
-    EncoderFinishedPercent_Right = ((float)MotorManager_GetRotationCount(Motor_Right) * dDISTANCE_PER_MOTOR_ROTATION) / (float)(cor_dX + stepDistanceOffset);
-    
-    EncoderFinishedPercent = fabs(EncoderFinishedPercent_Left - EncoderFinishedPercent_Right)/2;
+    EncoderFinishedPercent = RouteManager_GetEncoderFinishedPercent(StepDistance);
 
     //Set the magnet search window (step completion in %))
-
-    if(cor_dX < 10)
-        MagnetsEnableMultiplier = 0.20f;
-    else if(cor_dX > 50)
-        MagnetsEnableMultiplier = 0.80f;
-    else{
-        /* Dynamic change from 0.2 to 0.95 */
-        MagnetsEnableMultiplier = 0.2f + (((float)cor_dX / 100.0f) * 0.75f);
-    }
+    MagnetsEnableMultiplier = RouteManager_GetMagnetSearchStart();
 
     //MagnetsEnableMultiplier = 0.50f;    //Lower window limit (%)
-    EndStepPercent = 1.5f;  //Upper window limit (%)
+    EndStepPercent = dQ16(1.5);  //Upper window limit (%)
     MagnetSearchWindowFlag = 0;  //Reset the flag for indicating the magnet search window
     if(!stepRepeatFlag)
     {
@@ -608,7 +613,7 @@ bool RouteManager_IsNormStepAchieved(void)
     else//while returning to previous position search for magnets
     {
         MagnetSearchWindowFlag = 1;
-        EndStepPercent += 0.2f;//increase magnet search window while returning to previous position
+        EndStepPercent += dQ16(0.2);//increase magnet search window while returning to previous position
         
         if(EncoderFinishedPercent >= EndStepPercent){//if moover can not find magnet while returning to previous position
             /* If exceeded 150% of distance, stop step */
@@ -654,6 +659,7 @@ bool RouteManager_IsNormStepAchieved(void)
             stepRepeatCount++;
             stepRepeatFlag = true;
             CurrentRoute.Step--;
+            CurrentRoute.Pose--;
             if(CurrentRouteStep > 0)
             {
                 CurrentRouteStep--;
@@ -665,15 +671,9 @@ bool RouteManager_IsNormStepAchieved(void)
 
 bool RouteManager_IsNormNoMagnetStepAchieved(void)
 {
-    float EncoderFinishedPercent_Left;
-    float EncoderFinishedPercent_Right;
-    
-    EncoderFinishedPercent_Left = (float)MotorManager_GetRotationCount(Motor_Left) * dDISTANCE_PER_MOTOR_ROTATION / (float)cor_dX ;
-    EncoderFinishedPercent_Right = (float)MotorManager_GetRotationCount(Motor_Right) * dDISTANCE_PER_MOTOR_ROTATION / (float)cor_dX;
+    EncoderFinishedPercent = RouteManager_GetEncoderFinishedPercent((uint16_t)cor_dX);
     
-    EncoderFinishedPercent = fabs(EncoderFinishedPercent_Left - EncoderFinishedPercent_Right)/2;
-    
-    if (EncoderFinishedPercent >= 1.0f)
+    if (EncoderFinishedPercent >= dQ16_ONE)
     {
         return true;
     }
@@ -683,21 +683,46 @@ bool RouteManager_IsNormNoMagnetStepAchieved(void)
     }
 }
 
+/* Driven part of the step, dQ16_ONE when both wheels made Distance [cm] */
+static q16_t RouteManager_GetEncoderFinishedPercent(uint16_t Distance)
+{
+    q16_t EncoderFinishedPercent_Left;
+    q16_t EncoderFinishedPercent_Right;
+
+    EncoderFinishedPercent_Left = FixedPoint_Q16Mul(FixedPoint_Q16Div(MotorManager_GetRotationCount(Motor_Left), Distance), dDISTANCE_PER_MOTOR_ROTATION_Q16);
+    EncoderFinishedPercent_Right = FixedPoint_Q16Mul(FixedPoint_Q16Div(MotorManager_GetRotationCount(Motor_Right), Distance), dDISTANCE_PER_MOTOR_ROTATION_Q16);
+
+    return FixedPoint_Q16Abs(EncoderFinishedPercent_Left - EncoderFinishedPercent_Right) / 2;
+}
+
+/* Step completion from which magnets are searched, depends on step length */
+static q16_t RouteManager_GetMagnetSearchStart(void)
+{
+    if(cor_dX < 10)
+        return dQ16(0.20);
+    else if(cor_dX > 50)
+        return dQ16(0.80);
+    else{
+        /* Dynamic change from 0.2 to 0.95, cor_dX / 100 * 0.75 */
+        return dQ16(0.2) + FixedPoint_Q16Div(cor_dX * 3, 400);
+    }
+}
+
 bool RouteManager_IsTurnStepAchieved(OperType Operation)
 {
-    float DiagonalFinishedPercent;
-    float IMUFinishedPercent;
+    q16_t DiagonalFinishedPercent = 0;
+    q16_t IMUFinishedPercent;
 
     if (Operation == TU_L){
-        DiagonalFinishedPercent = (float)MotorManager_GetRotationCount(Motor_Left) / (float)Diagonal;
+        DiagonalFinishedPercent = FixedPoint_Q16Div(MotorManager_GetRotationCount(Motor_Left), Diagonal);
     }
     else if (Operation == TU_R){
-        DiagonalFinishedPercent = (float)MotorManager_GetRotationCount(Motor_Right) / (float)Diagonal;
+        DiagonalFinishedPercent = FixedPoint_Q16Div(MotorManager_GetRotationCount(Motor_Right), Diagonal);
     }
 
-    IMUFinishedPercent = -(fabs(IMUHandler_CalculateAngle(DesiredAngle, CurrentAngle) / TurnAngle) - 1.0f);
+    IMUFinishedPercent = dQ16_ONE - FixedPoint_Q16Abs(FixedPoint_Q16DivQ16(IMUHandler_CalculateAngleQ16(DesiredAngleQ16, CurrentAngle), TurnAngleQ16));
 
-    if ((IMUFinishedPercent * dIMU_JUDGEMENT_FACTOR + fabs(DiagonalFinishedPercent) * dECODER_JUDGEMENT_FACTOR) >= 0.97f){
+    if ((FixedPoint_Q16Mul(IMUFinishedPercent, dIMU_JUDGEMENT_FACTOR_Q16) + FixedPoint_Q16Mul(FixedPoint_Q16Abs(DiagonalFinishedPercent), dECODER_JUDGEMENT_FACTOR_Q16)) >= dQ16(0.97)){
         return true;
     }
     else{
@@ -707,42 +732,45 @@ bool RouteManager_IsTurnStepAchieved(OperType Operation)
 
 bool RouteManager_Is90DegStepAchieved(OperType Operation)
 {
-    float EncoderFinishedPercent_Left;
-    float EncoderFinishedPercent_Right;
-    float IMUFinishedPercent;
-
-    float IMUJudgementResult;
-    float LeftJudgementResult;
-    float RightJudgementResult;
+    q16_t EncoderFinishedPercent_Left;
+    q16_t EncoderFinishedPercent_Right;
+    q16_t IMUFinishedPercent;
+    q16_t SpeedFactor;
+
+    q16_t IMUJudgementResult;
+    q16_t LeftJudgementResult;
+    q16_t RightJudgementResult;
     
-    EncoderFinishedPercent_Left = (float)MotorManager_GetRotationCount(Motor_Left) / (float)FULL_WHEEL_TURN;
-    EncoderFinishedPercent_Right = (float)MotorManager_GetRotationCount(Motor_Right) / (float)FULL_WHEEL_TURN;
+    EncoderFinishedPercent_Left = FixedPoint_Q16Div(MotorManager_GetRotationCount(Motor_Left), FULL_WHEEL_TURN);
+    EncoderFinishedPercent_Right = FixedPoint_Q16Div(MotorManager_GetRotationCount(Motor_Right), FULL_WHEEL_TURN);
     
-    IMUFinishedPercent = fabs(-(fabs(IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, CurrentAngle) / TurnAngle) - 1.0f));//in some rare cases resoult of this func was negative therefore absolute value is needed
+    IMUFinishedPercent = FixedPoint_Q16Abs(dQ16_ONE - FixedPoint_Q16Abs(FixedPoint_Q16DivQ16(IMUHandler_CalculateAngleQ16(DesiredAngleQ16 + MagnetCorrectionAngleQ16, CurrentAngle), TurnAngleQ16)));//in some rare cases resoult of this func was negative therefore absolute value is needed
    
-    IMUJudgementResult = IMUFinishedPercent * dIMU_JUDGEMENT_FACTOR;
-    LeftJudgementResult = fabs(EncoderFinishedPercent_Left * dECODER_JUDGEMENT_FACTOR);
-    RightJudgementResult = fabs(EncoderFinishedPercent_Right * dECODER_JUDGEMENT_FACTOR);
+    IMUJudgementResult = FixedPoint_Q16Mul(IMUFinishedPercent, dIMU_JUDGEMENT_FACTOR_Q16);
+    LeftJudgementResult = FixedPoint_Q16Abs(FixedPoint_Q16Mul(EncoderFinishedPercent_Left, dECODER_JUDGEMENT_FACTOR_Q16));
+    RightJudgementResult = FixedPoint_Q16Abs(FixedPoint_Q16Mul(EncoderFinishedPercent_Right, dECODER_JUDGEMENT_FACTOR_Q16));
     
-    if(IMUFinishedPercent>0.5 && false == SlowerSpeedFlag)
+    if(IMUFinishedPercent>dQ16(0.5) && false == SlowerSpeedFlag)
     {
         //SlowerSpeedFlag = true;
-        MotorManager_SetSpeed(Motor_Right, MotorManager_GetStepSpeed(Motor_Right)*(1-((IMUFinishedPercent-0.5)*1.7)));
+        SpeedFactor = dQ16_ONE - FixedPoint_Q16Mul(IMUFinishedPercent - dQ16(0.5), dQ16(1.7));
+        MotorManager_SetSpeed(Motor_Right, FixedPoint_ScaleU16(MotorManager_GetStepSpeed(Motor_Right), SpeedFactor));
         MotorManager_StartMotorKeepDirection(Motor_Right);
         
-        MotorManager_SetSpeed(Motor_Left, MotorManager_GetStepSpeed(Motor_Left)*(1-((IMUFinishedPercent-0.5)*1.7)));
+        MotorManager_SetSpeed(Motor_Left, FixedPoint_ScaleU16(MotorManager_GetStepSpeed(Motor_Left), SpeedFactor));
         MotorManager_StartMotorKeepDirection(Motor_Left);
     }
     else
     {
-        MotorManager_SetSpeed(Motor_Right, MotorManager_GetStepSpeed(Motor_Right)*((IMUFinishedPercent * 1.6)+0.2));
+        SpeedFactor = FixedPoint_Q16Mul(IMUFinishedPercent, dQ16(1.6)) + dQ16(0.2);
+        MotorManager_SetSpeed(Motor_Right, FixedPoint_ScaleU16(MotorManager_GetStepSpeed(Motor_Right), SpeedFactor));
         MotorManager_StartMotorKeepDirection(Motor_Right);
         
-        MotorManager_SetSpeed(Motor_Left, MotorManager_GetStepSpeed(Motor_Left)*((IMUFinishedPercent * 1.6)+0.2));
+        MotorManager_SetSpeed(Motor_Left, FixedPoint_ScaleU16(MotorManager_GetStepSpeed(Motor_Left), SpeedFactor));
         MotorManager_StartMotorKeepDirection(Motor_Left);
     }
     
-    if (fabs(IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, CurrentAngle))<1)
+    if (FixedPoint_Q16Abs(IMUHandler_CalculateAngleQ16(DesiredAngleQ16 + MagnetCorrectionAngleQ16, CurrentAngle)) < dQ16_ONE)
     {
         SlowerSpeedFlag = false;
         return true;
@@ -810,26 +838,44 @@ void RouteManager_PrepareRouteSettings(Route_ID  Route)
     DesiredAngle = IMUHandler_GetAngle();
     previusMagnetDeltaDistance = 0;
     previusTurnAngle = 0;
+    RouteManager_UpdateStepFixedPoint();
+}
+
+/* Measured magnet bar position [cm] minus the step expected position, in RouteStep.MagnetCorrection units [0.1mm] */
+static int16_t RouteManager_GetMagnetError(const RouteStep* Step, float MagnetCM)
+{
+    return (int16_t)(MagnetCM * dROUTE_MAGNET_UNITS_PER_CM) - Step->MagnetCorrection;
+}
+
+/* Step setup keeps float trigonometry, 1ms calculations use these fixed point copies */
+static void RouteManager_UpdateStepFixedPoint(void)
+{
+    float Distance = (float)cor_dX + stepDistanceOffset;
+
+    DesiredAngleQ16 = FixedPoint_Q16FromFloat(DesiredAngle);
+    MagnetCorrectionAngleQ16 = FixedPoint_Q16FromFloat(MagnetCorrectionAngle);
+    TurnAngleQ16 = FixedPoint_Q16FromFloat(TurnAngle);
+    StepDistance = (Distance > 0.0f) ? (uint16_t)(Distance + 0.5f) : 0;
 }
 
 /* Stop motors, set default speed and change route state to IDLE */
 void RouteManager_FinishRoute(void)
 {  
     int i=1;
-                CurrentAngle2 = IMUHandler_GetAngle();
+                CurrentAngle2 = IMUHandler_GetAngleQ16();
             StepAngle = CurrentAngle2 - PrevStepAngle;
             
-            if (StepAngle > 180)
+            if (StepAngle > dQ16_FROM_INT(180))
             {
-                StepAngle = StepAngle - 360;
+                StepAngle = StepAngle - dQ16_FROM_INT(360);
             }
-            else if (StepAngle < -180)
+            else if (StepAngle < dQ16_FROM_INT(-180))
             {
-                StepAngle = StepAngle + 360;
+                StepAngle = StepAngle + dQ16_FROM_INT(360);
             }
             
             PrevStepAngle = CurrentAngle2;
-            IntStepAngle = (int)(fabs(StepAngle)*10);
+            IntStepAngle = (int)dQ16_TO_INT(FixedPoint_Q16Abs(StepAngle) * 10);
     RouteManager_ResetRouteSettings();
     MotorManager_StopMotor(Motor_Right);
     MotorManager_StopMotor(Motor_Left);
@@ -885,8 +931,8 @@ bool RouteManager_LoadNextStepData(void)
    
     if( RouteManager_SwitchToNextStep()){
         //Save the distance driven after finishing a route step (for dev display purposes)
-        LastRotL = MotorManager_GetRotationCountPositive(Motor_Left) * dDISTANCE_PER_MOTOR_ROTATION;
-        LastRotR = MotorManager_GetRotationCountPositive(Motor_Right) * dDISTANCE_PER_MOTOR_ROTATION;
+        LastRotL = FixedPoint_Q16Mul(MotorManager_GetRotationCountPositive(Motor_Left), dDISTANCE_PER_MOTOR_ROTATION_Q16);
+        LastRotR = FixedPoint_Q16Mul(MotorManager_GetRotationCountPositive(Motor_Right), dDISTANCE_PER_MOTOR_ROTATION_Q16);
 
 
         
@@ -939,7 +985,7 @@ bool RouteManager_LoadNextStepData(void)
                 if(rampEnable)
                     decelerate = true;
             }
-            else if(CurrentRoute.Step->MagnetCorrection != dMAGNET_NO_CORRECTION)
+            else if(RouteStep_HasMagnetCorrection(CurrentRoute.Step))
                     nextStepDistance = CurrentRoute.Step->dX;    
             
             CurrentRoute.Step--;
@@ -949,7 +995,7 @@ bool RouteManager_LoadNextStepData(void)
         MagnetCM = IMUHandler_GetMagnetMagnetPositionInCM(Magnet1st);
         stepDistanceOffset = 0;
         //if robot is going in straight line and correction is on nad is not returning to previous position
-        if(CurrentRoute.Step->MagnetCorrection != dMAGNET_NO_CORRECTION && CurrentRoute.Step->OperationType == NORM && !stepRepeatFlag){//angle correction only in norm step
+        if(RouteStep_HasMagnetCorrection(CurrentRoute.Step) && CurrentRoute.Step->OperationType == NORM && !stepRepeatFlag){//angle correction only in norm step
             
             if((MagnetCM == dMAGNET_NO_DETECTION) && (previusTurnAngle != 0))//if magnet was not detected and last step was turning
             {
@@ -959,20 +1005,20 @@ bool RouteManager_LoadNextStepData(void)
             }
             else if (MagnetCM == dMAGNET_NO_DETECTION)//if magnet is not detected cancel magnet correction
             {
-                MagnetCM = CurrentRoute.Step->MagnetCorrection;
+                MagnetCM = (float)CurrentRoute.Step->MagnetCorrection / dROUTE_MAGNET_UNITS_PER_CM;
             }
             
              if(CurrentRoute.Step->DirectionLeft == L_REV && CurrentRoute.Step->DirectionRight == R_REV)//if going in reverse
              {
-                MagnetCMDouble = -(double)(MagnetCM - CurrentRoute.Step->MagnetCorrection);//adjusting for expected magnet
+                MagnetCMDouble = -(double)RouteManager_GetMagnetError(CurrentRoute.Step, MagnetCM);//adjusting for expected magnet
                 stepDistanceOffset = -stepDistanceOffset;
              }
              else
              {
-                MagnetCMDouble = (double)(MagnetCM - CurrentRoute.Step->MagnetCorrection);//adjusting for expected magnet
+                MagnetCMDouble = (double)RouteManager_GetMagnetError(CurrentRoute.Step, MagnetCM);//adjusting for expected magnet
              }
             
-            RouteStepDxDouble = (double)(CurrentRoute.Step->dX + stepDistanceOffset);
+            RouteStepDxDouble = (double)(CurrentRoute.Step->dX + stepDistanceOffset) * dROUTE_MAGNET_UNITS_PER_CM;//same units as magnet error
                         
             if(MagnetCMDouble < 0){
                 MagnetCorrectionAngle = atan(-MagnetCMDouble/RouteStepDxDouble);
@@ -998,15 +1044,15 @@ bool RouteManager_LoadNextStepData(void)
             
             if(CurrentRoute.Step->DirectionLeft == L_REV && CurrentRoute.Step->DirectionRight == R_REV)
             {
-                MagnetCMDouble = -(double)(MagnetCM - CurrentRoute.Step->MagnetCorrection);//get next step expected magnet
+                MagnetCMDouble = -(double)RouteManager_GetMagnetError(CurrentRoute.Step, MagnetCM);//get next step expected magnet
                 stepDistanceOffset = -stepDistanceOffset;
             }
             else
             {
-                MagnetCMDouble = (double)(MagnetCM - CurrentRoute.Step->MagnetCorrection);//get next step expected magnet
+                MagnetCMDouble = (double)RouteManager_GetMagnetError(CurrentRoute.Step, MagnetCM);//get next step expected magnet
             }
             
-           RouteStepDxDouble = (double)(CurrentRoute.Step->dX + stepDistanceOffset);
+           RouteStepDxDouble = (double)(CurrentRoute.Step->dX + stepDistanceOffset) * dROUTE_MAGNET_UNITS_PER_CM;//same units as magnet error
             
             CurrentRoute.Step--;
             
@@ -1069,8 +1115,9 @@ bool RouteManager_LoadNextStepData(void)
         
         if(accelerating)
         {
-            MotorManager_SetSpeed(Motor_Right, CurrentRoute.Step->RightSpeed/2);
-            MotorManager_SetSpeed(Motor_Left, CurrentRoute.Step->LeftSpeed/2);
+            //start at the first speed of the step profile
+            MotorManager_SetSpeed(Motor_Right, FixedPoint_ScaleU16Q15(CurrentRoute.Step->RightSpeed, dMOTION_PROFILE_LOW_FACTOR));
+            MotorManager_SetSpeed(Motor_Left, FixedPoint_ScaleU16Q15(CurrentRoute.Step->LeftSpeed, dMOTION_PROFILE_LOW_FACTOR));
         }
         else
         {
@@ -1139,14 +1186,14 @@ bool RouteManager_LoadNextStepData(void)
         }
         
         
-        if(!stepRepeatFlag && CurrentRoute.Step->MagnetCorrection != dMAGNET_NO_CORRECTION && previusMagnetDeltaDistance != dMAGNET_NO_CORRECTION)//if going forward correct disared angle
+        if(!stepRepeatFlag && RouteStep_HasMagnetCorrection(CurrentRoute.Step) && previusMagnetDeltaDistance != dROUTE_MAGNET_NONE)//if going forward correct disared angle
         {
-            float deltaMagnetDistance = MagnetCM - CurrentRoute.Step->MagnetCorrection;
-            if(MagnetCM == dMAGNET_NO_DETECTION)
-                deltaMagnetDistance = 0;
+            int16_t deltaMagnetDistance = 0;
+            if(MagnetCM != dMAGNET_NO_DETECTION)
+                deltaMagnetDistance = RouteManager_GetMagnetError(CurrentRoute.Step, MagnetCM);
             
             float deltaDistance =  deltaMagnetDistance - previusMagnetDeltaDistance;
-                float stepDistance = CurrentRoute.Step->dX;
+                float stepDistance = (float)CurrentRoute.Step->dX * dROUTE_MAGNET_UNITS_PER_CM;//same units as magnet error
                 
                 float deltaAngle = acos(deltaDistance/(sqrt((deltaDistance*deltaDistance)+(stepDistance*stepDistance))));
                 deltaAngle = deltaAngle * 180.0 / 3.1416;
@@ -1190,10 +1237,10 @@ bool RouteManager_LoadNextStepData(void)
             DesiredAngle -= 360;
         }
         
-        if(MagnetCM != dMAGNET_NO_DETECTION &&  CurrentRoute.Step->MagnetCorrection != dMAGNET_NO_CORRECTION)//remember last distance error
-            previusMagnetDeltaDistance = MagnetCM - CurrentRoute.Step->MagnetCorrection;
+        if(MagnetCM != dMAGNET_NO_DETECTION &&  RouteStep_HasMagnetCorrection(CurrentRoute.Step))//remember last distance error
+            previusMagnetDeltaDistance = RouteManager_GetMagnetError(CurrentRoute.Step, MagnetCM);
         else
-            previusMagnetDeltaDistance = dMAGNET_NO_CORRECTION;
+            previusMagnetDeltaDistance = dROUTE_MAGNET_NONE;
         
         
         if(MagnetCM != dMAGNET_NO_DETECTION)//remember position of last detected magnet
@@ -1212,23 +1259,33 @@ bool RouteManager_LoadNextStepData(void)
             MagnetsDiscoveredLatched = false;
         }
         
-                        CurrentAngle2 = IMUHandler_GetAngle();
+                        CurrentAngle2 = IMUHandler_GetAngleQ16();
             StepAngle = CurrentAngle2 - PrevStepAngle;
             
-            if (StepAngle > 180)
+            if (StepAngle > dQ16_FROM_INT(180))
             {
-                StepAngle = StepAngle - 360;
+                StepAngle = StepAngle - dQ16_FROM_INT(360);
             }
-            else if (StepAngle < -180)
+            else if (StepAngle < dQ16_FROM_INT(-180))
             {
-                StepAngle = StepAngle + 360;
+                StepAngle = StepAngle + dQ16_FROM_INT(360);
             }
             
             PrevStepAngle = CurrentAngle2;
-            IntStepAngle = (int)(fabs(StepAngle) * 10);
+            IntStepAngle = (int)dQ16_TO_INT(FixedPoint_Q16Abs(StepAngle) * 10);
+        
+        RouteManager_UpdateStepFixedPoint();
+        /* Acceleration at the beginning and deceleration at the end of NORM step,
+         * MotorManager applies the S-curve to the wheel setpoints */
+        if(Operation_Type == NORM || Operation_Type == NORM_NOMAGNET)
+            MotorManager_PlanStepProfile(StepDistance, accelerating, decelerate);
+        else
+            MotorManager_ClearStepProfile();
         
-        if(!stepRepeatFlag)
-        CurrentRoute.Step++;
+        if(!stepRepeatFlag){
+            CurrentRoute.Step++;
+            CurrentRoute.Pose++;
+        }
      
     }
     else{
@@ -1256,6 +1313,7 @@ void RouteManager_ResetRouteSettings()
     Operation_Type = OpTypeNoOperation;
     CurrentRouteStep = 0;
     RouteSelected = Route_NumOf;
+    MotorManager_ClearStepProfile();
 }
 
 bool RouteManager_IsCurrentStepDone()
@@ -1263,75 +1321,57 @@ bool RouteManager_IsCurrentStepDone()
     return CurrentStepDone;
 }
 
-void RouteManager_AutomaticCorrectionForward(float Angle){
-    CalulatedAngle = IMUHandler_CalculateAngle(DesiredAngle+MagnetCorrectionAngle, Angle);
+void RouteManager_AutomaticCorrectionForward(q16_t Angle){
+    CalulatedAngle = IMUHandler_CalculateAngleQ16(DesiredAngleQ16 + MagnetCorrectionAngleQ16, Angle);
 
     uint16_t RightSpeed = MotorManager_GetStepSpeed(Motor_Right);
     uint16_t LeftSpeed = MotorManager_GetStepSpeed(Motor_Left);
     
-    float accelPecent = 0.3; //precent of route the acceleration will stop
-    float decelPecent = 0.7; //precent of route the deceleration will start
-    float lowPrecent = 0.2;//slowest speed in precent of stepspeed
-    
 // Store previous speed adjustment to smoothly increase the speed
-static float previousScaleFactor = 1.0; // Initially, no scaling
-float scaleFactor = 1.0;
+static q15_t previousScaleFactor = dQ15_ONE; // Initially, no scaling
+q15_t scaleFactor = dQ15_ONE;
 int thumbleCurrent = abs((int16_t)MotorManager_GetCurrent(Motor_Thumble)); // get thumble current
 
 // If current is less than 20A, maintain original speed
 if (thumbleCurrent < 20) {
     // Gradually increase scaleFactor if it's less than 1.0
-    if (previousScaleFactor < 1.0) {
-        previousScaleFactor += 0.01; // Smooth increase (adjust this step for desired smoothness)
-        if (previousScaleFactor > 1.0) {
-            previousScaleFactor = 1.0; // Limit it to the original speed
+    if (previousScaleFactor < dQ15_ONE) {
+        // Smooth increase (adjust this step for desired smoothness), limit it to the original speed
+        if (previousScaleFactor > dQ15_ONE - dQ15(0.01)) {
+            previousScaleFactor = dQ15_ONE;
+        }
+        else {
+            previousScaleFactor += dQ15(0.01);
         }
     }
     scaleFactor = previousScaleFactor;
 } 
 else if (thumbleCurrent >= 20 && thumbleCurrent <= 40) {
-    // Calculate the scale factor for current between 20A and 40A
-    scaleFactor = 0.7 - ((thumbleCurrent - 20) * (0.7 - 0.1) / 20.0);
+    // Calculate the scale factor for current between 20A and 40A, (0.7 - 0.1) / 20 per 1A
+    scaleFactor = dQ15(0.7) - (q15_t)((thumbleCurrent - 20) * dQ15(0.03));
     
     // Apply the calculated scale factor and update previousScaleFactor
     previousScaleFactor = scaleFactor;
 } 
 else {
-    // If current is greater than 40A, set speed to 0.1
-    scaleFactor = 0.05;
+    // If current is greater than 40A, set speed to 0.05
+    scaleFactor = dQ15(0.05);
     previousScaleFactor = scaleFactor;
 }
 
 // Apply the scale factor to the wheel speeds
-RightSpeed = RightSpeed * scaleFactor;
-LeftSpeed = LeftSpeed * scaleFactor;
-    
-    if(EncoderFinishedPercent<accelPecent && accelerating)//acceleration
-    {
-        RightSpeed = RightSpeed * ((EncoderFinishedPercent*(1/accelPecent-lowPrecent*2))+lowPrecent);//accelerate from 20 to 100% in first half of the step
-        LeftSpeed = LeftSpeed * ((EncoderFinishedPercent*(1/accelPecent-lowPrecent*2))+lowPrecent);
-    }
-    else if(EncoderFinishedPercent>decelPecent && EncoderFinishedPercent<1 && decelerate)
-    {
-        RightSpeed = RightSpeed * (1-(EncoderFinishedPercent-decelPecent)*((1/(1-decelPecent))-lowPrecent*2));//decelerate from 100 to 20% in second half of the step
-        LeftSpeed = LeftSpeed * (1-(EncoderFinishedPercent-decelPecent)*((1/(1-decelPecent))-lowPrecent*2));
-    }
-    else if(EncoderFinishedPercent>=1 && decelerate)
-    {
-        RightSpeed = RightSpeed * lowPrecent;
-        LeftSpeed = LeftSpeed * lowPrecent;
-    }
+RightSpeed = FixedPoint_ScaleU16Q15(RightSpeed, scaleFactor);
+LeftSpeed = FixedPoint_ScaleU16Q15(LeftSpeed, scaleFactor);
     
-    float proportionalCorrectionTreasholdAngle = 3;//on this angle, correction proportional regulation is based
-    float correctionFactor = -(fabs(CalulatedAngle / proportionalCorrectionTreasholdAngle) - 1.0f);
+    q16_t correctionFactor = dQ16_ONE - FixedPoint_Q16Mul(FixedPoint_Q16Abs(CalulatedAngle), dQ16(1.0 / dPROPORTIONAL_CORRECTION_ANGLE));
 
     
-        if (CalulatedAngle <= - dCORRECTION_ANGLE_THRESHOLD){
+        if (CalulatedAngle <= - dCORRECTION_ANGLE_THRESHOLD_Q16){
                 VelocityCorrection = true;
                 
-                if(fabs(CalulatedAngle)<proportionalCorrectionTreasholdAngle)
+                if(FixedPoint_Q16Abs(CalulatedAngle) < dQ16_FROM_INT(dPROPORTIONAL_CORRECTION_ANGLE))
                 {
-                    MotorManager_SetSpeed(Motor_Right, RightSpeed*correctionFactor);
+                    MotorManager_SetSpeed(Motor_Right, FixedPoint_ScaleU16(RightSpeed, correctionFactor));
                     MotorManager_StartMotorKeepDirection(Motor_Right);
                 }
                 else
@@ -1343,12 +1383,12 @@ LeftSpeed = LeftSpeed * scaleFactor;
                 MotorManager_SetSpeed(Motor_Left, LeftSpeed);
                 MotorManager_StartMotorKeepDirection(Motor_Left);
             }
-        else if (CalulatedAngle > dCORRECTION_ANGLE_THRESHOLD){
+        else if (CalulatedAngle > dCORRECTION_ANGLE_THRESHOLD_Q16){
                 VelocityCorrection = true;
                 
-                if(fabs(CalulatedAngle)<proportionalCorrectionTreasholdAngle)
+                if(FixedPoint_Q16Abs(CalulatedAngle) < dQ16_FROM_INT(dPROPORTIONAL_CORRECTION_ANGLE))
                 {
-                    MotorManager_SetSpeed(Motor_Left, LeftSpeed*correctionFactor);
+                    MotorManager_SetSpeed(Motor_Left, FixedPoint_ScaleU16(LeftSpeed, correctionFactor));
                     MotorManager_StartMotorKeepDirection(Motor_Left);
                 }
                 else
@@ -1372,44 +1412,23 @@ LeftSpeed = LeftSpeed * scaleFactor;
         }
 }
 
-void RouteManager_AutomaticCorrectionReverse(float Angle)
+void RouteManager_AutomaticCorrectionReverse(q16_t Angle)
 {
 
-    CalulatedAngle = IMUHandler_CalculateAngle(DesiredAngle+MagnetCorrectionAngle, Angle);
+    CalulatedAngle = IMUHandler_CalculateAngleQ16(DesiredAngleQ16 + MagnetCorrectionAngleQ16, Angle);
 
     uint16_t RightSpeed = MotorManager_GetStepSpeed(Motor_Right);
     uint16_t LeftSpeed = MotorManager_GetStepSpeed(Motor_Left);
     
-    float accelPecent = 0.3; //precent of route the acceleration will stop
-    float decelPecent = 0.7; //precent of route the deceleration will start
-    float lowPrecent = 0.2;//slowest speed in precent of stepspeed
-    
-    if(EncoderFinishedPercent<accelPecent && accelerating)//acceleration
-    {
-        RightSpeed = RightSpeed * ((EncoderFinishedPercent*(1/accelPecent-lowPrecent*2))+lowPrecent);//accelerate from 20 to 100% in first half of the step
-        LeftSpeed = LeftSpeed * ((EncoderFinishedPercent*(1/accelPecent-lowPrecent*2))+lowPrecent);
-    }
-    else if(EncoderFinishedPercent>decelPecent && EncoderFinishedPercent<1 && decelerate)
-    {
-        RightSpeed = RightSpeed * (1-(EncoderFinishedPercent-decelPecent)*((1/(1-decelPecent))-lowPrecent*2));//decelerate from 100 to 20% in second half of the step
-        LeftSpeed = LeftSpeed * (1-(EncoderFinishedPercent-decelPecent)*((1/(1-decelPecent))-lowPrecent*2));
-    }
-    else if(EncoderFinishedPercent>=1 && decelerate)
-    {
-        RightSpeed = RightSpeed * lowPrecent;
-        LeftSpeed = LeftSpeed * lowPrecent;
-    }
-    
-    float proportionalCorrectionTreasholdAngle = 3;//on this angle, correction proportional regulation is based
-    float correctionFactor = -(fabs(CalulatedAngle / proportionalCorrectionTreasholdAngle) - 1.0f);
+    q16_t correctionFactor = dQ16_ONE - FixedPoint_Q16Mul(FixedPoint_Q16Abs(CalulatedAngle), dQ16(1.0 / dPROPORTIONAL_CORRECTION_ANGLE));
 
     
-        if (CalulatedAngle >= dCORRECTION_ANGLE_THRESHOLD){
+        if (CalulatedAngle >= dCORRECTION_ANGLE_THRESHOLD_Q16){
                 VelocityCorrection = true;
                 
-                if(fabs(CalulatedAngle)<proportionalCorrectionTreasholdAngle)
+                if(FixedPoint_Q16Abs(CalulatedAngle) < dQ16_FROM_INT(dPROPORTIONAL_CORRECTION_ANGLE))
                 {
-                    MotorManager_SetSpeed(Motor_Right, RightSpeed*correctionFactor);
+                    MotorManager_SetSpeed(Motor_Right, FixedPoint_ScaleU16(RightSpeed, correctionFactor));
                     MotorManager_StartMotorKeepDirection(Motor_Right);
                 }
                 else
@@ -1421,12 +1440,12 @@ void RouteManager_AutomaticCorrectionReverse(float Angle)
                 MotorManager_SetSpeed(Motor_Left, LeftSpeed);
                 MotorManager_StartMotor(Motor_Left, MotorManager_GetStepDirection(Motor_Left));
             }
-        else if (CalulatedAngle < -dCORRECTION_ANGLE_THRESHOLD){
+        else if (CalulatedAngle < -dCORRECTION_ANGLE_THRESHOLD_Q16){
                 VelocityCorrection = true;
                 
-                if(fabs(CalulatedAngle)<proportionalCorrectionTreasholdAngle)
+                if(FixedPoint_Q16Abs(CalulatedAngle) < dQ16_FROM_INT(dPROPORTIONAL_CORRECTION_ANGLE))
                 {
-                    MotorManager_SetSpeed(Motor_Left, LeftSpeed*correctionFactor);
+                    MotorManager_SetSpeed(Motor_Left, FixedPoint_ScaleU16(LeftSpeed, correctionFactor));
                     MotorManager_StartMotorKeepDirection(Motor_Left);
                 }
                 else
@@ -1,9 +1,11 @@
 
 #include "pmb_System.h"
+#include "Tools/FixedPoint.h"
 
 
 /* Powyzej jakiej wartosci (w stopniach) ma byc dokrecanie w trybie NORM  */
 #define dCORRECTION_ANGLE_THRESHOLD 0.5f
+#define dCORRECTION_ANGLE_THRESHOLD_Q16 dQ16(dCORRECTION_ANGLE_THRESHOLD)
 
 /* Dokladnosc w stopniach podczas skrecania (przy 90 stopniach wystarczy osiagnac 85 zeby zakonczyc krok) */
 #define d90DEG_OFFSET 0
@@ -26,6 +28,8 @@
 /* IMU influence on step finish decision, default 50% IMU, 50% encoders */
 #define dIMU_JUDGEMENT_FACTOR 1.0f
 #define dECODER_JUDGEMENT_FACTOR (1.0f - dIMU_JUDGEMENT_FACTOR)
+#define dIMU_JUDGEMENT_FACTOR_Q16 dQ16(dIMU_JUDGEMENT_FACTOR)
+#define dECODER_JUDGEMENT_FACTOR_Q16 dQ16(dECODER_JUDGEMENT_FACTOR)
 
 /* After achieving 120% of encode value, step should be broken */
 #define dENCODER_STEP_MAX_MULTIPLIER 1.5f
@@ -57,6 +61,7 @@
 #else
 #define dDISTANCE_PER_MOTOR_ROTATION 1.26f
 #endif
+#define dDISTANCE_PER_MOTOR_ROTATION_Q16 dQ16(dDISTANCE_PER_MOTOR_ROTATION)
 
 #define dMAGNETS_DEBOUCE_CNT 5U
 #define dMAGNETS_ACTIVE_THRESHOLD 10U
@@ -18,6 +18,7 @@ extern "C" {
 #define COMPILE_SWITCH_MOOVER_1 1
 #define COMPILE_SWITCH_MOOVER_3 0
 #define COMPILE_SWITCH_MOONION 0
+#define COMPILE_SWITCH_PROFILER 1 //Main loop execution time measurement
     
 //Machine Defines
 #define GEAR_SHIFT_N 100 //Ratio of the Gear Shift for wheels
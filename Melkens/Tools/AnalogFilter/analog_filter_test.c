@@ -0,0 +1,276 @@
+/*
+ * Host driver of analog_filter_test.py, built together with
+ * Melkens_PMB/AnalogHandler/AnalogFilter.c and AnalogHandler.c against a
+ * model of the ADC (mcc_generated_files/adc1.h stub written by the script).
+ *
+ * The TMR1 interrupt is a POSIX timer signal that preempts the reader at any
+ * instruction and runs to completion, as on the single core dsPIC.
+ *
+ * Prints:
+ *   <case> ok [<what was measured>]
+ *   <case> FAIL <what>
+ */
+
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "AnalogHandler/AnalogFilter.h"
+#include "AnalogHandler/AnalogHandler.h"
+
+#define SNAPSHOT_READS      2000000u
+#define CHANNEL_STEP        37u         // rough value of a channel differs per channel
+
+static int Failures;
+
+// ADC model: every channel of a scan converts (scan + channel * CHANNEL_STEP)
+static volatile uint16_t Scan;
+
+bool ADC1_IsConversionComplete(ADC1_CHANNEL channel)
+{
+    (void)channel;
+    return true;
+}
+
+uint16_t ADC1_ConversionResultGet(ADC1_CHANNEL channel)
+{
+    return (uint16_t)((Scan + channel * CHANNEL_STEP) & 0x0FFFu);
+}
+
+void ADC1_SoftwareTriggerEnable(void)
+{
+}
+
+void ADC1_SoftwareTriggerDisable(void)
+{
+    Scan++;
+}
+
+static void Check(const char *name, bool condition, const char *what)
+{
+    if (!condition) {
+        printf("%s FAIL %s\n", name, what);
+        Failures++;
+    }
+}
+
+static void Report(const char *name, int failuresBefore, const char *measured)
+{
+    if (Failures == failuresBefore) {
+        printf("%s ok %s\n", name, measured);
+    }
+}
+
+static uint16_t RoundedMean(uint32_t sum, uint8_t decimation)
+{
+    // mean in Q4 truncated, then rounded to counts, as on target
+    uint32_t q4 = (sum << dANALOG_FILTER_FRACTION_BITS) / decimation;
+
+    return (uint16_t)((q4 + (1u << (dANALOG_FILTER_FRACTION_BITS - 1))) >> dANALOG_FILTER_FRACTION_BITS);
+}
+
+static void BoxcarDecimation(void)
+{
+    static const uint8_t decimations[] = { 1, 2, 3, 4, 10, 16 };
+    const char *name = "boxcar_decimation";
+    int before = Failures;
+    AnalogFilter filter;
+    AnalogFilterConfig config;
+    uint32_t sum, i;
+    uint16_t sample;
+    uint8_t d;
+    double worst = 0.0;
+    char measured[64];
+
+    for (d = 0; d < sizeof(decimations); d++) {
+        config.Decimation = decimations[d];
+        config.IIRShift = 0;
+        AnalogFilter_Init(&filter);
+        sum = 0;
+        for (i = 0; i < 4000u; i++) {
+            // full scale saw with noise like steps, 4095 included
+            sample = (uint16_t)((i * 2731u + (i & 7u) * 509u) % 4096u);
+            sum += sample;
+            if (AnalogFilter_AddSample(&filter, &config, sample) != (((i + 1u) % config.Decimation) == 0u)) {
+                Check(name, false, "output not every Decimation samples");
+                break;
+            }
+            if (((i + 1u) % config.Decimation) == 0u) {
+                double error = fabs(filter.Output - (double)sum / config.Decimation);
+
+                Check(name, filter.Output == RoundedMean(sum, config.Decimation), "not the rounded mean");
+                worst = (error > worst) ? error : worst;
+                sum = 0;
+            }
+        }
+    }
+    config.Decimation = 0;
+    AnalogFilter_Init(&filter);
+    Check(name, AnalogFilter_AddSample(&filter, &config, 100) && filter.Output == 100u, "Decimation 0 not 1");
+    Check(name, worst <= 0.5 + 1.0 / (1 << dANALOG_FILTER_FRACTION_BITS), "error above half a count");
+    snprintf(measured, sizeof(measured), "max error %.3f counts", worst);
+    Report(name, before, measured);
+}
+
+static void IirStartAndStep(void)
+{
+    static const uint8_t shifts[] = { 1, 2, 3, 4, 5, 8 };
+    const char *name = "iir_start_and_step";
+    int before = Failures;
+    AnalogFilter filter;
+    AnalogFilterConfig config;
+    double reference, worst = 0.0;
+    uint32_t i;
+    uint16_t target, steps[] = { 1000, 3000, 0, 4095, 2047 };
+    uint8_t s, k;
+    char measured[64];
+
+    config.Decimation = 4;
+    for (s = 0; s < sizeof(shifts); s++) {
+        config.IIRShift = shifts[s];
+        AnalogFilter_Init(&filter);
+        // first output is the first mean, no ramp up from zero
+        for (i = 0; i < 4u; i++) {
+            AnalogFilter_AddSample(&filter, &config, 2500);
+        }
+        Check(name, filter.Output == 2500u, "start value ramps from zero");
+        reference = 2500.0;
+        for (k = 0; k < sizeof(steps) / sizeof(steps[0]); k++) {
+            target = steps[k];
+            for (i = 0; i < 4u * 4000u; i++) {
+                if (AnalogFilter_AddSample(&filter, &config, target)) {
+                    double error;
+
+                    reference += (target - reference) / (double)(1u << config.IIRShift);
+                    error = fabs(filter.Output - reference);
+                    worst = (error > worst) ? error : worst;
+                }
+            }
+            // settles on the input in both directions, no offset left by the shift
+            Check(name, filter.Output == target, "step does not settle on the input");
+        }
+    }
+    Check(name, worst <= 1.0, "step response off the exponential by more than a count");
+    snprintf(measured, sizeof(measured), "max error %.3f counts against exponential", worst);
+    Report(name, before, measured);
+}
+
+static void Rounding(void)
+{
+    static const AnalogFilterConfig configs[] = { { 1, 0 }, { 4, 3 }, { 10, 5 }, { 16, 8 } };
+    static const AnalogFilterConfig two = { 2, 0 };
+    const char *name = "rounding";
+    int before = Failures;
+    AnalogFilter filter;
+    uint32_t value, i;
+    uint8_t c;
+
+    // constant input comes out unchanged, every ADC count and configuration
+    for (c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        for (value = 0; value < 4096u; value++) {
+            AnalogFilter_Init(&filter);
+            for (i = 0; i < 3u * configs[c].Decimation; i++) {
+                AnalogFilter_AddSample(&filter, &configs[c], (uint16_t)value);
+            }
+            if (filter.Output != value) {
+                Check(name, false, "constant input changed");
+                c = sizeof(configs);
+                break;
+            }
+        }
+    }
+    // half counts round up
+    AnalogFilter_Init(&filter);
+    AnalogFilter_AddSample(&filter, &two, 10);
+    AnalogFilter_AddSample(&filter, &two, 11);
+    Check(name, filter.Output == 11u, "10.5 not rounded up");
+    Report(name, before, "");
+}
+
+static void Tick(void)
+{
+    AnalogHandler_SYSTICK_Handler();
+}
+
+static void OnTimer(int signal)
+{
+    (void)signal;
+    Tick();
+}
+
+// All channels of a snapshot come from the same scan
+static bool IsConsistent(const AnalogSnapshot *snapshot)
+{
+    // scan n is collected by tick n + 1, the first tick only starts a scan
+    uint16_t scan = (uint16_t)snapshot->SampleCount;
+    ADC1_CHANNEL c;
+
+    for (c = 0; c < ADC1_ChannelNumOf; c++) {
+        if (snapshot->Rough[c] != ((scan + c * CHANNEL_STEP) & 0x0FFFu)) {
+            return false;
+        }
+    }
+    // channels without decimation and IIR pass the sample
+    return snapshot->Filtered[StatSw1] == snapshot->Rough[StatSw1] &&
+           snapshot->Filtered[StatSw4] == snapshot->Rough[StatSw4];
+}
+
+static void SnapshotUnderInterrupt(void)
+{
+    const char *name = "snapshot_seqlock";
+    int before = Failures;
+    struct sigaction action;
+    struct sigevent event;
+    struct itimerspec period;
+    timer_t timer;
+    AnalogSnapshot snapshot;
+    uint32_t i, torn = 0, ticks;
+    uint16_t first;
+    char measured[64];
+
+    AnalogHandler_Init();
+    Scan = 0;
+    Tick();
+    Tick();         // first scan collected, SampleCount 1
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = OnTimer;
+    sigaction(SIGALRM, &action, NULL);
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo = SIGALRM;
+    timer_create(CLOCK_MONOTONIC, &event, &timer);
+    period.it_value.tv_sec = 0;
+    period.it_value.tv_nsec = 20000;
+    period.it_interval = period.it_value;
+    timer_settime(timer, 0, &period, NULL);
+
+    AnalogHandler_GetSnapshot(&snapshot);
+    first = snapshot.SampleCount;
+    for (i = 0; i < SNAPSHOT_READS; i++) {
+        AnalogHandler_GetSnapshot(&snapshot);
+        torn += IsConsistent(&snapshot) ? 0u : 1u;
+    }
+    ticks = (uint16_t)(snapshot.SampleCount - first);
+
+    memset(&period, 0, sizeof(period));
+    timer_settime(timer, 0, &period, NULL);
+    timer_delete(timer);
+    signal(SIGALRM, SIG_DFL);
+
+    Check(name, torn == 0u, "torn snapshot");
+    Check(name, ticks > 100u, "too few interrupts during the reads");
+    snprintf(measured, sizeof(measured), "%u reads, %u interrupts, %u torn", (unsigned)SNAPSHOT_READS,
+             (unsigned)ticks, (unsigned)torn);
+    Report(name, before, measured);
+}
+
+int main(void)
+{
+    BoxcarDecimation();
+    IirStartAndStep();
+    Rounding();
+    SnapshotUnderInterrupt();
+    return (Failures > 0) ? 1 : 0;
+}
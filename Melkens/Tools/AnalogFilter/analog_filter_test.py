@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Host test of the PMB ADC filtering, Melkens_PMB/AnalogHandler.
+
+Builds analog_filter_test.c with AnalogFilter.c and AnalogHandler.c against
+a model of the MCC ADC driver (channel list taken from adc1.h) and checks:
+  - boxcar decimation gives one output per Decimation samples, the mean
+    rounded to counts, Decimation 0 works as 1,
+  - the IIR starts at the first mean instead of ramping up from zero,
+    follows the exponential within a count and settles exactly on the
+    input after steps up and down,
+  - constant input of every ADC count comes out unchanged,
+  - AnalogHandler_GetSnapshot never returns channels of different scans
+    while the sampling interrupt (a POSIX timer signal) preempts it.
+
+Usage:
+  analog_filter_test.py [--cc cc] [--cflags "-O2"]
+"""
+
+import argparse
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+PMB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_PMB')
+SOURCES = ['AnalogFilter.c', 'AnalogFilter.h', 'AnalogHandler.c', 'AnalogHandler.h']
+
+# AnalogHandler.h includes ../mcc_generated_files/adc1.h, its inline functions
+# access ADC registers; the test implements these instead
+ADC_STUB = '''#ifndef _ADC1_H
+#define _ADC1_H
+#include <stdbool.h>
+#include <stdint.h>
+typedef enum {
+%s
+} ADC1_CHANNEL;
+bool ADC1_IsConversionComplete(ADC1_CHANNEL channel);
+uint16_t ADC1_ConversionResultGet(ADC1_CHANNEL channel);
+void ADC1_SoftwareTriggerEnable(void);
+void ADC1_SoftwareTriggerDisable(void);
+#endif
+'''
+
+
+def adc_channels():
+    with open(os.path.join(PMB_DIR, 'mcc_generated_files', 'adc1.h')) as file:
+        body = re.search(r'typedef enum\s*\{([^}]*)\}\s*ADC1_CHANNEL;', file.read()).group(1)
+    return re.findall(r'^\s*(\w+),?', re.sub(r'//.*', '', body), re.MULTILINE)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        os.mkdir(os.path.join(directory, 'AnalogHandler'))
+        os.mkdir(os.path.join(directory, 'mcc_generated_files'))
+        for name in SOURCES:
+            shutil.copy(os.path.join(PMB_DIR, 'AnalogHandler', name), os.path.join(directory, 'AnalogHandler'))
+        with open(os.path.join(directory, 'mcc_generated_files', 'adc1.h'), 'w') as stub:
+            stub.write(ADC_STUB % '\n'.join('    %s,' % name for name in adc_channels()))
+        output = os.path.join(directory, 'analog_filter_test')
+        command = [args.cc, '-std=gnu99', '-Wall', '-Wextra'] + shlex.split(args.cflags) + [
+            '-I' + directory, '-o', output,
+            os.path.join(TOOL_DIR, 'analog_filter_test.c'),
+            os.path.join(directory, 'AnalogHandler', 'AnalogFilter.c'),
+            os.path.join(directory, 'AnalogHandler', 'AnalogHandler.c'), '-lm', '-lrt']
+        subprocess.check_call(command)
+        result = subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True)
+
+    failed = result.returncode != 0
+    for line in result.stdout.splitlines():
+        fields = line.split(None, 2)
+        print('%-28s %s' % (fields[0], ' '.join(fields[1:])))
+        failed |= fields[1] != 'ok'
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,408 @@
+#!/usr/bin/env python3
+"""
+Decoder of the IMU binary log (Melkens_Lib/BinLog).
+
+BINLOG calls on the IMU send only the id of their format string, a cycle
+count and raw 32-bit arguments in LOG frames on the debug UART (USART3,
+460800 8N1, Imu2PCFrame bytes in between are skipped). The format strings
+stay in section binlog of the ELF, which is not loaded to flash; this tool
+reads them from the ELF of the running build or from a table extracted
+from it, so keep the ELF or the table of every image given out.
+
+Usage:
+  binlog.py extract Melkens_IMU.elf [-o formats.json]
+        format table of the build, id (offset in section binlog) -> format
+  binlog.py decode --formats Melkens_IMU.elf|formats.json capture.bin
+  binlog.py decode --formats Melkens_IMU.elf --port /dev/ttyUSB0 [--baud 460800]
+        prints "<s> <text>" per record, time from the IMU ms tick and the
+        cycle counter (--clock, HCLK 160 MHz); lost frames, records dropped
+        by a full ring and frames with bad CRC are reported. Port needs pyserial.
+  binlog.py test [--cc cc] [--cflags "-Wall -Wextra -O2"]
+        builds binlog_test.c with BinLog.c, decodes its stream with the table
+        of the test binary and compares with the printf output of the same
+        calls, checks resynchronisation on corrupted frames, the lock free
+        ring with two producer threads and prints the cost per call.
+"""
+
+import argparse
+import json
+import os
+import re
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+LIB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib')
+
+SECTION = 'binlog'
+SYNC = b'\x42\x4c'
+FRAME_HEADER_SIZE = 6
+FRAME_CRC_SIZE = 2
+FRAME_LENGTH_MAX = 4096
+FRAME_LOG = 1
+LOG_HEADER_SIZE = 12
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|t|j)?([diouxXcfFeEgG%])')
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def elf_section(data, name):
+    """Contents of a section of an ELF32/ELF64 file, None when missing."""
+    if data[:4] != b'\x7fELF':
+        raise ValueError('not an ELF file')
+    is64 = data[4] == 2
+    order = '<' if data[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(order + 'Q', data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(order + 'HHH', data, 0x3A)
+    else:
+        shoff, = struct.unpack_from(order + 'I', data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(order + 'HHH', data, 0x2E)
+
+    def header(index):
+        base = shoff + index * shentsize
+        if is64:
+            name_offset, kind, _, _, offset, size = struct.unpack_from(order + 'IIQQQQ', data, base)
+        else:
+            name_offset, kind, _, _, offset, size = struct.unpack_from(order + 'IIIIII', data, base)
+        return name_offset, kind, offset, size
+
+    _, _, names_offset, names_size = header(shstrndx)
+    names = data[names_offset:names_offset + names_size]
+    for index in range(shnum):
+        name_offset, kind, offset, size = header(index)
+        if names[name_offset:names.index(b'\0', name_offset)].decode() == name:
+            return b'' if kind == 8 else data[offset:offset + size]     # SHT_NOBITS
+    return None
+
+
+def formats_from_elf(path):
+    """Id -> format of every string in section binlog (padding between them skipped)."""
+    with open(path, 'rb') as file:
+        section = elf_section(file.read(), SECTION)
+    if section is None:
+        raise ValueError('%s has no %s section, no BINLOG calls or old build' % (path, SECTION))
+    formats = {}
+    offset = 0
+    while offset < len(section):
+        if section[offset] == 0:
+            offset += 1
+            continue
+        end = section.index(b'\0', offset)
+        formats[offset] = section[offset:end].decode('utf-8', 'replace')
+        offset = end + 1
+    return formats
+
+
+def load_formats(path):
+    if path.endswith('.json'):
+        with open(path) as file:
+            return {int(key): value for key, value in json.load(file)['formats'].items()}
+    return formats_from_elf(path)
+
+
+def format_record(format_string, args):
+    """Text of a record, arguments typed by the conversions of the format."""
+    values = []
+    pieces = []
+    last = 0
+    for match in CONVERSION.finditer(format_string):
+        flags, width, precision, _, conversion = match.groups()
+        pieces.append(format_string[last:match.start()].replace('%', '%%'))
+        last = match.end()
+        if conversion == '%':
+            pieces.append('%%')
+            continue
+        if len(values) >= len(args):
+            pieces.append('<missing>')
+            continue
+        raw = args[len(values)]
+        if conversion in 'di':
+            value = raw - (1 << 32) if raw & 0x80000000 else raw
+            conversion = 'd'
+        elif conversion in 'fFeEgG':
+            value = struct.unpack('<f', struct.pack('<I', raw))[0]
+        elif conversion == 'c':
+            value = chr(raw & 0xFF)
+        else:
+            value = raw
+            conversion = 'd' if conversion == 'u' else conversion
+        values.append(value)
+        pieces.append('%' + flags + width + ('.' + precision if precision is not None else '') + conversion)
+    pieces.append(format_string[last:].replace('%', '%%'))
+    if len(values) < len(args):
+        pieces.append(' <%d more arguments>' % (len(args) - len(values)))
+    return ''.join(pieces) % tuple(values)
+
+
+class FrameParser:
+    """Debug UART frames in a byte stream, other bytes skipped."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.bad_frames = 0
+        self.skipped = 0
+
+    def feed(self, data):
+        self.buffer += data
+        frames = []
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                keep = 1 if self.buffer[-1:] == SYNC[:1] else 0
+                self.skipped += len(self.buffer) - keep
+                del self.buffer[:len(self.buffer) - keep]
+                return frames
+            self.skipped += start
+            del self.buffer[:start]
+            if len(self.buffer) < FRAME_HEADER_SIZE:
+                return frames
+            frame_type, sequence, length = struct.unpack_from('<BBH', self.buffer, 2)
+            if length > FRAME_LENGTH_MAX:
+                self.skip_sync()
+                continue
+            size = FRAME_HEADER_SIZE + length + FRAME_CRC_SIZE
+            if len(self.buffer) < size:
+                return frames
+            crc, = struct.unpack_from('<H', self.buffer, size - FRAME_CRC_SIZE)
+            if crc != crc16(self.buffer[2:size - FRAME_CRC_SIZE]):
+                # sync inside other bytes or a broken frame, search on from the next byte
+                self.bad_frames += 1
+                self.skip_sync()
+                continue
+            frames.append((frame_type, sequence, bytes(self.buffer[FRAME_HEADER_SIZE:size - FRAME_CRC_SIZE])))
+            del self.buffer[:size]
+
+    def skip_sync(self):
+        self.skipped += 1
+        del self.buffer[:1]
+
+
+class LogDecoder:
+    """Lines of LOG frames: (seconds or None, text)."""
+
+    def __init__(self, formats, clock):
+        self.formats = formats
+        self.clock = clock
+        self.sequence = None
+        self.lost_frames = 0
+
+    def decode(self, sequence, payload):
+        lines = []
+        if self.sequence is not None and sequence != (self.sequence + 1) & 0xFF:
+            lost = (sequence - self.sequence - 1) & 0xFF
+            self.lost_frames += lost
+            lines.append((None, 'lost %d frames' % lost))
+        self.sequence = sequence
+        if len(payload) < LOG_HEADER_SIZE:
+            return lines + [(None, 'short LOG frame')]
+        tick, drain_time, dropped, _ = struct.unpack_from('<IIHH', payload, 0)
+        offset = LOG_HEADER_SIZE
+        while offset + 8 <= len(payload):
+            header, time = struct.unpack_from('<II', payload, offset)
+            words = header & 0x0F
+            if words < 2 or offset + words * 4 > len(payload):
+                lines.append((None, 'bad record'))
+                break
+            args = struct.unpack_from('<%dI' % (words - 2), payload, offset + 8)
+            offset += words * 4
+            # signed difference, the cycle counter wraps every 26.8s
+            delta = ((time - drain_time + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+            seconds = tick / 1000.0 + delta / self.clock
+            format_string = self.formats.get(header >> 16)
+            if format_string is None:
+                lines.append((seconds, '<format %d not in table, other build?> %s' %
+                              (header >> 16, ' '.join('%08x' % arg for arg in args))))
+            else:
+                lines.append((seconds, format_record(format_string, args)))
+        if dropped:
+            lines.append((None, 'dropped %d' % dropped))
+        return lines
+
+
+def decode_stream(chunks, formats, clock, output):
+    parser = FrameParser()
+    decoder = LogDecoder(formats, clock)
+    for chunk in chunks:
+        for frame_type, sequence, payload in parser.feed(chunk):
+            if frame_type != FRAME_LOG:
+                continue
+            for seconds, text in decoder.decode(sequence, payload):
+                output('%.6f %s' % (seconds, text) if seconds is not None else text)
+    return parser, decoder
+
+
+def command_extract(args):
+    formats = formats_from_elf(args.elf)
+    table = {'elf': os.path.basename(args.elf), 'formats': {str(key): value for key, value in sorted(formats.items())}}
+    text = json.dumps(table, indent=1, ensure_ascii=False) + '\n'
+    if args.output:
+        with open(args.output, 'w') as file:
+            file.write(text)
+    else:
+        sys.stdout.write(text)
+    return 0
+
+
+def command_decode(args):
+    formats = load_formats(args.formats)
+
+    def output(line):
+        print(line, flush=True)
+
+    if args.port:
+        try:
+            import serial
+        except ImportError as error:
+            print('error: %s, install pyserial' % error, file=sys.stderr)
+            return 1
+        port = serial.Serial(args.port, args.baud, timeout=0.05)
+        try:
+            decode_stream(iter(lambda: port.read(4096), None), formats, args.clock, output)
+        except KeyboardInterrupt:
+            pass
+        return 0
+    if not args.capture:
+        print('error: capture file or --port required', file=sys.stderr)
+        return 1
+    with open(args.capture, 'rb') as file:
+        parser, decoder = decode_stream([file.read()], formats, args.clock, output)
+    print('%d bad frames, %d lost frames, %d bytes skipped' % (parser.bad_frames, decoder.lost_frames, parser.skipped),
+          file=sys.stderr)
+    return 0
+
+
+def parse_expected(lines):
+    result = []
+    for line in lines:
+        if line.startswith('dropped') or line.startswith('driver'):
+            result.append((None, line))
+        else:
+            seconds, text = line.split(' ', 1)
+            result.append((float(seconds), text))
+    return result
+
+
+def compare(expected, decoded):
+    """Problems of decoded lines against expected ones, times within 1 us."""
+    if len(expected) != len(decoded):
+        return ['%d lines decoded, %d expected' % (len(decoded), len(expected))]
+    for index, ((expected_time, expected_text), (time, text)) in enumerate(zip(expected, decoded)):
+        if expected_text != text or (expected_time is None) != (time is None) or \
+                (time is not None and abs(time - expected_time) > 1e-6):
+            return ['line %d: %s %s, expected %s %s' % (index + 1, time, text, expected_time, expected_text)]
+    return []
+
+
+def command_test(args):
+    failed = False
+    outputs = []
+    with tempfile.TemporaryDirectory() as directory:
+        binary = os.path.join(directory, 'binlog_test')
+        subprocess.check_call([args.cc, '-std=gnu11', '-pthread', '-DBINLOG_RING_WORDS=64'] + shlex.split(args.cflags) + [
+            '-I' + os.path.join(LIB_DIR, 'BinLog'), '-I' + os.path.join(LIB_DIR, 'CRC16'), '-o', binary,
+            os.path.join(TOOL_DIR, 'binlog_test.c'), os.path.join(LIB_DIR, 'BinLog', 'BinLog.c'),
+            os.path.join(LIB_DIR, 'CRC16', 'CRC16.c')])
+        formats = formats_from_elf(binary)
+        for run in range(2):
+            frames_path = os.path.join(directory, 'frames%d.bin' % run)
+            expected_path = os.path.join(directory, 'expected%d.txt' % run)
+            result = subprocess.run([binary, frames_path, expected_path], stdout=subprocess.PIPE,
+                                    universal_newlines=True, check=True)
+            with open(frames_path, 'rb') as file:
+                frames = file.read()
+            with open(expected_path) as file:
+                expected_lines = file.read().splitlines()
+            outputs.append((frames, expected_lines, result.stdout))
+    frames, expected_lines, stdout = outputs[0]
+    values = {line.split()[0]: line.split()[1:] for line in stdout.splitlines()}
+
+    problems = []
+    if outputs[1][:2] != outputs[0][:2]:
+        problems.append('second run differs')
+    expected = parse_expected(expected_lines)
+    decoded = []
+    # fed in odd chunks, frames split between reads of the port
+    chunks = [frames[index:index + 61] for index in range(0, len(frames), 61)]
+    parser, decoder = decode_stream(chunks, formats, 160e6, lambda line: decoded.append(line))
+    problems += compare(expected, parse_expected(decoded))
+    if decoder.lost_frames:
+        problems.append('%d frames lost' % decoder.lost_frames)
+    print('decode   %d records, %d false syncs skipped: %s' %
+          (sum(1 for time, _ in expected if time is not None), parser.bad_frames, '; '.join(problems) or 'ok'))
+    failed |= bool(problems)
+
+    # one byte changed in every 7th frame, not the first or last: exactly those frames go
+    problems = []
+    corrupted = bytearray(frames)
+    starts = []
+    offset = 0
+    while offset < len(frames):
+        starts.append(offset)
+        length, = struct.unpack_from('<H', frames, offset + 4)
+        offset += FRAME_HEADER_SIZE + length + FRAME_CRC_SIZE + 18     # Imu2PCFrame-like bytes after each
+    hit = starts[3:-1:7]
+    for start in hit:
+        corrupted[start + FRAME_HEADER_SIZE + LOG_HEADER_SIZE + 1] ^= 0x5A
+    decoded = []
+    _, decoder = decode_stream([bytes(corrupted)], formats, 160e6, lambda line: decoded.append(line))
+    lost = sum(1 for line in decoded if line.startswith('lost'))
+    if decoder.lost_frames != len(hit) or lost != len(hit):
+        problems.append('%d frames reported lost, %d corrupted' % (decoder.lost_frames, len(hit)))
+    print('resync   %d of %d frames corrupted: %s' % (len(hit), len(starts), '; '.join(problems) or 'ok'))
+    failed |= bool(problems)
+
+    records, dropped, errors = (int(value) for value in values['stress'])
+    problems = []
+    if errors:
+        problems.append('%d bad records' % errors)
+    if records + dropped != 2 * 200000:
+        problems.append('%d records + %d dropped of %d' % (records, dropped, 2 * 200000))
+    print('stress   2 producers, %d records, %d dropped: %s' % (records, dropped, '; '.join(problems) or 'ok'))
+    failed |= bool(problems)
+
+    print('cost     %s ns per BINLOG call on this host' % values['cost_ns'][0])
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    commands = parser.add_subparsers(dest='command')
+    commands.required = True
+
+    parser_extract = commands.add_parser('extract', help='format table of an ELF')
+    parser_extract.add_argument('elf')
+    parser_extract.add_argument('-o', '--output', help='JSON file, default stdout')
+    parser_extract.set_defaults(function=command_extract)
+
+    parser_decode = commands.add_parser('decode', help='decode a capture or a serial port')
+    parser_decode.add_argument('--formats', required=True, help='ELF of the running build or extracted table')
+    parser_decode.add_argument('capture', nargs='?', help='raw bytes of the IMU debug UART')
+    parser_decode.add_argument('--port', help='serial port on USART3 TX')
+    parser_decode.add_argument('--baud', type=int, default=460800)
+    parser_decode.add_argument('--clock', type=float, default=160e6, help='[Hz] cycle counter of the timestamps')
+    parser_decode.set_defaults(function=command_decode)
+
+    parser_test = commands.add_parser('test', help='host test of BinLog and this decoder')
+    parser_test.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser_test.add_argument('--cflags', default='-Wall -Wextra -O2')
+    parser_test.set_defaults(function=command_test)
+
+    args = parser.parse_args()
+    return args.function(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,249 @@
+/*
+ * Host driver of binlog.py test, built with Melkens_Lib/BinLog/BinLog.c and
+ * CRC16.c (-DBINLOG_RING_WORDS=64, small ring so records wrap and overflow).
+ *
+ * binlog_test <frames> <expected> writes:
+ *   frames    debug UART stream: LOG frames with Imu2PCFrame-like bytes in
+ *             between (some holding the frame sync)
+ *   expected  one line per record the decoder has to print, "<s> <text>",
+ *             and "dropped <n>" where the ring was full
+ * and prints to stdout:
+ *   stress <records> <dropped> <errors>  two producer threads, one consumer
+ *   cost_ns <ns per BINLOG call>
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "BinLog.h"
+#include "CRC16.h"
+
+#define CLOCK_HZ        160000000.0
+#define CLOCK_STEP      37u             // time source per call
+#define FRAME_SIZE      128u
+#define PENDING_MAX     64u
+#define STRESS_RECORDS  200000u
+#define COST_BLOCKS     20000u
+#define COST_BLOCK      8u              // records of 4 words, half the ring
+
+static volatile uint32_t Clock;
+static FILE *Frames;
+static FILE *Expected;
+static uint32_t Tick;                   // [ms]
+
+// Records logged since the last drain: time source at the call and text
+static struct {
+    uint32_t Time;
+    char Text[96];
+} Pending[PENDING_MAX];
+static uint8_t PendingCount;
+
+static uint32_t GetTime(void)
+{
+    Clock += CLOCK_STEP;
+    return Clock;
+}
+
+#define LOG(format, ...) \
+    do { \
+        BINLOG(format, ##__VA_ARGS__); \
+        Pending[PendingCount].Time = Clock; \
+        snprintf(Pending[PendingCount].Text, sizeof(Pending[0].Text), format, ##__VA_ARGS__); \
+        PendingCount++; \
+    } while (0)
+
+static void Junk(uint8_t seed)
+{
+    // Imu2PCFrame_t size, sometimes with the log frame sync in it
+    uint8_t junk[18];
+    uint8_t i;
+
+    for (i = 0; i < sizeof(junk); i++) {
+        junk[i] = (uint8_t)(seed * 31u + i * 7u);
+    }
+    if (seed & 1u) {
+        junk[4] = dBINLOG_FRAME_SYNC0;
+        junk[5] = dBINLOG_FRAME_SYNC1;
+    }
+    junk[16] = '\r';
+    junk[17] = '\n';
+    fwrite(junk, 1, sizeof(junk), Frames);
+}
+
+static uint32_t Get32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// Drains everything like DebugUart_Perform. The records of a frame are the
+// next pending ones, their times are relative to the time source the frame
+// was made at; the decoder reports a dropped count after the frame records.
+static void Drain(void)
+{
+    static uint8_t frame[FRAME_SIZE];
+    static uint8_t junkSeed;
+    uint16_t length, offset, dropped;
+    uint32_t drainTime;
+    uint8_t next = 0;
+
+    Tick += 3u;
+    while ((length = BinLog_Drain(frame, sizeof(frame), Tick)) > 0) {
+        drainTime = Get32(&frame[10]);
+        fwrite(frame, 1, length, Frames);
+        Junk(junkSeed++);
+        for (offset = 18u; offset < length - 2u; offset += (uint16_t)((Get32(&frame[offset]) & 0x0Fu) * 4u)) {
+            fprintf(Expected, "%.6f %s\n",
+                    Tick / 1000.0 + (double)(int32_t)(Pending[next].Time - drainTime) / CLOCK_HZ, Pending[next].Text);
+            next++;
+        }
+        dropped = (uint16_t)(frame[14] | (frame[15] << 8));
+        if (dropped != 0u) {
+            fprintf(Expected, "dropped %u\n", (unsigned)dropped);
+        }
+    }
+    if (next != PendingCount) {
+        fprintf(Expected, "driver: %u records pending, %u drained\n", (unsigned)PendingCount, (unsigned)next);
+    }
+    PendingCount = 0;
+}
+
+static void Deterministic(void)
+{
+    float speed = -0.125f;
+    double heading = 2.25;
+    int16_t error = -321;
+    uint8_t flags = 0xA5;
+    uint32_t i;
+
+    Clock = 0xFFFFF000u;     // wraps in the middle
+    for (i = 0; i < 40u; i++) {
+        LOG("boot");
+        LOG("tick %u", (unsigned)i);
+        LOG("wheel %d %d", error + (int)i, -(int)i);
+        LOG("pose %.3f %f %5d", speed * (float)i, heading, error);
+        LOG("flags %02x %X %c %u", flags, 0xDEADBEEFu, 'A' + (int)(i % 26u), 4000000000u);
+        Drain();
+    }
+
+    // Ring full: 4 word records, 16 fit into 64 words
+    for (i = 0; i < 16u; i++) {
+        LOG("burst %u %d", (unsigned)i, -(int)i);
+    }
+    for (i = 0; i < 10u; i++) {
+        BINLOG("burst %u %d", (unsigned)i, -(int)i);
+    }
+    Drain();
+    LOG("after burst %e", 1.0e-3f);
+    Drain();
+}
+
+static volatile uint32_t StressFinished;
+
+static void *StressProducer(void *argument)
+{
+    uint32_t thread = (uint32_t)(uintptr_t)argument;
+    uint32_t i;
+
+    for (i = 0; i < STRESS_RECORDS; i++) {
+        BINLOG("stress %u %u %u", thread, i, ~i);
+        if ((i & 15u) == 0u) {
+            // consumer gets to run on a host with few cores, as the main loop does between interrupts
+            sched_yield();
+        }
+    }
+    __atomic_fetch_add(&StressFinished, 1u, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Records of both threads come complete and in order of each thread, every
+// record is either received or counted as dropped
+static void Stress(void)
+{
+    static uint8_t frame[FRAME_SIZE];
+    pthread_t threads[2];
+    uint32_t next[2] = {0, 0};
+    uint32_t records = 0, dropped = 0, errors = 0;
+    uint32_t header, thread, sequence;
+    uint16_t length, offset;
+    bool isFinished;
+
+    BinLog_Init(GetTime);
+    pthread_create(&threads[0], NULL, StressProducer, (void *)(uintptr_t)0);
+    pthread_create(&threads[1], NULL, StressProducer, (void *)(uintptr_t)1);
+    do {
+        isFinished = (__atomic_load_n(&StressFinished, __ATOMIC_ACQUIRE) == 2u);
+        while ((length = BinLog_Drain(frame, sizeof(frame), 0)) > 0) {
+            if (CRC16(&frame[2], (uint16_t)(length - 4u)) != (uint16_t)(frame[length - 2u] | (frame[length - 1u] << 8))) {
+                errors++;
+            }
+            dropped += (uint32_t)(frame[14] | (frame[15] << 8));
+            for (offset = 18u; offset < length - 2u; offset += 20u) {
+                header = Get32(&frame[offset]);
+                thread = Get32(&frame[offset + 8u]);
+                sequence = Get32(&frame[offset + 12u]);
+                if ((header & 0x0Fu) != 5u || thread > 1u || sequence < next[thread] ||
+                    Get32(&frame[offset + 16u]) != ~sequence) {
+                    errors++;
+                    continue;
+                }
+                next[thread] = sequence + 1u;
+                records++;
+            }
+        }
+    } while (!isFinished || !BinLog_IsEmpty());
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    printf("stress %u %u %u\n", (unsigned)records, (unsigned)dropped, (unsigned)errors);
+}
+
+static double Now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void Cost(void)
+{
+    static uint8_t frame[FRAME_SIZE];
+    double spent = 0.0, start;
+    uint32_t block, i;
+
+    BinLog_Init(GetTime);
+    for (block = 0; block < COST_BLOCKS; block++) {
+        start = Now();
+        for (i = 0; i < COST_BLOCK; i++) {
+            BINLOG("cost %u %u", i, block);
+        }
+        spent += Now() - start;
+        while (BinLog_Drain(frame, sizeof(frame), 0) > 0) {
+        }
+    }
+    printf("cost_ns %.1f\n", spent * 1e9 / (COST_BLOCKS * COST_BLOCK));
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "usage: binlog_test <frames> <expected>\n");
+        return 2;
+    }
+    Frames = fopen(argv[1], "wb");
+    Expected = fopen(argv[2], "w");
+    if (Frames == NULL || Expected == NULL) {
+        return 2;
+    }
+    CRC16_Init();
+    BinLog_Init(GetTime);
+    Deterministic();
+    fclose(Frames);
+    fclose(Expected);
+
+    Stress();
+    Cost();
+    return 0;
+}
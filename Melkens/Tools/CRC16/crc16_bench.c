@@ -0,0 +1,104 @@
+/*
+ * Host driver of crc16_bench.py, built once per backend together with
+ * Melkens_Lib/CRC16/CRC16.c (-DCRC16_BACKEND=...).
+ *
+ * Prints:
+ *   check <crc of "123456789">
+ *   errors <mismatches against bitwise reference, whole and split updates>
+ *   digest <xor-rotate of all conformance CRCs, equal for all backends>
+ *   throughput <bytes per call> <MB/s>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "CRC16.h"
+
+#define BUFFER_SIZE 4096
+#define MAX_OFFSET  8
+#define MAX_LENGTH  300
+
+static uint8_t Buffer[BUFFER_SIZE + MAX_OFFSET];
+
+static uint16_t Reference(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    uint8_t bit;
+
+    while (length--) {
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static double Now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint16_t Sizes[] = {34, 46, 62, 89, 1024, BUFFER_SIZE};
+    double seconds = (argc > 1) ? atof(argv[1]) : 0.2;
+    uint32_t seed = 12345;
+    uint32_t digest = 0;
+    uint32_t errors = 0;
+    uint16_t offset, length, split;
+    uint32_t i;
+
+    CRC16_Init();
+
+    for (i = 0; i < sizeof(Buffer); i++) {
+        seed = seed * 1103515245u + 12345u;
+        Buffer[i] = (uint8_t)(seed >> 16);
+    }
+
+    printf("check %04x\n", CRC16((const uint8_t *)"123456789", 9));
+
+    for (offset = 0; offset < MAX_OFFSET; offset++) {
+        for (length = 0; length <= MAX_LENGTH; length++) {
+            uint16_t expected = Reference(dCRC16_INIT, &Buffer[offset], length);
+            uint16_t crc = CRC16(&Buffer[offset], length);
+
+            errors += (crc != expected);
+            digest = ((digest << 5) | (digest >> 27)) ^ crc;
+            for (split = 0; split <= length; split += 7) {
+                crc = CRC16_Update(CRC16_Update(dCRC16_INIT, &Buffer[offset], split),
+                                   &Buffer[offset + split], (uint16_t)(length - split));
+                errors += (crc != expected);
+            }
+        }
+    }
+    // Any start value, not only dCRC16_INIT
+    for (i = 0; i < 1000; i++) {
+        uint16_t start = (uint16_t)(i * 65.537);
+        errors += (CRC16_Update(start, Buffer, (uint16_t)(i % 97)) != Reference(start, Buffer, i % 97));
+    }
+    printf("errors %u\n", errors);
+    printf("digest %08x\n", digest);
+
+    for (i = 0; i < sizeof(Sizes) / sizeof(Sizes[0]); i++) {
+        volatile uint16_t sink = 0;
+        uint32_t calls = 0;
+        uint32_t batch = 1u + (1u << 20) / Sizes[i];
+        double start = Now();
+        double elapsed;
+
+        do {
+            uint32_t n;
+            for (n = 0; n < batch; n++) {
+                sink ^= CRC16(&Buffer[n & 7], Sizes[i]);
+            }
+            calls += batch;
+            elapsed = Now() - start;
+        } while (elapsed < seconds);
+        printf("throughput %u %.1f\n", Sizes[i], ((double)calls * Sizes[i]) / elapsed / 1e6);
+    }
+    return errors ? 1 : 0;
+}
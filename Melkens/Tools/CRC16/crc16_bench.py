@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+Host conformance and throughput benchmark of Melkens_Lib/CRC16 backends.
+
+Builds crc16_bench.c with Melkens_Lib/CRC16/CRC16.c once per software
+backend (table, slicing-by-4, slicing-by-8 and the bitwise model of the
+STM32/dsPIC CRC unit configuration) and checks that every backend:
+  - gives the CRC-16/MODBUS check value 0x4B37 for "123456789",
+  - matches a bitwise reference for lengths 0..300 at 8 alignments, for
+    split CRC16_Update calls and for any start value,
+  - gives the same digest over all conformance CRCs as the table backend.
+Then prints throughput per frame size.
+
+The hardware backends need the MCU; the bitwise backend runs the same
+register configuration (MSB first 0x8005, LSb first data, reflected register)
+so a mistake in that mapping shows up here.
+
+Usage:
+  crc16_bench.py [--seconds 0.2] [--cc cc] [--cflags "-O2"]
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+LIB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib', 'CRC16')
+
+BACKENDS = [
+    ('table', 'dCRC16_BACKEND_TABLE'),
+    ('slicing4', 'dCRC16_BACKEND_SLICING4'),
+    ('slicing8', 'dCRC16_BACKEND_SLICING8'),
+    ('bitwise', 'dCRC16_BACKEND_BITWISE'),
+]
+CHECK_VALUE = '4b37'
+
+
+def run_backend(args, directory, name, backend):
+    output = os.path.join(directory, 'crc16_bench_' + name)
+    command = [args.cc, '-std=c99', '-Wall', '-Wextra', '-D_POSIX_C_SOURCE=199309L'] + shlex.split(args.cflags) + [
+        '-DCRC16_BACKEND=' + backend, '-I' + LIB_DIR, '-o', output,
+        os.path.join(TOOL_DIR, 'crc16_bench.c'), os.path.join(LIB_DIR, 'CRC16.c'),
+        os.path.join(LIB_DIR, 'CRC16_Stm32.c'), os.path.join(LIB_DIR, 'CRC16_dsPIC.c')]
+    subprocess.check_call(command)
+    result = subprocess.run([output, str(args.seconds)], stdout=subprocess.PIPE, universal_newlines=True)
+    values = {'throughput': {}}
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if fields[0] == 'throughput':
+            values['throughput'][int(fields[1])] = float(fields[2])
+        else:
+            values[fields[0]] = fields[1]
+    values['exit'] = result.returncode
+    return values
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--seconds', type=float, default=0.2, help='[s] per throughput measurement')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    args = parser.parse_args()
+
+    results = []
+    with tempfile.TemporaryDirectory() as directory:
+        for name, backend in BACKENDS:
+            results.append((name, run_backend(args, directory, name, backend)))
+
+    failed = False
+    reference = results[0][1]['digest']
+    for name, values in results:
+        problems = []
+        if values['check'] != CHECK_VALUE:
+            problems.append('check value %s' % values['check'])
+        if values['errors'] != '0' or values['exit']:
+            problems.append('%s reference mismatches' % values['errors'])
+        if values['digest'] != reference:
+            problems.append('digest %s differs from table %s' % (values['digest'], reference))
+        failed |= bool(problems)
+        print('%-9s %s' % (name, '; '.join(problems) if problems else 'conforms'))
+
+    sizes = sorted(results[0][1]['throughput'])
+    print('\nthroughput [MB/s] per CRC16 call size [B]')
+    print('%-9s' % 'backend' + ''.join('%9d' % size for size in sizes))
+    for name, values in results:
+        print('%-9s' % name + ''.join('%9.1f' % values['throughput'][size] for size in sizes))
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
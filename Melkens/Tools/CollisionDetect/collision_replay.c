@@ -0,0 +1,115 @@
+/*
+ * Host driver of collision_replay.py, built together with
+ * Melkens_IMU/Core/Src/CollisionDetector.c.
+ *
+ * Arguments: <param>=<value> overriding CollisionDetector_Defaults, and
+ * rearm=<ms> clearing the detector that long after an event (0: never).
+ *
+ * Reads trace lines from stdin:
+ *   acc <ms> <x> <y> <z>          raw accelerometer sample [LSB], time it was read
+ *   pmb <ms> <adcCurrent> <thumbleCurrent> <leftRotation> <rightRotation> <leftSpeed> <rightSpeed>
+ *   clear <ms>                    route resumed
+ * Prints:
+ *   params <name>=<value> ...
+ *   event <ms> <dCOLLISION_...>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "CollisionDetector.h"
+
+typedef struct {
+    const char *name;
+    size_t offset;
+} Param;
+
+static const Param Params[] = {
+    {"ImpactJerk", offsetof(CollisionParams, ImpactJerk)},
+    {"ImpactAccel", offsetof(CollisionParams, ImpactAccel)},
+    {"StallMinSpeed", offsetof(CollisionParams, StallMinSpeed)},
+    {"StallCurrent", offsetof(CollisionParams, StallCurrent)},
+    {"StallTravel", offsetof(CollisionParams, StallTravel)},
+    {"StallTime", offsetof(CollisionParams, StallTime)},
+    {"AugerCurrent", offsetof(CollisionParams, AugerCurrent)},
+    {"AugerTime", offsetof(CollisionParams, AugerTime)},
+};
+#define PARAMS_NUM_OF (sizeof(Params) / sizeof(Params[0]))
+
+static uint16_t *ParamValue(CollisionParams *params, size_t index)
+{
+    return (uint16_t *)((uint8_t *)params + Params[index].offset);
+}
+
+int main(int argc, char **argv)
+{
+    CollisionParams params = CollisionDetector_Defaults;
+    Pmb2ImuFrame_t frame;
+    char line[256], kind[16];
+    unsigned long time, rearm = 0, eventTime = 0;
+    long values[6];
+    uint8_t reported = dCOLLISION_NONE;
+    size_t i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        char *value = strchr(argv[arg], '=');
+
+        if (value == NULL) {
+            fprintf(stderr, "bad argument %s\n", argv[arg]);
+            return 2;
+        }
+        *value++ = '\0';
+        if (strcmp(argv[arg], "rearm") == 0) {
+            rearm = strtoul(value, NULL, 0);
+            continue;
+        }
+        for (i = 0; i < PARAMS_NUM_OF && strcmp(argv[arg], Params[i].name) != 0; i++) {
+        }
+        if (i == PARAMS_NUM_OF) {
+            fprintf(stderr, "unknown parameter %s\n", argv[arg]);
+            return 2;
+        }
+        *ParamValue(&params, i) = (uint16_t)strtoul(value, NULL, 0);
+    }
+
+    printf("params");
+    for (i = 0; i < PARAMS_NUM_OF; i++) {
+        printf(" %s=%u", Params[i].name, *ParamValue(&params, i));
+    }
+    printf("\n");
+
+    CollisionDetector_Init(&params);
+    memset(&frame, 0, sizeof(frame));
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        if (sscanf(line, "%15s %lu", kind, &time) != 2) {
+            continue;
+        }
+        if (reported != dCOLLISION_NONE && rearm > 0u && (time - eventTime) >= rearm) {
+            CollisionDetector_Clear();
+            reported = dCOLLISION_NONE;
+        }
+        if (strcmp(kind, "acc") == 0 &&
+            sscanf(line, "%*s %*u %ld %ld %ld", &values[0], &values[1], &values[2]) == 3) {
+            CollisionDetector_AccSample((int16_t)values[0], (int16_t)values[1], (int16_t)values[2], (uint32_t)time);
+        } else if (strcmp(kind, "pmb") == 0 &&
+                   sscanf(line, "%*s %*u %ld %ld %ld %ld %ld %ld", &values[0], &values[1], &values[2],
+                          &values[3], &values[4], &values[5]) == 6) {
+            frame.adcCurrent = (uint16_t)values[0];
+            frame.thumbleCurrent = (uint16_t)values[1];
+            frame.motorLeftRotation = (uint32_t)values[2];
+            frame.motorRightRotation = (uint32_t)values[3];
+            CollisionDetector_PmbFrame(&frame, (int16_t)values[4], (int16_t)values[5], (uint32_t)time);
+        } else if (strcmp(kind, "clear") == 0) {
+            CollisionDetector_Clear();
+            reported = dCOLLISION_NONE;
+        }
+        if (reported == dCOLLISION_NONE && CollisionDetector_GetEvent() != dCOLLISION_NONE) {
+            reported = CollisionDetector_GetEvent();
+            eventTime = CollisionDetector_GetEventTime();
+            printf("event %lu %u\n", eventTime, reported);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""
+Host validation of IMU collision and stall detection (CollisionDetector).
+
+Builds collision_replay.c with Melkens_IMU/Core/Src/CollisionDetector.c and
+feeds it traces in the firmware call order: raw accelerometer samples in
+batches of the FIFO watermark (4 samples at 416 Hz, read every 9.6 ms) and
+Pmb2ImuFrame_t values every 100 ms.
+
+  simulate   synthetic scenarios, accelerometer signals as the LSM6DSR gives
+             them with LPF2 off, the detector filters its input itself:
+             driving with auger vibration, floor bumps, slopes and pushing
+             feed must give no event, impacts, wheel stall and auger overload
+             the right one in time. Exit code 1 when any scenario fails.
+  replay     a recorded trace, lines as read by collision_replay.c
+             (acc <ms> <x> <y> <z> / pmb <ms> <adcCurrent> <thumbleCurrent>
+             <leftRotation> <rightRotation> <leftSpeed> <rightSpeed>, commas
+             allowed), prints the events.
+
+Thresholds are tuned with --param Name=value (CollisionParams field names),
+the defaults are CollisionDetector_Defaults.
+
+Usage:
+  collision_replay.py simulate [--scenario all] [--seed 1] [--param ImpactJerk=3000]
+  collision_replay.py replay trace.txt [--rearm 2000] [--param ...]
+"""
+
+import argparse
+import math
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+IMU_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_IMU', 'Core')
+TYPES_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib', 'Types')
+
+EVENTS = ['none', 'impact', 'wheel_stall', 'auger_overload']   # dCOLLISION_...
+LSB_PER_G = 16384.0             # 2 g range
+ODR = 416.0                     # [Hz]
+FIFO_SAMPLES = 4                # dFIFO_DEPTH
+PMB_PERIOD = 100                # [ms]
+ENCODER_RANGE = 10000           # dCOLLISION_ENCODER_RANGE
+
+
+def rail_counts(amps):
+    """Pmb2ImuFrame_t.adcCurrent, PMB CalculateCurrent with power stage on"""
+    return int((amps + 131) * 1484 / 100)
+
+
+def half_sine(t, start, duration, amplitude):
+    if start <= t < start + duration:
+        return amplitude * math.sin(math.pi * (t - start) / duration)
+    return 0.0
+
+
+class Scenario:
+    """Robot driving straight at speed, with disturbances added per scenario"""
+
+    def __init__(self, seconds=6.0, speed=300, auger=True):
+        self.seconds = seconds
+        self.speed = speed
+        self.auger = auger
+        self.pulses = []            # (axis, start [s], duration [s], amplitude [g])
+        self.slope = None           # (start [s], duration [s], final horizontal gravity [g])
+        self.stall = None           # start [s], wheels stop, rail current high
+        self.push = None            # start [s], wheels slow, rail current high
+        self.auger_load = None      # (start [s], duration [s])
+        self.expected = 'none'
+        self.onset = 0.0            # [s] of the expected event
+        self.limit = 0              # [ms] allowed from onset to event
+
+    def acceleration(self, t, rng):
+        """Horizontal X (driving), Y (side) and vertical Z in g before the sensor filter"""
+        x = 0.0
+        if t < 1.0:
+            x += 0.08           # start
+        if self.seconds - 1.0 <= t:
+            x -= 0.1            # stop
+        y = 0.0
+        z = 1.0
+        if self.auger:
+            vibration = 0.04 * math.sin(2 * math.pi * 23.0 * t)
+            x += vibration
+            y += 0.5 * vibration
+            z += vibration
+        if self.slope is not None:
+            start, duration, final = self.slope
+            x += final * min(1.0, max(0.0, (t - start) / duration))
+        for axis, start, duration, amplitude in self.pulses:
+            value = half_sine(t, start, duration, amplitude)
+            if axis == 'x':
+                x += value
+            elif axis == 'y':
+                y += value
+            else:
+                z += value
+        return [x + rng.gauss(0, 0.01), y + rng.gauss(0, 0.01), z + rng.gauss(0, 0.01)]
+
+    def pmb(self, t):
+        """adcCurrent, thumbleCurrent, encoder counts per PMB_PERIOD, wheel speed command"""
+        amps, travel = 10.0, 30
+        if self.stall is not None and t >= self.stall:
+            amps, travel = 35.0, 0
+        if self.push is not None and t >= self.push:
+            amps, travel = 30.0, 10
+        thumble = 20 if self.auger else 0
+        if self.auger_load is not None and self.auger_load[0] <= t < sum(self.auger_load):
+            thumble = 60
+        return rail_counts(amps), thumble, travel, self.speed
+
+    def trace(self, seed):
+        rng = random.Random(seed)
+        batch = []
+        lines = []
+        left = right = 5000
+        next_pmb = 0
+        for n in range(int(self.seconds * ODR)):
+            t = n / ODR
+            # LPF1 at ODR/2 only, nothing of these signals is above it
+            raw = self.acceleration(t, rng)
+            batch.append([max(-32768, min(32767, int(round(v * LSB_PER_G)))) for v in raw])
+            ms = int(t * 1000)
+            while next_pmb <= ms:
+                current, thumble, travel, speed = self.pmb(next_pmb / 1000.0)
+                left = (left + travel) % ENCODER_RANGE
+                right = (right - travel) % ENCODER_RANGE   # mounted mirrored
+                lines.append('pmb %d %d %d %d %d %d %d' % (next_pmb, current, thumble, left, right, speed, speed))
+                next_pmb += PMB_PERIOD
+            if len(batch) == FIFO_SAMPLES:
+                # FIFO watermark interrupt, all samples are taken at once
+                lines.extend('acc %d %d %d %d' % (ms, x, y, z) for x, y, z in batch)
+                batch = []
+        return lines
+
+
+def make_scenarios():
+    s = {}
+
+    s['cruise'] = Scenario()
+
+    s['bumpy_floor'] = Scenario()
+    for i in range(8):
+        start = 1.2 + 0.55 * i
+        s['bumpy_floor'].pulses += [('z', start, 0.015, 0.6), ('x', start, 0.02, 0.15)]
+
+    s['slope'] = Scenario()
+    s['slope'].slope = (1.5, 2.0, 0.17)
+
+    s['push_feed'] = Scenario()
+    s['push_feed'].push = 1.5
+
+    s['auger_spike'] = Scenario()
+    s['auger_spike'].auger_load = (2.0, 0.15)
+
+    s['impact_front'] = Scenario()
+    s['impact_front'].pulses = [('x', 3.0, 0.04, -1.0)]
+    s['impact_front'].expected, s['impact_front'].onset, s['impact_front'].limit = 'impact', 3.0, 25
+
+    s['impact_side'] = Scenario()
+    s['impact_side'].pulses = [('y', 2.5, 0.025, 0.8)]
+    s['impact_side'].expected, s['impact_side'].onset, s['impact_side'].limit = 'impact', 2.5, 25
+
+    s['wheel_stall'] = Scenario()
+    s['wheel_stall'].stall = 2.0
+    s['wheel_stall'].expected, s['wheel_stall'].onset, s['wheel_stall'].limit = 'wheel_stall', 2.0, 800
+
+    s['auger_overload'] = Scenario()
+    s['auger_overload'].auger_load = (2.0, 2.0)
+    s['auger_overload'].expected, s['auger_overload'].onset, s['auger_overload'].limit = 'auger_overload', 2.0, 500
+
+    return s
+
+
+def build(cc, directory):
+    output = os.path.join(directory, 'collision_replay')
+    subprocess.check_call([cc, '-std=c99', '-Wall', '-Wextra', '-O2', '-I' + os.path.join(IMU_DIR, 'Inc'),
+                           '-I' + TYPES_DIR, '-o', output, os.path.join(TOOL_DIR, 'collision_replay.c'),
+                           os.path.join(IMU_DIR, 'Src', 'CollisionDetector.c')])
+    return output
+
+
+def run(driver, lines, params, rearm=0):
+    result = subprocess.run([driver, 'rearm=%d' % rearm] + params, input='\n'.join(lines) + '\n',
+                            stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    header = ''
+    events = []
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if fields[0] == 'params':
+            header = ' '.join(fields[1:])
+        elif fields[0] == 'event':
+            events.append((int(fields[1]), EVENTS[int(fields[2])]))
+    return header, events
+
+
+def simulate(args, driver):
+    scenarios = make_scenarios()
+    names = sorted(scenarios) if args.scenario == 'all' else [args.scenario]
+    failed = False
+    for index, name in enumerate(names):
+        scenario = scenarios[name]
+        header, events = run(driver, scenario.trace(args.seed + index), args.param)
+        if index == 0:
+            print(header)
+        if scenario.expected == 'none':
+            ok = not events
+            detail = 'no event' if ok else '%s at %d ms' % (events[0][1], events[0][0])
+        elif not events:
+            ok = False
+            detail = 'missed %s' % scenario.expected
+        else:
+            time, event = events[0]
+            latency = time - int(scenario.onset * 1000)
+            ok = event == scenario.expected and 0 <= latency <= scenario.limit
+            detail = '%s after %d ms (limit %d ms)' % (event, latency, scenario.limit)
+        failed |= not ok
+        print('%-15s %-40s %s' % (name, detail, 'PASS' if ok else 'FAIL'))
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+def replay(args, driver):
+    with open(args.trace) as trace:
+        lines = [line.replace(',', ' ').strip() for line in trace if line.strip() and not line.startswith('#')]
+    header, events = run(driver, lines, args.param, args.rearm)
+    print(header)
+    for time, event in events:
+        print('%10d ms  %s' % (time, event))
+    print('%d events' % len(events))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--param', action='append', default=[], help='CollisionParams field=value')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    commands = parser.add_subparsers(dest='command')
+    command = commands.add_parser('simulate')
+    command.add_argument('--scenario', default='all', choices=['all'] + sorted(make_scenarios()))
+    command.add_argument('--seed', type=int, default=1)
+    command = commands.add_parser('replay')
+    command.add_argument('trace')
+    command.add_argument('--rearm', type=int, default=2000, help='[ms] detector cleared after an event, 0: never')
+    args = parser.parse_args()
+    if args.command is None:
+        parser.print_help()
+        return 2
+
+    with tempfile.TemporaryDirectory() as directory:
+        driver = build(args.cc, directory)
+        return simulate(args, driver) if args.command == 'simulate' else replay(args, driver)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,295 @@
+/*
+ * Host driver of emergency_stop_test.py, built together with
+ * Melkens_PMB/pmb_MotorManager.c, pmb_RouteManager.c, EmergencyStop.c,
+ * Routes.c and the fixed point, motion profile and speed control modules.
+ *
+ * CAN1_Transmit is the inverter side: every frame is recorded and the last
+ * speed frame of a wheel turns its encoder. Display, remote and keyboard
+ * events are injected for one tick, the other board modules are stubs.
+ *
+ * Prints:
+ *   <case> ok
+ *   <case> FAIL <what>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mcc_generated_files/can_types.h"
+#include "mcc_generated_files/can1.h"
+#include "pmb_MotorManager.h"
+#include "pmb_RouteManager.h"
+#include "pmb_Display.h"
+#include "pmb_Keyboard.h"
+#include "pmb_Scheduler.h"
+#include "pmb_System.h"
+#include "DiagnosticsHandler.h"
+#include "DriveIndicator.h"
+#include "AnalogHandler/AnalogHandler.h"
+#include "BatteryManager/BatteryManager.h"
+#include "IMUHandler/IMUHandler.h"
+#include "TimeManager/TimeManager.h"
+#include "EmergencyStop/EmergencyStop.h"
+
+#define CAN_ID_LEFT         0x0600007Fu
+#define CAN_ID_RIGHT        0x0600007Eu
+#define ENCODER_PERIOD      20u     /* [ms] per rotation count at any speed */
+
+
+static uint32_t Now;                /* [ms] */
+static uint32_t SpeedFrames;        /* non-zero speed since Clear */
+static uint32_t EnableFrames;
+static uint32_t StopFrames;
+static uint32_t InverterSpeed[2];   /* raw speed word of the last frame, left and right */
+static DisplayButton DisplayEvent = Display_Released;
+static RemoteButton RemoteEvent = Remote_Released;
+static KeyboardButton KeyboardPress = Keyboard_Released;
+static int Failures;
+
+/* ---- inverters ---- */
+
+/* TXQ control register, FRESET clears by itself one access after it is set */
+volatile C1TXQCONLBITS *C1TXQCONL_Access(void)
+{
+    static volatile C1TXQCONLBITS reg;
+
+    reg.FRESET = 0;
+    return &reg;
+}
+
+CAN_TX_FIFO_STATUS CAN1_TransmitFIFOStatusGet(const CAN1_TX_FIFO_CHANNELS fifoChannel)
+{
+    (void)fifoChannel;
+    return CAN_TX_FIFO_AVAILABLE;
+}
+
+CAN_TX_MSG_REQUEST_STATUS CAN1_Transmit(const CAN1_TX_FIFO_CHANNELS fifoChannel, CAN_MSG_OBJ *txCanMsg)
+{
+    const uint8_t *data = txCanMsg->data;
+    uint32_t speed;
+    int wheel = (txCanMsg->msgId == CAN_ID_LEFT) ? 0 : (txCanMsg->msgId == CAN_ID_RIGHT) ? 1 : -1;
+
+    (void)fifoChannel;
+    if (data[0] == 0x23 && data[1] == 0x0D && data[2] == 0x20) {
+        EnableFrames++;
+    }
+    else if (data[0] == 0x23 && data[1] == 0x00 && data[2] == 0x20) {
+        /* 0x2000 speed: 0 forward or 0xFFFFFFFF reverse is standstill */
+        speed = ((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) | ((uint32_t)data[6] << 8) | data[7];
+        if (speed == 0u || speed == 0xFFFFFFFFu) {
+            StopFrames++;
+            speed = 0u;
+        }
+        else {
+            SpeedFrames++;
+        }
+        if (wheel >= 0) {
+            InverterSpeed[wheel] = speed;
+        }
+    }
+    return CAN_TX_MSG_REQUEST_SUCCESS;
+}
+
+/* ---- rest of the board ---- */
+
+DisplayButton Display_GetEvent(void) { return DisplayEvent; }
+RemoteButton IMUHandler_GetRemoteMessage(void) { return RemoteEvent; }
+KeyboardEvent Keyboard_GetEvent(void)
+{
+    KeyboardEvent event = { KeyboardPress, Keyboard_ShortPress };
+    return event;
+}
+bool IMUHandler_IsRouteSelectButton(void) { return RemoteEvent >= Remote_RouteA && RemoteEvent < Remote_Released; }
+uint8_t Remote_GetRouteStep(void) { return 0; }
+uint8_t Remote_GetSpeed(void) { return 0; }
+BatteryLevel BatteryManager_GetBatteryLevel(void) { return BatteryLevel_Good; }
+bool AnalogHandler_IsSafetyActivated(void) { return false; }
+bool Diagnostics_IsInvertersReady(void) { return true; }
+bool Diagnostics_IsIMUReady(void) { return true; }
+void Diagnostics_SetEvent(DiagnosticsEvent_t Event) { (void)Event; }
+bool DriveIndicator_IsFinishedIndication(void) { return true; }
+void DriveIndicator_SetIndication(uint32_t BuzzerMs, uint32_t LampMs) { (void)BuzzerMs; (void)LampMs; }
+void DriveIndicator_SetDisable(IndicationType Indication) { (void)Indication; }
+Route_ID Scheduler_GetRouteFromScheduler(void) { return Route_NumOf; }
+void System_PowerRailRequestSequence(PowerSequenceNames Name) { (void)Name; }
+void IMUHandler_SetCurrentRouteStep(uint8_t Step) { (void)Step; }
+float IMUHandler_GetAngle(void) { return 0.0f; }
+q16_t IMUHandler_GetAngleQ16(void) { return 0; }
+q16_t IMUHandler_CalculateAngleQ16(q16_t prevDegree, q16_t currentDegree) { return currentDegree - prevDegree; }
+float IMUHandler_GetMagnetMagnetPositionInCM(MagnetPosition Magnet) { (void)Magnet; return 0.0f; }
+MagnetsStatus GetMagnets(void)
+{
+    MagnetsStatus status;
+    memset(&status, 0, sizeof(status));
+    return status;
+}
+uint32_t TimeManager_GetMicros(void) { return Now * 1000u; }
+bool IMUHandler_ToSharedTime(uint32_t Local, uint32_t *Shared)
+{
+    *Shared = Local;
+    return false;
+}
+void DBG3_SetHigh(void) {}
+void DBG3_SetLow(void) {}
+bool DBG4_GetValue(void) { return false; }
+
+/* ---- test ---- */
+
+static void Check(const char *name, bool condition, const char *what)
+{
+    if (!condition) {
+        printf("%s FAIL %s\n", name, what);
+        Failures++;
+    }
+}
+
+static void Report(const char *name, int failuresBefore)
+{
+    if (Failures == failuresBefore) {
+        printf("%s ok\n", name);
+    }
+}
+
+static void Clear(void)
+{
+    SpeedFrames = 0;
+    EnableFrames = 0;
+    StopFrames = 0;
+}
+
+/* One ms of the PMB main loop with the route manager enabled */
+static void Tick(void)
+{
+    int wheel;
+
+    Now++;
+    EmergencyStop_Perform1ms(TimeManager_GetMicros());
+    RouteManager_Perform1ms();
+    MotorManager_Perform1ms();
+    if (Now % 100u == 0u) {
+        RouteManager_Perform100ms();
+        MotorManager_Perform100ms();
+    }
+    RouteManager_StateMachine();
+    MotorManager_StateMachine();
+    MotorManager_PerformAfterMainLoop();
+    DisplayEvent = Display_Released;
+    RemoteEvent = Remote_Released;
+    KeyboardPress = Keyboard_Released;
+
+    for (wheel = 0; wheel < 2; wheel++) {
+        if (InverterSpeed[wheel] != 0u && Now % ENCODER_PERIOD == 0u) {
+            MotorManager_SetRotationCount((MotorName)wheel, MotorManager_GetRotationCount((MotorName)wheel) + 1);
+        }
+    }
+}
+
+static void Run(uint32_t ms)
+{
+    while (ms-- > 0u) {
+        Tick();
+    }
+}
+
+static void Stop(uint8_t stop)
+{
+    Imu2PmbFrame_t frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.stop = stop;
+    frame.stopTime = Now * 1000u;
+    EmergencyStop_Frame(&frame, TimeManager_GetMicros());
+}
+
+static void Init(void)
+{
+    memset(InverterSpeed, 0, sizeof(InverterSpeed));
+    EmergencyStop_Init();
+    MotorManager_Initialise();
+    RouteManager_Init();
+    Run(10);
+    Clear();
+}
+
+/* Route A selected and started from the display, driving for a while */
+static void StartRoute(void)
+{
+    DisplayEvent = Display_ROUTE_A;
+    Run(10);
+    DisplayEvent = Display_PLAY;
+    Run(1000);
+}
+
+static void RouteHeld(void)
+{
+    const char *name = "route_held_by_stop";
+    int before = Failures;
+    uint32_t i;
+
+    Init();
+    StartRoute();
+    Check(name, SpeedFrames > 0u && InverterSpeed[0] != 0u && InverterSpeed[1] != 0u, "route does not drive");
+
+    Clear();
+    Stop(dSTOP_REQUESTED);
+    Check(name, StopFrames >= (uint32_t)Motor_NumOf && InverterSpeed[0] == 0u && InverterSpeed[1] == 0u,
+          "stop not sent to the wheels");
+    Run(2000);
+    /* operator and remote try to go on, the step is finished meanwhile */
+    DisplayEvent = Display_PLAY;
+    Run(200);
+    RemoteEvent = Remote_RoutePlay;
+    Run(200);
+    MotorManager_SetRotationCount(Motor_Left, 100000);
+    MotorManager_SetRotationCount(Motor_Right, 100000);
+    DisplayEvent = Display_PLAY;
+    Run(2000);
+    Check(name, SpeedFrames == 0u, "speed frame sent while stopped");
+    Check(name, EnableFrames == 0u, "enable frame sent while stopped");
+    Check(name, InverterSpeed[0] == 0u && InverterSpeed[1] == 0u, "wheels turn while stopped");
+
+    Clear();
+    Stop(dSTOP_NONE);
+    for (i = 0; i < 1000u && SpeedFrames == 0u; i++) {
+        Tick();
+    }
+    Check(name, SpeedFrames == 0u, "route goes on after release without PLAY");
+    DisplayEvent = Display_PLAY;
+    Run(500);
+    Check(name, SpeedFrames > 0u, "route does not go on with PLAY after release");
+    Report(name, before);
+}
+
+static void ManualHeld(void)
+{
+    const char *name = "manual_held_by_stop";
+    int before = Failures;
+
+    Init();
+    EmergencyStop_Trigger(EmergencyStop_LinkLost, TimeManager_GetMicros());
+    Clear();
+    KeyboardPress = Keyboard_UP;
+    Run(500);
+    /* speeds the way IMUHandler and the speed loop set them */
+    MotorManager_SetSpeed(Motor_Left, 300);
+    MotorManager_SetSpeed(Motor_Right, 300);
+    MotorManager_StartMotorKeepDirection(Motor_Left);
+    MotorManager_StartMotorKeepDirection(Motor_Right);
+    MotorManager_TriggerEnableMessageSend(0);
+    Run(500);
+    Check(name, SpeedFrames == 0u, "speed frame sent while stopped");
+    Check(name, EnableFrames == 0u, "enable frame sent while stopped");
+    Check(name, !MotorManager_IsAnyMotorEnabled(), "motor enabled while stopped");
+
+    Stop(dSTOP_NONE);
+    KeyboardPress = Keyboard_DOWN;
+    Run(500);
+    Check(name, SpeedFrames > 0u, "keyboard does not drive after release");
+    Report(name, before);
+}
+
+int main(void)
+{
+    RouteHeld();
+    ManualHeld();
+    return (Failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * Host driver of emergency_stop_test.py, built together with
+ * Melkens_PMB/EmergencyStop/EmergencyStop.c.
+ *
+ * MotorManager_AbortCanTx/MotorManager_SendStop run against a model of the
+ * CAN1 TXQ (24 frames, abort of a frame on the bus takes some calls) and
+ * IMUHandler_ToSharedTime against a fixed clock offset.
+ *
+ * Prints:
+ *   <case> ok
+ *   <case> FAIL <what>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "EmergencyStop/EmergencyStop.h"
+#include "pmb_MotorManager.h"
+#include "IMUHandler/IMUHandler.h"
+
+#define TXQ_SIZE        24
+#define FRAME_STALE     0xFF    /* speed or inquiry queued before the stop */
+#define SHARED_OFFSET   100000u /* [us] shared time minus PMB micros */
+
+static uint8_t Txq[TXQ_SIZE];
+static uint8_t TxqLength;
+static uint8_t AbortBusy;       /* calls MotorManager_AbortCanTx fails, frame on the bus */
+static uint32_t Aborts;
+static uint32_t Stops;
+static bool IsSynchronised;
+static int Failures;
+
+bool MotorManager_AbortCanTx(void)
+{
+    Aborts++;
+    if (AbortBusy > 0u) {
+        AbortBusy--;
+        return false;
+    }
+    TxqLength = 0;
+    return true;
+}
+
+bool MotorManager_SendStop(MotorName Mot)
+{
+    if (TxqLength >= TXQ_SIZE) {
+        return false;
+    }
+    Txq[TxqLength++] = (uint8_t)Mot;
+    Stops++;
+    return true;
+}
+
+bool IMUHandler_ToSharedTime(uint32_t Local, uint32_t *Shared)
+{
+    *Shared = Local + SHARED_OFFSET;
+    return IsSynchronised;
+}
+
+static void Reset(void)
+{
+    memset(Txq, FRAME_STALE, sizeof(Txq));
+    TxqLength = TXQ_SIZE;
+    AbortBusy = 0;
+    Aborts = 0;
+    Stops = 0;
+    IsSynchronised = true;
+    EmergencyStop_Init();
+}
+
+static void Check(const char *name, bool condition, const char *what)
+{
+    if (!condition) {
+        printf("%s FAIL %s\n", name, what);
+        Failures++;
+    }
+}
+
+/* Queue holds exactly one stop per inverter and nothing else */
+static bool IsOnlyStops(void)
+{
+    uint8_t seen = 0;
+    uint8_t i;
+
+    if (TxqLength != Motor_NumOf) {
+        return false;
+    }
+    for (i = 0; i < TxqLength; i++) {
+        if (Txq[i] >= Motor_NumOf || (seen & (1u << Txq[i]))) {
+            return false;
+        }
+        seen |= (uint8_t)(1u << Txq[i]);
+    }
+    return true;
+}
+
+static Imu2PmbFrame_t StopFrame(uint8_t stop, uint32_t stopTime)
+{
+    Imu2PmbFrame_t frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.motorRightSpeed = 500;
+    frame.motorLeftSpeed = 500;
+    frame.stop = stop;
+    frame.stopTime = stopTime;
+    return frame;
+}
+
+static void Report(const char *name, int failuresBefore)
+{
+    if (Failures == failuresBefore) {
+        printf("%s ok\n", name);
+    }
+}
+
+int main(void)
+{
+    const char *name;
+    Imu2PmbFrame_t frame;
+    int before;
+
+    name = "stop_flushes_txq";
+    before = Failures;
+    Reset();
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    Check(name, EmergencyStop_Frame(&frame, 3500u), "speeds not ignored");
+    Check(name, IsOnlyStops(), "stale frames left or stop missing");
+    Check(name, EmergencyStop_GetSource() == EmergencyStop_Esp, "source");
+    Check(name, EmergencyStop_GetStopTime() == frame.stopTime, "stop time");
+    Check(name, EmergencyStop_GetReaction() == 2500u, "reaction");
+    Check(name, EmergencyStop_GetReaction() < dESTOP_REACTION_BUDGET, "reaction above budget");
+    Report(name, before);
+
+    name = "abort_in_progress";
+    before = Failures;
+    Reset();
+    AbortBusy = 2;
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    Check(name, EmergencyStop_Frame(&frame, 2000u), "speeds not ignored");
+    Check(name, Stops == 0u, "stop queued behind stale frames");
+    Check(name, EmergencyStop_GetReaction() == dSTOP_REACTION_UNKNOWN, "reaction before stops queued");
+    EmergencyStop_Perform1ms(3000u);
+    Check(name, Stops == 0u, "stop queued behind stale frames");
+    EmergencyStop_Perform1ms(4000u);
+    Check(name, IsOnlyStops(), "stops not queued after abort");
+    Check(name, EmergencyStop_GetReaction() == 3000u, "reaction");
+    Report(name, before);
+
+    name = "repeated_frame_once";
+    before = Failures;
+    Reset();
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    EmergencyStop_Frame(&frame, 2000u);
+    Aborts = 0;
+    Stops = 0;
+    Check(name, EmergencyStop_Frame(&frame, 12000u), "speeds not ignored");
+    EmergencyStop_Perform1ms(13000u);
+    Check(name, Aborts == 0u && Stops == 0u, "stop carried out again");
+    Check(name, EmergencyStop_GetReaction() == 1000u, "reaction changed");
+    Report(name, before);
+
+    name = "release";
+    before = Failures;
+    Reset();
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    EmergencyStop_Frame(&frame, 2000u);
+    frame = StopFrame(dSTOP_NONE, 0u);
+    Check(name, !EmergencyStop_Frame(&frame, 3000u), "speeds ignored after release");
+    Check(name, !EmergencyStop_IsActive(), "still active");
+    Check(name, EmergencyStop_GetReaction() == 1000u, "last reaction lost");
+    Report(name, before);
+
+    name = "link_lost";
+    before = Failures;
+    Reset();
+    EmergencyStop_Trigger(EmergencyStop_LinkLost, 5000u);
+    Check(name, IsOnlyStops(), "stale frames left or stop missing");
+    Check(name, EmergencyStop_GetSource() == EmergencyStop_LinkLost, "source");
+    Check(name, EmergencyStop_GetReaction() == dSTOP_REACTION_UNKNOWN, "reaction without ESP request");
+    frame = StopFrame(dSTOP_NONE, 0u);
+    Check(name, !EmergencyStop_Frame(&frame, 6000u), "not released by valid frame");
+    Report(name, before);
+
+    name = "link_lost_keeps_esp_stop";
+    before = Failures;
+    Reset();
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    EmergencyStop_Frame(&frame, 2000u);
+    TxqLength = TXQ_SIZE;
+    EmergencyStop_Trigger(EmergencyStop_LinkLost, 5000u);
+    Check(name, IsOnlyStops(), "stops not sent again");
+    Check(name, EmergencyStop_GetSource() == EmergencyStop_Esp, "source");
+    Check(name, EmergencyStop_Frame(&frame, 6000u), "speeds not ignored");
+    Report(name, before);
+
+    name = "unsynchronised";
+    before = Failures;
+    Reset();
+    IsSynchronised = false;
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    EmergencyStop_Frame(&frame, 2000u);
+    Check(name, IsOnlyStops(), "stale frames left or stop missing");
+    Check(name, EmergencyStop_GetStopTime() == frame.stopTime, "stop time");
+    Check(name, EmergencyStop_GetReaction() == dSTOP_REACTION_UNKNOWN, "reaction");
+    Report(name, before);
+
+    name = "stop_after_release";
+    before = Failures;
+    Reset();
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    EmergencyStop_Frame(&frame, 2000u);
+    frame = StopFrame(dSTOP_NONE, 0u);
+    EmergencyStop_Frame(&frame, 3000u);
+    memset(Txq, FRAME_STALE, sizeof(Txq));
+    TxqLength = 10;
+    frame = StopFrame(dSTOP_REQUESTED, 50000u + SHARED_OFFSET);
+    Check(name, EmergencyStop_Frame(&frame, 54000u), "speeds not ignored");
+    Check(name, IsOnlyStops(), "stale frames left or stop missing");
+    Check(name, EmergencyStop_GetReaction() == 4000u, "reaction");
+    Report(name, before);
+
+    name = "clock_error_before_request";
+    before = Failures;
+    Reset();
+    frame = StopFrame(dSTOP_REQUESTED, 1000u + SHARED_OFFSET);
+    EmergencyStop_Frame(&frame, 900u);
+    Check(name, EmergencyStop_GetReaction() == 0u, "negative reaction not clamped");
+    Report(name, before);
+
+    return (Failures > 0) ? 1 : 0;
+}
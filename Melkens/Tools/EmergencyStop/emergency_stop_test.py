@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Host test of the PMB emergency stop, Melkens_PMB/EmergencyStop.
+
+Builds emergency_stop_test.c with EmergencyStop.c against a model of the
+CAN1 TXQ and checks that:
+  - a stop drops all frames waiting in the TXQ and queues exactly one stop
+    command per inverter, in the call that receives it,
+  - an abort still in progress delays the stop commands to the next
+    EmergencyStop_Perform1ms, never behind stale frames,
+  - the stop repeated in every frame is carried out once, a new one again,
+  - a frame with dSTOP_NONE releases, link loss stops without ESP request,
+  - the reaction is measured in shared time, unknown when not synchronised.
+
+Builds emergency_stop_route.c with pmb_MotorManager.c, pmb_RouteManager.c
+and the route modules, CAN frames going to a model of the inverters, and
+checks that while the stop is latched:
+  - a running route sends no speed or enable frame, whatever PLAY the
+    display or remote sends and however far the wheels got in the step,
+  - after release the route waits for PLAY, then drives on,
+  - keyboard, IMU speeds and the speed loop send nothing either, the
+    keyboard drives again after release.
+
+Usage:
+  emergency_stop_test.py [--cc cc] [--cflags "-O2"]
+"""
+
+import argparse
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+PMB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_PMB')
+
+# pmb_MotorManager.h includes the XC16 processor header, MotorManager_AbortCanTx
+# accesses the TXQ control register through it
+XC_STUB = '''#ifndef XC_STUB_H
+#define XC_STUB_H
+#include <stdint.h>
+#include <stdbool.h>
+typedef struct { unsigned TXREQ; unsigned FRESET; } C1TXQCONLBITS;
+volatile C1TXQCONLBITS *C1TXQCONL_Access(void);
+#define C1TXQCONLbits (*C1TXQCONL_Access())
+#endif
+'''
+
+# Copied next to the stubs below, quoted includes resolve there first
+ROUTE_COPIES = ['pmb_MotorManager.c', 'pmb_RouteManager.c', os.path.join('AnalogHandler', 'AnalogHandler.h')]
+ROUTE_SOURCES = [os.path.join('EmergencyStop', 'EmergencyStop.c'), 'Routes.c',
+                 os.path.join('Tools', 'FixedPoint.c'), os.path.join('Tools', 'Timer.c'),
+                 os.path.join('MotionProfile', 'MotionProfile.c'), os.path.join('SpeedControl', 'SpeedControl.c')]
+
+PIN_STUB = '''#include <stdbool.h>
+#define LED1_SetHigh()
+#define LED1_SetLow()
+#define LED2_SetHigh()
+#define LED2_SetLow()
+#define DBG1_GetValue() 1
+#define DBG2_GetValue() 1
+void DBG3_SetHigh(void);
+void DBG3_SetLow(void);
+bool DBG4_GetValue(void);
+'''
+
+ADC_STUB = '''#ifndef _ADC1_H
+#define _ADC1_H
+typedef enum {
+%s
+} ADC1_CHANNEL;
+#endif
+'''
+
+
+def adc_channels():
+    with open(os.path.join(PMB_DIR, 'mcc_generated_files', 'adc1.h')) as file:
+        body = re.search(r'typedef enum\s*\{([^}]*)\}\s*ADC1_CHANNEL;', file.read()).group(1)
+    return re.findall(r'^\s*(\w+),?', re.sub(r'//.*', '', body), re.MULTILINE)
+
+
+def build_route(cc, cflags, directory):
+    os.mkdir(os.path.join(directory, 'AnalogHandler'))
+    os.mkdir(os.path.join(directory, 'mcc_generated_files'))
+    for name in ROUTE_COPIES:
+        shutil.copy(os.path.join(PMB_DIR, name), os.path.join(directory, name))
+    with open(os.path.join(directory, 'mcc_generated_files', 'pin_manager.h'), 'w') as stub:
+        stub.write(PIN_STUB)
+    with open(os.path.join(directory, 'mcc_generated_files', 'adc1.h'), 'w') as stub:
+        stub.write(ADC_STUB % '\n'.join('    %s,' % name for name in adc_channels()))
+    output = os.path.join(directory, 'emergency_stop_route')
+    # pmb_RouteManager.h uses uint8_t without including stdint.h
+    command = [cc, '-std=gnu99', '-include', 'stdint.h'] + shlex.split(cflags) + [
+        '-I' + directory, '-I' + PMB_DIR, '-o', output,
+        os.path.join(TOOL_DIR, 'emergency_stop_route.c'),
+        os.path.join(directory, 'pmb_MotorManager.c'),
+        os.path.join(directory, 'pmb_RouteManager.c')] + [
+        os.path.join(PMB_DIR, name) for name in ROUTE_SOURCES] + ['-lm']
+    subprocess.check_call(command)
+    return output
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        with open(os.path.join(directory, 'xc.h'), 'w') as stub:
+            stub.write(XC_STUB)
+        output = os.path.join(directory, 'emergency_stop_test')
+        command = [args.cc, '-std=c99', '-Wall', '-Wextra'] + shlex.split(args.cflags) + [
+            '-I' + directory, '-I' + PMB_DIR, '-o', output,
+            os.path.join(TOOL_DIR, 'emergency_stop_test.c'),
+            os.path.join(PMB_DIR, 'EmergencyStop', 'EmergencyStop.c')]
+        subprocess.check_call(command)
+        results = [subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True)]
+        output = build_route(args.cc, args.cflags, directory)
+        results.append(subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True))
+
+    failed = False
+    for result in results:
+        failed |= result.returncode != 0
+        for line in result.stdout.splitlines():
+            fields = line.split(None, 2)
+            print('%-28s %s' % (fields[0], ' '.join(fields[1:])))
+            failed |= fields[1] != 'ok'
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
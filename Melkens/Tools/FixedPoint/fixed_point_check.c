@@ -0,0 +1,773 @@
+/*
+ * Host driver of fixed_point_check.py, built together with
+ * Melkens_PMB/Tools/FixedPoint.c, Routes.c and the step functions the script
+ * copies out of pmb_RouteManager.c, IMUHandler.c and pmb_Functions.c.
+ *
+ * Every step of every route in Routes.c goes through the fixed point code and
+ * through the float code it replaced (Float* below), both fed with the raw
+ * values firmware gets: IMU roll [mrad], rotation counts, thumble current.
+ * FixedPoint helper calls are counted through ld --wrap. Float operations are
+ * counted in the float code, worst path, each of them is a library call on
+ * dsPIC33CK (conversions and compares included).
+ *
+ * Prints:
+ *   <case> ok <max error> <operations per evaluation>
+ *   <case> FAIL <what>
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "fixed_point_check.h"
+
+#define ROLL_PI                 3141        // IMU roll of 180 degrees
+#define KEEP_DIRECTION          0xFEu
+#define THRESHOLD_MARGIN        0.001f      // [deg] decisions may differ this close to a threshold
+#define FLOAT_OPS_CALCULATE_ANGLE   4       // IMUHandler_CalculateAngle: sub, 2 compares, add
+
+/* pmb_RouteManager.c globals */
+uint32_t cor_dX;
+float stepDistanceOffset;
+float DesiredAngle;
+float TurnAngle;
+float MagnetCorrectionAngle;
+q16_t DesiredAngleQ16;
+q16_t MagnetCorrectionAngleQ16;
+q16_t TurnAngleQ16;
+uint16_t StepDistance;
+q16_t CurrentAngle;
+q16_t CalulatedAngle;
+bool SlowerSpeedFlag;
+bool VelocityCorrection;
+
+static int Failures;
+
+/* Motor manager model, speeds and starts of the fixed and the float code */
+typedef struct {
+    uint16_t Speed[Motor_NumOf];
+    uint8_t Start[Motor_NumOf];
+} MotorCommands;
+
+static int32_t Rotations[Motor_NumOf];
+static uint16_t StepSpeed[Motor_NumOf];
+static uint8_t StepDirection[Motor_NumOf];
+static uint16_t ThumbleCurrent;
+static MotorCommands Fixed, Float;
+
+int32_t MotorManager_GetRotationCount(MotorName Mot)
+{
+    return Rotations[Mot];
+}
+
+uint16_t MotorManager_GetStepSpeed(uint8_t Mot)
+{
+    return StepSpeed[Mot];
+}
+
+uint8_t MotorManager_GetStepDirection(uint8_t Mot)
+{
+    return StepDirection[Mot];
+}
+
+uint16_t MotorManager_GetCurrent(MotorName Mot)
+{
+    (void)Mot;
+    return ThumbleCurrent;
+}
+
+void MotorManager_SetSpeed(uint8_t Motor, uint16_t Speed)
+{
+    Fixed.Speed[Motor] = Speed;
+}
+
+void MotorManager_StartMotor(MotorName Mot, uint8_t Direction)
+{
+    Fixed.Start[Mot] = Direction;
+}
+
+void MotorManager_StartMotorKeepDirection(MotorName Mot)
+{
+    Fixed.Start[Mot] = KEEP_DIRECTION;
+}
+
+/* Negative speed converted to uint16_t was undefined (0xFFFx on host and
+ * target), FixedPoint_ScaleU16 gives 0 for a negative factor */
+static void FloatSetSpeed(uint8_t Motor, double Speed)
+{
+    Float.Speed[Motor] = (Speed > 0.0) ? (uint16_t)Speed : 0u;
+}
+
+static void FloatStartMotor(MotorName Mot, uint8_t Direction)
+{
+    Float.Start[Mot] = Direction;
+}
+
+static void FloatStartMotorKeepDirection(MotorName Mot)
+{
+    Float.Start[Mot] = KEEP_DIRECTION;
+}
+
+static void ClearCommands(void)
+{
+    memset(&Fixed, 0xFF, sizeof(Fixed));
+    memset(&Float, 0xFF, sizeof(Float));
+}
+
+/* FixedPoint helpers, counted. MUL and DIV are the hardware instructions of a call */
+enum {
+    Helper_Q15Mul, Helper_ScaleU16Q15, Helper_Q16Mul, Helper_Q16Div,
+    Helper_Q16DivQ16, Helper_Q16Abs, Helper_ScaleU16, Helper_NumOf
+};
+static const struct {
+    uint8_t Mul;
+    uint8_t Div;
+} HelperCost[Helper_NumOf] = { { 1, 0 }, { 1, 0 }, { 4, 0 }, { 0, 2 }, { 0, 2 }, { 0, 0 }, { 2, 0 } };
+static uint32_t HelperCalls[Helper_NumOf];
+static uint32_t FloatOps;
+
+q15_t __real_FixedPoint_Q15Mul(q15_t A, q15_t B);
+uint16_t __real_FixedPoint_ScaleU16Q15(uint16_t Value, q15_t Factor);
+q16_t __real_FixedPoint_Q16Mul(q16_t A, q16_t B);
+q16_t __real_FixedPoint_Q16Div(int32_t Num, uint16_t Den);
+q16_t __real_FixedPoint_Q16DivQ16(q16_t Num, q16_t Den);
+q16_t __real_FixedPoint_Q16Abs(q16_t Value);
+uint16_t __real_FixedPoint_ScaleU16(uint16_t Value, q16_t Factor);
+q15_t __wrap_FixedPoint_Q15Mul(q15_t A, q15_t B);
+uint16_t __wrap_FixedPoint_ScaleU16Q15(uint16_t Value, q15_t Factor);
+q16_t __wrap_FixedPoint_Q16Mul(q16_t A, q16_t B);
+q16_t __wrap_FixedPoint_Q16Div(int32_t Num, uint16_t Den);
+q16_t __wrap_FixedPoint_Q16DivQ16(q16_t Num, q16_t Den);
+q16_t __wrap_FixedPoint_Q16Abs(q16_t Value);
+uint16_t __wrap_FixedPoint_ScaleU16(uint16_t Value, q16_t Factor);
+
+q15_t __wrap_FixedPoint_Q15Mul(q15_t A, q15_t B)
+{
+    HelperCalls[Helper_Q15Mul]++;
+    return __real_FixedPoint_Q15Mul(A, B);
+}
+
+uint16_t __wrap_FixedPoint_ScaleU16Q15(uint16_t Value, q15_t Factor)
+{
+    HelperCalls[Helper_ScaleU16Q15]++;
+    return __real_FixedPoint_ScaleU16Q15(Value, Factor);
+}
+
+q16_t __wrap_FixedPoint_Q16Mul(q16_t A, q16_t B)
+{
+    HelperCalls[Helper_Q16Mul]++;
+    return __real_FixedPoint_Q16Mul(A, B);
+}
+
+q16_t __wrap_FixedPoint_Q16Div(int32_t Num, uint16_t Den)
+{
+    HelperCalls[Helper_Q16Div]++;
+    return __real_FixedPoint_Q16Div(Num, Den);
+}
+
+q16_t __wrap_FixedPoint_Q16DivQ16(q16_t Num, q16_t Den)
+{
+    HelperCalls[Helper_Q16DivQ16]++;
+    return __real_FixedPoint_Q16DivQ16(Num, Den);
+}
+
+q16_t __wrap_FixedPoint_Q16Abs(q16_t Value)
+{
+    HelperCalls[Helper_Q16Abs]++;
+    return __real_FixedPoint_Q16Abs(Value);
+}
+
+uint16_t __wrap_FixedPoint_ScaleU16(uint16_t Value, q16_t Factor)
+{
+    HelperCalls[Helper_ScaleU16]++;
+    return __real_FixedPoint_ScaleU16(Value, Factor);
+}
+
+static void ResetOperations(void)
+{
+    memset(HelperCalls, 0, sizeof(HelperCalls));
+    FloatOps = 0;
+}
+
+static void FormatOperations(char *text, size_t size, uint32_t evaluations)
+{
+    uint32_t calls = 0, mul = 0, div = 0;
+    uint8_t i;
+
+    for (i = 0; i < Helper_NumOf; i++) {
+        calls += HelperCalls[i];
+        mul += HelperCalls[i] * HelperCost[i].Mul;
+        div += HelperCalls[i] * HelperCost[i].Div;
+    }
+    snprintf(text, size, "fixed %.1f calls %.1f MUL %.1f DIV, float %.1f ops per evaluation",
+             (double)calls / evaluations, (double)mul / evaluations, (double)div / evaluations,
+             (double)FloatOps / evaluations);
+}
+
+static void Check(const char *name, bool condition, const char *what)
+{
+    if (!condition) {
+        printf("%s FAIL %s\n", name, what);
+        Failures++;
+    }
+}
+
+static void Report(const char *name, int failuresBefore, const char *measured)
+{
+    if (Failures == failuresBefore) {
+        printf("%s ok %s\n", name, measured);
+    }
+}
+
+static double Q16ToDouble(q16_t Value)
+{
+    return Value / 65536.0;
+}
+
+/* Float code replaced by the fixed point one */
+
+static float FloatEncoderFinishedPercent(float Distance)
+{
+    float EncoderFinishedPercent_Left;
+    float EncoderFinishedPercent_Right;
+
+    EncoderFinishedPercent_Left = ((float)MotorManager_GetRotationCount(Motor_Left) * dDISTANCE_PER_MOTOR_ROTATION) / Distance;
+    EncoderFinishedPercent_Right = ((float)MotorManager_GetRotationCount(Motor_Right) * dDISTANCE_PER_MOTOR_ROTATION) / Distance;
+    FloatOps += 6 + 2;      // 2x conversion, mul, div; sub, div
+    return fabsf(EncoderFinishedPercent_Left - EncoderFinishedPercent_Right) / 2;
+}
+
+static float FloatMagnetSearchStart(void)
+{
+    if (cor_dX < 10)
+        return 0.20f;
+    else if (cor_dX > 50)
+        return 0.80f;
+    FloatOps += 4;          // conversion, div, mul, add
+    return 0.2f + (((float)cor_dX / 100.0f) * 0.75f);
+}
+
+static bool Float90DegStepAchieved(float CurrentAngle)
+{
+    float EncoderFinishedPercent_Left;
+    float EncoderFinishedPercent_Right;
+    float IMUFinishedPercent;
+    float IMUJudgementResult;
+    float LeftJudgementResult;
+    float RightJudgementResult;
+
+    EncoderFinishedPercent_Left = (float)MotorManager_GetRotationCount(Motor_Left) / (float)FULL_WHEEL_TURN;
+    EncoderFinishedPercent_Right = (float)MotorManager_GetRotationCount(Motor_Right) / (float)FULL_WHEEL_TURN;
+    IMUFinishedPercent = fabsf(-(fabsf(IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, CurrentAngle) / TurnAngle) - 1.0f));
+    IMUJudgementResult = IMUFinishedPercent * dIMU_JUDGEMENT_FACTOR;
+    LeftJudgementResult = fabsf(EncoderFinishedPercent_Left * dECODER_JUDGEMENT_FACTOR);
+    RightJudgementResult = fabsf(EncoderFinishedPercent_Right * dECODER_JUDGEMENT_FACTOR);
+    (void)IMUJudgementResult;
+    (void)LeftJudgementResult;
+    (void)RightJudgementResult;
+    FloatOps += 4 + 3 + FLOAT_OPS_CALCULATE_ANGLE + 3 + 2;      // 2x conversion, div; add, div, sub; 3x mul; compare 0.5 in double
+
+    if (IMUFinishedPercent > 0.5 && false == SlowerSpeedFlag) {
+        FloatSetSpeed(Motor_Right, MotorManager_GetStepSpeed(Motor_Right) * (1 - ((IMUFinishedPercent - 0.5) * 1.7)));
+        FloatStartMotorKeepDirection(Motor_Right);
+        FloatSetSpeed(Motor_Left, MotorManager_GetStepSpeed(Motor_Left) * (1 - ((IMUFinishedPercent - 0.5) * 1.7)));
+        FloatStartMotorKeepDirection(Motor_Left);
+        FloatOps += 2 * 7;  // double: 2x conversion, sub, mul, sub, mul, conversion to speed
+    } else {
+        FloatSetSpeed(Motor_Right, MotorManager_GetStepSpeed(Motor_Right) * ((IMUFinishedPercent * 1.6) + 0.2));
+        FloatStartMotorKeepDirection(Motor_Right);
+        FloatSetSpeed(Motor_Left, MotorManager_GetStepSpeed(Motor_Left) * ((IMUFinishedPercent * 1.6) + 0.2));
+        FloatStartMotorKeepDirection(Motor_Left);
+        FloatOps += 2 * 6;  // double: 2x conversion, mul, add, mul, conversion to speed
+    }
+
+    FloatOps += 2 + FLOAT_OPS_CALCULATE_ANGLE;      // add, compare
+    if (fabsf(IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, CurrentAngle)) < 1) {
+        SlowerSpeedFlag = false;
+        return true;
+    }
+    return false;
+}
+
+static float FloatCorrectionFactor(float CalulatedAngle)
+{
+    float proportionalCorrectionTreasholdAngle = 3;
+
+    FloatOps += 2;          // div, sub
+    return -(fabsf(CalulatedAngle / proportionalCorrectionTreasholdAngle) - 1.0f);
+}
+
+static void FloatAutomaticCorrectionForward(float Angle)
+{
+    float CalulatedAngle = IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, Angle);
+    uint16_t RightSpeed = MotorManager_GetStepSpeed(Motor_Right);
+    uint16_t LeftSpeed = MotorManager_GetStepSpeed(Motor_Left);
+    static float previousScaleFactor = 1.0;
+    float scaleFactor = 1.0;
+    int thumbleCurrent = abs((int16_t)MotorManager_GetCurrent(Motor_Thumble));
+    float correctionFactor;
+
+    FloatOps += 1 + FLOAT_OPS_CALCULATE_ANGLE;      // add
+    if (thumbleCurrent < 20) {
+        FloatOps += 2;      // double: conversion, compare
+        if (previousScaleFactor < 1.0) {
+            previousScaleFactor += 0.01;
+            if (previousScaleFactor > 1.0) {
+                previousScaleFactor = 1.0;
+            }
+            FloatOps += 3 + 2;  // double: conversion, add, conversion; conversion, compare
+        }
+        scaleFactor = previousScaleFactor;
+    } else if (thumbleCurrent >= 20 && thumbleCurrent <= 40) {
+        scaleFactor = 0.7 - ((thumbleCurrent - 20) * (0.7 - 0.1) / 20.0);
+        previousScaleFactor = scaleFactor;
+        FloatOps += 5;      // double: conversion, mul, div, sub, conversion
+    } else {
+        scaleFactor = 0.05;
+        previousScaleFactor = scaleFactor;
+    }
+    RightSpeed = RightSpeed * scaleFactor;
+    LeftSpeed = LeftSpeed * scaleFactor;
+    FloatOps += 2 * 3;      // conversion, mul, conversion to speed
+
+    correctionFactor = FloatCorrectionFactor(CalulatedAngle);
+
+    FloatOps += 2;          // compares
+    if (CalulatedAngle <= -dCORRECTION_ANGLE_THRESHOLD) {
+        FloatOps += 1;      // compare
+        if (fabsf(CalulatedAngle) < 3) {
+            FloatSetSpeed(Motor_Right, RightSpeed * correctionFactor);
+            FloatStartMotorKeepDirection(Motor_Right);
+            FloatOps += 3;  // conversion, mul, conversion to speed
+        } else {
+            FloatSetSpeed(Motor_Right, RightSpeed);
+            FloatStartMotor(Motor_Right, R_REV);
+        }
+        FloatSetSpeed(Motor_Left, LeftSpeed);
+        FloatStartMotorKeepDirection(Motor_Left);
+    } else if (CalulatedAngle > dCORRECTION_ANGLE_THRESHOLD) {
+        FloatOps += 1;      // compare
+        if (fabsf(CalulatedAngle) < 3) {
+            FloatSetSpeed(Motor_Left, LeftSpeed * correctionFactor);
+            FloatStartMotorKeepDirection(Motor_Left);
+            FloatOps += 3;  // conversion, mul, conversion to speed
+        } else {
+            FloatSetSpeed(Motor_Left, LeftSpeed);
+            FloatStartMotor(Motor_Left, L_REV);
+        }
+        FloatSetSpeed(Motor_Right, RightSpeed);
+        FloatStartMotorKeepDirection(Motor_Right);
+    } else {
+        FloatSetSpeed(Motor_Left, LeftSpeed);
+        FloatSetSpeed(Motor_Right, RightSpeed);
+        FloatStartMotor(Motor_Right, MotorManager_GetStepDirection(Motor_Right));
+        FloatStartMotor(Motor_Left, MotorManager_GetStepDirection(Motor_Left));
+    }
+}
+
+static void FloatAutomaticCorrectionReverse(float Angle)
+{
+    float CalulatedAngle = IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, Angle);
+    uint16_t RightSpeed = MotorManager_GetStepSpeed(Motor_Right);
+    uint16_t LeftSpeed = MotorManager_GetStepSpeed(Motor_Left);
+    float correctionFactor;
+
+    FloatOps += 1 + FLOAT_OPS_CALCULATE_ANGLE;      // add
+    correctionFactor = FloatCorrectionFactor(CalulatedAngle);
+
+    FloatOps += 2;          // compares
+    if (CalulatedAngle >= dCORRECTION_ANGLE_THRESHOLD) {
+        FloatOps += 1;      // compare
+        if (fabsf(CalulatedAngle) < 3) {
+            FloatSetSpeed(Motor_Right, RightSpeed * correctionFactor);
+            FloatStartMotorKeepDirection(Motor_Right);
+            FloatOps += 3;  // conversion, mul, conversion to speed
+        } else {
+            FloatSetSpeed(Motor_Right, RightSpeed);
+            FloatStartMotor(Motor_Right, R_FOR);
+        }
+        FloatSetSpeed(Motor_Left, LeftSpeed);
+        FloatStartMotor(Motor_Left, MotorManager_GetStepDirection(Motor_Left));
+    } else if (CalulatedAngle < -dCORRECTION_ANGLE_THRESHOLD) {
+        FloatOps += 1;      // compare
+        if (fabsf(CalulatedAngle) < 3) {
+            FloatSetSpeed(Motor_Left, LeftSpeed * correctionFactor);
+            FloatStartMotorKeepDirection(Motor_Left);
+            FloatOps += 3;  // conversion, mul, conversion to speed
+        } else {
+            FloatSetSpeed(Motor_Left, LeftSpeed);
+            FloatStartMotor(Motor_Left, L_FOR);
+        }
+        FloatSetSpeed(Motor_Right, RightSpeed);
+        FloatStartMotor(Motor_Right, MotorManager_GetStepDirection(Motor_Right));
+    } else {
+        FloatSetSpeed(Motor_Left, LeftSpeed);
+        FloatSetSpeed(Motor_Right, RightSpeed);
+        FloatStartMotor(Motor_Right, MotorManager_GetStepDirection(Motor_Right));
+        FloatStartMotor(Motor_Left, MotorManager_GetStepDirection(Motor_Left));
+    }
+}
+
+/* Route steps and the variations of step setup each of them is checked with */
+
+static const int32_t StartRolls[] = { -ROLL_PI, -2000, -1, 0, 1, 1571, 3000, ROLL_PI };
+static const float Offsets[] = { 0.0f, 3.7f, -3.7f, 12.25f };
+static const float MagnetAngles[] = { 0.0f, 1.37f, -2.0f };
+#define COUNT(Array)    (sizeof(Array) / sizeof((Array)[0]))
+
+typedef void (*StepCheck)(const RouteStep *Step);
+
+static uint32_t ForEachStep(StepCheck Function)
+{
+    RouteData route;
+    uint32_t steps = 0;
+    uint8_t id, i;
+
+    for (id = RouteA; id < Route_NumOf; id++) {
+        Route_SetRoutePointer(&route, (Route_ID)id, 0);
+        for (i = 0; i < route.StepCount; i++) {
+            Function(&route.Step[i]);
+            steps++;
+        }
+    }
+    return steps;
+}
+
+/* Desired angle of a step started at Roll, as RouteManager_LoadNextStepData */
+static void SetupStep(const RouteStep *Step, int32_t Roll, float Offset, float MagnetAngle)
+{
+    DesiredAngle = CalculateDegreeFromPi(Roll);
+    if (Step->OperationType == L_90)
+        DesiredAngle -= Step->Angle;
+    else if (Step->OperationType == R_90)
+        DesiredAngle += Step->Angle;
+    if (DesiredAngle <= -180) {
+        DesiredAngle += 360;
+    } else if (DesiredAngle > 180) {
+        DesiredAngle -= 360;
+    }
+    TurnAngle = Step->Angle;
+    MagnetCorrectionAngle = MagnetAngle;
+    cor_dX = Step->dX;
+    stepDistanceOffset = Offset;
+    RouteManager_UpdateStepFixedPoint();
+}
+
+static int32_t WrapRoll(int32_t Roll)
+{
+    if (Roll > ROLL_PI) {
+        return Roll - 2 * ROLL_PI - 1;
+    }
+    if (Roll < -ROLL_PI) {
+        return Roll + 2 * ROLL_PI + 1;
+    }
+    return Roll;
+}
+
+/* Roll at which CalculateDegreeFromPi gives Angle */
+static int32_t RollOf(float Angle)
+{
+    if (Angle >= 0.0f) {
+        return (int32_t)lroundf((180.0f - Angle) * ROLL_PI / 180.0f);
+    }
+    return (int32_t)lroundf((-180.0f - Angle) * ROLL_PI / 180.0f);
+}
+
+static struct {
+    double AngleError;          // [deg]
+    double DistanceError;       // [cm]
+    double ProgressError;       // [Q16 LSB] against float with the rounded step distance
+    double SearchStartError;
+    double SpeedError;          // [RPM]
+    uint32_t EndShift;          // [rotations]
+    uint32_t Evaluations;
+    uint32_t NearThreshold;
+    bool IsMismatch;
+} Result;
+
+static void ResetResult(void)
+{
+    memset(&Result, 0, sizeof(Result));
+    ResetOperations();
+}
+
+static void Worst(double *worst, double value)
+{
+    *worst = (value > *worst) ? value : *worst;
+}
+
+static void SetupOfStep(const RouteStep *Step)
+{
+    uint8_t r, o, m;
+    float distance;
+
+    for (r = 0; r < COUNT(StartRolls); r++) {
+        for (o = 0; o < COUNT(Offsets); o++) {
+            for (m = 0; m < COUNT(MagnetAngles); m++) {
+                SetupStep(Step, StartRolls[r], Offsets[o], MagnetAngles[m]);
+                Worst(&Result.AngleError, fabs(Q16ToDouble(DesiredAngleQ16) - DesiredAngle));
+                Worst(&Result.AngleError, fabs(Q16ToDouble(TurnAngleQ16) - TurnAngle));
+                Worst(&Result.AngleError, fabs(Q16ToDouble(MagnetCorrectionAngleQ16) - MagnetCorrectionAngle));
+                distance = (float)cor_dX + stepDistanceOffset;
+                Worst(&Result.DistanceError, fabs(StepDistance - ((distance > 0.0f) ? distance : 0.0f)));
+            }
+        }
+    }
+}
+
+static void StepSetup(void)
+{
+    const char *name = "step_setup";
+    int before = Failures;
+    uint32_t steps;
+    char measured[128];
+
+    ResetResult();
+    steps = ForEachStep(SetupOfStep);
+    Check(name, Result.AngleError <= 0.5 / 65536.0, "angle copy off by more than half a Q16 LSB");
+    Check(name, Result.DistanceError <= 0.5, "step distance not rounded");
+    snprintf(measured, sizeof(measured), "%u steps, max angle error %.2g deg, distance %.2f cm",
+             (unsigned)steps, Result.AngleError, Result.DistanceError);
+    Report(name, before, measured);
+}
+
+/* Step end in rotations of both wheels, counts up to 160 % of the step */
+static void ProgressOfStep(const RouteStep *Step)
+{
+    uint8_t o, mirror;
+    int32_t n, last;
+
+    if (Step->OperationType != NORM && Step->OperationType != NORM_NOMAGNET) {
+        return;
+    }
+    for (o = 0; o < COUNT(Offsets); o++) {
+        float distance;
+        uint16_t fixedDistance;
+
+        if (Step->OperationType == NORM_NOMAGNET && o > 0) {
+            break;
+        }
+        SetupStep(Step, 0, Offsets[o], 0.0f);
+        distance = (float)cor_dX + stepDistanceOffset;
+        fixedDistance = (Step->OperationType == NORM) ? StepDistance : (uint16_t)cor_dX;
+        if (distance <= 0.0f) {
+            continue;
+        }
+        last = (int32_t)(1.6f * distance / dDISTANCE_PER_MOTOR_ROTATION) + 2;
+        // wheels turn in opposite directions, second pass one of them slips
+        for (mirror = 0; mirror < 2; mirror++) {
+            int32_t fixedEnd = -1, floatEnd = -1;
+
+            for (n = 0; n <= last; n++) {
+                q16_t fixedPercent;
+                float floatPercent;
+                double error;
+
+                Rotations[Motor_Left] = n;
+                Rotations[Motor_Right] = (mirror == 0) ? -n : -(n * 7 / 8);
+                fixedPercent = RouteManager_GetEncoderFinishedPercent(fixedDistance);
+                floatPercent = FloatEncoderFinishedPercent(distance);
+                Result.Evaluations++;
+                error = fabs(Q16ToDouble(fixedPercent) - floatPercent) * distance;
+                Worst(&Result.DistanceError, error);
+                Worst(&Result.ProgressError, fabs(Q16ToDouble(fixedPercent) - (double)floatPercent * distance / fixedDistance) * 65536.0);
+                if (fixedEnd < 0 && fixedPercent >= dQ16_ONE) {
+                    fixedEnd = n;
+                }
+                if (floatEnd < 0 && floatPercent >= 1.0f) {
+                    floatEnd = n;
+                }
+                // IsNormStepAchieved takes the magnet search window on every call
+                if (Step->OperationType == NORM) {
+                    Worst(&Result.SearchStartError, fabs(Q16ToDouble(RouteManager_GetMagnetSearchStart()) - FloatMagnetSearchStart()));
+                }
+            }
+            Result.EndShift = (abs(fixedEnd - floatEnd) > (int32_t)Result.EndShift) ? (uint32_t)abs(fixedEnd - floatEnd) : Result.EndShift;
+        }
+    }
+}
+
+static void StepProgress(void)
+{
+    const char *name = "step_progress";
+    int before = Failures;
+    char measured[256], operations[96];
+
+    ResetResult();
+    ForEachStep(ProgressOfStep);
+    // Q16Div and Q16Mul truncate once per wheel, 1.26 is not exact in Q16
+    Check(name, Result.ProgressError <= 4.0, "progress off by more than the rounding of the step distance");
+    Check(name, Result.EndShift <= 1u, "step ends more than one rotation away");
+    Check(name, Result.SearchStartError <= 2.0 / 65536.0, "magnet search window");
+    FormatOperations(operations, sizeof(operations), Result.Evaluations);
+    snprintf(measured, sizeof(measured), "max error %.3f cm (%.1f LSB without distance rounding), end shift %u rotation, %s",
+             Result.DistanceError, Result.ProgressError, (unsigned)Result.EndShift, operations);
+    Report(name, before, measured);
+}
+
+static void ImuAngle(void)
+{
+    const char *name = "imu_angle";
+    int before = Failures;
+    int32_t roll;
+    char measured[160], operations[96];
+
+    ResetResult();
+    for (roll = -ROLL_PI; roll <= ROLL_PI; roll++) {
+        q16_t fixedAngle = CalculateDegreeFromPiQ16(roll);
+        float floatAngle = CalculateDegreeFromPi(roll);
+
+        FloatOps += 6;      // 2x conversion, div, mul, compare, add
+        Result.Evaluations++;
+        Worst(&Result.AngleError, fabs(Q16ToDouble(fixedAngle) - floatAngle));
+    }
+    Check(name, Result.AngleError <= 1e-4, "angle off by more than 0.0001 deg");
+    FormatOperations(operations, sizeof(operations), Result.Evaluations);
+    snprintf(measured, sizeof(measured), "max error %.2g deg, %s", Result.AngleError, operations);
+    Report(name, before, measured);
+}
+
+/* Speeds and starts the same, decisions may differ only at a threshold */
+static void Compare(bool isNearThreshold)
+{
+    uint8_t i;
+
+    for (i = Motor_Left; i <= Motor_Right; i++) {
+        if (Fixed.Start[i] != Float.Start[i] || abs((int)Fixed.Speed[i] - (int)Float.Speed[i]) > 3) {
+            if (isNearThreshold) {
+                Result.NearThreshold++;
+                return;
+            }
+            Result.IsMismatch = true;
+        }
+    }
+    for (i = Motor_Left; i <= Motor_Right; i++) {
+        Worst(&Result.SpeedError, abs((int)Fixed.Speed[i] - (int)Float.Speed[i]));
+    }
+}
+
+static void TurnOfStep(const RouteStep *Step)
+{
+    uint8_t r, m;
+    int32_t roll;
+
+    if (Step->OperationType != L_90 && Step->OperationType != R_90) {
+        return;
+    }
+    StepSpeed[Motor_Right] = Step->RightSpeed;
+    StepSpeed[Motor_Left] = Step->LeftSpeed;
+    for (r = 0; r < COUNT(StartRolls); r++) {
+        for (m = 0; m < COUNT(MagnetAngles); m++) {
+            SetupStep(Step, StartRolls[r], 0.0f, MagnetAngles[m]);
+            // whole circle, the turn and over it
+            for (roll = -ROLL_PI; roll <= ROLL_PI; roll++) {
+                float floatAngle = CalculateDegreeFromPi(roll);
+                float error = IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, floatAngle);
+                bool isFixedDone, isFloatDone, isNear;
+
+                Rotations[Motor_Left] = roll / 20;
+                Rotations[Motor_Right] = -roll / 20;
+                CurrentAngle = CalculateDegreeFromPiQ16(roll);
+                ClearCommands();
+                isFixedDone = RouteManager_Is90DegStepAchieved((OperType)Step->OperationType);
+                isFloatDone = Float90DegStepAchieved(floatAngle);
+                Result.Evaluations++;
+                // slow down starts at half of the turn, step ends 1 degree before
+                isNear = fabsf(fabsf(error) - fabsf(TurnAngle) / 2.0f) < THRESHOLD_MARGIN ||
+                         fabsf(fabsf(error) - 1.0f) < THRESHOLD_MARGIN;
+                Compare(isNear);
+                if (isFixedDone != isFloatDone) {
+                    Result.NearThreshold += isNear ? 1u : 0u;
+                    Result.IsMismatch |= !isNear;
+                }
+            }
+        }
+    }
+}
+
+static void Turn90(void)
+{
+    const char *name = "turn_90";
+    int before = Failures;
+    char measured[160], operations[96];
+
+    ResetResult();
+    ForEachStep(TurnOfStep);
+    Check(name, !Result.IsMismatch, "step end or speeds differ from float");
+    Check(name, Result.SpeedError <= 1.0, "speed off by more than 1 RPM");
+    FormatOperations(operations, sizeof(operations), Result.Evaluations);
+    snprintf(measured, sizeof(measured), "max speed error %.0f RPM, %u at threshold, %s",
+             Result.SpeedError, (unsigned)Result.NearThreshold, operations);
+    Report(name, before, measured);
+}
+
+static void CorrectionOfStep(const RouteStep *Step)
+{
+    // thumble load and step profile change between evaluations
+    static const uint16_t currents[] = { 0, 0, 0, 5, 19, 20, 27, 33, 40, 41, 55, 12, 0, 0, 0, 0, 0 };
+    static uint32_t sequence;
+    uint8_t r, m;
+    int32_t center, k;
+    bool isForward = (Step->DirectionRight == R_FOR);
+
+    if (Step->OperationType != NORM && Step->OperationType != NORM_NOMAGNET) {
+        return;
+    }
+    StepSpeed[Motor_Right] = Step->RightSpeed;
+    StepSpeed[Motor_Left] = Step->LeftSpeed;
+    StepDirection[Motor_Right] = Step->DirectionRight;
+    StepDirection[Motor_Left] = Step->DirectionLeft;
+    for (r = 0; r < COUNT(StartRolls); r += 2) {
+        for (m = 0; m < COUNT(MagnetAngles); m++) {
+            SetupStep(Step, StartRolls[r], 0.0f, MagnetAngles[m]);
+            // 7 degrees around the desired heading
+            center = RollOf(DesiredAngle + MagnetCorrectionAngle);
+            for (k = -120; k <= 120; k++) {
+                int32_t roll = WrapRoll(center + k);
+                float floatAngle = CalculateDegreeFromPi(roll);
+                q16_t fixedAngle = CalculateDegreeFromPiQ16(roll);
+                float error = fabsf(IMUHandler_CalculateAngle(DesiredAngle + MagnetCorrectionAngle, floatAngle));
+
+                ThumbleCurrent = currents[sequence % COUNT(currents)];
+                sequence++;
+                ClearCommands();
+                if (isForward) {
+                    RouteManager_AutomaticCorrectionForward(fixedAngle);
+                    FloatAutomaticCorrectionForward(floatAngle);
+                } else {
+                    RouteManager_AutomaticCorrectionReverse(fixedAngle);
+                    FloatAutomaticCorrectionReverse(floatAngle);
+                }
+                Result.Evaluations++;
+                Compare(fabsf(error - dCORRECTION_ANGLE_THRESHOLD) < THRESHOLD_MARGIN ||
+                        fabsf(error - dPROPORTIONAL_CORRECTION_ANGLE) < THRESHOLD_MARGIN);
+            }
+        }
+    }
+}
+
+static void Correction(void)
+{
+    const char *name = "correction";
+    int before = Failures;
+    char measured[160], operations[96];
+
+    ResetResult();
+    ForEachStep(CorrectionOfStep);
+    Check(name, !Result.IsMismatch, "speeds or directions differ from float");
+    // thumble scale, ramp and proportional correction each round once
+    Check(name, Result.SpeedError <= 3.0, "speed off by more than 3 RPM");
+    FormatOperations(operations, sizeof(operations), Result.Evaluations);
+    snprintf(measured, sizeof(measured), "max speed error %.0f RPM, %u at threshold, %s",
+             Result.SpeedError, (unsigned)Result.NearThreshold, operations);
+    Report(name, before, measured);
+}
+
+int main(void)
+{
+    StepSetup();
+    StepProgress();
+    ImuAngle();
+    Turn90();
+    Correction();
+    return (Failures > 0) ? 1 : 0;
+}
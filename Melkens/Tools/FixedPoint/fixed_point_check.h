@@ -0,0 +1,42 @@
+/*
+ * Shared by fixed_point_check.c and the functions fixed_point_check.py
+ * copies out of pmb_RouteManager.c, IMUHandler.c and pmb_Functions.c.
+ * Globals are the ones of pmb_RouteManager.c, defined by the driver.
+ */
+
+#ifndef FIXED_POINT_CHECK_H
+#define FIXED_POINT_CHECK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "pmb_Settings.h"
+#include "RoutesDataTypes.h"
+#include "pmb_MotorManager.h"
+#include "IMUHandler/IMUHandler.h"
+#include "pmb_Functions.h"
+#include "Tools/FixedPoint.h"
+#include "route_constants.h"     /* macros copied by fixed_point_check.py */
+
+extern uint32_t cor_dX;
+extern float stepDistanceOffset;
+extern float DesiredAngle;
+extern float TurnAngle;
+extern float MagnetCorrectionAngle;
+extern q16_t DesiredAngleQ16;
+extern q16_t MagnetCorrectionAngleQ16;
+extern q16_t TurnAngleQ16;
+extern uint16_t StepDistance;
+extern q16_t CurrentAngle;
+extern q16_t CalulatedAngle;
+extern bool SlowerSpeedFlag;
+extern bool VelocityCorrection;
+
+void RouteManager_UpdateStepFixedPoint(void);
+q16_t RouteManager_GetEncoderFinishedPercent(uint16_t Distance);
+q16_t RouteManager_GetMagnetSearchStart(void);
+bool RouteManager_Is90DegStepAchieved(OperType Operation);
+void RouteManager_AutomaticCorrectionForward(q16_t Angle);
+void RouteManager_AutomaticCorrectionReverse(q16_t Angle);
+
+#endif
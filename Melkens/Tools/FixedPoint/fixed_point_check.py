@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+Host check of the PMB fixed point route calculations, Melkens_PMB/Tools/FixedPoint.
+
+Builds fixed_point_check.c with FixedPoint.c, Routes.c and the step functions
+of pmb_RouteManager.c, IMUHandler.c and pmb_Functions.c (copied out of the
+sources by name, the rest of those files needs the target). Every step of
+every route runs through the fixed point code and the float code it replaced:
+  - step setup: Q16 copies of the float angles within half an LSB, step
+    distance rounded to a cm,
+  - step progress of NORM and NORM_NOMAGNET steps: error no larger than the
+    rounding of the step distance, step end within one rotation, magnet
+    search window,
+  - IMU roll to degrees over the whole circle,
+  - 90 degree turns: speeds within 1 RPM and the same step end, a negative
+    float speed far past the turn (undefined conversion to uint16_t) as 0,
+  - automatic correction with thumble load and step profile: speeds within
+    3 RPM and the same motor starts.
+Decisions may differ only within 0.001 degree of a threshold.
+
+FixedPoint helper calls (and their MUL/DIV instructions) and float operations
+(library calls on dsPIC33CK) are reported per evaluation. These are operation
+counts only, not dsPIC33CK cycles: float operations are not split by kind and
+neither XC16 nor its simulator are used here, so no cycle figures are given.
+
+Usage:
+  fixed_point_check.py [--cc cc] [--cflags "-O2"]
+"""
+
+import argparse
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+PMB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_PMB')
+
+# source, macros, functions
+EXTRACTS = [
+    ('pmb_RouteManager.c', ['FULL_WHEEL_TURN', 'dPROPORTIONAL_CORRECTION_ANGLE'], [
+        'RouteManager_UpdateStepFixedPoint',
+        'RouteManager_GetEncoderFinishedPercent',
+        'RouteManager_GetMagnetSearchStart',
+        'RouteManager_Is90DegStepAchieved',
+        'RouteManager_AutomaticCorrectionForward',
+        'RouteManager_AutomaticCorrectionReverse']),
+    (os.path.join('IMUHandler', 'IMUHandler.c'), [], [
+        'IMUHandler_CalculateAngle',
+        'IMUHandler_CalculateAngleQ16']),
+    ('pmb_Functions.c', ['FIXED_POINT_BITS', 'FIXED_POINT_SCALE'], [
+        'CalculateDegreeFromPi',
+        'CalculateDegreeFromPiQ16']),
+]
+
+WRAPPED = ['FixedPoint_Q15Mul', 'FixedPoint_ScaleU16Q15', 'FixedPoint_Q16Mul', 'FixedPoint_Q16Div',
+           'FixedPoint_Q16DivQ16', 'FixedPoint_Q16Abs', 'FixedPoint_ScaleU16']
+
+
+def extract_function(text, name):
+    match = re.search(r'^(?:static\s+)?[\w ]+?\b%s\s*\([^;{]*\)\s*\{' % name, text, re.MULTILINE)
+    if match is None:
+        sys.exit('%s not found' % name)
+    depth = 0
+    for end in range(match.end() - 1, len(text)):
+        depth += {'{': 1, '}': -1}.get(text[end], 0)
+        if depth == 0:
+            break
+    # static functions are called by the driver
+    return re.sub(r'^static\s+', '', text[match.start():end + 1])
+
+
+def generate(directory):
+    constants = []
+    lines = ['#include "fixed_point_check.h"', '#include <math.h>']
+    for source, macros, functions in EXTRACTS:
+        with open(os.path.join(PMB_DIR, source)) as file:
+            text = file.read()
+        for macro in macros:
+            constants.append(re.search(r'^#define\s+%s\b.*$' % macro, text, re.MULTILINE).group(0))
+        lines.append('\n/* %s */' % source.replace(os.sep, '/'))
+        for function in functions:
+            lines.append(extract_function(text, function) + '\n')
+    with open(os.path.join(directory, 'route_constants.h'), 'w') as file:
+        file.write('\n'.join(constants) + '\n')
+    with open(os.path.join(directory, 'route_functions.c'), 'w') as file:
+        file.write('\n'.join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        # PMB headers include the device header, only stdint is needed from it
+        with open(os.path.join(directory, 'xc.h'), 'w') as file:
+            file.write('#include <stdint.h>\n')
+        generate(directory)
+        functions = os.path.join(directory, 'route_functions.c')
+        output = os.path.join(directory, 'fixed_point_check')
+        # firmware code sets variables it does not use on every path
+        command = [args.cc, '-std=c99', '-Wall', '-Wextra', '-Wno-unused-but-set-variable', '-Wno-unused-parameter'] + shlex.split(args.cflags) + [
+            '-I' + directory, '-I' + TOOL_DIR, '-I' + PMB_DIR, '-o', output,
+            os.path.join(TOOL_DIR, 'fixed_point_check.c'), functions,
+            os.path.join(PMB_DIR, 'Tools', 'FixedPoint.c'),
+            os.path.join(PMB_DIR, 'Routes.c'), '-lm'] + ['-Wl,--wrap=' + name for name in WRAPPED]
+        subprocess.check_call(command)
+        result = subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True)
+
+    failed = result.returncode != 0
+    for line in result.stdout.splitlines():
+        fields = line.split(None, 2)
+        print('%-28s %s' % (fields[0], ' '.join(fields[1:])))
+        failed |= fields[1] != 'ok'
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,461 @@
+#!/usr/bin/env python3
+"""
+Host simulation of firmware transfer to the loaders (Melkens_Lib/FwUpdate).
+
+Builds Melkens_Lib/FwUpdate/FwUpdate.c and Melkens_Lib/CRC16/CRC16.c with
+the host C compiler, loads them with ctypes and runs the ESP sender against
+a loader receiver writing a simulated flash:
+
+  - flash: pages erased to 0xFF, program units written only when erased (as
+    STM32 and dsPIC flash, a second write is an error), erase and program
+    times of the target; the loader receives nothing while it works on
+    flash, bytes arriving meanwhile go to its receive buffer and are lost
+    when it is full,
+  - link: 8N1 at the loader rate in both directions, latency of the bridge
+    (PMB is reached through the IMU loader), corrupted bytes and lost packets,
+  - resets of the loader (RAM lost, flash kept) and of the sender (ESP
+    restarts and sends the same image again).
+
+Usage:
+  fw_update_sim.py [--scenario all] [--seed 1] [--cc cc]
+
+A transfer passes when the flash holds the image with a valid record
+(FwImage_IsValid, the loader start check) or, for the broken image
+scenarios, when the loader refuses it and the sender fails. Clean transfers
+must reach MIN_EFFICIENCY of the slower of link and flash, resumes must not
+send more than RESUME_LIMIT blocks again. The boot word scenarios check
+FwBoot_Decide: a requested loader, an application confirmed at once and
+one that never comes up (back in the loader after dFW_BOOT_TRIALS starts).
+Every scenario runs twice and must give the same result. Exit code 1 when
+any scenario fails.
+"""
+
+import argparse
+import ctypes
+import heapq
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+LIB_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Melkens_Lib')
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'MessageGen'))
+import messages  # noqa: E402
+
+BAUDS = [115200, 460800, 921600, 2000000]   # LinkSpeed.c, index is dLINK_RATE_...
+BITS_PER_BYTE = 10                          # 8N1
+BLOCK_SIZE = 256                            # dFW_BLOCK_SIZE
+PACKET_OVERHEAD = 10                        # sync, command, target, sequence, length, CRC
+WINDOW = 4                                  # blocks in flight, FirmwareUpload.cpp
+TICK = 10.0                                 # [ms] FwSender_Poll without traffic
+RX_BUFFER = 2048                            # [bytes] loader receive ring
+LOADER_START = 50.0                         # [ms] reset to loader receiving
+MIN_EFFICIENCY = 0.85                       # of the slower of link and flash, clean transfers
+RESUME_LIMIT = 2 * WINDOW                   # blocks sent again after a reset
+
+STEP_DONE = 4                               # FwSenderStep
+STEP_FAILED = 5
+STATE_NAMES = ['idle', 'receiving', 'done', 'error header', 'error flash', 'error crc']
+
+# Flash of the loaders, the layout is the one the loaders are built for:
+# IMU loader in the first 16 KB, application up to the record page below
+# the magnetometer calibration; PMB image as 4 bytes per instruction word
+# (hex2bin of the XC16 output), 1024 instruction pages, double word programming.
+# name: (target, image address, image size, record address, page, program unit,
+#        erase [ms], program [ms], bridge latency [ms])
+TARGETS = {
+    'imu': (messages.FW_TARGET_IMU, 0x08004000, 0x2A000, 0x0802E000, 4096, 8, 22.0, 0.085, 0.0),
+    'pmb': (messages.FW_TARGET_PMB, 0x00004000, 0x24000, 0x00028000, 4096, 8, 25.0, 0.060, 1.0),
+}
+
+# name: (target, rate, image size, byte error rate, packet loss, events, expected)
+# events: (share of the image acknowledged, 'loader_reset' | 'sender_restart')
+# expected: 'done' or the loader state the sender fails on
+SCENARIOS = {
+    'imu_921600': ('imu', 2, 160 * 1024 + 77, 0.0, 0.0, [], 'done'),
+    'imu_2000000': ('imu', 3, 160 * 1024 + 77, 0.0, 0.0, [], 'done'),
+    'pmb_921600': ('pmb', 2, 120 * 1024 + 12, 0.0, 0.0, [], 'done'),
+    'imu_115200': ('imu', 0, 48 * 1024, 0.0, 0.0, [], 'done'),
+    'imu_noisy': ('imu', 2, 96 * 1024, 2e-6, 0.01, [], 'done'),
+    'pmb_noisy': ('pmb', 3, 96 * 1024, 1e-5, 0.02, [], 'done'),
+    'imu_loader_reset': ('imu', 2, 96 * 1024, 0.0, 0.0, [(0.4, 'loader_reset')], 'done'),
+    'pmb_sender_restart': ('pmb', 2, 96 * 1024, 0.0, 0.0, [(0.6, 'sender_restart')], 'done'),
+    'imu_twice_reset': ('imu', 3, 96 * 1024, 1e-6, 0.005,
+                        [(0.2, 'loader_reset'), (0.7, 'sender_restart')], 'done'),
+    'imu_bad_crc': ('imu', 2, 32 * 1024, 0.0, 0.0, [], 'error crc'),
+    'imu_other_loader': ('imu', 2, 32 * 1024, 0.0, 0.0, [], 'idle'),
+    'imu_too_large': ('imu', 2, 0x2A000 + 1, 0.0, 0.0, [], 'error header'),
+}
+
+
+class FwImageHeader(ctypes.Structure):
+    _fields_ = [('Magic', ctypes.c_uint32), ('Target', ctypes.c_uint8), ('Reserved', ctypes.c_uint8 * 3),
+                ('Version', ctypes.c_uint32), ('Size', ctypes.c_uint32), ('Crc', ctypes.c_uint16),
+                ('Reserved2', ctypes.c_uint8 * 12), ('HeaderCrc', ctypes.c_uint16)]
+
+
+EraseFunction = ctypes.CFUNCTYPE(ctypes.c_bool, ctypes.c_uint32)
+ProgramFunction = ctypes.CFUNCTYPE(ctypes.c_bool, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint8))
+ReadFunction = ctypes.CFUNCTYPE(None, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint8), ctypes.c_uint32)
+ImageReadFunction = ctypes.CFUNCTYPE(ctypes.c_bool, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint8), ctypes.c_uint16)
+
+
+class FwFlash(ctypes.Structure):
+    _fields_ = [('ImageAddress', ctypes.c_uint32), ('ImageSize', ctypes.c_uint32),
+                ('RecordAddress', ctypes.c_uint32), ('PageSize', ctypes.c_uint32),
+                ('ProgramSize', ctypes.c_uint8), ('Erase', EraseFunction), ('Program', ProgramFunction),
+                ('Read', ReadFunction)]
+
+
+def build_library(cc, cflags, directory):
+    output = os.path.join(directory, 'fwupdate.so')
+    subprocess.check_call([cc, '-std=c99'] + cflags.split() + [
+        '-shared', '-fPIC', '-o', output,
+        os.path.join(LIB_DIR, 'FwUpdate', 'FwUpdate.c'), os.path.join(LIB_DIR, 'CRC16', 'CRC16.c')])
+    library = ctypes.CDLL(output)
+    library.CRC16_Init.argtypes = []
+    library.CRC16.argtypes = [ctypes.c_char_p, ctypes.c_uint16]
+    library.CRC16.restype = ctypes.c_uint16
+    library.CRC16_Update.argtypes = [ctypes.c_uint16, ctypes.c_char_p, ctypes.c_uint16]
+    library.CRC16_Update.restype = ctypes.c_uint16
+    library.FwImage_MakeHeader.argtypes = [ctypes.POINTER(FwImageHeader), ctypes.c_uint8, ctypes.c_uint32,
+                                           ctypes.c_uint32, ctypes.c_uint16]
+    library.FwImage_IsValid.argtypes = [ctypes.POINTER(FwFlash), ctypes.POINTER(FwImageHeader)]
+    library.FwImage_IsValid.restype = ctypes.c_bool
+    library.FwReceiver_Init.argtypes = [ctypes.c_void_p, ctypes.POINTER(FwFlash), ctypes.c_uint8]
+    library.FwReceiver_Receive.argtypes = [ctypes.c_void_p, ctypes.c_uint8, ctypes.c_void_p]
+    library.FwReceiver_Receive.restype = ctypes.c_uint16
+    library.FwSender_Start.argtypes = [ctypes.c_void_p, ctypes.POINTER(FwImageHeader), ImageReadFunction,
+                                       ctypes.c_uint8, ctypes.c_uint32]
+    library.FwSender_Receive.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_uint32]
+    library.FwSender_Poll.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32]
+    library.FwSender_Poll.restype = ctypes.c_uint16
+    library.FwBoot_Request.argtypes = [ctypes.c_uint8, ctypes.c_uint8]
+    library.FwBoot_Request.restype = ctypes.c_uint32
+    library.FwBoot_Decide.argtypes = [ctypes.POINTER(ctypes.c_uint32), ctypes.c_bool,
+                                      ctypes.POINTER(ctypes.c_uint8), ctypes.POINTER(ctypes.c_uint8)]
+    library.FwBoot_Decide.restype = ctypes.c_uint8
+    library.FwBoot_Confirm.argtypes = []
+    library.FwBoot_Confirm.restype = ctypes.c_uint32
+    library.CRC16_Init()
+    return library
+
+
+class Flash:
+    """Loader flash, busy time [ms] accumulates while the loader works on it"""
+
+    def __init__(self, target):
+        _, self.image_address, image_size, self.record_address, self.page, unit, \
+            self.erase_time, self.program_time, _ = TARGETS[target]
+        self.base = self.image_address
+        self.memory = bytearray(b'\xff' * (self.record_address + self.page - self.base))
+        self.unit = unit
+        self.busy = 0.0
+        self.erases = {}        # page address: count
+        self.programs = 0
+        self.errors = 0
+        # callbacks are kept here, ctypes does not hold them
+        self.functions = (EraseFunction(self.erase), ProgramFunction(self.program), ReadFunction(self.read))
+        self.interface = FwFlash(self.image_address, image_size, self.record_address, self.page, unit,
+                                 *self.functions)
+
+    def erase(self, address):
+        if (address - self.base) % self.page:
+            self.errors += 1
+            return False
+        offset = address - self.base
+        self.memory[offset:offset + self.page] = b'\xff' * self.page
+        self.erases[address] = self.erases.get(address, 0) + 1
+        self.busy += self.erase_time
+        return True
+
+    def program(self, address, data):
+        offset = address - self.base
+        if offset % self.unit or any(b != 0xFF for b in self.memory[offset:offset + self.unit]):
+            self.errors += 1
+            return False
+        self.memory[offset:offset + self.unit] = ctypes.string_at(data, self.unit)
+        self.programs += 1
+        self.busy += self.program_time
+        return True
+
+    def read(self, address, data, length):
+        offset = address - self.base
+        ctypes.memmove(data, bytes(self.memory[offset:offset + length]), length)
+
+    def image(self, size):
+        offset = self.image_address - self.base
+        return bytes(self.memory[offset:offset + size])
+
+
+def make_image(rng, size):
+    """Code with a run of erased bytes (padding between sections) in the middle"""
+    image = bytearray(rng.getrandbits(8) for _ in range(size))
+    middle = (size // 2) & ~(BLOCK_SIZE - 1)
+    image[middle:middle + 3 * BLOCK_SIZE] = b'\xff' * (3 * BLOCK_SIZE)
+    return bytes(image)
+
+
+class Simulation:
+    def __init__(self, library, args, scenario):
+        self.library = library
+        self.rng = random.Random(args.seed)
+        self.target_name, rate, size, self.byte_error, self.loss, self.script, self.expected = SCENARIOS[scenario]
+        target = TARGETS[self.target_name]
+        self.target = target[0]
+        self.baud = BAUDS[rate]
+        self.latency = target[8]
+        self.image = make_image(self.rng, size)
+        self.flash = Flash(self.target_name)
+        self.header = FwImageHeader()
+        crc = self.crc(self.image)
+        if scenario.endswith('bad_crc'):
+            crc ^= 0x0100
+        # PMB image sent while the IMU loader runs: packets for another target are not answered
+        header_target = messages.FW_TARGET_PMB if scenario.endswith('other_loader') else self.target
+        library.FwImage_MakeHeader(ctypes.byref(self.header), header_target, (crc << 16) | (size & 0xFFFF),
+                                   size, crc)
+        self.read_function = ImageReadFunction(self.read_image)
+        self.sender = ctypes.create_string_buffer(1024)
+        self.receiver = ctypes.create_string_buffer(1024)
+        self.packet = ctypes.create_string_buffer(300)
+        self.reply = ctypes.create_string_buffer(300)
+        self.events = []
+        self.order = 0
+        self.esp_line_free = 0.0
+        self.loader_line_free = 0.0
+        self.loader_rx = bytearray()
+        self.loader_busy_until = 0.0
+        self.loader_generation = 0
+        self.sent_blocks = 0
+        self.lost_bytes = 0
+        self.corrupted = 0
+
+    def crc(self, data):
+        crc = 0xFFFF  # dCRC16_INIT
+        for offset in range(0, len(data), 0x8000):
+            crc = self.library.CRC16_Update(crc, data[offset:offset + 0x8000], len(data[offset:offset + 0x8000]))
+        return crc
+
+    def read_image(self, offset, data, length):
+        ctypes.memmove(data, self.image[offset:offset + length], length)
+        return True
+
+    def push(self, time, kind, data=None):
+        self.order += 1
+        heapq.heappush(self.events, (time, self.order, kind, data))
+
+    def transmit(self, data, now, line_free):
+        """Returns the end of transmission, bytes are damaged on the way"""
+        start = max(now, line_free)
+        end = start + len(data) * BITS_PER_BYTE * 1000.0 / self.baud
+        if self.rng.random() < self.loss:
+            return end, None
+        data = bytearray(data)
+        for i in range(len(data)):
+            if self.byte_error and self.rng.random() < self.byte_error:
+                data[i] ^= 1 << self.rng.randrange(8)
+                self.corrupted += 1
+        return end, bytes(data)
+
+    def sender_step(self):
+        return ctypes.cast(self.sender, ctypes.POINTER(ctypes.c_int))[0]
+
+    def sender_field(self, name):
+        # FwSender: Step, LoaderState, Window, Retries, Read, Header, BlockCount, NextBlock, AckedBlocks, Resent
+        offset = {'AckedBlocks': 8 + ctypes.sizeof(ctypes.c_void_p) + 32 + 4,
+                  'Resent': 8 + ctypes.sizeof(ctypes.c_void_p) + 32 + 6}[name]
+        return int.from_bytes(self.sender.raw[offset:offset + 2], 'little')
+
+    def pump(self, now):
+        """ESP sends everything the sender has, its UART queues behind the line"""
+        while True:
+            length = self.library.FwSender_Poll(self.sender, self.packet, int(now) & 0xFFFFFFFF)
+            if not length:
+                break
+            data = self.packet.raw[:length]
+            if data[2] == 3:
+                self.sent_blocks += 1
+            self.esp_line_free, data = self.transmit(data, now, self.esp_line_free)
+            if data is not None:
+                self.push(self.esp_line_free + self.latency, 'loader_rx', (self.loader_generation, data))
+
+    def loader_work(self, now):
+        """Loader takes buffered bytes until a packet needs flash time"""
+        generation = self.loader_generation
+        while self.loader_rx and now >= self.loader_busy_until:
+            byte = self.loader_rx.pop(0)
+            self.flash.busy = 0.0
+            length = self.library.FwReceiver_Receive(self.receiver, byte, self.reply)
+            if self.flash.busy:
+                self.loader_busy_until = now + self.flash.busy
+                self.push(self.loader_busy_until, 'loader_ready', generation)
+            if length:
+                start = max(now + self.flash.busy, self.loader_line_free)
+                self.loader_line_free, data = self.transmit(self.reply.raw[:length], start, self.loader_line_free)
+                if data is not None:
+                    self.push(self.loader_line_free + self.latency, 'esp_rx', data)
+
+    def loader_start(self, now):
+        self.loader_generation += 1
+        self.loader_rx = bytearray()
+        self.loader_busy_until = now + LOADER_START
+        self.library.FwReceiver_Init(self.receiver, ctypes.byref(self.flash.interface), self.target)
+        self.push(self.loader_busy_until, 'loader_ready', self.loader_generation)
+
+    def sender_start(self, now):
+        self.library.FwSender_Start(self.sender, ctypes.byref(self.header), self.read_function, WINDOW,
+                                    int(now) & 0xFFFFFFFF)
+        self.pump(now)
+
+    def run(self):
+        self.loader_start(0.0)
+        self.sender_start(0.0)
+        self.push(TICK, 'tick')
+        script = sorted(self.script)
+        block_count = (len(self.image) + BLOCK_SIZE - 1) // BLOCK_SIZE
+        resent_after = []
+        now = 0.0
+        while self.events:
+            now, _, kind, data = heapq.heappop(self.events)
+            if kind == 'loader_rx':
+                generation, data = data
+                if generation != self.loader_generation:
+                    continue
+                room = RX_BUFFER - len(self.loader_rx)
+                self.lost_bytes += max(0, len(data) - room)
+                self.loader_rx += data[:room]
+                self.loader_work(now)
+            elif kind == 'loader_ready':
+                if data == self.loader_generation:
+                    self.loader_work(now)
+            elif kind == 'esp_rx':
+                self.library.FwSender_Receive(self.sender, data, len(data), int(now) & 0xFFFFFFFF)
+                self.pump(now)
+            elif kind == 'tick':
+                self.pump(now)
+                if self.sender_step() in (STEP_DONE, STEP_FAILED):
+                    break
+                self.push(now + TICK, 'tick')
+
+            if script and self.sender_field('AckedBlocks') >= script[0][0] * block_count:
+                _, event = script.pop(0)
+                acked = self.sender_field('AckedBlocks')
+                if event == 'loader_reset':
+                    self.loader_start(now)
+                else:
+                    self.sender_start(now)
+                resent_after.append((self.sent_blocks, acked))
+        return now, block_count, resent_after
+
+    def report(self, name):
+        elapsed, block_count, resets = self.run()
+        step = self.sender_step()
+        loader_state = self.sender.raw[4]
+        header = FwImageHeader()
+        valid = self.library.FwImage_IsValid(ctypes.byref(self.flash.interface), ctypes.byref(header))
+        size = len(self.image)
+        if self.expected == 'done':
+            ok = step == STEP_DONE and valid and self.flash.image(size) == self.image
+        else:
+            ok = step == STEP_FAILED and STATE_NAMES[loader_state] == self.expected and not valid
+        ok = ok and not self.flash.errors
+
+        # each resume may send the blocks in flight and the partly written one again
+        extra = self.sent_blocks - block_count
+        clean = not self.byte_error and not self.loss
+        if clean and self.expected == 'done':
+            ok = ok and extra <= RESUME_LIMIT * len(resets)
+            pages = [count for count in self.flash.erases.values()]
+            ok = ok and max(pages) == 1
+        efficiency = 0.0
+        if self.expected == 'done' and not resets:
+            # transfer time against the slower of link and flash for the image bytes
+            _, _, _, _, _, unit, erase_time, program_time, _ = TARGETS[self.target_name]
+            pages = (size + 4095) // 4096 + 1
+            link = (size + block_count * PACKET_OVERHEAD) * BITS_PER_BYTE * 1000.0 / self.baud
+            flash = size / unit * program_time
+            bound = pages * erase_time + max(link, flash)
+            efficiency = bound / elapsed
+            if clean:
+                ok = ok and efficiency >= MIN_EFFICIENCY
+        print('%-19s %-4s %7d %4d kB %6.2f s %6.1f kB/s eff %3.0f %%  blocks %4d sent %4d  lost %4d B  '
+              'corrupt %3d  loader %-12s -> %s' % (
+                  name, self.target_name, self.baud, size // 1024, elapsed / 1000.0,
+                  size / elapsed, efficiency * 100.0, block_count, self.sent_blocks, self.lost_bytes,
+                  self.corrupted, STATE_NAMES[loader_state], 'PASS' if ok else 'FAIL'))
+        return ok, (step, loader_state, round(elapsed, 3), self.sent_blocks, self.flash.programs)
+
+
+def boot_scenarios(library):
+    """FwBoot_Decide over a series of starts, returns list of (name, ok)"""
+    word = ctypes.c_uint32()
+    target = ctypes.c_uint8()
+    rate = ctypes.c_uint8()
+
+    def decide(valid):
+        result = library.FwBoot_Decide(ctypes.byref(word), valid, ctypes.byref(target), ctypes.byref(rate))
+        return result, target.value, rate.value
+
+    results = []
+    # power on with anything in RAM, image confirmed on each start
+    word.value = 0xA5A5A5A5
+    runs = []
+    for _ in range(5):
+        runs.append(decide(True))
+        word.value = library.FwBoot_Confirm()
+    results.append(('boot_confirmed', all(run == (0, 0, 0) for run in runs)))
+
+    # requested loader for PMB at 921600, then the new image comes up
+    word.value = library.FwBoot_Request(messages.FW_TARGET_PMB, 2)
+    first = decide(True)
+    second = decide(True)
+    results.append(('boot_request', first == (1, messages.FW_TARGET_PMB, 2) and second == (0, 0, 0)))
+
+    # new image hangs before confirming: application for the trials, then the
+    # loader on every start until an image is committed and confirmed
+    word.value = library.FwBoot_Confirm()
+    runs = [decide(True)[0] for _ in range(6)]
+    expected = [0] * 3 + [1] * 3
+    word.value = library.FwBoot_Confirm()
+    recovered = decide(True)[0]
+    results.append(('boot_rollback', runs == expected and recovered == 0))
+
+    # no valid image at all
+    word.value = library.FwBoot_Confirm()
+    results.append(('boot_no_image', decide(False) == (1, 0, 0)))
+    for name, ok in results:
+        print('%-19s -> %s' % (name, 'PASS' if ok else 'FAIL'))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='FwUpdate host simulation')
+    parser.add_argument('--scenario', default='all', choices=['all'] + sorted(SCENARIOS))
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-Wall -Wextra -O2')
+    args = parser.parse_args()
+
+    names = sorted(SCENARIOS) if args.scenario == 'all' else [args.scenario]
+    with tempfile.TemporaryDirectory() as directory:
+        library = build_library(args.cc, args.cflags, directory)
+        print('window %d blocks of %d bytes, loader buffer %d bytes' % (WINDOW, BLOCK_SIZE, RX_BUFFER))
+        oks = []
+        for name in names:
+            first_ok, first = Simulation(library, args, name).report(name)
+            again_ok, again = Simulation(library, args, name).report(name + ' (2)')
+            deterministic = first == again
+            if not deterministic:
+                print('%-19s not deterministic: %s / %s -> FAIL' % (name, first, again))
+            oks.append(first_ok and again_ok and deterministic)
+        if args.scenario == 'all':
+            oks += [ok for _, ok in boot_scenarios(library)]
+    print('PASS' if all(oks) else 'FAIL')
+    return 0 if all(oks) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
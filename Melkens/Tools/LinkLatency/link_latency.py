@@ -0,0 +1,423 @@
+#!/usr/bin/env python3
+"""
+Joystick to PMB latency test.
+
+Measures time from a WebSocket joystick message received by the ESP to the
+Imu2PmbFrame carrying the new wheel speeds, which is the manual driving lag
+added by ESP -> IMU -> PMB forwarding.
+
+Usage:
+  link_latency.py measure --ws ws://192.168.4.1/ws --port /dev/ttyUSB0 [--count 200]
+        hardware test: sends joystick messages to the ESP WebSocket and
+        timestamps Imu2PmbFrame on a USB-UART adapter listening on the IMU
+        TX -> PMB RX line (115200 8N1). Wheels turn, lift the robot.
+        Needs pyserial and websocket-client.
+  link_latency.py simulate [--count 2000] [--legacy]
+        timing model of the same path: ESP rate limit and keep-alive, UART
+        frame times, IMU main loop, 1ms tasks and PMB frame rate limit;
+        --legacy models the former 100ms ESP and IMU send cycles
+  link_latency.py timeline capture.bin | --self-test
+        rebuilds per command timelines from Imu2EspFrame.trace found in a raw
+        capture of the IMU TX -> ESP RX line; --self-test checks the
+        reconstruction on generated frames with wrapping board clocks
+
+measure and simulate fail (exit code 1) when the worst latency is above --limit (20 ms).
+"""
+
+import argparse
+import heapq
+import json
+import os
+import random
+import struct
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'MessageGen'))
+import messages  # noqa: E402
+
+# MessageTypes.h
+IMU2PMB_FRAME = struct.Struct(messages.IMU2PMB_FRAME_FORMAT)
+IMU2ESP_FRAME = struct.Struct(messages.IMU2ESP_FRAME_FORMAT)
+TRACE_OFFSET = 14                                   # index of LatencyTrace_t.traceId in IMU2ESP_FRAME
+ESP2IMU_FRAME_SIZE = messages.ESP2IMU_FRAME_SIZE
+BITS_PER_BYTE = 10                  # 8N1
+
+# ESP ImuCommunication.h
+CONTROL_MIN_INTERVAL = 8.0          # [ms]
+CONTROL_PERIOD = 100.0              # [ms] keep-alive
+# IMU IMU_func.c, main.c
+PMB_FRAME_MIN_INTERVAL = 5          # [ms]
+PMB_PERIOD = 100                    # [ms] IMU_SendDataToPMB
+PMB_PHASE = 41                      # [ms]
+JOYSTICK_SCALE = 5                  # Navigation.c manualNavigation()
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/MODBUS, same as Melkens_Lib CRC16"""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def wheel_speeds(x, y):
+    return (y - x) * JOYSTICK_SCALE, (y + x) * JOYSTICK_SCALE
+
+
+def report(latencies, limit):
+    latencies = sorted(latencies)
+    if not latencies:
+        print('no samples')
+        return 1
+    count = len(latencies)
+    print('samples %d, min %.1f ms, median %.1f ms, p95 %.1f ms, max %.1f ms' % (
+        count, latencies[0], latencies[count // 2], latencies[min(count - 1, int(count * 0.95))], latencies[-1]))
+    if latencies[-1] > limit:
+        print('FAIL: worst latency above %.0f ms' % limit)
+        return 1
+    print('PASS: worst latency below %.0f ms' % limit)
+    return 0
+
+
+class PmbSniffer(threading.Thread):
+    """Timestamps valid Imu2PmbFrame on IMU -> PMB line, resynchronises by CRC"""
+
+    def __init__(self, port):
+        threading.Thread.__init__(self, daemon=True)
+        self.port = port
+        self.frames = []
+        self.lock = threading.Lock()
+        self.running = True
+
+    def run(self):
+        buffer = b''
+        while self.running:
+            data = self.port.read(64)
+            now = time.perf_counter()
+            buffer += data
+            while len(buffer) >= IMU2PMB_FRAME.size:
+                frame = IMU2PMB_FRAME.unpack_from(buffer)
+                if frame[-1] == crc16(buffer[:IMU2PMB_FRAME.size - 2]):
+                    with self.lock:
+                        self.frames.append((now, frame[0], frame[1]))
+                    buffer = buffer[IMU2PMB_FRAME.size:]
+                else:
+                    buffer = buffer[1:]
+
+    def wait_for(self, right, left, since, timeout):
+        deadline = since + timeout
+        while time.perf_counter() < deadline:
+            with self.lock:
+                for stamp, frame_right, frame_left in self.frames:
+                    if stamp >= since and frame_right == right and frame_left == left:
+                        return stamp
+            time.sleep(0.0005)
+        return None
+
+
+def command_measure(args):
+    try:
+        import serial
+        import websocket
+    except ImportError as error:
+        print('error: %s, install pyserial and websocket-client' % error, file=sys.stderr)
+        return 1
+
+    port = serial.Serial(args.port, args.baud, timeout=0.001)
+    sniffer = PmbSniffer(port)
+    sniffer.start()
+    socket = websocket.create_connection(args.ws)
+    rng = random.Random(args.seed)
+    latencies = []
+    lost = 0
+    try:
+        for index in range(args.count):
+            x = args.x if index % 2 else -args.x
+            right, left = wheel_speeds(x, 0)
+            with sniffer.lock:
+                sniffer.frames = []
+            sent = time.perf_counter()
+            socket.send(json.dumps({'type': 'joystick', 'x': x, 'y': 0}))
+            received = sniffer.wait_for(right, left, sent, 0.5)
+            if received is None:
+                lost += 1
+            else:
+                latencies.append((received - sent) * 1000.0)
+            time.sleep(rng.uniform(0.05, 0.15))
+    finally:
+        socket.send(json.dumps({'type': 'joystick', 'x': 0, 'y': 0}))
+        socket.close()
+        sniffer.running = False
+    if lost:
+        print('%d commands did not reach PMB within 500 ms' % lost)
+    # WebSocket send and USB-UART receive add about 1-2 ms of host latency
+    return report(latencies, args.limit) or (1 if lost else 0)
+
+
+class Simulation:
+    """Event model: WebSocket -> ESP link task -> UART -> IMU main loop -> 1ms tasks -> PMB UART"""
+
+    def __init__(self, args):
+        self.args = args
+        self.random = random.Random(args.seed)
+        self.byte_time = BITS_PER_BYTE * 1000.0 / args.baud
+        self.events = []
+        self.order = 0
+
+    def push(self, time_ms, kind, data=None):
+        self.order += 1
+        heapq.heappush(self.events, (time_ms, self.order, kind, data))
+
+    def run(self):
+        args = self.args
+        legacy = args.legacy
+        # ESP
+        esp_command = 0             # latest command number set by WebSocket
+        esp_sent_command = 0
+        esp_last_control = -CONTROL_PERIOD
+        esp_pending = False
+        esp_line_free = 0.0
+        # IMU
+        imu_command = 0             # applied command
+        imu_speed_command = 0       # command used for current wheel speeds
+        imu_send_requested = False
+        imu_last_pmb = -1000
+        pmb_line_free = 0.0
+        command_time = {}
+        latencies = {}
+
+        time_ms = 0.0
+        for command in range(1, args.count + 1):
+            time_ms += self.random.uniform(args.ws_min, args.ws_max)
+            self.push(time_ms, 'ws', command)
+        end = time_ms + 300.0
+        self.push(self.random.uniform(0, 1), 'tick')
+        if legacy:
+            self.push(self.random.uniform(0, CONTROL_PERIOD), 'esp_loop100')
+        else:
+            self.push(self.random.uniform(0, 10.0), 'esp_period')     # link task IMU_LINK_PERIOD wake up
+
+        while self.events:
+            now, _, kind, data = heapq.heappop(self.events)
+            if now > end:
+                break
+
+            if kind == 'ws':
+                # AsyncTCP task -> SetControl -> link task wake up
+                command_time[data] = now
+                esp_command = data
+                if not legacy:
+                    self.push(now + args.esp_wake, 'esp_link')
+            elif kind in ('esp_link', 'esp_period'):
+                if esp_command != esp_sent_command:
+                    esp_pending = True
+                if kind == 'esp_period':
+                    self.push(now + 10.0, 'esp_period')
+                if (esp_pending and now >= esp_last_control + CONTROL_MIN_INTERVAL) or \
+                        now >= esp_last_control + CONTROL_PERIOD:
+                    esp_pending = False
+                    esp_last_control = now
+                    esp_sent_command = esp_command
+                    start = max(now, esp_line_free)
+                    esp_line_free = start + ESP2IMU_FRAME_SIZE * self.byte_time
+                    self.push(esp_line_free, 'imu_rx', esp_command)
+                elif esp_pending:
+                    self.push(esp_last_control + CONTROL_MIN_INTERVAL, 'esp_link')
+            elif kind == 'esp_loop100':
+                start = max(now, esp_line_free)
+                esp_line_free = start + ESP2IMU_FRAME_SIZE * self.byte_time
+                self.push(esp_line_free, 'imu_rx', esp_command)
+                self.push(now + CONTROL_PERIOD, 'esp_loop100')
+            elif kind == 'imu_rx':
+                # frame is taken by main loop connectivityHandlerPerform()
+                self.push(now + self.random.uniform(0, args.imu_loop), 'imu_apply', data)
+            elif kind == 'imu_apply':
+                if data > imu_command:
+                    imu_command = data
+                    if not legacy:
+                        imu_send_requested = True
+            elif kind == 'tick':
+                tick = int(round(now))
+                # RouteManager_Perform1ms: manualNavigation() takes latest command
+                imu_speed_command = imu_command
+                send = tick % PMB_PERIOD == PMB_PHASE
+                if imu_send_requested and tick - imu_last_pmb >= PMB_FRAME_MIN_INTERVAL:
+                    imu_send_requested = False
+                    send = True
+                if send:
+                    imu_last_pmb = tick
+                    start = max(now + args.task_delay, pmb_line_free)
+                    pmb_line_free = start + IMU2PMB_FRAME.size * self.byte_time
+                    for command in range(imu_speed_command, 0, -1):
+                        if command in latencies:
+                            break
+                        latencies[command] = pmb_line_free - command_time[command]
+                self.push(now + 1.0, 'tick')
+
+        return [latencies[command] for command in sorted(latencies) if command in command_time]
+
+
+def command_simulate(args):
+    latencies = Simulation(args).run()
+    print('%s path, %d joystick messages every %.0f..%.0f ms' % (
+        'legacy 100ms' if args.legacy else 'event driven', args.count, args.ws_min, args.ws_max))
+    return report(latencies, args.limit)
+
+
+def find_frames(data, frame):
+    """Yields (offset, fields) of CRC valid frames, skips bytes until the next valid one"""
+    offset = 0
+    while offset + frame.size <= len(data):
+        fields = frame.unpack_from(data, offset)
+        if fields[-1] == crc16(data[offset:offset + frame.size - 2]):
+            yield offset, fields
+            offset += frame.size
+        else:
+            offset += 1
+
+
+def trace_timeline(trace):
+    """Times of LatencyTrace_t on IMU clock [us] relative to command applied, PMB link assumed symmetric"""
+    _, imu_rx, imu_pmb_tx, pmb_rx, pmb_tx, imu_pmb_rx, imu_tx = trace
+    pmb = (pmb_tx - pmb_rx) & 0xFFFF
+    pmb_round_trip = (imu_pmb_rx - imu_pmb_tx) & 0xFFFF
+    sent = (imu_pmb_tx - imu_rx) & 0xFFFF
+    if pmb > pmb_round_trip:
+        return None
+    link = (pmb_round_trip - pmb) / 2.0
+    return [
+        ('applied', 0.0),
+        ('pmb frame sent', sent),
+        ('pmb received', sent + link),
+        ('pmb answered', sent + link + pmb),
+        ('pmb answer received', sent + pmb_round_trip),
+        ('esp frame sent', sent + pmb_round_trip + ((imu_tx - imu_pmb_rx) & 0xFFFF)),
+    ]
+
+
+def traces_from_capture(data):
+    """First Imu2EspFrame of each trace, the trace is repeated in later frames until the next command"""
+    traces = []
+    last = None
+    for _, fields in find_frames(data, IMU2ESP_FRAME):
+        trace = fields[TRACE_OFFSET:TRACE_OFFSET + 7]
+        if trace != last and any(trace):
+            traces.append(trace)
+        last = trace
+    return traces
+
+
+def print_timelines(traces):
+    segments = {'imu': [], 'pmb link': [], 'pmb': [], 'imu return': []}
+    invalid = 0
+    for trace in traces:
+        timeline = trace_timeline(trace)
+        if timeline is None:
+            invalid += 1
+            continue
+        times = dict(timeline)
+        segments['imu'].append(times['pmb frame sent'])
+        segments['pmb link'].append(times['pmb answer received'] - times['pmb frame sent']
+                                    - (times['pmb answered'] - times['pmb received']))
+        segments['pmb'].append(times['pmb answered'] - times['pmb received'])
+        segments['imu return'].append(times['esp frame sent'] - times['pmb answer received'])
+        print('trace %5d: %s' % (trace[0], ', '.join('%s %.2f' % (name, time / 1000.0) for name, time in timeline)))
+    print('%d traces, %d invalid, times in ms' % (len(traces), invalid))
+    for name, values in segments.items():
+        if values:
+            values = sorted(values)
+            print('%-10s min %.2f, median %.2f, max %.2f ms' % (
+                name, values[0] / 1000.0, values[len(values) // 2] / 1000.0, values[-1] / 1000.0))
+    return segments
+
+
+def build_imu2esp_frame(command_sequence, trace):
+    fields = [0, 1] + [0] * 8 + [0, 0, 0, command_sequence] + list(trace)
+    fields += [0] * (len(IMU2ESP_FRAME.format) - 1 - len(fields))     # SyncStamp_t, LinkControl_t, crc
+    data = IMU2ESP_FRAME.pack(*fields)[:-2]
+    return data + struct.pack('<H', crc16(data))
+
+
+def timeline_self_test(seed):
+    """Generated traces with known segment times on clocks starting at random 16 bit offsets"""
+    rng = random.Random(seed)
+    imu_clock = rng.randrange(0x10000)
+    pmb_clock = rng.randrange(0x10000)
+    capture = bytearray()
+    expected = []
+    for sequence in range(1, 201):
+        imu, link, pmb, imu_return = (rng.randrange(0, 6000), rng.randrange(1200, 4000),
+                                      rng.randrange(0, 1500), rng.randrange(0, 3000))
+        imu_clock = (imu_clock + rng.randrange(5000, 60000)) & 0xFFFF
+        pmb_clock = (pmb_clock + rng.randrange(5000, 60000)) & 0xFFFF
+        trace = (sequence,
+                 imu_clock,
+                 (imu_clock + imu) & 0xFFFF,
+                 pmb_clock,
+                 (pmb_clock + pmb) & 0xFFFF,
+                 (imu_clock + imu + 2 * link + pmb) & 0xFFFF,
+                 (imu_clock + imu + 2 * link + pmb + imu_return) & 0xFFFF)
+        expected.append((imu, 2 * link, pmb, imu_return))
+        # trace is repeated by following frames, noise between frames is skipped by CRC
+        for _ in range(rng.randrange(1, 4)):
+            capture += build_imu2esp_frame(sequence, trace)
+            capture += bytes(rng.randrange(256) for _ in range(rng.randrange(0, 3)))
+    segments = print_timelines(traces_from_capture(bytes(capture)))
+    result = list(zip(segments['imu'], segments['pmb link'], segments['pmb'], segments['imu return']))
+    if result != [tuple(float(value) for value in item) for item in expected]:
+        print('FAIL: reconstructed segments differ from generated ones')
+        return 1
+    print('PASS: %d timelines reconstructed' % len(result))
+    return 0
+
+
+def command_timeline(args):
+    if args.self_test:
+        return timeline_self_test(args.seed)
+    if not args.capture:
+        print('error: capture file or --self-test required', file=sys.stderr)
+        return 1
+    with open(args.capture, 'rb') as file:
+        print_timelines(traces_from_capture(file.read()))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Joystick WebSocket to Imu2PmbFrame latency test')
+    parser.add_argument('--limit', type=float, default=20.0, help='[ms] required worst latency')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--seed', type=int, default=1)
+    commands = parser.add_subparsers(dest='command')
+    commands.required = True
+
+    parser_measure = commands.add_parser('measure', help='measure on hardware')
+    parser_measure.add_argument('--ws', default='ws://192.168.4.1/ws', help='ESP WebSocket url')
+    parser_measure.add_argument('--port', required=True, help='serial port listening on IMU -> PMB line')
+    parser_measure.add_argument('--count', type=int, default=200)
+    parser_measure.add_argument('--x', type=int, default=20, help='joystick step, wheels are driven with 5x')
+    parser_measure.set_defaults(function=command_measure)
+
+    parser_simulate = commands.add_parser('simulate', help='timing model')
+    parser_simulate.add_argument('--count', type=int, default=2000)
+    parser_simulate.add_argument('--legacy', action='store_true', help='former 100ms forwarding')
+    parser_simulate.add_argument('--ws-min', type=float, default=5.0, help='[ms] shortest joystick message interval')
+    parser_simulate.add_argument('--ws-max', type=float, default=60.0, help='[ms] longest joystick message interval')
+    parser_simulate.add_argument('--esp-wake', type=float, default=0.3, help='[ms] WebSocket handler to link task')
+    parser_simulate.add_argument('--imu-loop', type=float, default=0.5, help='[ms] longest IMU main loop iteration')
+    parser_simulate.add_argument('--task-delay', type=float, default=0.1, help='[ms] 1ms tasks before PMB send')
+    parser_simulate.set_defaults(function=command_simulate)
+
+    parser_timeline = commands.add_parser('timeline', help='per command timelines from IMU -> ESP capture')
+    parser_timeline.add_argument('capture', nargs='?', help='raw bytes of IMU TX line')
+    parser_timeline.add_argument('--self-test', action='store_true', help='check on generated frames')
+    parser_timeline.set_defaults(function=command_timeline)
+
+    args = parser.parse_args()
+    return args.function(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+"""
+Host simulation of UART baud rate negotiation (Melkens_Lib/LinkSpeed).
+
+Builds Melkens_Lib/LinkSpeed/LinkSpeed.c with the host C compiler, loads it
+with ctypes and runs a master and a slave end over a model of one link:
+frames at the ESP <-> IMU or IMU <-> PMB rates and sizes, a bit error rate per
+baud rate (cable and receiver quality), frames sent while the two ends run
+different rates arriving as garbage or not at all, cable cuts, degradation
+during operation and lost SWITCH frames.
+
+Usage:
+  link_speed_sim.py [--scenario all] [--link esp|pmb] [--seed 1] [--cc cc]
+
+Every scenario states the rate the link must reach within a time limit after
+its last disturbance and then stay at for MIN_SHARE of the remaining time
+(failed rates are probed again after dLINK_SPEED_RETRY). The simulation also
+reports line capacity (baud / 10, 0 while the ends disagree on the rate),
+valid and broken frames, rate changes and fallbacks. Exit code 1 when any
+scenario fails.
+"""
+
+import argparse
+import ctypes
+import heapq
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+LIB_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Melkens_Lib')
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'MessageGen'))
+import messages  # noqa: E402
+
+BAUDS = [115200, 460800, 921600, 2000000]   # LinkSpeed.c, index is dLINK_RATE_...
+BITS_PER_BYTE = 10                          # 8N1
+PERFORM_PERIOD = 10.0                       # [ms] LinkSpeed_Perform without traffic
+SWITCH_INTERVAL = 8.0                       # [ms] master frame after a SWITCH frame
+MAX_ERRORS = 20                             # [per mille] dLINK_SPEED_MAX_ERRORS
+MIN_SHARE = 0.9                             # of time at expected rate once reached
+
+# master frame, slave frame, master period [ms], slave answers each master frame
+LINKS = {
+    'esp': (messages.ESP2IMU_FRAME_SIZE, messages.IMU2ESP_FRAME_SIZE, 100.0, False),
+    'pmb': (messages.IMU2PMB_FRAME_SIZE, messages.PMB2IMU_FRAME_SIZE, 100.0, True),
+}
+
+# name: (bit error rate per rate, slave max rate, events, expected final rate, limit [s] to reach it)
+# events: (time [s], kind, value) with kinds 'ber' (new error rates), 'cut' (duration [s]), 'switch_loss'
+SCENARIOS = {
+    'clean': ([0, 0, 0, 1e-8], 3, [], 3, 30),
+    'long_cable': ([0, 1e-8, 2e-6, 1e-4], 3, [], 2, 40),
+    'noisy_921600': ([0, 1e-7, 1e-4, 1e-3], 3, [], 1, 40),
+    'slave_921600': ([0, 0, 0, 0], 2, [], 2, 30),
+    'degrade': ([0, 0, 1e-7, 1e-7], 3, [(60, 'ber', [0, 1e-7, 1e-4, 1e-3])], 1, 90),
+    'cable_cut': ([0, 0, 0, 0], 3, [(60, 'cut', 5.0)], 3, 120),
+    'lost_switch': ([0, 0, 0, 0], 3, [(0, 'switch_loss', 0.4)], 3, 120),
+}
+
+
+class LinkControl(ctypes.Structure):
+    _pack_ = 1
+    _fields_ = [('command', ctypes.c_uint8), ('rate', ctypes.c_uint8), ('sequence', ctypes.c_uint8),
+                ('errors', ctypes.c_uint8)]
+
+
+def build_library(cc, directory):
+    source = os.path.join(LIB_DIR, 'LinkSpeed', 'LinkSpeed.c')
+    output = os.path.join(directory, 'linkspeed.so')
+    subprocess.check_call([cc, '-std=c99', '-O2', '-Wall', '-Wextra', '-shared', '-fPIC', '-o', output, source])
+    library = ctypes.CDLL(output)
+    library.LinkSpeed_Init.argtypes = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_uint8, ctypes.c_uint32]
+    library.LinkSpeed_Stamp.argtypes = [ctypes.c_void_p, ctypes.POINTER(LinkControl), ctypes.c_uint32]
+    library.LinkSpeed_Stamp.restype = ctypes.c_bool
+    library.LinkSpeed_Receive.argtypes = [ctypes.c_void_p, ctypes.POINTER(LinkControl), ctypes.c_uint32]
+    library.LinkSpeed_Error.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    library.LinkSpeed_Error.restype = ctypes.c_bool
+    library.LinkSpeed_Perform.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    library.LinkSpeed_Perform.restype = ctypes.c_bool
+    library.LinkSpeed_GetBaud.argtypes = [ctypes.c_void_p]
+    library.LinkSpeed_GetBaud.restype = ctypes.c_uint32
+    return library
+
+
+def frame_time(size, baud):
+    """[ms]"""
+    return size * BITS_PER_BYTE * 1000.0 / baud
+
+
+def frame_error_rate(ber, size):
+    return 1.0 - (1.0 - ber) ** (size * BITS_PER_BYTE)
+
+
+class End:
+    def __init__(self, library, name, is_master, max_rate, frame_size):
+        self.library = library
+        self.name = name
+        self.state = ctypes.create_string_buffer(256)
+        library.LinkSpeed_Init(self.state, is_master, max_rate, 0)
+        self.baud = BAUDS[0]
+        self.frame_size = frame_size
+        self.line_free = 0.0
+        self.valid = 0          # valid frames received
+        self.errors = 0         # frames received with CRC error
+        self.unexpected = 0     # of them not right after a rate change (PMB stops the motors)
+
+    def perform(self, now):
+        if self.library.LinkSpeed_Perform(self.state, int(now) & 0xFFFFFFFF):
+            self.baud = self.library.LinkSpeed_GetBaud(self.state)
+            return True
+        return False
+
+
+class Simulation:
+    def __init__(self, library, args, scenario):
+        self.library = library
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.ber, slave_max, self.script, self.expected, self.limit = SCENARIOS[scenario]
+        self.ber = list(self.ber)
+        master_size, slave_size, self.period, self.answers = LINKS[args.link]
+        self.master = End(library, 'master', True, 3, master_size)
+        self.slave = End(library, 'slave', False, slave_max, slave_size)
+        self.events = []
+        self.order = 0
+        self.cut_until = -1.0
+        self.switch_loss = 0.0
+        self.history = [(0.0, BAUDS[0], BAUDS[0])]  # (time [ms], master baud, slave baud)
+
+    def push(self, time, kind, data=None):
+        self.order += 1
+        heapq.heappush(self.events, (time, self.order, kind, data))
+
+    def send(self, sender, receiver, now):
+        """Returns True when the next frame should follow at once"""
+        control = LinkControl()
+        hurry = self.library.LinkSpeed_Stamp(sender.state, ctypes.byref(control), int(now) & 0xFFFFFFFF)
+        start = max(now, sender.line_free)
+        sender.line_free = start + frame_time(sender.frame_size, sender.baud)
+        self.push(sender.line_free + self.rng.uniform(0, 2.0), 'rx', (sender, receiver, sender.baud, control))
+        # firmware calls LinkSpeed_Perform right after queueing the frame, the UART
+        # is reconfigured once it is out: frame keeps its baud, next one waits
+        self.reconfigure(sender, now)
+        return hurry
+
+    def reconfigure(self, end, now):
+        if end.perform(now):
+            self.history.append((now, self.master.baud, self.slave.baud))
+
+    def error(self, receiver, now):
+        receiver.errors += 1
+        if self.library.LinkSpeed_Error(receiver.state, int(now)):
+            receiver.unexpected += 1
+
+    def deliver(self, sender, receiver, baud, control, now):
+        if now < self.cut_until:
+            return
+        if control.command == messages.LINK_COMMAND_SWITCH and self.rng.random() < self.switch_loss:
+            return
+        if baud != receiver.baud:
+            # wrong rate: some garbage looks like a frame start and fails CRC, most is lost
+            if self.rng.random() < 0.3:
+                self.error(receiver, now)
+            return
+        if self.rng.random() < frame_error_rate(self.ber[BAUDS.index(baud)], sender.frame_size):
+            self.error(receiver, now)
+        else:
+            receiver.valid += 1
+            self.library.LinkSpeed_Receive(receiver.state, ctypes.byref(control), int(now))
+        self.reconfigure(receiver, now)
+        if receiver is self.slave and self.answers:
+            self.push(now + self.rng.uniform(0, 1.0), 'slave_tx')
+
+    def run(self):
+        end = self.args.seconds * 1000.0
+        self.push(self.rng.uniform(0, self.period), 'master_tx')
+        if not self.answers:
+            self.push(self.rng.uniform(0, self.period), 'slave_tx', True)
+        self.push(0.0, 'perform')
+        for time, kind, value in self.script:
+            self.push(time * 1000.0, kind, value)
+        capacity = 0.0
+        last = 0.0
+        reached = None      # first time at expected rate after last scripted event
+        at_rate = 0.0       # [ms] at expected rate since reached
+        events_end = max([time for time, _, _ in self.script] + [0]) * 1000.0
+
+        while self.events:
+            now, _, kind, data = heapq.heappop(self.events)
+            if now > end:
+                break
+            at_expected = self.master.baud == self.slave.baud == BAUDS[self.expected]
+            if self.master.baud == self.slave.baud and now >= self.cut_until:
+                capacity += (now - last) * self.master.baud / BITS_PER_BYTE / 1000.0
+            if reached is not None and at_expected:
+                at_rate += now - last
+            last = now
+
+            if kind == 'master_tx':
+                hurry = self.send(self.master, self.slave, now)
+                self.push(now + (SWITCH_INTERVAL if hurry else self.period), 'master_tx')
+            elif kind == 'slave_tx':
+                self.send(self.slave, self.master, now)
+                if data:
+                    self.push(now + self.period * self.rng.uniform(0.8, 1.2), 'slave_tx', True)
+            elif kind == 'rx':
+                self.deliver(*data, now=now)
+            elif kind == 'perform':
+                self.reconfigure(self.master, now)
+                self.reconfigure(self.slave, now)
+                self.push(now + PERFORM_PERIOD, 'perform')
+            elif kind == 'ber':
+                self.ber = list(data)
+            elif kind == 'cut':
+                self.cut_until = now + data * 1000.0
+            elif kind == 'switch_loss':
+                self.switch_loss = data
+
+            if reached is None and now >= events_end and self.master.baud == self.slave.baud == BAUDS[self.expected]:
+                reached = now
+        share = at_rate / (end - reached) if reached is not None and reached < end else 0.0
+        return capacity * 1000.0 / end, reached, share
+
+    def report(self, name):
+        average, reached, share = self.run()
+        events_end = max([time for time, _, _ in self.script] + [0])
+        frames = self.master.valid + self.slave.valid
+        errors = self.master.errors + self.slave.errors
+        fallbacks = sum(1 for (_, before, _), (_, after, _) in zip(self.history, self.history[1:]) if after < before)
+        # on a clean line every CRC error at the slave comes from a rate change
+        # and must be reported as expected, PMB stops the motors on the others
+        clean = not any(self.ber) and not self.script
+        ok = reached is not None and reached <= (events_end + self.limit) * 1000.0 and share >= MIN_SHARE and \
+            not (clean and self.slave.unexpected)
+        print('%-13s %7d reached %7s, then %3.0f %% at it, %2d rate changes, %2d fallbacks, '
+              'frames %5d valid %4d errors (%3d at slave unexpected), capacity %6.1f kB/s -> %s' % (
+                  name, BAUDS[self.expected],
+                  ('%.1f s' % (reached / 1000.0)) if reached is not None else 'never', share * 100.0,
+                  len(self.history) - 1, fallbacks, frames, errors, self.slave.unexpected, average / 1000.0,
+                  'PASS' if ok else 'FAIL'))
+        if self.args.verbose or not ok:
+            for time, master_baud, slave_baud in self.history[1:]:
+                print('    %8.2f s  master %7d  slave %7d' % (time / 1000.0, master_baud, slave_baud))
+        return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description='LinkSpeed host simulation')
+    parser.add_argument('--scenario', default='all', choices=['all'] + sorted(SCENARIOS))
+    parser.add_argument('--link', default='esp', choices=sorted(LINKS))
+    parser.add_argument('--seconds', type=float, default=600.0, help='simulated time per scenario [s]')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--verbose', action='store_true', help='print rate changes')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    args = parser.parse_args()
+
+    names = sorted(SCENARIOS) if args.scenario == 'all' else [args.scenario]
+    with tempfile.TemporaryDirectory() as directory:
+        library = build_library(args.cc, directory)
+        print('%s link, frame error rate limit %d per mille' % (args.link, MAX_ERRORS))
+        results = [Simulation(library, args, name).report(name) for name in names]
+    print('PASS' if all(results) else 'FAIL')
+    return 0 if all(results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
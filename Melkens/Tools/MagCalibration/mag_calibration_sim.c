@@ -0,0 +1,161 @@
+/*
+ * Host driver of mag_calibration_sim.py, built together with
+ * Melkens_IMU/Core/Src/MagCalibration.c.
+ *
+ * Arguments: <param>=<value> overriding MagCalibration_Defaults.
+ *
+ * Reads trace lines from stdin:
+ *   axis <axis>                                 MagCalibration_SetVerticalAxis
+ *   stored <axis> <cu> <cv> <m00> <m01> <m11> <radius>
+ *                                               restart with a stored calibration
+ *   sample <ms> <mx> <my> <mz> <gx> <gy> <gz>   field [mG], gyro [rad/s]
+ * Prints:
+ *   params <name>=<value> ...
+ *   fit <ms> <cu> <cv> <m00> <m01> <m11> <radius>   calibration taken
+ *   out <ms> <fused> <disturbed> <heading>      on every sample, heading of the
+ *                                               calibrated field when fused
+ *   result <fits> <coverage>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include "MagCalibration.h"
+
+typedef struct {
+    const char *name;
+    size_t offset;
+    char type;          /* f float, w uint32_t, h uint16_t, b uint8_t */
+} Param;
+
+static const Param Params[] = {
+    {"MinSamples", offsetof(MagCalibrationParams, MinSamples), 'h'},
+    {"MinSectors", offsetof(MagCalibrationParams, MinSectors), 'b'},
+    {"MaxAxisRatio", offsetof(MagCalibrationParams, MaxAxisRatio), 'f'},
+    {"MaxResidual", offsetof(MagCalibrationParams, MaxResidual), 'f'},
+    {"MinRadius", offsetof(MagCalibrationParams, MinRadius), 'f'},
+    {"MaxRadius", offsetof(MagCalibrationParams, MaxRadius), 'f'},
+    {"DisturbanceRatio", offsetof(MagCalibrationParams, DisturbanceRatio), 'f'},
+    {"HeadingLimit", offsetof(MagCalibrationParams, HeadingLimit), 'f'},
+    {"ClearTime", offsetof(MagCalibrationParams, ClearTime), 'h'},
+    {"InvalidTime", offsetof(MagCalibrationParams, InvalidTime), 'w'},
+    {"FitWeight", offsetof(MagCalibrationParams, FitWeight), 'f'},
+};
+#define PARAMS_NUM_OF (sizeof(Params) / sizeof(Params[0]))
+
+static double GetParam(const MagCalibrationParams *params, size_t index)
+{
+    const uint8_t *field = (const uint8_t *)params + Params[index].offset;
+
+    switch (Params[index].type) {
+    case 'w':
+        return *(const uint32_t *)field;
+    case 'h':
+        return *(const uint16_t *)field;
+    case 'b':
+        return *field;
+    default:
+        return *(const float *)field;
+    }
+}
+
+static void SetParam(MagCalibrationParams *params, size_t index, double value)
+{
+    uint8_t *field = (uint8_t *)params + Params[index].offset;
+
+    switch (Params[index].type) {
+    case 'w':
+        *(uint32_t *)field = (uint32_t)value;
+        break;
+    case 'h':
+        *(uint16_t *)field = (uint16_t)value;
+        break;
+    case 'b':
+        *field = (uint8_t)value;
+        break;
+    default:
+        *(float *)field = (float)value;
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    MagCalibrationParams params = MagCalibration_Defaults;
+    MagCalibrationData data;
+    char line[256], kind[16];
+    unsigned long time;
+    double v[7];
+    float field[3], gyro[3];
+    uint8_t axis = 0;
+    size_t i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        char *value = strchr(argv[arg], '=');
+
+        if (value == NULL) {
+            fprintf(stderr, "bad argument %s\n", argv[arg]);
+            return 2;
+        }
+        *value++ = '\0';
+        for (i = 0; i < PARAMS_NUM_OF && strcmp(argv[arg], Params[i].name) != 0; i++) {
+        }
+        if (i == PARAMS_NUM_OF) {
+            fprintf(stderr, "unknown parameter %s\n", argv[arg]);
+            return 2;
+        }
+        SetParam(&params, i, strtod(value, NULL));
+    }
+
+    printf("params");
+    for (i = 0; i < PARAMS_NUM_OF; i++) {
+        printf(" %s=%g", Params[i].name, GetParam(&params, i));
+    }
+    printf("\n");
+
+    MagCalibration_Init(&params, NULL);
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        if (sscanf(line, "%15s", kind) != 1) {
+            continue;
+        }
+        if (strcmp(kind, "axis") == 0 && sscanf(line, "%*s %lf", &v[0]) == 1) {
+            axis = (uint8_t)v[0];
+            MagCalibration_SetVerticalAxis(axis);
+        } else if (strcmp(kind, "stored") == 0 &&
+                   sscanf(line, "%*s %lf %lf %lf %lf %lf %lf %lf", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6]) == 7) {
+            memset(&data, 0, sizeof(data));
+            data.VerticalAxis = (uint8_t)v[0];
+            data.Center[0] = (float)v[1];
+            data.Center[1] = (float)v[2];
+            data.Matrix[0][0] = (float)v[3];
+            data.Matrix[0][1] = (float)v[4];
+            data.Matrix[1][0] = (float)v[4];
+            data.Matrix[1][1] = (float)v[5];
+            data.Radius = (float)v[6];
+            axis = data.VerticalAxis;
+            MagCalibration_Init(&params, &data);
+        } else if (strcmp(kind, "sample") == 0 &&
+                   sscanf(line, "%*s %lu %lf %lf %lf %lf %lf %lf", &time, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) == 7) {
+            for (i = 0; i < 3; i++) {
+                field[i] = (float)v[i];
+                gyro[i] = (float)v[3 + i];
+            }
+            MagCalibration_AddSample(field, gyro, (uint32_t)time);
+            if (MagCalibration_TakeNew(&data)) {
+                printf("fit %lu %.2f %.2f %.4f %.4f %.4f %.2f\n", time, data.Center[0], data.Center[1],
+                       data.Matrix[0][0], data.Matrix[0][1], data.Matrix[1][1], data.Radius);
+            }
+            if (MagCalibration_GetField(field)) {
+                printf("out %lu 1 %d %.4f\n", time, MagCalibration_IsDisturbed(),
+                       atan2(field[(axis + 2) % 3], field[(axis + 1) % 3]));
+            } else {
+                printf("out %lu 0 %d 0\n", time, MagCalibration_IsDisturbed());
+            }
+        }
+    }
+    printf("result %u %u\n", MagCalibration_GetFitCount(), MagCalibration_GetCoverage());
+    return 0;
+}
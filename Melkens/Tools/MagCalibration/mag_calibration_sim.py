@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+"""
+Host validation of the IMU magnetometer calibration (MagCalibration).
+
+Builds mag_calibration_sim.c with Melkens_IMU/Core/Src/MagCalibration.c and
+feeds it the LIS3MDL samples Magnetometer.c hands over every 25 ms: the
+earth field turned by the robot heading, bent by soft iron, shifted by hard
+iron, with sensor noise and the gyro rate about the vertical axis.
+
+  alley     back and forth in a feeding alley with 180 deg turns, no stored
+            calibration, steel next to the alley three times
+  stored    the same alley, correct calibration loaded from flash
+  moved     the same alley, stored calibration 100 mG off (payload changed),
+            dropped after InvalidTime and fitted again
+  upright   sensor mounted with Z vertical, turns on the spot
+
+A scenario passes when a calibration is fitted (alley, upright, moved)
+within the first minute (moved: two minutes), the heading of the calibrated field follows the robot heading
+within --heading deg RMS (constant offset removed) while the raw field is
+off by at least five times that, fusion is off near steel and on in clean
+sections (at most 2 % of them disturbed) and two runs give the same output.
+Exit code 1 when any check fails.
+
+Calibration parameters are changed with --param Name=value
+(MagCalibrationParams field names), the defaults are MagCalibration_Defaults.
+
+Usage:
+  mag_calibration_sim.py [--scenario all] [--seed 1] [--heading 2] [--param HeadingLimit=0.2]
+  mag_calibration_sim.py --trace alley > trace.txt
+"""
+
+import argparse
+import math
+import os
+import random
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+IMU_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_IMU', 'Core')
+
+PERIOD = 25                     # [ms] dMAGNETOMETER_PERIOD
+EARTH = (200.0, 450.0)          # [mG] horizontal and vertical earth field
+NOISE = 4.0                     # [mG] LIS3MDL at 4 gauss, RMS
+GYRO_NOISE = 0.002              # [rad/s]
+GYRO_BIAS = 0.001               # [rad/s]
+HARD_IRON = (120.0, -90.0, 300.0)           # [mG] sensor axes
+SOFT_IRON = ((1.10, 0.12, 0.05),
+             (0.12, 0.88, 0.08),
+             (0.05, 0.08, 1.00))
+STEEL_FIELD = 150.0             # [mG] peak, field of steel next to the alley
+STEEL_ANGLE = math.radians(60)  # world direction of the steel field
+FIT_LIMIT = 60000               # [ms]
+CLEAN_FIELD = 5.0               # [mG] steel field below is a clean section
+STRONG_FIELD = 60.0             # [mG] steel field above has to be detected
+CLEAR_MARGIN = 3000             # [ms] after steel, ClearTime and a margin
+
+
+def wrap(angle):
+    return (angle + math.pi) % (2.0 * math.pi) - math.pi
+
+
+class Scenario:
+    """Heading profile of straight runs and turns, steel windows [s]"""
+
+    def __init__(self, axis, straight, turn, duration, steel=(), stored=None, fit=FIT_LIMIT):
+        self.axis = axis
+        self.straight = straight    # [s] between turns
+        self.turn = turn            # [rad] each turn, at 45 deg/s
+        self.duration = duration    # [s]
+        self.steel = steel
+        self.stored = stored
+        self.fit = fit
+
+    def heading(self, time):
+        """Robot heading [rad] and rate [rad/s] at time [s]"""
+        rate = math.radians(45.0)
+        turn_time = abs(self.turn) / rate
+        cycle = self.straight + turn_time
+        count, phase = divmod(time, cycle)
+        start = count * self.turn
+        if phase < self.straight:
+            return start, 0.0
+        return start + math.copysign(rate, self.turn) * (phase - self.straight), math.copysign(rate, self.turn)
+
+    def steel_field(self, time):
+        field = 0.0
+        for start, end in self.steel:
+            if start <= time <= end:
+                field = max(field, STEEL_FIELD * math.sin(math.pi * (time - start) / (end - start)) ** 2)
+        return field
+
+    def sensor(self, body):
+        """Body x forward, y left, z up to sensor axes, vertical axis is up"""
+        sensor = [0.0, 0.0, 0.0]
+        sensor[(self.axis + 1) % 3] = body[0]
+        sensor[(self.axis + 2) % 3] = body[1]
+        sensor[self.axis] = body[2]
+        return sensor
+
+    def calibration(self):
+        """Exact calibration of the horizontal axes, as stored in flash"""
+        u, v, k = (self.axis + 1) % 3, (self.axis + 2) % 3, self.axis
+        # Vertical field through soft iron is a constant offset while level
+        center = [HARD_IRON[u] - SOFT_IRON[u][k] * EARTH[1], HARD_IRON[v] - SOFT_IRON[v][k] * EARTH[1]]
+        a, b, c = SOFT_IRON[u][u], SOFT_IRON[u][v], SOFT_IRON[v][v]
+        # Inverse of the horizontal soft iron, scaled to keep the field size
+        det = a * c - b * b
+        scale = math.sqrt(det)
+        return center, (c / det * scale, -b / det * scale, a / det * scale), EARTH[0] * scale
+
+    def trace(self, seed):
+        rng = random.Random(seed)
+        lines = []
+        truth = []
+        if self.stored is not None:
+            center, matrix, radius = self.calibration()
+            center = [center[0] + self.stored, center[1]]
+            lines.append('stored %d %.2f %.2f %.5f %.5f %.5f %.2f' % ((self.axis,) + tuple(center) + matrix + (radius,)))
+        lines.append('axis %d' % self.axis)
+        for time in range(0, int(self.duration * 1000), PERIOD):
+            heading, rate = self.heading(time / 1000.0)
+            steel = self.steel_field(time / 1000.0)
+            world = (EARTH[0] + steel * math.cos(STEEL_ANGLE), steel * math.sin(STEEL_ANGLE))
+            body = (world[0] * math.cos(heading) + world[1] * math.sin(heading),
+                    -world[0] * math.sin(heading) + world[1] * math.cos(heading), -EARTH[1])
+            true_field = self.sensor(body)
+            field = [sum(SOFT_IRON[i][j] * true_field[j] for j in range(3)) + HARD_IRON[i] + rng.gauss(0.0, NOISE)
+                     for i in range(3)]
+            gyro = self.sensor((rng.gauss(0.0, GYRO_NOISE), rng.gauss(0.0, GYRO_NOISE),
+                                rate + GYRO_BIAS + rng.gauss(0.0, GYRO_NOISE)))
+            lines.append('sample %d %.1f %.1f %.1f %.5f %.5f %.5f' % ((time,) + tuple(field) + tuple(gyro)))
+            truth.append((time, heading, steel, field))
+        return lines, truth
+
+
+def make_scenarios():
+    steel = ((70.0, 76.0), (140.0, 144.0), (200.0, 210.0))
+    return {
+        'alley': Scenario(0, 10.0, math.pi, 240.0, steel=steel),
+        'stored': Scenario(0, 10.0, math.pi, 240.0, steel=steel, stored=0.0, fit=None),
+        'moved': Scenario(0, 10.0, math.pi, 240.0, steel=steel, stored=100.0, fit=2 * FIT_LIMIT),
+        'upright': Scenario(2, 3.0, math.radians(90), 120.0),
+    }
+
+
+def build(args, directory):
+    output = os.path.join(directory, 'mag_calibration_sim')
+    subprocess.check_call([args.cc, '-std=c99'] + shlex.split(args.cflags) + [
+        '-I' + os.path.join(IMU_DIR, 'Inc'), '-o', output,
+        os.path.join(TOOL_DIR, 'mag_calibration_sim.c'),
+        os.path.join(IMU_DIR, 'Src', 'MagCalibration.c'), '-lm'])
+    return output
+
+
+def run(driver, lines, params):
+    result = subprocess.run([driver] + params, input='\n'.join(lines) + '\n',
+                            stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    output = {'header': '', 'fits': [], 'samples': [], 'text': result.stdout}
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if fields[0] == 'params':
+            output['header'] = ' '.join(fields[1:])
+        elif fields[0] == 'fit':
+            output['fits'].append((int(fields[1]),) + tuple(float(field) for field in fields[2:]))
+        elif fields[0] == 'out':
+            output['samples'].append((int(fields[1]), fields[2] == '1', fields[3] == '1', float(fields[4])))
+        elif fields[0] == 'result':
+            output['result'] = (int(fields[1]), int(fields[2]))
+    return output
+
+
+def heading_rms(errors):
+    """RMS of the errors around their circular mean, deg"""
+    if not errors:
+        return float('inf')
+    offset = math.atan2(sum(math.sin(e) for e in errors), sum(math.cos(e) for e in errors))
+    return math.degrees(math.sqrt(sum(wrap(e - offset) ** 2 for e in errors) / len(errors)))
+
+
+def check(scenario, output, truth, heading_limit):
+    problems = []
+    fit_time = output['fits'][0][0] if output['fits'] else None
+    if scenario.fit and (fit_time is None or fit_time > scenario.fit):
+        problems.append('not calibrated')
+
+    last_steel = -CLEAR_MARGIN
+    clean = disturbed_clean = strong = fused_strong = 0
+    calibrated, raw = [], []
+    # Without a calibration there is nothing to detect, fusion is off anyway
+    steel_hit = {window: False for window in scenario.steel
+                 if not scenario.fit or (fit_time is not None and window[0] * 1000 >= fit_time)}
+    axis = scenario.axis
+    for (time, fused, disturbed, heading), (_, true_heading, steel, field) in zip(output['samples'], truth):
+        if steel > CLEAN_FIELD:
+            last_steel = time
+        is_clean = steel <= CLEAN_FIELD and time - last_steel > CLEAR_MARGIN
+        if is_clean and (fit_time is not None or not scenario.fit) and time >= (fit_time or 0):
+            clean += 1
+            disturbed_clean += disturbed
+            if fused:
+                calibrated.append(heading + true_heading)
+                raw.append(math.atan2(field[(axis + 2) % 3], field[(axis + 1) % 3]) + true_heading)
+        if steel > STRONG_FIELD:
+            strong += 1
+            fused_strong += fused
+            for window in steel_hit:
+                if window[0] * 1000 <= time <= window[1] * 1000 and disturbed:
+                    steel_hit[window] = True
+
+    heading_error = heading_rms(calibrated)
+    raw_error = heading_rms(raw)
+    if heading_error > heading_limit:
+        problems.append('heading error')
+    if raw_error < 5.0 * heading_error:
+        problems.append('raw field not worse')
+    if not all(steel_hit.values()) or (strong and fused_strong > 0.1 * strong):
+        problems.append('steel not detected')
+    if clean and disturbed_clean > 0.02 * clean:
+        problems.append('disturbed in clean sections')
+    return problems, {
+        'fit': fit_time, 'fits': len(output['fits']), 'heading': heading_error, 'raw': raw_error,
+        'clean': clean, 'disturbed_clean': disturbed_clean, 'strong': strong, 'fused_strong': fused_strong,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--scenario', default='all', choices=['all'] + sorted(make_scenarios()))
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--heading', type=float, default=2.0, help='calibrated heading error limit [deg RMS]')
+    parser.add_argument('--param', action='append', default=[], help='MagCalibrationParams field=value')
+    parser.add_argument('--trace', metavar='SCENARIO', help='print the input trace of a scenario instead')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-Wall -Wextra -O2')
+    args = parser.parse_args()
+
+    scenarios = make_scenarios()
+    if args.trace:
+        print('\n'.join(scenarios[args.trace].trace(args.seed)[0]))
+        return 0
+
+    names = sorted(scenarios) if args.scenario == 'all' else [args.scenario]
+    failed = False
+    with tempfile.TemporaryDirectory() as directory:
+        driver = build(args, directory)
+        for index, name in enumerate(names):
+            scenario = scenarios[name]
+            lines, truth = scenario.trace(args.seed + index)
+            output = run(driver, lines, args.param)
+            again = run(driver, lines, args.param)
+            if index == 0:
+                print(output['header'])
+
+            problems, stats = check(scenario, output, truth, args.heading)
+            if output['text'] != again['text']:
+                problems.append('not deterministic')
+            failed |= bool(problems)
+
+            print('%-8s %s%s' % (name, 'FAIL' if problems else 'ok', ('  ' + ', '.join(problems)) if problems else ''))
+            print('  fits %d, first at %s' % (stats['fits'], ('%.1f s' % (stats['fit'] / 1000.0))
+                                                if stats['fit'] is not None else 'none'))
+            print('  heading error %.2f deg RMS calibrated, %.1f deg raw' % (stats['heading'], stats['raw']))
+            print('  clean samples %d disturbed %d, near steel %d fused %d'
+                  % (stats['clean'], stats['disturbed_clean'], stats['strong'], stats['fused_strong']))
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,753 @@
+#!/usr/bin/env python3
+"""
+Generates inter-board message code from Melkens_Lib/Types/MessageSchema.json.
+
+Outputs:
+  Melkens_Lib/Types/MessageTypes.h   packed frame structs, defines, protocol
+                                     version, layout hash, feature bits and
+                                     compile time size/offset assertions
+  Melkens_Lib/Types/MessageCodec.h   explicit little endian pack/unpack,
+  Melkens_Lib/Types/MessageCodec.c   zero-copy views on byte buffers,
+                                     CRC seal/check and protocol hello
+  Tools/MessageGen/messages.py       struct formats and sizes for host tools
+
+Usage:
+  message_gen.py generate     write all outputs
+  message_gen.py check        fail when outputs are not up to date
+  message_gen.py self-test    build generated C code on host and check it byte
+                              for byte against Python packing of the schema
+                              [--cc cc] [--cxx c++] [--iterations 200]
+
+dPROTOCOL_LAYOUT_HASH is CRC-16/MODBUS of the canonical layout (every field
+with type, offset and size), it changes whenever any frame byte moves.
+"""
+
+import argparse
+import json
+import os
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+TYPES_DIR = os.path.normpath(os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib', 'Types'))
+CRC_DIR = os.path.normpath(os.path.join(TYPES_DIR, '..', 'CRC16'))
+SCHEMA = os.path.join(TYPES_DIR, 'MessageSchema.json')
+OUTPUTS = {
+    'types': os.path.join(TYPES_DIR, 'MessageTypes.h'),
+    'codec_h': os.path.join(TYPES_DIR, 'MessageCodec.h'),
+    'codec_c': os.path.join(TYPES_DIR, 'MessageCodec.c'),
+    'python': os.path.join(TOOL_DIR, 'messages.py'),
+}
+
+BANNER = 'Generated by Tools/MessageGen/message_gen.py from MessageSchema.json, do not edit.'
+
+# type: (size, struct format, signed)
+SCALARS = {
+    'uint8_t': (1, 'B', False),
+    'int8_t': (1, 'b', True),
+    'uint16_t': (2, 'H', False),
+    'int16_t': (2, 'h', True),
+    'uint32_t': (4, 'I', False),
+    'int32_t': (4, 'i', True),
+}
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def base_name(type_name):
+    return type_name[:-2] if type_name.endswith('_t') else type_name
+
+
+def upper_name(name):
+    """Imu2PmbFrame_t -> IMU2PMB_FRAME, motorRightSpeed -> MOTOR_RIGHT_SPEED"""
+    name = base_name(name)
+    out = ''
+    for index, char in enumerate(name):
+        following = name[index + 1] if index + 1 < len(name) else ''
+        if char.isupper() and index and (name[index - 1].islower() or
+                                         (name[index - 1].isupper() and following.islower())):
+            out += '_'
+        out += char.upper()
+    return out
+
+
+class Schema:
+    def __init__(self, path):
+        with open(path) as file:
+            self.data = json.load(file)
+        self.defines = {}
+        for group in self.data['defines']:
+            for item in group['items']:
+                self.defines[item['name']] = item['value']
+        self.types = {entry['name']: entry for entry in self.data['types']}
+        self.order = [entry['name'] for entry in self.data['types']]
+        self.sizes = {}
+        for name in self.order:
+            self.sizes[name] = self.fields_size(self.types[name]['fields'])
+
+    def count(self, field):
+        count = field.get('count', 1)
+        if isinstance(count, str):
+            count = int(self.defines[count], 0)
+        return count
+
+    def field_size(self, field):
+        if 'union' in field:
+            return max(self.variant_size(variant) for variant in field['variants'])
+        element = SCALARS[field['type']][0] if field['type'] in SCALARS else self.sizes[field['type']]
+        return element * self.count(field)
+
+    def variant_size(self, variant):
+        return self.fields_size(variant['fields']) if 'fields' in variant else self.field_size(variant['field'])
+
+    def fields_size(self, fields):
+        return sum(self.field_size(field) for field in fields)
+
+    def layout(self, type_name, prefix='', offset=0):
+        """Flattened (path, c_member, type, offset, size, count) of scalar and array fields"""
+        items = []
+        for field in self.types[type_name]['fields']:
+            items += self.field_layout(field, prefix, offset)
+            offset += self.field_size(field)
+        return items
+
+    def field_layout(self, field, prefix, offset):
+        if 'union' in field:
+            items = []
+            for variant in field['variants']:
+                fields = variant['fields'] if 'fields' in variant else [variant['field']]
+                variant_offset = offset
+                for member in fields:
+                    items += self.field_layout(member, prefix, variant_offset)
+                    variant_offset += self.field_size(member)
+            return items
+        path = prefix + field['name']
+        if field['type'] in SCALARS:
+            return [(path, field['type'], offset, self.field_size(field), self.count(field) if 'count' in field else 0)]
+        return self.layout(field['type'], path + '.', offset)
+
+    def layout_hash(self):
+        text = ''
+        for name in self.order:
+            text += name + '{' + ';'.join('%s:%s:%d:%d' % (path, ctype, offset, size)
+                                          for path, ctype, offset, size, _ in self.layout(name)) + '}'
+        return crc16(text.encode())
+
+    def frames(self):
+        return [name for name in self.order if self.types[name].get('frame')]
+
+
+def doc_comment(doc):
+    return ' //' + doc if doc else ''
+
+
+def c_field_lines(schema, field, indent):
+    pad = '  ' * indent
+    if 'union' in field:
+        lines = [pad + 'union { //by ' + field['union']]
+        for variant in field['variants']:
+            if 'fields' in variant:
+                lines.append(pad + '  struct { //' + variant['value'])
+                for member in variant['fields']:
+                    lines += c_field_lines(schema, member, indent + 2)
+                lines.append(pad + '  };')
+            else:
+                member = variant['field']
+                lines += [line + ('' if '//' in line else ' //' + variant['value'])
+                          for line in c_field_lines(schema, member, indent + 1)]
+        lines.append(pad + '};')
+        return lines
+    array = '[%s]' % field['count'] if 'count' in field else ''
+    return [pad + '%s %s%s;%s' % (field['type'], field['name'], array, doc_comment(field.get('doc')))]
+
+
+def generate_types(schema):
+    data = schema.data
+    out = []
+    out.append('/*')
+    out.append(' * %s' % data['header']['file'])
+    out.append(' *')
+    out.append(' *  Created on: %s' % data['header']['created'])
+    out.append(' *      Author: %s' % data['header']['author'])
+    out.append(' *')
+    out.append(' * %s' % BANNER)
+    out.append(' * Change the schema and run: python3 Tools/MessageGen/message_gen.py generate')
+    out.append(' */')
+    out.append('#include <stdint.h>')
+    out.append('#include <stdbool.h>')
+    out.append('#include <stddef.h>')
+    out.append('')
+    out.append('#ifndef MESSAGETYPES_H')
+    out.append('#define MESSAGETYPES_H')
+    out.append('')
+    out.append('#define PROTOCOL_VERSION %d' % data['version'])
+    out.append('#define dPROTOCOL_LAYOUT_HASH 0x%04X /* CRC16 of all frame layouts */' % schema.layout_hash())
+    out.append('')
+    out.append('/* ProtocolHello_t.features */')
+    for index, feature in enumerate(data['features']):
+        doc = feature['doc'] + (', not offered: ' + feature['disabled'] if 'disabled' in feature else '')
+        out.append('#define dPROTOCOL_FEATURE_%-14s (1u << %d) /* %s */' % (feature['name'], index, doc))
+    # a disabled feature keeps its bit and is left out of the own hello
+    out.append('#define dPROTOCOL_FEATURES (%s)' % ' | '.join('dPROTOCOL_FEATURE_' + feature['name']
+                                                           for feature in data['features']
+                                                           if 'disabled' not in feature))
+    for group in data['defines']:
+        out.append('')
+        if group.get('doc'):
+            out.append('/* %s */' % group['doc'])
+        for item in group['items']:
+            line = '#define %-27s %s' % (item['name'], item['value'])
+            if item.get('doc'):
+                line = '%-40s /* %s */' % (line, item['doc'])
+            out.append(line)
+    out.append('')
+    out.append('/* All boards are little endian, frames go on the line as their struct memory */')
+    out.append('#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)')
+    out.append('#error "Message frames need a little endian target"')
+    out.append('#endif')
+    out.append('')
+    out.append('#pragma pack(push,1)')
+    for name in schema.order:
+        entry = schema.types[name]
+        out.append('//---------------------------------------------------------')
+        if entry.get('section'):
+            out.append('// ' + entry['section'])
+        for line in entry.get('doc', []):
+            out.append('// ' + line)
+        out.append('typedef struct {')
+        fields = entry['fields']
+        for index, field in enumerate(fields):
+            if entry.get('frame') and index == len(fields) - 1 and field['name'] == 'crc':
+                out.append('  ////////')
+            out += c_field_lines(schema, field, 1)
+        out.append('} %s;' % name)
+        out.append('')
+    out.append('#pragma pack(pop)')
+    out.append('')
+    out.append('// Compile time layout check on every target, C89 compatible for XC16')
+    out.append('#define MESSAGE_ASSERT(Condition, Name) typedef char MessageAssert_##Name[(Condition) ? 1 : -1]')
+    out.append('')
+    for name in schema.order:
+        out.append('MESSAGE_ASSERT(sizeof(%s) == %d, %s_size);' % (name, schema.sizes[name], base_name(name)))
+        for path, _, offset, _, _ in schema.layout(name):
+            out.append('MESSAGE_ASSERT(offsetof(%s, %s) == %d, %s_%s);' % (
+                name, path, offset, base_name(name), path.replace('.', '_')))
+    out.append('')
+    out.append('#endif /* MESSAGETYPES_H */')
+    return '\n'.join(out) + '\n'
+
+
+def accessor(path):
+    return ''.join(part[0].upper() + part[1:] for part in path.split('.'))
+
+
+def generate_codec_h(schema):
+    out = []
+    out.append('/*')
+    out.append(' * MessageCodec.h')
+    out.append(' *')
+    out.append(' * %s' % BANNER)
+    out.append(' *')
+    out.append(' * <Type>_Pack/_Unpack  struct <-> little endian bytes, independent of')
+    out.append(' *                      compiler layout, union by its discriminator')
+    out.append(' * <Type>View_Get/Set   zero-copy access to a field of a received byte buffer,')
+    out.append(' *                      any alignment')
+    out.append(' * <Frame>_Seal/IsValid CRC16 of a frame struct')
+    out.append(' */')
+    out.append('')
+    out.append('#ifndef MESSAGECODEC_H')
+    out.append('#define MESSAGECODEC_H')
+    out.append('')
+    out.append('#include "MessageTypes.h"')
+    out.append('')
+    out.append('#ifdef __cplusplus')
+    out.append('extern "C" {')
+    out.append('#endif')
+    out.append('')
+    for name in schema.order:
+        base = base_name(name)
+        out.append('#define d%s_SIZE %d' % (upper_name(name), schema.sizes[name]))
+        out.append('void %s_Pack(const %s *value, uint8_t *buffer);' % (base, name))
+        out.append('void %s_Unpack(%s *value, const uint8_t *buffer);' % (base, name))
+        if schema.types[name].get('frame'):
+            out.append('void %s_Seal(%s *frame);' % (base, name))
+            out.append('bool %s_IsValid(const %s *frame);' % (base, name))
+        out.append('')
+    out.append('// Own hello: magic, PROTOCOL_VERSION, dPROTOCOL_LAYOUT_HASH, dPROTOCOL_FEATURES, sealed')
+    out.append('void ProtocolHello_Make(ProtocolHello_t *hello);')
+    out.append('// Valid hello with magic, whatever the peer version')
+    out.append('bool ProtocolHello_Check(const ProtocolHello_t *hello);')
+    out.append('// Features both ends support, 0 when frame layouts differ')
+    out.append('uint16_t ProtocolHello_CommonFeatures(const ProtocolHello_t *peer);')
+    out.append('')
+    out.append('static inline uint16_t Message_Get16(const uint8_t *buffer)')
+    out.append('{')
+    out.append('  return (uint16_t)(buffer[0] | ((uint16_t)buffer[1] << 8));')
+    out.append('}')
+    out.append('')
+    out.append('static inline uint32_t Message_Get32(const uint8_t *buffer)')
+    out.append('{')
+    out.append('  return (uint32_t)Message_Get16(buffer) | ((uint32_t)Message_Get16(buffer + 2) << 16);')
+    out.append('}')
+    out.append('')
+    out.append('static inline void Message_Put16(uint8_t *buffer, uint16_t value)')
+    out.append('{')
+    out.append('  buffer[0] = (uint8_t)value;')
+    out.append('  buffer[1] = (uint8_t)(value >> 8);')
+    out.append('}')
+    out.append('')
+    out.append('static inline void Message_Put32(uint8_t *buffer, uint32_t value)')
+    out.append('{')
+    out.append('  Message_Put16(buffer, (uint16_t)value);')
+    out.append('  Message_Put16(buffer + 2, (uint16_t)(value >> 16));')
+    out.append('}')
+    out.append('')
+    for name in schema.frames():
+        view = base_name(name) + 'View'
+        out.append('// %s views' % name)
+        for path, ctype, offset, size, count in schema.layout(name):
+            if count:
+                out.append('#define d%s_%s_OFFSET %d' % (upper_name(name), upper_name(path.replace('.', '_')), offset))
+                continue
+            getter, putter = {1: ('buffer[%d]', 'buffer[%d] = (uint8_t)value'),
+                              2: ('Message_Get16(buffer + %d)', 'Message_Put16(buffer + %d, (uint16_t)value)'),
+                              4: ('Message_Get32(buffer + %d)', 'Message_Put32(buffer + %d, (uint32_t)value)')}[size]
+            out.append('static inline %s %s_Get%s(const uint8_t *buffer) { return (%s)%s; }' % (
+                ctype, view, accessor(path), ctype, getter % offset))
+            out.append('static inline void %s_Set%s(uint8_t *buffer, %s value) { %s; }' % (
+                view, accessor(path), ctype, putter % offset))
+        out.append('')
+    out.append('#ifdef __cplusplus')
+    out.append('}')
+    out.append('#endif')
+    out.append('')
+    out.append('#endif /* MESSAGECODEC_H */')
+    return '\n'.join(out) + '\n'
+
+
+def pack_lines(schema, field, source, offset, indent):
+    """C statements packing field of struct expression source at byte offset (int)"""
+    pad = '  ' * indent
+    if 'union' in field:
+        size = schema.field_size(field)
+        lines = [pad + 'memset(buffer + %d, 0, %d);' % (offset, size)]
+        keyword = 'if'
+        for variant in field['variants']:
+            lines.append(pad + '%s (%s%s == %s) {' % (keyword, source, field['union'], variant['value']))
+            members = variant['fields'] if 'fields' in variant else [variant['field']]
+            member_offset = offset
+            for member in members:
+                lines += pack_lines(schema, member, source, member_offset, indent + 1)
+                member_offset += schema.field_size(member)
+            keyword = '} else if'
+        lines.append(pad + '}')
+        return lines
+    expression = source + field['name']
+    if field['type'] in SCALARS:
+        size = SCALARS[field['type']][0]
+        if 'count' in field:
+            if size == 1:
+                return [pad + 'memcpy(buffer + %d, %s, %d);' % (offset, expression, schema.count(field))]
+            return [pad + 'for (i = 0; i < %d; i++) Message_Put%d(buffer + %d + i * %d, (uint%d_t)%s[i]);' % (
+                schema.count(field), size * 8, offset, size, size * 8, expression)]
+        if size == 1:
+            return [pad + 'buffer[%d] = (uint8_t)%s;' % (offset, expression)]
+        return [pad + 'Message_Put%d(buffer + %d, (uint%d_t)%s);' % (size * 8, offset, size * 8, expression)]
+    return [pad + '%s_Pack(&%s, buffer + %d);' % (base_name(field['type']), expression, offset)]
+
+
+def unpack_lines(schema, field, target, offset, indent):
+    pad = '  ' * indent
+    if 'union' in field:
+        size = schema.field_size(field)
+        lines = [pad + 'memset(&%s%s, 0, %d);' % (target, first_member(field), size)]
+        keyword = 'if'
+        for variant in field['variants']:
+            lines.append(pad + '%s (%s%s == %s) {' % (keyword, target, field['union'], variant['value']))
+            members = variant['fields'] if 'fields' in variant else [variant['field']]
+            member_offset = offset
+            for member in members:
+                lines += unpack_lines(schema, member, target, member_offset, indent + 1)
+                member_offset += schema.field_size(member)
+            keyword = '} else if'
+        lines.append(pad + '}')
+        return lines
+    expression = target + field['name']
+    ctype = field['type']
+    if ctype in SCALARS:
+        size = SCALARS[ctype][0]
+        if 'count' in field:
+            if size == 1:
+                return [pad + 'memcpy(%s, buffer + %d, %d);' % (expression, offset, schema.count(field))]
+            return [pad + 'for (i = 0; i < %d; i++) %s[i] = (%s)Message_Get%d(buffer + %d + i * %d);' % (
+                schema.count(field), expression, ctype, size * 8, offset, size)]
+        if size == 1:
+            return [pad + '%s = (%s)buffer[%d];' % (expression, ctype, offset)]
+        return [pad + '%s = (%s)Message_Get%d(buffer + %d);' % (expression, ctype, size * 8, offset)]
+    return [pad + '%s_Unpack(&%s, buffer + %d);' % (base_name(ctype), expression, offset)]
+
+
+def first_member(field):
+    variant = field['variants'][0]
+    return variant['fields'][0]['name'] if 'fields' in variant else variant['field']['name']
+
+
+def uses_loop(schema, fields):
+    for field in fields:
+        if 'union' in field:
+            for variant in field['variants']:
+                if uses_loop(schema, variant['fields'] if 'fields' in variant else [variant['field']]):
+                    return True
+        elif 'count' in field and SCALARS.get(field['type'], (1,))[0] > 1:
+            return True
+    return False
+
+
+def generate_codec_c(schema):
+    out = []
+    out.append('/*')
+    out.append(' * MessageCodec.c')
+    out.append(' *')
+    out.append(' * %s' % BANNER)
+    out.append(' */')
+    out.append('')
+    out.append('#include "MessageCodec.h"')
+    out.append('#include "../CRC16/CRC16.h"')
+    out.append('#include <string.h>')
+    for name in schema.order:
+        base = base_name(name)
+        fields = schema.types[name]['fields']
+        loop = uses_loop(schema, fields)
+        out.append('')
+        out.append('void %s_Pack(const %s *value, uint8_t *buffer)' % (base, name))
+        out.append('{')
+        if loop:
+            out.append('  uint16_t i;')
+            out.append('')
+        offset = 0
+        for field in fields:
+            out += pack_lines(schema, field, 'value->', offset, 1)
+            offset += schema.field_size(field)
+        out.append('}')
+        out.append('')
+        out.append('void %s_Unpack(%s *value, const uint8_t *buffer)' % (base, name))
+        out.append('{')
+        if loop:
+            out.append('  uint16_t i;')
+            out.append('')
+        offset = 0
+        for field in fields:
+            out += unpack_lines(schema, field, 'value->', offset, 1)
+            offset += schema.field_size(field)
+        out.append('}')
+        if schema.types[name].get('frame'):
+            out.append('')
+            out.append('void %s_Seal(%s *frame)' % (base, name))
+            out.append('{')
+            out.append('  frame->crc = CRC16((const uint8_t *)frame, offsetof(%s, crc));' % name)
+            out.append('}')
+            out.append('')
+            out.append('bool %s_IsValid(const %s *frame)' % (base, name))
+            out.append('{')
+            out.append('  return frame->crc == CRC16((const uint8_t *)frame, offsetof(%s, crc));' % name)
+            out.append('}')
+    out.append('')
+    out.append('void ProtocolHello_Make(ProtocolHello_t *hello)')
+    out.append('{')
+    out.append('  hello->magic = dPROTOCOL_HELLO_MAGIC;')
+    out.append('  hello->version = PROTOCOL_VERSION;')
+    out.append('  hello->layoutHash = dPROTOCOL_LAYOUT_HASH;')
+    out.append('  hello->features = dPROTOCOL_FEATURES;')
+    out.append('  ProtocolHello_Seal(hello);')
+    out.append('}')
+    out.append('')
+    out.append('bool ProtocolHello_Check(const ProtocolHello_t *hello)')
+    out.append('{')
+    out.append('  return (hello->magic == dPROTOCOL_HELLO_MAGIC) && ProtocolHello_IsValid(hello);')
+    out.append('}')
+    out.append('')
+    out.append('uint16_t ProtocolHello_CommonFeatures(const ProtocolHello_t *peer)')
+    out.append('{')
+    out.append('  if (peer->layoutHash != dPROTOCOL_LAYOUT_HASH) {')
+    out.append('    return 0;')
+    out.append('  }')
+    out.append('  return (uint16_t)(peer->features & dPROTOCOL_FEATURES);')
+    out.append('}')
+    return '\n'.join(out) + '\n'
+
+
+def struct_format(schema, type_name):
+    fmt = ''
+    for field in schema.types[type_name]['fields']:
+        if 'union' in field:
+            fmt += '%ds' % schema.field_size(field)
+        elif field['type'] in SCALARS:
+            code = SCALARS[field['type']][1]
+            fmt += ('%ds' % schema.count(field)) if 'count' in field and code in 'Bb' else (
+                code * schema.count(field) if 'count' in field else code)
+        else:
+            fmt += struct_format(schema, field['type'])
+    return fmt
+
+
+def generate_python(schema):
+    out = []
+    out.append('"""%s"""' % BANNER)
+    out.append('')
+    out.append('PROTOCOL_VERSION = %d' % schema.data['version'])
+    out.append('PROTOCOL_LAYOUT_HASH = 0x%04X' % schema.layout_hash())
+    for group in schema.data['defines']:
+        for item in group['items']:
+            value = item['value']
+            value = {'UINT32_MAX': '0xFFFFFFFF', 'UINT16_MAX': '0xFFFF'}.get(value, value)
+            out.append('%s = %s' % (item['name'][1:] if item['name'].startswith('d') else item['name'], value))
+    out.append('')
+    out.append('# struct module formats (little endian, packed), unions as bytes')
+    for name in schema.order:
+        out.append("%s_FORMAT = '<%s'" % (upper_name(name), struct_format(schema, name)))
+        out.append('%s_SIZE = %d' % (upper_name(name), schema.sizes[name]))
+    out.append('')
+    out.append('# field offsets')
+    for name in schema.frames():
+        out.append('%s_OFFSETS = {' % upper_name(name))
+        for path, _, offset, _, _ in schema.layout(name):
+            out.append("    '%s': %d," % (path, offset))
+        out.append('}')
+    return '\n'.join(out) + '\n'
+
+
+def generate_all(schema):
+    return {
+        'types': generate_types(schema),
+        'codec_h': generate_codec_h(schema),
+        'codec_c': generate_codec_c(schema),
+        'python': generate_python(schema),
+    }
+
+
+def command_generate(args):
+    schema = Schema(SCHEMA)
+    for key, text in generate_all(schema).items():
+        with open(OUTPUTS[key], 'w', newline='\n') as file:
+            file.write(text)
+        print('wrote %s' % os.path.relpath(OUTPUTS[key]))
+    print('PROTOCOL_VERSION %d, layout hash 0x%04X' % (schema.data['version'], schema.layout_hash()))
+    return 0
+
+
+def command_check(args):
+    schema = Schema(SCHEMA)
+    stale = []
+    for key, text in generate_all(schema).items():
+        try:
+            with open(OUTPUTS[key]) as file:
+                current = file.read()
+        except OSError:
+            current = None
+        if current != text:
+            stale.append(os.path.relpath(OUTPUTS[key]))
+    if stale:
+        print('out of date, run message_gen.py generate: ' + ', '.join(stale))
+        return 1
+    print('generated files are up to date')
+    return 0
+
+
+def random_field_value(rng, ctype):
+    size, _, signed = SCALARS[ctype]
+    bits = size * 8
+    return rng.randrange(-(1 << (bits - 1)), 1 << (bits - 1)) if signed else rng.randrange(1 << bits)
+
+
+def random_values(schema, type_name, rng):
+    """Flat list of (path, ctype, offset, value) and expected packed bytes"""
+    data = bytearray(schema.sizes[type_name])
+    discriminators = {}
+    for field in schema.types[type_name]['fields']:
+        if 'union' in field:
+            discriminators[field['union']] = rng.choice(field['variants'])
+    chosen = []
+    for field_offset, field in field_offsets(schema, type_name):
+        if 'union' in field:
+            variant = discriminators[field['union']]
+            members = variant['fields'] if 'fields' in variant else [variant['field']]
+            member_offset = field_offset
+            for member in members:
+                chosen += schema.field_layout(member, '', member_offset)
+                member_offset += schema.field_size(member)
+        else:
+            chosen += schema.field_layout(field, '', field_offset)
+    result = []
+    for path, ctype, offset, field_size, count in chosen:
+        if path in discriminators:
+            value = int(schema.defines[discriminators[path]['value']], 0)
+        elif count:
+            value = [random_field_value(rng, ctype) for _ in range(count)]
+        else:
+            value = random_field_value(rng, ctype)
+        code = SCALARS[ctype][1]
+        if count:
+            struct.pack_into('<%d%s' % (count, code), data, offset, *value)
+        else:
+            struct.pack_into('<' + code, data, offset, value)
+        result.append((path, ctype, offset, count, value))
+    return result, bytes(data)
+
+
+def field_offsets(schema, type_name):
+    offset = 0
+    for field in schema.types[type_name]['fields']:
+        yield offset, field
+        offset += schema.field_size(field)
+
+
+def c_literal(ctype, value):
+    if SCALARS[ctype][2]:
+        return '(%s)(%d)' % (ctype, value)
+    return '(%s)%du' % (ctype, value)
+
+
+def self_test_source(schema, cases):
+    out = ['#include <stdio.h>', '#include <string.h>', '#include "MessageCodec.h"', '#include "CRC16.h"', '',
+           'static int Errors;', '',
+           'static void Compare(const char *what, const uint8_t *a, const uint8_t *b, unsigned size)',
+           '{',
+           '    if (memcmp(a, b, size) != 0) {',
+           '        printf("mismatch %s\\n", what);',
+           '        Errors++;',
+           '    }',
+           '}', '',
+           'int main(void)',
+           '{',
+           '    uint8_t buffer[512];',
+           '    uint8_t raw[512];',
+           '    CRC16_Init();']
+    for index, (type_name, values, expected) in enumerate(cases):
+        base = base_name(type_name)
+        var = 'value%d' % index
+        out.append('    {')
+        out.append('        static const uint8_t expected[%d] = {%s};' % (len(expected), ', '.join(str(b) for b in expected)))
+        out.append('        %s %s, back;' % (type_name, var))
+        out.append('        memset(&%s, 0, sizeof(%s));' % (var, var))
+        for path, ctype, offset, count, value in values:
+            if count:
+                for element, item in enumerate(value):
+                    out.append('        %s.%s[%d] = %s;' % (var, path, element, c_literal(ctype, item)))
+            else:
+                out.append('        %s.%s = %s;' % (var, path, c_literal(ctype, value)))
+        out.append('        memset(buffer, 0xA5, sizeof(buffer));')
+        out.append('        %s_Pack(&%s, buffer);' % (base, var))
+        out.append('        Compare("%s pack", buffer, expected, %d);' % (type_name, len(expected)))
+        out.append('        memcpy(raw, &%s, sizeof(%s));' % (var, var))
+        out.append('        Compare("%s struct memory", raw, expected, %d);' % (type_name, len(expected)))
+        out.append('        memset(&back, 0x5A, sizeof(back));')
+        out.append('        %s_Unpack(&back, expected);' % base)
+        out.append('        Compare("%s unpack", (const uint8_t *)&back, expected, %d);' % (type_name, len(expected)))
+        if schema.types[type_name].get('frame'):
+            view = base + 'View'
+            for path, ctype, offset, count, value in values:
+                if count:
+                    continue
+                out.append('        if (%s_Get%s(expected) != %s) { printf("view %s.%s\\n"); Errors++; }' % (
+                    view, accessor(path), c_literal(ctype, value), type_name, path))
+            out.append('        %s_Seal(&%s);' % (base, var))
+            out.append('        if (!%s_IsValid(&%s) || %s.crc != CRC16(expected, %d)) { printf("%s seal\\n"); Errors++; }' % (
+                base, var, var, len(expected) - 2, type_name))
+        out.append('    }')
+    out += ['    {',
+            '        ProtocolHello_t hello;',
+            '        ProtocolHello_Make(&hello);',
+            '        if (!ProtocolHello_Check(&hello) || ProtocolHello_CommonFeatures(&hello) != dPROTOCOL_FEATURES) {',
+            '            printf("hello\\n");',
+            '            Errors++;',
+            '        }',
+            '        hello.layoutHash ^= 1;',
+            '        if (ProtocolHello_CommonFeatures(&hello) != 0) {',
+            '            printf("hello layout\\n");',
+            '            Errors++;',
+            '        }',
+            '    }',
+            '    printf("errors %d\\n", Errors);',
+            '    return Errors ? 1 : 0;',
+            '}']
+    return '\n'.join(out) + '\n'
+
+
+def command_self_test(args):
+    schema = Schema(SCHEMA)
+    if command_check(args):
+        return 1
+    rng = random.Random(args.seed)
+    cases = []
+    for _ in range(args.iterations):
+        for name in schema.order:
+            values, expected = random_values(schema, name, rng)
+            cases.append((name, values, expected))
+
+    failed = False
+    with tempfile.TemporaryDirectory() as directory:
+        source = os.path.join(directory, 'message_test.c')
+        with open(source, 'w') as file:
+            file.write(self_test_source(schema, cases))
+        sources = [source, OUTPUTS['codec_c'], os.path.join(CRC_DIR, 'CRC16.c')]
+        includes = ['-I' + TYPES_DIR, '-I' + CRC_DIR]
+        builds = [('c99', [args.cc, '-std=gnu99', '-Wall', '-Wextra', '-Werror', '-O1'] + includes + sources)]
+        if args.m32:
+            builds.append(('c99 -m32', [args.cc, '-std=gnu99', '-m32', '-Wall', '-Wextra', '-O1'] + includes + sources))
+        for label, command in builds:
+            output = os.path.join(directory, 'message_test')
+            if subprocess.call(command + ['-o', output]) != 0:
+                print('%s: build failed' % label)
+                failed = True
+                continue
+            result = subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True)
+            print('%s: %s' % (label, result.stdout.strip().splitlines()[-1] if result.stdout else 'no output'))
+            if result.returncode:
+                print(result.stdout)
+                failed = True
+        # ESP32 includes the header from C++
+        header_test = os.path.join(directory, 'header_test.cpp')
+        with open(header_test, 'w') as file:
+            file.write('#include "MessageCodec.h"\nint main() { return sizeof(Esp2ImuFrame_t) == %d ? 0 : 1; }\n'
+                       % schema.sizes['Esp2ImuFrame_t'])
+        if subprocess.call([args.cxx, '-std=gnu++17', '-Wall', '-Werror', '-fsyntax-only', '-I' + TYPES_DIR,
+                            header_test]) != 0:
+            print('c++: header does not compile')
+            failed = True
+        else:
+            print('c++: header compiles')
+
+    print('%d packed frames checked against Python struct packing' % len(cases))
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    subparsers = parser.add_subparsers(dest='command')
+    subparsers.required = True
+    subparsers.add_parser('generate').set_defaults(function=command_generate)
+    subparsers.add_parser('check').set_defaults(function=command_check)
+    parser_test = subparsers.add_parser('self-test')
+    parser_test.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser_test.add_argument('--cxx', default=os.environ.get('CXX', 'c++'))
+    parser_test.add_argument('--iterations', type=int, default=50)
+    parser_test.add_argument('--seed', type=int, default=1)
+    parser_test.add_argument('--m32', action='store_true', help='also build 32 bit (needs multilib)')
+    parser_test.set_defaults(function=command_self_test)
+    args = parser.parse_args()
+    return args.function(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,199 @@
+"""Generated by Tools/MessageGen/message_gen.py from MessageSchema.json, do not edit."""
+
+PROTOCOL_VERSION = 13
+PROTOCOL_LAYOUT_HASH = 0xF94D
+ESP2IMU_FRAME_CONTROL = 0
+ESP2IMU_FRAME_ROUTE_BLOCK = 1
+ESP2IMU_FRAME_HELLO = 2
+ESP2IMU_FRAME_STOP = 3
+ESP2IMU_FRAME_FW_UPDATE = 4
+STOP_NONE = 0
+STOP_REQUESTED = 1
+FW_TARGET_NONE = 0
+FW_TARGET_IMU = 1
+FW_TARGET_PMB = 2
+STOP_REACTION_UNKNOWN = 0xFFFF
+COLLISION_NONE = 0
+COLLISION_IMPACT = 1
+COLLISION_WHEEL_STALL = 2
+COLLISION_AUGER_OVERLOAD = 3
+ROUTE_BLOCK_BEGIN = 1
+ROUTE_BLOCK_DATA = 2
+ROUTE_BLOCK_COMMIT = 3
+ROUTE_BLOCK_ABORT = 4
+ROUTE_BLOCK_DATA_SIZE = 64
+ROUTE_UPLOAD_IDLE = 0
+ROUTE_UPLOAD_RECEIVING = 1
+ROUTE_UPLOAD_DONE = 2
+ROUTE_UPLOAD_ERROR_BUSY = 3
+ROUTE_UPLOAD_ERROR_HEADER = 4
+ROUTE_UPLOAD_ERROR_FLASH = 5
+ROUTE_UPLOAD_ERROR_CRC = 6
+SYNC_NO_ECHO = 0xFFFFFFFF
+SYNC_UNKNOWN_WEEK_TIME = 0xFFFFFFFF
+SYNC_NOT_SYNCHRONISED = 0xFFFF
+LINK_COMMAND_NONE = 0
+LINK_COMMAND_PROPOSE = 1
+LINK_COMMAND_ACCEPT = 2
+LINK_COMMAND_REJECT = 3
+LINK_COMMAND_SWITCH = 4
+LINK_RATE_115200 = 0
+LINK_RATE_460800 = 1
+LINK_RATE_921600 = 2
+LINK_RATE_2000000 = 3
+LINK_RATE_NUM_OF = 4
+PROTOCOL_HELLO_MAGIC = 0x484D
+IMU2PC_DELIMITER = 0x0A0D
+
+# struct module formats (little endian, packed), unions as bytes
+SYNC_STAMP_FORMAT = '<IIIIH'
+SYNC_STAMP_SIZE = 18
+LATENCY_TRACE_FORMAT = '<HHHHHHH'
+LATENCY_TRACE_SIZE = 14
+LINK_CONTROL_FORMAT = '<BBBB'
+LINK_CONTROL_SIZE = 4
+PROTOCOL_HELLO_FORMAT = '<HHHHH'
+PROTOCOL_HELLO_SIZE = 10
+IMU2PMB_FRAME_FORMAT = '<hhHHHHHBIBBIIIIHBBBBH'
+IMU2PMB_FRAME_SIZE = 45
+PMB2IMU_FRAME_FORMAT = '<IIHHHHHHHHHHIHIIIIHBBBBH'
+PMB2IMU_FRAME_SIZE = 58
+IMU2ESP_FRAME_FORMAT = '<IHhhHHHHHHHBBHHHHHHHHIHBHHHIIIIHBBBBH'
+IMU2ESP_FRAME_SIZE = 79
+ROUTE_BLOCK_FORMAT = '<BBH64s'
+ROUTE_BLOCK_SIZE = 68
+ESP2IMU_FRAME_FORMAT = '<B68sIIIIHBBBBH'
+ESP2IMU_FRAME_SIZE = 93
+IMU2PC_FRAME_FORMAT = '<HHHHHHHHH'
+IMU2PC_FRAME_SIZE = 18
+
+# field offsets
+PROTOCOL_HELLO_OFFSETS = {
+    'magic': 0,
+    'version': 2,
+    'layoutHash': 4,
+    'features': 6,
+    'crc': 8,
+}
+IMU2PMB_FRAME_OFFSETS = {
+    'motorRightSpeed': 0,
+    'motorLeftSpeed': 2,
+    'motorThumbleSpeed': 4,
+    'motorLiftSpeed': 6,
+    'motorBelt1Speed': 8,
+    'motorBelt2Speed': 10,
+    'traceId': 12,
+    'stop': 14,
+    'stopTime': 15,
+    'fwTarget': 19,
+    'fwRate': 20,
+    'sync.txTime': 21,
+    'sync.echoTime': 25,
+    'sync.echoDelay': 29,
+    'sync.weekTime': 33,
+    'sync.errorBound': 37,
+    'link.command': 39,
+    'link.rate': 40,
+    'link.sequence': 41,
+    'link.errors': 42,
+    'crc': 43,
+}
+PMB2IMU_FRAME_OFFSETS = {
+    'motorRightRotation': 0,
+    'motorLeftRotation': 4,
+    'batteryVoltage': 8,
+    'adcCurrent': 10,
+    'thumbleCurrent': 12,
+    'crcImu2PmbErrorCount': 14,
+    'loopMaxTime': 16,
+    'missedTicks': 18,
+    'taskMisses': 20,
+    'traceId': 22,
+    'traceRxTime': 24,
+    'traceTxTime': 26,
+    'stopTime': 28,
+    'stopReaction': 32,
+    'sync.txTime': 34,
+    'sync.echoTime': 38,
+    'sync.echoDelay': 42,
+    'sync.weekTime': 46,
+    'sync.errorBound': 50,
+    'link.command': 52,
+    'link.rate': 53,
+    'link.sequence': 54,
+    'link.errors': 55,
+    'crc': 56,
+}
+IMU2ESP_FRAME_OFFSETS = {
+    'magnetBarStatus': 0,
+    'pmbConnection': 4,
+    'motorRightSpeed': 6,
+    'motorLeftSpeed': 8,
+    'batteryVoltage': 10,
+    'adcCurrent': 12,
+    'thumbleCurrent': 14,
+    'crcImu2PmbErrorCount': 16,
+    'crcPmb2ImuErrorCount': 18,
+    'crcEsp2ImuErrorCount': 20,
+    'routeUploadAck': 22,
+    'routeUploadState': 24,
+    'routeCount': 25,
+    'commandSequence': 26,
+    'trace.traceId': 28,
+    'trace.imuRxTime': 30,
+    'trace.imuPmbTxTime': 32,
+    'trace.pmbRxTime': 34,
+    'trace.pmbTxTime': 36,
+    'trace.imuPmbRxTime': 38,
+    'trace.imuTxTime': 40,
+    'stopTime': 42,
+    'stopReaction': 46,
+    'collision': 48,
+    'pmbLoopMaxTime': 49,
+    'pmbMissedTicks': 51,
+    'pmbTaskMisses': 53,
+    'sync.txTime': 55,
+    'sync.echoTime': 59,
+    'sync.echoDelay': 63,
+    'sync.weekTime': 67,
+    'sync.errorBound': 71,
+    'link.command': 73,
+    'link.rate': 74,
+    'link.sequence': 75,
+    'link.errors': 76,
+    'crc': 77,
+}
+ESP2IMU_FRAME_OFFSETS = {
+    'frameType': 0,
+    'moveX': 1,
+    'moveY': 2,
+    'augerSpeed': 3,
+    'rootNumber': 5,
+    'rootAction': 6,
+    'power': 7,
+    'charging': 8,
+    'commandSequence': 9,
+    'routeBlock.command': 1,
+    'routeBlock.length': 2,
+    'routeBlock.sequence': 3,
+    'routeBlock.data': 5,
+    'hello.magic': 1,
+    'hello.version': 3,
+    'hello.layoutHash': 5,
+    'hello.features': 7,
+    'hello.crc': 9,
+    'stopSequence': 1,
+    'stopTime': 3,
+    'fwTarget': 1,
+    'fwRate': 2,
+    'sync.txTime': 69,
+    'sync.echoTime': 73,
+    'sync.echoDelay': 77,
+    'sync.weekTime': 81,
+    'sync.errorBound': 85,
+    'link.command': 87,
+    'link.rate': 88,
+    'link.sequence': 89,
+    'link.errors': 90,
+    'crc': 91,
+}
@@ -0,0 +1,32 @@
+/*
+ * Host driver of motion_profile_sim.py, built together with
+ * Melkens_PMB/MotionProfile/MotionProfile.c and Melkens_PMB/Tools/FixedPoint.c.
+ *
+ * Reads one step per line from stdin:
+ *   <name> <length cm> <speed RPM> <cm per rotation, Q16> <accelerate 0|1> <decelerate 0|1>
+ * and prints
+ *   profile <name> <accel length> <decel length> <factor at 0 cm> ... <factor at length + 2 cm>
+ */
+
+#include <stdio.h>
+#include "MotionProfile/MotionProfile.h"
+
+int main(void)
+{
+    char Name[64];
+    unsigned Length, Speed, Accelerate, Decelerate;
+    long DistancePerRotation;
+    MotionProfile Profile;
+    unsigned Travelled;
+
+    while (scanf("%63s %u %u %ld %u %u", Name, &Length, &Speed, &DistancePerRotation, &Accelerate, &Decelerate) == 6) {
+        MotionProfile_Plan(&Profile, (uint16_t)Length, (uint16_t)Speed, (q16_t)DistancePerRotation,
+                           Accelerate != 0u, Decelerate != 0u);
+        printf("profile %s %u %u", Name, Profile.AccelLength, Profile.DecelLength);
+        for (Travelled = 0; Travelled <= Length + 2u; Travelled++) {
+            printf(" %d", MotionProfile_GetFactor(&Profile, (uint16_t)Travelled));
+        }
+        printf("\n");
+    }
+    return 0;
+}
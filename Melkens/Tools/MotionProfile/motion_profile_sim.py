@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""
+Host check of the PMB wheel step speed profile, Melkens_PMB/MotionProfile.
+
+Builds motion_profile_sim.c with MotionProfile.c and FixedPoint.c, plans
+steps typical for the routes in Melkens_PMB/Routes.c and checks that:
+  - the S-curve starts and ends at dMOTION_PROFILE_LOW_FACTOR, is monotonic
+    on the ramps and stays at full speed between them,
+  - the integer profile follows the float model of the same plan,
+  - peak acceleration (v dv/ds) stays within dMOTION_PROFILE_MAX_ACCEL when
+    the ramp fits in the step,
+  - acceleration at the ramp ends is close to 0 and peak jerk is lower than
+    with the previous linear ramp over 30 % of the step.
+
+Acceleration and jerk are taken from the profile at 1 cm resolution. The
+PMB updates the factor every dSPEED_CONTROL_PERIOD (10 ms), below 1 cm of
+travel at route speeds.
+
+Usage:
+  motion_profile_sim.py [--cc cc] [--cflags "-O2"] [--verbose]
+"""
+
+import argparse
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+PMB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_PMB')
+HEADER = os.path.join(PMB_DIR, 'MotionProfile', 'MotionProfile.h')
+
+Q15_ONE = 32767
+# dDISTANCE_PER_MOTOR_ROTATION of both robots, pmb_Settings.h
+MOONION = 0.67
+MOOVER = 1.26
+
+# name, length [cm], speed [RPM], cm per rotation, accelerate, decelerate
+CASES = [
+    ('norm_100cm_300rpm', 100, 300, MOOVER, True, True),
+    ('norm_100cm_600rpm', 100, 600, MOOVER, True, True),
+    ('norm_50cm_300rpm_accel', 50, 300, MOOVER, True, False),
+    ('norm_150cm_300rpm_decel', 150, 300, MOOVER, False, True),
+    ('short_20cm_300rpm', 20, 300, MOOVER, True, True),
+    ('moonion_100cm_600rpm', 100, 600, MOONION, True, True),
+    ('long_1000cm_1500rpm', 1000, 1500, MOOVER, True, True),
+    ('no_ramp_100cm', 100, 600, MOOVER, False, False),
+]
+
+
+def read_constants():
+    with open(HEADER) as file:
+        text = file.read()
+    low = float(re.search(r'#define dMOTION_PROFILE_LOW_FACTOR\s+dQ15\(([\d.]+)\)', text).group(1))
+    accel = int(re.search(r'#define dMOTION_PROFILE_MAX_ACCEL\s+(\d+)u', text).group(1))
+    min_ramp = int(re.search(r'#define dMOTION_PROFILE_MIN_RAMP\s+(\d+)u', text).group(1))
+    return low, accel, min_ramp
+
+
+def smoothstep(x):
+    return x * x * (3.0 - 2.0 * x)
+
+
+def float_factor(low, length, accel_length, decel_length, travelled):
+    factor = 1.0
+    if travelled < accel_length:
+        factor = low + (1.0 - low) * smoothstep(travelled / accel_length)
+    if decel_length:
+        remaining = max(length - travelled, 0)
+        if remaining < decel_length:
+            factor = min(factor, low + (1.0 - low) * smoothstep(remaining / decel_length))
+    return factor
+
+
+def linear_factor(length, accelerate, decelerate, travelled):
+    """RouteManager_ApplySpeedRamp before the S-curve"""
+    percent = travelled / length
+    if accelerate and percent < 0.3:
+        return percent * (1.0 / 0.3 - 0.4) + 0.2
+    if decelerate and 0.7 < percent < 1.0:
+        return 1.0 - (percent - 0.7) * (1.0 / 0.3 - 0.4)
+    if decelerate and percent >= 1.0:
+        return 0.2
+    return 1.0
+
+
+def dynamics(speeds, accelerate, decelerate):
+    """Peak acceleration, acceleration at ramp ends, peak jerk and time of
+    speeds [cm/s] sampled every cm. Before an accelerated step and after a
+    decelerated one the robot is taken as not accelerating."""
+    accels = []
+    times = []
+    for first, second in zip(speeds, speeds[1:]):
+        middle = (first + second) / 2.0
+        accels.append(middle * (second - first))
+        times.append(1.0 / middle)
+    if accelerate:
+        accels.insert(0, 0.0)
+        times.insert(0, times[0])
+    if decelerate:
+        accels.append(0.0)
+        times.append(times[-1])
+    jerks = [abs(accels[i + 1] - accels[i]) / ((times[i] + times[i + 1]) / 2.0) for i in range(len(accels) - 1)]
+    ends = []
+    if accelerate:
+        ends.append(abs(accels[1]))
+    if decelerate:
+        ends.append(abs(accels[-2]))
+    return max(abs(a) for a in accels), max(ends or [0.0]), max(jerks), sum(times)
+
+
+def check_case(case, result, constants, verbose):
+    name, length, rpm, distance, accelerate, decelerate = case
+    low, max_accel, min_ramp = constants
+    accel_length, decel_length = result[0], result[1]
+    factors = result[2:]
+    speed = rpm * distance / 60.0
+    problems = []
+
+    if accelerate and abs(factors[0] - low * 32768) > 2:
+        problems.append('start factor %d' % factors[0])
+    if decelerate and any(abs(f - low * 32768) > 2 for f in factors[length:]):
+        problems.append('end factor %d' % factors[length])
+    if not accelerate and not decelerate and any(f != Q15_ONE for f in factors):
+        problems.append('ramp without accelerate/decelerate')
+    if accel_length and any(b < a for a, b in zip(factors[:accel_length], factors[1:accel_length + 1])):
+        problems.append('acceleration not monotonic')
+    if decel_length:
+        start = length - decel_length
+        if any(b > a for a, b in zip(factors[start:length], factors[start + 1:length + 1])):
+            problems.append('deceleration not monotonic')
+
+    error = max(abs(f / 32768.0 - float_factor(low, length, accel_length, decel_length, i))
+                for i, f in enumerate(factors))
+    if error > 0.001:
+        problems.append('float model error %.4f' % error)
+
+    # peak of v dv/ds over a ramp of unit length and speed
+    shape = max((low + (1 - low) * smoothstep(x)) * (1 - low) * 6 * x * (1 - x)
+                for x in [i / 1000.0 for i in range(1001)])
+    planned = shape * speed ** 2 / max_accel
+    fits = max(planned, min_ramp) <= (length / 2 if accelerate and decelerate else length)
+    speeds = [f / 32768.0 * speed for f in factors[:length + 1]]
+    peak, end, jerk, time = dynamics(speeds, accelerate, decelerate)
+    if fits and peak > max_accel * 1.1:
+        problems.append('peak acceleration %.2f cm/s^2' % peak)
+
+    linear = [linear_factor(length, accelerate, decelerate, i) * speed for i in range(length + 1)]
+    linear_peak, linear_end, linear_jerk, linear_time = dynamics(linear, accelerate, decelerate)
+    if (accelerate or decelerate) and (jerk >= linear_jerk or end >= linear_end / 4):
+        problems.append('not smoother than linear ramp')
+
+    print('%-26s %s ramps %3d/%3d cm  a %5.2f (lin %5.2f)  a_end %5.2f (lin %5.2f)  j %7.2f (lin %7.2f)  t %5.1f s (lin %5.1f)%s' % (
+        name, 'FAIL' if problems else 'ok  ', accel_length, decel_length, peak, linear_peak, end, linear_end,
+        jerk, linear_jerk, time, linear_time, ('  ' + ', '.join(problems)) if problems else ''))
+    if verbose:
+        print('  ' + ' '.join('%.2f' % (f / 32768.0) for f in factors))
+    return not problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    parser.add_argument('--verbose', action='store_true', help='print the factor of every cm')
+    args = parser.parse_args()
+
+    constants = read_constants()
+    steps = ''.join('%s %d %d %d %d %d\n' % (name, length, rpm, round(distance * 65536), accelerate, decelerate)
+                    for name, length, rpm, distance, accelerate, decelerate in CASES)
+
+    with tempfile.TemporaryDirectory() as directory:
+        output = os.path.join(directory, 'motion_profile_sim')
+        command = [args.cc, '-std=c99', '-Wall', '-Wextra'] + shlex.split(args.cflags) + [
+            '-I' + PMB_DIR, '-o', output,
+            os.path.join(TOOL_DIR, 'motion_profile_sim.c'),
+            os.path.join(PMB_DIR, 'MotionProfile', 'MotionProfile.c'),
+            os.path.join(PMB_DIR, 'Tools', 'FixedPoint.c')]
+        subprocess.check_call(command)
+        result = subprocess.run([output], input=steps, stdout=subprocess.PIPE, universal_newlines=True)
+
+    print('low %.2f, max acceleration %d cm/s^2, min ramp %d cm' % constants)
+    failed = result.returncode != 0
+    profiles = {}
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if fields[0] == 'profile':
+            profiles[fields[1]] = [int(value) for value in fields[2:]]
+    for case in CASES:
+        failed |= not check_case(case, profiles[case[0]], constants, args.verbose)
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
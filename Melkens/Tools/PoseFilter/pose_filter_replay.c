@@ -0,0 +1,238 @@
+/*
+ * Host driver of pose_filter_replay.py, built together with
+ * Melkens_IMU/Core/Src/PoseFilter.c and Routes.c.
+ *
+ * Arguments: <param>=<value> overriding PoseFilter_Defaults.
+ *
+ * Reads trace lines from stdin, the route first:
+ *   route <id>                    compiled route of Routes.c
+ *   step <MagnetOffset>           or a route given step by step [0.1 mm]
+ *   magnet <x> <y> <step>         and its magnets, StepCount + 1 of them
+ *   start <ms> <x> <y> <angle>    loadRoute, pose in the Navigation frame
+ *   odo <ms> <left> <right> <yaw> getLeftEncoder, getRightEncoder, getRobotAngle
+ *   mag <ms> <status> <bar>       MagnetsHandler_GetSatus, GetAvreageDistance [cm]
+ *   true <ms> <x> <y>             true position, for the error only
+ * odo and mag are handled as updatePosition and navigationPerform1ms do,
+ * the step of the magnet window from the route segment nearest to the
+ * filter position. Next to the filter the pose is dead reckoned as before
+ * it: nominal CmPerCount and AHRS yaw since start.
+ * Prints:
+ *   params <name>=<value> ...
+ *   fix <ms> <magnet or -1>
+ *   pose <ms> <ekf error> <dead reckoning error> <position deviation>   on every true line
+ *   result <fixes> <rejects> <scale> <bias>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include "PoseFilter.h"
+#include "MagnetsHandler.h"
+
+#define MAX_STEPS   512
+#define COUNTS      10000
+
+typedef struct {
+    const char *name;
+    size_t offset;
+} Param;
+
+static const Param Params[] = {
+    {"CmPerCount", offsetof(PoseFilterParams, CmPerCount)},
+    {"DistanceNoise", offsetof(PoseFilterParams, DistanceNoise)},
+    {"SlipNoise", offsetof(PoseFilterParams, SlipNoise)},
+    {"YawNoise", offsetof(PoseFilterParams, YawNoise)},
+    {"ScaleWalk", offsetof(PoseFilterParams, ScaleWalk)},
+    {"BiasWalk", offsetof(PoseFilterParams, BiasWalk)},
+    {"MagnetNoise", offsetof(PoseFilterParams, MagnetNoise)},
+    {"Gate", offsetof(PoseFilterParams, Gate)},
+    {"ScaleDeviation", offsetof(PoseFilterParams, ScaleDeviation)},
+    {"BiasDeviation", offsetof(PoseFilterParams, BiasDeviation)},
+    {"LostDeviation", offsetof(PoseFilterParams, LostDeviation)},
+    {"LostAngleDeviation", offsetof(PoseFilterParams, LostAngleDeviation)},
+};
+#define PARAMS_NUM_OF (sizeof(Params) / sizeof(Params[0]))
+
+static RouteData Route;
+static RouteStep Steps[MAX_STEPS];
+static RoutePoint Magnets[MAX_STEPS + 1];
+
+/* Routes.c takes uploaded routes first, there are none on the host */
+bool RouteStore_GetRoute(uint16_t ID, RouteData *Data)
+{
+    (void)ID;
+    (void)Data;
+    return false;
+}
+
+static float *ParamValue(PoseFilterParams *params, size_t index)
+{
+    return (float *)((uint8_t *)params + Params[index].offset);
+}
+
+static int Increment(long value, long last)
+{
+    int increment = (int)(value - last);
+
+    if (increment < -COUNTS / 2) {
+        increment += COUNTS;
+    } else if (increment > COUNTS / 2) {
+        increment -= COUNTS;
+    }
+    return increment;
+}
+
+static double SegmentDistance(const RoutePoint *a, const RoutePoint *b, double x, double y)
+{
+    double dx = b->X - a->X, dy = b->Y - a->Y;
+    double length = dx * dx + dy * dy;
+    double t = (length > 0.0) ? ((x - a->X) * dx + (y - a->Y) * dy) / length : 0.0;
+
+    if (t < 0.0) {
+        t = 0.0;
+    } else if (t > 1.0) {
+        t = 1.0;
+    }
+    return hypot(x - (a->X + t * dx), y - (a->Y + t * dy));
+}
+
+/* Step the robot is on, searched forward from the last one as closestPoint is */
+static uint16_t CurrentStep(uint16_t last, float x, float y)
+{
+    uint16_t step = last;
+    double best = 1e9;
+
+    for (uint16_t i = (last > 0u) ? last - 1u : 0u; i < Route.StepCount && i <= last + 3u; i++) {
+        double distance = SegmentDistance(&Route.Magnet[i], &Route.Magnet[i + 1], x, y);
+
+        if (distance < best) {
+            best = distance;
+            step = i;
+        }
+    }
+    return step;
+}
+
+int main(int argc, char **argv)
+{
+    PoseFilterParams params = PoseFilter_Defaults;
+    char line[256], kind[16];
+    unsigned long time, status, lastStatus = 0;
+    long values[3];
+    double numbers[3];
+    long lastLeft = 0, lastRight = 0;
+    double lastYaw = 0.0, startYaw = 0.0, startAngle = 3.1415;
+    double deadX = 0.0, deadY = 0.0;
+    unsigned long lastOdo = 0;
+    int isOdo = 0;
+    uint16_t step = 0, fixes = 0, rejects = 0;
+    size_t i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        char *value = strchr(argv[arg], '=');
+
+        if (value == NULL) {
+            fprintf(stderr, "bad argument %s\n", argv[arg]);
+            return 2;
+        }
+        *value++ = '\0';
+        for (i = 0; i < PARAMS_NUM_OF && strcmp(argv[arg], Params[i].name) != 0; i++) {
+        }
+        if (i == PARAMS_NUM_OF) {
+            fprintf(stderr, "unknown parameter %s\n", argv[arg]);
+            return 2;
+        }
+        *ParamValue(&params, i) = strtof(value, NULL);
+    }
+
+    printf("params");
+    for (i = 0; i < PARAMS_NUM_OF; i++) {
+        printf(" %s=%g", Params[i].name, *ParamValue(&params, i));
+    }
+    printf("\n");
+
+    PoseFilter_Init(&params);
+    Route.Step = Steps;
+    Route.Magnet = Magnets;
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        if (sscanf(line, "%15s", kind) != 1) {
+            continue;
+        }
+        if (strcmp(kind, "route") == 0 && sscanf(line, "%*s %ld", &values[0]) == 1) {
+            Route_SetRoutePointer(&Route, (Route_ID)values[0]);
+        } else if (strcmp(kind, "step") == 0 && sscanf(line, "%*s %ld", &values[0]) == 1) {
+            if (Route.StepCount < MAX_STEPS) {
+                Steps[Route.StepCount].MagnetOffset = (int16_t)values[0];
+                Route.StepCount++;
+            }
+        } else if (strcmp(kind, "magnet") == 0 && sscanf(line, "%*s %ld %ld %ld", &values[0], &values[1], &values[2]) == 3) {
+            if (Route.PointCount <= MAX_STEPS) {
+                Magnets[Route.PointCount].X = (int16_t)values[0];
+                Magnets[Route.PointCount].Y = (int16_t)values[1];
+                Magnets[Route.PointCount].StepNumber = (uint16_t)values[2];
+                Route.PointCount++;
+            }
+        } else if (sscanf(line, "%*s %lu", &time) != 1) {
+            continue;
+        } else if (strcmp(kind, "start") == 0 &&
+                   sscanf(line, "%*s %*u %lf %lf %lf", &numbers[0], &numbers[1], &numbers[2]) == 3) {
+            PoseFilter_Reset((float)numbers[0], (float)numbers[1], (float)numbers[2]);
+            deadX = numbers[0];
+            deadY = numbers[1];
+            startAngle = numbers[2];
+            step = 0;
+            isOdo = 0;
+        } else if (strcmp(kind, "odo") == 0 &&
+                   sscanf(line, "%*s %*u %ld %ld %lf", &values[0], &values[1], &numbers[0]) == 3) {
+            if (isOdo) {
+                int left = Increment(values[0], lastLeft);
+                int right = Increment(values[1], lastRight);
+                double yaw = numbers[0] - lastYaw;
+                double distance = (left - right) * 0.5 * params.CmPerCount;
+                double angle = startAngle + (numbers[0] - startYaw);
+
+                if (yaw > 3.1415) {
+                    yaw -= 2.0 * 3.1415;
+                } else if (yaw < -3.1415) {
+                    yaw += 2.0 * 3.1415;
+                }
+                PoseFilter_Predict((left - right) * 0.5f, (float)yaw, (float)(time - lastOdo) / 1000.0f);
+                deadX -= distance * cos(angle);
+                deadY += distance * sin(angle);
+            } else {
+                startYaw = numbers[0];
+                isOdo = 1;
+            }
+            lastLeft = values[0];
+            lastRight = values[1];
+            lastYaw = numbers[0];
+            lastOdo = time;
+        } else if (strcmp(kind, "mag") == 0 && sscanf(line, "%*s %*u %lu %lf", &status, &numbers[0]) == 2) {
+            if (status != 0u && lastStatus == 0u && status != dMAGNET_STATUS_ERROR && Route.StepCount > 0u) {
+                uint16_t first;
+                int16_t magnet;
+
+                step = CurrentStep(step, PoseFilter_GetX(), PoseFilter_GetY());
+                first = (step > 0u) ? step - 1u : 0u;
+                magnet = PoseFilter_MagnetFix(&Route, first, first + dPOSE_FILTER_MAGNET_WINDOW - 1,
+                                              (float)numbers[0], dMAGNET_BAR_OFFSET_DISTANCE);
+                if (magnet == dPOSE_FILTER_NO_MAGNET) {
+                    rejects++;
+                } else {
+                    fixes++;
+                }
+                printf("fix %lu %d\n", time, magnet);
+            }
+            lastStatus = status;
+        } else if (strcmp(kind, "true") == 0 && sscanf(line, "%*s %*u %lf %lf", &numbers[0], &numbers[1]) == 2) {
+            printf("pose %lu %.2f %.2f %.2f\n", time,
+                   hypot(PoseFilter_GetX() - numbers[0], PoseFilter_GetY() - numbers[1]),
+                   hypot(deadX - numbers[0], deadY - numbers[1]), PoseFilter_GetPositionDeviation());
+        }
+    }
+    printf("result %u %u %.4f %.6f\n", fixes, rejects, PoseFilter_GetScale(), PoseFilter_GetBias());
+    return 0;
+}
@@ -0,0 +1,302 @@
+#!/usr/bin/env python3
+"""
+Host validation of the IMU pose filter (PoseFilter), odometry, AHRS yaw and magnet fixes.
+
+Builds pose_filter_replay.c with Melkens_IMU/Core/Src/PoseFilter.c and
+Routes.c and feeds it traces in the firmware call order: encoder counts and
+AHRS yaw of every Pmb2ImuFrame_t (10 ms) and the magnet bar status sampled
+every 100 ms.
+
+  simulate   synthetic runs: the robot follows a route exactly, wheels
+             travel 3 % further than CmPerCount says, the AHRS yaw drifts,
+             magnets are missed, the bar reports false hits and timeouts.
+             The filter error must stay bounded while dead reckoning, as
+             before the filter, grows, false hits must be rejected and the
+             odometry scale learned. Every run is done twice and must give
+             the same output. Exit code 1 when any check fails.
+  replay     a recorded trace, lines as read by pose_filter_replay.c
+             (route <id> or step/magnet lines, start, odo <ms> <left>
+             <right> <yaw>, mag <ms> <status> <bar cm>, optional true <ms>
+             <x> <y>, commas allowed), prints fixes and errors.
+
+Filter parameters are changed with --param Name=value (PoseFilterParams
+field names), the defaults are PoseFilter_Defaults.
+
+Usage:
+  pose_filter_replay.py simulate [--scenario all] [--seed 1] [--param MagnetNoise=3]
+  pose_filter_replay.py replay trace.txt [--param ...]
+"""
+
+import argparse
+import math
+import os
+import random
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+IMU_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_IMU', 'Core')
+TYPES_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib', 'Types')
+
+CM_PER_COUNT = 0.00018996       # PoseFilter_Defaults.CmPerCount
+COUNTS = 10000                  # encoder counts per rotation
+TRACK_WIDTH = 60.0              # [cm]
+BAR_OFFSET = 20.0               # [cm] dMAGNET_BAR_OFFSET_DISTANCE, bar behind the axle
+SENSOR_PITCH = 2.5              # [cm] dDISTANCE_BETWEEN_SENSORS
+SENSOR_REACH = 1.5              # [cm] magnet seen by a sensor this close
+STATUS_ERROR = 0xA5A5A5A5       # dMAGNET_STATUS_ERROR
+ODO_PERIOD = 10                 # [ms]
+MAG_PERIOD = 100                # [ms]
+TRUE_PERIOD = 1000              # [ms]
+PI = 3.1415                     # Navigation frame, loadRoute starts at Robot_Angle 3.1415
+
+
+class Scenario:
+    """Route as straight steps between magnets, driven at Speed [cm/s], turning in place between steps"""
+
+    def __init__(self, corners, offsets, reverse, laps=1, speed=9.5, scale=1.03, drift=0.0003,
+                 miss=0.2, false_hits=0.0005, timeouts=0.002, limit=8.0):
+        self.corners = corners
+        self.offsets = offsets          # [0.1 mm] magnet beside the route, in turn for every magnet
+        self.reverse = reverse          # steps driven backwards
+        self.laps = laps
+        self.speed = speed
+        self.scale = scale              # true cm per count over CM_PER_COUNT
+        self.drift = drift              # [rad/s] AHRS yaw drift
+        self.miss = miss
+        self.false_hits = false_hits    # share of bar samples
+        self.timeouts = timeouts
+        self.limit = limit              # [cm] filter error allowed once scale and drift are learned
+        self.false_times = []           # [ms] false hits of the last trace
+
+    def route(self):
+        """Magnets in the Navigation frame, robot starts at 0, 0 heading +X"""
+        points = []
+        for lap in range(self.laps):
+            for index, corner in enumerate(self.corners):
+                if lap == 0 or index > 0:
+                    points.append(corner)
+        reverse = [self.reverse[i % len(self.reverse)] for i in range(len(points) - 1)]
+        return points, reverse
+
+    def trace(self, seed):
+        rng = random.Random(seed)
+        points, reverse = self.route()
+        headings = [travel_angle(points[i], points[i + 1], reverse[i]) for i in range(len(points) - 1)]
+
+        # One physical magnet per place, beside the route along the bar of the first pass (sin, cos).
+        # Every step expects the bar reading of its end magnet when driven on the route.
+        beside = {}
+        for i in range(1, len(points)):
+            if points[i] not in beside:
+                lateral = self.offsets[len(beside) % len(self.offsets)] / 100.0
+                beside[points[i]] = (math.sin(headings[i - 1]) * lateral, math.cos(headings[i - 1]) * lateral)
+        lines = ['step %d' % int(round(100.0 * (beside[points[i + 1]][0] * math.sin(heading) +
+                                                beside[points[i + 1]][1] * math.cos(heading))))
+                 for i, heading in enumerate(headings)]
+        lines += ['magnet %d %d %d' % (x, y, max(i - 1, 0)) for i, (x, y) in enumerate(points)]
+        lines.append('start 0 0 0 %.4f' % PI)
+        magnets = [(x + dx, y + dy) for (x, y), (dx, dy) in sorted(beside.items()) if rng.random() >= self.miss]
+
+        state = {'ms': 0, 'x': 0.0, 'y': 0.0, 'angle': PI, 'left': 0.0, 'right': 0.0,
+                 'status': 0, 'bar': 0.0}
+        yaw_offset = rng.uniform(-PI, PI)
+        self.false_times = []
+
+        def sample():
+            ms = state['ms']
+            yaw = wrap(state['angle'] - PI + yaw_offset + self.drift * ms / 1000.0 + rng.gauss(0.0, 0.0005))
+            lines.append('odo %d %d %d %.6f' % (ms, int(state['left']) % COUNTS, int(state['right']) % COUNTS, yaw))
+            if ms % MAG_PERIOD == 0:
+                status, bar = bar_status(state, magnets)
+                draw = rng.random()
+                if draw < self.false_hits:
+                    sensor = rng.randrange(32)
+                    status, bar = 1 << sensor, (sensor - 16) * SENSOR_PITCH
+                    self.false_times.append(ms)
+                elif draw < self.false_hits + self.timeouts:
+                    status, bar = STATUS_ERROR, 0.0
+                lines.append('mag %d %d %.2f' % (ms, status, bar))
+            if ms % TRUE_PERIOD == 0:
+                lines.append('true %d %.2f %.2f' % (ms, state['x'], state['y']))
+
+        def move(distance, turn):
+            # Wheels at distance -+ turn * track / 2, right counts down going forward
+            left = (distance - turn * TRACK_WIDTH / 2.0) / (CM_PER_COUNT * self.scale)
+            right = (distance + turn * TRACK_WIDTH / 2.0) / (CM_PER_COUNT * self.scale)
+            state['left'] += left
+            state['right'] -= right
+            state['x'] -= distance * math.cos(state['angle'])
+            state['y'] += distance * math.sin(state['angle'])
+            state['angle'] = wrap(state['angle'] + turn)
+            state['ms'] += ODO_PERIOD
+            sample()
+
+        sample()
+        for i in range(1, len(points)):
+            change = wrap(headings[i - 1] - state['angle'])
+            rate = 0.5 * ODO_PERIOD / 1000.0    # turn in place at 0.5 rad/s
+            while abs(change) > 1e-9:
+                turn = max(-rate, min(rate, change))
+                move(0.0, turn)
+                change -= turn
+            length = math.hypot(points[i][0] - points[i - 1][0], points[i][1] - points[i - 1][1])
+            step = self.speed * ODO_PERIOD / 1000.0 * (-1.0 if reverse[i - 1] else 1.0)
+            for _ in range(int(round(length / abs(step)))):
+                move(step, 0.0)
+        return lines
+
+
+def wrap(angle):
+    return math.atan2(math.sin(angle), math.cos(angle))
+
+
+def travel_angle(a, b, reverse):
+    """Robot_Angle driving from a to b: X -= d cos, Y += d sin"""
+    angle = math.atan2(b[1] - a[1], -(b[0] - a[0]))
+    return wrap(angle + math.pi) if reverse else angle
+
+
+def bar_status(state, magnets):
+    """MagnetsHandler status and GetAvreageDistance of the magnets under the bar, calculatePoint frame"""
+    sin, cos = math.sin(state['angle']), math.cos(state['angle'])
+    sensors = []
+    for mx, my in magnets:
+        dx, dy = mx - state['x'], my - state['y']
+        along = dx * cos - dy * sin
+        lateral = dx * sin + dy * cos
+        if abs(along - BAR_OFFSET) > SENSOR_REACH:
+            continue
+        for sensor in range(32):
+            if abs((sensor - 16) * SENSOR_PITCH - lateral) <= SENSOR_REACH:
+                sensors.append(sensor)
+    if not sensors:
+        return 0, 0.0
+    status = 0
+    for sensor in sensors:
+        status |= 1 << sensor
+    # Integer division as in MagnetsHandler_GetAvreageDistance
+    return status, (sum(sensors) // len(sensors) - 16) * SENSOR_PITCH
+
+
+def make_scenarios():
+    square = [(0, 0), (200, 0), (400, 0), (400, 200), (400, 400), (200, 400), (0, 400), (0, 200), (0, 0)]
+    alley = [(0, 0), (250, 0), (500, 0), (750, 0), (1000, 0), (1250, 0), (1500, 0)]
+    return {
+        'laps': Scenario(square, [0], [False], laps=6),
+        'alley': Scenario(alley + alley[-2::-1], [0, 120, -80], [False] * 6 + [True] * 6, laps=4),
+        'exact': Scenario(square, [0], [False], laps=2, scale=1.0, drift=0.0, miss=0.0, false_hits=0.0,
+                          timeouts=0.0, limit=4.0),
+    }
+
+
+def build(args, directory):
+    output = os.path.join(directory, 'pose_filter_replay')
+    subprocess.check_call([args.cc, '-std=c99'] + shlex.split(args.cflags) + [
+        '-I' + os.path.join(IMU_DIR, 'Inc'), '-I' + TYPES_DIR, '-o', output,
+        os.path.join(TOOL_DIR, 'pose_filter_replay.c'),
+        os.path.join(IMU_DIR, 'Src', 'PoseFilter.c'),
+        os.path.join(IMU_DIR, 'Src', 'Routes.c'), '-lm'])
+    return output
+
+
+def run(driver, lines, params):
+    result = subprocess.run([driver] + params, input='\n'.join(lines) + '\n',
+                            stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    output = {'header': '', 'fixes': [], 'poses': [], 'text': result.stdout}
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if fields[0] == 'params':
+            output['header'] = ' '.join(fields[1:])
+        elif fields[0] == 'fix':
+            output['fixes'].append((int(fields[1]), int(fields[2])))
+        elif fields[0] == 'pose':
+            output['poses'].append((int(fields[1]), float(fields[2]), float(fields[3]), float(fields[4])))
+        elif fields[0] == 'result':
+            output['result'] = (int(fields[1]), int(fields[2]), float(fields[3]), float(fields[4]))
+    return output
+
+
+def simulate(args, driver):
+    scenarios = make_scenarios()
+    names = sorted(scenarios) if args.scenario == 'all' else [args.scenario]
+    failed = False
+    for index, name in enumerate(names):
+        scenario = scenarios[name]
+        seed = args.seed + index
+        lines = scenario.trace(seed)
+        output = run(driver, lines, args.param)
+        again = run(driver, scenario.trace(seed), args.param)
+        if index == 0:
+            print(output['header'])
+
+        fixes, rejects, scale, bias = output['result']
+        false_fixes = [magnet for time, magnet in output['fixes'] if time in scenario.false_times]
+        accepted_false = sum(1 for magnet in false_fixes if magnet >= 0)
+        # Scale and drift are learned in the first quarter of the run
+        learned = [pose[1] for pose in output['poses'] if pose[0] * 4 >= output['poses'][-1][0]]
+        ekf = max(learned) if fixes else float('inf')
+        peak = max(pose[1] for pose in output['poses'])
+        dead = output['poses'][-1][2]
+
+        problems = []
+        if ekf > scenario.limit:
+            problems.append('filter error')
+        if scenario.drift > 0.0 and dead < 5.0 * ekf:
+            problems.append('not better than dead reckoning')
+        if accepted_false > 0.1 * len(false_fixes):
+            problems.append('false hits accepted')
+        if abs(scale - scenario.scale) > 0.01:
+            problems.append('scale not learned')
+        if output['text'] != again['text']:
+            problems.append('not deterministic')
+        failed |= bool(problems)
+
+        print('%-6s %s%s' % (name, 'FAIL' if problems else 'ok', ('  ' + ', '.join(problems)) if problems else ''))
+        print('  fixes %d rejected %d, false hits %d accepted %d' % (fixes, rejects, len(false_fixes), accepted_false))
+        print('  error max %.1f cm, learned %.1f cm, dead reckoning %.1f cm at end' % (peak, ekf, dead))
+        print('  scale %.4f (true %.4f)  bias %.6f rad/s (true %.6f)' % (scale, scenario.scale, bias, scenario.drift))
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+def replay(args, driver):
+    with open(args.trace) as trace:
+        lines = [line.replace(',', ' ').strip() for line in trace if line.strip() and not line.startswith('#')]
+    output = run(driver, lines, args.param)
+    print(output['header'])
+    for time, magnet in output['fixes']:
+        print('%10d ms  %s' % (time, ('magnet %d' % magnet) if magnet >= 0 else 'rejected'))
+    if output['poses']:
+        print('error max %.1f cm, at end %.1f cm, dead reckoning at end %.1f cm'
+              % (max(pose[1] for pose in output['poses']), output['poses'][-1][1], output['poses'][-1][2]))
+    fixes, rejects, scale, bias = output['result']
+    print('%d fixes, %d rejected, scale %.4f, bias %.6f rad/s' % (fixes, rejects, scale, bias))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--param', action='append', default=[], help='PoseFilterParams field=value')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-Wall -Wextra -O2')
+    commands = parser.add_subparsers(dest='command')
+    command = commands.add_parser('simulate')
+    command.add_argument('--scenario', default='all', choices=['all'] + sorted(make_scenarios()))
+    command.add_argument('--seed', type=int, default=1)
+    command = commands.add_parser('replay')
+    command.add_argument('trace')
+    args = parser.parse_args()
+    if args.command is None:
+        parser.print_help()
+        return 2
+
+    with tempfile.TemporaryDirectory() as directory:
+        driver = build(args, directory)
+        return simulate(args, driver) if args.command == 'simulate' else replay(args, driver)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,531 @@
+#!/usr/bin/env python3
+"""
+Route compiler.
+
+Reads route descriptions (CSV or YAML) from Melkens/Routes, validates them
+and generates the constant route tables of both boards:
+
+  PMB  Melkens_PMB/Routes.c           compact RouteStep tables and pose
+                                      (cumulative position and heading)
+                                      at the end of each step
+  IMU  Melkens_IMU/Core/Src/Routes.c  steps with precomputed segment length,
+                                      heading and magnet position, cumulative
+                                      magnet points and pursuit points
+
+Route description header (CSV comment lines or YAML keys):
+  id      route letter, RouteA .. RouteK on PMB, RouteA .. RouteD on IMU,
+          route_pack.py accepts A .. Z or number for the IMU route store
+  boards  pmb, imu or both separated by comma
+  frame   relative - dx is driven along the current heading, L_90/R_90
+                     steps rotate the heading by angle (PMB style)
+          absolute - dx/dy is the displacement in route frame (IMU style),
+                     only for imu
+  repeat  route repetitions (PMB), default 1
+  name    free text, written as comment to the generated file
+
+Step columns:
+  op, dx, dy, speed_r, speed_l, dir_r, dir_l, thumble, angle, magnet, note
+  op      NORM, NORM_NOMAGNET, L_90, R_90, TU_L, TU_R
+  dir_*   FOR / REV
+  thumble ON / OFF
+  angle   turn angle [deg] of L_90/R_90 steps
+  magnet  expected magnet bar position: NONE, MID, L<n>/R<n> (n sensors
+          from the middle) or number in cm
+
+Usage:
+  route_compiler.py            generate tables
+  route_compiler.py --check    fail if generated tables are not up to date
+"""
+
+import argparse
+import csv
+import glob
+import math
+import os
+import sys
+
+MELKENS_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+ROUTES_DIR = os.path.join(MELKENS_DIR, 'Routes')
+PMB_OUTPUT = os.path.join(MELKENS_DIR, 'Melkens_PMB', 'Routes.c')
+IMU_OUTPUT = os.path.join(MELKENS_DIR, 'Melkens_IMU', 'Core', 'Src', 'Routes.c')
+
+# Route_ID enums of both boards
+BOARD_ROUTE_IDS = {
+    'pmb': 'ABCDEFGHIJK',
+    'imu': 'ABCD',
+}
+
+COLUMNS = ['op', 'dx', 'dy', 'speed_r', 'speed_l', 'dir_r', 'dir_l', 'thumble', 'angle', 'magnet', 'note']
+OPERATIONS = ['NORM', 'TU_L', 'TU_R', 'L_90', 'R_90', 'DIFF', 'NORM_NOMAGNET']
+DRIVE_OPERATIONS = ['NORM', 'NORM_NOMAGNET']
+TURN_OPERATIONS = ['L_90', 'R_90']
+
+MAGNET_SENSOR_PITCH_CM = 2.17       # distance between magnet bar sensors
+MAGNET_RANGE_CM = 32.5              # half of magnet bar length
+MAGNET_UNIT_PER_CM = 100            # RouteStep magnet position unit is 0.1 mm
+MAGNET_NONE = 'dROUTE_MAGNET_NONE'
+HEADING_UNIT_PER_RAD = 10000        # RouteStep heading unit is 1e-4 rad
+ROUTE_POINTS_DISTANCE = 10          # [cm] distance between IMU pursuit points
+
+INT16_MIN = -32768
+INT16_MAX = 32767
+UINT16_MAX = 65535
+PMB_MAX_STEPS = 255
+
+
+class RouteError(Exception):
+    pass
+
+
+class Step:
+    def __init__(self, row, where):
+        self.where = where
+        values = dict((key, '' if row.get(key) is None else str(row.get(key)).strip()) for key in COLUMNS)
+        self.op = values['op'].upper()
+        self.dx = parse_int(values['dx'], 0, where, 'dx')
+        self.dy = parse_int(values['dy'], 0, where, 'dy')
+        self.speed_r = parse_int(values['speed_r'], 0, where, 'speed_r')
+        self.speed_l = parse_int(values['speed_l'], 0, where, 'speed_l')
+        self.dir_r = values['dir_r'].upper()
+        self.dir_l = values['dir_l'].upper()
+        self.thumble = parse_switch(values['thumble'], where)
+        self.angle = parse_int(values['angle'], 0, where, 'angle')
+        self.magnet = parse_magnet(values['magnet'], where)
+        self.note = values['note']
+
+    def error(self, message):
+        raise RouteError('%s: %s' % (self.where, message))
+
+
+class Route:
+    def __init__(self, path):
+        self.path = path
+        self.id = None
+        self.boards = []
+        self.frame = 'relative'
+        self.repeat = 1
+        self.name = ''
+        self.steps = []
+
+    def error(self, message):
+        raise RouteError('%s: %s' % (self.path, message))
+
+
+def parse_int(text, default, where, name):
+    if text == '':
+        return default
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise RouteError('%s: %s is not an integer: %r' % (where, name, text))
+
+
+def parse_switch(text, where):
+    text = text.upper()
+    if text in ('ON', 'TRUE', '1'):
+        return True
+    if text in ('', 'OFF', 'FALSE', '0'):
+        return False
+    raise RouteError('%s: thumble has to be ON or OFF: %r' % (where, text))
+
+
+def parse_magnet(text, where):
+    """Returns expected magnet position in cm or None when correction is off"""
+    name = text.upper()
+    if name in ('', 'NONE'):
+        return None
+    if name == 'MID':
+        return 0.0
+    if name[0] in 'LR' and name[1:].isdigit():
+        sensors = int(name[1:])
+        return (-sensors if name[0] == 'L' else sensors) * MAGNET_SENSOR_PITCH_CM
+    try:
+        return float(text)
+    except ValueError:
+        raise RouteError('%s: unknown magnet position %r' % (where, text))
+
+
+def load_header(route, key, value):
+    key = key.strip().lower()
+    value = value.strip() if isinstance(value, str) else value
+    if key == 'id':
+        route.id = str(value).upper()
+    elif key == 'boards':
+        if isinstance(value, list):
+            route.boards = [str(board).strip().lower() for board in value]
+        else:
+            route.boards = [board.strip().lower() for board in str(value).split(',') if board.strip()]
+    elif key == 'frame':
+        route.frame = str(value).lower()
+    elif key == 'repeat':
+        route.repeat = parse_int(str(value), 1, route.path, 'repeat')
+    elif key == 'name':
+        route.name = str(value)
+    else:
+        route.error('unknown header key %r' % key)
+
+
+def load_csv(path):
+    route = Route(path)
+    rows = []
+    with open(path, newline='') as file:
+        for number, line in enumerate(file, 1):
+            if line.startswith('#'):
+                if ':' in line:
+                    key, value = line[1:].split(':', 1)
+                    load_header(route, key, value)
+                continue
+            if line.strip():
+                rows.append((number, line))
+    if not rows:
+        route.error('no steps')
+    reader = csv.DictReader([line for number, line in rows])
+    unknown = set(reader.fieldnames) - set(COLUMNS)
+    if unknown:
+        route.error('unknown columns %s' % ', '.join(sorted(unknown)))
+    for (number, line), row in zip(rows[1:], reader):
+        route.steps.append(Step(row, '%s:%d' % (path, number)))
+    return route
+
+
+def load_yaml(path):
+    try:
+        import yaml
+    except ImportError:
+        raise RouteError('%s: PyYAML is needed for YAML route descriptions' % path)
+    route = Route(path)
+    with open(path) as file:
+        document = yaml.safe_load(file)
+    for key, value in document.items():
+        if key != 'steps':
+            load_header(route, key, value)
+    for index, row in enumerate(document.get('steps') or []):
+        # YAML 1.1 reads ON/OFF as booleans
+        row = dict((key, ('ON' if value else 'OFF') if isinstance(value, bool) else value) for key, value in row.items())
+        route.steps.append(Step(row, '%s: step %d' % (path, index)))
+    return route
+
+
+def validate(route, board_ids=BOARD_ROUTE_IDS):
+    if route.id is None or not (len(route.id) == 1 or route.id.isdigit()):
+        route.error('missing or invalid id')
+    if not route.boards:
+        route.error('missing boards')
+    for board in route.boards:
+        if board not in board_ids:
+            route.error('unknown board %r' % board)
+        if route.id not in board_ids[board]:
+            route.error('route %s does not exist on %s' % (route.id, board))
+    if route.frame not in ('relative', 'absolute'):
+        route.error('frame has to be relative or absolute')
+    if route.frame == 'absolute' and 'pmb' in route.boards:
+        route.error('absolute frame routes can not be driven by pmb')
+    if not route.steps:
+        route.error('no steps')
+    if 'pmb' in route.boards and len(route.steps) > PMB_MAX_STEPS:
+        route.error('pmb route can have at most %d steps' % PMB_MAX_STEPS)
+    if not 0 < route.repeat < 256:
+        route.error('repeat out of range')
+
+    for step in route.steps:
+        if step.op not in OPERATIONS:
+            step.error('unknown operation %r' % step.op)
+        for direction in (step.dir_r, step.dir_l):
+            if direction not in ('FOR', 'REV'):
+                step.error('direction has to be FOR or REV')
+        for speed in (step.speed_r, step.speed_l):
+            if not 0 <= speed <= INT16_MAX:
+                step.error('speed out of range')
+        if step.magnet is not None:
+            if abs(step.magnet) > MAGNET_RANGE_CM:
+                step.error('magnet position outside of magnet bar')
+            if step.op != 'NORM':
+                step.error('magnet correction is used only in NORM steps')
+
+        if route.frame == 'relative':
+            if step.op in DRIVE_OPERATIONS:
+                if step.dx <= 0 or step.dy != 0:
+                    step.error('%s step needs dx > 0 and dy = 0' % step.op)
+                if step.dir_r != step.dir_l:
+                    step.error('%s step needs both wheels in the same direction' % step.op)
+                if step.angle != 0:
+                    step.error('%s step can not have angle' % step.op)
+            elif step.op in TURN_OPERATIONS:
+                if step.dx != 0 or step.dy != 0:
+                    step.error('%s step can not have dx/dy' % step.op)
+                if not 0 < step.angle <= 180:
+                    step.error('turn angle has to be in range 1..180')
+                expected = ('FOR', 'REV') if step.op == 'L_90' else ('REV', 'FOR')
+                if (step.dir_r, step.dir_l) != expected:
+                    step.error('%s step needs dir_r=%s, dir_l=%s' % ((step.op,) + expected))
+            elif 'imu' in route.boards:
+                step.error('%s step can not be compiled for imu' % step.op)
+        else:
+            if step.op != 'NORM':
+                step.error('absolute frame routes support only NORM steps')
+            if step.dx == 0 and step.dy == 0:
+                step.error('step without displacement')
+            if step.dir_r != step.dir_l or step.speed_r != step.speed_l:
+                step.error('absolute frame step needs equal wheel speed and direction')
+        low = INT16_MIN if route.frame == 'absolute' else 0
+        if not (low <= step.dx <= UINT16_MAX and low <= step.dy <= UINT16_MAX):
+            step.error('dx/dy out of range')
+
+
+def load_routes(directory):
+    paths = sorted(glob.glob(os.path.join(directory, '*.csv')) +
+                   glob.glob(os.path.join(directory, '*.yaml')) +
+                   glob.glob(os.path.join(directory, '*.yml')))
+    routes = dict((board, {}) for board in BOARD_ROUTE_IDS)
+    for path in paths:
+        route = load_csv(path) if path.endswith('.csv') else load_yaml(path)
+        validate(route)
+        for board in route.boards:
+            if route.id in routes[board]:
+                route.error('route %s for %s is also defined in %s' % (route.id, board, routes[board][route.id].path))
+            routes[board][route.id] = route
+    for board, ids in BOARD_ROUTE_IDS.items():
+        missing = [route_id for route_id in ids if route_id not in routes[board]]
+        if missing:
+            raise RouteError('%s routes missing: %s' % (board, ', '.join(missing)))
+    return routes
+
+
+def magnet_value(magnet):
+    if magnet is None:
+        return MAGNET_NONE
+    return str(int(round(magnet * MAGNET_UNIT_PER_CM)))
+
+
+def c_trunc_div(a, b):
+    """Integer division rounding towards zero, as in C"""
+    quotient = abs(a) // abs(b)
+    return quotient if (a >= 0) == (b > 0) else -quotient
+
+
+def imu_geometry(route):
+    """Returns IMU steps, magnet points and pursuit points of a route"""
+    steps = []
+    x = y = 0.0
+    heading = 0.0
+    for step in route.steps:
+        if route.frame == 'absolute':
+            dx, dy = step.dx, step.dy
+            reverse = step.dir_r == 'REV'
+        elif step.op in TURN_OPERATIONS:
+            heading += math.radians(step.angle if step.op == 'L_90' else -step.angle)
+            continue
+        else:
+            reverse = step.dir_r == 'REV'
+            distance = -step.dx if reverse else step.dx
+            dx, dy = distance * math.cos(heading), distance * math.sin(heading)
+        start = (int(round(x)), int(round(y)))
+        x += dx
+        y += dy
+        end = (int(round(x)), int(round(y)))
+        speed = (step.speed_r + step.speed_l) // 2
+        steps.append({
+            'start': start,
+            'end': end,
+            'speed': -speed if reverse else speed,
+            'thumble': step.thumble,
+            'magnet': step.magnet,
+            'note': step.note,
+        })
+
+    magnets = [(0, 0, 0)]
+    for index, step in enumerate(steps):
+        magnets.append((step['end'][0], step['end'][1], index))
+
+    # Same rule as used before by Navigation loadRoute()
+    points = []
+    for index in range(len(steps)):
+        dx = magnets[index][0] - magnets[index + 1][0]
+        dy = magnets[index][1] - magnets[index + 1][1]
+        step_distance = math.sqrt(dx * dx + dy * dy)
+        intermediate = int(step_distance / ROUTE_POINTS_DISTANCE)
+        steps[index]['length'] = int(round(step_distance))
+        steps[index]['heading'] = int(round(math.atan2(-dy, -dx) * HEADING_UNIT_PER_RAD))
+        for a in range(intermediate):
+            points.append((magnets[index][0] - c_trunc_div(dx, intermediate) * a,
+                           magnets[index][1] - c_trunc_div(dy, intermediate) * a,
+                           index))
+    points.append(magnets[-1])
+
+    for point in magnets + points:
+        if not (INT16_MIN <= point[0] <= INT16_MAX and INT16_MIN <= point[1] <= INT16_MAX):
+            route.error('route does not fit in int16 coordinates')
+    if len(points) > UINT16_MAX:
+        route.error('too many pursuit points')
+    return steps, magnets, points
+
+
+def pmb_poses(route):
+    """Returns (x, y, heading) at the end of each PMB step
+
+    x [cm] along the start heading, y [cm] to the right of it, heading [deg]
+    relative to the start, clockwise, as DesiredAngle of pmb_RouteManager.c
+    (L_90 subtracts the angle, R_90 adds it).
+    """
+    poses = []
+    x = y = 0.0
+    heading = 0
+    for step in route.steps:
+        if step.op in TURN_OPERATIONS:
+            heading += -step.angle if step.op == 'L_90' else step.angle
+            if heading <= -180:
+                heading += 360
+            elif heading > 180:
+                heading -= 360
+        elif step.op in DRIVE_OPERATIONS:
+            distance = -step.dx if step.dir_r == 'REV' else step.dx
+            x += distance * math.cos(math.radians(heading))
+            y += distance * math.sin(math.radians(heading))
+        else:
+            step.error('%s step has no pose' % step.op)
+        pose = (int(round(x)), int(round(y)), heading)
+        if not (INT16_MIN <= pose[0] <= INT16_MAX and INT16_MIN <= pose[1] <= INT16_MAX):
+            route.error('route does not fit in int16 coordinates')
+        poses.append(pose)
+    return poses
+
+
+def generated_notice(sources):
+    return [
+        ' * Generated by Tools/RouteCompiler/route_compiler.py from:',
+    ] + [' *   Routes/%s' % os.path.basename(path) for path in sources] + [
+        ' * Do not edit, change the route description and run the compiler again.',
+    ]
+
+
+def generate_pmb(routes):
+    ids = BOARD_ROUTE_IDS['pmb']
+    lines = ['/*', ' * File:   Routes.c', ' *']
+    lines += generated_notice([routes[route_id].path for route_id in ids])
+    lines += [' */', '', '#include "RoutesDataTypes.h"', '', '#include <string.h>', '']
+    for route_id in ids:
+        route = routes[route_id]
+        lines.append('')
+        if route.name:
+            lines.append('//%s' % route.name)
+        lines.append('#define STEPS_ROUTE_%s %d' % (route_id, len(route.steps)))
+        lines.append('static const RouteStep RouteSteps%s[STEPS_ROUTE_%s] = {' % (route_id, route_id))
+        lines.append('//{MODE, DirectionR, DirectionL, ThumbleState, dX, dY, SpeedR, SpeedL, Angle, MagnetCorrection}')
+        for index, step in enumerate(route.steps):
+            lines.append(('//%d %s' % (index, step.note)).rstrip())
+            lines.append('{%s, R_%s, L_%s, %s, %d, %d, %d, %d, %d, %s},' % (
+                step.op, step.dir_r, step.dir_l, 'TH_ON' if step.thumble else 'TH_OFF',
+                step.dx, step.dy, step.speed_r, step.speed_l, step.angle, magnet_value(step.magnet)))
+        lines.append('};')
+        lines.append('static const RoutePose RoutePoses%s[STEPS_ROUTE_%s] = {' % (route_id, route_id))
+        lines.append('//{X, Y, Heading} at the end of step')
+        for index, pose in enumerate(pmb_poses(route)):
+            lines.append('{%d, %d, %d}, //%d' % (pose + (index,)))
+        lines.append('};')
+    lines += ['', '', 'static const RouteData Routes[Route_NumOf]   = ', '    {']
+    for route_id in ids:
+        lines.append('     [Route%s] = {.ID = Route%s, .RepeatCount = %d, .CurrentStepCount = 0 , .StepCount = STEPS_ROUTE_%s, .Step = &RouteSteps%s[0], .Pose = &RoutePoses%s[0]},' % (
+            route_id, route_id, routes[route_id].repeat, route_id, route_id, route_id))
+    lines += [
+        '    };',
+        '',
+        'void Route_SetRoutePointer(RouteData* Data ,Route_ID RouteSelected, uint8_t Offset){',
+        '    memcpy(Data, &Routes[RouteSelected], sizeof(RouteData));',
+        '    Data->Step += Offset; /* no 0 step on display, but here steps are from 0 */',
+        '    Data->Pose += Offset;',
+        '    Data->CurrentStepCount = Offset;',
+        '}',
+        '',
+    ]
+    return '\n'.join(lines)
+
+
+def generate_imu(routes):
+    ids = BOARD_ROUTE_IDS['imu']
+    lines = ['/*', ' * Routes.c', ' *']
+    lines += generated_notice([routes[route_id].path for route_id in ids])
+    lines += [' */', '', '', '#include "RoutesDataTypes.h"', '#include "RouteStore.h"', '', '#include <string.h>', '']
+    for route_id in ids:
+        route = routes[route_id]
+        steps, magnets, points = imu_geometry(route)
+        lines.append('')
+        if route.name:
+            lines.append('//%s' % route.name)
+        lines.append('#define STEPS_ROUTE_%s %d' % (route_id, len(steps)))
+        lines.append('#define POINTS_ROUTE_%s %d' % (route_id, len(points)))
+        lines.append('static const RouteStep RouteSteps%s[STEPS_ROUTE_%s] =' % (route_id, route_id))
+        lines.append('{')
+        lines.append('//\t\tspeed, thumble, length, heading, magnet')
+        for index, step in enumerate(steps):
+            lines.append(('\t\t{%d, %s, %d, %d, %s},//%d %s' % (
+                step['speed'], 'TH_ON' if step['thumble'] else 'TH_OFF', step['length'],
+                step['heading'], magnet_value(step['magnet']), index, step['note'])).rstrip())
+        lines.append('};')
+        lines.append('')
+        lines.append('static const RoutePoint RouteMagnets%s[STEPS_ROUTE_%s + 1] =' % (route_id, route_id))
+        lines.append('{')
+        lines += ['\t\t{%d, %d, %d},' % point for point in magnets]
+        lines.append('};')
+        lines.append('')
+        lines.append('static const RoutePoint RoutePoints%s[POINTS_ROUTE_%s] =' % (route_id, route_id))
+        lines.append('{')
+        lines += ['\t\t{%d, %d, %d},' % point for point in points]
+        lines.append('};')
+    lines += ['', '', 'static const RouteData Routes[Route_NumOf]   =', '    {']
+    entries = []
+    for route_id in ids:
+        entries.append('     [Route%s] = {.ID = Route%s, .StepCount = STEPS_ROUTE_%s, .PointCount = POINTS_ROUTE_%s, '
+                       '.Step = &RouteSteps%s[0], .Magnet = &RouteMagnets%s[0], .Point = &RoutePoints%s[0]}' % (
+                           (route_id,) * 7))
+    lines.append(',\n'.join(entries))
+    lines += [
+        '    };',
+        '',
+        'void Route_SetRoutePointer(RouteData* Data ,Route_ID RouteSelected){',
+        '    /* Uploaded routes replace compiled in routes with the same ID */',
+        '    if(RouteStore_GetRoute(RouteSelected, Data))',
+        '        return;',
+        '    if(RouteSelected >= Route_NumOf)',
+        '        RouteSelected = RouteA;',
+        '    memcpy(Data, &Routes[RouteSelected], sizeof(RouteData));',
+        '}',
+        '',
+    ]
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile Melkens route descriptions to board route tables')
+    parser.add_argument('--routes', default=ROUTES_DIR, help='route description directory')
+    parser.add_argument('--pmb', default=PMB_OUTPUT, help='generated PMB Routes.c')
+    parser.add_argument('--imu', default=IMU_OUTPUT, help='generated IMU Routes.c')
+    parser.add_argument('--check', action='store_true', help='only check that generated files are up to date')
+    args = parser.parse_args()
+
+    try:
+        routes = load_routes(args.routes)
+        outputs = [(args.pmb, generate_pmb(routes['pmb'])), (args.imu, generate_imu(routes['imu']))]
+    except RouteError as error:
+        print('error: %s' % error, file=sys.stderr)
+        return 1
+
+    status = 0
+    for path, text in outputs:
+        current = None
+        if os.path.exists(path):
+            with open(path, newline='') as file:
+                current = file.read()
+        if current == text:
+            continue
+        if args.check:
+            print('%s is not up to date' % path, file=sys.stderr)
+            status = 1
+        else:
+            with open(path, 'w', newline='') as file:
+                file.write(text)
+            print('generated %s' % path)
+    return status
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,566 @@
+#!/usr/bin/env python3
+"""
+Route store packer.
+
+Packs IMU routes into the binary route store image that is uploaded at run
+time over the ESP (POST /routes or MQTT /moover/routes) into the IMU flash
+route store, see Melkens_IMU/Core/Inc/RouteStore.h for the layout. Routes
+are described and validated the same way as for route_compiler.py.
+
+Usage:
+  route_pack.py pack [-o routes.bin] [route files]
+        pack given routes, by default all IMU routes from Melkens/Routes
+  route_pack.py info routes.bin
+        check image and list its routes
+  route_pack.py simulate routes.bin [--baud 115200] [--window 2] [--ber 0]
+        simulate upload ESP -> IMU over UART: frame timing, IMU single
+        receive buffer, flash erase/program stalls, acknowledge latency and
+        bit errors, and report upload time and throughput
+  route_pack.py check [routes.bin]
+        upload cases on IMU RouteStore.c: A/B slots, CRC error, lock during
+        data and commit, dual bank flash, erases per block
+
+simulate and check build Melkens_IMU/Core/Src/RouteStore.c with the host C
+compiler (--cc, --cflags) against the flash model route_store_flash.c and
+load it with ctypes, the IMU side of the upload is the IMU code. The ESP
+side of simulate follows RouteUpload.cpp.
+
+Route id in the store is the rootNumber sent by ESP: letter A..Z is 0..25
+(A..D replace compiled in routes), number is used as is.
+"""
+
+import argparse
+import ctypes
+import glob
+import heapq
+import os
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+
+import route_compiler as rc
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+IMU_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_IMU', 'Core')
+LIB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib')
+
+sys.path.insert(0, os.path.join(TOOL_DIR, '..', 'MessageGen'))
+import messages  # noqa: E402
+
+# RouteStore.h
+STORE_MAGIC = 0x5354524D
+STORE_VERSION = 1
+STORE_ADDRESS = 0x08030000
+STORE_SLOT_SIZE = 0x8000
+STORE_MAX_ROUTES = 64
+HEADER = struct.Struct('<IHHIIH12sH')
+ENTRY = struct.Struct('<HHHHI')
+STEP = struct.Struct('<hHHhh')
+POINT = struct.Struct('<hhH')
+MAGNET_NONE = 0x7FFF
+TH_ON = 1500
+
+# MessageTypes.h
+BLOCK_DATA_SIZE = messages.ROUTE_BLOCK_DATA_SIZE
+BLOCK_BEGIN, BLOCK_DATA = messages.ROUTE_BLOCK_BEGIN, messages.ROUTE_BLOCK_DATA
+BLOCK_COMMIT, BLOCK_ABORT = messages.ROUTE_BLOCK_COMMIT, messages.ROUTE_BLOCK_ABORT
+UPLOAD_IDLE, UPLOAD_RECEIVING, UPLOAD_DONE = messages.ROUTE_UPLOAD_IDLE, messages.ROUTE_UPLOAD_RECEIVING, messages.ROUTE_UPLOAD_DONE
+UPLOAD_ERROR_BUSY, UPLOAD_ERROR_HEADER = messages.ROUTE_UPLOAD_ERROR_BUSY, messages.ROUTE_UPLOAD_ERROR_HEADER
+UPLOAD_ERROR_FLASH, UPLOAD_ERROR_CRC = messages.ROUTE_UPLOAD_ERROR_FLASH, messages.ROUTE_UPLOAD_ERROR_CRC
+ROUTE_BLOCK = struct.Struct('<BBH%ds' % BLOCK_DATA_SIZE)
+ESP2IMU_FRAME_SIZE = messages.ESP2IMU_FRAME_SIZE
+IMU2ESP_FRAME_SIZE = messages.IMU2ESP_FRAME_SIZE
+
+STORE_ROUTE_IDS = [chr(ord('A') + index) for index in range(26)] + [str(number) for number in range(256)]
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/MODBUS, same as Melkens_Lib CRC16"""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def store_id(route):
+    return int(route.id) if route.id.isdigit() else ord(route.id) - ord('A')
+
+
+def load_store_routes(paths):
+    routes = []
+    for path in paths:
+        route = rc.load_csv(path) if path.endswith('.csv') else rc.load_yaml(path)
+        rc.validate(route, {'pmb': rc.BOARD_ROUTE_IDS['pmb'], 'imu': STORE_ROUTE_IDS})
+        if 'imu' not in route.boards:
+            route.error('not an imu route')
+        routes.append(route)
+    ids = [store_id(route) for route in routes]
+    for route in routes:
+        if ids.count(store_id(route)) > 1:
+            route.error('route id %s is used more than once' % route.id)
+    if not 0 < len(routes) <= STORE_MAX_ROUTES:
+        raise rc.RouteError('route store holds 1 .. %d routes' % STORE_MAX_ROUTES)
+    return sorted(routes, key=store_id)
+
+
+def pack(routes):
+    entries = b''
+    data = b''
+    data_offset = ENTRY.size * len(routes)
+    for route in routes:
+        steps, magnets, points = rc.imu_geometry(route)
+        blob = b''.join(STEP.pack(step['speed'], TH_ON if step['thumble'] else 0, step['length'], step['heading'],
+                                  MAGNET_NONE if step['magnet'] is None else int(round(step['magnet'] * rc.MAGNET_UNIT_PER_CM)))
+                        for step in steps)
+        blob += b''.join(POINT.pack(*point) for point in magnets + points)
+        entries += ENTRY.pack(store_id(route), len(steps), len(points), 0, data_offset + len(data))
+        data += blob
+    payload = entries + data
+    if HEADER.size + len(payload) > STORE_SLOT_SIZE:
+        raise rc.RouteError('route store image %d B does not fit in %d B slot' % (HEADER.size + len(payload), STORE_SLOT_SIZE))
+    header = HEADER.pack(STORE_MAGIC, STORE_VERSION, len(routes), 0, len(payload), crc16(payload), bytes(12), 0)
+    header = header[:-2] + struct.pack('<H', crc16(header[:-2]))
+    return header + payload
+
+
+def unpack(image):
+    """Checks image the same way as IMU RouteStore, returns header fields and entries"""
+    if len(image) < HEADER.size:
+        raise rc.RouteError('image too short')
+    magic, version, count, sequence, size, payload_crc, _, header_crc = HEADER.unpack_from(image)
+    if magic != STORE_MAGIC or version != STORE_VERSION:
+        raise rc.RouteError('not a route store image')
+    if header_crc != crc16(image[:HEADER.size - 2]):
+        raise rc.RouteError('header CRC error')
+    if not 0 < count <= STORE_MAX_ROUTES or size != len(image) - HEADER.size or size > STORE_SLOT_SIZE - HEADER.size:
+        raise rc.RouteError('invalid header')
+    payload = image[HEADER.size:]
+    if payload_crc != crc16(payload):
+        raise rc.RouteError('payload CRC error')
+    entries = []
+    for index in range(count):
+        route_id, step_count, point_count, _, offset = ENTRY.unpack_from(payload, index * ENTRY.size)
+        length = step_count * STEP.size + (step_count + 1 + point_count) * POINT.size
+        if not step_count or not point_count or offset & 1 or offset + length > size:
+            raise rc.RouteError('invalid entry %d' % index)
+        entries.append((route_id, step_count, point_count, offset, length))
+    return size, entries
+
+
+def build_library(cc, cflags, directory):
+    output = os.path.join(directory, 'routestore.so')
+    subprocess.check_call([cc, '-std=gnu99'] + cflags.split() + [
+        '-shared', '-fPIC', '-o', output,
+        '-I' + os.path.join(IMU_DIR, 'Inc'), '-I' + os.path.join(LIB_DIR, 'Types'), '-I' + os.path.join(LIB_DIR, 'CRC16'),
+        os.path.join(IMU_DIR, 'Src', 'RouteStore.c'), os.path.join(LIB_DIR, 'CRC16', 'CRC16.c'),
+        os.path.join(TOOL_DIR, 'route_store_flash.c')])
+    library = ctypes.CDLL(output)
+    library.FlashModel_Init.restype = ctypes.c_bool
+    library.FlashModel_SetSingleBank.argtypes = [ctypes.c_bool]
+    library.RouteStore_ProcessBlock.argtypes = [ctypes.c_char_p, ctypes.c_bool]
+    library.RouteStore_GetUploadState.restype = ctypes.c_uint8
+    library.RouteStore_GetUploadAck.restype = ctypes.c_uint16
+    library.RouteStore_GetRouteCount.restype = ctypes.c_uint8
+    library.RouteStore_GetRoute.argtypes = [ctypes.c_uint16, ctypes.c_void_p]
+    library.RouteStore_GetRoute.restype = ctypes.c_bool
+    library.CRC16_Init()
+    if not library.FlashModel_Init():
+        raise OSError('cannot map route store at 0x%08X' % STORE_ADDRESS)
+    return library
+
+
+class RouteStore:
+    """IMU RouteStore.c on the flash model, starting from erased flash"""
+
+    def __init__(self, library):
+        self.library = library
+        library.FlashModel_SetSingleBank(True)
+        library.FlashModel_EraseAll()
+        library.RouteStore_Init()
+
+    def counter(self, name):
+        return ctypes.c_uint32.in_dll(self.library, 'FlashModel_' + name).value
+
+    def block(self, command, sequence=0, data=b'', locked=False):
+        """ConnectivityHandler: one received block, returns (erases, double words) it took"""
+        erases, words = self.counter('Erases'), self.counter('DoubleWords')
+        self.library.RouteStore_ProcessBlock(ROUTE_BLOCK.pack(command, len(data), sequence, data), locked)
+        return self.counter('Erases') - erases, self.counter('DoubleWords') - words
+
+    def state(self):
+        return self.library.RouteStore_GetUploadState(), self.library.RouteStore_GetUploadAck()
+
+    def upload(self, image, locked_commit=False):
+        """Whole upload without losses, returns the upload state"""
+        payload = image[HEADER.size:]
+        self.block(BLOCK_BEGIN, 0, image[:HEADER.size])
+        blocks = (len(payload) + BLOCK_DATA_SIZE - 1) // BLOCK_DATA_SIZE
+        for sequence in range(blocks):
+            self.block(BLOCK_DATA, sequence, payload[sequence * BLOCK_DATA_SIZE:(sequence + 1) * BLOCK_DATA_SIZE])
+        self.block(BLOCK_COMMIT, blocks, locked=locked_commit)
+        return self.state()[0]
+
+    def reset(self):
+        """IMU restart, routes as found in flash: (route count, payloads of the slots)"""
+        self.library.RouteStore_Init()
+        return self.library.RouteStore_GetRouteCount()
+
+    def slot_payload(self, slot, size):
+        return ctypes.string_at(STORE_ADDRESS + slot * STORE_SLOT_SIZE + HEADER.size, size)
+
+    def has_routes(self, image):
+        _, entries = unpack(image)
+        data = ctypes.create_string_buffer(64)
+        return self.reset() == len(entries) and all(self.library.RouteStore_GetRoute(entry[0], data) for entry in entries)
+
+
+class UploadSimulation:
+    """ESP RouteUpload.cpp and IMU RouteStore.c over simulated UART"""
+
+    ESP_PERIOD = 10.0           # [ms] ESP 10ms time base
+    CONTROL_PERIOD = 100.0      # [ms] Esp2ImuFrame control frames
+    RETRIES = 20                # ROUTE_UPLOAD_RETRIES
+
+    def __init__(self, image, args, library):
+        self.library = library
+        self.image = image
+        self.header = image[:HEADER.size]
+        self.payload = image[HEADER.size:]
+        self.blocks = (len(self.payload) + BLOCK_DATA_SIZE - 1) // BLOCK_DATA_SIZE
+        self.byte_time = 10.0 * 1000.0 / args.baud      # 8N1
+        self.window = args.window
+        self.timeout = args.timeout
+        self.status_period = args.status_period
+        self.erase_time = args.erase_time
+        self.program_time = args.program_time
+        self.ber = args.ber
+        self.random = random.Random(args.seed)
+        self.stats = dict((key, 0) for key in ('frames', 'blocks', 'resent', 'lost', 'crc_errors', 'status_lost', 'erases',
+                                               'max_erases'))
+
+    def corrupted(self, size):
+        return self.ber > 0 and self.random.random() < 1.0 - (1.0 - self.ber) ** (size * 10)
+
+    # --- ESP side ---
+    def esp_send(self, now, frame):
+        start = max(now, self.esp_line_free)
+        self.esp_line_free = start + ESP2IMU_FRAME_SIZE * self.byte_time
+        self.stats['frames'] += 1
+        self.push(self.esp_line_free, 'imu_rx', frame)
+
+    def esp_block(self, now, command, sequence=0):
+        if command == BLOCK_DATA:
+            self.stats['blocks'] += 1
+            if sequence in self.sent:
+                self.stats['resent'] += 1
+            self.sent.add(sequence)
+        self.esp_send(now, ('route', command, sequence))
+
+    def esp_timeout(self, now):
+        if now - self.last_progress < self.timeout:
+            return False
+        self.last_progress = now
+        self.retries += 1
+        if self.retries > self.RETRIES:
+            self.step = 'failed'
+            return False
+        return True
+
+    def esp_progress(self, now):
+        self.last_progress = now
+        self.retries = 0
+
+    def esp_perform(self, now):
+        received = bool(self.esp_status_queue)
+        if received:
+            self.imu_status = self.esp_status_queue.pop(0)
+        state, ack = self.imu_status
+        if self.step == 'begin':
+            if received and state == UPLOAD_RECEIVING and ack == 0:
+                self.step = 'data'
+                self.esp_progress(now)
+            elif self.esp_timeout(now):
+                if state >= UPLOAD_ERROR_BUSY:
+                    self.step = 'failed'
+                else:
+                    self.esp_block(now, BLOCK_BEGIN)
+        elif self.step == 'data':
+            if received:
+                if state != UPLOAD_RECEIVING:
+                    self.step = 'failed'
+                    return
+                if ack > self.acked:
+                    self.acked = ack
+                    self.esp_progress(now)
+            if self.acked >= self.blocks:
+                self.step = 'commit'
+                self.esp_block(now, BLOCK_COMMIT, self.blocks)
+                return
+            if self.esp_timeout(now) or self.next_block < self.acked:
+                self.next_block = self.acked
+            while self.step == 'data' and self.next_block < self.blocks and self.next_block < self.acked + self.window:
+                self.esp_block(now, BLOCK_DATA, self.next_block)
+                self.next_block += 1
+        elif self.step == 'commit':
+            if received and state == UPLOAD_DONE:
+                self.step = 'done'
+                self.done_time = now
+            elif received and state != UPLOAD_RECEIVING:
+                self.step = 'failed'
+            elif self.esp_timeout(now):
+                self.esp_block(now, BLOCK_COMMIT, self.blocks)
+
+    # --- IMU side ---
+    def imu_rx(self, now, frame):
+        # DMA is stopped after each frame until main loop reloads it
+        if not self.imu_dma_enabled:
+            self.stats['lost'] += 1
+            return
+        self.imu_dma_enabled = False
+        self.imu_pending = None if self.corrupted(ESP2IMU_FRAME_SIZE) else frame
+        if self.imu_pending is None:
+            self.stats['crc_errors'] += 1
+        self.push(max(now, self.imu_busy_until), 'imu_process', None)
+
+    def imu_process(self, now):
+        frame = self.imu_pending
+        self.imu_pending = None
+        self.imu_dma_enabled = True     # reloaded before flash write
+        if frame is None or frame[0] != 'route':
+            return
+        _, command, sequence = frame
+        if command == BLOCK_BEGIN:
+            data = self.header
+        elif command == BLOCK_DATA:
+            data = self.payload[sequence * BLOCK_DATA_SIZE:(sequence + 1) * BLOCK_DATA_SIZE]
+        else:
+            data = b''
+        # flash operations stall the main loop, reception is already reloaded
+        erases, words = self.store.block(command, sequence, data)
+        self.stats['erases'] += erases
+        self.stats['max_erases'] = max(self.stats['max_erases'], erases)
+        self.imu_busy_until = now + erases * self.erase_time + words * self.program_time
+
+    def imu_status_tx(self, now):
+        snapshot = self.store.state()
+        arrival = now + IMU2ESP_FRAME_SIZE * self.byte_time
+        if self.corrupted(IMU2ESP_FRAME_SIZE):
+            self.stats['status_lost'] += 1
+        else:
+            self.push(arrival, 'esp_status', snapshot)
+        # status is sent from IMU main loop, delayed by flash stall
+        self.push(max(now, self.imu_busy_until) + self.status_period, 'imu_status', None)
+
+    # --- event loop ---
+    def push(self, time, kind, data):
+        self.sequence += 1
+        heapq.heappush(self.events, (time, self.sequence, kind, data))
+
+    def run(self, limit=600000.0):
+        self.events, self.sequence = [], 0
+        self.esp_line_free = 0.0
+        self.esp_status_queue = []
+        self.imu_status = (UPLOAD_IDLE, 0)
+        self.store = RouteStore(self.library)
+        self.imu_dma_enabled, self.imu_pending, self.imu_busy_until = True, None, 0.0
+        self.step, self.acked, self.next_block, self.sent = 'begin', 0, 0, set()
+        self.done_time = None
+
+        self.esp_block(0.0, BLOCK_BEGIN)
+        self.esp_progress(0.0)
+        self.push(self.ESP_PERIOD, 'esp_tick', None)
+        self.push(self.CONTROL_PERIOD, 'esp_control', None)
+        self.push(self.random.uniform(0, self.status_period), 'imu_status', None)
+
+        while self.events and self.step not in ('done', 'failed'):
+            now, _, kind, data = heapq.heappop(self.events)
+            if now > limit:
+                break
+            if kind == 'esp_tick':
+                self.esp_perform(now)
+                self.push(now + self.ESP_PERIOD, 'esp_tick', None)
+            elif kind == 'esp_control':
+                self.esp_send(now, ('control',))
+                self.push(now + self.CONTROL_PERIOD, 'esp_control', None)
+            elif kind == 'esp_status':
+                self.esp_status_queue.append(data)
+            elif kind == 'imu_rx':
+                self.imu_rx(now, data)
+            elif kind == 'imu_process':
+                self.imu_process(now)
+            elif kind == 'imu_status':
+                self.imu_status_tx(now)
+        return self.step == 'done' and self.store.slot_payload(0, len(self.payload)) == self.payload and \
+            self.store.has_routes(self.image)
+
+
+def command_pack(args):
+    paths = args.routes or sorted(path for path in glob.glob(os.path.join(rc.ROUTES_DIR, 'IMU_*.*')))
+    image = pack(load_store_routes(paths))
+    with open(args.output, 'wb') as file:
+        file.write(image)
+    print('%s: %d routes, %d B' % (args.output, struct.unpack_from('<H', image, 6)[0], len(image)))
+    return 0
+
+
+def command_info(args):
+    with open(args.image, 'rb') as file:
+        image = file.read()
+    size, entries = unpack(image)
+    print('%s: %d routes, payload %d B, slot usage %.1f %%' % (args.image, len(entries), size,
+                                                               100.0 * (size + HEADER.size) / STORE_SLOT_SIZE))
+    for route_id, steps, points, offset, length in entries:
+        print('  id %3d  steps %4d  points %5d  offset %6d  %6d B' % (route_id, steps, points, offset, length))
+    return 0
+
+
+def command_simulate(args):
+    with open(args.image, 'rb') as file:
+        image = file.read()
+    unpack(image)
+    with tempfile.TemporaryDirectory() as directory:
+        simulation = UploadSimulation(image, args, build_library(args.cc, args.cflags, directory))
+        ok = simulation.run()
+    stats = simulation.stats
+    line = 1000.0 / (10.0 * 1000.0 / args.baud)     # [B/s] raw line rate
+    print('image %d B, %d blocks of %d B, frame %d B, baud %d, window %d' % (
+        len(image), simulation.blocks, BLOCK_DATA_SIZE, ESP2IMU_FRAME_SIZE, args.baud, args.window))
+    print('frames %d, data blocks %d, resent %d, lost in busy receiver %d, CRC errors %d, lost status %d, page erases %d '
+          '(at most %d per block)' % (stats['frames'], stats['blocks'], stats['resent'], stats['lost'], stats['crc_errors'],
+                                      stats['status_lost'], stats['erases'], stats['max_erases']))
+    if not ok:
+        print('upload FAILED (%s)' % simulation.step)
+        return 1
+    seconds = simulation.done_time / 1000.0
+    throughput = len(image) / seconds
+    print('upload done in %.2f s, %.0f B/s, %.1f %% of raw line rate %.0f B/s' % (
+        seconds, throughput, 100.0 * throughput / line, line))
+    if args.min_throughput and throughput < args.min_throughput:
+        print('throughput below required %d B/s' % args.min_throughput)
+        return 1
+    return 0
+
+
+def check_cases(store, image):
+    """(name, ok, what) of every case, each starts from erased flash"""
+    payload = image[HEADER.size:]
+    broken = image[:-1] + bytes([image[-1] ^ 1])
+    blocks = (len(payload) + BLOCK_DATA_SIZE - 1) // BLOCK_DATA_SIZE
+    results = []
+
+    store.__init__(store.library)
+    ok = store.upload(image) == UPLOAD_DONE and store.has_routes(image) and store.slot_payload(0, len(payload)) == payload
+    results.append(('upload', ok, 'routes not stored'))
+
+    store.__init__(store.library)
+    store.upload(image)
+    ok = store.upload(image) == UPLOAD_DONE and store.slot_payload(1, len(payload)) == payload
+    store.upload(broken)
+    ok = ok and store.slot_payload(0, len(payload)) == broken[HEADER.size:] and store.has_routes(image)
+    results.append(('slots_alternate', ok, 'second upload not in other slot or broken third one taken'))
+
+    store.__init__(store.library)
+    store.upload(image)
+    ok = store.upload(broken) == UPLOAD_ERROR_CRC and store.has_routes(image)
+    results.append(('crc_error_keeps_routes', ok, 'routes lost by broken upload'))
+
+    # route starts half way, the rest comes unlocked again
+    store.__init__(store.library)
+    store.block(BLOCK_BEGIN, 0, image[:HEADER.size])
+    for sequence in range(blocks):
+        if sequence == blocks // 2:
+            accesses = store.counter('Accesses')
+        store.block(BLOCK_DATA, sequence, payload[sequence * BLOCK_DATA_SIZE:(sequence + 1) * BLOCK_DATA_SIZE],
+                    sequence == blocks // 2)
+    store.block(BLOCK_COMMIT, blocks)
+    ok = store.state()[0] == UPLOAD_ERROR_BUSY and store.counter('Accesses') == accesses and store.reset() == 0
+    results.append(('locked_during_data', ok, 'flash written after lock'))
+
+    store.__init__(store.library)
+    ok = store.upload(image, locked_commit=True) == UPLOAD_ERROR_BUSY and store.reset() == 0
+    results.append(('locked_at_commit', ok, 'header written while locked'))
+
+    # slot pages are inaccessible in dual bank mode, a read ends the process
+    store.__init__(store.library)
+    store.upload(image)
+    store.library.FlashModel_SetSingleBank(False)
+    store.library.FlashModel_ClearCounters()
+    count = store.reset()
+    erases, words = store.block(BLOCK_BEGIN, 0, image[:HEADER.size])
+    ok = count == 0 and store.state()[0] == UPLOAD_ERROR_FLASH and store.counter('Accesses') == 0
+    results.append(('dual_bank_disabled', ok, 'store used with DBANK set'))
+
+    store.__init__(store.library)
+    store.block(BLOCK_BEGIN, 0, image[:HEADER.size])
+    most = max(store.block(BLOCK_DATA, sequence, payload[sequence * BLOCK_DATA_SIZE:(sequence + 1) * BLOCK_DATA_SIZE])[0]
+               for sequence in range(blocks))
+    results.append(('one_erase_per_block', most <= 1, '%d page erases in one block' % most))
+    return results
+
+
+def command_check(args):
+    if args.image:
+        with open(args.image, 'rb') as file:
+            image = file.read()
+    else:
+        image = pack(load_store_routes(sorted(glob.glob(os.path.join(rc.ROUTES_DIR, 'IMU_*.*')))))
+    unpack(image)
+    with tempfile.TemporaryDirectory() as directory:
+        store = RouteStore(build_library(args.cc, args.cflags, directory))
+        results = check_cases(store, image)
+    failed = False
+    for name, ok, what in results:
+        print('%-28s %s' % (name, 'ok' if ok else 'FAIL ' + what))
+        failed |= not ok
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack Melkens routes for run time upload to IMU route store')
+    commands = parser.add_subparsers(dest='command')
+    commands.required = True
+
+    parser_pack = commands.add_parser('pack', help='build route store image')
+    parser_pack.add_argument('routes', nargs='*', help='route description files, default all IMU routes')
+    parser_pack.add_argument('-o', '--output', default='routes.bin')
+    parser_pack.set_defaults(function=command_pack)
+
+    parser_info = commands.add_parser('info', help='check route store image')
+    parser_info.add_argument('image')
+    parser_info.set_defaults(function=command_info)
+
+    parser_simulate = commands.add_parser('simulate', help='simulate upload over ESP -> IMU UART')
+    parser_simulate.add_argument('image')
+    parser_simulate.add_argument('--baud', type=int, default=115200)
+    parser_simulate.add_argument('--window', type=int, default=2, help='blocks sent ahead of acknowledge')
+    parser_simulate.add_argument('--timeout', type=float, default=100.0, help='[ms] resend timeout without progress')
+    parser_simulate.add_argument('--status-period', type=float, default=10.0, help='[ms] IMU status frame period')
+    parser_simulate.add_argument('--erase-time', type=float, default=22.0, help='[ms] flash page erase')
+    parser_simulate.add_argument('--program-time', type=float, default=0.09, help='[ms] flash double word program')
+    parser_simulate.add_argument('--ber', type=float, default=0.0, help='bit error rate')
+    parser_simulate.add_argument('--seed', type=int, default=1)
+    parser_simulate.add_argument('--min-throughput', type=int, default=0, help='[B/s] fail below this throughput')
+    parser_simulate.set_defaults(function=command_simulate)
+
+    parser_check = commands.add_parser('check', help='upload cases on IMU RouteStore.c')
+    parser_check.add_argument('image', nargs='?', help='route store image, default all IMU routes packed')
+    parser_check.set_defaults(function=command_check)
+
+    for subparser in (parser_simulate, parser_check):
+        subparser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+        subparser.add_argument('--cflags', default='-O2')
+
+    args = parser.parse_args()
+    try:
+        return args.function(args)
+    except (rc.RouteError, OSError, subprocess.CalledProcessError) as error:
+        print('error: %s' % error, file=sys.stderr)
+        return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
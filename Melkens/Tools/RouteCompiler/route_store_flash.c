@@ -0,0 +1,107 @@
+/*
+ * Flash model of route_pack.py simulate and check, built together with
+ * Melkens_IMU/Core/Src/RouteStore.c into a library loaded with ctypes.
+ *
+ * Implements FlashPage.h on the route store region mapped at its IMU
+ * address. Programming follows the STM32G4: a double word is written once
+ * after erase, writing it again fails. Erases and programmed double words
+ * are counted for the stall time of the IMU main loop. In dual bank mode
+ * the region is not accessible at all.
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <sys/mman.h>
+#include "FlashPage.h"
+#include "RouteStore.h"
+
+#define FLASH_MODEL_SIZE    (dROUTE_STORE_SLOT_SIZE * dROUTE_STORE_SLOT_NUMOF)
+
+static uint8_t *Flash;
+static bool SingleBank = true;
+uint32_t FlashModel_Erases;
+uint32_t FlashModel_DoubleWords;
+uint32_t FlashModel_Accesses;       /* erase and program calls, also refused ones */
+
+/* false when the route store address cannot be mapped in this process */
+bool FlashModel_Init(void)
+{
+    void *map = mmap((void *)dROUTE_STORE_ADDRESS, FLASH_MODEL_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (map != (void *)dROUTE_STORE_ADDRESS) {
+        return false;
+    }
+    Flash = map;
+    memset(Flash, 0xFF, FLASH_MODEL_SIZE);
+    return true;
+}
+
+void FlashModel_EraseAll(void)
+{
+    memset(Flash, 0xFF, FLASH_MODEL_SIZE);
+}
+
+/* Dual bank: the region is not mapped on the IMU, here any access faults */
+void FlashModel_SetSingleBank(bool singleBank)
+{
+    SingleBank = singleBank;
+    mprotect(Flash, FLASH_MODEL_SIZE, singleBank ? (PROT_READ | PROT_WRITE) : PROT_NONE);
+}
+
+void FlashModel_ClearCounters(void)
+{
+    FlashModel_Erases = 0;
+    FlashModel_DoubleWords = 0;
+    FlashModel_Accesses = 0;
+}
+
+static bool FlashModel_Contains(uint32_t address, uint32_t length)
+{
+    return address >= dROUTE_STORE_ADDRESS && length <= FLASH_MODEL_SIZE &&
+           address - dROUTE_STORE_ADDRESS <= FLASH_MODEL_SIZE - length;
+}
+
+bool FlashPage_IsSingleBank(void)
+{
+    return SingleBank;
+}
+
+bool FlashPage_Erase(uint32_t Address)
+{
+    uint32_t page = Address & ~(dFLASH_PAGE_SIZE - 1);
+
+    FlashModel_Accesses++;
+    if (!SingleBank || !FlashModel_Contains(page, dFLASH_PAGE_SIZE)) {
+        return false;
+    }
+    memset(&Flash[page - dROUTE_STORE_ADDRESS], 0xFF, dFLASH_PAGE_SIZE);
+    FlashModel_Erases++;
+    return true;
+}
+
+bool FlashPage_Program(uint32_t Address, const uint8_t* Data, uint32_t Length)
+{
+    uint8_t doubleWord[8];
+    uint8_t *target;
+    uint32_t chunk;
+
+    FlashModel_Accesses++;
+    if (!SingleBank || (Address & 7U) != 0 || !FlashModel_Contains(Address, (Length + 7U) & ~7U)) {
+        return false;
+    }
+    for (uint32_t offset = 0; offset < Length; offset += sizeof(doubleWord)) {
+        chunk = (Length - offset < sizeof(doubleWord)) ? Length - offset : sizeof(doubleWord);
+        memset(doubleWord, 0xFF, sizeof(doubleWord));
+        memcpy(doubleWord, &Data[offset], chunk);
+        target = &Flash[Address + offset - dROUTE_STORE_ADDRESS];
+        for (uint8_t i = 0; i < sizeof(doubleWord); i++) {
+            if (target[i] != 0xFF) {
+                return false;   /* PROGERR, not erased */
+            }
+        }
+        memcpy(target, doubleWord, sizeof(doubleWord));
+        FlashModel_DoubleWords++;
+    }
+    return memcmp((const void *)(uintptr_t)Address, Data, Length) == 0;
+}
@@ -0,0 +1,487 @@
+#!/usr/bin/env python3
+"""
+Scope of IMU variables on the debug UART (Melkens_Lib/Scope).
+
+Modules on the IMU register variables (gyro, AHRS angles, navigation pose
+and cross-track error, wheel setpoints, task execution times); this tool
+lists them, selects up to 8 with a sample period of 1 ms or more and
+receives the samples in DATA frames on USART3 (460800 8N1, both directions),
+between the BINLOG frames. The IMU refuses a selection that needs more of
+the line than its budget, INFO tells the bytes per second of a selection.
+
+Usage:
+  scope.py list --port /dev/ttyUSB0
+        registered variables, their types and the budget
+  scope.py record --port /dev/ttyUSB0 --channels imu.yaw,nav.xte [--rate 1000 | --period 1]
+                  [-o samples.csv] [--seconds 10] [--plot] [--formats Melkens_IMU.elf]
+        samples to CSV ("tick,seconds,<channels>"), a summary every second
+        (samples, gaps, last values), a live plot with matplotlib, log lines
+        decoded with the format table of binlog.py. Ctrl+C or --seconds stops
+        the scope. Port needs pyserial.
+  scope.py test [--cc cc] [--cflags "-Wall -Wextra -O2"]
+        builds scope_test.c with Scope.c and BinLog.c, runs a script of
+        commands, slow UART and skipped ticks through it and checks every
+        decoded sample against the variables, refused selections, lost
+        sample accounting and log frames in between, prints the cost per
+        sample.
+"""
+
+import argparse
+import csv
+import os
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+LIB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib')
+sys.path.insert(0, os.path.join(TOOL_DIR, '..', 'BinLog'))
+
+import binlog  # noqa: E402
+
+FRAME_SCOPE_DATA = 2
+FRAME_SCOPE_INFO = 3
+FRAME_SCOPE_LIST = 4
+FRAME_SCOPE_SELECT = 5
+
+SELECT_MAX = 8
+PERIOD_MAX = 1000
+FRAME_SIZE = 256
+FRAME_AGE = 50
+FRAME_OVERHEAD = binlog.FRAME_HEADER_SIZE + binlog.FRAME_CRC_SIZE
+COMMAND_PAYLOAD_SIZE = 4 + SELECT_MAX
+DATA_HEADER_SIZE = 8
+INFO_HEADER_SIZE = 24
+
+TYPES = {0x01: ('u8', '<B'), 0x02: ('u16', '<H'), 0x04: ('u32', '<I'),
+         0x11: ('i8', '<b'), 0x12: ('i16', '<h'), 0x14: ('i32', '<i'), 0x24: ('float', '<f')}
+STATUS = {0: 'ok', 1: 'bad channel', 2: 'bad period', 3: 'over budget'}
+
+BAUD = 460800
+INFO_TIMEOUT = 0.5      # [s] command is sent again
+INFO_RETRIES = 4
+
+
+def make_command(frame_type, sequence, period=0, channels=()):
+    payload = struct.pack('<HBB', period, len(channels), 0) + bytes(channels) + bytes(SELECT_MAX - len(channels))
+    body = struct.pack('<BBH', frame_type, sequence, len(payload)) + payload
+    return binlog.SYNC + body + struct.pack('<H', binlog.crc16(body))
+
+
+def type_size(channel_type):
+    return channel_type & 0x0F
+
+
+def selection_rate(sizes, period, ticks_per_second):
+    """Bytes per second of a selection as Scope_GetRate counts them."""
+    if not sizes or not period:
+        return 0
+    sample_size = sum(sizes)
+    per_frame = min((FRAME_SIZE - FRAME_OVERHEAD - DATA_HEADER_SIZE) // sample_size, -(-FRAME_AGE // period))
+    samples = -(-ticks_per_second // period)
+    frames = -(-samples // per_frame)
+    return samples * sample_size + frames * (FRAME_OVERHEAD + DATA_HEADER_SIZE)
+
+
+def parse_info(payload):
+    status, selection, period, count = struct.unpack_from('<BBHB', payload, 0)
+    registered, ticks, rate, budget = struct.unpack_from('<BHII', payload, 13)
+    channels = []
+    offset = INFO_HEADER_SIZE
+    while offset < len(payload) and len(channels) < registered:
+        end = payload.index(b'\0', offset + 1)
+        channels.append((payload[offset], payload[offset + 1:end].decode('ascii', 'replace')))
+        offset = end + 1
+    return {'status': status, 'selection': selection, 'period': period,
+            'selected': list(payload[5:5 + count]), 'registered': registered, 'ticks': ticks,
+            'rate': rate, 'budget': budget, 'channels': channels}
+
+
+class ScopeDecoder:
+    """Samples of DATA frames: (selection, tick, values), layout from INFO frames."""
+
+    def __init__(self):
+        self.info = None
+        self.layouts = {}       # selection -> (period, [struct format])
+        self.last_tick = {}     # selection -> tick of the last sample
+        self.gaps = 0           # samples missing between received ones
+        self.unknown = 0        # DATA frames of a selection without INFO
+
+    def decode_info(self, payload):
+        self.info = parse_info(payload)
+        if self.info['status'] == 0:
+            types = [self.info['channels'][index][0] if index < len(self.info['channels']) else 0x04
+                     for index in self.info['selected']]
+            self.layouts[self.info['selection']] = (self.info['period'], [TYPES.get(t, ('?', '<I'))[1] for t in types])
+        return self.info
+
+    def decode_data(self, payload):
+        selection, count, period, tick = struct.unpack_from('<BBHI', payload, 0)
+        layout = self.layouts.get(selection)
+        if layout is None:
+            self.unknown += 1
+            return []
+        formats = layout[1]
+        samples = []
+        offset = DATA_HEADER_SIZE
+        for index in range(count):
+            values = []
+            for format_string in formats:
+                values.append(struct.unpack_from(format_string, payload, offset)[0])
+                offset += struct.calcsize(format_string)
+            samples.append((selection, tick + index * period, values))
+        last = self.last_tick.get(selection)
+        if last is not None and samples and samples[0][1] > last + period:
+            self.gaps += (samples[0][1] - last) // period - 1
+        if samples:
+            self.last_tick[selection] = samples[-1][1]
+        return samples
+
+
+def open_port(args):
+    try:
+        import serial
+    except ImportError as error:
+        print('error: %s, install pyserial' % error, file=sys.stderr)
+        return None
+    return serial.Serial(args.port, args.baud, timeout=0.05)
+
+
+class Link:
+    """Frames of the port: INFO answers to commands, DATA and LOG for the caller."""
+
+    def __init__(self, port, decoder, on_frame=None):
+        self.port = port
+        self.decoder = decoder
+        self.parser = binlog.FrameParser()
+        self.on_frame = on_frame
+        self.sequence = 0
+
+    def poll(self):
+        infos = []
+        for frame_type, sequence, payload in self.parser.feed(self.port.read(4096)):
+            if frame_type == FRAME_SCOPE_INFO:
+                infos.append(self.decoder.decode_info(payload))
+            elif self.on_frame is not None:
+                self.on_frame(frame_type, sequence, payload)
+        return infos
+
+    def command(self, frame_type, period=0, channels=()):
+        for _ in range(INFO_RETRIES):
+            self.port.write(make_command(frame_type, self.sequence, period, channels))
+            self.sequence = (self.sequence + 1) & 0xFF
+            deadline = time.monotonic() + INFO_TIMEOUT
+            while time.monotonic() < deadline:
+                infos = self.poll()
+                if infos:
+                    return infos[-1]
+        return None
+
+
+def print_channels(info):
+    for index, (channel_type, name) in enumerate(info['channels']):
+        print('%3d  %-5s %s' % (index, TYPES.get(channel_type, ('?',))[0], name))
+    if len(info['channels']) < info['registered']:
+        print('%d more, names did not fit in INFO' % (info['registered'] - len(info['channels'])))
+    print('budget %d bytes/s, %d ticks/s' % (info['budget'], info['ticks']))
+
+
+def command_list(args):
+    port = open_port(args)
+    if port is None:
+        return 1
+    info = Link(port, ScopeDecoder()).command(FRAME_SCOPE_LIST)
+    if info is None:
+        print('error: no answer from IMU', file=sys.stderr)
+        return 1
+    print_channels(info)
+    return 0
+
+
+class Plot:
+    """Live plot of the last --window seconds, one axis per channel."""
+
+    def __init__(self, names, window):
+        import matplotlib.pyplot as pyplot
+        self.pyplot = pyplot
+        self.window = window
+        self.times = []
+        self.values = [[] for _ in names]
+        pyplot.ion()
+        self.figure, axes = pyplot.subplots(len(names), 1, sharex=True, squeeze=False)
+        self.lines = []
+        for axis, name in zip(axes[:, 0], names):
+            axis.set_ylabel(name)
+            self.lines.append(axis.plot([], [])[0])
+        self.axes = axes[:, 0]
+
+    def add(self, seconds, values):
+        self.times.append(seconds)
+        for column, value in zip(self.values, values):
+            column.append(value)
+
+    def draw(self):
+        if not self.times:
+            return
+        start = next(i for i, t in enumerate(self.times) if t >= self.times[-1] - self.window)
+        del self.times[:start]
+        for column in self.values:
+            del column[:start]
+        for line, axis, column in zip(self.lines, self.axes, self.values):
+            line.set_data(self.times, column)
+            axis.relim()
+            axis.autoscale_view()
+        self.pyplot.pause(0.001)
+
+
+def command_record(args):
+    port = open_port(args)
+    if port is None:
+        return 1
+    decoder = ScopeDecoder()
+    formats = binlog.load_formats(args.formats) if args.formats else None
+    log = binlog.LogDecoder(formats, args.clock) if formats else None
+
+    def on_frame(frame_type, sequence, payload):
+        if frame_type == FRAME_SCOPE_DATA:
+            pending.extend(decoder.decode_data(payload))
+        elif frame_type == binlog.FRAME_LOG and log is not None:
+            for seconds, text in log.decode(sequence, payload):
+                print('log ' + ('%.6f %s' % (seconds, text) if seconds is not None else text), file=sys.stderr)
+
+    pending = []
+    link = Link(port, decoder, on_frame)
+    info = link.command(FRAME_SCOPE_LIST)
+    if info is None:
+        print('error: no answer from IMU', file=sys.stderr)
+        return 1
+    names = [name for _, name in info['channels']]
+    wanted = args.channels.split(',')
+    missing = [name for name in wanted if name not in names]
+    if missing or len(wanted) > SELECT_MAX:
+        print('error: %s' % ('unknown channel ' + ', '.join(missing) if missing else 'more than %d channels' % SELECT_MAX),
+              file=sys.stderr)
+        print_channels(info)
+        return 1
+    channels = [names.index(name) for name in wanted]
+    period = args.period if args.period else max(1, round(info['ticks'] / args.rate))
+    rate = selection_rate([type_size(info['channels'][index][0]) for index in channels], period, info['ticks'])
+    info = link.command(FRAME_SCOPE_SELECT, period, channels)
+    if info is None or info['status'] != 0:
+        print('error: selection %s, %d of %d bytes/s' % (STATUS.get(info['status'], '?') if info else 'not answered',
+                                                        rate, info['budget'] if info else 0), file=sys.stderr)
+        return 1
+    selection = info['selection']
+    print('%d channels every %d ticks, %d of %d bytes/s' % (len(channels), period, info['rate'], info['budget']),
+          file=sys.stderr)
+
+    output = open(args.output, 'w', newline='') if args.output else None
+    writer = csv.writer(output) if output else None
+    if writer:
+        writer.writerow(['tick', 'seconds'] + wanted)
+    plot = Plot(wanted, args.window) if args.plot else None
+    samples = 0
+    last = None
+    start = time.monotonic()
+    next_summary = start + 1.0
+    try:
+        while args.seconds is None or time.monotonic() - start < args.seconds:
+            link.poll()
+            for sample_selection, tick, values in pending:
+                if sample_selection != selection:
+                    continue
+                seconds = tick / float(info['ticks'])
+                samples += 1
+                last = (tick, values)
+                if writer:
+                    writer.writerow([tick, '%.3f' % seconds] + values)
+                if plot:
+                    plot.add(seconds, values)
+            del pending[:]
+            if time.monotonic() >= next_summary:
+                next_summary += 1.0
+                if plot:
+                    plot.draw()
+                print('%d samples, %d gaps%s' % (samples, decoder.gaps, '' if last is None else ', tick %d: %s' % (
+                    last[0], ' '.join('%s=%.6g' % pair for pair in zip(wanted, last[1])))), file=sys.stderr)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.command(FRAME_SCOPE_SELECT)
+        if output:
+            output.close()
+    return 0
+
+
+def read_values(lines):
+    """Tick -> raw bits of every test variable."""
+    values = {}
+    for line in lines:
+        fields = line.split()
+        values[int(fields[0])] = [int(field, 16) for field in fields[1:]]
+    return values
+
+
+def raw_value(raw, channel_type):
+    size = type_size(channel_type)
+    return struct.unpack(TYPES[channel_type][1], struct.pack('<I', raw)[:size])[0]
+
+
+def command_test(args):
+    failed = False
+    names = ['u8', 'u16', 'u32', 'i8', 'i16', 'i32', 'f0', 'f1', 'f2', 'tick']
+    selections = [(1, [0, 1, 2, 3, 4, 9]), (1, [2, 5, 6, 7, 8, 9, 0, 4]), (3, [2, 5, 6, 7, 8, 9, 0, 4]),
+                  (1, [0, 99]), (0, [1]), (1001, [1]), (0, [])]
+    script = [
+        (0, 'command', make_command(FRAME_SCOPE_LIST, 0).hex()),
+        (10, 'command', make_command(FRAME_SCOPE_SELECT, 1, *selections[0]).hex()),
+        (700, 'skip', '5'),
+        (1200, 'command', make_command(FRAME_SCOPE_SELECT, 2, *selections[1]).hex()),
+        (1300, 'command', make_command(FRAME_SCOPE_SELECT, 3, *selections[2]).hex()),
+        (1310, 'command', make_command(FRAME_SCOPE_SELECT, 4, *selections[3]).hex()),
+        (1320, 'command', make_command(FRAME_SCOPE_SELECT, 5, *selections[4]).hex()),
+        (1330, 'command', make_command(FRAME_SCOPE_SELECT, 6, *selections[5]).hex()),
+        (1340, 'command', 'ff' + make_command(FRAME_SCOPE_LIST, 7).hex()[2:]),      # broken, ignored
+        (2500, 'rate', '8'),
+        (3000, 'rate', '46'),
+        (3800, 'command', make_command(FRAME_SCOPE_SELECT, 8, *selections[6]).hex()),
+        (4000, 'end', '0'),
+    ]
+    expected_status = [0, 0, 3, 0, 1, 2, 2, 0]
+    outputs = []
+    with tempfile.TemporaryDirectory() as directory:
+        binary = os.path.join(directory, 'scope_test')
+        subprocess.check_call([args.cc, '-std=gnu11'] + shlex.split(args.cflags) + [
+            '-I' + os.path.join(LIB_DIR, 'Scope'), '-I' + os.path.join(LIB_DIR, 'BinLog'),
+            '-I' + os.path.join(LIB_DIR, 'CRC16'), '-o', binary, os.path.join(TOOL_DIR, 'scope_test.c'),
+            os.path.join(LIB_DIR, 'Scope', 'Scope.c'), os.path.join(LIB_DIR, 'BinLog', 'BinLog.c'),
+            os.path.join(LIB_DIR, 'CRC16', 'CRC16.c')])
+        formats = binlog.formats_from_elf(binary)
+        script_path = os.path.join(directory, 'script.txt')
+        with open(script_path, 'w') as file:
+            file.writelines('%d %s %s\n' % line for line in script)
+        for run in range(2):
+            stream_path = os.path.join(directory, 'stream%d.bin' % run)
+            values_path = os.path.join(directory, 'values%d.txt' % run)
+            result = subprocess.run([binary, script_path, stream_path, values_path], stdout=subprocess.PIPE,
+                                    universal_newlines=True, check=True)
+            with open(stream_path, 'rb') as file:
+                stream = file.read()
+            with open(values_path) as file:
+                values = file.read().splitlines()
+            outputs.append((stream, values, result.stdout))
+    stream, value_lines, stdout = outputs[0]
+    results = {line.split()[0]: line.split()[1:] for line in stdout.splitlines()}
+    values = read_values(value_lines)
+
+    # fed in odd chunks, frames split between reads of the port
+    parser = binlog.FrameParser()
+    decoder = ScopeDecoder()
+    log = binlog.LogDecoder(formats, 160e6)
+    infos, samples, log_lines = [], [], []
+    for index in range(0, len(stream), 37):
+        for frame_type, sequence, payload in parser.feed(stream[index:index + 37]):
+            if frame_type == FRAME_SCOPE_INFO:
+                infos.append(decoder.decode_info(payload))
+            elif frame_type == FRAME_SCOPE_DATA:
+                samples += decoder.decode_data(payload)
+            elif frame_type == binlog.FRAME_LOG:
+                log_lines += [text for _, text in log.decode(sequence, payload)]
+
+    problems = []
+    if outputs[1][:2] != outputs[0][:2]:
+        problems.append('second run differs')
+    statuses = [info['status'] for info in infos]
+    if statuses != expected_status:
+        problems.append('statuses %s, expected %s' % (statuses, expected_status))
+    if infos and [name for _, name in infos[0]['channels']] != names:
+        problems.append('channels %s' % [name for _, name in infos[0]['channels']])
+    for info in infos:
+        sizes = [type_size(info['channels'][index][0]) for index in info['selected']]
+        if info['rate'] != selection_rate(sizes, info['period'], info['ticks']):
+            problems.append('selection %d: rate %d, counted %d' % (info['selection'], info['rate'],
+                                                                    selection_rate(sizes, info['period'], info['ticks'])))
+    print('commands %d answered, statuses %s: %s' % (len(infos), ' '.join(STATUS[s] for s in statuses),
+                                                   '; '.join(problems) or 'ok'))
+    failed |= bool(problems)
+
+    # every sample is the variable at its tick, period apart, in order
+    problems = []
+    accepted = {info['selection']: info for info in infos if info['status'] == 0}
+    previous = {}
+    for selection, tick, sample in samples:
+        info = accepted[selection]
+        expected = [raw_value(values[tick][index], infos[0]['channels'][index][0]) for index in info['selected']]
+        if sample != expected:
+            problems.append('tick %d: %s, expected %s' % (tick, sample, expected))
+        if tick % info['period'] or tick <= previous.get(selection, -1):
+            problems.append('tick %d out of order or period' % tick)
+        previous[selection] = tick
+        if len(problems) > 5:
+            break
+    sample_count, lost, frames = (int(value) for value in results['stats'])
+    if len(samples) + lost != sample_count:
+        problems.append('%d decoded + %d lost of %d samples' % (len(samples), lost, sample_count))
+    slow = sum(1 for _, tick, _ in samples if 2500 <= tick < 3000)
+    if not lost or not decoder.gaps:
+        problems.append('slow UART: %d lost, %d gaps' % (lost, decoder.gaps))
+    if any(700 <= tick < 705 for _, tick, _ in samples):
+        problems.append('samples of skipped ticks')
+    if parser.bad_frames or decoder.unknown:
+        problems.append('%d bad frames, %d of unknown selection' % (parser.bad_frames, decoder.unknown))
+    print('samples  %d decoded in %d frames, %d lost, %d gaps, %d while UART slow: %s' % (
+        len(samples), frames, lost, decoder.gaps, slow, '; '.join(problems) or 'ok'))
+    failed |= bool(problems)
+
+    problems = []
+    logs = int(results['logs'][0])
+    ticks = [line for line in log_lines if line.startswith('tick ')]
+    if len(ticks) != logs or ticks != ['tick %d' % (index * 100) for index in range(logs)]:
+        problems.append('%d log records decoded of %d' % (len(ticks), logs))
+    print('log      %d records between scope frames: %s' % (logs, '; '.join(problems) or 'ok'))
+    failed |= bool(problems)
+
+    print('cost     %s ns per sample of 8 channels on this host' % results['cost_ns'][0])
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    parser_list = commands.add_parser('list', help='variables registered on the IMU')
+    parser_list.add_argument('--port', required=True, help='serial port on USART3')
+    parser_list.add_argument('--baud', type=int, default=BAUD)
+    parser_list.set_defaults(function=command_list)
+
+    parser_record = commands.add_parser('record', help='select variables and record their samples')
+    parser_record.add_argument('--port', required=True, help='serial port on USART3')
+    parser_record.add_argument('--baud', type=int, default=BAUD)
+    parser_record.add_argument('--channels', required=True, help='names from list, comma separated')
+    rate = parser_record.add_mutually_exclusive_group()
+    rate.add_argument('--rate', type=float, default=100.0, help='[Hz] samples per second, default 100')
+    rate.add_argument('--period', type=int, choices=range(1, PERIOD_MAX + 1), metavar='TICKS',
+                      help='ticks between samples')
+    parser_record.add_argument('-o', '--output', help='CSV file')
+    parser_record.add_argument('--seconds', type=float, help='stop after, default Ctrl+C')
+    parser_record.add_argument('--plot', action='store_true', help='live plot, needs matplotlib')
+    parser_record.add_argument('--window', type=float, default=10.0, help='[s] of the live plot')
+    parser_record.add_argument('--formats', help='ELF or binlog.py table, log lines to stderr')
+    parser_record.add_argument('--clock', type=float, default=160e6, help='[Hz] cycle counter of log timestamps')
+    parser_record.set_defaults(function=command_record)
+
+    parser_test = commands.add_parser('test', help='host test of Scope and this decoder')
+    parser_test.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser_test.add_argument('--cflags', default='-Wall -Wextra -O2')
+    parser_test.set_defaults(function=command_test)
+
+    args = parser.parse_args()
+    return args.function(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
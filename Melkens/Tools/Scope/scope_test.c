@@ -0,0 +1,294 @@
+/*
+ * Host driver of scope.py test, built with Melkens_Lib/Scope/Scope.c,
+ * BinLog.c and CRC16.c.
+ *
+ * scope_test <script> <stream> <values> runs the 1ms loop of the IMU for the
+ * ticks of the script, lines "<tick> <what> <argument>":
+ *   command <hex>     frame received on USART3, applied before sampling
+ *   rate <bytes>      UART bytes per tick from here on
+ *   skip <ticks>      sampling task does not run for that many ticks
+ *   end 0             last tick
+ * and writes:
+ *   stream    bytes sent on USART3: scope frames first, log frames when the
+ *             UART has nothing else, like DebugUart_Perform
+ *   values    "<tick> <raw>..." per tick, bits of every registered variable
+ * and prints to stdout:
+ *   stats <samples> <lost> <frames>
+ *   logs <records logged>
+ *   cost_ns <ns per Scope_Sample with 8 channels>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Scope.h"
+#include "CRC16.h"
+
+#define TICKS_PER_SECOND    1000u
+#define BUDGET              20000u      // [bytes per second] small, to see selections refused
+#define LOG_FRAME_SIZE      128u
+#define COST_SAMPLES        1000000u
+
+static uint8_t  ValueU8;
+static uint16_t ValueU16;
+static uint32_t ValueU32;
+static int8_t   ValueI8;
+static int16_t  ValueI16;
+static int32_t  ValueI32;
+static float    ValueF0;
+static float    ValueF1;
+static float    ValueF2;
+static uint32_t ValueTick;
+
+static const struct {
+    const char *Name;
+    const volatile void *Address;
+    uint8_t Type;
+} Variables[] = {
+    { "u8",     &ValueU8,   dSCOPE_TYPE_UINT8 },
+    { "u16",    &ValueU16,  dSCOPE_TYPE_UINT16 },
+    { "u32",    &ValueU32,  dSCOPE_TYPE_UINT32 },
+    { "i8",     &ValueI8,   dSCOPE_TYPE_INT8 },
+    { "i16",    &ValueI16,  dSCOPE_TYPE_INT16 },
+    { "i32",    &ValueI32,  dSCOPE_TYPE_INT32 },
+    { "f0",     &ValueF0,   dSCOPE_TYPE_FLOAT },
+    { "f1",     &ValueF1,   dSCOPE_TYPE_FLOAT },
+    { "f2",     &ValueF2,   dSCOPE_TYPE_FLOAT },
+    { "tick",   &ValueTick, dSCOPE_TYPE_UINT32 },
+};
+#define VARIABLES (sizeof(Variables) / sizeof(Variables[0]))
+
+static uint32_t Clock;
+static uint32_t Logs;
+
+static uint32_t GetTime(void)
+{
+    Clock += 160u;
+    return Clock;
+}
+
+static void Update(uint32_t tick)
+{
+    ValueU8 = (uint8_t)(tick * 7u);
+    ValueU16 = (uint16_t)(tick * 263u);
+    ValueU32 = tick * 2654435761u;
+    ValueI8 = (int8_t)(100 - (int32_t)(tick % 200u));
+    ValueI16 = (int16_t)(-(int32_t)tick * 17);
+    ValueI32 = -(int32_t)(tick * 40503u);
+    ValueF0 = (float)tick * 0.001f;
+    ValueF1 = -1.5f / (float)(tick + 1u);
+    ValueF2 = (float)(tick % 360u) * 0.0174533f;
+    ValueTick = tick;
+}
+
+static void WriteValues(FILE *values, uint32_t tick)
+{
+    uint32_t raw;
+    uint8_t i, size;
+
+    fprintf(values, "%u", (unsigned)tick);
+    for (i = 0; i < VARIABLES; i++) {
+        raw = 0;
+        size = Variables[i].Type & dSCOPE_TYPE_SIZE_MASK;
+        memcpy(&raw, (const void *)Variables[i].Address, size);
+        fprintf(values, " %x", (unsigned)raw);
+    }
+    fputc('\n', values);
+}
+
+static uint16_t ParseHex(const char *text, uint8_t *data, uint16_t size)
+{
+    uint16_t length = 0;
+    unsigned byte;
+
+    while (length < size && sscanf(text, "%2x", &byte) == 1) {
+        data[length++] = (uint8_t)byte;
+        text += 2;
+    }
+    return length;
+}
+
+// USART3 with DMA: one frame at a time, Rate bytes per tick
+static struct {
+    FILE *Stream;
+    uint32_t Rate;
+    uint32_t Remaining;     // [bytes] of the frame on the line
+    bool IsScope;
+} Uart;
+
+static void Transmit(void)
+{
+    static uint8_t logFrame[LOG_FRAME_SIZE];
+    uint32_t budget = Uart.Rate;
+    const uint8_t *frame;
+    uint16_t length;
+
+    while (budget > 0u) {
+        if (Uart.Remaining > 0u) {
+            uint32_t sent = (Uart.Remaining < budget) ? Uart.Remaining : budget;
+
+            Uart.Remaining -= sent;
+            budget -= sent;
+            continue;
+        }
+        if (Uart.IsScope) {
+            Uart.IsScope = false;
+            Scope_FrameSent();
+        }
+        frame = Scope_GetFrame(&length);
+        if (frame != NULL) {
+            Uart.IsScope = true;
+        } else if (!BinLog_IsEmpty() && (length = BinLog_Drain(logFrame, sizeof(logFrame), 0)) > 0u) {
+            frame = logFrame;
+        } else {
+            break;
+        }
+        fwrite(frame, 1, length, Uart.Stream);
+        Uart.Remaining = length;
+    }
+}
+
+static int Run(FILE *script, FILE *values)
+{
+    char what[16], argument[128];
+    uint8_t command[64];
+    unsigned lineTick;
+    uint32_t tick = 0, skipUntil = 0, end = 0;
+    bool isLine;
+    uint16_t length;
+
+    isLine = (fscanf(script, "%u %15s %127s", &lineTick, what, argument) == 3);
+    for (;;) {
+        while (isLine && lineTick == tick) {
+            if (strcmp(what, "command") == 0) {
+                length = ParseHex(argument, command, sizeof(command));
+                Scope_Command(command, length);
+            } else if (strcmp(what, "rate") == 0) {
+                Uart.Rate = (uint32_t)strtoul(argument, NULL, 10);
+            } else if (strcmp(what, "skip") == 0) {
+                skipUntil = tick + (uint32_t)strtoul(argument, NULL, 10);
+            } else if (strcmp(what, "end") == 0) {
+                end = tick;
+            }
+            isLine = (fscanf(script, "%u %15s %127s", &lineTick, what, argument) == 3);
+        }
+        Update(tick);
+        WriteValues(values, tick);
+        if (tick >= skipUntil) {
+            Scope_Sample(tick);
+        }
+        if ((tick % 100u) == 0u) {
+            BINLOG("tick %u", tick);
+            Logs++;
+        }
+        Transmit();
+        if (end != 0u && tick == end) {
+            break;
+        }
+        if (!isLine && end == 0u) {
+            fprintf(stderr, "script without end\n");
+            return 2;
+        }
+        tick++;
+    }
+    // line drains, nothing sampled any more
+    while (Uart.Remaining > 0u || Uart.IsScope || !BinLog_IsEmpty()) {
+        Transmit();
+        if (Uart.Remaining == 0u && Uart.IsScope) {
+            Uart.IsScope = false;
+            Scope_FrameSent();
+        }
+    }
+    return 0;
+}
+
+static double Now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+// Every tick, 8 channels of 4 bytes, frames taken as soon as they are ready
+static void Cost(void)
+{
+    uint8_t command[dSCOPE_COMMAND_SIZE];
+    uint8_t *payload = &command[dBINLOG_FRAME_HEADER_SIZE];
+    const uint8_t *frame;
+    uint16_t length;
+    double start, spent = 0.0;
+    uint32_t tick;
+    uint8_t i;
+
+    Scope_Init(TICKS_PER_SECOND, UINT32_MAX);
+    memset(command, 0, sizeof(command));
+    payload[0] = 1;
+    payload[2] = dSCOPE_SELECT_MAX;
+    for (i = 0; i < dSCOPE_SELECT_MAX; i++) {
+        payload[4 + i] = (uint8_t)(2u + i);
+    }
+    BinLog_MakeFrame(command, dBINLOG_FRAME_SCOPE_SELECT, 0, (uint16_t)(dSCOPE_COMMAND_SIZE - dBINLOG_FRAME_OVERHEAD));
+    Scope_Command(command, sizeof(command));
+    for (tick = 0; tick < COST_SAMPLES; tick++) {
+        start = Now();
+        Scope_Sample(tick);
+        spent += Now() - start;
+        while ((frame = Scope_GetFrame(&length)) != NULL) {
+            Scope_FrameSent();
+        }
+    }
+    // clock reads included, subtract what they cost alone
+    start = Now();
+    for (tick = 0; tick < COST_SAMPLES; tick++) {
+        (void)Now();
+    }
+    spent -= Now() - start;
+    printf("cost_ns %.1f\n", spent * 1e9 / COST_SAMPLES);
+}
+
+int main(int argc, char **argv)
+{
+    FILE *script, *values;
+    ScopeStats stats;
+    uint8_t i;
+    int result;
+
+    if (argc < 4) {
+        fprintf(stderr, "usage: scope_test <script> <stream> <values>\n");
+        return 2;
+    }
+    script = fopen(argv[1], "r");
+    Uart.Stream = fopen(argv[2], "wb");
+    values = fopen(argv[3], "w");
+    if (script == NULL || Uart.Stream == NULL || values == NULL) {
+        return 2;
+    }
+    CRC16_Init();
+    BinLog_Init(GetTime);
+    // half of the channels before Scope_Init, as modules initialised before DebugUart
+    for (i = 0; i < VARIABLES / 2u; i++) {
+        Scope_Register(Variables[i].Name, Variables[i].Address, Variables[i].Type);
+    }
+    Scope_Init(TICKS_PER_SECOND, BUDGET);
+    for (; i < VARIABLES; i++) {
+        Scope_Register(Variables[i].Name, Variables[i].Address, Variables[i].Type);
+    }
+    Scope_Register(Variables[0].Name, Variables[0].Address, Variables[0].Type);
+    Uart.Rate = 46u;        // 460800 baud
+
+    result = Run(script, values);
+    fclose(script);
+    fclose(Uart.Stream);
+    fclose(values);
+    if (result != 0) {
+        return result;
+    }
+    Scope_GetStats(&stats);
+    printf("stats %u %u %u\n", (unsigned)stats.Samples, (unsigned)stats.Lost, (unsigned)stats.Frames);
+    printf("logs %u\n", (unsigned)Logs);
+
+    Cost();
+    return 0;
+}
@@ -0,0 +1,391 @@
+/*
+ * Host driver of speed_control_sim.py, built together with
+ * Melkens_PMB/SpeedControl/SpeedControl.c and Melkens_PMB/Tools/FixedPoint.c.
+ *
+ * Both wheels are simulated in 100 us steps. The inverter holds its shaft
+ * speed with a first order lag (60 ms) and loses a share of the command to
+ * load and slip (droop). Positions are polled as in MotorManager: one wheel
+ * every 5 ms, reply 1-2 ms later, speed from the position change over the
+ * time between the inquiries as seen by the main loop. Speed commands reach the
+ * inverter 0.5 ms after they are sent. The loop runs every
+ * dSPEED_CONTROL_PERIOD and sends only changes of dSPEED_CONTROL_DEADBAND.
+ *
+ * Prints one line per case: <name> ok|FAIL [detail]. With argument "trace"
+ * prints the step response instead: time [ms], setpoint, command, speed.
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include "SpeedControl/SpeedControl.h"
+
+#define STEP_US         100u
+#define ENCODER_COUNTS  10000u          /* ENCODER_MAX_VALUE */
+#define LAG_S           0.060
+#define MAX_MS          12000u
+#define TIMEOUT_US      50000u          /* dSPEED_MEASURE_TIMEOUT */
+
+typedef struct {
+    /* plant */
+    double Speed;           /* [RPM] */
+    double Counts;          /* encoder position, not wrapped */
+    double Droop;
+    double Load;            /* [RPM] */
+    uint16_t Applied;       /* command used by inverter */
+    uint16_t Pending;
+    uint32_t PendingAt;     /* [us], 0 - nothing pending */
+    uint32_t ReplyAt;       /* [us], 0 - no request */
+    uint16_t ReplyCount;
+    uint32_t RequestTime;   /* [us] inquiry sent, as taken by MotorManager */
+    /* MotorManager side */
+    uint16_t PrevCount;
+    uint32_t PositionTime;
+    uint32_t SpeedTime;
+    uint16_t Measured;
+    uint16_t Setpoint;
+    uint16_t Sent;
+    uint32_t Frames;
+    SpeedController Controller;
+    /* per ms */
+    float History[MAX_MS];
+    uint16_t Commands[MAX_MS];
+}Wheel;
+
+static Wheel Wheels[2];
+static SpeedControlGains Gains;
+static bool IsClosed;
+static uint32_t Random = 12345u;
+static bool Failed;
+
+static uint32_t Jitter(uint32_t Max)
+{
+    Random = Random * 1103515245u + 12345u;
+    return (Random >> 16) % (Max + 1u);
+}
+
+static void Send(Wheel *W, uint32_t Now)
+{
+    W->Sent = IsClosed ? SpeedControl_GetCommand(&W->Controller, &Gains, W->Setpoint) : W->Setpoint;
+    W->Pending = W->Sent;
+    W->PendingAt = Now + 500u;
+    W->Frames++;
+}
+
+/* MotorManager_SetSpeed and MotorManager_StartMotor */
+static void SetSpeed(Wheel *W, uint16_t Setpoint, uint32_t Now)
+{
+    W->Setpoint = Setpoint;
+    if (Setpoint == 0u) {
+        SpeedControl_Reset(&W->Controller);
+    }
+    Send(W, Now);
+}
+
+/* CalculateShaftTurn */
+static void Reply(Wheel *W, uint32_t Now)
+{
+    int32_t Diff = (int32_t)W->ReplyCount - (int32_t)W->PrevCount;
+    uint32_t Elapsed;
+    uint32_t Speed;
+
+    if (Diff > (int32_t)ENCODER_COUNTS / 2) {
+        Diff -= ENCODER_COUNTS;
+    }
+    else if (Diff < -(int32_t)ENCODER_COUNTS / 2) {
+        Diff += ENCODER_COUNTS;
+    }
+    Now = W->RequestTime;
+    Elapsed = Now - W->PositionTime;
+    if (Elapsed > 0u && Elapsed < TIMEOUT_US) {
+        Speed = (uint32_t)labs(Diff) * (60000000u / ENCODER_COUNTS) / Elapsed;
+        W->Measured = (Speed > 0xFFFFu) ? 0xFFFFu : (uint16_t)Speed;
+        W->SpeedTime = Now;
+    }
+    W->PositionTime = Now;
+    W->PrevCount = W->ReplyCount;
+}
+
+/* MotorManager_PerformSpeedControl */
+static void Control(Wheel *W, uint32_t Now)
+{
+    uint16_t Command;
+
+    if (!IsClosed || W->Sent == 0u) {
+        SpeedControl_Reset(&W->Controller);
+        return;
+    }
+    if (Now - W->SpeedTime >= TIMEOUT_US) {
+        return;
+    }
+    Command = SpeedControl_Update(&W->Controller, &Gains, W->Setpoint, W->Measured);
+    if (Command != 0u && abs((int)Command - (int)W->Sent) >= (int)dSPEED_CONTROL_DEADBAND) {
+        Send(W, Now);
+    }
+}
+
+static void Plant(Wheel *W, uint32_t Now)
+{
+    double Target;
+
+    if (W->PendingAt != 0u && Now >= W->PendingAt) {
+        W->Applied = W->Pending;
+        W->PendingAt = 0u;
+    }
+    Target = W->Applied * (1.0 - W->Droop) - W->Load;
+    if (Target < 0.0) {
+        Target = 0.0;
+    }
+    W->Speed += (Target - W->Speed) * (STEP_US * 1e-6 / LAG_S);
+    W->Counts += W->Speed * ENCODER_COUNTS / 60.0 * STEP_US * 1e-6;
+}
+
+typedef void (*Events)(uint32_t Ms);
+
+static void Start(bool Closed, double DroopLeft, double DroopRight)
+{
+    memset(Wheels, 0, sizeof(Wheels));
+    Gains.Kp = dSPEED_CONTROL_KP;
+    Gains.Ki = dSPEED_CONTROL_KI;
+    Gains.Kd = dSPEED_CONTROL_KD;
+    Gains.Kff = dSPEED_CONTROL_KFF;
+    Gains.TrimLimit = dSPEED_CONTROL_TRIM_LIMIT;
+    IsClosed = Closed;
+    Wheels[0].Droop = DroopLeft;
+    Wheels[1].Droop = DroopRight;
+    SpeedControl_Reset(&Wheels[0].Controller);
+    SpeedControl_Reset(&Wheels[1].Controller);
+}
+
+static void Run(uint32_t Ms, Events OnMs)
+{
+    uint32_t Now;
+    uint8_t i;
+
+    for (Now = STEP_US; Now <= Ms * 1000u; Now += STEP_US) {
+        for (i = 0; i < 2u; i++) {
+            Wheel *W = &Wheels[i];
+
+            Plant(W, Now);
+            /* inquiry every 10 ms per wheel, the other wheel 5 ms later */
+            if (W->Sent != 0u && (Now + i * 5000u) % 10000u == 0u) {
+                /* main loop takes the time up to 200 us before the frame is queued,
+                 * reply is polled 1 to 2 ms later */
+                W->RequestTime = Now - Jitter(2u) * STEP_US;
+                W->ReplyCount = (uint16_t)((uint32_t)W->Counts % ENCODER_COUNTS);
+                W->ReplyAt = Now + 1000u + Jitter(10u) * STEP_US;
+            }
+            if (W->ReplyAt != 0u && Now >= W->ReplyAt) {
+                W->ReplyAt = 0u;
+                Reply(W, Now);
+            }
+        }
+        if (Now % 1000u == 0u) {
+            uint32_t Ms1 = Now / 1000u;
+
+            if (OnMs != NULL) {
+                OnMs(Ms1);
+            }
+            if (Ms1 % dSPEED_CONTROL_PERIOD == 0u) {
+                Control(&Wheels[0], Now);
+                Control(&Wheels[1], Now);
+            }
+            for (i = 0; i < 2u; i++) {
+                Wheels[i].History[Ms1 - 1u] = (float)Wheels[i].Speed;
+                Wheels[i].Commands[Ms1 - 1u] = Wheels[i].Sent;
+            }
+        }
+    }
+}
+
+static double Mean(const Wheel *W, uint32_t From, uint32_t To)
+{
+    double Sum = 0.0;
+    uint32_t Ms;
+
+    for (Ms = From; Ms < To; Ms++) {
+        Sum += W->History[Ms];
+    }
+    return Sum / (To - From);
+}
+
+static double Peak(const Wheel *W, uint32_t From, uint32_t To)
+{
+    double Max = 0.0;
+    uint32_t Ms;
+
+    for (Ms = From; Ms < To; Ms++) {
+        if (W->History[Ms] > Max) {
+            Max = W->History[Ms];
+        }
+    }
+    return Max;
+}
+
+static uint32_t MaxCommandChange(const Wheel *W, uint32_t From, uint32_t To)
+{
+    uint32_t Max = 0;
+    uint32_t Ms;
+
+    for (Ms = From; Ms < To; Ms++) {
+        uint32_t Change = (uint32_t)abs((int)W->Commands[Ms + 1u] - (int)W->Commands[Ms]);
+
+        Max = (Change > Max) ? Change : Max;
+    }
+    return Max;
+}
+
+/* First ms from which speed stays within Band of Target */
+static uint32_t Settle(const Wheel *W, uint32_t From, uint32_t To, double Target, double Band)
+{
+    uint32_t Settled = To;
+    uint32_t Ms;
+
+    for (Ms = To; Ms > From; Ms--) {
+        double Error = W->History[Ms - 1u] - Target;
+
+        if (Error > Band || Error < -Band) {
+            break;
+        }
+        Settled = Ms - 1u;
+    }
+    return Settled - From;
+}
+
+static void Check(const char *Name, bool Ok, const char *Format, ...)
+{
+    va_list Args;
+
+    printf("%s %s ", Name, Ok ? "ok" : "FAIL");
+    va_start(Args, Format);
+    vprintf(Format, Args);
+    va_end(Args);
+    printf("\n");
+    Failed |= !Ok;
+}
+
+static void StepEvents(uint32_t Ms)
+{
+    if (Ms == 100u) {
+        SetSpeed(&Wheels[0], 600, Ms * 1000u);
+        SetSpeed(&Wheels[1], 600, Ms * 1000u);
+    }
+}
+
+static void LoadEvents(uint32_t Ms)
+{
+    StepEvents(Ms);
+    if (Ms == 3000u) {
+        Wheels[0].Load = 60.0;
+        Wheels[1].Load = 60.0;
+    }
+}
+
+static void WindupEvents(uint32_t Ms)
+{
+    if (Ms == 100u) {
+        SetSpeed(&Wheels[0], 2900, Ms * 1000u);
+        SetSpeed(&Wheels[1], 2900, Ms * 1000u);
+    }
+    if (Ms == 4000u) {
+        SetSpeed(&Wheels[0], 600, Ms * 1000u);
+        SetSpeed(&Wheels[1], 600, Ms * 1000u);
+    }
+}
+
+static void GainEvents(uint32_t Ms)
+{
+    StepEvents(Ms);
+    if (Ms == 3000u) {
+        Gains.Kp = dQ15(0.1);
+        Gains.Ki = dQ15(0.02);
+    }
+}
+
+/* Route step speeds every 100 ms from RouteManager */
+static void RampEvents(uint32_t Ms)
+{
+    if (Ms % 100u == 0u && Ms <= 2000u) {
+        SetSpeed(&Wheels[0], (uint16_t)(Ms * 600u / 2000u), Ms * 1000u);
+        SetSpeed(&Wheels[1], (uint16_t)(Ms * 600u / 2000u), Ms * 1000u);
+    }
+}
+
+static void Trace(void)
+{
+    uint32_t Ms;
+
+    Start(true, 0.08, 0.08);
+    Run(2000u, StepEvents);
+    printf("time,setpoint,command,speed\n");
+    for (Ms = 0; Ms < 2000u; Ms++) {
+        printf("%u,%u,%u,%.1f\n", Ms + 1u, (Ms + 1u) >= 100u ? 600u : 0u, Wheels[0].Commands[Ms],
+               Wheels[0].History[Ms]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double Open, Closed, OpenGap, ClosedGap, Overshoot;
+    uint32_t Time, MaxChange;
+
+    if (argc > 1 && strcmp(argv[1], "trace") == 0) {
+        Trace();
+        return 0;
+    }
+
+    Start(false, 0.08, 0.08);
+    Run(3000u, StepEvents);
+    Open = Mean(&Wheels[0], 2000u, 3000u);
+    Start(true, 0.08, 0.08);
+    Run(3000u, StepEvents);
+    Closed = Mean(&Wheels[0], 2000u, 3000u);
+    Overshoot = Peak(&Wheels[0], 100u, 3000u) - 600.0;
+    Time = Settle(&Wheels[0], 100u, 3000u, 600.0, 12.0);
+    Check("step_600rpm", Closed > 594.0 && Closed < 606.0 && Overshoot < 60.0 && Time < 800u,
+          "speed %.1f RPM (open loop %.1f), overshoot %.1f RPM, within 2 %% after %u ms",
+          Closed, Open, Overshoot, Time);
+
+    Start(false, 0.03, 0.10);
+    Run(10000u, StepEvents);
+    OpenGap = (Wheels[0].Counts - Wheels[1].Counts) / ENCODER_COUNTS;
+    Start(true, 0.03, 0.10);
+    Run(10000u, StepEvents);
+    ClosedGap = (Wheels[0].Counts - Wheels[1].Counts) / ENCODER_COUNTS;
+    Check("wheel_mismatch", ClosedGap < OpenGap / 5.0 && ClosedGap > -OpenGap / 5.0,
+          "left-right after 10 s: %.2f rotations (open loop %.2f), droop 3 %% and 10 %%", ClosedGap, OpenGap);
+
+    Start(true, 0.08, 0.08);
+    Run(5000u, LoadEvents);
+    Time = Settle(&Wheels[0], 3000u, 5000u, 600.0, 12.0);
+    Closed = Mean(&Wheels[0], 4500u, 5000u);
+    Check("load_step", Time < 800u && Closed > 594.0, "60 RPM load, within 2 %% after %u ms, speed %.1f RPM",
+          Time, Closed);
+
+    Start(true, 0.20, 0.20);
+    Run(7000u, WindupEvents);
+    Overshoot = Peak(&Wheels[0], 4000u, 7000u);
+    Time = Settle(&Wheels[0], 4000u, 7000u, 600.0, 12.0);
+    Check("anti_windup", Wheels[0].Commands[3990] == dSPEED_CONTROL_MAX_SPEED || Wheels[0].Commands[3990] >= 2900u,
+          "command %u RPM while saturated", Wheels[0].Commands[3990]);
+    Check("after_saturation", Time < 1500u,
+          "2900 -> 600 RPM, within 2 %% after %u ms, undershoot to %.1f RPM", Time,
+          Mean(&Wheels[0], 4400u, 4500u));
+    (void)Overshoot;
+
+    Start(true, 0.08, 0.08);
+    Run(4000u, GainEvents);
+    MaxChange = MaxCommandChange(&Wheels[0], 3000u, 3100u);
+    Closed = Mean(&Wheels[0], 3500u, 4000u);
+    Check("gain_change", MaxChange <= MaxCommandChange(&Wheels[0], 2000u, 2990u) + dSPEED_CONTROL_DEADBAND &&
+          Closed > 594.0 && Closed < 606.0, "largest command change %u RPM after new gains (%u before), speed %.1f RPM",
+          MaxChange, MaxCommandChange(&Wheels[0], 2000u, 2990u), Closed);
+
+    Start(true, 0.08, 0.08);
+    Run(4000u, RampEvents);
+    Closed = Mean(&Wheels[0], 3500u, 4000u);
+    Check("route_ramp", Wheels[0].Frames <= 4000u / dSPEED_CONTROL_PERIOD + 21u && Closed > 594.0,
+          "%u speed frames in 4 s (21 setpoints), speed %.1f RPM", Wheels[0].Frames, Closed);
+
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""
+Host simulation of the PMB wheel speed loop, Melkens_PMB/SpeedControl.
+
+Builds speed_control_sim.c with SpeedControl.c against a model of the wheel
+inverters (first order lag, speed lost to load and slip, positions polled
+over CAN as in MotorManager) and checks that:
+  - a speed step settles on the setpoint without large overshoot, where the
+    open loop stays low by the droop,
+  - wheels with different droop drive the same distance,
+  - a load step is corrected,
+  - a saturated command does not wind up the integral,
+  - gains changed at run time take over without a command jump,
+  - the loop adds at most one speed frame per control period.
+
+Usage:
+  speed_control_sim.py [--cc cc] [--cflags "-O2"] [--trace step.csv]
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+PMB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_PMB')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    parser.add_argument('--trace', metavar='CSV', help='write the 600 RPM step response to CSV')
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        output = os.path.join(directory, 'speed_control_sim')
+        command = [args.cc, '-std=c99', '-Wall', '-Wextra'] + shlex.split(args.cflags) + [
+            '-I' + PMB_DIR, '-o', output,
+            os.path.join(TOOL_DIR, 'speed_control_sim.c'),
+            os.path.join(PMB_DIR, 'SpeedControl', 'SpeedControl.c'),
+            os.path.join(PMB_DIR, 'Tools', 'FixedPoint.c')]
+        subprocess.check_call(command)
+        if args.trace:
+            with open(args.trace, 'w') as trace:
+                subprocess.check_call([output, 'trace'], stdout=trace)
+            print('wrote %s' % args.trace)
+        result = subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True)
+
+    failed = result.returncode != 0
+    for line in result.stdout.splitlines():
+        fields = line.split(None, 2)
+        print('%-28s %s' % (fields[0], ' '.join(fields[1:])))
+        failed |= fields[1] != 'ok'
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,322 @@
+/*
+ * Host driver of task_scheduler_test.py, built together with
+ * Melkens_Lib/TaskScheduler/TaskScheduler.c.
+ *
+ * Ticks are passed in by the test like SYSTICK on target, the time source is
+ * a cycle counter that every task function advances by its cost.
+ *
+ * Prints:
+ *   <case> ok
+ *   <case> FAIL <what>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "TaskScheduler.h"
+
+#define TASKS_MAX   4
+#define RUNS_MAX    2048
+
+static uint32_t Cycles;             // time source
+static uint32_t Cost[TASKS_MAX];    // [cycles] per run of task i
+static uint32_t Tick;               // tick of the current Perform call
+static struct {
+    uint8_t Task;
+    uint32_t Tick;
+} Runs[RUNS_MAX];
+static uint32_t RunCount;
+static int Failures;
+
+static uint32_t GetCycles(void)
+{
+    return Cycles;
+}
+
+static void Record(uint8_t task)
+{
+    if (RunCount < RUNS_MAX) {
+        Runs[RunCount].Task = task;
+        Runs[RunCount].Tick = Tick;
+        RunCount++;
+    }
+    Cycles += Cost[task];
+}
+
+static void Task0(void) { Record(0); }
+static void Task1(void) { Record(1); }
+static void Task2(void) { Record(2); }
+static void Task3(void) { Record(3); }
+
+static void Reset(void)
+{
+    memset(Cost, 0, sizeof(Cost));
+    RunCount = 0;
+    Cycles = 0;
+}
+
+static void Check(const char *name, bool condition, const char *what)
+{
+    if (!condition) {
+        printf("%s FAIL %s\n", name, what);
+        Failures++;
+    }
+}
+
+static void Report(const char *name, int failuresBefore)
+{
+    if (Failures == failuresBefore) {
+        printf("%s ok\n", name);
+    }
+}
+
+static void Perform(TaskScheduler *scheduler, uint32_t tick)
+{
+    Tick = tick;
+    TaskScheduler_Perform(scheduler, tick);
+}
+
+// Every tick from first to last, wrapping
+static void PerformEveryTick(TaskScheduler *scheduler, uint32_t first, uint32_t ticks)
+{
+    uint32_t i;
+
+    for (i = 0; i < ticks; i++) {
+        Perform(scheduler, first + i);
+    }
+}
+
+static uint32_t RunsOf(uint8_t task)
+{
+    uint32_t count = 0, i;
+
+    for (i = 0; i < RunCount; i++) {
+        count += (Runs[i].Task == task) ? 1u : 0u;
+    }
+    return count;
+}
+
+// Runs of a task are on ticks period apart, starting at first
+static bool IsOnGrid(uint8_t task, uint32_t first, uint32_t period)
+{
+    uint32_t expected = first, i;
+
+    for (i = 0; i < RunCount; i++) {
+        if (Runs[i].Task != task) {
+            continue;
+        }
+        if (Runs[i].Tick != expected) {
+            return false;
+        }
+        expected += period;
+    }
+    return true;
+}
+
+// Like the 100ms tasks of the IMU and PMB tables
+static void PhaseOffsets(void)
+{
+    static const Task tasks[] = {
+        { Task0, 1,   0,  0, TaskPolicy_Skip, 0 },
+        { Task1, 100, 3,  0, TaskPolicy_Skip, 0 },
+        { Task2, 100, 21, 0, TaskPolicy_Skip, 0 },
+        { Task3, 100, 61, 0, TaskPolicy_Skip, 0 },
+    };
+    static TaskControl control[4];
+    TaskScheduler scheduler;
+    const char *name = "phase_offsets";
+    int before = Failures;
+    uint32_t i;
+    bool isOrdered = true;
+
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 4, NULL, 0);
+    PerformEveryTick(&scheduler, 0, 1000);
+    Check(name, RunsOf(0) == 1000u && IsOnGrid(0, 0, 1), "1ms task not every tick");
+    Check(name, RunsOf(1) == 10u && IsOnGrid(1, 3, 100), "phase 3");
+    Check(name, RunsOf(2) == 10u && IsOnGrid(2, 21, 100), "phase 21");
+    Check(name, RunsOf(3) == 10u && IsOnGrid(3, 61, 100), "phase 61");
+    // table order within a tick: the 1ms task first
+    for (i = 1; i < RunCount; i++) {
+        if (Runs[i].Tick == Runs[i - 1].Tick && Runs[i].Task <= Runs[i - 1].Task) {
+            isOrdered = false;
+        }
+    }
+    Check(name, isOrdered, "not in table order within a tick");
+    Check(name, TaskScheduler_GetStats(&scheduler, 1)->Late == 0u &&
+                TaskScheduler_GetStats(&scheduler, 1)->Skipped == 0u, "late or skipped without misses");
+
+    // started in the middle of a period, first release is the next tick of the phase
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 4, NULL, 57);
+    PerformEveryTick(&scheduler, 57, 300);
+    Check(name, IsOnGrid(1, 103, 100), "phase 3 after start at 57");
+    Check(name, IsOnGrid(2, 121, 100), "phase 21 after start at 57");
+    Check(name, IsOnGrid(3, 61, 100), "phase 61 after start at 57");
+    Report(name, before);
+}
+
+static void SkipPolicy(void)
+{
+    static const Task tasks[] = {
+        { Task0, 10, 0, 0, TaskPolicy_Skip, 0 },
+    };
+    static TaskControl control[1];
+    TaskScheduler scheduler;
+    const TaskStats *stats;
+    const char *name = "skip_policy";
+    int before = Failures;
+
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 1, NULL, 0);
+    stats = TaskScheduler_GetStats(&scheduler, 0);
+    Perform(&scheduler, 0);
+    // releases 10, 20 and 30 missed: one late run, two skipped
+    Perform(&scheduler, 35);
+    Check(name, stats->Runs == 2u, "not run once for missed releases");
+    Check(name, stats->Late == 1u, "late");
+    Check(name, stats->Skipped == 2u, "skipped");
+    Perform(&scheduler, 39);
+    Check(name, stats->Runs == 2u, "run before next release");
+    // back on the grid, 40 on time
+    Perform(&scheduler, 40);
+    Check(name, stats->Runs == 3u && stats->Late == 1u, "release 40 not on time");
+    // just late, nothing missed
+    Perform(&scheduler, 51);
+    Check(name, stats->Runs == 4u && stats->Late == 2u && stats->Skipped == 2u, "late by one tick");
+    Check(name, control[0].NextRelease == 60u, "next release off the grid");
+    Check(name, TaskScheduler_GetMissCount(&scheduler) == 4u, "miss count");
+
+    // long stall saturates
+    Perform(&scheduler, 60u + 10u * 100000u);
+    Check(name, stats->Skipped == UINT16_MAX, "skipped not saturated");
+    Check(name, TaskScheduler_GetMissCount(&scheduler) == UINT16_MAX, "miss count not saturated");
+    Report(name, before);
+}
+
+static void CatchUpPolicy(void)
+{
+    static const Task tasks[] = {
+        { Task0, 10, 0, 0, TaskPolicy_CatchUp, 3 },
+        { Task1, 10, 0, 0, TaskPolicy_CatchUp, 0 },
+    };
+    static TaskControl control[2];
+    TaskScheduler scheduler;
+    const TaskStats *stats, *single;
+    const char *name = "catch_up_policy";
+    int before = Failures;
+
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 2, NULL, 0);
+    stats = TaskScheduler_GetStats(&scheduler, 0);
+    single = TaskScheduler_GetStats(&scheduler, 1);
+    Perform(&scheduler, 0);
+    // releases 10, 20 and 30 missed, all three within MaxCatchUp
+    Perform(&scheduler, 35);
+    Check(name, stats->Runs == 4u, "missed releases not caught up");
+    Check(name, stats->Skipped == 0u && stats->Late == 1u, "skipped or late");
+    Check(name, control[0].NextRelease == 40u, "next release");
+    // six missed (40 .. 90): three run, the rest dropped and back on the grid
+    Perform(&scheduler, 95);
+    Check(name, stats->Runs == 7u, "catch up not bounded by MaxCatchUp");
+    Check(name, stats->Skipped == 3u, "releases over MaxCatchUp not skipped");
+    Check(name, control[0].NextRelease == 100u, "not realigned to the grid");
+    // MaxCatchUp 0 runs once per call
+    Check(name, single->Runs == 3u && single->Skipped == 7u, "MaxCatchUp 0");
+    Check(name, control[1].NextRelease == 100u, "MaxCatchUp 0 not realigned");
+    Report(name, before);
+}
+
+static void ExecutionTime(void)
+{
+    static const Task tasks[] = {
+        { Task0, 1, 0, 100, TaskPolicy_Skip, 0 },
+        { Task1, 1, 0, 0,   TaskPolicy_Skip, 0 },
+    };
+    static TaskControl control[2];
+    TaskScheduler scheduler;
+    const TaskStats *stats, *unchecked;
+    const char *name = "execution_time";
+    int before = Failures;
+
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 2, GetCycles, 0);
+    stats = TaskScheduler_GetStats(&scheduler, 0);
+    unchecked = TaskScheduler_GetStats(&scheduler, 1);
+    Cost[0] = 150;
+    Cost[1] = 5000;
+    Perform(&scheduler, 0);
+    Check(name, stats->LastTime == 150u && stats->MaxTime == 150u, "time of a run");
+    Check(name, stats->BudgetOverruns == 1u, "overrun not counted");
+    Check(name, unchecked->LastTime == 5000u && unchecked->BudgetOverruns == 0u, "budget 0 is checked");
+    Cost[0] = 100;
+    Perform(&scheduler, 1);
+    Check(name, stats->LastTime == 100u && stats->MaxTime == 150u, "max time");
+    Check(name, stats->BudgetOverruns == 1u, "run at budget counted as overrun");
+    // cycle counter wraps during a run
+    Cycles = 0xFFFFFFC0u;
+    Cost[0] = 200;
+    Perform(&scheduler, 2);
+    Check(name, stats->LastTime == 200u && stats->BudgetOverruns == 2u, "time across counter wrap");
+    Check(name, TaskScheduler_GetMissCount(&scheduler) == 2u, "overruns not in miss count");
+
+    TaskScheduler_ResetStats(&scheduler);
+    Check(name, stats->Runs == 0u && stats->MaxTime == 0u && stats->BudgetOverruns == 0u, "stats not reset");
+    Check(name, TaskScheduler_GetMissCount(&scheduler) == 0u, "miss count not reset");
+    Check(name, TaskScheduler_GetStats(&scheduler, 2) == NULL, "stats of a task not in the table");
+
+    // without a time source nothing is measured
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 2, NULL, 0);
+    Cost[0] = 150;
+    Perform(&scheduler, 0);
+    Check(name, stats->Runs == 1u && stats->LastTime == 0u && stats->BudgetOverruns == 0u, "measured without source");
+    Report(name, before);
+}
+
+static void TickWrap(void)
+{
+    static const Task tasks[] = {
+        { Task0, 100, 30, 0, TaskPolicy_Skip, 0 },
+        { Task1, 7,   0,  0, TaskPolicy_CatchUp, 2 },
+    };
+    static TaskControl control[2];
+    TaskScheduler scheduler;
+    const TaskStats *stats;
+    const char *name = "tick_wrap";
+    int before = Failures;
+    uint32_t first;
+
+    // SYSTICK wraps after 49.7 days: periods stay even across it
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 2, NULL, 0xFFFFFE00u);
+    first = control[0].NextRelease;
+    PerformEveryTick(&scheduler, 0xFFFFFE00u, 1024);
+    Check(name, RunsOf(0) == 10u && IsOnGrid(0, first, 100), "100 tick period broken by wrap");
+    Check(name, IsOnGrid(1, control[1].NextRelease - 7u * RunsOf(1), 7), "7 tick period broken by wrap");
+    Check(name, TaskScheduler_GetStats(&scheduler, 1)->Late == 0u, "late at wrap");
+
+    // release after the wrap is not reached before it
+    Reset();
+    TaskScheduler_Init(&scheduler, tasks, control, 1, NULL, 0);
+    control[0].NextRelease = 5;
+    Perform(&scheduler, 0xFFFFFFFAu);
+    Check(name, RunsOf(0) == 0u, "run before a release after the wrap");
+
+    // release before the wrap is missed over it
+    stats = TaskScheduler_GetStats(&scheduler, 0);
+    control[0].NextRelease = 0xFFFFFF9Cu;       // -100
+    Perform(&scheduler, 150);
+    Check(name, RunsOf(0) == 1u && stats->Late == 1u && stats->Skipped == 2u, "late over the wrap");
+    Check(name, control[0].NextRelease == 200u, "grid over the wrap");
+    Report(name, before);
+}
+
+int main(void)
+{
+    PhaseOffsets();
+    SkipPolicy();
+    CatchUpPolicy();
+    ExecutionTime();
+    TickWrap();
+    return (Failures > 0) ? 1 : 0;
+}
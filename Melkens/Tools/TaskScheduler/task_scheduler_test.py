@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""
+Host test of the table driven task scheduler, Melkens_Lib/TaskScheduler.
+
+Builds task_scheduler_test.c with TaskScheduler.c and drives
+TaskScheduler_Perform with a simulated tick and a simulated cycle counter,
+checking that:
+  - tasks of one period with different phase offsets run on their own
+    ticks, also when started in the middle of a period, in table order,
+  - TaskPolicy_Skip runs once for missed releases and counts them skipped,
+  - TaskPolicy_CatchUp runs missed releases up to MaxCatchUp per tick,
+    drops the rest and gets back onto the period grid,
+  - late, skipped and budget overrun counters, their sum over all tasks,
+    last and max execution time, also with the cycle counter wrapping
+    during a run,
+  - periods stay even across the wrap of the uint32 tick.
+
+Usage:
+  task_scheduler_test.py [--cc cc] [--cflags "-O2"]
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+LIB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        output = os.path.join(directory, 'task_scheduler_test')
+        command = [args.cc, '-std=c99', '-Wall', '-Wextra'] + shlex.split(args.cflags) + [
+            '-I' + os.path.join(LIB_DIR, 'TaskScheduler'), '-o', output,
+            os.path.join(TOOL_DIR, 'task_scheduler_test.c'),
+            os.path.join(LIB_DIR, 'TaskScheduler', 'TaskScheduler.c')]
+        subprocess.check_call(command)
+        result = subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True)
+
+    failed = result.returncode != 0
+    for line in result.stdout.splitlines():
+        fields = line.split(None, 2)
+        print('%-28s %s' % (fields[0], ' '.join(fields[1:])))
+        failed |= fields[1] != 'ok'
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
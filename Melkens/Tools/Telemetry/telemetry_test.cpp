@@ -0,0 +1,181 @@
+/*
+ * Host test driver of telemetry_test.py, built together with
+ * Melkens_Connectivity/src/Telemetry/TelemetryStream.cpp.
+ *
+ * Prints one line per case: <name> ok|FAIL [detail], and
+ *   frame <hex>   encoded frame of known values, decoded by telemetry_test.py
+ *                 with the layout the web page uses
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "src/Telemetry/TelemetryStream.h"
+
+#define MAX_SENT 256
+
+typedef struct {
+    uint32_t client;
+    uint16_t sequence;
+} Sent;
+
+static Sent SentFrames[MAX_SENT];
+static uint32_t SentCount;
+static uint32_t BusyClient = 0xFFFFFFFF;
+static uint16_t Sequence;
+static bool Failed;
+
+static bool Send(uint32_t client, const uint8_t *frame, size_t length, void *context)
+{
+    (void)context;
+    if (client == BusyClient || length != TELEMETRY_FRAME_SIZE || SentCount == MAX_SENT)
+    {
+        return false;
+    }
+    SentFrames[SentCount].client = client;
+    SentFrames[SentCount].sequence = (uint16_t)(frame[2] | (frame[3] << 8));
+    SentCount++;
+    return true;
+}
+
+static uint32_t CountSent(uint32_t client)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < SentCount; i++)
+    {
+        count += (SentFrames[i].client == client) ? 1U : 0U;
+    }
+    return count;
+}
+
+// Network task every 10 ms as in Network_Perform
+static void Run(uint32_t from, uint32_t to)
+{
+    Imu2EspFrame_t imu;
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+
+    memset(&imu, 0, sizeof(imu));
+    for (uint32_t now = from; now < to; now += 10)
+    {
+        if (TelemetryStream_IsDue(now))
+        {
+            TelemetryStream_Encode(frame, &imu, Sequence++, now, 0, 0);
+            TelemetryStream_Push(frame, now);
+        }
+        TelemetryStream_Drain(Send, NULL);
+    }
+}
+
+static void Start(void)
+{
+    TelemetryStream_Reset();
+    SentCount = 0;
+    Sequence = 0;
+    BusyClient = 0xFFFFFFFF;
+}
+
+static void Check(const char *name, bool ok, const char *format, ...)
+{
+    va_list args;
+
+    printf("%s %s ", name, ok ? "ok" : "FAIL");
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+    Failed |= !ok;
+}
+
+int main(void)
+{
+    TelemetryStats stats;
+    Imu2EspFrame_t imu;
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    uint32_t i;
+    bool ok;
+
+    memset(&imu, 0, sizeof(imu));
+    imu.magnetBarStatus = 0x80010203;
+    imu.pmbConnection = 1;
+    imu.motorRightSpeed = -1200;
+    imu.motorLeftSpeed = 1300;
+    imu.batteryVoltage = 25400;
+    imu.adcCurrent = 2100;
+    imu.thumbleCurrent = 45;
+    imu.crcImu2PmbErrorCount = 7;
+    imu.crcPmb2ImuErrorCount = 8;
+    imu.crcEsp2ImuErrorCount = 9;
+    imu.collision = dCOLLISION_WHEEL_STALL;
+    imu.routeUploadState = dROUTE_UPLOAD_DONE;
+    imu.routeCount = 12;
+    imu.stopReaction = 4321;
+    imu.pmbLoopMaxTime = 950;
+    imu.pmbMissedTicks = 3;
+    imu.pmbTaskMisses = 17;
+    TelemetryStream_Encode(frame, &imu, 0xBEEF, 123456789, 98765, TELEMETRY_FLAG_STOPPED);
+    printf("frame ");
+    for (i = 0; i < TELEMETRY_FRAME_SIZE; i++)
+    {
+        printf("%02x", frame[i]);
+    }
+    printf("\n");
+
+    Start();
+    TelemetryStream_Subscribe(1, 20, 0);
+    TelemetryStream_Subscribe(2, 50, 0);
+    TelemetryStream_Subscribe(3, 200, 0);
+    Run(0, 1000);
+    Check("rate_20hz", CountSent(1) == 20, "%u frames in 1 s", CountSent(1));
+    Check("rate_50hz", CountSent(2) == 50, "%u frames in 1 s", CountSent(2));
+    Check("rate_limited", CountSent(3) == 1000 / (1000 / TELEMETRY_MAX_RATE), "%u frames in 1 s, limit %u Hz",
+          CountSent(3), TELEMETRY_MAX_RATE);
+
+    Start();
+    TelemetryStream_Subscribe(1, 50, 0);
+    TelemetryStream_Subscribe(2, 50, 0);
+    BusyClient = 1;
+    Run(0, 200);
+    ok = CountSent(1) == 0 && CountSent(2) == 10;
+    Check("slow_client_isolated", ok, "busy client %u frames, other %u", CountSent(1), CountSent(2));
+    BusyClient = 0xFFFFFFFF;
+    SentCount = 0;
+    TelemetryStream_Drain(Send, NULL);
+    ok = SentCount == TELEMETRY_QUEUE_DEPTH;
+    for (i = 0; ok && i < SentCount; i++)
+    {
+        // newest TELEMETRY_QUEUE_DEPTH frames in order
+        ok = SentFrames[i].sequence == 10 - TELEMETRY_QUEUE_DEPTH + i;
+    }
+    TelemetryStream_GetStats(&stats, false);
+    Check("drop_oldest", ok && stats.dropped == 10 - TELEMETRY_QUEUE_DEPTH, "%u frames after busy, %u dropped",
+          SentCount, stats.dropped);
+
+    Start();
+    TelemetryStream_Subscribe(1, 50, 0);
+    BusyClient = 1;
+    Run(0, 50);
+    TelemetryStream_Unsubscribe(1);
+    BusyClient = 0xFFFFFFFF;
+    Run(50, 500);
+    Check("unsubscribe", SentCount == 0 && TelemetryStream_GetSubscribers() == 0, "%u frames, %u subscribers",
+          SentCount, TelemetryStream_GetSubscribers());
+
+    Start();
+    for (i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+    {
+        TelemetryStream_Subscribe(100 + i, 10, 0);
+    }
+    ok = !TelemetryStream_Subscribe(200, 10, 0) && TelemetryStream_Subscribe(100, 50, 0);
+    Check("slots_full", ok && TelemetryStream_GetSubscribers() == TELEMETRY_MAX_CLIENTS,
+          "%u subscribers of %u, resubscribe changes rate", TelemetryStream_GetSubscribers(), TELEMETRY_MAX_CLIENTS);
+
+    Start();
+    TelemetryStream_Subscribe(1, 50, 0);
+    Run(0, 100);
+    SentCount = 0;
+    Run(400, 410); // network task stalled for 300 ms
+    Check("late_no_burst", SentCount == 1, "%u frames after stall", SentCount);
+
+    return Failed ? 1 : 0;
+}
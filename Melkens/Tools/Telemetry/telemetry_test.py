@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+Host test of the ESP binary web telemetry, Melkens_Connectivity/src/Telemetry.
+
+Builds telemetry_test.cpp with TelemetryStream.cpp and checks that:
+  - the encoded frame decodes with the layout of TelemetryStream.h, the same
+    offsets the web page reads with DataView,
+  - every subscriber gets frames at its own rate, limited to TELEMETRY_MAX_RATE,
+  - a client that does not keep up keeps only the newest frames (drop oldest)
+    and does not delay the others,
+  - unsubscribed clients get nothing, client slots are limited,
+  - a late network task sends one frame, not a burst.
+
+Usage:
+  telemetry_test.py [--cc c++] [--cflags "-O2"]
+"""
+
+import argparse
+import os
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.join(TOOL_DIR, '..', '..')
+ESP_DIR = os.path.join(ROOT_DIR, 'Melkens_Connectivity')
+
+sys.path.insert(0, os.path.join(ROOT_DIR, 'Tools', 'MessageGen'))
+import messages  # noqa: E402
+
+# TelemetryStream.h frame layout
+FRAME = struct.Struct('<BBHIIHhhHHHHHHBBBBHIHHH')
+FIELDS = ['magic', 'format', 'sequence', 'time', 'magnetBarStatus', 'pmbConnection', 'motorRightSpeed',
+          'motorLeftSpeed', 'batteryVoltage', 'adcCurrent', 'thumbleCurrent', 'crcImu2PmbErrorCount',
+          'crcPmb2ImuErrorCount', 'crcEsp2ImuErrorCount', 'collision', 'routeUploadState', 'routeCount',
+          'flags', 'stopReaction', 'imuFrames', 'pmbLoopMaxTime', 'pmbMissedTicks', 'pmbTaskMisses']
+# values set in telemetry_test.cpp
+EXPECTED = {
+    'magic': 0x54, 'format': 2, 'sequence': 0xBEEF, 'time': 123456789, 'magnetBarStatus': 0x80010203,
+    'pmbConnection': 1, 'motorRightSpeed': -1200, 'motorLeftSpeed': 1300, 'batteryVoltage': 25400,
+    'adcCurrent': 2100, 'thumbleCurrent': 45, 'crcImu2PmbErrorCount': 7, 'crcPmb2ImuErrorCount': 8,
+    'crcEsp2ImuErrorCount': 9, 'collision': messages.COLLISION_WHEEL_STALL,
+    'routeUploadState': messages.ROUTE_UPLOAD_DONE, 'routeCount': 12, 'flags': 1, 'stopReaction': 4321,
+    'imuFrames': 98765, 'pmbLoopMaxTime': 950, 'pmbMissedTicks': 3, 'pmbTaskMisses': 17,
+}
+
+
+def check_frame(hex_frame):
+    data = bytes.fromhex(hex_frame)
+    if len(data) != FRAME.size:
+        return False, '%d bytes, layout has %d' % (len(data), FRAME.size)
+    decoded = dict(zip(FIELDS, FRAME.unpack(data)))
+    wrong = [name for name in FIELDS if decoded[name] != EXPECTED[name]]
+    if wrong:
+        return False, 'wrong ' + ', '.join('%s=%s' % (name, decoded[name]) for name in wrong)
+    return True, '%d bytes, all fields at their offsets' % FRAME.size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--cc', default=os.environ.get('CXX', 'c++'))
+    parser.add_argument('--cflags', default='-O2')
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        # sources include the library as the sketch does, through src/Melkens_Lib
+        os.makedirs(os.path.join(directory, 'src'))
+        os.symlink(os.path.abspath(os.path.join(ROOT_DIR, 'Melkens_Lib')),
+                   os.path.join(directory, 'src', 'Melkens_Lib'))
+        os.symlink(os.path.abspath(os.path.join(ESP_DIR, 'src', 'Telemetry')),
+                   os.path.join(directory, 'src', 'Telemetry'))
+        output = os.path.join(directory, 'telemetry_test')
+        command = [args.cc, '-std=c++11', '-Wall', '-Wextra'] + shlex.split(args.cflags) + [
+            '-I' + directory, '-o', output,
+            os.path.join(TOOL_DIR, 'telemetry_test.cpp'),
+            os.path.join(ESP_DIR, 'src', 'Telemetry', 'TelemetryStream.cpp'), '-lpthread']
+        subprocess.check_call(command)
+        result = subprocess.run([output], stdout=subprocess.PIPE, universal_newlines=True)
+
+    failed = result.returncode != 0
+    for line in result.stdout.splitlines():
+        fields = line.split(None, 2)
+        if fields[0] == 'frame':
+            ok, detail = check_frame(fields[1])
+            fields = ['frame_layout', 'ok' if ok else 'FAIL', detail]
+        print('%-28s %s' % (fields[0], ' '.join(fields[1:])))
+        failed |= fields[1] != 'ok'
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,260 @@
+#!/usr/bin/env python3
+"""
+Host simulation of cross board time synchronisation (Melkens_Lib/TimeSync).
+
+Builds Melkens_Lib/TimeSync/TimeSync.c with the host C compiler, loads it with
+ctypes and drives the real code with a model of the ESP <-> IMU <-> PMB links:
+drifting board clocks, frame times at 115200 baud, receive pick up latency of
+the main loops and occasional transmit queueing. IMU and PMB conversion to ESP
+timebase is compared with true ESP time every 10 ms.
+
+Usage:
+  time_sync_sim.py [--minutes 10] [--drift 100] [--seed 1] [--cc cc]
+
+Fails (exit code 1) when any error exceeds the error bound reported by
+TimeSync_GetErrorBound or when the worst error --settle (2 s) after the first
+synchronisation is above --limit (1000 us). The first sample is used at once,
+so until the first window with a better sample the error can be larger.
+"""
+
+import argparse
+import ctypes
+import heapq
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+LIB_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Melkens_Lib')
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'MessageGen'))
+import messages  # noqa: E402
+
+BAUD = 115200
+# MessageTypes.h frame sizes
+ESP2IMU_FRAME = messages.ESP2IMU_FRAME_SIZE
+IMU2ESP_FRAME = messages.IMU2ESP_FRAME_SIZE
+IMU2PMB_FRAME = messages.IMU2PMB_FRAME_SIZE
+PMB2IMU_FRAME = messages.PMB2IMU_FRAME_SIZE
+
+NO_ECHO = messages.SYNC_NO_ECHO
+UNKNOWN_WEEK_TIME = messages.SYNC_UNKNOWN_WEEK_TIME
+NOT_SYNCHRONISED = messages.SYNC_NOT_SYNCHRONISED
+UINT32_MAX = 0xFFFFFFFF
+
+
+class SyncStamp(ctypes.Structure):
+    _pack_ = 1
+    _fields_ = [('txTime', ctypes.c_uint32), ('echoTime', ctypes.c_uint32), ('echoDelay', ctypes.c_uint32),
+                ('weekTime', ctypes.c_uint32), ('errorBound', ctypes.c_uint16)]
+
+
+def build_library(cc, directory):
+    source = os.path.join(LIB_DIR, 'TimeSync', 'TimeSync.c')
+    output = os.path.join(directory, 'timesync.so')
+    subprocess.check_call([cc, '-std=c99', '-O2', '-Wall', '-shared', '-fPIC', '-o', output, source])
+    library = ctypes.CDLL(output)
+    library.TimeSync_Receive.argtypes = [ctypes.c_void_p, ctypes.POINTER(SyncStamp), ctypes.c_uint32, ctypes.c_bool]
+    library.TimeSync_Stamp.argtypes = [ctypes.c_void_p, ctypes.POINTER(SyncStamp), ctypes.c_uint32,
+                                       ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint16]
+    library.TimeSync_ToShared.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32)]
+    library.TimeSync_ToShared.restype = ctypes.c_bool
+    library.TimeSync_GetErrorBound.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    library.TimeSync_GetErrorBound.restype = ctypes.c_uint32
+    library.TimeSync_GetWeekTime.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    library.TimeSync_GetWeekTime.restype = ctypes.c_uint32
+    library.TimeSync_Init.argtypes = [ctypes.c_void_p]
+    return library
+
+
+class Clock:
+    """Board clock [us] with offset, drift and slow drift change (temperature)"""
+
+    def __init__(self, rng, drift_ppm, wander_ppm):
+        self.offset = rng.randrange(1 << 32)
+        self.drift = rng.uniform(-drift_ppm, drift_ppm)
+        self.wander = rng.uniform(-wander_ppm, wander_ppm) / 600.0   # [ppm/s]
+
+    def read(self, time_us):
+        drift = self.drift + self.wander * time_us / 1e6
+        return int(self.offset + time_us * (1.0 + drift * 1e-6)) & UINT32_MAX
+
+
+def frame_time(size):
+    return size * 10 * 1e6 / BAUD
+
+
+class Board:
+    def __init__(self, library, clock):
+        self.library = library
+        self.clock = clock
+        self.sync = ctypes.create_string_buffer(256)
+        library.TimeSync_Init(self.sync)
+        self.line_free = 0.0
+
+
+class Simulation:
+    def __init__(self, args):
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.events = []
+        self.order = 0
+
+    def push(self, time_us, kind, data=None):
+        self.order += 1
+        heapq.heappush(self.events, (time_us, self.order, kind, data))
+
+    def send(self, sender, size, now):
+        """Returns end of frame on the line; occasionally frames wait behind other traffic"""
+        start = max(now, sender.line_free)
+        if self.rng.random() < self.args.queue_probability:
+            start += self.rng.uniform(0, 10000)
+        sender.line_free = start + frame_time(size)
+        return sender.line_free
+
+    def pickup(self, worst):
+        """Main loop / task latency until received frame is processed"""
+        if self.rng.random() < 0.02:
+            return self.rng.uniform(0, worst)
+        return self.rng.uniform(0, worst / 10.0)
+
+    def run(self, library):
+        args = self.args
+        rng = self.rng
+        esp = Board(library, Clock(rng, 0, 0))      # ESP clock is the shared timebase
+        esp.clock.offset = rng.randrange(1 << 32)
+        imu = Board(library, Clock(rng, args.drift, args.wander))
+        pmb = Board(library, Clock(rng, args.drift, args.wander))
+        week_time = 3 * 86400 + 12 * 3600           # Wednesday noon at simulation start
+
+        def stamp_from(board, now, size, shared, bound, week):
+            stamp = SyncStamp()
+            local = (board.clock.read(now) + int(frame_time(size))) & UINT32_MAX
+            library.TimeSync_Stamp(board.sync, ctypes.byref(stamp), shared(local), local, week, bound)
+            return stamp
+
+        def imu_shared():
+            value = ctypes.c_uint32()
+            local = imu.clock.read(now)
+            if library.TimeSync_ToShared(imu.sync, local, ctypes.byref(value)):
+                return value.value, library.TimeSync_GetErrorBound(imu.sync, local)
+            return None, None
+
+        end = args.minutes * 60e6
+        self.push(rng.uniform(0, 8000), 'esp_tx')
+        self.push(rng.uniform(0, 100000), 'imu_pmb_tx')
+        self.push(0.0, 'check')
+        errors = {'imu': [], 'pmb': []}
+        violations = {'imu': 0, 'pmb': 0}
+        synced_at = {'imu': None, 'pmb': None}
+        week_errors = 0
+        imu_pmb_last = -1e9
+
+        while self.events:
+            now, _, kind, data = heapq.heappop(self.events)
+            if now > end:
+                break
+
+            if kind == 'esp_tx':
+                # control changes at 8..100 ms, keep-alive at 100 ms
+                week = (week_time + int(now / 1e6)) % 604800
+                stamp = stamp_from(esp, now, ESP2IMU_FRAME, lambda local: local, 0, week)
+                arrival = self.send(esp, ESP2IMU_FRAME, now) + self.pickup(args.imu_pickup)
+                self.push(arrival, 'imu_rx_esp', stamp)
+                self.push(now + rng.choice([8000, 20000, 50000, 100000]), 'esp_tx')
+            elif kind == 'imu_rx_esp':
+                library.TimeSync_Receive(imu.sync, ctypes.byref(data), imu.clock.read(now), True)
+                # new command: PMB frame at most every 5 ms
+                if now - imu_pmb_last >= 5000:
+                    imu_pmb_last = now
+                    self.push(now + rng.uniform(0, 1000), 'imu_pmb_tx', False)
+            elif kind == 'imu_pmb_tx':
+                shared, bound = imu_shared()
+
+                def imu_time(local, shared=shared):
+                    if shared is None:
+                        return local
+                    return (shared + int(frame_time(IMU2PMB_FRAME))) & UINT32_MAX
+                stamp = stamp_from(imu, now, IMU2PMB_FRAME, imu_time,
+                                   NOT_SYNCHRONISED if bound is None else min(bound, NOT_SYNCHRONISED - 1),
+                                   library.TimeSync_GetWeekTime(imu.sync, imu.clock.read(now)))
+                arrival = self.send(imu, IMU2PMB_FRAME, now) + rng.uniform(0, 1000)   # PMB 1ms task
+                self.push(arrival, 'pmb_rx', stamp)
+                if data is None:
+                    self.push(now + 100000, 'imu_pmb_tx')
+            elif kind == 'pmb_rx':
+                library.TimeSync_Receive(pmb.sync, ctypes.byref(data), pmb.clock.read(now), True)
+                if data.weekTime != UNKNOWN_WEEK_TIME:
+                    expected = (week_time + int(now / 1e6)) % 604800
+                    if min((data.weekTime - expected) % 604800, (expected - data.weekTime) % 604800) > 1:
+                        week_errors += 1
+                stamp = stamp_from(pmb, now, PMB2IMU_FRAME, lambda local: local, NOT_SYNCHRONISED, UNKNOWN_WEEK_TIME)
+                arrival = self.send(pmb, PMB2IMU_FRAME, now) + self.pickup(args.imu_pickup)
+                self.push(arrival, 'imu_rx_pmb', stamp)
+            elif kind == 'imu_rx_pmb':
+                library.TimeSync_Receive(imu.sync, ctypes.byref(data), imu.clock.read(now), False)
+                stamp = stamp_from(imu, now, IMU2ESP_FRAME, lambda local: local, NOT_SYNCHRONISED, UNKNOWN_WEEK_TIME)
+                arrival = self.send(imu, IMU2ESP_FRAME, now) + self.pickup(args.esp_pickup)
+                self.push(arrival, 'esp_rx', stamp)
+            elif kind == 'esp_rx':
+                library.TimeSync_Receive(esp.sync, ctypes.byref(data), esp.clock.read(now), False)
+            elif kind == 'check':
+                truth = esp.clock.read(now)
+                for name, board in (('imu', imu), ('pmb', pmb)):
+                    local = board.clock.read(now)
+                    value = ctypes.c_uint32()
+                    if library.TimeSync_ToShared(board.sync, local, ctypes.byref(value)):
+                        if synced_at[name] is None:
+                            synced_at[name] = now
+                        error = ((value.value - truth + (1 << 31)) & UINT32_MAX) - (1 << 31)
+                        bound = library.TimeSync_GetErrorBound(board.sync, local)
+                        if abs(error) > bound:
+                            violations[name] += 1
+                        if now - synced_at[name] >= args.settle * 1e6:
+                            errors[name].append((abs(error), bound))
+                self.push(now + 10000, 'check')
+
+        result = 0
+        for name in ('imu', 'pmb'):
+            samples = sorted(error for error, _ in errors[name])
+            bounds = sorted(bound for _, bound in errors[name])
+            if not samples:
+                print('%s: never synchronised' % name)
+                result = 1
+                continue
+            count = len(samples)
+            print('%s: synchronised after %.2f s, then |error| median %d us, p99 %d us, max %d us, '
+                  'bound median %d us, max %d us, %d bound violations' % (
+                      name, synced_at[name] / 1e6, samples[count // 2], samples[int(count * 0.99)], samples[-1],
+                      bounds[count // 2], bounds[-1], violations[name]))
+            if violations[name] or samples[-1] > args.limit:
+                result = 1
+        if week_errors:
+            print('week time forwarded to PMB wrong %d times' % week_errors)
+            result = 1
+        print('FAIL' if result else 'PASS')
+        return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='TimeSync host simulation with drifting clocks')
+    parser.add_argument('--minutes', type=float, default=10.0, help='simulated time')
+    parser.add_argument('--drift', type=float, default=100.0, help='[ppm] IMU and PMB clock rate error')
+    parser.add_argument('--wander', type=float, default=5.0, help='[ppm] drift change over 10 minutes')
+    parser.add_argument('--imu-pickup', type=float, default=2000.0, help='[us] worst IMU main loop latency')
+    parser.add_argument('--esp-pickup', type=float, default=1000.0, help='[us] worst ESP link task latency')
+    parser.add_argument('--queue-probability', type=float, default=0.02, help='frames delayed by other traffic')
+    parser.add_argument('--limit', type=float, default=1000.0, help='[us] required worst error after --settle')
+    parser.add_argument('--settle', type=float, default=2.0, help='[s] after first synchronisation')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        library = build_library(args.cc, directory)
+        return Simulation(args).run(library)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,251 @@
+/*
+ * Host driver of velocity_planner_sim.py, built together with
+ * Melkens_IMU/Core/Src/Navigation.c, VelocityPlanner.c, PoseFilter.c and
+ * Routes.c. No magnets are seen, the pose filter only dead reckons.
+ *
+ * The real navigationPerform1ms drives a robot model every 1 ms. Every
+ * FRAME_MS the wheel speed commands go to the PMB and the encoder counts
+ * come back, taken HALF a frame earlier. Inverters follow the command with
+ * a first order lag. Robot angle (getRobotAngle) follows the true heading
+ * without error. Truth moves in the same frame as updatePosition: heading
+ * Robot_Angle pi is +X, left wheel faster turns towards +Y.
+ *
+ * Usage: velocity_planner_sim <route> <fixed|planned> <speed scale> [Param=value ...]
+ * Step speeds of the route are multiplied by speed scale, Param are
+ * VelocityPlannerParams fields. Prints:
+ *   result <finished 0|1> <time ms> <max cte> <max cte in turns> <rms cte> <peak lateral accel> <peak accel>
+ *   with "trace" after the parameters one line per 10 ms before it:
+ *   ms x y cte speed lookahead lateral_accel closest_point
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Navigation.h"
+#include "VelocityPlanner.h"
+#include "PoseFilter.h"
+#include "RouteStore.h"
+#include "IMU_func.h"
+
+#define FRAME_MS        10          /* Imu2PmbFrame_t / Pmb2ImuFrame_t exchange */
+#define LAG_S           0.060       /* inverter speed lag */
+#define COUNTS          10000.0     /* encoder counts per rotation */
+#define TIMEOUT_MS      180000
+#define TURN_ANGLE      0.15        /* [rad] route direction change counted as turn */
+#define TURN_WINDOW     5           /* [points] around a turn */
+#define MAX_STEPS       256
+#define PI              3.14159265358979
+
+extern float RouteStartAngle;
+extern uint16_t closestPoint;
+extern uint8_t pursuitPointIncrement;
+
+static VelocityPlannerParams Params;
+static RouteData Scaled;
+static RouteStep ScaledSteps[MAX_STEPS];
+static bool IsScaled;
+
+/* robot model */
+static double Yaw = 0.7;                /* getRobotAngle, any start value */
+static double TrueX, TrueY;
+static double LeftSpeed, RightSpeed;    /* [RPM] at the wheel */
+static int16_t LeftCommand, RightCommand;
+static int16_t LeftApplied, RightApplied;
+static double LeftCounts, RightCounts;
+static uint16_t LeftReported, RightReported;
+static double LeftHalf, RightHalf;      /* counts half a frame ago */
+
+/* Firmware interfaces used by Navigation.c */
+float getRobotAngle(void) { return (float)Yaw; }
+uint16_t getLeftEncoder(void) { return LeftReported; }
+uint16_t getRightEncoder(void) { return RightReported; }
+void setLeftWheelSpeed(int16_t speed) { LeftCommand = speed; }
+void setRightWheelSpeed(int16_t speed) { RightCommand = speed; }
+void setThumbleSpeed(uint16_t speed) { (void)speed; }
+void setDebugDataPoint1(uint16_t x, uint16_t y) { (void)x; (void)y; }
+uint32_t MagnetsHandler_GetSatus(void) { return 0; }
+float MagnetsHandler_GetAvreageDistance(void) { return 0.0f; }
+int8_t getJoystickX(void) { return 0; }
+int8_t getJoystickY(void) { return 0; }
+int16_t getThumbleSetting(void) { return 0; }
+
+/* Compiled route with scaled step speeds replaces the stored one */
+bool RouteStore_GetRoute(uint16_t ID, RouteData* Data)
+{
+	(void)ID;
+	if(!IsScaled)
+		return false;
+	*Data = Scaled;
+	return true;
+}
+
+static uint16_t Wrap(double Counts)
+{
+	double Value = fmod(Counts, COUNTS);
+
+	if(Value < 0.0)
+		Value += COUNTS;
+	return (uint16_t)Value;
+}
+
+static double SegmentDistance(const RoutePoint* A, const RoutePoint* B, double X, double Y)
+{
+	double dx = B->X - A->X, dy = B->Y - A->Y;
+	double Length = dx*dx + dy*dy;
+	double t = (Length > 0.0) ? ((X - A->X) * dx + (Y - A->Y) * dy) / Length : 0.0;
+
+	if(t < 0.0)
+		t = 0.0;
+	if(t > 1.0)
+		t = 1.0;
+	return hypot(X - (A->X + t * dx), Y - (A->Y + t * dy));
+}
+
+static bool SetParam(const char* Text)
+{
+	char Name[32];
+	double Value;
+
+	if(sscanf(Text, "%31[^=]=%lf", Name, &Value) != 2)
+		return false;
+	if(!strcmp(Name, "DistancePerRotation")) Params.DistancePerRotation = (float)Value;
+	else if(!strcmp(Name, "TrackWidth")) Params.TrackWidth = (float)Value;
+	else if(!strcmp(Name, "MaxLateralAccel")) Params.MaxLateralAccel = (float)Value;
+	else if(!strcmp(Name, "MaxAccel")) Params.MaxAccel = (float)Value;
+	else if(!strcmp(Name, "MaxWheelSpeed")) Params.MaxWheelSpeed = (uint16_t)Value;
+	else if(!strcmp(Name, "MinSpeed")) Params.MinSpeed = (uint16_t)Value;
+	else if(!strcmp(Name, "LookaheadTime")) Params.LookaheadTime = (float)Value;
+	else if(!strcmp(Name, "MinLookahead")) Params.MinLookahead = (uint8_t)Value;
+	else if(!strcmp(Name, "MaxLookahead")) Params.MaxLookahead = (uint8_t)Value;
+	else return false;
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	const RoutePoint* Points;
+	bool IsTurn[dVELOCITY_PLANNER_MAX_POINTS] = {false};
+	bool IsTrace = false;
+	uint16_t Progress = 0;
+	double Scale, MaxCte = 0.0, TurnCte = 0.0, SumCte = 0.0, PeakLateral = 0.0, PeakAccel = 0.0;
+	double PrevSpeed = 0.0;
+	uint32_t Ms, Samples = 0;
+	int Route;
+
+	if(argc < 4)
+	{
+		fprintf(stderr, "usage: %s <route> <fixed|planned> <speed scale> [Param=value ...] [trace]\n", argv[0]);
+		return 2;
+	}
+	Route = atoi(argv[1]);
+	Scale = atof(argv[3]);
+	Params = VelocityPlanner_Defaults;
+	for(int i = 4; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "trace"))
+			IsTrace = true;
+		else if(!SetParam(argv[i]))
+		{
+			fprintf(stderr, "unknown parameter %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	Route_SetRoutePointer(&Scaled, (Route_ID)Route);
+	if(Scaled.StepCount > MAX_STEPS || Scaled.PointCount > dVELOCITY_PLANNER_MAX_POINTS)
+		return 2;
+	for(uint16_t i = 0; i < Scaled.StepCount; i++)
+	{
+		ScaledSteps[i] = Scaled.Step[i];
+		ScaledSteps[i].Speed = (int16_t)lround(Scaled.Step[i].Speed * Scale);
+	}
+	Scaled.Step = ScaledSteps;
+	IsScaled = true;
+	Points = Scaled.Point;
+
+	/* Points near a change of route direction */
+	for(int i = 1; i + 1 < Scaled.PointCount; i++)
+	{
+		double In = atan2(Points[i].Y - Points[i - 1].Y, Points[i].X - Points[i - 1].X);
+		double Out = atan2(Points[i + 1].Y - Points[i].Y, Points[i + 1].X - Points[i].X);
+		double Change = fabs(remainder(Out - In, 2.0 * PI));
+
+		if(Change > TURN_ANGLE)
+			for(int j = i - TURN_WINDOW; j <= i + TURN_WINDOW; j++)
+				if(j >= 0 && j < Scaled.PointCount)
+					IsTurn[j] = true;
+	}
+
+	navigationInit();
+	VelocityPlanner_Init(&Params);
+	PoseFilter_Init(&PoseFilter_Defaults);
+	VelocityPlanner_SetEnabled(!strcmp(argv[2], "planned"));
+	loadRoute((Route_ID)Route);
+
+	for(Ms = 0; Ms < TIMEOUT_MS && !isRouteFinnished(); Ms++)
+	{
+		double Cm = Params.DistancePerRotation / 60.0 / 1000.0;  /* RPM to cm per ms */
+		double Left, Right, Speed, Turn, Cte = 1e9;
+
+		if(Ms % FRAME_MS == 0)
+		{
+			LeftApplied = LeftCommand;
+			RightApplied = RightCommand;
+			LeftReported = Wrap(LeftHalf);
+			RightReported = Wrap(RightHalf);
+		}
+		else if(Ms % FRAME_MS == FRAME_MS / 2)
+		{
+			LeftHalf = LeftCounts;
+			RightHalf = RightCounts;
+		}
+
+		navigationPerform1ms();
+
+		LeftSpeed += (LeftApplied - LeftSpeed) * (0.001 / LAG_S);
+		RightSpeed += (RightApplied - RightSpeed) * (0.001 / LAG_S);
+		LeftCounts += LeftSpeed / 60.0 / 1000.0 * COUNTS;
+		RightCounts -= RightSpeed / 60.0 / 1000.0 * COUNTS;
+
+		Left = LeftSpeed * Cm;
+		Right = RightSpeed * Cm;
+		Speed = (Left + Right) / 2.0;
+		Turn = (Right - Left) / Params.TrackWidth;
+		Yaw += Turn;
+		TrueX -= Speed * cos(Yaw - RouteStartAngle);
+		TrueY += Speed * sin(Yaw - RouteStartAngle);
+
+		/* Cross track error to the route near the last closest segment */
+		for(int i = (Progress > 3) ? Progress - 3 : 0; i < Progress + 15 && i + 1 < Scaled.PointCount; i++)
+		{
+			double Distance = SegmentDistance(&Points[i], &Points[i + 1], TrueX, TrueY);
+
+			if(Distance < Cte)
+			{
+				Cte = Distance;
+				Progress = (uint16_t)i;
+			}
+		}
+		if(Cte > MaxCte)
+			MaxCte = Cte;
+		if((IsTurn[Progress] || IsTurn[Progress + 1]) && Cte > TurnCte)
+			TurnCte = Cte;
+		SumCte += Cte * Cte;
+		Samples++;
+
+		/* [cm/s^2], speed per ms times turn per ms */
+		if(fabs(Speed * Turn) * 1e6 > PeakLateral)
+			PeakLateral = fabs(Speed * Turn) * 1e6;
+		if(fabs(Speed - PrevSpeed) * 1e6 > PeakAccel)
+			PeakAccel = fabs(Speed - PrevSpeed) * 1e6;
+		PrevSpeed = Speed;
+
+		if(IsTrace && Ms % 10 == 0)
+			printf("%u %.1f %.1f %.2f %d %u %.2f %u\n", Ms, TrueX, TrueY, Cte, (LeftCommand + RightCommand) / 2, pursuitPointIncrement, fabs(Speed * Turn) * 1e6, closestPoint);
+	}
+
+	printf("result %d %u %.2f %.2f %.2f %.2f %.2f\n", isRouteFinnished() ? 1 : 0, Ms, MaxCte, TurnCte,
+		   sqrt(SumCte / (Samples ? Samples : 1)), PeakLateral, PeakAccel);
+	return 0;
+}
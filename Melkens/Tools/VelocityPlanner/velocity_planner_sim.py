@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Host simulation of IMU pure pursuit with the velocity planner (VelocityPlanner).
+
+Builds velocity_planner_sim.c with Melkens_IMU/Core/Src/Navigation.c,
+VelocityPlanner.c, PoseFilter.c, Routes.c and Melkens_Lib/Scope (Navigation
+registers its scope channels) and drives every stored route twice, both
+with the stored step speeds:
+
+  fixed      as before the planner: step speeds, lookahead of 5 points
+  planned    step speeds as the upper limit, planned speed and lookahead
+
+A route passes when the planned run finishes, its cross track error in turns
+is not worse (0.5 cm allowed), its peak lateral acceleration stays within
+MaxLateralAccel or the one of the fixed run (10 % allowed) and its peak
+acceleration is not higher. Run time is only reported: the planner slows
+down for turns and limits acceleration, so at the same step speeds it is not
+faster. Cross track error is the distance of the true robot position from
+the route polyline, "in turns" within 5 points of a route direction change
+of more than 0.15 rad, reversals included.
+
+--scale multiplies the step speeds of both runs, to see how the planner
+holds when routes are given more speed. The checks stay the same.
+
+Planner parameters are changed with --param Name=value (VelocityPlannerParams
+field names), the defaults are VelocityPlanner_Defaults.
+
+Usage:
+  velocity_planner_sim.py [--scale 1] [--route all] [--param MaxAccel=20] [--cc cc] [--cflags "-O2"]
+  velocity_planner_sim.py --trace A [--fixed] [--scale 1] > trace.txt
+"""
+
+import argparse
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+IMU_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_IMU', 'Core')
+LIB_DIR = os.path.join(TOOL_DIR, '..', '..', 'Melkens_Lib')
+TYPES_DIR = os.path.join(LIB_DIR, 'Types')
+
+# IMU_func.h pulls in the HAL, Navigation.c needs only these
+IMU_FUNC_STUB = '''#include <stdint.h>
+#include <stdbool.h>
+float getRobotAngle(void);
+uint16_t getRightEncoder(void);
+uint16_t getLeftEncoder(void);
+void setLeftWheelSpeed(int16_t speed);
+void setRightWheelSpeed(int16_t speed);
+void setDebugDataPoint1(uint16_t x, uint16_t y);
+void setThumbleSpeed(uint16_t speed);
+'''
+
+# Navigation times the pose filter with the DWT cycle counter, it stays 0 here
+MAIN_STUB = '''#include <stdint.h>
+typedef struct { volatile uint32_t CYCCNT; } DWT_Type;
+static DWT_Type HostDwt;
+#define DWT (&HostDwt)
+'''
+
+CTE_MARGIN = 0.5            # [cm]
+LATERAL_MARGIN = 1.1
+
+
+def route_names():
+    with open(os.path.join(IMU_DIR, 'Src', 'Routes.c')) as file:
+        return re.findall(r'\[Route(\w+)\] = \{', file.read())
+
+
+def max_lateral_accel(params):
+    for param in params:
+        if param.startswith('MaxLateralAccel='):
+            return float(param.split('=')[1])
+    with open(os.path.join(IMU_DIR, 'Src', 'VelocityPlanner.c')) as file:
+        return float(re.search(r'\.MaxLateralAccel = ([\d.]+)f', file.read()).group(1))
+
+
+def build(directory, args):
+    with open(os.path.join(directory, 'IMU_func.h'), 'w') as stub:
+        stub.write(IMU_FUNC_STUB)
+    with open(os.path.join(directory, 'main.h'), 'w') as stub:
+        stub.write(MAIN_STUB)
+    output = os.path.join(directory, 'velocity_planner_sim')
+    command = [args.cc, '-std=c99'] + shlex.split(args.cflags) + [
+        '-I' + directory, '-I' + os.path.join(IMU_DIR, 'Inc'), '-I' + TYPES_DIR,
+        '-I' + os.path.join(LIB_DIR, 'Scope'), '-o', output,
+        os.path.join(TOOL_DIR, 'velocity_planner_sim.c'),
+        os.path.join(IMU_DIR, 'Src', 'Navigation.c'),
+        os.path.join(IMU_DIR, 'Src', 'VelocityPlanner.c'),
+        os.path.join(IMU_DIR, 'Src', 'PoseFilter.c'),
+        os.path.join(IMU_DIR, 'Src', 'Routes.c'),
+        # Navigation registers its scope channels
+        os.path.join(LIB_DIR, 'Scope', 'Scope.c'),
+        os.path.join(LIB_DIR, 'BinLog', 'BinLog.c'),
+        os.path.join(LIB_DIR, 'CRC16', 'CRC16.c'), '-lm']
+    subprocess.check_call(command)
+    return output
+
+
+def run(simulator, route, mode, scale, params, trace=False):
+    command = [simulator, str(route), mode, str(scale)] + params + (['trace'] if trace else [])
+    result = subprocess.run(command, stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    if trace:
+        return result.stdout
+    fields = result.stdout.split()
+    return {
+        'finished': fields[1] == '1',
+        'time': int(fields[2]) / 1000.0,
+        'cte': float(fields[3]),
+        'turn_cte': float(fields[4]),
+        'rms_cte': float(fields[5]),
+        'lateral': float(fields[6]),
+        'accel': float(fields[7]),
+    }
+
+
+def row(name, result):
+    return '  %-11s %s %6.1f s  cte max %5.1f turns %5.1f rms %5.2f cm  a_lat %5.2f  a %6.1f cm/s^2' % (
+        name, 'done' if result['finished'] else 'STUCK', result['time'], result['cte'], result['turn_cte'],
+        result['rms_cte'], result['lateral'], result['accel'])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--scale', type=float, default=1.0, help='step speed multiplier of both runs')
+    parser.add_argument('--route', default='all', help='route letter or all')
+    parser.add_argument('--param', action='append', default=[], help='VelocityPlannerParams Name=value')
+    parser.add_argument('--trace', metavar='ROUTE', help='print the trace of one planned run instead')
+    parser.add_argument('--fixed', action='store_true', help='trace the fixed run')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cflags', default='-O2')
+    args = parser.parse_args()
+
+    names = route_names()
+    lateral_limit = max_lateral_accel(args.param)
+
+    with tempfile.TemporaryDirectory() as directory:
+        simulator = build(directory, args)
+
+        if args.trace:
+            route = names.index(args.trace.upper())
+            sys.stdout.write(run(simulator, route, 'fixed' if args.fixed else 'planned',
+                                 args.scale, args.param, trace=True))
+            return 0
+
+        failed = False
+        for route, name in enumerate(names):
+            if args.route != 'all' and args.route.upper() != name:
+                continue
+            fixed = run(simulator, route, 'fixed', args.scale, args.param)
+            planned = run(simulator, route, 'planned', args.scale, args.param)
+
+            problems = []
+            if not planned['finished'] or not fixed['finished']:
+                problems.append('route not finished')
+            if planned['accel'] > fixed['accel']:
+                problems.append('acceleration')
+            if planned['turn_cte'] > fixed['turn_cte'] + CTE_MARGIN:
+                problems.append('cross track error in turns')
+            if planned['lateral'] > max(lateral_limit, fixed['lateral']) * LATERAL_MARGIN:
+                problems.append('lateral acceleration')
+            failed |= bool(problems)
+
+            print('route %s %s  time %+.0f %%%s' % (name, 'FAIL' if problems else 'ok',
+                                                   100.0 * (planned['time'] / fixed['time'] - 1.0),
+                                                   ('  ' + ', '.join(problems)) if problems else ''))
+            print(row('fixed', fixed))
+            print(row('planned', planned))
+
+    print('FAIL' if failed else 'PASS')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
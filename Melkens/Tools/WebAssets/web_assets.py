@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+Packs the ESP web pages into flash resident, pre-compressed assets.
+
+Sources are the plain files in Melkens_Connectivity/src/WebPage (index.html,
+settings.html, style.css). Every file is gzipped (deterministic, no time
+stamp) and written as a const PROGMEM byte array to
+Melkens_Connectivity/src/WebPage/WebAssets.h with its URL, content type and a
+strong ETag from the SHA-1 of the source. WebHandler serves them with
+Content-Encoding: gzip and answers a matching If-None-Match with 304.
+
+Usage:
+  web_assets.py generate     write WebAssets.h and print served sizes
+  web_assets.py check        fail when WebAssets.h is not up to date
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import sys
+
+TOOL_DIR = os.path.dirname(os.path.abspath(__file__))
+WEB_DIR = os.path.normpath(os.path.join(TOOL_DIR, '..', '..', 'Melkens_Connectivity', 'src', 'WebPage'))
+OUTPUT = os.path.join(WEB_DIR, 'WebAssets.h')
+
+BANNER = 'Generated by Tools/WebAssets/web_assets.py from src/WebPage, do not edit.'
+
+# source file, URL, content type
+ASSETS = [
+    ('index.html', '/', 'text/html'),
+    ('settings.html', '/settings', 'text/html'),
+    ('style.css', '/style.css', 'text/css'),
+]
+
+
+def pack(name):
+    with open(os.path.join(WEB_DIR, name), 'rb') as file:
+        source = file.read()
+    packed = gzip.compress(source, compresslevel=9, mtime=0)
+    packed = packed[:9] + b'\xff' + packed[10:]   # OS unknown, same output on every host
+    if gzip.decompress(packed) != source:
+        raise RuntimeError('%s does not survive gzip' % name)
+    etag = '"%s"' % hashlib.sha1(source).hexdigest()[:16]
+    return source, packed, etag
+
+
+def symbol(name):
+    return 'WebAsset_' + name.replace('.', '_')
+
+
+def generate():
+    out = []
+    out.append('// ' + BANNER)
+    out.append('')
+    out.append('#ifndef WEB_ASSETS_H')
+    out.append('#define WEB_ASSETS_H')
+    out.append('')
+    out.append('#include <Arduino.h>')
+    out.append('')
+    out.append('typedef struct {')
+    out.append('    const char *path;')
+    out.append('    const char *contentType;')
+    out.append('    const uint8_t *data; // gzip')
+    out.append('    size_t length;')
+    out.append('    const char *etag;')
+    out.append('} WebAsset;')
+    sizes = []
+    for name, path, content_type in ASSETS:
+        source, packed, etag = pack(name)
+        sizes.append((name, len(source), len(packed)))
+        out.append('')
+        out.append('// %s, %d bytes, %d gzipped' % (name, len(source), len(packed)))
+        out.append('static const uint8_t %s[] PROGMEM = {' % symbol(name))
+        for offset in range(0, len(packed), 16):
+            out.append('    ' + ' '.join('0x%02x,' % byte for byte in packed[offset:offset + 16]))
+        out.append('};')
+    out.append('')
+    out.append('static const WebAsset WebAssets[] = {')
+    for name, path, content_type in ASSETS:
+        out.append('    {"%s", "%s", %s, sizeof(%s), "%s"},' % (
+            path, content_type, symbol(name), symbol(name), pack(name)[2].replace('"', '\\"')))
+    out.append('};')
+    out.append('#define WEB_ASSETS_NUM_OF (sizeof(WebAssets) / sizeof(WebAssets[0]))')
+    out.append('')
+    out.append('#endif // WEB_ASSETS_H')
+    out.append('')
+    return '\n'.join(out), sizes
+
+
+def command_generate(args):
+    text, sizes = generate()
+    with open(OUTPUT, 'w', newline='\n') as file:
+        file.write(text)
+    print('wrote %s' % os.path.relpath(OUTPUT))
+    print('%-16s %8s %8s' % ('asset', 'bytes', 'served'))
+    for name, raw, packed in sizes:
+        print('%-16s %8d %8d  %3d %%' % (name, raw, packed, 100 * packed // raw))
+    print('%-16s %8d %8d  (0 on 304)' % ('total', sum(size[1] for size in sizes), sum(size[2] for size in sizes)))
+    return 0
+
+
+def command_check(args):
+    text, sizes = generate()
+    try:
+        with open(OUTPUT) as file:
+            current = file.read()
+    except OSError:
+        current = None
+    if current != text:
+        print('out of date, run web_assets.py generate: %s' % os.path.relpath(OUTPUT))
+        return 1
+    print('generated files are up to date')
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    subparsers = parser.add_subparsers(dest='command')
+    subparsers.required = True
+    subparsers.add_parser('generate').set_defaults(function=command_generate)
+    subparsers.add_parser('check').set_defaults(function=command_check)
+    args = parser.parse_args()
+    return args.function(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())